@@ -25,5 +25,17 @@ function iterateSliced() {
     return count;
 }
 
+function iterateParallelScan() {
+    var cursors = t.parallelScan( 3 );
+    assert.lte( cursors.length, 3 );
+    var count = 0;
+    for ( var i = 0; i < cursors.length; i++ ) {
+        count += cursors[i].itcount();
+    }
+
+    return count;
+}
+
 assert.eq( iterateSliced(), t.count() );
 assert.eq( iterateSliced(), i );
+assert.eq( iterateParallelScan(), t.count() );
@@ -0,0 +1,100 @@
+// bson_bench.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+    MONGO_BENCHMARK(BSONObjBuilderFlatDocument) {
+        volatile int sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            BSONObjBuilder b;
+            b.append("_id", static_cast<long long>(i));
+            b.append("name", "a string of typical field length");
+            b.append("count", 12345);
+            b.append("ratio", 0.5);
+            b.append("active", true);
+            b.appendDate("ts", 1407000000000LL);
+            sink += b.obj().objsize();
+        }
+    }
+
+    MONGO_BENCHMARK(BSONObjBuilderNestedDocument) {
+        volatile int sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            BSONObjBuilder b;
+            b.append("_id", static_cast<long long>(i));
+            {
+                BSONObjBuilder sub(b.subobjStart("stats"));
+                sub.append("reads", 10);
+                sub.append("writes", 20);
+                sub.done();
+            }
+            {
+                BSONArrayBuilder arr(b.subarrayStart("tags"));
+                arr.append("one");
+                arr.append("two");
+                arr.append("three");
+                arr.done();
+            }
+            sink += b.obj().objsize();
+        }
+    }
+
+    MONGO_BENCHMARK(BSONObjFieldIteration) {
+        BSONObjBuilder b;
+        for (int f = 0; f < 20; f++) {
+            b.append(BSONObjBuilder::numStr(f), f);
+        }
+        const BSONObj obj = b.obj();
+
+        volatile int sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            BSONObjIterator it(obj);
+            while (it.more()) {
+                sink += it.next().numberInt();
+            }
+        }
+    }
+
+    MONGO_BENCHMARK(BSONObjGetFieldDotted) {
+        const BSONObj obj = BSON("a" << BSON("b" << BSON("c" << 42)));
+        volatile int sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            sink += obj.getFieldDotted("a.b.c").numberInt();
+        }
+    }
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,82 @@
+// bson_field_index.cpp
+
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/bson/bson_field_index.h"
+
+#include "mongo/bson/bsonobjiterator.h"
+
+namespace mongo {
+
+    void BSONFieldIndex::buildTable() const {
+        const int nFields = _obj.nFields();
+
+        // Power of two at most half full so linear probe chains stay short.
+        size_t slots = 8;
+        while ( slots < static_cast<size_t>( nFields ) * 2 )
+            slots *= 2;
+        _table.assign( slots, 0 );
+
+        const StringData::Hasher hasher;
+        const char* base = _obj.objdata();
+        BSONObjIterator it( _obj );
+        while ( it.more() ) {
+            BSONElement e = it.next();
+            const StringData name = e.fieldNameStringData();
+            size_t slot = hasher( name ) & ( slots - 1 );
+            for ( ;; ) {
+                if ( _table[slot] == 0 ) {
+                    _table[slot] = static_cast<unsigned>( e.rawdata() - base );
+                    break;
+                }
+                // On duplicate field names keep the earlier element, matching getField.
+                if ( name == BSONElement( base + _table[slot] ).fieldNameStringData() )
+                    break;
+                slot = ( slot + 1 ) & ( slots - 1 );
+            }
+        }
+    }
+
+    BSONElement BSONFieldIndex::getField( const StringData& name ) const {
+        if ( _table.empty() )
+            buildTable();
+
+        const StringData::Hasher hasher;
+        const char* base = _obj.objdata();
+        const size_t mask = _table.size() - 1;
+        size_t slot = hasher( name ) & mask;
+        while ( _table[slot] != 0 ) {
+            BSONElement e( base + _table[slot] );
+            if ( name == e.fieldNameStringData() )
+                return e;
+            slot = ( slot + 1 ) & mask;
+        }
+        return BSONElement();
+    }
+
+} // namespace mongo
@@ -0,0 +1,76 @@
+// bson_field_index.h
+
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+    /**
+     * A hashed field-name -> offset table over one BSONObj, for callers that look up many
+     * different fields in the same document.  BSONObj::getField is a linear scan, so k lookups
+     * against an n-field document cost O(n*k); through a BSONFieldIndex they cost one O(n)
+     * build plus O(1) per lookup.
+     *
+     * The table is built lazily on the first lookup, so wrapping a document that ends up never
+     * being probed costs nothing.  The index holds a copy of the (refcounted) BSONObj, keeping
+     * owned buffers alive for as long as the index is.
+     *
+     * Not useful for dotted paths - resolve those a component at a time, or keep using
+     * getFieldDotted.
+     */
+    class BSONFieldIndex {
+        MONGO_DISALLOW_COPYING(BSONFieldIndex);
+    public:
+        explicit BSONFieldIndex( const BSONObj& obj ) : _obj( obj ) { }
+
+        /**
+         * Same results as _obj.getField(name): the first element with that exact name, or an
+         * eoo element if there is none.
+         */
+        BSONElement getField( const StringData& name ) const;
+
+        const BSONObj& obj() const { return _obj; }
+
+    private:
+        void buildTable() const;
+
+        BSONObj _obj;
+
+        // Open-addressed (linear probe) table of element offsets into _obj's buffer.  Zero
+        // means an empty slot; real elements always start at offset >= 4.  Sized to a power of
+        // two at roughly half load.  Built on first lookup, hence mutable.
+        mutable std::vector<unsigned> _table;
+    };
+
+} // namespace mongo
@@ -0,0 +1,75 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/unittest/unittest.h"
+
+#include "mongo/bson/bson_field_index.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace {
+
+    using namespace mongo;
+
+    TEST( BSONFieldIndex, MatchesGetFieldOnWideObject ) {
+        BSONObjBuilder bob;
+        for ( int i = 0; i < 400; i++ ) {
+            const std::string name = mongoutils::str::stream() << "field" << i;
+            bob.append( name, i );
+        }
+        BSONObj obj = bob.obj();
+
+        BSONFieldIndex idx( obj );
+        for ( int i = 0; i < 400; i++ ) {
+            const std::string name = mongoutils::str::stream() << "field" << i;
+            BSONElement viaIndex = idx.getField( name );
+            BSONElement viaScan = obj.getField( name );
+            ASSERT_FALSE( viaIndex.eoo() );
+            ASSERT_EQUALS( viaScan.rawdata(), viaIndex.rawdata() );
+        }
+        ASSERT_TRUE( idx.getField( "notAField" ).eoo() );
+        ASSERT_TRUE( idx.getField( "field" ).eoo() );
+    }
+
+    TEST( BSONFieldIndex, EmptyObject ) {
+        BSONObj empty;
+        BSONFieldIndex idx( empty );
+        ASSERT_TRUE( idx.getField( "a" ).eoo() );
+    }
+
+    TEST( BSONFieldIndex, DuplicateFieldNamesKeepFirst ) {
+        BSONObjBuilder bob;
+        bob.append( "a", 1 );
+        bob.append( "a", 2 );
+        BSONObj obj = bob.obj();
+
+        BSONFieldIndex idx( obj );
+        ASSERT_EQUALS( 1, idx.getField( "a" ).numberInt() );
+        ASSERT_EQUALS( obj.getField( "a" ).rawdata(), idx.getField( "a" ).rawdata() );
+    }
+
+} // namespace
@@ -39,6 +39,26 @@ namespace {
         ASSERT_EQUALS(text, o1_str);
     }
 
+    TEST(BSONObjSharedBuffer, ViewsShareOneBuffer) {
+        const mongo::BSONObj a = BSON("a" << 1);
+        const mongo::BSONObj b = BSON("b" << "two");
+
+        mongo::SharedBuffer backing = mongo::SharedBuffer::allocate(a.objsize() + b.objsize());
+        memcpy(backing.get(), a.objdata(), a.objsize());
+        memcpy(backing.get() + a.objsize(), b.objdata(), b.objsize());
+
+        mongo::BSONObj viewA(backing.get(), backing);
+        mongo::BSONObj viewB(viewA.objdata() + viewA.objsize(), backing.moveFrom());
+
+        ASSERT_TRUE(viewA.isOwned());
+        ASSERT_TRUE(viewB.isOwned());
+        ASSERT_EQUALS(a, viewA);
+        ASSERT_EQUALS(b, viewB);
+        // Both views reference the same allocation.
+        ASSERT_EQUALS(static_cast<const void*>(viewA.sharedBuffer().get()),
+                      static_cast<const void*>(viewB.sharedBuffer().get()));
+    }
+
     TEST(BSONObjCompare, NumberDouble) {
         ASSERT_LT(BSON("" << 0.0), BSON("" << 1.0));
         ASSERT_LT(BSON("" << -1.0), BSON("" << 0.0));
@@ -34,6 +34,7 @@
 #include "mongo/bson/bson_validate.h"
 #include "mongo/bson/oid.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/platform/bits.h"
 
 namespace mongo {
 
@@ -71,10 +72,28 @@ namespace mongo {
             }
 
             Status readCString( StringData* out ) {
-                const void* x = memchr( _buffer + _position, 0, _maxLength - _position );
+                // Field names are typically short, so scan for the terminator a machine word
+                // at a time: any zero byte in the word lights up the corresponding high bit in
+                // 'zeroes', and countTrailingZeros64 says which byte it was (we read little
+                // endian, so low bytes come first).  The call into memchr only happens for the
+                // unaligned tail of the buffer.
+                const char* p = _buffer + _position;
+                const char* end = _buffer + _maxLength;
+                const char* x = NULL;
+                while ( p + sizeof(uint64_t) <= end ) {
+                    uint64_t w = ConstDataView( p ).readLE<uint64_t>();
+                    uint64_t zeroes = ( w - 0x0101010101010101ULL ) & ~w & 0x8080808080808080ULL;
+                    if ( zeroes ) {
+                        x = p + ( countTrailingZeros64( zeroes ) >> 3 );
+                        break;
+                    }
+                    p += sizeof(uint64_t);
+                }
+                if ( !x && p < end )
+                    x = static_cast<const char*>( memchr( p, 0, end - p ) );
                 if ( !x )
                     return makeError("no end of c-string", _idElem);
-                uint64_t len = static_cast<uint64_t>( static_cast<const char*>(x) - ( _buffer + _position ) );
+                uint64_t len = static_cast<uint64_t>( x - ( _buffer + _position ) );
 
                 StringData data( _buffer + _position, len );
                 _position += len + 1;
@@ -190,6 +190,16 @@ namespace {
         ASSERT_OK( validateBSON( x.objdata(), x.objsize() ) );
     }
 
+    TEST( BSONValidateFast, FieldNamesOfEveryLength ) {
+        // exercise the word-at-a-time c-string scan with terminators at every offset
+        // within and across 8-byte words.
+        for ( int len = 1; len <= 24; len++ ) {
+            const std::string name( len, 'x' );
+            BSONObj x = BSON( name << 17 );
+            ASSERT_OK( validateBSON( x.objdata(), x.objsize() ) );
+        }
+    }
+
     TEST( BSONValidateFast, RegEx ) {
         BSONObjBuilder b;
         b.appendRegex( "foo", "i" );
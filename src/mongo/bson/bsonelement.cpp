@@ -972,6 +972,183 @@ namespace {
         }
         return -1;
     }
- 
+
+namespace {
+
+    typedef int (*ElementValueComparator)(const BSONElement& l, const BSONElement& r);
+
+    // Everything not covered by a specialized comparator below (including MinKey,
+    // MaxKey, objects, and any mixed-canonical-type pair) funnels through here.
+    int cmpGeneric(const BSONElement& l, const BSONElement& r) {
+        return l.woCompare(r, false);
+    }
+
+    int cmpDoubleDouble(const BSONElement& l, const BSONElement& r) {
+        return compareDoubles(l._numberDouble(), r._numberDouble());
+    }
+    int cmpDoubleInt(const BSONElement& l, const BSONElement& r) {
+        return compareDoubles(l._numberDouble(), r._numberInt());
+    }
+    int cmpDoubleLong(const BSONElement& l, const BSONElement& r) {
+        return compareDoubleToLong(l._numberDouble(), r._numberLong());
+    }
+    int cmpIntDouble(const BSONElement& l, const BSONElement& r) {
+        return compareDoubles(l._numberInt(), r._numberDouble());
+    }
+    int cmpIntInt(const BSONElement& l, const BSONElement& r) {
+        return compareInts(l._numberInt(), r._numberInt());
+    }
+    int cmpIntLong(const BSONElement& l, const BSONElement& r) {
+        return compareLongs(l._numberInt(), r._numberLong());
+    }
+    int cmpLongDouble(const BSONElement& l, const BSONElement& r) {
+        return compareLongToDouble(l._numberLong(), r._numberDouble());
+    }
+    int cmpLongInt(const BSONElement& l, const BSONElement& r) {
+        return compareLongs(l._numberLong(), r._numberInt());
+    }
+    int cmpLongLong(const BSONElement& l, const BSONElement& r) {
+        return compareLongs(l._numberLong(), r._numberLong());
+    }
+
+    // Valid for String, Symbol and Code, which share the <size><cstring> layout.
+    // No collation in this sort order, so a plain memcmp is exact.
+    int cmpStringLike(const BSONElement& l, const BSONElement& r) {
+        int lsz = l.valuestrsize();
+        int rsz = r.valuestrsize();
+        int common = std::min(lsz, rsz);
+        int res = memcmp(l.valuestr(), r.valuestr(), common);
+        if( res )
+            return res;
+        return lsz - rsz;
+    }
+
+    int cmpOidOid(const BSONElement& l, const BSONElement& r) {
+        return memcmp(l.value(), r.value(), OID::kOIDSize);
+    }
+    int cmpBoolBool(const BSONElement& l, const BSONElement& r) {
+        return *l.value() - *r.value();
+    }
+    int cmpDateDate(const BSONElement& l, const BSONElement& r) {
+        long long a = (long long) l.Date().millis;
+        long long b = (long long) r.Date().millis;
+        if( a < b )
+            return -1;
+        return a == b ? 0 : 1;
+    }
+    int cmpTimestampTimestamp(const BSONElement& l, const BSONElement& r) {
+        if ( l.date() < r.date() )
+            return -1;
+        return l.date() == r.date() ? 0 : 1;
+    }
+    int cmpNullNull(const BSONElement& l, const BSONElement& r) {
+        return 0;
+    }
+    int cmpRegExRegEx(const BSONElement& l, const BSONElement& r) {
+        int c = strcmp(l.regex(), r.regex());
+        if ( c )
+            return c;
+        return strcmp(l.regexFlags(), r.regexFlags());
+    }
+    int cmpDBRefDBRef(const BSONElement& l, const BSONElement& r) {
+        int lsz = l.valuesize();
+        int rsz = r.valuesize();
+        if ( lsz - rsz != 0 ) return lsz - rsz;
+        return memcmp(l.value(), r.value(), lsz);
+    }
+    int cmpBinDataBinData(const BSONElement& l, const BSONElement& r) {
+        int lsz = l.objsize();
+        int rsz = r.objsize();
+        if ( lsz - rsz != 0 ) return lsz - rsz;
+        return memcmp(l.value()+4, r.value()+4, lsz+1 /*+1 for subtype byte*/);
+    }
+
+    /**
+     * Maps each type byte to a dense 4-bit slot and each slot pair to a
+     * comparator, giving a single indexed load per comparison: 256 entries for
+     * the 16x16 slot pairs. Slot 0 collects every type without a specialized
+     * comparator; any pair involving it (or any unspecialized pair) gets
+     * cmpGeneric.
+     */
+    class ElementValueComparatorTable {
+        static const int kNumSlots = 16;
+    public:
+        ElementValueComparatorTable() {
+            memset(_slotForType, 0, sizeof(_slotForType));
+            for (int i = 0; i < kNumSlots * kNumSlots; i++)
+                _comparators[i] = &cmpGeneric;
+
+            int next = 1;
+            const int doubleSlot = _assign(NumberDouble, next++);
+            const int intSlot = _assign(NumberInt, next++);
+            const int longSlot = _assign(NumberLong, next++);
+            const int stringSlot = _assign(String, next++);
+            const int symbolSlot = _assign(Symbol, next++);
+            const int codeSlot = _assign(Code, next++);
+            const int oidSlot = _assign(jstOID, next++);
+            const int boolSlot = _assign(Bool, next++);
+            const int dateSlot = _assign(Date, next++);
+            const int timestampSlot = _assign(Timestamp, next++);
+            const int nullSlot = _assign(jstNULL, next++);
+            const int regexSlot = _assign(RegEx, next++);
+            const int dbrefSlot = _assign(DBRef, next++);
+            const int bindataSlot = _assign(BinData, next++);
+            verify( next <= kNumSlots );
+
+            _set(doubleSlot, doubleSlot, &cmpDoubleDouble);
+            _set(doubleSlot, intSlot, &cmpDoubleInt);
+            _set(doubleSlot, longSlot, &cmpDoubleLong);
+            _set(intSlot, doubleSlot, &cmpIntDouble);
+            _set(intSlot, intSlot, &cmpIntInt);
+            _set(intSlot, longSlot, &cmpIntLong);
+            _set(longSlot, doubleSlot, &cmpLongDouble);
+            _set(longSlot, intSlot, &cmpLongInt);
+            _set(longSlot, longSlot, &cmpLongLong);
+
+            // String and Symbol share a canonical type, so they compare by value
+            // against each other; Code only compares by value against itself.
+            _set(stringSlot, stringSlot, &cmpStringLike);
+            _set(stringSlot, symbolSlot, &cmpStringLike);
+            _set(symbolSlot, stringSlot, &cmpStringLike);
+            _set(symbolSlot, symbolSlot, &cmpStringLike);
+            _set(codeSlot, codeSlot, &cmpStringLike);
+
+            _set(oidSlot, oidSlot, &cmpOidOid);
+            _set(boolSlot, boolSlot, &cmpBoolBool);
+            _set(dateSlot, dateSlot, &cmpDateDate);
+            _set(timestampSlot, timestampSlot, &cmpTimestampTimestamp);
+            _set(nullSlot, nullSlot, &cmpNullNull);
+            _set(regexSlot, regexSlot, &cmpRegExRegEx);
+            _set(dbrefSlot, dbrefSlot, &cmpDBRefDBRef);
+            _set(bindataSlot, bindataSlot, &cmpBinDataBinData);
+        }
+
+        ElementValueComparator get(int lType, int rType) const {
+            const int lSlot = _slotForType[lType & 0xff];
+            const int rSlot = _slotForType[rType & 0xff];
+            return _comparators[(lSlot << 4) | rSlot];
+        }
+
+    private:
+        int _assign(BSONType t, int slot) {
+            _slotForType[static_cast<int>(t) & 0xff] = slot;
+            return slot;
+        }
+
+        void _set(int lSlot, int rSlot, ElementValueComparator cmp) {
+            _comparators[(lSlot << 4) | rSlot] = cmp;
+        }
+
+        unsigned char _slotForType[256];
+        ElementValueComparator _comparators[kNumSlots * kNumSlots];
+    };
+
+    const ElementValueComparatorTable elementValueComparatorTable;
+
+} // namespace
+
+    int compareElementsFast(const BSONElement& l, const BSONElement& r) {
+        return elementValueComparatorTable.get(l.type(), r.type())(l, r);
+    }
 
 } // namespace mongo
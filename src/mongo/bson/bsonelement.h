@@ -53,6 +53,14 @@ namespace mongo {
     /* l and r MUST have same type when called: check that first. */
     int compareElementValues(const BSONElement& l, const BSONElement& r);
 
+    /** As l.woCompare(r, false): orders values without field names, with the usual
+        mixed-numeric semantics.  Dispatches on the (l.type(), r.type()) pair through
+        a precomputed comparator table, so the common same-type comparisons (numbers,
+        strings, ObjectIds, dates) go straight to a specialized comparator instead of
+        through the canonical-type and value-type switches.  Intended for hot
+        comparison loops such as in-memory sorts. */
+    int compareElementsFast(const BSONElement& l, const BSONElement& r);
+
 
     /** BSONElement represents an "element" in a BSONObj.  So for the object { a : 3, b : "abc" },
         'a : 3' is the first element (key+value).
@@ -111,6 +111,15 @@ namespace mongo {
                 , _ownedBuffer(ownedBuffer.moveFrom()) {
         }
 
+        /** Construct a BSONObj viewing data at 'bsonData', which must lie inside 'ownedBuffer'.
+         *  The object shares ownership of the buffer, so several BSONObjs packed into one
+         *  allocation cost a refcount bump apiece rather than a copy.
+         */
+        BSONObj(const char* bsonData, SharedBuffer ownedBuffer)
+                : _ownedBuffer(ownedBuffer.moveFrom()) {
+            init(bsonData);
+        }
+
 #if __cplusplus >= 201103L
         /** Move construct a BSONObj */
         BSONObj(BSONObj&& other)
@@ -172,6 +181,12 @@ namespace mongo {
         */
         bool isOwned() const { return _ownedBuffer.get() != 0; }
 
+        /** The buffer this object shares ownership of, or an empty SharedBuffer if !isOwned().
+            Lets callers (e.g. Message::appendSharedData) keep the object's storage alive
+            without copying it.
+        */
+        SharedBuffer sharedBuffer() const { return _ownedBuffer; }
+
         /** assure the data buffer is under the control of this BSONObj and not a remote buffer
             @see isOwned()
         */
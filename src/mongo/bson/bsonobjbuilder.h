@@ -46,6 +46,7 @@
 #include "mongo/bson/bsonelement.h"
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/util/builder_arena.h"
 #include "mongo/client/export_macros.h"
 
 namespace mongo {
@@ -724,6 +725,31 @@ namespace mongo {
         static bool numStrsReady; // for static init safety
     };
 
+    /** A BSONObjBuilder whose backing buffer is drawn from a BufBuilderArena instead of its own
+        heap allocation.  Use for short-lived documents built while servicing one operation; the
+        buffer goes back to the arena when the builder is destroyed.
+
+        The finished object points into arena-owned memory, so it must not outlive the arena (or
+        the builder's release back to it) - call done().getOwned() for anything that does.
+    */
+    class ArenaBSONObjBuilder : public BSONObjBuilder {
+    public:
+        explicit ArenaBSONObjBuilder( BufBuilderArena* arena )
+            : BSONObjBuilder( *arena->acquire() )
+            , _arena( arena ) {
+        }
+
+        ~ArenaBSONObjBuilder() {
+            doneFast(); // write the length in before the base destructor looks at the buffer
+            _arena->release( &bb() );
+        }
+
+    private:
+        BSONObj obj(); // not allowed: would steal the arena's buffer.  use done().
+
+        BufBuilderArena* _arena;
+    };
+
     class BSONArrayBuilder : boost::noncopyable {
     public:
         BSONArrayBuilder() : _i(0), _b() {}
@@ -1404,6 +1404,21 @@ namespace mutablebson {
     Element Element::findFirstChildNamed(const StringData& name) const {
         verify(ok());
         Document::Impl& impl = _doc->getImpl();
+
+        // If our substructure is completely unexplored, scan the serialized bytes first.
+        // When the name is absent -- the common case for mods that create a new field --
+        // this avoids materializing an ElementRep for every child, and leaves the
+        // children opaque for later navigation.
+        const ElementRep& thisRep = impl.getElementRep(_repIdx);
+        if (thisRep.serialized && (thisRep.child.left == kOpaqueRepIdx)) {
+            const BSONObj children =
+                impl.hasValue(thisRep) ?
+                impl.getSerializedElement(thisRep).embeddedObject() :
+                impl.getObject(thisRep.objIdx);
+            if (!children.hasField(name))
+                return Element(_doc, kInvalidRepIdx);
+        }
+
         Element::RepIdx current = _repIdx;
         current = impl.resolveLeftChild(current);
         // TODO: Could DRY this loop with the identical logic in findElementNamed.
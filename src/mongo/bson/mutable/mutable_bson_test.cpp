@@ -1291,6 +1291,29 @@ namespace {
         ASSERT_FALSE(doc.root().leftChild() == doc.root().rightChild());
     }
 
+    TEST(Element, FindFirstChildNamedOnUnexploredDocument) {
+        static const char inJson[] = "{ a : 1, b : { c : 2 }, d : 3 }";
+        mongo::BSONObj inObj = mongo::fromjson(inJson);
+        mmb::Document doc(inObj);
+
+        // A missing name answers without disturbing later navigation.
+        ASSERT_FALSE(doc.root().findFirstChildNamed("x").ok());
+
+        mmb::Element b = doc.root().findFirstChildNamed("b");
+        ASSERT_TRUE(b.ok());
+        ASSERT_FALSE(b.findFirstChildNamed("missing").ok());
+        ASSERT_TRUE(b.findFirstChildNamed("c").ok());
+
+        mmb::Element d = doc.root().findFirstChildNamed("d");
+        ASSERT_TRUE(d.ok());
+        ASSERT_EQUALS(3, d.getValueInt());
+
+        // After a mutation the document is partially explored; lookups still work.
+        ASSERT_OK(d.setValueInt(4));
+        ASSERT_FALSE(doc.root().findFirstChildNamed("x").ok());
+        ASSERT_TRUE(doc.root().findFirstChildNamed("a").ok());
+    }
+
     TEST(Document, AddChildToEmptyOpaqueSubobject) {
         mongo::BSONObj inObj = mongo::fromjson("{a: {}}");
         mmb::Document doc(inObj);
@@ -0,0 +1,95 @@
+/* builder_arena.h */
+
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/util/builder.h"
+
+namespace mongo {
+
+    /** A pool of reusable BufBuilders, intended to be scoped to a single operation.  Transient
+        BSON built while servicing the operation draws its backing buffers from here instead of
+        going to malloc/free for each short-lived document; buffers are recycled across documents
+        and released wholesale when the arena goes away.
+
+        Not thread safe - an arena belongs to the one thread running its operation, like the
+        OperationContext that owns it.
+    */
+    class BufBuilderArena {
+        MONGO_DISALLOW_COPYING(BufBuilderArena);
+    public:
+        BufBuilderArena() { }
+
+        ~BufBuilderArena() {
+            for ( size_t i = 0; i < _builders.size(); i++ )
+                delete _builders[i];
+        }
+
+        /** Get a builder from the arena.  The builder, and anything built on top of it, stays
+            valid until it is released back or the arena is destroyed.
+        */
+        BufBuilder* acquire() {
+            if ( _free.empty() ) {
+                _builders.push_back( new BufBuilder() );
+                return _builders.back();
+            }
+            BufBuilder* b = _free.back();
+            _free.pop_back();
+            return b;
+        }
+
+        /** Return 'builder' to the arena for reuse.  Its backing buffer is kept (trimmed if it
+            grew past maxRetainedBytes) so a later acquire() is just a pointer pop.
+        */
+        void release( BufBuilder* builder ) {
+            builder->reset( maxRetainedBytes );
+            _free.push_back( builder );
+        }
+
+        /** Total bytes currently held by the arena's buffers, for diagnostics. */
+        size_t retainedBytes() const {
+            size_t total = 0;
+            for ( size_t i = 0; i < _builders.size(); i++ )
+                total += _builders[i]->getSize();
+            return total;
+        }
+
+        // Buffers bigger than this are shrunk on release so one jumbo document doesn't pin
+        // memory for the rest of the operation.
+        static const int maxRetainedBytes = 64 * 1024;
+
+    private:
+        std::vector<BufBuilder*> _builders; // everything we own
+        std::vector<BufBuilder*> _free;     // the subset available for acquire()
+    };
+
+} // namespace mongo
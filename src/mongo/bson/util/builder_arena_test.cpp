@@ -0,0 +1,78 @@
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/unittest/unittest.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/util/builder_arena.h"
+
+namespace mongo {
+
+    TEST( BufBuilderArena, ReusesReleasedBuilder ) {
+        BufBuilderArena arena;
+        BufBuilder* a = arena.acquire();
+        a->appendStr( "transient" );
+        arena.release( a );
+
+        // A released builder comes back reset rather than freshly malloc'ed.
+        BufBuilder* b = arena.acquire();
+        ASSERT_EQUALS( a, b );
+        ASSERT_EQUALS( 0, b->len() );
+        arena.release( b );
+    }
+
+    TEST( BufBuilderArena, DistinctBuildersWhileBothLive ) {
+        BufBuilderArena arena;
+        BufBuilder* a = arena.acquire();
+        BufBuilder* b = arena.acquire();
+        ASSERT_NOT_EQUALS( a, b );
+        arena.release( a );
+        arena.release( b );
+    }
+
+    TEST( BufBuilderArena, JumboBuffersShrinkOnRelease ) {
+        BufBuilderArena arena;
+        BufBuilder* a = arena.acquire();
+        a->grow( 4 * BufBuilderArena::maxRetainedBytes );
+        arena.release( a );
+        ASSERT_LESS_THAN_OR_EQUALS( arena.retainedBytes(),
+                                    static_cast<size_t>( BufBuilderArena::maxRetainedBytes ) );
+    }
+
+    TEST( ArenaBSONObjBuilder, BuildsValidObjects ) {
+        BufBuilderArena arena;
+        for ( int i = 0; i < 3; i++ ) {
+            ArenaBSONObjBuilder bob( &arena );
+            bob.append( "a", i );
+            bob.append( "b", "arena" );
+            BSONObj o = bob.done();
+            ASSERT_EQUALS( i, o["a"].numberInt() );
+            ASSERT_EQUALS( std::string( "arena" ), o["b"].str() );
+        }
+    }
+
+} // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/client/syncclusterconnection.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 #include "mongo/s/shard.h"
 
 namespace mongo {
@@ -174,29 +175,55 @@ namespace mongo {
     const int PoolForHost::kPoolSizeUnlimited(-1);
 
     DBConnectionPool::DBConnectionPool()
-        : _mutex("DBConnectionPool") , 
-          _name( "dbconnectionpool" ) , 
+        : _mutex("DBConnectionPool") ,
+          _name( "dbconnectionpool" ) ,
           _maxPoolSize(PoolForHost::kPoolSizeUnlimited) ,
+          _minPoolSize(0) ,
           _hooks( new list<DBConnectionHook*>() ) {
     }
 
+    DBConnectionPool::PoolForHostPtr DBConnectionPool::_poolForKey( const PoolKey& key ) {
+        scoped_lock L(_mutex);
+        PoolForHostPtr& p = _pools[key];
+        if ( ! p )
+            p.reset( new PoolForHost() );
+        return p;
+    }
+
+    void DBConnectionPool::_snapshotPools( vector< pair<PoolKey,PoolForHostPtr> >* out ) {
+        scoped_lock L(_mutex);
+        out->reserve( _pools.size() );
+        for ( PoolMap::iterator i = _pools.begin(); i != _pools.end(); ++i ) {
+            out->push_back( *i );
+        }
+    }
+
+    void DBConnectionPool::_recordWaitTime( long long micros ) {
+        static const long long boundaries[kWaitTimeBuckets - 1] =
+            { 1000, 10 * 1000, 100 * 1000, 1000 * 1000, 10 * 1000 * 1000 };
+        int bucket = 0;
+        while ( bucket < kWaitTimeBuckets - 1 && micros >= boundaries[bucket] )
+            bucket++;
+        _waitTimeBuckets[bucket].fetchAndAdd( 1 );
+    }
+
     DBClientBase* DBConnectionPool::_get(const string& ident , double socketTimeout ) {
         uassert(17382, "Can't use connection pool during shutdown",
                 !inShutdown());
-        scoped_lock L(_mutex);
-        PoolForHost& p = _pools[PoolKey(ident,socketTimeout)];
-        p.setMaxPoolSize(_maxPoolSize);
-        p.initializeHostName(ident);
-        return p.get( this , socketTimeout );
+        PoolForHostPtr p = _poolForKey(PoolKey(ident,socketTimeout));
+        scoped_lock L(p->lock());
+        p->setMaxPoolSize(_maxPoolSize);
+        p->initializeHostName(ident);
+        return p->get( this , socketTimeout );
     }
 
     DBClientBase* DBConnectionPool::_finishCreate( const string& host , double socketTimeout , DBClientBase* conn ) {
         {
-            scoped_lock L(_mutex);
-            PoolForHost& p = _pools[PoolKey(host,socketTimeout)];
-            p.setMaxPoolSize(_maxPoolSize);
-            p.initializeHostName(host);
-            p.createdOne( conn );
+            PoolForHostPtr p = _poolForKey(PoolKey(host,socketTimeout));
+            scoped_lock L(p->lock());
+            p->setMaxPoolSize(_maxPoolSize);
+            p->initializeHostName(host);
+            p->createdOne( conn );
         }
         
         try {
@@ -212,6 +239,8 @@ namespace mongo {
     }
 
     DBClientBase* DBConnectionPool::get(const ConnectionString& url, double socketTimeout) {
+        Timer waitTimer;
+
         DBClientBase * c = _get( url.toString() , socketTimeout );
         if ( c ) {
             try {
@@ -221,6 +250,7 @@ namespace mongo {
                 delete c;
                 throw;
             }
+            _recordWaitTime( waitTimer.micros() );
             return c;
         }
 
@@ -228,10 +258,14 @@ namespace mongo {
         c = url.connect( errmsg, socketTimeout );
         uassert( 13328 ,  _name + ": connect failed " + url.toString() + " : " + errmsg , c );
 
-        return _finishCreate( url.toString() , socketTimeout , c );
+        c = _finishCreate( url.toString() , socketTimeout , c );
+        _recordWaitTime( waitTimer.micros() );
+        return c;
     }
 
     DBClientBase* DBConnectionPool::get(const string& host, double socketTimeout) {
+        Timer waitTimer;
+
         DBClientBase * c = _get( host , socketTimeout );
         if ( c ) {
             try {
@@ -241,6 +275,7 @@ namespace mongo {
                 delete c;
                 throw;
             }
+            _recordWaitTime( waitTimer.micros() );
             return c;
         }
 
@@ -251,7 +286,9 @@ namespace mongo {
         c = cs.connect( errmsg, socketTimeout );
         if ( ! c )
             throw SocketException( SocketException::CONNECT_ERROR , host , 11002 , str::stream() << _name << " error: " << errmsg );
-        return _finishCreate( host , socketTimeout , c );
+        c = _finishCreate( host , socketTimeout , c );
+        _recordWaitTime( waitTimer.micros() );
+        return c;
     }
 
     void DBConnectionPool::onRelease(DBClientBase* conn) {
@@ -267,8 +304,9 @@ namespace mongo {
     void DBConnectionPool::release(const string& host, DBClientBase *c) {
         onRelease(c);
 
-        scoped_lock L(_mutex);
-        _pools[PoolKey(host,c->getSoTimeout())].done(this,c);
+        PoolForHostPtr p = _poolForKey(PoolKey(host,c->getSoTimeout()));
+        scoped_lock L(p->lock());
+        p->done(this,c);
     }
 
 
@@ -277,29 +315,34 @@ namespace mongo {
     }
 
     void DBConnectionPool::flush() {
-        scoped_lock L(_mutex);
-        for ( PoolMap::iterator i = _pools.begin(); i != _pools.end(); i++ ) {
-            PoolForHost& p = i->second;
-            p.flush();
+        vector< pair<PoolKey,PoolForHostPtr> > pools;
+        _snapshotPools( &pools );
+        for ( size_t i = 0; i < pools.size(); i++ ) {
+            scoped_lock L(pools[i].second->lock());
+            pools[i].second->flush();
         }
     }
 
     void DBConnectionPool::clear() {
-        scoped_lock L(_mutex);
         LOG(2) << "Removing connections on all pools owned by " << _name  << endl;
-        for (PoolMap::iterator iter = _pools.begin(); iter != _pools.end(); ++iter) {
-            iter->second.clear();
+        vector< pair<PoolKey,PoolForHostPtr> > pools;
+        _snapshotPools( &pools );
+        for ( size_t i = 0; i < pools.size(); i++ ) {
+            scoped_lock L(pools[i].second->lock());
+            pools[i].second->clear();
         }
     }
 
     void DBConnectionPool::removeHost( const string& host ) {
-        scoped_lock L(_mutex);
         LOG(2) << "Removing connections from all pools for host: " << host << endl;
-        for ( PoolMap::iterator i = _pools.begin(); i != _pools.end(); ++i ) {
-            const string& poolHost = i->first.ident;
+        vector< pair<PoolKey,PoolForHostPtr> > pools;
+        _snapshotPools( &pools );
+        for ( size_t i = 0; i < pools.size(); i++ ) {
+            const string& poolHost = pools[i].first.ident;
             if ( !serverNameCompare()(host, poolHost) && !serverNameCompare()(poolHost, host) ) {
                 // hosts are the same
-                i->second.clear();
+                scoped_lock L(pools[i].second->lock());
+                pools[i].second->clear();
             }
         }
     }
@@ -345,23 +388,26 @@ namespace mongo {
         
         BSONObjBuilder bb( b.subobjStart( "hosts" ) );
         {
-            scoped_lock lk( _mutex );
-            for ( PoolMap::iterator i=_pools.begin(); i!=_pools.end(); ++i ) {
-                if ( i->second.numCreated() == 0 )
+            vector< pair<PoolKey,PoolForHostPtr> > pools;
+            _snapshotPools( &pools );
+            for ( size_t i = 0; i < pools.size(); i++ ) {
+                PoolForHost& p = *pools[i].second;
+                scoped_lock lk( p.lock() );
+                if ( p.numCreated() == 0 )
                     continue;
 
-                string s = str::stream() << i->first.ident << "::" << i->first.timeout;
+                string s = str::stream() << pools[i].first.ident << "::" << pools[i].first.timeout;
 
                 BSONObjBuilder temp( bb.subobjStart( s ) );
-                temp.append( "available" , i->second.numAvailable() );
-                temp.appendNumber( "created" , i->second.numCreated() );
+                temp.append( "available" , p.numAvailable() );
+                temp.appendNumber( "created" , p.numCreated() );
                 temp.done();
 
-                avail += i->second.numAvailable();
-                created += i->second.numCreated();
+                avail += p.numAvailable();
+                created += p.numCreated();
 
-                long long& x = createdByType[i->second.type()];
-                x += i->second.numCreated();
+                long long& x = createdByType[p.type()];
+                x += p.numCreated();
             }
         }
         bb.done();
@@ -392,6 +438,16 @@ namespace mongo {
             temp.done();
         }
 
+        {
+            static const char* bucketNames[kWaitTimeBuckets] =
+                { "<1ms", "1-10ms", "10-100ms", "100ms-1s", "1-10s", ">=10s" };
+            BSONObjBuilder temp( b.subobjStart( "poolWaitTimes" ) );
+            for ( int i = 0; i < kWaitTimeBuckets; i++ ) {
+                temp.appendNumber( bucketNames[i], _waitTimeBuckets[i].load() );
+            }
+            temp.done();
+        }
+
         b.append( "totalAvailable" , avail );
         b.appendNumber( "totalCreated" , created );
     }
@@ -442,9 +498,9 @@ namespace mongo {
         }
 
         {
-            scoped_lock sl(_mutex);
-            PoolForHost& pool = _pools[PoolKey(hostName, conn->getSoTimeout())];
-            if (pool.isBadSocketCreationTime(conn->getSockCreationMicroSec())) {
+            PoolForHostPtr p = _poolForKey(PoolKey(hostName, conn->getSoTimeout()));
+            scoped_lock sl(p->lock());
+            if (p->isBadSocketCreationTime(conn->getSockCreationMicroSec())) {
                 return false;
             }
         }
@@ -452,15 +508,18 @@ namespace mongo {
         return true;
     }
 
-    void DBConnectionPool::taskDoWork() { 
+    void DBConnectionPool::taskDoWork() {
         vector<DBClientBase*> toDelete;
-        
+
+        vector< pair<PoolKey,PoolForHostPtr> > pools;
+        _snapshotPools( &pools );
+
         {
             // we need to get the connections inside the lock
             // but we can actually delete them outside
-            scoped_lock lk( _mutex );
-            for ( PoolMap::iterator i=_pools.begin(); i!=_pools.end(); ++i ) {
-                i->second.getStaleConnections( toDelete );
+            for ( size_t i = 0; i < pools.size(); i++ ) {
+                scoped_lock lk( pools[i].second->lock() );
+                pools[i].second->getStaleConnections( toDelete );
             }
         }
 
@@ -473,6 +532,51 @@ namespace mongo {
                 // we don't care if there was a socket error
             }
         }
+
+        // Pre-establish connections for hosts whose pool has fallen below the floor, so
+        // the next caller finds a warm connection instead of paying a connect. This runs
+        // on the periodic task thread; no caller ever waits on a connect we start here.
+        if ( _minPoolSize > 0 ) {
+            for ( size_t i = 0; i < pools.size() && !inShutdown(); i++ ) {
+                int needed = 0;
+                {
+                    scoped_lock lk( pools[i].second->lock() );
+                    // only warm hosts that have actually been used
+                    if ( pools[i].second->numCreated() == 0 )
+                        continue;
+                    needed = _minPoolSize - pools[i].second->numAvailable();
+                }
+
+                const PoolKey& key = pools[i].first;
+                for ( int n = 0; n < needed && !inShutdown(); n++ ) {
+                    try {
+                        string errmsg;
+                        ConnectionString cs = ConnectionString::parse( key.ident, errmsg );
+                        if ( ! cs.isValid() )
+                            break;
+
+                        DBClientBase* c = cs.connect( errmsg, key.timeout );
+                        if ( ! c ) {
+                            LOG(1) << "pool warm-up connect failed for " << key.ident
+                                   << ": " << errmsg << endl;
+                            break;
+                        }
+
+                        {
+                            scoped_lock lk( pools[i].second->lock() );
+                            pools[i].second->createdOne( c );
+                        }
+                        onCreate( c );
+                        release( key.ident, c );
+                    }
+                    catch ( const std::exception& e ) {
+                        LOG(1) << "pool warm-up failed for " << key.ident
+                               << causedBy( e ) << endl;
+                        break;
+                    }
+                }
+            }
+        }
     }
 
     // ------ ScopedDbConnection ------
@@ -30,6 +30,7 @@
 #pragma once
 
 #include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
 #include <stack>
 
 #include "mongo/client/dbclientinterface.h"
@@ -45,7 +46,9 @@ namespace mongo {
 
     /**
      * not thread safe
-     * thread safety is handled by DBConnectionPool
+     * thread safety is handled by DBConnectionPool, which serializes access to each
+     * host's pool under lock() so traffic to one host never contends with traffic to
+     * another
      */
     class MONGO_CLIENT_API PoolForHost {
     public:
@@ -54,20 +57,17 @@ namespace mongo {
         static const int kPoolSizeUnlimited;
 
         PoolForHost() :
+            _lock("PoolForHost"),
             _created(0),
             _minValidCreationTimeMicroSec(0),
             _type(ConnectionString::INVALID),
             _maxPoolSize(kPoolSizeUnlimited) {
         }
 
-        PoolForHost(const PoolForHost& other) :
-            _created(other._created),
-            _minValidCreationTimeMicroSec(other._minValidCreationTimeMicroSec),
-            _type(other._type),
-            _maxPoolSize(other._maxPoolSize) {
-            verify(_created == 0);
-            verify(other._pool.size() == 0);
-        }
+        /**
+         * The per-host lock; see the class comment.
+         */
+        mongo::mutex& lock() { return _lock; }
 
         ~PoolForHost();
 
@@ -130,6 +130,8 @@ namespace mongo {
             time_t when;
         };
 
+        mongo::mutex _lock;
+
         std::string _hostName;
         std::stack<StoredConnection> _pool;
 
@@ -191,6 +193,18 @@ namespace mongo {
          */
         void setMaxPoolSize( int maxPoolSize ) { _maxPoolSize = maxPoolSize; }
 
+        /**
+         * Returns the number of connections the background replenisher tries to keep
+         * available per-host. 0 means no warm-up is performed.
+         */
+        int getMinPoolSize() { return _minPoolSize; }
+
+        /**
+         * Sets the number of connections the background replenisher tries to keep
+         * available per-host. Only hosts that have been used at least once are warmed.
+         */
+        void setMinPoolSize( int minPoolSize ) { _minPoolSize = minPoolSize; }
+
         void onCreate( DBClientBase * conn );
         void onHandedOut( DBClientBase * conn );
         void onDestroy( DBClientBase * conn );
@@ -250,7 +264,26 @@ namespace mongo {
             bool operator()( const PoolKey& a , const PoolKey& b ) const;
         };
 
-        typedef std::map<PoolKey,PoolForHost,poolKeyCompare> PoolMap; // servername -> pool
+        // Hosts are held by shared_ptr so _mutex only covers the map itself; all work on
+        // one host's pool happens under that host's own lock.
+        typedef boost::shared_ptr<PoolForHost> PoolForHostPtr;
+        typedef std::map<PoolKey,PoolForHostPtr,poolKeyCompare> PoolMap; // servername -> pool
+
+        /**
+         * Returns the pool for 'key', creating it if this is the first time the host is
+         * seen. Only locks _mutex; the caller locks the returned pool as needed.
+         */
+        PoolForHostPtr _poolForKey( const PoolKey& key );
+
+        /**
+         * Copies all current (key, pool) entries out under _mutex so they can be visited
+         * without holding the map lock.
+         */
+        void _snapshotPools( std::vector< std::pair<PoolKey,PoolForHostPtr> >* out );
+
+        void _recordWaitTime( long long micros );
+
+        static const int kWaitTimeBuckets = 6;
 
         mongo::mutex _mutex;
         std::string _name;
@@ -260,8 +293,15 @@ namespace mongo {
         // 0 effectively disables the pool
         int _maxPoolSize;
 
+        // Connections per host the periodic task tries to keep pre-established; 0 (the
+        // default) disables warm-up
+        int _minPoolSize;
+
         PoolMap _pools;
 
+        // histogram of time callers spent in get(), reported by appendInfo()
+        AtomicInt64 _waitTimeBuckets[kWaitTimeBuckets];
+
         // pointers owned by me, right now they leak on shutdown
         // _hooks itself also leaks because it creates a shutdown race condition
         std::list<DBConnectionHook*> * _hooks;
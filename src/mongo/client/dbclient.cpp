@@ -1558,6 +1558,31 @@ namespace mongo {
         return false;
     }
 
+    MSGID DBClientConnection::sayPipelined( Message &toSend ) {
+        checkConnection();
+        try {
+            return port().sayPipelined( toSend );
+        }
+        catch( SocketException & ) {
+            _failed = true;
+            throw;
+        }
+    }
+
+    bool DBClientConnection::recvPipelined( MSGID requestId, Message &response ) {
+        try {
+            if ( port().recvPipelined( requestId, response ) )
+                return true;
+        }
+        catch( SocketException & ) {
+            _failed = true;
+            throw;
+        }
+
+        _failed = true;
+        return false;
+    }
+
     bool DBClientConnection::call( Message &toSend, Message &response, bool assertOk , string * actualServer ) {
         /* todo: this is very ugly messagingport::call returns an error code AND can throw
                  an exception.  we should make it return void and just throw an exception anytime
@@ -1634,6 +1659,15 @@ namespace mongo {
             say(m);
     }
 
+    void DBClientConnection::abandonExhaustStream() {
+        /* connection CANNOT be used anymore as more data may be on the way from the server.
+           we have to reconnect.
+           */
+        _failed = true;
+        if ( p )
+            p->shutdown();
+    }
+
 #ifdef MONGO_SSL
     static SimpleMutex s_mtx("SSLManager");
     static SSLManagerInterface* s_sslMgr(NULL);
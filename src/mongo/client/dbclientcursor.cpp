@@ -154,6 +154,15 @@ namespace mongo {
     void DBClientCursor::requestMore() {
         verify( cursorId && batch.pos == batch.nReturned );
 
+        // An exhaust cursor never asks for more: after the initial reply the server
+        // pipelines the remaining batches on its own, so the next one is simply
+        // received off the socket. This lets pull-style consumers (more()/next())
+        // stream in exhaust mode too, not just the callback form of query().
+        if ( opts & QueryOption_Exhaust ) {
+            exhaustReceiveMore();
+            return;
+        }
+
         if (haveLimit) {
             nToReturn -= batch.nReturned;
             verify(nToReturn > 0);
@@ -357,6 +366,16 @@ namespace mongo {
         DESTRUCTOR_GUARD (
 
         if ( cursorId && _ownCursor && ! inShutdown() ) {
+
+            if ( opts & QueryOption_Exhaust ) {
+                // The server streams batches until the cursor is drained or the socket
+                // closes; a killCursors message cannot stop it and replies are already
+                // in flight, so the connection must be failed rather than reused.
+                if ( _client )
+                    _client->abandonExhaustStream();
+                return;
+            }
+
             BufBuilder b;
             b.appendNum( (int)0 ); // reserved
             b.appendNum( (int)1 ); // number
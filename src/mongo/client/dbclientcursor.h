@@ -174,6 +174,12 @@ namespace mongo {
 
         long long getCursorId() const { return cursorId; }
 
+        /** true for an exhaust cursor: after the initial reply the server pushes the
+            remaining batches on its own, with no getMore round trips. While such a
+            cursor is live the connection cannot be used for anything else, and
+            abandoning it mid-stream fails the connection (see ~DBClientCursor). */
+        bool isExhaust() const { return ( opts & QueryOption_Exhaust ) != 0; }
+
         /** by default we "own" the cursor and will send the server a KillCursor
             message when ~DBClientCursor() is called. This function overrides that.
         */
@@ -1202,6 +1202,15 @@ namespace mongo {
 
         virtual void killCursor( long long cursorID ) = 0;
 
+        /**
+         * Called by ~DBClientCursor when an exhaust cursor is abandoned with replies
+         * still in flight. The server keeps streaming batches until the cursor is
+         * drained or the socket closes, so the connection cannot be reused for any
+         * other request; connection types that serve exhaust cursors fail and close
+         * it here. No-op elsewhere.
+         */
+        virtual void abandonExhaustStream() {}
+
         virtual bool callRead( Message& toSend , Message& response ) = 0;
         // virtual bool callWrite( Message& toSend , Message& response ) = 0; // TODO: add this if needed
 
@@ -1320,9 +1329,20 @@ namespace mongo {
         const HostAndPort& getServerHostAndPort() const { return _server; }
 
         virtual void killCursor( long long cursorID );
+        virtual void abandonExhaustStream();
         virtual bool callRead( Message& toSend , Message& response ) { return call( toSend , response ); }
         virtual void say( Message &toSend, bool isRetry = false , std::string * actualServer = 0 );
         virtual bool recv( Message& m );
+
+        /**
+         * Pipelined requests: sends 'toSend' immediately and returns its message id;
+         * several requests may be in flight on this connection before any reply is
+         * read. Collect each reply with recvPipelined(), in any order - replies are
+         * matched to requests by message id.
+         */
+        MSGID sayPipelined( Message& toSend );
+        bool recvPipelined( MSGID requestId, Message& response );
+
         virtual void checkResponse( const char *data, int nReturned, bool* retry = NULL, std::string* host = NULL );
         virtual bool call( Message &toSend, Message &response, bool assertOk = true , std::string * actualServer = 0 );
         virtual ConnectionString::ConnectionType type() const { return ConnectionString::MASTER; }
@@ -242,22 +242,73 @@ namespace mongo {
         return GridFSChunk(o);
     }
 
+    auto_ptr<DBClientCursor> GridFile::_chunkCursor() const {
+        BSONObjBuilder b;
+        b.appendAs( _obj["_id"] , "files_id" );
+
+        Query q( b.obj() );
+        q.sort( BSON( "n" << 1 ) );
+
+        return _grid->_client.query( _grid->_chunksNS.c_str() , q );
+    }
+
     gridfs_offset GridFile::write( ostream & out ) const {
         _exists();
 
+        // One ordered cursor over all chunks: each getMore pulls a batch of
+        // chunks in a single round trip, instead of the query-per-chunk that
+        // getChunk() would cost us.
         const int num = getNumChunks();
+        auto_ptr<DBClientCursor> cursor = _chunkCursor();
 
         for ( int i=0; i<num; i++ ) {
-            GridFSChunk c = getChunk( i );
+            uassert( 28720 , str::stream() << "missing chunk " << i << " of " << num ,
+                     cursor->more() );
+            BSONObj o = cursor->nextSafe();
+            uassert( 28721 , "chunks are out of order" , o["n"].numberInt() == i );
 
             int len;
-            const char * data = c.data( len );
+            const char * data = o["data"].binDataClean( len );
             out.write( data , len );
         }
 
         return getContentLength();
     }
 
+    gridfs_offset GridFile::write( char * buf , gridfs_offset bufSize ) const {
+        _exists();
+
+        uassert( 28722 , "buffer is too small for file contents" ,
+                 bufSize >= getContentLength() );
+
+        const int num = getNumChunks();
+        auto_ptr<DBClientCursor> cursor = _chunkCursor();
+
+        gridfs_offset written = 0;
+        for ( int i=0; i<num; i++ ) {
+            uassert( 28723 , str::stream() << "missing chunk " << i << " of " << num ,
+                     cursor->more() );
+            BSONObj o = cursor->nextSafe();
+            uassert( 28724 , "chunks are out of order" , o["n"].numberInt() == i );
+
+            int len;
+            const char * data = o["data"].binDataClean( len );
+
+            // files.length and the chunks are independently writable, so don't
+            // trust their sizes to agree: a chunk stream longer than the
+            // declared length would otherwise overrun the caller's buffer
+            uassert( 28729 , "chunk data exceeds declared file length" ,
+                     len >= 0 && written + len <= bufSize );
+
+            // copy straight from the cursor's current batch into the caller's
+            // buffer; the chunk bytes are never staged anywhere else
+            memcpy( buf + written , data , len );
+            written += len;
+        }
+
+        return written;
+    }
+
     gridfs_offset GridFile::write( const string& where ) const {
         if (where == "-") {
             return write( cout );
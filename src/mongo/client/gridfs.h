@@ -197,6 +197,10 @@ namespace mongo {
 
         /**
            write the file to the output stream
+
+           Streams all chunks through a single ordered cursor rather than one
+           query per chunk, so the driver's batching keeps the next chunks in
+           flight while earlier ones are written.
          */
         gridfs_offset write( std::ostream & out ) const;
 
@@ -205,9 +209,22 @@ namespace mongo {
          */
         gridfs_offset write( const std::string& where ) const;
 
+        /**
+           write the file contents into the caller's buffer, copying each chunk
+           straight out of the cursor batch with no intermediate buffering
+
+           @param buf destination buffer
+           @param bufSize size of the buffer; must be at least getContentLength()
+           @return number of bytes written
+         */
+        gridfs_offset write( char * buf , gridfs_offset bufSize ) const;
+
     private:
         GridFile(const GridFS * grid , BSONObj obj );
 
+        /** cursor over all of this file's chunks, ordered by chunk number */
+        std::auto_ptr<DBClientCursor> _chunkCursor() const;
+
         void _exists() const;
 
         const GridFS * _grid;
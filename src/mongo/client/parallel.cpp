@@ -50,6 +50,7 @@
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/version_manager.h"
 #include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -255,7 +256,8 @@ namespace mongo {
     // --------  ParallelSortClusteredCursor -----------
 
     ParallelSortClusteredCursor::ParallelSortClusteredCursor( const QuerySpec& qSpec, const CommandInfo& cInfo )
-        : _qSpec( qSpec ), _cInfo( cInfo ), _totalTries( 0 )
+        : _qSpec( qSpec ), _cInfo( cInfo ), _totalTries( 0 ),
+          _prefetchMutex( "ParallelSortClusteredCursor::prefetch" )
     {
         _done = false;
         _didInit = false;
@@ -267,7 +269,8 @@ namespace mongo {
     ParallelSortClusteredCursor::ParallelSortClusteredCursor( const set<ServerAndQuery>& servers , const string& ns ,
             const Query& q ,
             int options , const BSONObj& fields  )
-        : _servers( servers ) {
+        : _servers( servers ),
+          _prefetchMutex( "ParallelSortClusteredCursor::prefetch" ) {
 
         _sortKey = q.getSort().copy();
         _needToSkip = 0;
@@ -289,6 +292,8 @@ namespace mongo {
         _numServers = _servers.size();
         _lastFrom = 0;
         _cursors = 0;
+        _prefetching = -1;
+        _prefetchShutdown = false;
 
         if( ! _qSpec.isEmpty() ){
             _needToSkip = _qSpec.ntoskip();
@@ -788,6 +793,7 @@ namespace mongo {
                 }
 
                 bool lazyInit = state->conn->get()->lazySupported();
+                mdata.dispatchMicros = curTimeMicros64();
                 if( lazyInit ){
 
                     // Need to keep track if this is a second or third try for replica sets
@@ -818,6 +824,7 @@ namespace mongo {
                     mdata.retryNext = false;
                     mdata.initialized = true;
                     mdata.finished = true;
+                    mdata.replyMicros = curTimeMicros64();
                 }
 
 
@@ -958,6 +965,7 @@ namespace mongo {
                         }
                     }
 
+                    mdata.replyMicros = curTimeMicros64();
                     mdata.completed = false;
                 }
 
@@ -1160,6 +1168,16 @@ namespace mongo {
         else return i->second.pcState->cursor;
     }
 
+    long long ParallelSortClusteredCursor::getShardRoundTripMicros( const Shard& shard ) {
+        map<Shard,PCMData>::iterator i = _cursorMap.find( shard );
+
+        if( i == _cursorMap.end() ) return -1;
+
+        const PCMData& mdata = i->second;
+        if( mdata.dispatchMicros == 0 || mdata.replyMicros < mdata.dispatchMicros ) return -1;
+        return mdata.replyMicros - mdata.dispatchMicros;
+    }
+
     static BSONObj _concatFilter( const BSONObj& filter , const BSONObj& extra ) {
         BSONObjBuilder b;
         b.appendElements( filter );
@@ -1450,6 +1468,9 @@ namespace mongo {
 
     ParallelSortClusteredCursor::~ParallelSortClusteredCursor() {
 
+        // No background refill may touch the cursors once we start tearing them down
+        _stopPrefetch();
+
         // WARNING: Commands (in particular M/R) connect via _oldInit() directly to shards
         bool isDirectShardCursor = _cursorMap.empty();
 
@@ -1469,8 +1490,125 @@ namespace mongo {
         _done = true;
     }
 
+    namespace {
+        // A cursor whose last batch was bigger than this is not refilled in the background,
+        // so a merge never buffers more than roughly this much data ahead of the consumer
+        // per shard.
+        const int kMaxPrefetchBytesPerCursor = 4 * 1024 * 1024;
+    }
+
+    void ParallelSortClusteredCursor::_schedulePrefetch( int i ) {
+        if ( ! _cursors[i].get() )
+            return;
+
+        // nothing to refill if the server already closed the cursor
+        if ( _cursors[i].get()->getCursorId() == 0 )
+            return;
+
+        // per-cursor memory budget - batches at this size are expensive enough that the
+        // round trip no longer dominates, so don't buffer another one ahead of the merge
+        Message* m = _cursors[i].get()->getMessage();
+        if ( m && m->size() > kMaxPrefetchBytesPerCursor )
+            return;
+
+        scoped_lock lk( _prefetchMutex );
+
+        if ( _prefetchShutdown )
+            return;
+
+        if ( ! _prefetcher ) {
+            _prefetcher.reset(
+                new boost::thread( &ParallelSortClusteredCursor::_prefetchThread, this ) );
+        }
+
+        if ( _prefetching != i &&
+             std::find( _prefetchQueue.begin(), _prefetchQueue.end(), i ) ==
+                 _prefetchQueue.end() ) {
+            _prefetchQueue.push_back( i );
+            _prefetchCV.notify_one();
+        }
+    }
+
+    void ParallelSortClusteredCursor::_prefetchThread() {
+        while ( true ) {
+            int i = -1;
+            {
+                scoped_lock lk( _prefetchMutex );
+                while ( _prefetchQueue.empty() && ! _prefetchShutdown ) {
+                    _prefetchCV.wait( lk.boost() );
+                }
+
+                if ( _prefetchShutdown )
+                    return;
+
+                i = _prefetchQueue.front();
+                _prefetchQueue.pop_front();
+                _prefetching = i;
+            }
+
+            try {
+                // pulls the next batch over the wire; the merge consumes it later
+                _cursors[i].get()->more();
+            }
+            catch ( const DBException& e ) {
+                scoped_lock lk( _prefetchMutex );
+                _prefetchErrors[i] = e.what();
+            }
+            catch ( const std::exception& e ) {
+                scoped_lock lk( _prefetchMutex );
+                _prefetchErrors[i] = e.what();
+            }
+
+            scoped_lock lk( _prefetchMutex );
+            _prefetching = -1;
+            _prefetchCV.notify_all();
+        }
+    }
+
+    void ParallelSortClusteredCursor::_finishPrefetch( int i ) {
+        string errmsg;
+        {
+            scoped_lock lk( _prefetchMutex );
+
+            // if it's still queued nothing has touched the cursor yet, just drop it
+            std::deque<int>::iterator it =
+                std::find( _prefetchQueue.begin(), _prefetchQueue.end(), i );
+            if ( it != _prefetchQueue.end() )
+                _prefetchQueue.erase( it );
+
+            while ( _prefetching == i ) {
+                _prefetchCV.wait( lk.boost() );
+            }
+
+            map<int,string>::iterator err = _prefetchErrors.find( i );
+            if ( err == _prefetchErrors.end() )
+                return;
+
+            errmsg = err->second;
+            _prefetchErrors.erase( err );
+        }
+
+        // surface the background error where the caller expects getMore errors to appear
+        uasserted( 28646, str::stream() << "background getMore failed: " << errmsg );
+    }
+
+    void ParallelSortClusteredCursor::_stopPrefetch() {
+        {
+            scoped_lock lk( _prefetchMutex );
+            _prefetchShutdown = true;
+            _prefetchCV.notify_all();
+        }
+
+        if ( _prefetcher ) {
+            _prefetcher->join();
+            _prefetcher.reset();
+        }
+    }
+
     void ParallelSortClusteredCursor::setBatchSize(int newBatchSize) {
         for ( int i=0; i<_numServers; i++ ) {
+            if ( _prefetcher )
+                _finishPrefetch( i );
             if (_cursors[i].get())
                 _cursors[i].get()->setBatchSize(newBatchSize);
         }
@@ -1491,6 +1629,8 @@ namespace mongo {
         }
 
         for ( int i=0; i<_numServers; i++ ) {
+            if ( _prefetcher )
+                _finishPrefetch( i );
             if (_cursors[i].get() && _cursors[i].get()->more())
                 return true;
         }
@@ -1508,6 +1648,10 @@ namespace mongo {
 
             int i = ( j + _lastFrom + 1 ) % _numServers;
 
+            // make sure no background refill is still touching this cursor
+            if ( _prefetcher )
+                _finishPrefetch( i );
+
             // Check to see if the cursor is finished
             if (!_cursors[i].get() || !_cursors[i].get()->more()) {
                 if (_cursors[i].getMData())
@@ -1543,6 +1687,10 @@ namespace mongo {
         // Make sure the result data won't go away after the next call to more()
         if (!_cursors[bestFrom].get()->moreInCurrentBatch()) {
             best = best.getOwned();
+
+            // refill the drained batch in the background while the merge consumes the
+            // other cursors, so we don't stall on the getMore round trip later
+            _schedulePrefetch( bestFrom );
         }
 
         if (_cursors[bestFrom].getMData())
@@ -33,14 +33,19 @@
 
 #pragma once
 
+#include <deque>
+
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/thread.hpp>
 
 #include "mongo/client/export_macros.h"
 #include "mongo/db/dbmessage.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/s/shard.h"
+#include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/concurrency/mvar.h"
 
 namespace mongo {
@@ -140,7 +145,8 @@ namespace mongo {
     public:
 
         ParallelConnectionMetadata() :
-            retryNext( false ), initialized( false ), finished( false ), completed( false ), errored( false ) { }
+            retryNext( false ), initialized( false ), finished( false ), completed( false ),
+            errored( false ), dispatchMicros( 0 ), replyMicros( 0 ) { }
 
         ~ParallelConnectionMetadata(){
             cleanup( true );
@@ -158,6 +164,12 @@ namespace mongo {
 
         bool errored;
 
+        // Mongos-observed wall clock (micros since epoch) when the query was dispatched to the
+        // remote host and when its reply was received, so explain can attribute per-shard
+        // network and queueing latency.  Zero until recorded.
+        long long dispatchMicros;
+        long long replyMicros;
+
         BSONObj toBSON() const;
 
         std::string toString() const {
@@ -242,6 +254,12 @@ namespace mongo {
         ChunkManagerPtr getChunkManager( const Shard& shard );
         DBClientCursorPtr getShardCursor( const Shard& shard );
 
+        /**
+         * Returns the mongos-observed time in microseconds between dispatching the query to
+         * 'shard' and receiving its reply, or -1 if no timing was recorded for the shard.
+         */
+        long long getShardRoundTripMicros( const Shard& shard );
+
         BSONObj toBSON() const;
         std::string toString() const;
 
@@ -276,6 +294,35 @@ namespace mongo {
         DBClientCursorHolder * _cursors;
         int _needToSkip;
 
+        // ---- background batch prefetching ----
+
+        /**
+         * Runs in a background thread, refilling cursors whose batches the merge has
+         * drained so next() doesn't stall on a getMore round trip.
+         */
+        void _prefetchThread();
+
+        /** Queues cursor 'i' for a background getMore if it qualifies. */
+        void _schedulePrefetch( int i );
+
+        /**
+         * Blocks until no background getMore is touching cursor 'i', and rethrows any
+         * error the background refill of that cursor hit.
+         */
+        void _finishPrefetch( int i );
+
+        /** Stops the prefetch thread; must be called before the cursors go away. */
+        void _stopPrefetch();
+
+        // Guards all prefetch state below; never held while talking to a shard.
+        mongo::mutex _prefetchMutex;
+        boost::condition _prefetchCV;
+        boost::scoped_ptr<boost::thread> _prefetcher;
+        std::deque<int> _prefetchQueue;
+        int _prefetching;         // cursor being refilled right now, -1 if none
+        bool _prefetchShutdown;
+        std::map<int,std::string> _prefetchErrors;
+
         /**
          * Setups the shard version of the connection. When using a replica
          * set connection and the primary cannot be reached, the version
@@ -257,6 +257,44 @@ namespace {
         bool operator() (const Node& node) { return !_hosts.count(node.host); }
         const std::set<HostAndPort>& _hosts;
     };
+
+    // HostPicker for selection while holding SetState::mutex. Uses the set's PseudoRandom,
+    // or round-robin when useDeterministicHostSelection is on.
+    class LockedHostPicker : public SetState::HostPicker {
+    public:
+        LockedHostPicker(PseudoRandom* rand, int* roundRobin)
+            : _rand(rand)
+            , _roundRobin(roundRobin)
+        {}
+
+        virtual size_t pickIndex(size_t count) {
+            if (ReplicaSetMonitor::useDeterministicHostSelection) {
+                // only in tests
+                return (*_roundRobin)++ % count;
+            }
+            // normal case
+            return _rand->nextInt32(count);
+        }
+
+    private:
+        PseudoRandom* const _rand;
+        int* const _roundRobin;
+    };
+
+    // HostPicker for the lock-free snapshot path. Strides a shared counter rather than
+    // using the set's PseudoRandom, which may only be touched under SetState::mutex.
+    // Rotating through the candidates spreads load at least as evenly as a random pick.
+    class SnapshotHostPicker : public SetState::HostPicker {
+    public:
+        explicit SnapshotHostPicker(AtomicUInt32* counter) : _counter(counter) {}
+
+        virtual size_t pickIndex(size_t count) {
+            return _counter->fetchAndAdd(1) % count;
+        }
+
+    private:
+        AtomicUInt32* const _counter;
+    };
 } // namespace
 
     // At 1 check every 10 seconds, 30 checks takes 5 minutes
@@ -279,8 +317,16 @@ namespace {
 
     HostAndPort ReplicaSetMonitor::getHostOrRefresh(const ReadPreferenceSetting& criteria) {
         {
-            boost::mutex::scoped_lock lk(_state->mutex);
-            HostAndPort out = _state->getMatchingHost(criteria);
+            // Lock-free fast path: select from the last published snapshot of the node
+            // list. Since the snapshot is immutable, an in-flight refresh (which may be
+            // stuck talking to a slow or unresponsive host) never delays selection here.
+            const boost::shared_ptr<const Nodes> snapshot =
+                boost::atomic_load(&_state->nodesSnapshot);
+            SnapshotHostPicker picker(&_state->snapshotPick);
+            HostAndPort out = SetState::getMatchingHostInNodes(*snapshot,
+                                                               criteria,
+                                                               _state->latencyThresholdMicros,
+                                                               picker);
             if (!out.empty())
                 return out;
         }
@@ -318,8 +364,10 @@ namespace {
     void ReplicaSetMonitor::failedHost(const HostAndPort& host) {
         boost::mutex::scoped_lock lk(_state->mutex);
         Node* node = _state->findNode(host);
-        if (node)
+        if (node) {
             node->markFailed();
+            _state->publishSnapshot();
+        }
         DEV _state->checkInvariants();
     }
 
@@ -520,6 +568,7 @@ namespace {
                         it != _scan->unconfirmedReplies.end(); ++it) {
                     _set->findOrCreateNode(it->host)->update(*it);
                 }
+                _set->publishSnapshot();
             }
 
             if (_scan->foundAnyUpNodes) {
@@ -583,6 +632,8 @@ namespace {
         // connectible host that is that claims to be in the set.
         _scan->foundAnyUpNodes = true;
 
+        _set->publishSnapshot();
+
         // TODO consider only notifying if we've updated a node or we've emptied waitingFor.
         _set->cv.notify_all();
 
@@ -598,8 +649,10 @@ namespace {
             _set->cv.notify_all();
 
         Node* node = _set->findNode(host);
-        if (node)
+        if (node) {
             node->markFailed();
+            _set->publishSnapshot();
+        }
     }
 
     ScanStatePtr Refresher::startNewScan(const SetState* set) {
@@ -906,31 +959,52 @@ namespace {
             nodes.push_back(Node(*it));
         }
 
+        publishSnapshot();
+
         DEV checkInvariants();
     }
 
     HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) const {
+        LockedHostPicker picker(&rand, &roundRobin);
+        return getMatchingHostInNodes(nodes, criteria, latencyThresholdMicros, picker);
+    }
+
+    HostAndPort SetState::getMatchingHostInNodes(const Nodes& nodes,
+                                                 const ReadPreferenceSetting& criteria,
+                                                 int64_t latencyThresholdMicros,
+                                                 HostPicker& picker) {
         switch (criteria.pref) {
         // "Prefered" read preferences are defined in terms of other preferences
         case ReadPreference_PrimaryPreferred: {
-            HostAndPort out = getMatchingHost(ReadPreferenceSetting(ReadPreference_PrimaryOnly,
-                                                                    criteria.tags));
+            HostAndPort out = getMatchingHostInNodes(
+                    nodes,
+                    ReadPreferenceSetting(ReadPreference_PrimaryOnly, criteria.tags),
+                    latencyThresholdMicros,
+                    picker);
             // NOTE: the spec says we should use the primary even if tags don't match
             if (!out.empty())
                 return out;
-            return getMatchingHost(ReadPreferenceSetting(ReadPreference_SecondaryOnly,
-                                                         criteria.tags));
+            return getMatchingHostInNodes(
+                    nodes,
+                    ReadPreferenceSetting(ReadPreference_SecondaryOnly, criteria.tags),
+                    latencyThresholdMicros,
+                    picker);
         }
 
         case ReadPreference_SecondaryPreferred: {
-            HostAndPort out =
-                getMatchingHost(ReadPreferenceSetting(ReadPreference_SecondaryOnly,
-                                                      criteria.tags));
+            HostAndPort out = getMatchingHostInNodes(
+                    nodes,
+                    ReadPreferenceSetting(ReadPreference_SecondaryOnly, criteria.tags),
+                    latencyThresholdMicros,
+                    picker);
             if (!out.empty())
                 return out;
             // NOTE: the spec says we should use the primary even if tags don't match
-            return getMatchingHost(ReadPreferenceSetting(ReadPreference_PrimaryOnly,
-                                                         criteria.tags));
+            return getMatchingHostInNodes(
+                    nodes,
+                    ReadPreferenceSetting(ReadPreference_PrimaryOnly, criteria.tags),
+                    latencyThresholdMicros,
+                    picker);
         }
 
         case ReadPreference_PrimaryOnly: {
@@ -972,15 +1046,8 @@ namespace {
                     }
                 }
 
-                // of the remaining nodes, pick one at random (or use round-robin)
-                if (ReplicaSetMonitor::useDeterministicHostSelection) {
-                    // only in tests
-                    return matchingNodes[roundRobin++ % matchingNodes.size()]->host;
-                }
-                else {
-                    // normal case
-                    return matchingNodes[rand.nextInt32(matchingNodes.size())]->host;
-                };
+                // of the remaining nodes, the picker chooses one
+                return matchingNodes[picker.pickIndex(matchingNodes.size())]->host;
             }
 
             return HostAndPort();
@@ -1022,6 +1089,13 @@ namespace {
         node->update(reply);
     }
 
+    void SetState::publishSnapshot() {
+        // Lock-free readers never see a partially updated node list: the snapshot is
+        // always replaced as a whole.
+        boost::atomic_store(&nodesSnapshot,
+                            boost::shared_ptr<const Nodes>(new Nodes(nodes)));
+    }
+
     std::string SetState::getServerAddress() const {
         StringBuilder ss;
         if (!name.empty())
@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include <boost/shared_ptr.hpp>
 #include <deque>
 #include <string>
 #include <vector>
@@ -42,6 +43,7 @@
 #include "mongo/client/dbclient_rs.h" // for TagSet and ReadPreferenceSettings
 #include "mongo/client/replica_set_monitor.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/cstdint.h"
 #include "mongo/platform/random.h"
 #include "mongo/util/net/hostandport.h"
@@ -138,6 +140,30 @@ namespace mongo {
          */
         HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria) const;
 
+        /**
+         * Chooses which of several equally acceptable hosts to use. Lets the selection
+         * algorithm below run both under mutex (using this set's PseudoRandom) and against
+         * the published snapshot (which may not touch any mutex-guarded member).
+         */
+        struct HostPicker {
+            virtual ~HostPicker() {}
+
+            /**
+             * Returns the index of the host to use, in [0, count). Only called with
+             * count >= 2.
+             */
+            virtual size_t pickIndex(size_t count) = 0;
+        };
+
+        /**
+         * Core of getMatchingHost. Takes the node list and selection state explicitly so
+         * it can also be run against nodesSnapshot without holding mutex.
+         */
+        static HostAndPort getMatchingHostInNodes(const Nodes& nodes,
+                                                  const ReadPreferenceSetting& criteria,
+                                                  int64_t latencyThresholdMicros,
+                                                  HostPicker& picker);
+
         /**
          * Returns the Node with the given host, or NULL if no Node has that host.
          */
@@ -151,6 +177,12 @@ namespace mongo {
 
         void updateNodeIfInNodes(const IsMasterReply& reply);
 
+        /**
+         * Replaces nodesSnapshot with a fresh copy of nodes. Must be called, while still
+         * holding mutex, after any change to nodes so that lock-free readers see it.
+         */
+        void publishSnapshot();
+
         std::string getServerAddress() const;
 
         /**
@@ -177,9 +209,22 @@ namespace mongo {
         HostAndPort lastSeenMaster; // empty if we have never seen a master. can be same as current
         Nodes nodes; // maintained sorted and unique by host
         ScanStatePtr currentScan; // NULL if no scan in progress
+
+        // Effectively const after construction (tests assign it before use), so the
+        // lock-free snapshot path may read it without holding mutex.
         int64_t latencyThresholdMicros;
+
         mutable PseudoRandom rand; // only used for host selection to balance load
         mutable int roundRobin; // used when useDeterministicHostSelection is true
+
+        // Immutable copy of nodes published for lock-free host selection. Replaced
+        // wholesale by publishSnapshot(), never mutated in place; only access it through
+        // boost::atomic_load/atomic_store. Old copies stay alive until the last reader
+        // drops them.
+        boost::shared_ptr<const Nodes> nodesSnapshot;
+
+        // Tie-breaker for snapshot-based selection. Atomic, so not guarded by mutex.
+        AtomicUInt32 snapshotPick;
     };
 
     struct ReplicaSetMonitor::ScanState {
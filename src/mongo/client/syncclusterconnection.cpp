@@ -44,6 +44,9 @@
 
 namespace mongo {
 
+    void assembleRequest( const string &ns, BSONObj query, int nToReturn, int nToSkip,
+                          const BSONObj *fieldsToReturn, int queryOptions, Message &toSend );
+
     SyncClusterConnection::SyncClusterConnection( const list<HostAndPort> & L, double socketTimeout) : _mutex("SyncClusterConnection"), _socketTimeout( socketTimeout ) {
         {
             stringstream s;
@@ -120,23 +123,66 @@ namespace mongo {
 
     void SyncClusterConnection::_checkLast() {
         _lastErrors.clear();
-        vector<string> errors;
+        vector<string> errors( _conns.size() );
+
+        // Pipeline the getlasterror checks: send the command to every node first, then
+        // collect the replies, so this costs the slowest node's round trip instead of
+        // the sum of all of them.
+        BSONObj cmd = BSON( "getlasterror" << 1 << "fsync" << 1 );
+        if ( getRunCommandHook() ) {
+            BSONObjBuilder cmdObj;
+            cmdObj.appendElements( cmd );
+            getRunCommandHook()( &cmdObj );
+            cmd = cmdObj.obj();
+        }
 
+        vector<MSGID> requestIds( _conns.size(), 0 );
+        vector<bool> sent( _conns.size(), false );
         for ( size_t i=0; i<_conns.size(); i++ ) {
-            BSONObj res;
-            string err;
             try {
-                if ( ! _conns[i]->runCommand( "admin" , BSON( "getlasterror" << 1 << "fsync" << 1 ) , res ) )
-                    err = "cmd failed: ";
+                Message toSend;
+                assembleRequest( "admin.$cmd", cmd, 1, 0, NULL, 0, toSend );
+                requestIds[i] = _conns[i]->sayPipelined( toSend );
+                sent[i] = true;
             }
             catch ( std::exception& e ) {
-                err += e.what();
+                errors[i] += e.what();
             }
             catch ( ... ) {
-                err += "unknown failure";
+                errors[i] += "unknown failure";
+            }
+        }
+
+        for ( size_t i=0; i<_conns.size(); i++ ) {
+            BSONObj res;
+            if ( sent[i] ) {
+                try {
+                    Message response;
+                    uassert( 28635,
+                             str::stream() << "no data from: " << _conns[i]->toString(),
+                             _conns[i]->recvPipelined( requestIds[i], response ) );
+
+                    QueryResult::View qr = response.singleData().view2ptr();
+                    uassert( 28636,
+                             str::stream() << "empty getlasterror reply from: "
+                                           << _conns[i]->toString(),
+                             qr.getNReturned() >= 1 );
+                    res = BSONObj( qr.data() ).getOwned();
+
+                    if ( getPostRunCommandHook() )
+                        getPostRunCommandHook()( res, _conns[i]->getServerAddress() );
+
+                    if ( ! isOk( res ) )
+                        errors[i] = "cmd failed: ";
+                }
+                catch ( std::exception& e ) {
+                    errors[i] += e.what();
+                }
+                catch ( ... ) {
+                    errors[i] += "unknown failure";
+                }
             }
-            _lastErrors.push_back( res.getOwned() );
-            errors.push_back( err );
+            _lastErrors.push_back( res );
         }
 
         verify( _lastErrors.size() == errors.size() && _lastErrors.size() == _conns.size() );
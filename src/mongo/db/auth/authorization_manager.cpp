@@ -262,6 +262,11 @@ namespace mongo {
             fassert(17265, it->second != internalSecurity.user);
             delete it->second ;
         }
+        for (unordered_map<UserName, User*>::iterator it = _staleUserCache.begin();
+                it != _staleUserCache.end(); ++it) {
+            fassert(28718, it->second != internalSecurity.user);
+            delete it->second;
+        }
     }
 
     Status AuthorizationManager::getAuthorizationVersion(OperationContext* txn, int* version) {
@@ -289,7 +294,7 @@ namespace mongo {
     }
 
     OID AuthorizationManager::getCacheGeneration() {
-        CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+        boost::lock_guard<boost::mutex> lk(_cacheGenerationMutex);
         return _cacheGeneration;
     }
 
@@ -556,6 +561,18 @@ namespace mongo {
         while ((_userCache.end() == (it = _userCache.find(userName))) &&
                guard.otherUpdateInFetchPhase()) {
 
+            // Another thread is fetching from the privilege documents.  If a recently
+            // invalidated copy of this user is still available, serve it immediately
+            // instead of queueing behind the in-flight fetch; the caller will pick up
+            // fresh data on its next acquisition once the fetch completes.
+            unordered_map<UserName, User*>::iterator staleIt = _staleUserCache.find(userName);
+            if (staleIt != _staleUserCache.end()) {
+                fassert(28719, !staleIt->second->isValid());
+                staleIt->second->incrementRefCount();
+                *acquiredUser = staleIt->second;
+                return Status::OK();
+            }
+
             guard.wait();
         }
 
@@ -604,6 +621,13 @@ namespace mongo {
             }
             if (status.isOK())
                 break;
+            if (status == ErrorCodes::UserNotFound) {
+                // The user has been removed; make sure a stale copy of it cannot be
+                // served to threads arriving while a later fetch is in flight.
+                guard.endFetchPhase();
+                _removeStaleUser_inlock(userName);
+                return status;
+            }
             if (status != ErrorCodes::AuthSchemaIncompatible)
                 return status;
 
@@ -618,6 +642,7 @@ namespace mongo {
         // NOTE: It is not safe to throw an exception from here to the end of the method.
         if (guard.isSameCacheGeneration()) {
             _userCache.insert(make_pair(userName, user.get()));
+            _removeStaleUser_inlock(userName);
             if (_version == schemaVersionInvalid)
                 _version = authzVersion;
         }
@@ -626,6 +651,9 @@ namespace mongo {
             // associated with the user may now be invalid, so we must mark it as such.  The caller
             // may still opt to use the information for a short while, but not indefinitely.
             user->invalidate();
+            // Still the freshest data we have for this user, so replace the stale copy with
+            // it for the benefit of threads arriving while the next fetch is in flight.
+            _addStaleUser_inlock(user.get());
         }
         *acquiredUser = user.release();
 
@@ -681,6 +709,7 @@ namespace mongo {
         User* user = it->second;
         _userCache.erase(it);
         user->invalidate();
+        _addStaleUser_inlock(user);
     }
 
     void AuthorizationManager::invalidateUsersFromDB(const std::string& dbname) {
@@ -692,6 +721,7 @@ namespace mongo {
             if (user->getName().getDB() == dbname) {
                 _userCache.erase(it++);
                 user->invalidate();
+                _addStaleUser_inlock(user);
             } else {
                 ++it;
             }
@@ -709,6 +739,7 @@ namespace mongo {
                 it != _userCache.end(); ++it) {
             fassert(17266, it->second != internalSecurity.user);
             it->second->invalidate();
+            _addStaleUser_inlock(it->second);
         }
         _userCache.clear();
 
@@ -952,9 +983,30 @@ namespace {
 }  // namespace
 
     void AuthorizationManager::_updateCacheGeneration_inlock() {
+        boost::lock_guard<boost::mutex> lk(_cacheGenerationMutex);
         _cacheGeneration = OID::gen();
     }
 
+    void AuthorizationManager::_addStaleUser_inlock(User* user) {
+        _removeStaleUser_inlock(user->getName());
+        user->incrementRefCount();
+        _staleUserCache.insert(make_pair(user->getName(), user));
+    }
+
+    void AuthorizationManager::_removeStaleUser_inlock(const UserName& userName) {
+        unordered_map<UserName, User*>::iterator it = _staleUserCache.find(userName);
+        if (it == _staleUserCache.end()) {
+            return;
+        }
+        User* user = it->second;
+        _staleUserCache.erase(it);
+        user->decrementRefCount();
+        if (user->getRefCount() == 0) {
+            // Stale users are always invalid, so they are never in _userCache.
+            delete user;
+        }
+    }
+
     void AuthorizationManager::_invalidateRelevantCacheData(const char* op,
                                                             const char* ns,
                                                             const BSONObj& o,
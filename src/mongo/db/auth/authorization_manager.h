@@ -337,6 +337,10 @@ namespace mongo {
          *  exists yet in the cache, reads the user's privilege document from disk, builds up
          *  a User object, sets the refcount to 1, and gives that out.  The returned user may
          *  be invalid by the time the caller gets access to it.
+         *  If another thread is already fetching from the privilege documents, a recently
+         *  invalidated copy of the user may be handed out immediately rather than queueing
+         *  behind the in-flight fetch; such a copy is marked invalid and will be replaced
+         *  the next time the caller re-acquires the user after the fetch completes.
          *  The AuthorizationManager retains ownership of the returned User object.
          *  On non-OK Status return values, acquiredUser will not be modified.
          */
@@ -461,6 +465,20 @@ namespace mongo {
          */
         void _updateCacheGeneration_inlock();
 
+        /**
+         * Makes "user", which must already be marked invalid and removed from _userCache,
+         * available for stale serving from acquireUser().  Takes a reference to the user on
+         * behalf of _staleUserCache, replacing any older stale copy for the same user name.
+         * Should only be called when already holding _cacheMutex.
+         */
+        void _addStaleUser_inlock(User* user);
+
+        /**
+         * Discards the stale copy of the named user, if any, releasing the reference held by
+         * _staleUserCache.  Should only be called when already holding _cacheMutex.
+         */
+        void _removeStaleUser_inlock(const UserName& userName);
+
         /**
          * Fetches user information from a v2-schema user document for the named user,
          * and stores a pointer to a new user object into *acquiredUser on success.
@@ -497,12 +515,28 @@ namespace mongo {
          */
         unordered_map<UserName, User*> _userCache;
 
+        /**
+         * Holds the most recently invalidated User object for each user name, so that
+         * acquireUser() can serve a stale-but-recent copy instead of blocking behind an
+         * in-flight fetch after the cache is invalidated.  Each entry holds a reference to
+         * its User; entries are discarded when a fresh copy of the user is fetched.
+         */
+        unordered_map<UserName, User*> _staleUserCache;
+
         /**
          * Current generation of cached data.  Updated every time part of the cache gets
-         * invalidated.  Protected by CacheGuard.
+         * invalidated.  Writes are guarded by both CacheGuard and _cacheGenerationMutex, so
+         * readers may hold either.
          */
         OID _cacheGeneration;
 
+        /**
+         * Protects reads of _cacheGeneration that do not hold _cacheMutex.  Kept separate
+         * from _cacheMutex so that the frequent generation checks made by authorization
+         * sessions do not contend with user cache fetches and ref count traffic.
+         */
+        boost::mutex _cacheGenerationMutex;
+
         /**
          * True if there is an update to the _userCache in progress, and that update is currently in
          * the "fetch phase", during which it does not hold the _cacheMutex.
@@ -53,6 +53,9 @@ namespace mongo {
 
 namespace {
     const std::string ADMIN_DBNAME = "admin";
+
+    // Upper bound on the number of per-namespace compiled action sets kept per session.
+    const size_t kCompiledActionsMapMaxSize = 1000;
 }  // namespace
 
     AuthorizationSession::AuthorizationSession(AuthzSessionExternalState* externalState) 
@@ -95,6 +98,7 @@ namespace {
         clearImpersonatedUserData();
 
         _buildAuthenticatedRolesVector();
+        _compiledNamespaceActions.clear();
         return Status::OK();
     }
 
@@ -109,6 +113,7 @@ namespace {
         }
         clearImpersonatedUserData();
         _buildAuthenticatedRolesVector();
+        _compiledNamespaceActions.clear();
     }
 
     UserNameIterator AuthorizationSession::getAuthenticatedUserNames() {
@@ -135,6 +140,7 @@ namespace {
     void AuthorizationSession::grantInternalAuthorization() {
         _authenticatedUsers.add(internalSecurity.user);
         _buildAuthenticatedRolesVector();
+        _compiledNamespaceActions.clear();
     }
 
     PrivilegeVector AuthorizationSession::getDefaultPrivileges() {
@@ -457,6 +463,10 @@ namespace {
                     // Success! Replace the old User object with the updated one.
                     fassert(17067, _authenticatedUsers.replaceAt(it, updatedUser) == user);
                     authMan.releaseUser(user);
+                    // The cache generation may not move again between a failed refresh and
+                    // a successful retry, so compiled action sets built from the old User
+                    // object have to go now.
+                    _compiledNamespaceActions.clear();
                     LOG(1) << "Updated session cache of user information for " << name;
                     break;
                 }
@@ -464,6 +474,7 @@ namespace {
                     // User does not exist anymore; remove it from _authenticatedUsers.
                     fassert(17068, _authenticatedUsers.removeAt(it) == user);
                     authMan.releaseUser(user);
+                    _compiledNamespaceActions.clear();
                     log() << "Removed deleted user " << name <<
                         " from session cache of user information.";
                     continue;  // No need to advance "it" in this case.
@@ -498,24 +509,30 @@ namespace {
     bool AuthorizationSession::_isAuthorizedForPrivilege(const Privilege& privilege) {
         const ResourcePattern& target(privilege.getResourcePattern());
 
+        if (target.isExactNamespacePattern()) {
+            // The per-operation hot path: query, getmore, insert, update and delete checks
+            // all target an exact namespace, so they are answered from the compiled
+            // per-namespace action sets.
+            return _getCompiledNamespaceActions(target).isSupersetOf(privilege.getActions());
+        }
+
+        return _resolveGrantedActions(target).isSupersetOf(privilege.getActions());
+    }
+
+    ActionSet AuthorizationSession::_resolveGrantedActions(const ResourcePattern& target) {
         ResourcePattern resourceSearchList[resourceSearchListCapacity];
         const int resourceSearchListLength = buildResourceSearchList(target, resourceSearchList);
 
-        ActionSet unmetRequirements = privilege.getActions();
+        ActionSet granted;
 
         PrivilegeVector defaultPrivileges = getDefaultPrivileges();
         for (PrivilegeVector::iterator it = defaultPrivileges.begin();
                 it != defaultPrivileges.end(); ++it) {
 
             for (int i = 0; i < resourceSearchListLength; ++i) {
-                if (!(it->getResourcePattern() == resourceSearchList[i]))
-                    continue;
-
-                ActionSet userActions = it->getActions();
-                unmetRequirements.removeAllActionsFromSet(userActions);
-
-                if (unmetRequirements.empty())
-                    return true;
+                if (it->getResourcePattern() == resourceSearchList[i]) {
+                    granted.addAllActionsFromSet(it->getActions());
+                }
             }
         }
 
@@ -523,15 +540,36 @@ namespace {
                 it != _authenticatedUsers.end(); ++it) {
             User* user = *it;
             for (int i = 0; i < resourceSearchListLength; ++i) {
-                ActionSet userActions = user->getActionsForResource(resourceSearchList[i]);
-                unmetRequirements.removeAllActionsFromSet(userActions);
-
-                if (unmetRequirements.empty())
-                    return true;
+                granted.addAllActionsFromSet(user->getActionsForResource(resourceSearchList[i]));
             }
         }
 
-        return false;
+        return granted;
+    }
+
+    ActionSet AuthorizationSession::_getCompiledNamespaceActions(const ResourcePattern& target) {
+        const OID generation = getAuthorizationManager().getCacheGeneration();
+        if (generation != _compiledActionsGeneration) {
+            // A user or role changed somewhere; everything we compiled may be stale.
+            _compiledNamespaceActions.clear();
+            _compiledActionsGeneration = generation;
+        }
+
+        const std::string ns = target.ns().ns();
+        CompiledActionsMap::const_iterator it = _compiledNamespaceActions.find(ns);
+        if (it != _compiledNamespaceActions.end()) {
+            return it->second;
+        }
+
+        if (_compiledNamespaceActions.size() >= kCompiledActionsMapMaxSize) {
+            // A session touching this many distinct namespaces is probably enumerating
+            // them; start over rather than grow without bound.
+            _compiledNamespaceActions.clear();
+        }
+
+        ActionSet granted = _resolveGrantedActions(target);
+        _compiledNamespaceActions[ns] = granted;
+        return granted;
     }
 
     void AuthorizationSession::setImpersonatedUserData(std::vector<UserName> usernames,
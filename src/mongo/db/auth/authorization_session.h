@@ -42,6 +42,7 @@
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/unordered_map.h"
 
 namespace mongo {
 
@@ -223,8 +224,27 @@ namespace mongo {
         // lock on the admin database (to update out-of-date user privilege information).
         bool _isAuthorizedForPrivilege(const Privilege& privilege);
 
+        // Computes the full set of actions this session is granted on "target": the union,
+        // over every resource pattern that matches "target", of the actions granted by the
+        // default privileges and by every authenticated user.
+        ActionSet _resolveGrantedActions(const ResourcePattern& target);
+
+        // Returns the compiled action set for an exact namespace target, building it on a
+        // miss.  The compiled entries make the common per-operation check one hash lookup
+        // plus one bitmask comparison.
+        ActionSet _getCompiledNamespaceActions(const ResourcePattern& target);
+
         boost::scoped_ptr<AuthzSessionExternalState> _externalState;
 
+        // Caches _resolveGrantedActions() results for exact namespaces, which is what every
+        // per-operation check (query, insert, update, delete) targets.  Entries are discarded
+        // when the AuthorizationManager's user cache generation moves -- which happens on any
+        // user or role modification -- and whenever the set of users authenticated on this
+        // session changes.
+        typedef unordered_map<std::string, ActionSet> CompiledActionsMap;
+        CompiledActionsMap _compiledNamespaceActions;
+        OID _compiledActionsGeneration;
+
         // All Users who have been authenticated on this connection.
         UserSet _authenticatedUsers;
         // The roles of the authenticated users. This vector is generated when the authenticated
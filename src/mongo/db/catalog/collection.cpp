@@ -39,11 +39,13 @@
 #include "mongo/base/counter.h"
 #include "mongo/base/owned_pointer_map.h"
 #include "mongo/db/clientcursor.h"
+#include "mongo/db/commands/dbhash.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/index_create.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/mmap_v1/mmap_v1_options.h"
@@ -93,8 +95,10 @@ namespace mongo {
           _cursorManager( fullNS ) {
         _magic = 1357924;
         _indexCatalog.init(txn);
-        if ( isCapped() )
+        if ( isCapped() ) {
             _recordStore->setCappedDeleteCallback( this );
+            _cappedNotifier.reset( new CappedInsertNotifier() );
+        }
         _infoCache.reset(txn);
     }
 
@@ -140,8 +144,9 @@ namespace mongo {
         return _recordStore->getIterator( txn, start, dir );
     }
 
-    vector<RecordIterator*> Collection::getManyIterators( OperationContext* txn ) const {
-        return _recordStore->getManyIterators(txn);
+    vector<RecordIterator*> Collection::getManyIterators( OperationContext* txn,
+                                                          size_t numWanted ) const {
+        return _recordStore->getManyIterators(txn, numWanted);
     }
 
     int64_t Collection::countTableScan( OperationContext* txn, const MatchExpression* expression ) {
@@ -176,12 +181,21 @@ namespace mongo {
                                                     bool enforceQuota ) {
         invariant( !_indexCatalog.haveAnyIndexes() ); // eventually can implement, just not done
 
+        if ( !isCapped() ) {
+            // This path never sees the document bytes again, so a seeded dbHash digest
+            // cannot be maintained across it.  Capped collections are never digested.
+            wipeDigestForDbHash( _ns.ns() );
+        }
+
         StatusWith<RecordId> loc = _recordStore->insertRecord( txn,
                                                               doc,
                                                               _enforceQuota( enforceQuota ) );
         if ( !loc.isOK() )
             return loc;
 
+        if ( _cappedNotifier )
+            _cappedNotifier->notifyOfInsert();
+
         return StatusWith<RecordId>( loc );
     }
 
@@ -204,6 +218,58 @@ namespace mongo {
         return res;
     }
 
+    Status Collection::insertDocuments( OperationContext* txn,
+                                        const std::vector<BSONObj>& docs,
+                                        bool enforceQuota,
+                                        size_t* numInserted ) {
+        *numInserted = 0;
+
+        const bool hasIdIndex = _indexCatalog.findIdIndex( txn ) != NULL;
+
+        std::vector<RecordData> records;
+        records.reserve( docs.size() );
+        for ( size_t i = 0; i < docs.size(); i++ ) {
+            if ( hasIdIndex && docs[i]["_id"].eoo() ) {
+                return Status( ErrorCodes::InternalError,
+                               str::stream() << "Collection::insertDocuments got "
+                               "document without _id for ns:" << _ns.ns() );
+            }
+            records.push_back( RecordData( docs[i].objdata(), docs[i].objsize() ) );
+        }
+
+        // Let the record store allocate and write the whole batch before we touch the
+        // indexes; the caller's unit of work makes the batch atomic either way.
+        std::vector<RecordId> locs;
+        Status status = _recordStore->insertRecords( txn,
+                                                     records,
+                                                     _enforceQuota( enforceQuota ),
+                                                     &locs );
+        if ( !status.isOK() )
+            return status;
+
+        invariant( locs.size() == docs.size() );
+
+        for ( size_t i = 0; i < docs.size(); i++ ) {
+            invariant( RecordId::min() < locs[i] );
+            invariant( locs[i] < RecordId::max() );
+
+            _infoCache.notifyOfWriteOp();
+
+            Status s = _indexCatalog.indexRecord( txn, docs[i], locs[i] );
+            if ( !s.isOK() )
+                return s;
+
+            digestOpForDbHash( txn, _ns.ns(), docs[i] );
+
+            (*numInserted)++;
+        }
+
+        if ( _cappedNotifier && *numInserted > 0 )
+            _cappedNotifier->notifyOfInsert();
+
+        return Status::OK();
+    }
+
     StatusWith<RecordId> Collection::insertDocument( OperationContext* txn,
                                                     const BSONObj& doc,
                                                     MultiIndexBlock* indexBlock,
@@ -220,6 +286,8 @@ namespace mongo {
         if ( !status.isOK() )
             return StatusWith<RecordId>( status );
 
+        digestOpForDbHash( txn, _ns.ns(), doc );
+
         return loc;
     }
 
@@ -253,6 +321,11 @@ namespace mongo {
         if (!s.isOK())
             return StatusWith<RecordId>(s);
 
+        digestOpForDbHash( txn, _ns.ns(), docToInsert );
+
+        if ( _cappedNotifier )
+            _cappedNotifier->notifyOfInsert();
+
         return loc;
     }
 
@@ -295,19 +368,42 @@ namespace mongo {
 
         _recordStore->deleteRecord( txn, loc );
 
+        digestOpForDbHash( txn, _ns.ns(), doc );
+
         _infoCache.notifyOfWriteOp();
     }
 
     Counter64 moveCounter;
     ServerStatusMetricField<Counter64> moveCounterDisplay( "record.moves", &moveCounter );
 
+    namespace {
+
+        // An update that names the paths it modifies lets us skip indexes whose keys
+        // provably cannot change.  An index unknown to the info cache is conservatively
+        // treated as touched.
+        bool pathsCouldTouchIndex( const UpdateIndexData* indexPaths,
+                                   const FieldRefSet& updatedPaths ) {
+            if ( !indexPaths )
+                return true;
+            for ( FieldRefSet::const_iterator it = updatedPaths.begin();
+                  it != updatedPaths.end();
+                  ++it ) {
+                if ( indexPaths->mightBeIndexed( (*it)->dottedField() ) )
+                    return true;
+            }
+            return false;
+        }
+
+    }  // namespace
+
     StatusWith<RecordId> Collection::updateDocument( OperationContext* txn,
                                                      const RecordId& oldLocation,
                                                      const BSONObj& objOld,
                                                      const BSONObj& objNew,
                                                      bool enforceQuota,
                                                      bool indexesAffected,
-                                                     OpDebug* debug ) {
+                                                     OpDebug* debug,
+                                                     const FieldRefSet* updatedPaths ) {
 
         uint64_t txnId = txn->recoveryUnit()->getMyTransactionCount();
 
@@ -331,6 +427,13 @@ namespace mongo {
                 IndexDescriptor* descriptor = ii.next();
                 IndexAccessMethod* iam = _indexCatalog.getIndex( descriptor );
 
+                if ( updatedPaths &&
+                     !pathsCouldTouchIndex(
+                         _infoCache.indexKeysFor( txn, descriptor->indexName() ),
+                         *updatedPaths ) ) {
+                    continue;
+                }
+
                 InsertDeleteOptions options;
                 options.logIfError = false;
                 options.dupsAllowed =
@@ -364,6 +467,11 @@ namespace mongo {
 
         _infoCache.notifyOfWriteOp();
 
+        // Fold the old version of the document out of the dbHash digest and the new
+        // version in (the digest is an xor, so both are the same operation).
+        digestOpForDbHash( txn, _ns.ns(), objOld );
+        digestOpForDbHash( txn, _ns.ns(), objNew );
+
         // If the object did move, we need to add the new location to all indexes.
         if ( newLocation.getValue() != oldLocation ) {
 
@@ -392,9 +500,14 @@ namespace mongo {
                 IndexDescriptor* descriptor = ii.next();
                 IndexAccessMethod* iam = _indexCatalog.getIndex( descriptor );
 
+                // Indexes whose paths the update does not touch have no ticket.
+                OwnedPointerMap<IndexDescriptor*,UpdateTicket>::MapType::const_iterator it =
+                    updateTickets.map().find( descriptor );
+                if ( it == updateTickets.map().end() )
+                    continue;
+
                 int64_t updatedKeys;
-                Status ret = iam->update(
-                    txn, *updateTickets.mutableMap()[descriptor], &updatedKeys);
+                Status ret = iam->update( txn, *it->second, &updatedKeys );
                 if ( !ret.isOK() )
                     return StatusWith<RecordId>( ret );
                 if ( debug )
@@ -421,14 +534,87 @@ namespace mongo {
 
     Status Collection::updateDocumentWithDamages( OperationContext* txn,
                                                   const RecordId& loc,
-                                                  const RecordData& oldRec,
+                                                  const BSONObj& objOld,
+                                                  const BSONObj& objNew,
                                                   const char* damageSource,
-                                                  const mutablebson::DamageVector& damages ) {
+                                                  const mutablebson::DamageVector& damages,
+                                                  bool indexesAffected,
+                                                  OpDebug* debug,
+                                                  const FieldRefSet* updatedPaths ) {
+
+        // As in updateDocument(), compute the index updates before touching anything, so a
+        // validation failure leaves both the record and the indexes untouched.
+        OwnedPointerMap<IndexDescriptor*,UpdateTicket> updateTickets;
+        if ( indexesAffected ) {
+            IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator( txn, true );
+            while ( ii.more() ) {
+                IndexDescriptor* descriptor = ii.next();
+                IndexAccessMethod* iam = _indexCatalog.getIndex( descriptor );
+
+                if ( updatedPaths &&
+                     !pathsCouldTouchIndex(
+                         _infoCache.indexKeysFor( txn, descriptor->indexName() ),
+                         *updatedPaths ) ) {
+                    continue;
+                }
+
+                InsertDeleteOptions options;
+                options.logIfError = false;
+                options.dupsAllowed =
+                    !(KeyPattern::isIdKeyPattern(descriptor->keyPattern()) || descriptor->unique())
+                    || repl::getGlobalReplicationCoordinator()->shouldIgnoreUniqueIndex(descriptor);
+                UpdateTicket* updateTicket = new UpdateTicket();
+                updateTickets.mutableMap()[descriptor] = updateTicket;
+                Status ret = iam->validateUpdate(
+                    txn, objOld, objNew, loc, options, updateTicket );
+                if ( !ret.isOK() ) {
+                    return ret;
+                }
+            }
+        }
 
         // Broadcast the mutation so that query results stay correct.
         _cursorManager.invalidateDocument(txn, loc, INVALIDATION_MUTATION);
 
-        return _recordStore->updateWithDamages( txn, loc, oldRec, damageSource, damages );
+        const RecordData oldRec( objOld.objdata(), objOld.objsize() );
+        Status status = _recordStore->updateWithDamages( txn, loc, oldRec, damageSource, damages );
+        if ( !status.isOK() ) {
+            return status;
+        }
+
+        _infoCache.notifyOfWriteOp();
+
+        // Fold the old version of the document out of the dbHash digest and the new
+        // version in.
+        digestOpForDbHash( txn, _ns.ns(), objOld );
+        digestOpForDbHash( txn, _ns.ns(), objNew );
+
+        // The record did not move, so we update each index with its respective UpdateTicket.
+        if ( indexesAffected ) {
+            if ( debug )
+                debug->keyUpdates = 0;
+
+            IndexCatalog::IndexIterator ii = _indexCatalog.getIndexIterator( txn, true );
+            while ( ii.more() ) {
+                IndexDescriptor* descriptor = ii.next();
+                IndexAccessMethod* iam = _indexCatalog.getIndex( descriptor );
+
+                // Indexes whose paths the update does not touch have no ticket.
+                OwnedPointerMap<IndexDescriptor*,UpdateTicket>::MapType::const_iterator it =
+                    updateTickets.map().find( descriptor );
+                if ( it == updateTickets.map().end() )
+                    continue;
+
+                int64_t updatedKeys;
+                Status ret = iam->update( txn, *it->second, &updatedKeys );
+                if ( !ret.isOK() )
+                    return ret;
+                if ( debug )
+                    debug->keyUpdates += updatedKeys;
+            }
+        }
+
+        return Status::OK();
     }
 
     bool Collection::_enforceQuota( bool userEnforeQuota ) const {
@@ -510,6 +696,7 @@ namespace mongo {
             return status;
         _cursorManager.invalidateAll( false );
         _infoCache.reset( txn );
+        wipeDigestForDbHash( _ns.ns() );
 
         // 3) truncate record store
         status = _recordStore->truncate(txn);
@@ -632,4 +819,32 @@ namespace mongo {
         return Status::OK();
     }
 
+    // ----
+
+    CappedInsertNotifier::CappedInsertNotifier()
+        : _mutex( "CappedInsertNotifier" ), _version( 0 ) {
+    }
+
+    void CappedInsertNotifier::notifyOfInsert() {
+        mutex::scoped_lock lk( _mutex );
+        _version++;
+        _condition.notify_all();
+    }
+
+    uint64_t CappedInsertNotifier::getVersion() const {
+        mutex::scoped_lock lk( _mutex );
+        return _version;
+    }
+
+    void CappedInsertNotifier::waitForInsert( uint64_t referenceVersion,
+                                              int timeoutMillis ) const {
+        mutex::scoped_lock lk( _mutex );
+
+        while ( referenceVersion == _version ) {
+            if ( !_condition.timed_wait( lk.boost(),
+                                         boost::posix_time::milliseconds( timeoutMillis ) ) )
+                return;
+        }
+    }
+
 }
@@ -30,6 +30,8 @@
 
 #pragma once
 
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition.hpp>
 #include <string>
 
 #include "mongo/base/string_data.h"
@@ -43,12 +45,14 @@
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/platform/cstdint.h"
+#include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
 
     class CollectionCatalogEntry;
     class Database;
     class ExtentManager;
+    class FieldRefSet;
     class IndexCatalog;
     class MultiIndexBlock;
     class OperationContext;
@@ -95,6 +99,40 @@ namespace mongo {
         long long corruptDocuments;
     };
 
+    /**
+     * Signaled by the insert paths of a capped collection; tailable awaitData cursors
+     * that have reached the end of the collection block on it so they wake as soon as a
+     * writer adds a document instead of polling.  Waiters hold the notifier by
+     * shared_ptr, so dropping the collection under a blocked waiter is safe: the wait
+     * simply times out against a notifier nobody signals anymore.
+     */
+    class CappedInsertNotifier {
+    public:
+        CappedInsertNotifier();
+
+        /**
+         * Wakes everyone blocked in waitForInsert().  Called after a document is
+         * inserted into the capped collection.
+         */
+        void notifyOfInsert();
+
+        /**
+         * Version to hand to a later waitForInsert(); bumped by each notifyOfInsert().
+         */
+        uint64_t getVersion() const;
+
+        /**
+         * Blocks until notifyOfInsert() is called after 'referenceVersion' was read, or
+         * until 'timeoutMillis' have passed, whichever comes first.
+         */
+        void waitForInsert( uint64_t referenceVersion, int timeoutMillis ) const;
+
+    private:
+        mutable mongo::mutex _mutex;
+        mutable boost::condition _condition; // cond over _version changing
+        uint64_t _version;
+    };
+
     /**
      * this is NOT safe through a yield right now
      * not sure if it will be, or what yet
@@ -149,8 +187,12 @@ namespace mongo {
          * Returns many iterators that partition the Collection into many disjoint sets. Iterating
          * all returned iterators is equivalent to Iterating the full collection.
          * Caller owns all pointers in the vector.
+         *
+         * 'numWanted' hints how many iterators the caller can put to use; see
+         * RecordStore::getManyIterators. Zero means no preference.
          */
-        std::vector<RecordIterator*> getManyIterators( OperationContext* txn ) const;
+        std::vector<RecordIterator*> getManyIterators( OperationContext* txn,
+                                                       size_t numWanted = 0 ) const;
 
 
         /**
@@ -176,6 +218,17 @@ namespace mongo {
                                             const BSONObj& doc,
                                             bool enforceQuota );
 
+        /**
+         * Inserts all of 'docs', in order, in the caller's WriteUnitOfWork.  Stops at the
+         * first document that cannot be inserted; 'numInserted' is set to the number of
+         * documents inserted before the failure.  On failure the caller is responsible for
+         * rolling back the unit of work, which undoes any partially inserted documents.
+         */
+        Status insertDocuments( OperationContext* txn,
+                                const std::vector<BSONObj>& docs,
+                                bool enforceQuota,
+                                size_t* numInserted );
+
         StatusWith<RecordId> insertDocument( OperationContext* txn,
                                             const DocWriter* doc,
                                             bool enforceQuota );
@@ -201,6 +254,11 @@ namespace mongo {
          * updates the document @ oldLocation with newDoc
          * if the document fits in the old space, it is put there
          * if not, it is moved
+         *
+         * If non-NULL, 'updatedPaths' names every path whose value may differ between
+         * 'oldDoc' and 'newDoc'; indexes covering none of those paths are then skipped
+         * entirely when the document does not move.
+         *
          * @return the post update location of the doc (may or may not be the same as oldLocation)
          */
         StatusWith<RecordId> updateDocument( OperationContext* txn,
@@ -209,16 +267,24 @@ namespace mongo {
                                              const BSONObj& newDoc,
                                              bool enforceQuota,
                                              bool indexesAffected,
-                                             OpDebug* debug );
+                                             OpDebug* debug,
+                                             const FieldRefSet* updatedPaths = NULL );
 
         /**
-         * right now not allowed to modify indexes
+         * Applies 'damages' to the record @ loc without moving it.  'objNew' must be the
+         * document as it looks once the damages are applied; when 'indexesAffected' is
+         * true it is used to bring the affected indexes up to date.  'updatedPaths' is
+         * interpreted as in updateDocument().
          */
         Status updateDocumentWithDamages( OperationContext* txn,
                                           const RecordId& loc,
-                                          const RecordData& oldRec,
+                                          const BSONObj& objOld,
+                                          const BSONObj& objNew,
                                           const char* damageSource,
-                                          const mutablebson::DamageVector& damages );
+                                          const mutablebson::DamageVector& damages,
+                                          bool indexesAffected,
+                                          OpDebug* debug,
+                                          const FieldRefSet* updatedPaths = NULL );
 
         // -----------
 
@@ -266,6 +332,14 @@ namespace mongo {
 
         bool isCapped() const;
 
+        /**
+         * Get a pointer to this collection's insert notifier; non-NULL iff the
+         * collection is capped.
+         */
+        boost::shared_ptr<CappedInsertNotifier> getCappedInsertNotifier() const {
+            return _cappedNotifier;
+        }
+
         uint64_t numRecords( OperationContext* txn ) const;
 
         uint64_t dataSize( OperationContext* txn ) const;
@@ -317,6 +391,9 @@ namespace mongo {
         // should be about the data.
         mutable CursorManager _cursorManager;
 
+        // Non-NULL iff this collection is capped.  See getCappedInsertNotifier().
+        boost::shared_ptr<CappedInsertNotifier> _cappedNotifier;
+
         friend class Database;
         friend class IndexCatalog;
         friend class NamespaceDetails;
@@ -32,6 +32,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <memory>
+
 #include "mongo/db/catalog/collection_info_cache.h"
 
 #include "mongo/db/catalog/collection.h"
@@ -48,14 +50,16 @@ namespace mongo {
 
     CollectionInfoCache::CollectionInfoCache( Collection* collection )
         : _collection( collection ),
-          _keysComputed( false ),
           _planCache(new PlanCache(collection->ns().ns())),
           _querySettings(new QuerySettings()) { }
 
+    CollectionInfoCache::~CollectionInfoCache() {
+        delete _indexedPaths.loadRelaxed();
+    }
+
     void CollectionInfoCache::reset( OperationContext* txn ) {
         LOG(1) << _collection->ns().ns() << ": clearing plan cache - collection info cache reset";
         clearQueryCache();
-        _keysComputed = false;
         computeIndexKeys( txn );
         // query settings is not affected by info cache reset.
         // index filters should persist throughout life of collection
@@ -64,54 +68,84 @@ namespace mongo {
     const UpdateIndexData& CollectionInfoCache::indexKeys( OperationContext* txn ) const {
         // This requires "some" lock, and MODE_IS is an expression for that, for now.
         dassert(txn->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_IS));
-        invariant(_keysComputed);
-        return _indexedPaths;
+        const IndexedPaths* snapshot = _indexedPaths.loadRelaxed();
+        invariant(snapshot);
+        return snapshot->indexedPaths;
     }
 
-    void CollectionInfoCache::computeIndexKeys( OperationContext* txn ) {
-        // This function modified objects attached to the Collection so we need a write lock
-        invariant(txn->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X));
-        _indexedPaths.clear();
+    const UpdateIndexData* CollectionInfoCache::indexKeysFor( OperationContext* txn,
+                                                              const StringData& indexName ) const {
+        // This requires "some" lock, and MODE_IS is an expression for that, for now.
+        dassert(txn->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_IS));
+        const IndexedPaths* snapshot = _indexedPaths.loadRelaxed();
+        invariant(snapshot);
+
+        OwnedPointerMap<std::string, UpdateIndexData>::MapType::const_iterator it =
+            snapshot->indexedPathsPerIndex.map().find(indexName.toString());
+        if (it == snapshot->indexedPathsPerIndex.map().end())
+            return NULL;
+        return it->second;
+    }
 
-        IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(txn, true);
-        while (i.more()) {
-            IndexDescriptor* descriptor = i.next();
+    namespace {
 
+        // Registers in 'paths' every path whose value contributes to the keys of the index
+        // described by 'descriptor'.
+        void addPathsForIndex(const IndexDescriptor* descriptor, UpdateIndexData* paths) {
             if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
                 BSONObj key = descriptor->keyPattern();
                 BSONObjIterator j(key);
                 while (j.more()) {
                     BSONElement e = j.next();
-                    _indexedPaths.addPath(e.fieldName());
+                    paths->addPath(e.fieldName());
                 }
             }
             else {
                 fts::FTSSpec ftsSpec(descriptor->infoObj());
 
                 if (ftsSpec.wildcard()) {
-                    _indexedPaths.allPathsIndexed();
+                    paths->allPathsIndexed();
                 }
                 else {
                     for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                        _indexedPaths.addPath(ftsSpec.extraBefore(i));
+                        paths->addPath(ftsSpec.extraBefore(i));
                     }
                     for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
                          it != ftsSpec.weights().end();
                          ++it) {
-                        _indexedPaths.addPath(it->first);
+                        paths->addPath(it->first);
                     }
                     for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                        _indexedPaths.addPath(ftsSpec.extraAfter(i));
+                        paths->addPath(ftsSpec.extraAfter(i));
                     }
                     // Any update to a path containing "language" as a component could change the
                     // language of a subdocument.  Add the override field as a path component.
-                    _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
+                    paths->addPathComponent(ftsSpec.languageOverrideField());
                 }
             }
         }
 
-        _keysComputed = true;
+    }  // namespace
+
+    void CollectionInfoCache::computeIndexKeys( OperationContext* txn ) {
+        // The write lock both protects the index catalog iteration and guarantees that
+        // no reader is still looking at the snapshot we are about to reclaim.
+        invariant(txn->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X));
+
+        std::auto_ptr<IndexedPaths> next(new IndexedPaths());
+
+        IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(txn, true);
+        while (i.more()) {
+            IndexDescriptor* descriptor = i.next();
+
+            addPathsForIndex(descriptor, &next->indexedPaths);
+
+            std::auto_ptr<UpdateIndexData> perIndex(new UpdateIndexData());
+            addPathsForIndex(descriptor, perIndex.get());
+            next->indexedPathsPerIndex.mutableMap()[descriptor->indexName()] = perIndex.release();
+        }
 
+        delete _indexedPaths.swap(next.release());
     }
 
     void CollectionInfoCache::notifyOfWriteOp() {
@@ -32,9 +32,13 @@
 
 #include <boost/scoped_ptr.hpp>
 
+#include <string>
+
+#include "mongo/base/owned_pointer_map.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -48,6 +52,7 @@ namespace mongo {
     public:
 
         CollectionInfoCache( Collection* collection );
+        ~CollectionInfoCache();
 
         /*
          * Resets entire cache state. Must be called under exclusive DB lock.
@@ -75,6 +80,13 @@ namespace mongo {
         */
         const UpdateIndexData& indexKeys( OperationContext* txn ) const;
 
+        /* get the set of paths covered by the single index named 'indexName', or NULL if
+           the index is not known to the cache.  handy to decide whether an update that
+           names the fields it touches needs to maintain that index at all.
+        */
+        const UpdateIndexData* indexKeysFor( OperationContext* txn,
+                                             const StringData& indexName ) const;
+
         // ---------------------
 
         /**
@@ -91,9 +103,21 @@ namespace mongo {
 
         Collection* _collection; // not owned
 
-        // ---  index keys cache
-        bool _keysComputed;
-        UpdateIndexData _indexedPaths;
+        // Indexed-path metadata, immutable once published.  computeIndexKeys() builds a
+        // fresh instance on the side and installs it with a single pointer swap, so
+        // readers resolve the metadata with one load and never see a partial rebuild.
+        struct IndexedPaths {
+            // The set of paths covered by any index on the collection.
+            UpdateIndexData indexedPaths;
+
+            // The paths covered by each individual index, keyed by index name.
+            OwnedPointerMap<std::string, UpdateIndexData> indexedPathsPerIndex;
+        };
+
+        // The current snapshot; NULL until computeIndexKeys() first runs.  Superseded
+        // snapshots are reclaimed immediately, because the writer holds the collection
+        // X-lock and readers are required to hold at least MODE_IS.
+        AtomicWord<IndexedPaths*> _indexedPaths;
 
         // A cache for query plans.
         boost::scoped_ptr<PlanCache> _planCache;
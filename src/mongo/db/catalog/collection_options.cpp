@@ -60,6 +60,7 @@ namespace mongo {
         flags = 0;
         flagsSet = false;
         temp = false;
+        tier.clear();
         storageEngine = BSONObj();
     }
 
@@ -122,6 +123,30 @@ namespace mongo {
             else if ( fieldName == "temp" ) {
                 temp = e.trueValue();
             }
+            else if ( fieldName == "tier" ) {
+                if ( e.type() != String ) {
+                    return Status( ErrorCodes::BadValue, "'tier' has to be a string." );
+                }
+                const std::string t = e.String();
+                if ( t.empty() ) {
+                    return Status( ErrorCodes::BadValue, "'tier' cannot be empty." );
+                }
+                // The tier becomes a directory component of storage engine idents, so it
+                // has to be a plain name, never a path.
+                for ( size_t j = 0; j < t.size(); j++ ) {
+                    const char c = t[j];
+                    const bool ok =
+                        ( c >= 'a' && c <= 'z' ) ||
+                        ( c >= 'A' && c <= 'Z' ) ||
+                        ( c >= '0' && c <= '9' ) ||
+                        c == '_';
+                    if ( !ok ) {
+                        return Status( ErrorCodes::BadValue,
+                                       "'tier' can only contain letters, digits and '_'." );
+                    }
+                }
+                tier = t;
+            }
             else if (fieldName == "storageEngine") {
                 // Storage engine-specific collection options.
                 // "storageEngine" field must be of type "document".
@@ -190,6 +215,9 @@ namespace mongo {
         if ( temp )
             b.appendBool( "temp", true );
 
+        if ( !tier.empty() )
+            b.append( "tier", tier );
+
         if (!storageEngine.isEmpty()) {
             b.append("storageEngine", storageEngine);
         }
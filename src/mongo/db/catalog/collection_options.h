@@ -81,6 +81,12 @@ namespace mongo {
 
         bool temp;
 
+        // Storage tier for the collection's data. Storage engines that place data in per
+        // collection files create them under a subdirectory with this name, which the
+        // operator can point at different media. Empty means the default tier. Indexes
+        // always stay on the default tier.
+        std::string tier;
+
         // Storage engine collection options. Always owned or empty.
         BSONObj storageEngine;
     };
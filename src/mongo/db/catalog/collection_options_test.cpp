@@ -85,6 +85,24 @@ namespace mongo {
         ASSERT_OK( CollectionOptions().parse( BSON( "foo" << "bar" ) ) );
     }
 
+    TEST( CollectionOptions, ParseTierField ) {
+        CollectionOptions options;
+        ASSERT_OK( options.parse( fromjson( "{tier: 'cold'}" ) ) );
+        ASSERT_EQUALS( "cold", options.tier );
+        checkRoundTrip( options );
+
+        // Default tier is not persisted.
+        ASSERT_FALSE( CollectionOptions().toBSON().hasField( "tier" ) );
+    }
+
+    TEST( CollectionOptions, ErrorBadTier ) {
+        // The tier becomes a directory name, so only plain names are allowed.
+        ASSERT_NOT_OK( CollectionOptions().parse( fromjson( "{tier: 1}" ) ) );
+        ASSERT_NOT_OK( CollectionOptions().parse( fromjson( "{tier: ''}" ) ) );
+        ASSERT_NOT_OK( CollectionOptions().parse( fromjson( "{tier: 'a/b'}" ) ) );
+        ASSERT_NOT_OK( CollectionOptions().parse( fromjson( "{tier: '..'}" ) ) );
+    }
+
     TEST(CollectionOptions, InvalidStorageEngineField) {
         // "storageEngine" field has to be an object if present.
         ASSERT_NOT_OK( CollectionOptions().parse(fromjson("{storageEngine: 1}")));
@@ -42,6 +42,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/platform/random.h"
+#include "mongo/util/concurrency/big_reader_lock.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/startup_test.h"
 
@@ -111,7 +112,10 @@ namespace mongo {
 
         int64_t nextSeed();
     private:
-        SimpleMutex _mutex;
+        // Maps cursor manager id to namespace. Hit by every getMore/killCursors to
+        // resolve the namespace, written only when a CursorManager is created or
+        // destroyed, hence the reader-optimized lock.
+        mutable BigReaderLock _mutex;
 
         typedef unordered_map<unsigned,string> Map;
         Map _idToNS;
@@ -146,7 +150,7 @@ namespace mongo {
     }
 
     int64_t GlobalCursorIdCache::nextSeed() {
-        SimpleMutex::scoped_lock lk( _mutex );
+        BigReaderLock::Exclusive lk( _mutex );
         if ( !_secureRandom )
             _secureRandom.reset(SecureRandom::create());
         return _secureRandom->nextInt64();
@@ -155,7 +159,7 @@ namespace mongo {
     unsigned GlobalCursorIdCache::created( const std::string& ns ) {
         static const unsigned MAX_IDS = 1000 * 1000 * 1000;
 
-        SimpleMutex::scoped_lock lk( _mutex );
+        BigReaderLock::Exclusive lk( _mutex );
 
         fassert( 17359, _idToNS.size() < MAX_IDS );
 
@@ -173,7 +177,7 @@ namespace mongo {
     }
 
     void GlobalCursorIdCache::destroyed( unsigned id, const std::string& ns ) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        BigReaderLock::Exclusive lk( _mutex );
         invariant( ns == _idToNS[id] );
         _idToNS.erase( id );
     }
@@ -181,7 +185,7 @@ namespace mongo {
     bool GlobalCursorIdCache::eraseCursor(OperationContext* txn, CursorId id, bool checkAuth) {
         string ns;
         {
-            SimpleMutex::scoped_lock lk( _mutex );
+            BigReaderLock::Shared lk( _mutex );
             unsigned nsid = idFromCursorId( id );
             Map::const_iterator it = _idToNS.find( nsid );
             if ( it == _idToNS.end() ) {
@@ -229,7 +233,7 @@ namespace mongo {
     std::size_t GlobalCursorIdCache::timeoutCursors(OperationContext* txn, int millisSinceLastCall) {
         vector<string> todo;
         {
-            SimpleMutex::scoped_lock lk( _mutex );
+            BigReaderLock::Shared lk( _mutex );
             for ( Map::const_iterator i = _idToNS.begin(); i != _idToNS.end(); ++i )
                 todo.push_back( i->second );
         }
@@ -297,7 +301,8 @@ namespace mongo {
         : _nss( ns ),
           _mutex( "CursorManager" ) {
         _collectionCacheRuntimeId = globalCursorIdCache->created( _nss.ns() );
-        _random.reset( new PseudoRandom( globalCursorIdCache->nextSeed() ) );
+        PseudoRandom random( globalCursorIdCache->nextSeed() );
+        _nextCursorPart.store( static_cast<unsigned>( random.nextInt32() ) );
     }
 
     CursorManager::~CursorManager() {
@@ -306,71 +311,82 @@ namespace mongo {
     }
 
     void CursorManager::invalidateAll( bool collectionGoingAway ) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        {
+            SimpleMutex::scoped_lock lk( _mutex );
 
-        for ( ExecSet::iterator it = _nonCachedExecutors.begin();
-              it != _nonCachedExecutors.end();
-              ++it ) {
+            for ( ExecSet::iterator it = _nonCachedExecutors.begin();
+                  it != _nonCachedExecutors.end();
+                  ++it ) {
 
-            // we kill the executor, but it deletes itself
-            PlanExecutor* exec = *it;
-            exec->kill();
-            invariant( exec->collection() == NULL );
+                // we kill the executor, but it deletes itself
+                PlanExecutor* exec = *it;
+                exec->kill();
+                invariant( exec->collection() == NULL );
+            }
+            _nonCachedExecutors.clear();
         }
-        _nonCachedExecutors.clear();
 
-        if ( collectionGoingAway ) {
-            // we're going to wipe out the world
-            for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-                ClientCursor* cc = i->second;
+        for ( int p = 0; p < kNumPartitions; p++ ) {
+            Partition& partition = _partitions[p];
+            SimpleMutex::scoped_lock lk( partition.mutex );
+            CursorMap& cursors = partition.cursors;
 
-                cc->kill();
+            if ( collectionGoingAway ) {
+                // we're going to wipe out the world
+                for ( CursorMap::const_iterator i = cursors.begin(); i != cursors.end(); ++i ) {
+                    ClientCursor* cc = i->second;
 
-                invariant( cc->getExecutor() == NULL || cc->getExecutor()->collection() == NULL );
+                    cc->kill();
 
-                // If the CC is pinned, somebody is actively using it and we do not delete it.
-                // Instead we notify the holder that we killed it.  The holder will then delete the
-                // CC.
-                //
-                // If the CC is not pinned, there is nobody actively holding it.  We can safely
-                // delete it.
-                if (!cc->isPinned()) {
-                    delete cc;
+                    invariant( cc->getExecutor() == NULL ||
+                               cc->getExecutor()->collection() == NULL );
+
+                    // If the CC is pinned, somebody is actively using it and we do not delete
+                    // it.  Instead we notify the holder that we killed it.  The holder will
+                    // then delete the CC.
+                    //
+                    // If the CC is not pinned, there is nobody actively holding it.  We can
+                    // safely delete it.
+                    if (!cc->isPinned()) {
+                        delete cc;
+                    }
                 }
+                cursors.clear();
             }
-        }
-        else {
-            CursorMap newMap;
+            else {
+                CursorMap newMap;
+
+                // collection will still be around, just all PlanExecutors are invalid
+                for ( CursorMap::const_iterator i = cursors.begin(); i != cursors.end(); ++i ) {
+                    ClientCursor* cc = i->second;
+
+                    // Note that a valid ClientCursor state is "no cursor no executor."  This is
+                    // because the set of active cursor IDs in ClientCursor is used as
+                    // representation of query state.  See sharding_block.h.  TODO(greg,hk):
+                    // Move this out.
+                    if (NULL == cc->getExecutor() ) {
+                        newMap.insert( *i );
+                        continue;
+                    }
+
+                    if (cc->isPinned() || cc->isAggCursor()) {
+                        // Pinned cursors need to stay alive, so we leave them around.
+                        // Aggregation cursors also can stay alive (since they don't have their
+                        // lifetime bound to the underlying collection).  However, if they have
+                        // an associated executor, we need to kill it, because it's now invalid.
+                        if ( cc->getExecutor() )
+                            cc->getExecutor()->kill();
+                        newMap.insert( *i );
+                    }
+                    else {
+                        cc->kill();
+                        delete cc;
+                    }
 
-            // collection will still be around, just all PlanExecutors are invalid
-            for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-                ClientCursor* cc = i->second;
-
-                // Note that a valid ClientCursor state is "no cursor no executor."  This is because
-                // the set of active cursor IDs in ClientCursor is used as representation of query
-                // state.  See sharding_block.h.  TODO(greg,hk): Move this out.
-                if (NULL == cc->getExecutor() ) {
-                    newMap.insert( *i );
-                    continue;
-                }
-
-                if (cc->isPinned() || cc->isAggCursor()) {
-                    // Pinned cursors need to stay alive, so we leave them around.  Aggregation
-                    // cursors also can stay alive (since they don't have their lifetime bound to
-                    // the underlying collection).  However, if they have an associated executor, we
-                    // need to kill it, because it's now invalid.
-                    if ( cc->getExecutor() )
-                        cc->getExecutor()->kill();
-                    newMap.insert( *i );
-                }
-                else {
-                    cc->kill();
-                    delete cc;
                 }
 
+                cursors = newMap;
             }
-
-            _cursors = newMap;
         }
     }
 
@@ -383,44 +399,62 @@ namespace mongo {
             return;
         }
 
-        SimpleMutex::scoped_lock lk( _mutex );
+        {
+            SimpleMutex::scoped_lock lk( _mutex );
 
-        for ( ExecSet::iterator it = _nonCachedExecutors.begin();
-              it != _nonCachedExecutors.end();
-              ++it ) {
+            for ( ExecSet::iterator it = _nonCachedExecutors.begin();
+                  it != _nonCachedExecutors.end();
+                  ++it ) {
 
-            PlanExecutor* exec = *it;
-            exec->invalidate(txn, dl, type);
+                PlanExecutor* exec = *it;
+                exec->invalidate(txn, dl, type);
+            }
         }
 
-        for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-            PlanExecutor* exec = i->second->getExecutor();
-            if ( exec ) {
-                exec->invalidate(txn, dl, type);
+        for ( int p = 0; p < kNumPartitions; p++ ) {
+            Partition& partition = _partitions[p];
+            SimpleMutex::scoped_lock lk( partition.mutex );
+
+            for ( CursorMap::const_iterator i = partition.cursors.begin();
+                  i != partition.cursors.end(); ++i ) {
+                PlanExecutor* exec = i->second->getExecutor();
+                if ( exec ) {
+                    exec->invalidate(txn, dl, type);
+                }
             }
         }
     }
 
     std::size_t CursorManager::timeoutCursors( int millisSinceLastCall ) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        std::size_t totalTimedOut = 0;
 
-        vector<ClientCursor*> toDelete;
+        // Each partition is swept under its own mutex, so an expensive sweep of one
+        // partition never blocks cursor traffic on the others.
+        for ( int p = 0; p < kNumPartitions; p++ ) {
+            Partition& partition = _partitions[p];
+            SimpleMutex::scoped_lock lk( partition.mutex );
 
-        for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-            ClientCursor* cc = i->second;
-            if ( cc->shouldTimeout( millisSinceLastCall ) )
-                toDelete.push_back( cc );
-        }
+            vector<ClientCursor*> toDelete;
+
+            for ( CursorMap::const_iterator i = partition.cursors.begin();
+                  i != partition.cursors.end(); ++i ) {
+                ClientCursor* cc = i->second;
+                if ( cc->shouldTimeout( millisSinceLastCall ) )
+                    toDelete.push_back( cc );
+            }
 
-        for ( vector<ClientCursor*>::const_iterator i = toDelete.begin();
-                i != toDelete.end(); ++i ) {
-            ClientCursor* cc = *i;
-            _deregisterCursor_inlock( cc );
-            cc->kill();
-            delete cc;
+            for ( vector<ClientCursor*>::const_iterator i = toDelete.begin();
+                    i != toDelete.end(); ++i ) {
+                ClientCursor* cc = *i;
+                _deregisterCursor_inlock( partition, cc );
+                cc->kill();
+                delete cc;
+            }
+
+            totalTimedOut += toDelete.size();
         }
 
-        return toDelete.size();
+        return totalTimedOut;
     }
 
     void CursorManager::registerExecutor( PlanExecutor* exec ) {
@@ -435,9 +469,10 @@ namespace mongo {
     }
 
     ClientCursor* CursorManager::find( CursorId id, bool pin ) {
-        SimpleMutex::scoped_lock lk( _mutex );
-        CursorMap::const_iterator it = _cursors.find( id );
-        if ( it == _cursors.end() )
+        Partition& partition = _partitionForId( id );
+        SimpleMutex::scoped_lock lk( partition.mutex );
+        CursorMap::const_iterator it = partition.cursors.find( id );
+        if ( it == partition.cursors.end() )
             return NULL;
 
         ClientCursor* cursor = it->second;
@@ -452,7 +487,8 @@ namespace mongo {
     }
 
     void CursorManager::unpin( ClientCursor* cursor ) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        Partition& partition = _partitionForId( cursor->cursorid() );
+        SimpleMutex::scoped_lock lk( partition.mutex );
 
         invariant( cursor->isPinned() );
         cursor->unsetPinned();
@@ -463,47 +499,68 @@ namespace mongo {
     }
 
     void CursorManager::getCursorIds( std::set<CursorId>* openCursors ) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        for ( int p = 0; p < kNumPartitions; p++ ) {
+            Partition& partition = _partitions[p];
+            SimpleMutex::scoped_lock lk( partition.mutex );
 
-        for ( CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i ) {
-            ClientCursor* cc = i->second;
-            openCursors->insert( cc->cursorid() );
+            for ( CursorMap::const_iterator i = partition.cursors.begin();
+                  i != partition.cursors.end(); ++i ) {
+                ClientCursor* cc = i->second;
+                openCursors->insert( cc->cursorid() );
+            }
         }
     }
 
     size_t CursorManager::numCursors(){
-        SimpleMutex::scoped_lock lk( _mutex );
-        return _cursors.size();
+        size_t count = 0;
+        for ( int p = 0; p < kNumPartitions; p++ ) {
+            Partition& partition = _partitions[p];
+            SimpleMutex::scoped_lock lk( partition.mutex );
+            count += partition.cursors.size();
+        }
+        return count;
     }
 
-    CursorId CursorManager::_allocateCursorId_inlock() {
-        for ( int i = 0; i < 10000; i++ ) {
-            unsigned mypart = static_cast<unsigned>( _random->nextInt32() );
-            CursorId id = cursorIdFromParts( _collectionCacheRuntimeId, mypart );
-            if ( _cursors.count( id ) == 0 )
-                return id;
-        }
-        fassertFailed( 17360 );
+    CursorManager::Partition& CursorManager::_partitionForId( CursorId id ) {
+        // The low 32 bits come from _nextCursorPart, so consecutive allocations
+        // land in consecutive partitions.
+        return _partitions[ static_cast<unsigned>( id ) & ( kNumPartitions - 1 ) ];
+    }
+
+    CursorId CursorManager::_allocateCursorId() {
+        unsigned mypart = _nextCursorPart.fetchAndAdd( 1 );
+        return cursorIdFromParts( _collectionCacheRuntimeId, mypart );
     }
 
     CursorId CursorManager::registerCursor( ClientCursor* cc ) {
         invariant( cc );
-        SimpleMutex::scoped_lock lk( _mutex );
-        CursorId id = _allocateCursorId_inlock();
-        _cursors[id] = cc;
-        return id;
+        for ( int i = 0; i < 10000; i++ ) {
+            // Id generation takes no lock; the insert into the owning partition
+            // catches the (rare) case of the 32 bit counter lapping a cursor that
+            // is still open.
+            CursorId id = _allocateCursorId();
+            Partition& partition = _partitionForId( id );
+            SimpleMutex::scoped_lock lk( partition.mutex );
+            if ( partition.cursors.count( id ) == 0 ) {
+                partition.cursors[id] = cc;
+                return id;
+            }
+        }
+        fassertFailed( 17360 );
     }
 
     void CursorManager::deregisterCursor( ClientCursor* cc ) {
-        SimpleMutex::scoped_lock lk( _mutex );
-        _deregisterCursor_inlock( cc );
+        Partition& partition = _partitionForId( cc->cursorid() );
+        SimpleMutex::scoped_lock lk( partition.mutex );
+        _deregisterCursor_inlock( partition, cc );
     }
 
     bool CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool checkAuth) {
-        SimpleMutex::scoped_lock lk( _mutex );
+        Partition& partition = _partitionForId( id );
+        SimpleMutex::scoped_lock lk( partition.mutex );
 
-        CursorMap::iterator it = _cursors.find( id );
-        if ( it == _cursors.end() ) {
+        CursorMap::iterator it = partition.cursors.find( id );
+        if ( it == partition.cursors.end() ) {
             if ( checkAuth )
                 audit::logKillCursorsAuthzCheck( txn->getClient(),
                                                  _nss,
@@ -525,15 +582,15 @@ namespace mongo {
                  !cursor->isPinned() );
 
         cursor->kill();
-        _deregisterCursor_inlock( cursor );
+        _deregisterCursor_inlock( partition, cursor );
         delete cursor;
         return true;
     }
 
-    void CursorManager::_deregisterCursor_inlock( ClientCursor* cc ) {
+    void CursorManager::_deregisterCursor_inlock( Partition& partition, ClientCursor* cc ) {
         invariant( cc );
         CursorId id = cc->cursorid();
-        _cursors.erase( id );
+        partition.cursors.erase( id );
     }
 
 }
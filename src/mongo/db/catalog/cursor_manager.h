@@ -36,6 +36,7 @@
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/record_id.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/util/concurrency/mutex.h"
 
@@ -130,20 +131,43 @@ namespace mongo {
         static std::size_t timeoutCursorsGlobal(OperationContext* txn, int millisSinceLastCall);
 
     private:
-        CursorId _allocateCursorId_inlock();
-        void _deregisterCursor_inlock( ClientCursor* cc );
+        enum { kNumPartitions = 16 }; // must be a power of two
+
+        typedef std::map<CursorId,ClientCursor*> CursorMap;
+
+        /**
+         * Cursors are striped by id across these partitions, each with its own
+         * mutex, so that pin/unpin/register traffic on different cursors does not
+         * serialize on a single lock.  All cross-partition operations (timeout,
+         * invalidation, stats) visit the partitions one at a time and never hold
+         * more than one partition mutex at once.
+         */
+        struct Partition {
+            Partition() : mutex( "CursorManagerPartition" ) {}
+
+            SimpleMutex mutex;
+            CursorMap cursors;
+        };
+
+        Partition& _partitionForId( CursorId id );
+        CursorId _allocateCursorId();
+        void _deregisterCursor_inlock( Partition& partition, ClientCursor* cc );
 
         NamespaceString _nss;
         unsigned _collectionCacheRuntimeId;
-        boost::scoped_ptr<PseudoRandom> _random;
 
+        // Low 32 bits of the next cursor id, seeded randomly at construction and
+        // bumped with an atomic increment; no lock is taken to generate an id.
+        // Uniqueness is enforced when the id is inserted into its partition.
+        AtomicUInt32 _nextCursorPart;
+
+        // guards _nonCachedExecutors only; cursors live in the partitions
         SimpleMutex _mutex;
 
         typedef unordered_set<PlanExecutor*> ExecSet;
         ExecSet _nonCachedExecutors;
 
-        typedef std::map<CursorId,ClientCursor*> CursorMap;
-        CursorMap _cursors;
+        Partition _partitions[kNumPartitions];
     };
 
 }
@@ -46,6 +46,7 @@
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/commands/dbhash.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/global_environment_experiment.h"
 #include "mongo/db/global_environment_d.h"
@@ -54,6 +55,7 @@
 #include "mongo/db/introspect.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/database_stats_cache.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/db/storage/storage_engine.h"
@@ -293,44 +295,44 @@ namespace mongo {
     }
 
     void Database::getStats( OperationContext* opCtx, BSONObjBuilder* output, double scale ) {
-        list<string> collections;
-        _dbEntry->getCollectionNamespaces( &collections );
+        DatabaseStatsEntry stats;
+        if ( !DatabaseStatsCache::getStats( _name, &stats ) ) {
+            list<string> collections;
+            _dbEntry->getCollectionNamespaces( &collections );
+
+            for (list<string>::const_iterator it = collections.begin();
+                 it != collections.end();
+                 ++it) {
+                const string ns = *it;
+
+                Collection* collection = getCollection( ns );
+                if ( !collection )
+                    continue;
 
-        long long ncollections = 0;
-        long long objects = 0;
-        long long size = 0;
-        long long storageSize = 0;
-        long long numExtents = 0;
-        long long indexes = 0;
-        long long indexSize = 0;
+                stats.collections += 1;
+                stats.objects += collection->numRecords(opCtx);
+                stats.dataSize += collection->dataSize(opCtx);
 
-        for (list<string>::const_iterator it = collections.begin(); it != collections.end(); ++it) {
-            const string ns = *it;
-
-            Collection* collection = getCollection( ns );
-            if ( !collection )
-                continue;
+                BSONObjBuilder temp;
+                stats.storageSize += collection->getRecordStore()->storageSize( opCtx, &temp );
+                stats.numExtents += temp.obj()["numExtents"].numberInt(); // XXX
 
-            ncollections += 1;
-            objects += collection->numRecords(opCtx);
-            size += collection->dataSize(opCtx);
-
-            BSONObjBuilder temp;
-            storageSize += collection->getRecordStore()->storageSize( opCtx, &temp );
-            numExtents += temp.obj()["numExtents"].numberInt(); // XXX
+                stats.indexes += collection->getIndexCatalog()->numIndexesTotal( opCtx );
+                stats.indexSize += collection->getIndexSize(opCtx);
+            }
 
-            indexes += collection->getIndexCatalog()->numIndexesTotal( opCtx );
-            indexSize += collection->getIndexSize(opCtx);
+            DatabaseStatsCache::putStats( _name, stats );
         }
 
-        output->appendNumber( "collections" , ncollections );
-        output->appendNumber( "objects" , objects );
-        output->append      ( "avgObjSize" , objects == 0 ? 0 : double(size) / double(objects) );
-        output->appendNumber( "dataSize" , size / scale );
-        output->appendNumber( "storageSize" , storageSize / scale);
-        output->appendNumber( "numExtents" , numExtents );
-        output->appendNumber( "indexes" , indexes );
-        output->appendNumber( "indexSize" , indexSize / scale );
+        output->appendNumber( "collections" , stats.collections );
+        output->appendNumber( "objects" , stats.objects );
+        output->append      ( "avgObjSize" , stats.objects == 0 ?
+                                  0 : double(stats.dataSize) / double(stats.objects) );
+        output->appendNumber( "dataSize" , stats.dataSize / scale );
+        output->appendNumber( "storageSize" , stats.storageSize / scale);
+        output->appendNumber( "numExtents" , stats.numExtents );
+        output->appendNumber( "indexes" , stats.indexes );
+        output->appendNumber( "indexSize" , stats.indexSize / scale );
 
         _dbEntry->appendExtraStats( opCtx, output, scale );
     }
@@ -392,6 +394,8 @@ namespace mongo {
 
         _clearCollectionCache( txn, fullns ); // we want to do this always
 
+        wipeDigestForDbHash( fullns );
+
         if ( !s.isOK() )
             return s;
 
@@ -459,6 +463,9 @@ namespace mongo {
             _clearCollectionCache( txn, fromNS );
             _clearCollectionCache( txn, toNS );
 
+            wipeDigestForDbHash( fromNS );
+            wipeDigestForDbHash( toNS );
+
             Top::global.collectionDropped( fromNS.toString() );
         }
 
@@ -504,6 +511,10 @@ namespace mongo {
 
         audit::logCreateCollection( currentClient.get(), ns );
 
+        // A fresh collection must not inherit a dbHash digest left over from an earlier
+        // incarnation of this namespace (e.g. across a dropDatabase).
+        wipeDigestForDbHash( ns );
+
         txn->recoveryUnit()->registerChange( new AddCollectionChange(this, ns) );
 
         Status status = _dbEntry->createCollection(txn, ns, options, allocateDefaultSpace);
@@ -574,6 +585,8 @@ namespace mongo {
         dbHolder().close( txn, name );
         db = NULL; // d is now deleted
 
+        DatabaseStatsCache::invalidate( name );
+
         getGlobalEnvironment()->getGlobalStorageEngine()->dropDatabase( txn, name );
     }
 
@@ -30,6 +30,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <memory>
+
 #include "mongo/db/audit.h"
 #include "mongo/db/auth/auth_index_d.h"
 #include "mongo/db/background.h"
@@ -68,21 +70,50 @@ namespace {
         return _dbHolder;
     }
 
+    DatabaseHolder::~DatabaseHolder() {
+        delete _dbs.loadRelaxed();
+        for (size_t i = 0; i < _retired.size(); i++) {
+            delete _retired[i];
+        }
+    }
+
     Database* DatabaseHolder::get(OperationContext* txn,
                                   const StringData& ns) const {
 
         const StringData db = _todb(ns);
         invariant(txn->lockState()->isDbLockedForMode(db, MODE_IS));
 
-        SimpleMutex::scoped_lock lk(_m);
-        DBs::const_iterator it = _dbs.find(db);
-        if (it != _dbs.end()) {
+        // The caller's DB IS-lock doubles as the read-side grace period: snapshots are
+        // only reclaimed under the global X-lock, which cannot be granted while any
+        // database lock is held, so the map we load here stays valid for the lookup.
+        // The relaxed load is safe because _publish_inlock() stores the fully built map
+        // with a barrier and everything after this reads through the loaded pointer.
+        const DBs* dbs = _dbs.loadRelaxed();
+        DBs::const_iterator it = dbs->find(db);
+        if (it != dbs->end()) {
             return it->second;
         }
 
         return NULL;
     }
 
+    void DatabaseHolder::_publish_inlock(OperationContext* txn, DBs* next) {
+        DBs* old = _dbs.swap(next);
+        if (txn->lockState()->isW()) {
+            // Readers of get() hold a DB IS-lock, which cannot coexist with our global
+            // X-lock, so the superseded snapshot and everything retired before it are
+            // unreachable.
+            delete old;
+            for (size_t i = 0; i < _retired.size(); i++) {
+                delete _retired[i];
+            }
+            _retired.clear();
+        }
+        else {
+            _retired.push_back(old);
+        }
+    }
+
     Database* DatabaseHolder::openDb(OperationContext* txn,
                                      const StringData& ns,
                                      bool* justCreated) {
@@ -128,10 +159,13 @@ namespace {
         // Only one thread can be inside this method for the same DB name, because of the
         // requirement for X-lock on the database. So there is no way we can insert two different
         // databases for the same name.
-        SimpleMutex::scoped_lock lk(_m);
+        BigReaderLock::Exclusive lk(_m);
 
         db = new Database(txn, dbname, entry);
-        _dbs[dbname] = db;
+
+        std::auto_ptr<DBs> next(new DBs(*_dbs.loadRelaxed()));
+        (*next)[dbname] = db;
+        _publish_inlock(txn, next.release());
 
         return db;
     }
@@ -143,16 +177,20 @@ namespace {
 
         const StringData dbName = _todb(ns);
 
-        SimpleMutex::scoped_lock lk(_m);
+        BigReaderLock::Exclusive lk(_m);
 
-        DBs::const_iterator it = _dbs.find(dbName);
-        if (it == _dbs.end()) {
+        const DBs* dbs = _dbs.loadRelaxed();
+        DBs::const_iterator it = dbs->find(dbName);
+        if (it == dbs->end()) {
             return;
         }
 
         it->second->close( txn );
         delete it->second;
-        _dbs.erase(it);
+
+        std::auto_ptr<DBs> next(new DBs(*dbs));
+        next->erase(dbName);
+        _publish_inlock(txn, next.release());
 
         getGlobalEnvironment()->getGlobalStorageEngine()->closeDatabase(txn, dbName.toString());
     }
@@ -160,10 +198,12 @@ namespace {
     bool DatabaseHolder::closeAll(OperationContext* txn, BSONObjBuilder& result, bool force) {
         invariant(txn->lockState()->isW());
 
-        SimpleMutex::scoped_lock lk(_m);
+        BigReaderLock::Exclusive lk(_m);
+
+        std::auto_ptr<DBs> next(new DBs(*_dbs.loadRelaxed()));
 
         set< string > dbs;
-        for ( DBs::const_iterator i = _dbs.begin(); i != _dbs.end(); ++i ) {
+        for ( DBs::const_iterator i = next->begin(); i != next->end(); ++i ) {
             dbs.insert( i->first );
         }
 
@@ -183,17 +223,19 @@ namespace {
                 continue;
             }
 
-            Database* db = _dbs[name];
+            Database* db = (*next)[name];
             db->close( txn );
             delete db;
 
-            _dbs.erase( name );
+            next->erase( name );
 
             getGlobalEnvironment()->getGlobalStorageEngine()->closeDatabase( txn, name );
 
             bb.append( name );
         }
 
+        _publish_inlock(txn, next.release());
+
         bb.done();
         if( nNotClosed ) {
             result.append("nNotClosed", nNotClosed);
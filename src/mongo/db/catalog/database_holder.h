@@ -28,9 +28,13 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/big_reader_lock.h"
 #include "mongo/util/string_map.h"
 
 namespace mongo {
@@ -40,7 +44,8 @@ namespace mongo {
      */
     class DatabaseHolder {
     public:
-        DatabaseHolder() : _m("dbholder") { }
+        DatabaseHolder() : _m("dbholder"), _dbs(new DBs()) { }
+        ~DatabaseHolder();
 
         /**
          * Retrieves an already opened database or returns NULL. Must be called with the database
@@ -76,8 +81,11 @@ namespace mongo {
          * lock is held, which would prevent database from disappearing or being created.
          */
         void getAllShortNames( std::set<std::string>& all ) const {
-            SimpleMutex::scoped_lock lk(_m);
-            for( DBs::const_iterator j=_dbs.begin(); j!=_dbs.end(); ++j ) {
+            // Holding _m shared keeps close() from reclaiming the snapshot underneath us;
+            // unlike get(), callers here are not required to hold any database lock.
+            BigReaderLock::Shared lk(_m);
+            const DBs* dbs = _dbs.loadRelaxed();
+            for( DBs::const_iterator j=dbs->begin(); j!=dbs->end(); ++j ) {
                 all.insert( j->first );
             }
         }
@@ -85,8 +93,27 @@ namespace mongo {
     private:
         typedef StringMap<Database*> DBs;
 
-        mutable SimpleMutex _m;
-        DBs _dbs;
+        /**
+         * Replaces the published snapshot with "next" and disposes of the old one:
+         * reclaimed immediately if the caller holds the global X-lock (no reader can
+         * exist), parked on _retired otherwise.  Must be called under _m exclusive.
+         */
+        void _publish_inlock(OperationContext* txn, DBs* next);
+
+        // Serializes writers against each other and against getAllShortNames(); the hot
+        // get() path does not take it.
+        mutable BigReaderLock _m;
+
+        // The set of open databases, published as an immutable snapshot so that get()
+        // resolves a Database* with a single atomic load.  Writers build a modified copy
+        // of the map under _m exclusive and swap it in via _publish_inlock().
+        AtomicWord<DBs*> _dbs;
+
+        // Snapshots superseded by openDb(), which holds only a DB X-lock and so may run
+        // concurrently with readers of other databases.  Reclaimed by the next writer
+        // that holds the global X-lock, under which no reader can hold the DB IS-lock
+        // that get() requires.
+        std::vector<DBs*> _retired;
     };
 
     DatabaseHolder& dbHolder();
@@ -36,6 +36,9 @@
 
 #include <vector>
 
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+
 #include "mongo/db/audit.h"
 #include "mongo/db/background.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
@@ -48,17 +51,23 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/global_environment_experiment.h"
+#include "mongo/db/index/btree_based_access_method.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_legacy.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/ops/delete.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -564,6 +573,35 @@ namespace {
                                          << keyStatus.reason() );
         }
 
+        const BSONElement filterElement = spec["partialFilterExpression"];
+        if ( !filterElement.eoo() ) {
+            if ( filterElement.type() != Object ) {
+                return Status( ErrorCodes::CannotCreateIndex,
+                               "'partialFilterExpression' for an index has to be a document" );
+            }
+
+            if ( IndexDescriptor::isIdIndexPattern( key ) ) {
+                return Status( ErrorCodes::CannotCreateIndex,
+                               "the _id index cannot be a partial index" );
+            }
+
+            if ( spec["sparse"].trueValue() ) {
+                return Status( ErrorCodes::CannotCreateIndex,
+                               "an index cannot be both partial and sparse" );
+            }
+
+            // Verify that the filter is a parseable match expression.  The parsed form is
+            // rebuilt from the spec whenever the index is opened.
+            StatusWithMatchExpression res =
+                MatchExpressionParser::parse( filterElement.Obj() );
+            if ( !res.isOK() ) {
+                return Status( ErrorCodes::CannotCreateIndex,
+                               str::stream() << "failed to parse 'partialFilterExpression': "
+                                             << res.getStatus().reason() );
+            }
+            delete res.getValue();
+        }
+
         if ( IndexDescriptor::isIdIndexPattern( key ) ) {
             BSONElement uniqueElt = spec["unique"];
             if ( !uniqueElt.eoo() && !uniqueElt.trueValue() ) {
@@ -1070,6 +1108,11 @@ namespace {
 
     // ---------------------------
 
+    // When positive, indexRecord() offloads key generation for non-unique indexes to a
+    // worker pool of this many threads.  The pool is sized on first use; later changes to
+    // the parameter toggle the offload on and off but do not resize the pool.
+    MONGO_EXPORT_SERVER_PARAMETER(internalIndexKeyGenerationThreads, int, 0);
+
     namespace {
         bool isDupsAllowed( IndexDescriptor* desc ) {
             bool isUnique = desc->unique() || KeyPattern::isIdKeyPattern(desc->keyPattern());
@@ -1079,6 +1122,60 @@ namespace {
             return repl::getGlobalReplicationCoordinator()->shouldIgnoreUniqueIndex(desc);
         }
 
+        SimpleMutex keyGenPoolLock( "indexKeyGenPool" );
+        threadpool::ThreadPool* keyGenPool = NULL;
+
+        threadpool::ThreadPool* getKeyGenPool( int nThreads ) {
+            SimpleMutex::scoped_lock lk( keyGenPoolLock );
+            if ( NULL == keyGenPool ) {
+                keyGenPool = new threadpool::ThreadPool( nThreads, "IndexKeyGen-" );
+            }
+            return keyGenPool;
+        }
+
+        /**
+         * Synchronizes a writer thread with the key-generation tasks it offloaded to the
+         * worker pool; the writer blocks in wait() until every task has reported in.
+         */
+        class KeyGenerationBatch {
+        public:
+            explicit KeyGenerationBatch( int numTasks ) : _remaining( numTasks ) { }
+
+            void taskDone() {
+                boost::mutex::scoped_lock lk( _mutex );
+                if ( 0 == --_remaining )
+                    _allDone.notify_one();
+            }
+
+            void wait() {
+                boost::mutex::scoped_lock lk( _mutex );
+                while ( _remaining > 0 )
+                    _allDone.wait( lk );
+            }
+
+        private:
+            boost::mutex _mutex;
+            boost::condition _allDone;
+            int _remaining;
+        };
+
+        void generateKeysTask( BtreeBasedAccessMethod* iam,
+                               const BSONObj* obj,
+                               BSONObjSet* keys,
+                               Status* result,
+                               KeyGenerationBatch* batch ) {
+            try {
+                iam->computeKeys( *obj, keys );
+            }
+            catch ( const DBException& e ) {
+                *result = e.toStatus();
+            }
+            catch ( const std::exception& e ) {
+                *result = Status( ErrorCodes::InternalError, e.what() );
+            }
+            batch->taskDone();
+        }
+
     }
 
     Status IndexCatalog::_indexRecord(OperationContext* txn,
@@ -1119,6 +1216,10 @@ namespace {
                                    const BSONObj& obj,
                                    const RecordId &loc ) {
 
+        if ( internalIndexKeyGenerationThreads > 0 && _entries.size() > 1 ) {
+            return _indexRecordParallel( txn, obj, loc );
+        }
+
         for ( IndexCatalogEntryContainer::const_iterator i = _entries.begin();
               i != _entries.end();
               ++i ) {
@@ -1130,6 +1231,78 @@ namespace {
         return Status::OK();
     }
 
+    Status IndexCatalog::_indexRecordParallel(OperationContext* txn,
+                                              const BSONObj& obj,
+                                              const RecordId &loc ) {
+
+        std::vector<IndexCatalogEntry*> entries( _entries.begin(), _entries.end() );
+        const size_t numEntries = entries.size();
+
+        std::vector<BSONObjSet> keys( numEntries );
+        std::vector<Status> results( numEntries, Status::OK() );
+
+        // Key generation for non-unique indexes has no ordering requirements and is
+        // offloaded; unique indexes (including _id) stay on the writer thread.
+        std::vector<bool> offloaded( numEntries, false );
+        int numOffloaded = 0;
+        for ( size_t i = 0; i < numEntries; i++ ) {
+            if ( !entries[i]->descriptor()->unique() ) {
+                offloaded[i] = true;
+                numOffloaded++;
+            }
+        }
+
+        threadpool::ThreadPool* pool = getKeyGenPool( internalIndexKeyGenerationThreads );
+
+        KeyGenerationBatch batch( numOffloaded );
+        for ( size_t i = 0; i < numEntries; i++ ) {
+            if ( !offloaded[i] )
+                continue;
+            BtreeBasedAccessMethod* iam =
+                static_cast<BtreeBasedAccessMethod*>( entries[i]->accessMethod() );
+            pool->schedule( generateKeysTask, iam, &obj, &keys[i], &results[i], &batch );
+        }
+
+        // Generate the remaining keys here while the workers run, then join before
+        // touching any btree; a failure must not leave half the tasks still writing
+        // into our stack frame.
+        try {
+            for ( size_t i = 0; i < numEntries; i++ ) {
+                if ( offloaded[i] )
+                    continue;
+                BtreeBasedAccessMethod* iam =
+                    static_cast<BtreeBasedAccessMethod*>( entries[i]->accessMethod() );
+                iam->computeKeys( obj, &keys[i] );
+            }
+        }
+        catch ( ... ) {
+            batch.wait();
+            throw;
+        }
+
+        batch.wait();
+
+        for ( size_t i = 0; i < numEntries; i++ ) {
+            if ( !results[i].isOK() )
+                return results[i];
+        }
+
+        for ( size_t i = 0; i < numEntries; i++ ) {
+            InsertDeleteOptions options;
+            options.logIfError = false;
+            options.dupsAllowed = isDupsAllowed( entries[i]->descriptor() );
+
+            BtreeBasedAccessMethod* iam =
+                static_cast<BtreeBasedAccessMethod*>( entries[i]->accessMethod() );
+            int64_t inserted;
+            Status s = iam->insertPrecomputedKeys( txn, keys[i], loc, options, &inserted );
+            if ( !s.isOK() )
+                return s;
+        }
+
+        return Status::OK();
+    }
+
     void IndexCatalog::unindexRecord(OperationContext* txn,
                                      const BSONObj& obj,
                                      const RecordId& loc,
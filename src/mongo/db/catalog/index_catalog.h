@@ -328,6 +328,14 @@ namespace mongo {
                             const BSONObj& obj,
                             const RecordId &loc );
 
+        /**
+         * As the indexRecord() loop, but offloads key generation for non-unique indexes to a
+         * worker pool and joins before performing any btree insertions.
+         */
+        Status _indexRecordParallel(OperationContext* txn,
+                                    const BSONObj& obj,
+                                    const RecordId &loc );
+
         Status _unindexRecord(OperationContext* txn,
                               IndexCatalogEntry* index,
                               const BSONObj& obj,
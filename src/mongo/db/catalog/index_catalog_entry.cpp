@@ -40,6 +40,8 @@
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/global_environment_experiment.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/util/file_allocator.h"
 #include "mongo/util/log.h"
@@ -79,6 +81,14 @@ namespace mongo {
           _isReady( false ) {
 
         _descriptor->_cachedEntry = this;
+
+        if ( _descriptor->isPartial() ) {
+            // The filter was validated when the index was created.
+            StatusWithMatchExpression res =
+                MatchExpressionParser::parse( _descriptor->partialFilterExpression() );
+            invariant( res.isOK() );
+            _filterExpression.reset( res.getValue() );
+        }
     }
 
     IndexCatalogEntry::~IndexCatalogEntry() {
@@ -32,6 +32,8 @@
 
 #include <string>
 
+#include <boost/scoped_ptr.hpp>
+
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/ordering.h"
 #include "mongo/db/record_id.h"
@@ -43,6 +45,7 @@ namespace mongo {
     class HeadManager;
     class IndexAccessMethod;
     class IndexDescriptor;
+    class MatchExpression;
     class OperationContext;
 
     class IndexCatalogEntry {
@@ -68,6 +71,12 @@ namespace mongo {
 
         const Ordering& ordering() const { return _ordering; }
 
+        /**
+         * Returns the filter expression of a partial index, or NULL if the index is not
+         * partial.  The returned expression is owned here.
+         */
+        const MatchExpression* getFilterExpression() const { return _filterExpression.get(); }
+
         /// ---------------------
 
         const RecordId& head( OperationContext* txn ) const;
@@ -111,6 +120,9 @@ namespace mongo {
         // Owned here.
         HeadManager* _headManager;
 
+        // The filter expression of a partial index, or NULL.  Owned here.
+        boost::scoped_ptr<MatchExpression> _filterExpression;
+
         // cached stuff
 
         Ordering _ordering; // TODO: this might be b-tree specific
@@ -34,10 +34,15 @@
 
 #include "mongo/db/catalog/index_create.h"
 
+#include <deque>
+
 #include <boost/make_shared.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
 
 #include "mongo/base/error_codes.h"
+#include "mongo/base/owned_pointer_vector.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/audit.h"
 #include "mongo/db/background.h"
@@ -48,6 +53,8 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/background.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/progress_meter.h"
@@ -56,6 +63,138 @@ namespace mongo {
 
     using boost::scoped_ptr;
 
+    // When building more than one index in the foreground, generate keys and sort for all
+    // indexes on worker threads fed by a single collection scan.
+    MONGO_EXPORT_SERVER_PARAMETER(useParallelIndexBuild, bool, true);
+
+    namespace {
+
+        // Documents are handed to the index build workers in batches; a batch is flushed
+        // once it holds this many documents or this many bytes, and each worker's queue
+        // holds at most kIndexBuildMaxQueuedBatches before the collection scan waits.
+        const size_t kIndexBuildBatchDocs = 1000;
+        const size_t kIndexBuildBatchBytes = 1024 * 1024;
+        const size_t kIndexBuildMaxQueuedBatches = 2;
+
+        typedef std::vector< std::pair<BSONObj, RecordId> > IndexBuildBatch;
+        typedef boost::shared_ptr<const IndexBuildBatch> SharedIndexBuildBatch;
+
+        /**
+         * Generates keys and feeds the external sorter for one index on its own thread,
+         * consuming document batches queued by the collection scan. Only this thread
+         * touches the index's bulk access method between go() and finish(), and the bulk
+         * access method never touches storage while being fed, so no OperationContext is
+         * needed here.
+         */
+        class IndexBulkFeeder : public BackgroundJob {
+        public:
+            IndexBulkFeeder(IndexAccessMethod* bulk, const InsertDeleteOptions& options)
+                : BackgroundJob(false /* selfDelete */),
+                  _bulk(bulk),
+                  _options(options),
+                  _done(false),
+                  _status(Status::OK()) {
+            }
+
+            virtual std::string name() const { return "IndexBulkFeeder"; }
+
+            /**
+             * Queues a batch for this feeder, waiting while its queue is full. Returns
+             * false if the feeder has failed and is discarding work; the error itself
+             * comes back from finish().
+             */
+            bool push(const SharedIndexBuildBatch& batch) {
+                boost::mutex::scoped_lock lk(_mutex);
+                while (_queue.size() >= kIndexBuildMaxQueuedBatches && _status.isOK()) {
+                    _queueHasRoom.wait(lk);
+                }
+                if (!_status.isOK())
+                    return false;
+                _queue.push_back(batch);
+                _queueHasWork.notify_one();
+                return true;
+            }
+
+            /**
+             * Signals that no more batches are coming, drains the queue, and joins the
+             * thread. Returns the first error the feeder hit, if any.
+             */
+            Status finish() {
+                {
+                    boost::mutex::scoped_lock lk(_mutex);
+                    _done = true;
+                    _queueHasWork.notify_one();
+                }
+                wait();
+                return _status; // no lock needed; the thread is gone
+            }
+
+        private:
+            virtual void run() {
+                while (true) {
+                    SharedIndexBuildBatch batch;
+                    {
+                        boost::mutex::scoped_lock lk(_mutex);
+                        while (_queue.empty() && !_done) {
+                            _queueHasWork.wait(lk);
+                        }
+                        if (_queue.empty())
+                            return;
+                        batch = _queue.front();
+                        _queue.pop_front();
+                        _queueHasRoom.notify_one();
+                    }
+
+                    Status status = _insertBatch(*batch);
+                    if (!status.isOK()) {
+                        boost::mutex::scoped_lock lk(_mutex);
+                        _status = status;
+                        _queue.clear();
+                        // The producer may be blocked on a full queue; let it see the
+                        // failure rather than the room.
+                        _queueHasRoom.notify_one();
+                        return;
+                    }
+                }
+            }
+
+            Status _insertBatch(const IndexBuildBatch& batch) {
+                try {
+                    for (size_t i = 0; i < batch.size(); i++) {
+                        int64_t unused;
+                        // The bulk access method ignores the OperationContext; it only
+                        // generates keys and adds them to its sorter.
+                        Status status = _bulk->insert(NULL,
+                                                      batch[i].first,
+                                                      batch[i].second,
+                                                      _options,
+                                                      &unused);
+                        if (!status.isOK())
+                            return status;
+                    }
+                    return Status::OK();
+                }
+                catch (const DBException& e) {
+                    return e.toStatus();
+                }
+                catch (const std::exception& e) {
+                    return Status(ErrorCodes::InternalError, e.what());
+                }
+            }
+
+            IndexAccessMethod* const _bulk; // not owned
+            const InsertDeleteOptions _options;
+
+            boost::mutex _mutex; // protects everything below
+            boost::condition _queueHasWork;
+            boost::condition _queueHasRoom;
+            std::deque<SharedIndexBuildBatch> _queue;
+            bool _done;
+            Status _status;
+        };
+
+    } // namespace
+
     /**
      * On rollback sets MultiIndexBlock::_needToCleanup to true.
      */
@@ -209,6 +348,12 @@ namespace mongo {
     }
 
     Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsOut) {
+        // Foreground multi-index builds can share one collection scan across per-index
+        // worker threads; everything else feeds the indexes from this thread.
+        if (useParallelIndexBuild && !_buildInBackground && _indexes.size() > 1) {
+            return _insertAllDocumentsParallel(dupsOut);
+        }
+
         const char* curopMessage = _buildInBackground ? "Index Build (background)" : "Index Build";
         ProgressMeterHolder progress(*_txn->setMessage(curopMessage,
                                                        curopMessage,
@@ -276,6 +421,113 @@ namespace mongo {
         return Status::OK();
     }
 
+    Status MultiIndexBlock::_insertAllDocumentsParallel(std::set<RecordId>* dupsOut) {
+        // One worker per index generates keys and feeds that index's external sorter, so
+        // adding indexes to the build adds (almost) no time to the collection scan. The
+        // sorted btree loads in doneInserting() still run one after another on this
+        // thread: they write through this thread's OperationContext and locks, which
+        // cannot be shared with the workers.
+        const char* curopMessage = "Index Build";
+        ProgressMeterHolder progress(*_txn->setMessage(curopMessage,
+                                                       curopMessage,
+                                                       _collection->numRecords(_txn)));
+
+        Timer t;
+
+        log() << "building " << _indexes.size() << " indexes in parallel from one scan";
+
+        OwnedPointerVector<IndexBulkFeeder> feeders;
+        for (size_t i = 0; i < _indexes.size(); i++) {
+            invariant(_indexes[i].bulk); // guaranteed by the foreground-only caller
+            feeders.push_back(new IndexBulkFeeder(_indexes[i].bulk.get(),
+                                                  _indexes[i].options));
+        }
+        for (size_t i = 0; i < feeders.size(); i++) {
+            feeders[i]->go();
+        }
+
+        unsigned long long n = 0;
+        PlanExecutor::ExecState state = PlanExecutor::IS_EOF;
+
+        try {
+            scoped_ptr<PlanExecutor> exec(InternalPlanner::collectionScan(_txn,
+                                                                          _collection->ns().ns(),
+                                                                          _collection));
+
+            boost::shared_ptr<IndexBuildBatch> batch =
+                boost::make_shared<IndexBuildBatch>();
+            size_t batchBytes = 0;
+            bool feederFailed = false;
+
+            BSONObj objToIndex;
+            RecordId loc;
+            while (PlanExecutor::ADVANCED == (state = exec->getNext(&objToIndex, &loc))) {
+                if (_allowInterruption)
+                    _txn->checkForInterrupt();
+
+                // The scan may hand back a view into the collection's own memory, so own
+                // the document before another thread reads it after we have moved on.
+                batch->push_back(std::make_pair(objToIndex.getOwned(), loc));
+                batchBytes += objToIndex.objsize();
+
+                if (batch->size() >= kIndexBuildBatchDocs ||
+                    batchBytes >= kIndexBuildBatchBytes) {
+                    for (size_t i = 0; i < feeders.size(); i++) {
+                        if (!feeders[i]->push(batch))
+                            feederFailed = true;
+                    }
+                    if (feederFailed)
+                        break; // the error surfaces from finish() below
+                    batch = boost::make_shared<IndexBuildBatch>();
+                    batchBytes = 0;
+                }
+
+                n++;
+                progress->hit();
+
+                progress->setTotalWhileRunning( _collection->numRecords(_txn) );
+            }
+
+            if (!feederFailed && !batch->empty()) {
+                for (size_t i = 0; i < feeders.size(); i++) {
+                    feeders[i]->push(batch);
+                }
+            }
+        }
+        catch (...) {
+            // Workers reference the feeders and batches; join them before unwinding.
+            for (size_t i = 0; i < feeders.size(); i++) {
+                feeders[i]->finish();
+            }
+            throw;
+        }
+
+        Status feedStatus = Status::OK();
+        for (size_t i = 0; i < feeders.size(); i++) {
+            Status status = feeders[i]->finish();
+            if (feedStatus.isOK() && !status.isOK())
+                feedStatus = status;
+        }
+        if (!feedStatus.isOK())
+            return feedStatus;
+
+        if (state != PlanExecutor::IS_EOF) {
+            uasserted(28612,
+                      "Unable to complete index build as the collection is no longer readable");
+        }
+
+        progress->finished();
+
+        Status ret = doneInserting(dupsOut);
+        if (!ret.isOK())
+            return ret;
+
+        log() << "build index done.  scanned " << n << " total records. "
+              << t.seconds() << " secs" << endl;
+
+        return Status::OK();
+    }
+
     Status MultiIndexBlock::insert(const BSONObj& doc, const RecordId& loc) {
         for ( size_t i = 0; i < _indexes.size(); i++ ) {
             int64_t unused;
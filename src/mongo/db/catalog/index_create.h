@@ -198,6 +198,13 @@ namespace mongo {
     private:
         class SetNeedToCleanupOnRollback;
 
+        /**
+         * The multi-index fast path of insertAllDocumentsInCollection(): one collection
+         * scan feeds per-index worker threads that generate keys and sort concurrently.
+         * Only used for foreground builds, where every index has a bulk builder.
+         */
+        Status _insertAllDocumentsParallel(std::set<RecordId>* dupsOut);
+
         struct IndexToBuild {
             IndexToBuild() : real(NULL) {}
 
@@ -125,6 +125,7 @@ namespace {
           _desc(desc),
           _threadId(boost::this_thread::get_id()),
           _connectionId(p ? p->connectionId() : 0),
+          _lock("Client"),
           _god(0),
           _txn(NULL),
           _locker(newLocker()),
@@ -439,6 +440,7 @@ namespace {
         exceptionInfo.reset();
         
         executionTime = 0;
+        lockWaitMicros = -1;
         nreturned = -1;
         responseLength = -1;
     }
@@ -516,6 +518,7 @@ namespace {
         s << " numYields:" << curop.numYields() << " ";
         
         OPDEBUG_TOSTRING_HELP( nreturned );
+        OPDEBUG_TOSTRING_HELP( lockWaitMicros );
         if ( responseLength > 0 )
             s << " reslen:" << responseLength;
         s << " " << executionTime << "ms";
@@ -606,6 +609,7 @@ namespace {
             exceptionInfo.append( b , "exception" , "exceptionCode" );
 
         OPDEBUG_APPEND_NUMBER( nreturned );
+        OPDEBUG_APPEND_NUMBER( lockWaitMicros );
         OPDEBUG_APPEND_NUMBER( responseLength );
         b.append( "millis" , executionTime );
 
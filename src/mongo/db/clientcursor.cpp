@@ -47,6 +47,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context_impl.h"
+#include "mongo/db/query/find_constants.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
 #include "mongo/util/exit.h"
 
@@ -109,6 +110,8 @@ namespace mongo {
         _idleAgeMillis = 0;
         _leftoverMaxTimeMicros = 0;
         _pos = 0;
+        _batchByteTarget = 1024 * 1024;
+        _lastGetMoreMicros = 0;
 
         if (_queryOptions & QueryOption_NoCursorTimeout) {
             // cursors normally timeout after an inactivity period to prevent excess memory use
@@ -174,6 +177,28 @@ namespace mongo {
         _idleAgeMillis = millis;
     }
 
+    int ClientCursor::nextBatchByteTarget() {
+        // A client that turns the next getMore around within this gap is blocked on us;
+        // one that takes longer than a second is reading slower than we can fill.
+        const unsigned long long kFastConsumerGapMicros = 50 * 1000;
+        const unsigned long long kSlowConsumerGapMicros = 1000 * 1000;
+        const int kMinBatchBytes = 128 * 1024;
+
+        const unsigned long long now = curTimeMicros64();
+        if (_lastGetMoreMicros != 0) {
+            const unsigned long long gap = now - _lastGetMoreMicros;
+            if (gap < kFastConsumerGapMicros) {
+                _batchByteTarget = std::min(2 * _batchByteTarget,
+                                            MaxBytesToReturnToClientAtOnce);
+            }
+            else if (gap > kSlowConsumerGapMicros) {
+                _batchByteTarget = std::max(_batchByteTarget / 2, kMinBatchBytes);
+            }
+        }
+        _lastGetMoreMicros = now;
+        return _batchByteTarget;
+    }
+
     void ClientCursor::updateSlaveLocation(OperationContext* txn, CurOp& curop) {
         if (_slaveReadTill.isNull())
             return;
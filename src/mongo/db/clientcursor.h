@@ -155,6 +155,15 @@ namespace mongo {
         void incPos(int n) { _pos += n; }
         void setPos(int n) { _pos = n; }
 
+        /**
+         * Returns the byte budget getMore should target for the next batch, and updates
+         * the cursor's estimate of how quickly its client consumes batches. The budget
+         * ramps up toward MaxBytesToReturnToClientAtOnce for clients that issue the next
+         * getMore promptly, and back down for trickle readers so we don't scan and buffer
+         * megabytes the client won't ask for any time soon.
+         */
+        int nextBatchByteTarget();
+
         static long long totalOpen();
 
         //
@@ -231,6 +240,14 @@ namespace mongo {
         // How many objects have been returned by the find() so far?
         int _pos;
 
+        // Byte budget targeted by getMore when the client doesn't dictate a batch size,
+        // adapted to the observed consumption rate (see nextBatchByteTarget()).
+        int _batchByteTarget;
+
+        // When the previous getMore on this cursor arrived, for adapting the budget.
+        // Zero until the first getMore.
+        unsigned long long _lastGetMoreMicros;
+
         // The query that prompted this ClientCursor.  Only used for debugging.
         BSONObj _query;
 
@@ -0,0 +1,480 @@
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects
+*    for all of the code used other than as permitted herein. If you modify
+*    file(s) with this exception, you may extend this exception to your
+*    version of the file(s), but you are not obligated to do so. If you do not
+*    wish to do so, delete this exception statement from your version. If you
+*    delete this exception statement from all source files in the program,
+*    then also delete it in the license file.
+*/
+
+#define MONGO_PCH_WHITELISTED
+#include "mongo/platform/basic.h"
+#include "mongo/pch.h"
+#undef MONGO_PCH_WHITELISTED
+
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/auth/resource_pattern.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/storage_options.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    using boost::intrusive_ptr;
+
+namespace {
+
+    // Per-database collection holding one definition document per aggregation view:
+    //   { _id: <view collection>, source: <collection>, pipeline: [...],
+    //     lastOptime: <oplog position the view is current to> }
+    const char viewsCollection[] = "system.aggviews";
+
+    // Accumulators whose deltas can be folded into an existing group with an update
+    // operator; $avg and the positional accumulators cannot be maintained this way.
+    bool isAdditiveAccumulator(const char* op) {
+        return str::equals(op, "$sum")
+            || str::equals(op, "$min")
+            || str::equals(op, "$max")
+            || str::equals(op, "$addToSet");
+    }
+
+    /**
+     * Verifies that a view's pipeline can be maintained incrementally: zero or more
+     * per-document stages ($match, $project, $unwind) followed by a single terminal
+     * $group whose accumulators are all additive. Returns the $group specification.
+     */
+    BSONObj validateViewPipeline(const vector<BSONElement>& stages) {
+        uassert(28629, "an aggregation view's pipeline must end in a $group stage",
+                !stages.empty());
+
+        for (size_t i = 0; i < stages.size(); i++) {
+            uassert(28630, "every stage of an aggregation view's pipeline must be an object",
+                    stages[i].type() == Object);
+            uassert(28631, "every pipeline stage must have exactly one field",
+                    stages[i].Obj().nFields() == 1);
+        }
+
+        for (size_t i = 0; i + 1 < stages.size(); i++) {
+            const char* name = stages[i].Obj().firstElement().fieldName();
+            uassert(28632, str::stream() << name << " cannot be used in an aggregation"
+                    " view; only $match, $project and $unwind may precede the terminal"
+                    " $group",
+                    str::equals(name, "$match")
+                        || str::equals(name, "$project")
+                        || str::equals(name, "$unwind"));
+        }
+
+        const BSONElement last = stages.back().Obj().firstElement();
+        uassert(28633, "an aggregation view's pipeline must end in a $group stage",
+                str::equals(last.fieldName(), "$group") && last.type() == Object);
+
+        const BSONObj groupSpec = last.Obj();
+        BSONForEach(field, groupSpec) {
+            if (str::equals(field.fieldName(), "_id"))
+                continue;
+
+            uassert(28634, str::stream() << "the accumulator for '" << field.fieldName()
+                    << "' must be additive ($sum, $min, $max or $addToSet) to maintain"
+                    " the view incrementally",
+                    field.type() == Object
+                        && field.Obj().nFields() == 1
+                        && isAdditiveAccumulator(field.Obj().firstElement().fieldName()));
+        }
+
+        return groupSpec.getOwned();
+    }
+
+    /**
+     * Returns the optime of the newest entry in the local oplog and sets *oplogNs to the
+     * oplog's namespace. Asserts if the server has no oplog.
+     */
+    OpTime lastOplogTime(DBDirectClient* client, string* oplogNs) {
+        *oplogNs = repl::rsoplog;
+        BSONObj last = client->findOne(*oplogNs, Query().sort(BSON("$natural" << -1)));
+        if (last.isEmpty()) {
+            *oplogNs = "local.oplog.$main";
+            last = client->findOne(*oplogNs, Query().sort(BSON("$natural" << -1)));
+        }
+
+        uassert(28620, "aggregation views require an oplog; start the server with"
+                       " --replSet or --master",
+                !last.isEmpty());
+        return last["ts"]._opTime();
+    }
+
+    Status checkAuthForViewCommand(ClientBasic* client,
+                                   const std::string& dbname,
+                                   const std::string& viewName,
+                                   const std::string& source) {
+        AuthorizationSession* authSession = client->getAuthorizationSession();
+
+        ActionSet viewActions;
+        viewActions.addAction(ActionType::find);
+        viewActions.addAction(ActionType::insert);
+        viewActions.addAction(ActionType::update);
+        viewActions.addAction(ActionType::remove);
+        viewActions.addAction(ActionType::dropCollection);
+
+        if (!authSession->isAuthorizedForActionsOnResource(
+                ResourcePattern::forExactNamespace(NamespaceString(dbname, viewName)),
+                viewActions)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+
+        if (!source.empty()
+                && !authSession->isAuthorizedForActionsOnResource(
+                       ResourcePattern::forExactNamespace(NamespaceString(dbname, source)),
+                       ActionType::find)) {
+            return Status(ErrorCodes::Unauthorized, "Unauthorized");
+        }
+
+        return Status::OK();
+    }
+
+} // namespace
+
+    /**
+     * { createAggregationView: <view collection>, source: <collection>, pipeline: [...] }
+     *
+     * Materializes the result of running the pipeline over the source collection into
+     * the view collection, and records the pipeline plus the current oplog position so
+     * refreshAggregationView can later fold in newer documents without rescanning.
+     */
+    class CmdCreateAggregationView : public Command {
+    public:
+        CmdCreateAggregationView() : Command("createAggregationView") {}
+
+        virtual bool slaveOk() const { return false; }
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+
+        virtual void help(stringstream& help) const {
+            help << "{ createAggregationView: <view collection>, source: <collection>"
+                    ", pipeline: [...] }\n"
+                    "Materializes the pipeline's result and records the current oplog "
+                    "position; refreshAggregationView folds in documents inserted later.";
+        }
+
+        virtual Status checkAuthForCommand(ClientBasic* client,
+                                           const std::string& dbname,
+                                           const BSONObj& cmdObj) {
+            return checkAuthForViewCommand(client,
+                                           dbname,
+                                           cmdObj.firstElement().str(),
+                                           cmdObj["source"].str());
+        }
+
+        virtual bool run(OperationContext* txn, const string& dbname, BSONObj& cmdObj,
+                         int, string& errmsg, BSONObjBuilder& result, bool) {
+            const string viewName = cmdObj.firstElement().str();
+            const string source = cmdObj["source"].str();
+            uassert(28621, "createAggregationView requires a view collection name",
+                    !viewName.empty());
+            uassert(28622, "createAggregationView requires a string 'source' collection",
+                    !source.empty());
+            uassert(28623, "'pipeline' must be an array",
+                    cmdObj["pipeline"].type() == Array);
+
+            validateViewPipeline(cmdObj["pipeline"].Array());
+
+            DBDirectClient client(txn);
+
+            string oplogNs;
+            OpTime startOptime;
+            BSONObj aggResult;
+            {
+                // Capture the oplog position and materialize the full result while
+                // holding the database exclusively, so nothing can be inserted into
+                // the source mid-scan. Everything the aggregation observes then has
+                // ts <= startOptime, and the first refresh applies only documents
+                // the scan could not have seen.
+                ScopedTransaction transaction(txn, MODE_IX);
+                Lock::DBLock dbXLock(txn->lockState(), dbname, MODE_X);
+
+                startOptime = lastOplogTime(&client, &oplogNs);
+
+                BSONObjBuilder aggCmd;
+                aggCmd.append("aggregate", source);
+                aggCmd.appendAs(cmdObj["pipeline"], "pipeline");
+                aggCmd.append("allowDiskUse", true);
+
+                const bool ok = client.runCommand(dbname, aggCmd.obj(), aggResult);
+                uassert(28624, str::stream() << "initial aggregation failed: "
+                        << aggResult,
+                        ok);
+            }
+
+            const string viewNs = dbname + "." + viewName;
+            client.dropCollection(viewNs);
+
+            long long numDocs = 0;
+            BSONForEach(doc, aggResult["result"].Obj()) {
+                client.insert(viewNs, doc.Obj());
+                numDocs++;
+            }
+
+            // upsert the definition so an existing view can be rebuilt in place
+            BSONObjBuilder def;
+            def.append("_id", viewName);
+            def.append("source", source);
+            def.append(cmdObj["pipeline"]);
+            def.appendTimestamp("lastOptime", startOptime.asDate());
+            client.update(dbname + "." + viewsCollection,
+                          BSON("_id" << viewName),
+                          def.obj(),
+                          true /*upsert*/,
+                          false /*multi*/);
+
+            result.appendNumber("documents", numDocs);
+            return true;
+        }
+    } cmdCreateAggregationView;
+
+    /**
+     * { refreshAggregationView: <view collection> }
+     *
+     * Reads the source collection's inserts from the oplog since the view's recorded
+     * optime, runs the view's pipeline over just those documents, and folds the
+     * resulting groups into the materialized collection with additive update operators
+     * ($inc, $min, $max, $addToSet). Updates or deletes on the source make the deltas
+     * unmergeable and require recreating the view.
+     */
+    class CmdRefreshAggregationView : public Command {
+    public:
+        CmdRefreshAggregationView() : Command("refreshAggregationView") {}
+
+        virtual bool slaveOk() const { return false; }
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+
+        virtual void help(stringstream& help) const {
+            help << "{ refreshAggregationView: <view collection> }\n"
+                    "Folds documents inserted into the source since the last refresh "
+                    "into the materialized result created by createAggregationView.";
+        }
+
+        virtual Status checkAuthForCommand(ClientBasic* client,
+                                           const std::string& dbname,
+                                           const BSONObj& cmdObj) {
+            // The source isn't named in the command; reading it happened at create time
+            // and refresh only reads the oplog, so authorize against the view alone.
+            return checkAuthForViewCommand(client,
+                                           dbname,
+                                           cmdObj.firstElement().str(),
+                                           string());
+        }
+
+        virtual bool run(OperationContext* txn, const string& dbname, BSONObj& cmdObj,
+                         int, string& errmsg, BSONObjBuilder& result, bool) {
+            const string viewName = cmdObj.firstElement().str();
+            uassert(28625, "refreshAggregationView requires a view collection name",
+                    !viewName.empty());
+
+            DBDirectClient client(txn);
+
+            const string defNs = dbname + "." + viewsCollection;
+            const BSONObj def = client.findOne(defNs, BSON("_id" << viewName));
+            uassert(28626, str::stream() << "no aggregation view named '" << viewName
+                    << "'; create one with createAggregationView",
+                    !def.isEmpty());
+
+            const string sourceNs = dbname + "." + def["source"].str();
+            const OpTime lastOptime = def["lastOptime"]._opTime();
+
+            string oplogNs;
+            const OpTime newOptime = lastOplogTime(&client, &oplogNs);
+
+            // Collect the documents inserted into the source since the last refresh.
+            // The scan is bounded above by newOptime so that inserts landing while it
+            // runs are left for the next refresh rather than applied both now and
+            // then. Updates and deletes can't be folded into additive accumulators,
+            // so they force a rebuild.
+            BSONArrayBuilder deltas;
+            long long numDeltas = 0;
+            {
+                BSONObjBuilder query;
+                query.append("ns", sourceNs);
+                {
+                    BSONObjBuilder ts(query.subobjStart("ts"));
+                    ts.appendTimestamp("$gt", lastOptime.asDate());
+                    ts.appendTimestamp("$lte", newOptime.asDate());
+                    ts.done();
+                }
+
+                auto_ptr<DBClientCursor> cursor = client.query(oplogNs, query.obj());
+                while (cursor->more()) {
+                    BSONObj entry = cursor->next();
+                    const char* op = entry["op"].valuestrsafe();
+                    if (str::equals(op, "n"))
+                        continue;
+
+                    uassert(28627, str::stream() << "aggregation view '" << viewName
+                            << "' saw a '" << op << "' operation on " << sourceNs
+                            << "; only inserts can be applied incrementally - rerun"
+                            " createAggregationView",
+                            str::equals(op, "i"));
+
+                    deltas.append(entry["o"].Obj());
+                    numDeltas++;
+                }
+            }
+
+            long long numGroups = 0;
+            if (numDeltas > 0)
+                numGroups = applyDeltas(txn, &client, dbname, def, deltas.arr());
+
+            // Advance the recorded optime even when nothing changed so the next
+            // refresh's oplog scan starts where this one stopped.
+            {
+                BSONObjBuilder update;
+                {
+                    BSONObjBuilder set(update.subobjStart("$set"));
+                    set.appendTimestamp("lastOptime", newOptime.asDate());
+                    set.done();
+                }
+                client.update(defNs, BSON("_id" << viewName), update.obj());
+            }
+
+            result.appendNumber("documents", numDeltas);
+            result.appendNumber("groups", numGroups);
+            return true;
+        }
+
+    private:
+        /**
+         * Runs the view's pipeline over just the delta documents and folds each
+         * resulting group into the materialized collection. Returns the number of
+         * groups touched.
+         */
+        static long long applyDeltas(OperationContext* txn,
+                                     DBDirectClient* client,
+                                     const string& dbname,
+                                     const BSONObj& def,
+                                     const BSONArray& deltas) {
+            // re-check the stored pipeline; the definition could have been edited by hand
+            const BSONObj groupSpec = validateViewPipeline(def["pipeline"].Array());
+
+            const string source = def["source"].str();
+
+            BSONObjBuilder aggCmd;
+            aggCmd.append("aggregate", source);
+            aggCmd.appendAs(def["pipeline"], "pipeline");
+            const BSONObj cmdObj = aggCmd.obj();
+
+            intrusive_ptr<ExpressionContext> expCtx =
+                new ExpressionContext(txn, NamespaceString(dbname + "." + source));
+            expCtx->tempDir = storageGlobalParams.dbpath + "/_tmp";
+
+            string errmsg;
+            intrusive_ptr<Pipeline> pipeline =
+                Pipeline::parseCommand(errmsg, cmdObj, expCtx);
+            uassert(28628, str::stream() << "failed to reparse the pipeline of"
+                    " aggregation view '" << def["_id"].str() << "': " << errmsg,
+                    pipeline.get());
+
+            pipeline->addInitialSource(DocumentSourceBsonArray::create(deltas, expCtx));
+            pipeline->stitch();
+
+            BSONObjBuilder deltaResult;
+            pipeline->run(deltaResult);
+            const BSONObj deltaGroups = deltaResult.obj();
+
+            const string viewNs = dbname + "." + def["_id"].str();
+            long long numGroups = 0;
+            BSONForEach(groupElem, deltaGroups["result"].Obj()) {
+                const BSONObj group = groupElem.Obj();
+
+                BSONObjBuilder query;
+                query.appendAs(group["_id"], "_id");
+                const BSONObj queryObj = query.obj();
+
+                BSONObjBuilder inc;
+                BSONObjBuilder min;
+                BSONObjBuilder max;
+                BSONObjBuilder addToSet;
+                BSONForEach(field, groupSpec) {
+                    if (str::equals(field.fieldName(), "_id"))
+                        continue;
+
+                    const BSONElement value = group[field.fieldName()];
+                    if (value.eoo())
+                        continue;
+
+                    const char* op = field.Obj().firstElement().fieldName();
+                    if (str::equals(op, "$sum")) {
+                        inc.append(value);
+                    }
+                    else if (str::equals(op, "$min")) {
+                        min.append(value);
+                    }
+                    else if (str::equals(op, "$max")) {
+                        max.append(value);
+                    }
+                    else {
+                        dassert(str::equals(op, "$addToSet"));
+                        BSONObjBuilder each(
+                                addToSet.subobjStart(field.fieldNameStringData()));
+                        each.appendAs(value, "$each");
+                        each.done();
+                    }
+                }
+
+                BSONObjBuilder update;
+                const BSONObj incObj = inc.obj();
+                const BSONObj minObj = min.obj();
+                const BSONObj maxObj = max.obj();
+                const BSONObj addToSetObj = addToSet.obj();
+                if (!incObj.isEmpty())
+                    update.append("$inc", incObj);
+                if (!minObj.isEmpty())
+                    update.append("$min", minObj);
+                if (!maxObj.isEmpty())
+                    update.append("$max", maxObj);
+                if (!addToSetObj.isEmpty())
+                    update.append("$addToSet", addToSetObj);
+                const BSONObj updateObj = update.obj();
+
+                if (updateObj.isEmpty()) {
+                    // a group with no accumulators is just its _id
+                    client->update(viewNs, queryObj, queryObj, true /*upsert*/);
+                }
+                else {
+                    client->update(viewNs, queryObj, updateObj, true /*upsert*/);
+                }
+                numGroups++;
+            }
+
+            return numGroups;
+        }
+    } cmdRefreshAggregationView;
+
+} // namespace mongo
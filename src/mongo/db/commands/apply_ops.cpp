@@ -42,6 +42,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/operation_context_impl.h"
+#include "mongo/db/prefetch.h"
 #include "mongo/db/repl/oplog.h"
 
 namespace mongo {
@@ -111,21 +112,37 @@ namespace mongo {
             // apply
             int num = 0;
             int errors = 0;
-            
-            BSONObjIterator i( ops );
+
             BSONArrayBuilder ab;
             const bool alwaysUpsert = cmdObj.hasField("alwaysUpsert") ?
                     cmdObj["alwaysUpsert"].trueValue() : true;
-            
-            while ( i.more() ) {
-                BSONElement e = i.next();
-                const BSONObj& temp = e.Obj();
 
-                // Ignore 'n' operations.
-                const char *opType = temp["op"].valuestrsafe();
-                if (*opType == 'n') continue;
+            // Ignore 'n' operations.
+            vector<BSONObj> opsToApply;
+            {
+                BSONObjIterator i( ops );
+                while ( i.more() ) {
+                    const BSONObj& temp = i.next().Obj();
+                    if (*temp["op"].valuestrsafe() != 'n') {
+                        opsToApply.push_back(temp);
+                    }
+                }
+            }
 
-                string ns = temp["ns"].String();
+            // Apply consecutive operations on the same namespace as one group, so a
+            // batch pays for one lock acquisition and context per namespace run rather
+            // than per op, and so the group's index and document pages can be paged in
+            // together up front.  Only adjacent ops are grouped, which preserves the
+            // order the caller asked for.
+            size_t opIndex = 0;
+            while ( opIndex < opsToApply.size() ) {
+                const string ns = opsToApply[opIndex]["ns"].String();
+
+                size_t endIndex = opIndex + 1;
+                while ( endIndex < opsToApply.size() &&
+                        opsToApply[endIndex]["ns"].String() == ns ) {
+                    endIndex++;
+                }
 
                 // Run operations under a nested lock as a hack to prevent yielding.
                 //
@@ -148,18 +165,32 @@ namespace mongo {
                 };
 
                 Client::Context ctx(txn, ns);
-                bool failed = repl::applyOperation_inlock(txn,
-                                                          ctx.db(),
-                                                          temp,
-                                                          false,
-                                                          alwaysUpsert);
-                ab.append(!failed);
-                if ( failed )
-                    errors++;
 
-                num++;
+                // Page in the index and document pages the whole group will touch before
+                // applying any of it, so the applies do not stall on one fault at a
+                // time.  A group of one gets no overlap and skips the extra pass.
+                if ( endIndex - opIndex > 1 ) {
+                    for ( size_t j = opIndex; j < endIndex; j++ ) {
+                        repl::prefetchPagesForReplicatedOp(txn, ctx.db(), opsToApply[j]);
+                    }
+                }
+
+                for ( size_t j = opIndex; j < endIndex; j++ ) {
+                    bool failed = repl::applyOperation_inlock(txn,
+                                                              ctx.db(),
+                                                              opsToApply[j],
+                                                              false,
+                                                              alwaysUpsert);
+                    ab.append(!failed);
+                    if ( failed )
+                        errors++;
+
+                    num++;
+                }
 
                 logOpForDbHash(ns.c_str());
+
+                opIndex = endIndex;
             }
 
             result.append( "applied" , num );
@@ -0,0 +1,133 @@
+// backup.cpp
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/global_environment_experiment.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage_options.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+    /**
+     * beginBackup asks the storage engine for a consistent checkpoint of its data files
+     * and returns the list of files (relative to the dbpath) an external tool has to
+     * copy. Unlike { fsync: 1, lock: 1 }, writes continue while the backup runs; the
+     * engine keeps the listed files stable until { endBackup: 1 } releases the
+     * checkpoint.
+     *
+     * { beginBackup: 1, incremental: <bool> } - with incremental true, only the journal
+     * files written since the last checkpoint are listed, for engines that support it.
+     */
+    class BeginBackupCommand : public Command {
+    public:
+        BeginBackupCommand() : Command( "beginBackup" ) {}
+
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+        virtual bool slaveOk() const { return true; }
+        virtual bool adminOnly() const { return true; }
+        virtual void help(stringstream& h) const {
+            h << "open a storage engine checkpoint for a hot backup and list the files "
+              << "to copy. writes are not blocked; run { endBackup: 1 } when the copy "
+              << "is done";
+        }
+        virtual void addRequiredPrivileges(const std::string& dbname,
+                                           const BSONObj& cmdObj,
+                                           std::vector<Privilege>* out) {
+            ActionSet actions;
+            actions.addAction(ActionType::fsync);
+            out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+        }
+        virtual bool run(OperationContext* txn, const string& dbname, BSONObj& cmdObj, int,
+                         string& errmsg, BSONObjBuilder& result, bool fromRepl) {
+            const bool incremental = cmdObj["incremental"].trueValue();
+
+            StorageEngine* storageEngine = getGlobalEnvironment()->getGlobalStorageEngine();
+
+            std::vector<std::string> files;
+            Status status = storageEngine->beginBackup(txn, incremental, &files);
+            if (!status.isOK()) {
+                return appendCommandStatus(result, status);
+            }
+
+            log() << "CMD beginBackup: checkpoint open, " << files.size()
+                  << " file(s) to copy, writes still permitted" << endl;
+
+            BSONArrayBuilder arr(result.subarrayStart("files"));
+            for (size_t i = 0; i < files.size(); i++) {
+                arr.append(files[i]);
+            }
+            arr.done();
+            result.append("dbpath", storageGlobalParams.dbpath);
+            return true;
+        }
+    } beginBackupCmd;
+
+    /**
+     * Releases the checkpoint opened by beginBackup. A no-op if no backup is in
+     * progress.
+     */
+    class EndBackupCommand : public Command {
+    public:
+        EndBackupCommand() : Command( "endBackup" ) {}
+
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+        virtual bool slaveOk() const { return true; }
+        virtual bool adminOnly() const { return true; }
+        virtual void help(stringstream& h) const {
+            h << "release the storage engine checkpoint opened by { beginBackup: 1 }";
+        }
+        virtual void addRequiredPrivileges(const std::string& dbname,
+                                           const BSONObj& cmdObj,
+                                           std::vector<Privilege>* out) {
+            ActionSet actions;
+            actions.addAction(ActionType::fsync);
+            out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+        }
+        virtual bool run(OperationContext* txn, const string& dbname, BSONObj& cmdObj, int,
+                         string& errmsg, BSONObjBuilder& result, bool fromRepl) {
+            StorageEngine* storageEngine = getGlobalEnvironment()->getGlobalStorageEngine();
+            storageEngine->endBackup(txn);
+
+            log() << "CMD endBackup: checkpoint released" << endl;
+            return true;
+        }
+    } endBackupCmd;
+
+}
@@ -0,0 +1,172 @@
+// command_admission.cpp
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/command_admission.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/base/init.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+    // Maximum number of read (resp. write) commands executing at once.  0 disables
+    // admission control for that class.  Startup-only: the ticket holders are
+    // sized once, before any command can run.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(admissionControlReadConcurrency, int, 0);
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(admissionControlWriteConcurrency, int, 0);
+
+    // When more than this many commands of one class are already queued, further
+    // arrivals are rejected instead of queued, so a saturated server answers
+    // "overloaded" quickly rather than timing everything out.  0 never rejects.
+    MONGO_EXPORT_SERVER_PARAMETER(admissionControlMaxQueueDepth, int, 0);
+
+    TicketHolder* readTickets = NULL;
+    TicketHolder* writeTickets = NULL;
+
+    AtomicWord<int> readWaiters;
+    AtomicWord<int> writeWaiters;
+
+    Counter64 readsQueued;
+    Counter64 writesQueued;
+    Counter64 readsShed;
+    Counter64 writesShed;
+    Counter64 readWaitMicros;
+    Counter64 writeWaitMicros;
+
+    ServerStatusMetricField<Counter64> displayReadsQueued(
+            "admission.reads.queued", &readsQueued );
+    ServerStatusMetricField<Counter64> displayWritesQueued(
+            "admission.writes.queued", &writesQueued );
+    ServerStatusMetricField<Counter64> displayReadsShed(
+            "admission.reads.shed", &readsShed );
+    ServerStatusMetricField<Counter64> displayWritesShed(
+            "admission.writes.shed", &writesShed );
+    ServerStatusMetricField<Counter64> displayReadWaitMicros(
+            "admission.reads.waitMicros", &readWaitMicros );
+    ServerStatusMetricField<Counter64> displayWriteWaitMicros(
+            "admission.writes.waitMicros", &writeWaitMicros );
+
+    MONGO_INITIALIZER_GENERAL(CreateCommandAdmissionTickets,
+                              ("EndStartupOptionHandling"),
+                              ("default"))(InitializerContext* context) {
+        if ( admissionControlReadConcurrency < 0 || admissionControlWriteConcurrency < 0 ) {
+            return Status( ErrorCodes::BadValue,
+                           "admission control concurrency limits cannot be negative" );
+        }
+        if ( admissionControlReadConcurrency > 0 )
+            readTickets = new TicketHolder( admissionControlReadConcurrency );
+        if ( admissionControlWriteConcurrency > 0 )
+            writeTickets = new TicketHolder( admissionControlWriteConcurrency );
+        return Status::OK();
+    }
+
+}  // namespace
+
+    CommandAdmission::CommandAdmission( OperationContext* txn, Command* c, bool fromRepl )
+        : _tickets( NULL ),
+          _status( Status::OK() ) {
+
+        // Replicated ops and admin-only commands are never held back: queueing
+        // replication or the operator's escape hatches only makes an overload
+        // worse.  Neither are DBDirectClient invocations (every direct call runs
+        // under GodScope): they execute nested inside a command that already
+        // holds a ticket, so queueing them can deadlock the gate against itself.
+        if ( fromRepl || c->adminOnly() || txn->getClient()->isGod() )
+            return;
+
+        const bool isWrite = c->isWriteCommandForConfigServer();
+        TicketHolder* tickets = isWrite ? writeTickets : readTickets;
+        if ( !tickets )
+            return;
+
+        if ( tickets->tryAcquire() ) {
+            _tickets = tickets;
+            return;
+        }
+
+        AtomicWord<int>* waiters = isWrite ? &writeWaiters : &readWaiters;
+
+        const int maxDepth = admissionControlMaxQueueDepth;
+        if ( maxDepth > 0 && waiters->load() >= maxDepth ) {
+            ( isWrite ? writesShed : readsShed ).increment();
+            _status = Status( ErrorCodes::Error( 28637 ),
+                              str::stream() << "rejecting " << c->name << ": too many "
+                                            << ( isWrite ? "write" : "read" )
+                                            << " commands queued for admission" );
+            return;
+        }
+
+        waiters->addAndFetch( 1 );
+        Timer timer;
+
+        // Wait within the operation's remaining maxTimeMS budget when it has one,
+        // indefinitely otherwise.
+        const uint64_t remainingMicros = txn->getCurOp()->getRemainingMaxTimeMicros();
+        bool admitted = true;
+        if ( remainingMicros > 0 ) {
+            admitted = tickets->waitForTicket( TicketHolder::PRIORITY_NORMAL,
+                                               static_cast<int>( remainingMicros / 1000 ) + 1 );
+        }
+        else {
+            tickets->waitForTicket();
+        }
+
+        waiters->subtractAndFetch( 1 );
+        ( isWrite ? writesQueued : readsQueued ).increment();
+        ( isWrite ? writeWaitMicros : readWaitMicros ).increment( timer.micros() );
+
+        if ( !admitted ) {
+            _status = Status( ErrorCodes::ExceededTimeLimit,
+                              str::stream() << "operation exceeded time limit while queued"
+                                            << " for admission" );
+            return;
+        }
+
+        _tickets = tickets;
+    }
+
+    CommandAdmission::~CommandAdmission() {
+        if ( _tickets )
+            _tickets->release();
+    }
+
+}
@@ -0,0 +1,77 @@
+// command_admission.h
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+    class Command;
+    class OperationContext;
+    class TicketHolder;
+
+    /**
+     * Admission gate between command dispatch and execution.  Without it an
+     * overloaded server queues every incoming command on the lock manager and
+     * storage engine, and throughput falls off a cliff; with it, excess commands
+     * wait (or are rejected) up front, where waiting is cheap.
+     *
+     * Commands are split into two classes -- reads and writes -- each with its
+     * own concurrency limit, configured with the admissionControlReadConcurrency
+     * and admissionControlWriteConcurrency server parameters.  Both default to 0,
+     * which disables admission control entirely.  Replicated operations,
+     * admin-only commands and nested DBDirectClient invocations (which run
+     * inside a command already holding a slot) are never gated.
+     */
+    class CommandAdmission {
+        MONGO_DISALLOW_COPYING(CommandAdmission);
+    public:
+        /**
+         * Classifies the command and, when a limit is configured for its class,
+         * blocks until an execution slot is free.  Waits no longer than the
+         * operation's remaining maxTimeMS budget, if it has one.  On failure
+         * (queue full, or the time budget expired while queued) status() is not
+         * OK and the command must not be run.
+         */
+        CommandAdmission( OperationContext* txn, Command* c, bool fromRepl );
+
+        /** Releases the execution slot, if one was acquired. */
+        ~CommandAdmission();
+
+        const Status& status() const { return _status; }
+
+    private:
+        TicketHolder* _tickets;  // NULL if this command was not gated
+        Status _status;
+    };
+
+}
@@ -38,7 +38,9 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/storage/recovery_unit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/timer.h"
@@ -54,10 +56,48 @@ namespace mongo {
         dbhashCmd.wipeCacheForCollection( ns );
     }
 
+    namespace {
+
+        /**
+         * Applies one record's md5 to a collection digest only once the enclosing unit
+         * of work commits, so a rolled back write leaves the digest untouched.  The
+         * digest is an xor, so the same change serves additions and removals.
+         */
+        class DigestChange : public RecoveryUnit::Change {
+        public:
+            DigestChange( const StringData& ns, const BSONObj& doc )
+                : _ns( ns.toString() ) {
+                md5( doc.objdata(), doc.objsize(), _delta );
+            }
+
+            virtual void commit() {
+                dbhashCmd.applyDigestDelta( _ns, _delta );
+            }
+
+            virtual void rollback() {}
+
+        private:
+            const std::string _ns;
+            md5digest _delta;
+        };
+
+    }
+
+    void digestOpForDbHash( OperationContext* txn, const StringData& ns, const BSONObj& doc ) {
+        if ( !dbhashCmd.isDigestMaintained( ns ) )
+            return;
+        txn->recoveryUnit()->registerChange( new DigestChange( ns, doc ) );
+    }
+
+    void wipeDigestForDbHash( const StringData& ns ) {
+        dbhashCmd.invalidateDigest( ns );
+    }
+
     // ----
 
     DBHashCmd::DBHashCmd()
         : Command( "dbHash", false, "dbhash" ),
+          _digestsMutex( "_digestsMutex" ),
           _cachedHashedMutex( "_cachedHashedMutex" ){
     }
 
@@ -88,6 +128,21 @@ namespace mongo {
 
         IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex( opCtx );
 
+        // Collections with a unique _id index hash to an order independent digest --
+        // the xor of the md5 of every record -- which the Collection write paths keep
+        // up to date once one full scan has seeded it.  Later invocations then serve
+        // the digest without touching the collection.  The _id index guarantees no two
+        // records are byte-identical, which the xor needs; capped collections delete
+        // below the Collection layer, so they stay on the scanning path.
+        const bool digestable = desc && !collection->isCapped();
+        if ( digestable ) {
+            string hash;
+            if ( getDigest( fullCollectionName, &hash ) ) {
+                *fromCache = true;
+                return hash;
+            }
+        }
+
         auto_ptr<PlanExecutor> exec;
         if ( desc ) {
             exec.reset(InternalPlanner::indexScan(opCtx,
@@ -112,19 +167,40 @@ namespace mongo {
         md5_state_t st;
         md5_init(&st);
 
+        md5digest d;
+        memset( d, 0, sizeof(d) );
+
         long long n = 0;
         PlanExecutor::ExecState state;
         BSONObj c;
         verify(NULL != exec.get());
         while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
-            md5_append( &st , (const md5_byte_t*)c.objdata() , c.objsize() );
+            if ( digestable ) {
+                md5digest recordDigest;
+                md5( c.objdata(), c.objsize(), recordDigest );
+                for ( size_t i = 0; i < sizeof(d); i++ ) {
+                    d[i] ^= recordDigest[i];
+                }
+            }
+            else {
+                md5_append( &st , (const md5_byte_t*)c.objdata() , c.objsize() );
+            }
             n++;
         }
         if (PlanExecutor::IS_EOF != state) {
             warning() << "error while hashing, db dropped? ns=" << fullCollectionName << endl;
         }
-        md5digest d;
-        md5_finish(&st, d);
+
+        if ( digestable ) {
+            // Seed the digest; from here on the write paths maintain it.  We hold the
+            // database S lock, so no writer can race with the scan we just did.
+            scoped_lock lk( _digestsMutex );
+            memcpy( _digests[fullCollectionName].bits, d, sizeof(d) );
+            _numDigests.store( _digests.size() );
+        }
+        else {
+            md5_finish(&st, d);
+        }
         string hash = digestToString( d );
 
         if ( cachedHashedLock.get() ) {
@@ -134,6 +210,44 @@ namespace mongo {
         return hash;
     }
 
+    bool DBHashCmd::getDigest( const StringData& ns, string* hash ) {
+        if ( _numDigests.load() == 0 )
+            return false;
+        scoped_lock lk( _digestsMutex );
+        map<string,CollectionDigest>::const_iterator it = _digests.find( ns.toString() );
+        if ( it == _digests.end() )
+            return false;
+        md5digest d;
+        memcpy( d, it->second.bits, sizeof(d) );
+        *hash = digestToString( d );
+        return true;
+    }
+
+    bool DBHashCmd::isDigestMaintained( const StringData& ns ) {
+        if ( _numDigests.load() == 0 )
+            return false;
+        scoped_lock lk( _digestsMutex );
+        return _digests.count( ns.toString() ) > 0;
+    }
+
+    void DBHashCmd::applyDigestDelta( const StringData& ns, const unsigned char* delta ) {
+        scoped_lock lk( _digestsMutex );
+        map<string,CollectionDigest>::iterator it = _digests.find( ns.toString() );
+        if ( it == _digests.end() )
+            return; // wiped since the write began; nothing to maintain
+        for ( size_t i = 0; i < sizeof(it->second.bits); i++ ) {
+            it->second.bits[i] ^= delta[i];
+        }
+    }
+
+    void DBHashCmd::invalidateDigest( const StringData& ns ) {
+        if ( _numDigests.load() == 0 )
+            return;
+        scoped_lock lk( _digestsMutex );
+        _digests.erase( ns.toString() );
+        _numDigests.store( _digests.size() );
+    }
+
     bool DBHashCmd::run(OperationContext* txn, const string& dbname , BSONObj& cmdObj, int, string& errmsg, BSONObjBuilder& result, bool) {
         Timer timer;
 
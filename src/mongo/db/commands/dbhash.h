@@ -30,12 +30,33 @@
 
 #pragma once
 
+#include <string.h>
+
 #include "mongo/db/commands.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
+    class OperationContext;
+
     void logOpForDbHash( const char* ns );
 
+    /**
+     * Folds one document into the incrementally maintained digest for 'ns', if one has
+     * been seeded by a previous dbHash.  The digest is an xor, so folding a document in
+     * and folding it back out are the same operation; an update is a fold of the old
+     * version of the document plus a fold of the new one.  Called from the Collection
+     * write paths.  The digest is only changed once 'txn's unit of work commits.
+     */
+    void digestOpForDbHash( OperationContext* txn, const StringData& ns, const BSONObj& doc );
+
+    /**
+     * Discards the incrementally maintained digest for 'ns'.  Called when a collection
+     * is created, renamed or truncated, and from write paths that do not see the
+     * documents they touch.
+     */
+    void wipeDigestForDbHash( const StringData& ns );
+
     class DBHashCmd : public Command {
     public:
         DBHashCmd();
@@ -50,12 +71,43 @@ namespace mongo {
 
         void wipeCacheForCollection( const StringData& ns );
 
+        /**
+         * Returns true and fills in 'hash' if a digest has been seeded for 'ns'.
+         */
+        bool getDigest( const StringData& ns, std::string* hash );
+
+        /**
+         * Returns true if a digest has been seeded for 'ns' and is being maintained.
+         */
+        bool isDigestMaintained( const StringData& ns );
+
+        /**
+         * Xors 16 bytes of 'delta' into the digest for 'ns', if one has been seeded.
+         */
+        void applyDigestDelta( const StringData& ns, const unsigned char* delta );
+
+        void invalidateDigest( const StringData& ns );
+
     private:
 
         bool isCachable( const StringData& ns ) const;
 
         std::string hashCollection( OperationContext* opCtx, Database* db, const std::string& fullCollectionName, bool* fromCache );
 
+        /**
+         * One entry per collection whose digest has been seeded by a full scan: the xor
+         * of the md5 of every record.  The write paths keep a seeded entry up to date,
+         * so later dbHash invocations read it without scanning the collection.
+         */
+        struct CollectionDigest {
+            CollectionDigest() { memset( bits, 0, sizeof(bits) ); }
+            unsigned char bits[16];
+        };
+
+        std::map<std::string,CollectionDigest> _digests;
+        AtomicUInt32 _numDigests; // cheap not-seeded-anywhere check for the write paths
+        mutex _digestsMutex;
+
         std::map<std::string,std::string> _cachedHashed;
         mutex _cachedHashedMutex;
 
@@ -47,13 +47,16 @@ namespace mongo {
      *
      *        1. 'off' - disable fail point.
      *        2. 'alwaysOn' - fail point is always active.
-     *        3. { period: <n> } - n should be within the range of a 32 bit signed
-     *            integer and this would be the approximate period for every activation.
-     *            For example, for { period: 120 }, the probability of the fail point to
-     *            be activated is 1 in 120. NOT YET SUPPORTED.
+     *        3. { period: <n> } - n should be positive and within the range of a 32 bit
+     *            signed integer and this would be the approximate period for every
+     *            activation. For example, for { period: 120 }, the probability of the
+     *            fail point to be activated is 1 in 120.
      *        4. { times: <n> } - n should be positive and within the range of a 32 bit
      *            signed integer and this is the number of passes on the fail point will
      *            remain activated.
+     *        5. { sleepMillis: <n> } - every pass on the fail point sleeps n
+     *            milliseconds and then continues normally, without reporting the fail
+     *            point as active. For injecting latency.
      *
      *    data: <Object> // optional arbitrary object to store.
      * }
@@ -134,10 +137,25 @@ namespace mongo {
                 }
                 else if (modeObj.hasField("period")) {
                     mode = FailPoint::random;
+                    const int intVal = modeObj["period"].numberInt();
 
-                    // TODO: implement
-                    errmsg = "random is not yet supported";
-                    return false;
+                    if (intVal < 1) {
+                        errmsg = "period should be positive";
+                        return false;
+                    }
+
+                    val = intVal;
+                }
+                else if (modeObj.hasField("sleepMillis")) {
+                    mode = FailPoint::sleepMillis;
+                    const int intVal = modeObj["sleepMillis"].numberInt();
+
+                    if (intVal < 0) {
+                        errmsg = "sleepMillis should not be negative";
+                        return false;
+                    }
+
+                    val = intVal;
                 }
                 else {
                     errmsg = "invalid mode object";
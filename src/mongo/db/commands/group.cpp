@@ -75,6 +75,10 @@ namespace mongo {
         // By default, group requests are regular group not explain of group.
         request->explain = false;
 
+        // Reduce functions matching a known pattern run natively until proven
+        // otherwise; see NativeGroupReduce.
+        request->allowNativeReduce = true;
+
         const BSONObj& p = cmdObj.firstElement().embeddedObjectUserCheck();
 
         if (p["cond"].type() == Object) {
@@ -156,6 +160,29 @@ namespace mongo {
         // Group executors return ADVANCED exactly once, with the entire group result.
         BSONObj retval;
         PlanExecutor::ExecState state = planExecutor->getNext(&retval, NULL);
+
+        if (PlanExecutor::FAILURE == state &&
+            WorkingSetCommon::isValidStatusMemberObject(retval) &&
+            ErrorCodes::NativeReduceFallback ==
+                WorkingSetCommon::getMemberObjectStatus(retval).code()) {
+            // The native reduce path met a value it could not mirror exactly (say, a
+            // string flowing into a sum). Re-run the whole operation through the
+            // Javascript path.
+            groupRequest.allowNativeReduce = false;
+
+            PlanExecutor* rawRetryExecutor;
+            Status retryStatus = getExecutorGroup(txn,
+                                                  coll,
+                                                  groupRequest,
+                                                  PlanExecutor::YIELD_AUTO,
+                                                  &rawRetryExecutor);
+            if (!retryStatus.isOK()) {
+                return appendCommandStatus(out, retryStatus);
+            }
+            planExecutor.reset(rawRetryExecutor);
+            state = planExecutor->getNext(&retval, NULL);
+        }
+
         if (PlanExecutor::ADVANCED != state) {
             if (PlanExecutor::FAILURE == state &&
                 WorkingSetCommon::isValidStatusMemberObject(retval)) {
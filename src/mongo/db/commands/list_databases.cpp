@@ -34,6 +34,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/global_environment_experiment.h"
+#include "mongo/db/stats/database_stats_cache.h"
 #include "mongo/db/storage/storage_engine.h"
 
 namespace mongo {
@@ -83,10 +84,8 @@ namespace mongo {
             for ( vector< string >::iterator i = dbNames.begin(); i != dbNames.end(); ++i ) {
                 const string& dbname = *i;
 
-                BSONObjBuilder b;
-                b.append( "name", dbname );
-
-                {
+                long long size = 0;
+                if ( !DatabaseStatsCache::getSizeOnDisk( dbname, &size ) ) {
                     ScopedTransaction transaction(txn, MODE_IS);
                     Lock::DBLock dbLock(txn->lockState(), dbname, MODE_IS);
 
@@ -97,13 +96,16 @@ namespace mongo {
                     const DatabaseCatalogEntry* entry = db->getDatabaseCatalogEntry();
                     invariant( entry );
 
-                    int64_t size = entry->sizeOnDisk( txn );
-                    b.append( "sizeOnDisk", static_cast<double>( size ) );
-                    totalSize += size;
-
-                    b.appendBool("empty", size == 0);
+                    size = entry->sizeOnDisk( txn );
+                    DatabaseStatsCache::putSizeOnDisk( dbname, size );
                 }
 
+                BSONObjBuilder b;
+                b.append( "name", dbname );
+                b.append( "sizeOnDisk", static_cast<double>( size ) );
+                b.appendBool( "empty", size == 0 );
+                totalSize += size;
+
                 dbInfos.push_back( b.obj() );
 
                 seen.insert( i->c_str() );
@@ -0,0 +1,103 @@
+// lock_info.cpp
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/lock_contention_trace.h"
+#include "mongo/db/concurrency/lock_state.h"
+
+namespace mongo {
+
+    /**
+     * Diagnostic command for lock contention. Reports the currently contended resources
+     * with their granted and pending lockers (the wait-for graph at the time of the call)
+     * and the most recent events from the lock contention trace, so "who blocked whom" can
+     * be answered both during and after a stall.
+     *
+     * Format: { lockInfo: 1, maxEvents: <n> }
+     *
+     * maxEvents caps the number of trace events returned and defaults to 100.
+     */
+    class CmdLockInfo : public Command {
+    public:
+        CmdLockInfo() : Command("lockInfo") {}
+
+        virtual bool slaveOk() const { return true; }
+        virtual bool adminOnly() const { return true; }
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+
+        virtual void addRequiredPrivileges(const std::string& dbname,
+                                           const BSONObj& cmdObj,
+                                           std::vector<Privilege>* out) {
+            ActionSet actions;
+            actions.addAction(ActionType::serverStatus);
+            out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+        }
+
+        virtual void help(std::stringstream& h) const {
+            h << "Reports currently contended locks and recent lock contention events.";
+        }
+
+        bool run(OperationContext* txn,
+                 const std::string& dbname,
+                 BSONObj& cmdObj,
+                 int,
+                 std::string& errmsg,
+                 BSONObjBuilder& result,
+                 bool fromRepl) {
+
+            int maxEvents = 100;
+            if (cmdObj["maxEvents"].isNumber()) {
+                maxEvents = cmdObj["maxEvents"].numberInt();
+            }
+
+            {
+                BSONArrayBuilder locks(result.subarrayStart("contendedLocks"));
+                getGlobalLockManager()->getContendedLocks(&locks);
+                locks.doneFast();
+            }
+
+            {
+                BSONArrayBuilder events(result.subarrayStart("recentContention"));
+                globalLockContentionTrace.append(&events, maxEvents);
+                events.doneFast();
+            }
+
+            result.append("thresholdMillis", lockContentionTraceThresholdMillis);
+            return true;
+        }
+
+    } cmdLockInfo;
+
+} // namespace mongo
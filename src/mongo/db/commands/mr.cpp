@@ -353,6 +353,35 @@ namespace mongo {
 
         }
 
+        /**
+         * Create the inc collection and make sure we have index on "0" key.
+         * The inc collection is not created until the first spill actually happens,
+         * so jobs whose results stay in memory never pay for it.
+         */
+        void State::_prepIncCollection() {
+            // Intentionally not replicating the inc collection to secondaries.
+            Client::WriteContext incCtx(_txn, _config.incLong);
+            WriteUnitOfWork wuow(_txn);
+            Collection* incColl = incCtx.getCollection();
+            invariant(!incColl);
+
+            CollectionOptions options;
+            options.setNoIdIndex();
+            options.temp = true;
+            incColl = incCtx.db()->createCollection(_txn, _config.incLong, options);
+            invariant(incColl);
+
+            BSONObj indexSpec = BSON( "key" << BSON( "0" << 1 ) << "ns" << _config.incLong
+                                      << "name" << "_temp_0" );
+            Status status = incColl->getIndexCatalog()->createIndexOnEmptyCollection(_txn,
+                                                                                     indexSpec);
+            if ( !status.isOK() ) {
+                uasserted( 17305 , str::stream() << "createIndex failed for mr incLong ns: " <<
+                        _config.incLong << " err: " << status.code() );
+            }
+            wuow.commit();
+        }
+
         /**
          * Create temporary collection, set up indexes
          */
@@ -361,30 +390,6 @@ namespace mongo {
                 return;
 
             dropTempCollections();
-            if (_useIncremental) {
-                // Create the inc collection and make sure we have index on "0" key.
-                // Intentionally not replicating the inc collection to secondaries.
-                Client::WriteContext incCtx(_txn, _config.incLong);
-                WriteUnitOfWork wuow(_txn);
-                Collection* incColl = incCtx.getCollection();
-                invariant(!incColl);
-
-                CollectionOptions options;
-                options.setNoIdIndex();
-                options.temp = true;
-                incColl = incCtx.db()->createCollection(_txn, _config.incLong, options);
-                invariant(incColl);
-
-                BSONObj indexSpec = BSON( "key" << BSON( "0" << 1 ) << "ns" << _config.incLong
-                                          << "name" << "_temp_0" );
-                Status status = incColl->getIndexCatalog()->createIndexOnEmptyCollection(_txn,
-                                                                                         indexSpec);
-                if ( !status.isOK() ) {
-                    uasserted( 17305 , str::stream() << "createIndex failed for mr incLong ns: " <<
-                            _config.incLong << " err: " << status.code() );
-                }
-                wuow.commit();
-            }
 
             vector<BSONObj> indexesToInsert;
 
@@ -695,6 +700,14 @@ namespace mongo {
         void State::_insertToInc( BSONObj& o ) {
             verify( _onDisk );
 
+            if ( !_spilledToInc ) {
+                if ( _useIncremental ) {
+                    // first spill, create the inc collection now
+                    _prepIncCollection();
+                }
+                _spilledToInc = true;
+            }
+
             Client::WriteContext ctx(_txn,  _config.incLong );
             WriteUnitOfWork wuow(_txn);
             Collection* coll = getCollectionOrUassert(ctx.db(), _config.incLong);
@@ -707,6 +720,7 @@ namespace mongo {
                 _db(txn),
                 _useIncremental(true),
                 _txn(txn),
+                _spilledToInc(false),
                 _size(0),
                 _dupCount(0),
                 _numEmits(0) {
@@ -970,6 +984,26 @@ namespace mongo {
                 return;
             }
 
+            if ( !_spilledToInc ) {
+                // the whole job fit in memory; final reduce straight out of the in
+                // memory map instead of round-tripping through the inc collection.
+                // the map is sorted by key, so output order matches the disk path.
+                verify(pm == op->setMessage("m/r: (3/3) final reduce to collection",
+                                            "M/R: (3/3) Final Reduce Progress",
+                                            _temp->size()));
+                for ( InMemory::iterator i=_temp->begin(); i!=_temp->end(); ++i ) {
+                    finalReduce( i->second );
+                    pm.hit();
+                    if ( pm->hits() % 100 == 0 ) {
+                        _txn->checkForInterrupt();
+                    }
+                }
+                _temp->clear();
+                _size = 0;
+                pm.finished();
+                return;
+            }
+
             // use index on "0" to pull sorted data
             verify( _temp->size() == 0 );
             BSONObj sortKey = BSON( "0" << 1 );
@@ -1096,8 +1130,10 @@ namespace mongo {
 
                 if ( all.size() == 1 ) {
                     // only 1 value for this key
-                    if ( _onDisk ) {
-                        // this key has low cardinality, so just write to collection
+                    if ( _onDisk && _spilledToInc ) {
+                        // this key has low cardinality, so just write to collection.
+                        // before the first spill everything stays in memory, so that
+                        // small jobs never touch the inc collection at all
                         _insertToInc( *(all.begin()) );
                     }
                     else {
@@ -1456,8 +1492,12 @@ namespace mongo {
                     // do reduce in memory
                     // this will be the last reduce needed for inline mode
                     state.reduceInMemory();
-                    // if not inline: dump the in memory map to inc collection, all data is on disk
-                    state.dumpToInc();
+                    // if data was spilled to the inc collection during the emit phase,
+                    // dump the rest of the in memory map as well so the final reduce
+                    // sees all data on disk; otherwise finalReduce() consumes the in
+                    // memory map directly and the inc collection is never created
+                    if ( state.spilledToInc() )
+                        state.dumpToInc();
                     // final reduce
                     state.finalReduce(op , pm );
                     reduceTime += rt.micros();
@@ -284,6 +284,13 @@ namespace mongo {
 
             // ------ reduce stage -----------
 
+            /**
+             * Creates the incremental collection along with its sort index. Called
+             * lazily on the first spill to disk rather than up front, so jobs whose
+             * results fit in memory never create it.
+             */
+            void _prepIncCollection();
+
             void prepTempCollection();
 
             void finalReduce( BSONList& values );
@@ -327,6 +334,9 @@ namespace mongo {
 
             bool isOnDisk() { return _onDisk; }
 
+            /** whether any data has been written to the incremental collection */
+            bool spilledToInc() const { return _spilledToInc; }
+
             long long numEmits() const { if (_jsMode) return _scope->getNumberLongLong("_emitCt"); return _numEmits; }
             long long numReduces() const { if (_jsMode) return _scope->getNumberLongLong("_redCt"); return _config.reducer->numReduces; }
             long long numInMemKeys() const { if (_jsMode) return _scope->getNumberLongLong("_keyCt"); return _temp->size(); }
@@ -354,6 +364,7 @@ namespace mongo {
             OperationContext* _txn;
             boost::scoped_ptr<Scope> _scope;
             bool _onDisk; // if the end result of this map reduce is disk or not
+            bool _spilledToInc; // true once anything has been written to the inc collection
 
             boost::scoped_ptr<InMemory> _temp;
             long _size; // bytes in _temp
@@ -92,7 +92,8 @@ namespace mongo {
                                                     "numCursors has to be between 1 and 10000" <<
                                                     " was: " << numCursors ) );
 
-            OwnedPointerVector<RecordIterator> iterators(collection->getManyIterators(txn));
+            OwnedPointerVector<RecordIterator> iterators(collection->getManyIterators(txn,
+                                                                                      numCursors));
 
             if (iterators.size() < numCursors) {
                 numCursors = iterators.size();
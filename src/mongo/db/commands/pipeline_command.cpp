@@ -50,6 +50,7 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/find_constants.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage_options.h"
 
 namespace mongo {
@@ -58,6 +59,14 @@ namespace mongo {
     using boost::scoped_ptr;
     using boost::shared_ptr;
 
+    // When enabled, an aggregation returning a cursor runs its pipeline to completion
+    // up front and spools the results, so a slowly-iterating client holds spooled
+    // result bytes (spilled to compressed temp files past the memory budget, when the
+    // pipeline allows disk use) rather than pinning live pipeline state such as $group
+    // tables until the cursor is exhausted.
+    MONGO_EXPORT_SERVER_PARAMETER(aggregationCursorEagerSpool, bool, false);
+    MONGO_EXPORT_SERVER_PARAMETER(aggregationCursorEagerSpoolMemoryLimitMB, int, 100);
+
     static bool isCursorCommand(BSONObj cmdObj) {
         BSONElement cursorElem = cmdObj["cursor"];
         if (cursorElem.eoo())
@@ -86,6 +95,7 @@ namespace mongo {
 
     static void handleCursorCommand(OperationContext* txn,
                                     const string& ns,
+                                    const intrusive_ptr<ExpressionContext>& pCtx,
                                     ClientCursorPin* pin,
                                     PlanExecutor* exec,
                                     const BSONObj& cmdObj,
@@ -145,6 +155,19 @@ namespace mongo {
         }
 
         if (cursor) {
+            // Eagerly run the rest of the pipeline now, while no client round trips
+            // intervene, and serve the getMores from the spool.  batchSize: 0 keeps its
+            // fast-return contract and stays lazy.
+            if (aggregationCursorEagerSpool && batchSize > 0) {
+                PipelineProxyStage* proxy =
+                    static_cast<PipelineProxyStage*>(exec->getRootStage());
+                proxy->spoolAllResults(
+                        static_cast<size_t>(aggregationCursorEagerSpoolMemoryLimitMB)
+                            * 1024 * 1024,
+                        pCtx->extSortAllowed,
+                        pCtx->tempDir);
+            }
+
             // If a time limit was set on the pipeline, remaining time is "rolled over" to the
             // cursor (for use by future getmore ops).
             cursor->setLeftoverMaxTimeMicros( txn->getCurOp()->getRemainingMaxTimeMicros() );
@@ -297,7 +320,7 @@ namespace mongo {
                     result << "stages" << Value(pPipeline->writeExplainOps());
                 }
                 else if (isCursorCommand(cmdObj)) {
-                    handleCursorCommand(txn, nss.ns(), pin.get(), exec, cmdObj, result);
+                    handleCursorCommand(txn, nss.ns(), pCtx, pin.get(), exec, cmdObj, result);
                     keepCursor = true;
                 }
                 else {
@@ -42,6 +42,8 @@
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/commands/plan_cache_commands.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/util/log.h"
@@ -104,6 +106,8 @@ namespace {
         new PlanCacheListQueryShapes();
         new PlanCacheClear();
         new PlanCacheListPlans();
+        new PlanCacheExport();
+        new PlanCacheImport();
 
         return Status::OK();
     }
@@ -443,4 +447,124 @@ namespace mongo {
         return Status::OK();
     }
 
+    PlanCacheExport::PlanCacheExport() : PlanCacheCommand("planCacheExport",
+        "Dumps all cached plans for a collection in a format accepted by planCacheImport.",
+        ActionType::planCacheRead) { }
+
+    Status PlanCacheExport::runPlanCacheCommand(OperationContext* txn,
+                                                const std::string& ns,
+                                                BSONObj& cmdObj,
+                                                BSONObjBuilder* bob) {
+        AutoGetCollectionForRead ctx(txn, ns);
+
+        PlanCache* planCache;
+        Status status = getPlanCache(txn, ctx.getCollection(), ns, &planCache);
+        if (!status.isOK()) {
+            // No collection - return results with empty entries array.
+            BSONArrayBuilder arrayBuilder(bob->subarrayStart("entries"));
+            arrayBuilder.doneFast();
+            return Status::OK();
+        }
+        return list(*planCache, bob);
+    }
+
+    // static
+    Status PlanCacheExport::list(const PlanCache& planCache, BSONObjBuilder* bob) {
+        invariant(bob);
+
+        vector<PlanCacheEntry*> entries = planCache.getAllEntries();
+
+        BSONArrayBuilder arrayBuilder(bob->subarrayStart("entries"));
+        for (vector<PlanCacheEntry*>::const_iterator i = entries.begin();
+                i != entries.end(); i++) {
+            PlanCacheEntry* entry = *i;
+            invariant(entry);
+
+            arrayBuilder.append(entry->toBSON());
+
+            // Release resources for cached solution after serializing.
+            delete entry;
+        }
+        arrayBuilder.doneFast();
+
+        return Status::OK();
+    }
+
+    PlanCacheImport::PlanCacheImport() : PlanCacheCommand("planCacheImport",
+        "Restores cached plans previously exported with planCacheExport.",
+        ActionType::planCacheWrite) { }
+
+    Status PlanCacheImport::runPlanCacheCommand(OperationContext* txn,
+                                                const std::string& ns,
+                                                BSONObj& cmdObj,
+                                                BSONObjBuilder* bob) {
+        AutoGetCollectionForRead ctx(txn, ns);
+
+        PlanCache* planCache;
+        Status status = getPlanCache(txn, ctx.getCollection(), ns, &planCache);
+        if (!status.isOK()) {
+            // Unlike the read-only plan cache commands, importing into a missing
+            // collection is an error.
+            return status;
+        }
+        return import(txn, ctx.getCollection(), planCache, cmdObj, bob);
+    }
+
+    // static
+    Status PlanCacheImport::import(OperationContext* txn,
+                                   Collection* collection,
+                                   PlanCache* planCache,
+                                   const BSONObj& cmdObj,
+                                   BSONObjBuilder* bob) {
+        invariant(collection);
+        invariant(planCache);
+        invariant(bob);
+
+        BSONElement entriesElt = cmdObj.getField("entries");
+        if (entriesElt.type() != mongo::Array) {
+            return Status(ErrorCodes::BadValue, "required field entries must be an array");
+        }
+
+        // Snapshot the collection's current indexes once; every imported plan is validated
+        // (and its multikey/sparse state refreshed) against this list.
+        vector<IndexEntry> indexes;
+        IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(txn,
+                                                                                         false);
+        while (ii.more()) {
+            const IndexDescriptor* desc = ii.next();
+            const IndexCatalogEntry* ice = collection->getIndexCatalog()->getEntry(desc);
+            indexes.push_back(IndexEntry(desc->keyPattern(),
+                                         desc->getAccessMethodName(),
+                                         desc->isMultikey(txn),
+                                         desc->isSparse(),
+                                         desc->indexName(),
+                                         ice->getFilterExpression(),
+                                         desc->infoObj()));
+        }
+
+        int imported = 0;
+        int skipped = 0;
+        BSONObjIterator it(entriesElt.Obj());
+        while (it.more()) {
+            BSONElement entryElt = it.next();
+            if (!entryElt.isABSONObj()) {
+                return Status(ErrorCodes::BadValue, "entries array elements must be objects");
+            }
+            Status entryStatus = planCache->importEntry(entryElt.Obj(), indexes);
+            if (entryStatus.isOK()) {
+                imported++;
+            }
+            else {
+                // A stale entry - e.g. one referencing an index dropped since the export -
+                // should not abort the rest of the import.
+                LOG(1) << "planCacheImport skipping entry: " << entryStatus.reason();
+                skipped++;
+            }
+        }
+
+        bob->append("imported", imported);
+        bob->append("skipped", skipped);
+        return Status::OK();
+    }
+
 } // namespace mongo
@@ -180,4 +180,58 @@ namespace mongo {
                            BSONObjBuilder* bob);
     };
 
+    /**
+     * planCacheExport
+     *
+     * { planCacheExport: <collection> }
+     *
+     * Dumps every entry in the collection's plan cache in a format accepted by
+     * planCacheImport, so cached plans can be stashed externally (e.g. in a regular
+     * collection) and restored after a restart instead of starting from a cold cache.
+     */
+    class PlanCacheExport : public PlanCacheCommand {
+    public:
+        PlanCacheExport();
+        virtual Status runPlanCacheCommand(OperationContext* txn,
+                                           const std::string& ns,
+                                           BSONObj& cmdObj,
+                                           BSONObjBuilder* bob);
+
+        /**
+         * Serializes all cache entries into an 'entries' array in the result.
+         */
+        static Status list(const PlanCache& planCache, BSONObjBuilder* bob);
+    };
+
+    /**
+     * planCacheImport
+     *
+     * {
+     *     planCacheImport: <collection>,
+     *     entries: [ <entry>, ... ]
+     * }
+     *
+     * Restores entries previously produced by planCacheExport. Each entry is validated
+     * against the collection's current indexes; stale entries (e.g. referencing a dropped
+     * index) are skipped and counted rather than failing the whole import.
+     */
+    class PlanCacheImport : public PlanCacheCommand {
+    public:
+        PlanCacheImport();
+        virtual Status runPlanCacheCommand(OperationContext* txn,
+                                           const std::string& ns,
+                                           BSONObj& cmdObj,
+                                           BSONObjBuilder* bob);
+
+        /**
+         * Imports entries from the command's 'entries' array into the collection's
+         * plan cache. Reports 'imported' and 'skipped' counts in the result.
+         */
+        static Status import(OperationContext* txn,
+                             Collection* collection,
+                             PlanCache* planCache,
+                             const BSONObj& cmdObj,
+                             BSONObjBuilder* bob);
+    };
+
 }  // namespace mongo
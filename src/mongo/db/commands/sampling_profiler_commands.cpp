@@ -0,0 +1,125 @@
+// sampling_profiler_commands.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+/**
+ * Commands for the built-in sampling CPU profiler, available on POSIX builds
+ * without any special build flags (unlike the gperftools commands in
+ * cpuprofile.cpp):
+ *
+ *     { _samplingProfilerStart: 1, samplesPerSecond: <1..1000, default 100> }
+ *     { _samplingProfilerStop: 1 }
+ *     { _samplingProfilerReport: 1 }
+ */
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/sampling_profiler.h"
+
+namespace mongo {
+
+    namespace {
+
+        /**
+         * Common code for the sampling profiler commands.
+         */
+        class SamplingProfilerCommand : public Command {
+        public:
+            SamplingProfilerCommand( char const *name ) : Command( name ) {}
+            virtual bool slaveOk() const { return true; }
+            virtual bool adminOnly() const { return true; }
+            virtual bool localHostOnlyIfNoAuth( const BSONObj& cmdObj ) { return true; }
+            virtual bool isWriteCommandForConfigServer() const { return false; }
+            virtual void addRequiredPrivileges(const std::string& dbname,
+                                               const BSONObj& cmdObj,
+                                               std::vector<Privilege>* out) {
+                ActionSet actions;
+                actions.addAction(ActionType::cpuProfiler);
+                out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+            }
+        };
+
+        class SamplingProfilerStartCommand : public SamplingProfilerCommand {
+        public:
+            SamplingProfilerStartCommand() : SamplingProfilerCommand( "_samplingProfilerStart" ) {}
+
+            virtual bool run( OperationContext* txn,
+                              std::string const &db,
+                              BSONObj &cmdObj,
+                              int options,
+                              std::string &errmsg,
+                              BSONObjBuilder &result,
+                              bool fromRepl ) {
+                int samplesPerSecond = 100;
+                if ( !cmdObj["samplesPerSecond"].eoo() ) {
+                    samplesPerSecond = cmdObj["samplesPerSecond"].numberInt();
+                }
+                return appendCommandStatus( result,
+                                            SamplingProfiler::get().start( samplesPerSecond ) );
+            }
+        } samplingProfilerStartCommandInstance;
+
+        class SamplingProfilerStopCommand : public SamplingProfilerCommand {
+        public:
+            SamplingProfilerStopCommand() : SamplingProfilerCommand( "_samplingProfilerStop" ) {}
+
+            virtual bool run( OperationContext* txn,
+                              std::string const &db,
+                              BSONObj &cmdObj,
+                              int options,
+                              std::string &errmsg,
+                              BSONObjBuilder &result,
+                              bool fromRepl ) {
+                return appendCommandStatus( result, SamplingProfiler::get().stop() );
+            }
+        } samplingProfilerStopCommandInstance;
+
+        class SamplingProfilerReportCommand : public SamplingProfilerCommand {
+        public:
+            SamplingProfilerReportCommand()
+                : SamplingProfilerCommand( "_samplingProfilerReport" ) {}
+
+            virtual bool run( OperationContext* txn,
+                              std::string const &db,
+                              BSONObj &cmdObj,
+                              int options,
+                              std::string &errmsg,
+                              BSONObjBuilder &result,
+                              bool fromRepl ) {
+                result.appendElements( SamplingProfiler::get().report() );
+                return true;
+            }
+        } samplingProfilerReportCommandInstance;
+
+    }  // namespace
+
+}  // namespace mongo
@@ -47,9 +47,11 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/platform/process_id.h"
+#include "mongo/util/concurrency/spin_lock.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/listen.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/numa.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
 #include "mongo/util/version.h"
@@ -170,6 +172,21 @@ namespace mongo {
             (*_sections)[section->getSectionName()] = section;
         }
 
+        void appendSnapshotSections( OperationContext* txn, BSONObjBuilder* result ) {
+            if ( _sections == 0 )
+                return;
+            for ( SectionMap::const_iterator i = _sections->begin();
+                  i != _sections->end(); ++i ) {
+                ServerStatusSection* section = i->second;
+                if ( ! section->includeInStatusSnapshot() )
+                    continue;
+                BSONObj data = section->generateSection(txn, BSONElement());
+                if ( data.isEmpty() )
+                    continue;
+                result->append( section->getSectionName(), data );
+            }
+        }
+
     private:
         const unsigned long long _started;
         bool _runCalled;
@@ -181,6 +198,10 @@ namespace mongo {
 
     CmdServerStatus::SectionMap* CmdServerStatus::_sections = 0;
 
+    void appendStatusSnapshotSections(OperationContext* txn, BSONObjBuilder* result) {
+        cmdServerStatus.appendSnapshotSections(txn, result);
+    }
+
     ServerStatusSection::ServerStatusSection( const string& sectionName )
         : _sectionName( sectionName ) {
         cmdServerStatus.addSection( this );
@@ -214,6 +235,8 @@ namespace mongo {
                 bb.append( "current" , Listener::globalTicketHolder.used() );
                 bb.append( "available" , Listener::globalTicketHolder.available() );
                 bb.append( "totalCreated" , Listener::globalConnectionNumber.load() );
+                bb.append( "acceptQueueDepth" , Listener::globalAcceptQueueDepth.load() );
+                bb.append( "acceptQueueMaxDepth" , Listener::globalAcceptQueueMaxDepth.load() );
                 return bb.obj();
             }
 
@@ -274,6 +297,56 @@ namespace mongo {
                 
         } network;
 
+        // Contention counters for the named spinlocks, aggregated by name. Off by
+        // default; ask for it with serverStatus({spinLocks: 1}) when hunting for
+        // CPU burned spinning.
+        class SpinLocks : public ServerStatusSection {
+        public:
+            SpinLocks() : ServerStatusSection( "spinLocks" ){}
+            virtual bool includeByDefault() const { return false; }
+
+            BSONObj generateSection(OperationContext* txn,
+                                    const BSONElement& configElement) const {
+
+                std::vector<SpinLockStats::Snapshot> stats;
+                SpinLockStats::appendAll( &stats );
+
+                BSONObjBuilder b;
+                for ( size_t i = 0; i < stats.size(); i++ ) {
+                    BSONObjBuilder sub( b.subobjStart( stats[i].name ) );
+                    sub.appendNumber( "contentions",
+                                      static_cast<long long>( stats[i].contentions ) );
+                    sub.appendNumber( "totalWaitMicros",
+                                      static_cast<long long>( stats[i].waitMicros ) );
+                    sub.done();
+                }
+                return b.obj();
+            }
+
+        } spinLocks;
+
+        // Per-NUMA-node memory counters from the kernel.  Off by default; ask for
+        // it with serverStatus({numa: 1}).  Empty -- and therefore omitted -- on
+        // single node machines.
+        class Numa : public ServerStatusSection {
+        public:
+            Numa() : ServerStatusSection( "numa" ){}
+            virtual bool includeByDefault() const { return false; }
+
+            BSONObj generateSection(OperationContext* txn,
+                                    const BSONElement& configElement) const {
+
+                if ( !numa::available() )
+                    return BSONObj();
+
+                BSONObjBuilder b;
+                b.append( "numNodes", numa::nodeCount() );
+                numa::appendNodeMemoryStats( b );
+                return b.obj();
+            }
+
+        } numaSection;
+
 #ifdef MONGO_SSL
         class Security : public ServerStatusSection {
         public:
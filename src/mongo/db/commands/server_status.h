@@ -45,12 +45,20 @@ namespace mongo {
 
         const std::string& getSectionName() const { return _sectionName; }
 
+        /**
+         * If true, this section is expensive enough (locks, storage engine calls) that
+         * the periodic status snapshot keeps a cached copy of it for monitoring
+         * scrapes. The cached copy is only served where slightly stale data is
+         * acceptable (the HTTP status page), never by the serverStatus command itself.
+         */
+        virtual bool includeInStatusSnapshot() const { return false; }
+
         /**
          * if this returns true, if the user doesn't mention this section
          * it will be included in the result
          * if they do : 1, it will be included
          * if they do : 0, it will not
-         * 
+         *
          * examples (section 'foo')
          *  includeByDefault returning true
          *     foo : 0 = not included
@@ -85,7 +93,7 @@ namespace mongo {
     public:
         OpCounterServerStatusSection( const std::string& sectionName, OpCounters* counters );
         virtual bool includeByDefault() const { return true; }
-        
+
         virtual BSONObj generateSection(OperationContext* txn,
                                         const BSONElement& configElement) const;
 
@@ -93,5 +101,13 @@ namespace mongo {
         const OpCounters* _counters;
     };
 
+    /**
+     * Appends a freshly generated copy of every registered section with
+     * includeInStatusSnapshot() to 'result'. Called by the snapshot thread at a fixed
+     * cadence; scrapes should read the published copy via getStatusSnapshot() in
+     * db/stats/snapshots.h rather than calling this on the request path.
+     */
+    void appendStatusSnapshotSections(OperationContext* txn, BSONObjBuilder* result);
+
 }
 
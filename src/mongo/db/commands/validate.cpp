@@ -32,11 +32,13 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bson_validate.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -49,7 +51,9 @@ namespace mongo {
         }
 
         virtual void help(stringstream& h) const { h << "Validate contents of a namespace by scanning its data structures for correctness.  Slow.\n"
-                                                        "Add full:true option to do a more thorough check"; }
+                                                        "Add full:true option to do a more thorough check\n"
+                                                        "Add background:true option to validate without blocking writes; "
+                                                        "only record and index counts are cross-checked in this mode"; }
 
         virtual bool isWriteCommandForConfigServer() const { return false; }
         virtual void addRequiredPrivileges(const std::string& dbname,
@@ -59,13 +63,14 @@ namespace mongo {
             actions.addAction(ActionType::validate);
             out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
         }
-        //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool> } */
+        //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool>] [, background: <bool>] } */
 
         bool run(OperationContext* txn, const string& dbname , BSONObj& cmdObj, int, string& errmsg, BSONObjBuilder& result, bool fromRepl ) {
             string ns = dbname + "." + cmdObj.firstElement().valuestrsafe();
 
             NamespaceString ns_string(ns);
             const bool full = cmdObj["full"].trueValue();
+            const bool background = cmdObj["background"].trueValue();
             const bool scanData = full || cmdObj["scandata"].trueValue();
 
             if ( !ns_string.isNormal() && full ) {
@@ -73,10 +78,19 @@ namespace mongo {
                 return false;
             }
 
+            if ( background && full ) {
+                errmsg = "cannot run full validate in background mode";
+                return false;
+            }
+
             if (!serverGlobalParams.quiet) {
                 LOG(0) << "CMD: validate " << ns << endl;
             }
 
+            if ( background ) {
+                return runBackground( txn, ns_string.ns(), errmsg, result );
+            }
+
             AutoGetCollectionForRead ctx(txn, ns_string.ns());
 
             Collection* collection = ctx.getCollection();
@@ -106,6 +120,127 @@ namespace mongo {
             return true;
         }
 
+    private:
+        /**
+         * Validates with yielding scans instead of holding the collection lock throughout,
+         * so writes keep flowing while it runs. Checks that every document is readable and
+         * valid BSON and reconciles record and index entry counts; the structural checks
+         * (extents, freelists, btree invariants) need the exclusive mode.
+         */
+        bool runBackground( OperationContext* txn,
+                            const string& ns,
+                            string& errmsg,
+                            BSONObjBuilder& result ) {
+
+            AutoGetCollectionForRead ctx( txn, ns );
+
+            Collection* collection = ctx.getCollection();
+            if ( !collection ) {
+                errmsg = "ns not found";
+                return false;
+            }
+
+            result.append( "ns", ns );
+
+            std::vector<std::string> errors;
+            std::vector<std::string> warnings;
+
+            long long nrecords = 0;
+            long long nInvalid = 0;
+            {
+                auto_ptr<PlanExecutor> exec( InternalPlanner::collectionScan( txn,
+                                                                              ns,
+                                                                              collection ) );
+                exec->setYieldPolicy( PlanExecutor::YIELD_AUTO );
+
+                BSONObj obj;
+                RecordId loc;
+                PlanExecutor::ExecState state;
+                while ( PlanExecutor::ADVANCED == ( state = exec->getNext( &obj, &loc ) ) ) {
+                    nrecords++;
+                    if ( !validateBSON( obj.objdata(), obj.objsize() ).isOK() ) {
+                        nInvalid++;
+                        if ( nInvalid <= 10 ) {
+                            errors.push_back( str::stream() << "invalid BSON at " << loc );
+                        }
+                    }
+                }
+                if ( PlanExecutor::IS_EOF != state ) {
+                    errmsg = "background validate terminated early (collection went away?)";
+                    return false;
+                }
+            }
+            if ( nInvalid > 10 ) {
+                errors.push_back( str::stream() << ( nInvalid - 10 )
+                                                << " more invalid documents not listed" );
+            }
+            result.appendNumber( "nrecords", nrecords );
+
+            IndexCatalog* indexCatalog = collection->getIndexCatalog();
+            result.append( "nIndexes", indexCatalog->numIndexesReady( txn ) );
+
+            BSONObjBuilder indexes; // not using subObjStart to be exception safe
+            IndexCatalog::IndexIterator i = indexCatalog->getIndexIterator( txn, false );
+            while ( i.more() ) {
+                const IndexDescriptor* descriptor = i.next();
+                const string indexNs = descriptor->indexNamespace();
+                const bool sparse = descriptor->isSparse();
+                const bool multikey = descriptor->isMultikey( txn );
+
+                auto_ptr<PlanExecutor> exec( InternalPlanner::indexScan( txn,
+                                                                         collection,
+                                                                         descriptor,
+                                                                         BSONObj(),
+                                                                         BSONObj(),
+                                                                         false ) );
+                exec->setYieldPolicy( PlanExecutor::YIELD_AUTO );
+
+                long long keys = 0;
+                PlanExecutor::ExecState state;
+                while ( PlanExecutor::ADVANCED == ( state = exec->getNext( NULL, NULL ) ) ) {
+                    keys++;
+                }
+                if ( PlanExecutor::IS_EOF != state ) {
+                    errmsg = str::stream() << "background validate of " << indexNs
+                                           << " terminated early (index went away?)";
+                    return false;
+                }
+                indexes.appendNumber( indexNs, keys );
+
+                // Reconcile against the record count. Writes landing while we scan move
+                // both counts, so a mismatch here is a reason to run the exclusive mode,
+                // not proof of corruption.
+                if ( !sparse ) {
+                    if ( !multikey && keys != nrecords ) {
+                        warnings.push_back( str::stream()
+                                            << indexNs << " has " << keys << " entries for "
+                                            << nrecords << " documents" );
+                    }
+                    else if ( multikey && keys < nrecords ) {
+                        warnings.push_back( str::stream()
+                                            << indexNs << " has only " << keys
+                                            << " entries for " << nrecords << " documents" );
+                    }
+                }
+            }
+            result.append( "keysPerIndex", indexes.done() );
+
+            result.appendBool( "valid", errors.empty() );
+            result.append( "errors", errors );
+            if ( !warnings.empty() ) {
+                result.append( "warnings", warnings );
+            }
+            result.append( "warning", "Background validate only checks document BSON and "
+                                      "record/index counts. Run without background:true for "
+                                      "structural checks." );
+
+            if ( !errors.empty() ) {
+                result.append("advice", "ns corrupt. See http://dochub.mongodb.org/core/data-recovery");
+            }
+
+            return true;
+        }
+
     } validateCmd;
 
 }
@@ -102,6 +102,11 @@ namespace mongo {
     // TODO: Determine queueing behavior we want here
     MONGO_EXPORT_SERVER_PARAMETER( queueForMigrationCommit, bool, true );
 
+    // Limit on the number of documents an insert batch groups into a single storage
+    // transaction.  Keeps the unit of work (and the amount of work redone when the group
+    // fails and is retried one document at a time) bounded for large batches.
+    MONGO_EXPORT_SERVER_PARAMETER( internalInsertMaxBatchSize, int, 64 );
+
     using mongoutils::str::stream;
 
     WriteBatchExecutor::WriteBatchExecutor( OperationContext* txn,
@@ -832,7 +837,9 @@ namespace mongo {
         // Instantiates an ExecInsertsState, which represents all of the state involved in the batch
         // insert execution algorithm.  Most importantly, encapsulates the lock state.
         //
-        // Every iteration of the loop in execInserts() processes one document insertion, by calling
+        // Every iteration of the loop in execInserts() first tries to peel off a group of
+        // consecutive well-formed documents and insert them via execManyInserts() under a single
+        // storage transaction.  Documents that cannot be handled that way are processed by calling
         // insertOne() exactly once for a given value of state.currIndex.
         //
         // If the ExecInsertsState indicates that the requisite write locks are not held, insertOne
@@ -874,6 +881,26 @@ namespace mongo {
                 elapsedTracker.resetLastTime();
             }
 
+            // Peel off a run of consecutive well-formed documents and insert them under a
+            // single lock acquisition and storage transaction.  If the group cannot be
+            // inserted wholesale we fall through to the one-at-a-time path below, which
+            // reports errors per document.
+            if (!request.isInsertIndexRequest()) {
+                size_t groupEnd = state.currIndex;
+                while (groupEnd < state.normalizedInserts.size() &&
+                       groupEnd - state.currIndex <
+                           static_cast<size_t>(internalInsertMaxBatchSize) &&
+                       state.normalizedInserts[groupEnd].isOK()) {
+                    ++groupEnd;
+                }
+
+                if (groupEnd - state.currIndex > 1 &&
+                    execManyInserts(&state, groupEnd - state.currIndex)) {
+                    state.currIndex = groupEnd - 1;
+                    continue;
+                }
+            }
+
             WriteErrorDetail* error = NULL;
             execOneInsert(&state, &error);
             if (error) {
@@ -1097,6 +1124,73 @@ namespace mongo {
         }
     }
 
+    bool WriteBatchExecutor::execManyInserts(ExecInsertsState* state, size_t count) {
+        invariant(state->currIndex + count <= state->normalizedInserts.size());
+
+        std::vector<BSONObj> docs;
+        docs.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            const StatusWith<BSONObj>& normalizedInsert(
+                state->normalizedInserts[state->currIndex + i]);
+            dassert(normalizedInsert.isOK());
+            docs.push_back(normalizedInsert.getValue().isEmpty() ?
+                           state->request->getInsertRequest()->getDocumentsAt(state->currIndex + i) :
+                           normalizedInsert.getValue());
+        }
+
+        // The whole group runs as one child operation; it is profiled and logged as such.
+        BatchItemRef firstInsertItem(state->request, state->currIndex);
+        CurOp currentOp( _txn->getClient(), _txn->getClient()->curop() );
+        beginCurrentOp( &currentOp, _txn->getClient(), firstInsertItem );
+
+        bool inserted = false;
+        try {
+            WriteOpResult result;
+            if (state->lockAndCheck(&result)) {
+                Collection* collection = state->getCollection();
+                const string& insertNS = collection->ns().ns();
+                invariant(_txn->lockState()->isCollectionLockedForMode(insertNS, MODE_IX));
+
+                WriteUnitOfWork wunit(_txn);
+                size_t numInserted = 0;
+                Status status = collection->insertDocuments(_txn, docs, true, &numInserted);
+                if (status.isOK()) {
+                    for (size_t i = 0; i < docs.size(); i++) {
+                        repl::logOp(_txn, "i", insertNS.c_str(), docs[i]);
+                    }
+                    wunit.commit();
+                    inserted = true;
+                }
+                // Otherwise destroying the uncommitted unit of work rolls back every
+                // document in the group, and the per-document retry starts from scratch.
+            }
+        }
+        catch (const DBException& ex) {
+            Status status(ex.toStatus());
+            if (ErrorCodes::isInterruption(status.code()))
+                throw;
+        }
+
+        if (!inserted) {
+            // Same policy as insertOne(): errors release the write lock.
+            _txn->recoveryUnit()->commitAndRestart();
+            state->unlock();
+            currentOp.done();
+            return false;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            BatchItemRef currInsertItem(state->request, state->currIndex + i);
+            incOpStats(currInsertItem);
+
+            WriteOpStats stats;
+            stats.n = 1;
+            incWriteStats(currInsertItem, stats, NULL, &currentOp);
+        }
+        finishCurrentOp(_txn, &currentOp, NULL);
+        return true;
+    }
+
     /**
      * Perform a single insert into a collection.  Requires the insert be preprocessed and the
      * collection already has been created.
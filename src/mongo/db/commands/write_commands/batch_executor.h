@@ -104,6 +104,16 @@ namespace mongo {
          */
         void execOneInsert( ExecInsertsState* state, WriteErrorDetail** error );
 
+        /**
+         * Attempts to execute "count" consecutive inserts from a batch, starting at the
+         * current index of "state", under a single lock acquisition and storage
+         * transaction.  Returns true if all of them were inserted and their stats
+         * recorded.  Returns false without recording anything if any insert cannot be
+         * performed this way; the caller then retries the documents one at a time so
+         * errors are reported per document.
+         */
+        bool execManyInserts( ExecInsertsState* state, size_t count );
+
         /**
          * Executes an update item (which may update many documents or upsert), and returns the
          * upserted _id on upsert or error on failure.
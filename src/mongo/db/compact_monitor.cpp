@@ -0,0 +1,256 @@
+// compact_monitor.cpp
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/compact_monitor.h"
+
+#include <list>
+#include <set>
+#include <string>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/background.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/fsync.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/repl/repl_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/util/background.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+    Counter64 compactMonitorPasses;
+    Counter64 compactMonitorCompactions;
+
+    ServerStatusMetricField<Counter64> compactMonitorPassesDisplay(
+        "compactMonitor.passes", &compactMonitorPasses );
+    ServerStatusMetricField<Counter64> compactMonitorCompactionsDisplay(
+        "compactMonitor.compactions", &compactMonitorCompactions );
+
+    // Off by default: compacting still takes the database lock exclusively for one
+    // collection at a time, so it is opt-in, meant for secondaries and quiet periods.
+    MONGO_EXPORT_SERVER_PARAMETER( compactMonitorEnabled, bool, false );
+
+    // How long to wait between passes, and how much reclaimable space a collection has
+    // to accumulate -- both in absolute bytes and as a share of its on-disk size --
+    // before a pass will pick it.
+    MONGO_EXPORT_SERVER_PARAMETER( compactMonitorIntervalSecs, int, 3600 );
+    MONGO_EXPORT_SERVER_PARAMETER( compactMonitorMinReclaimableMB, int, 128 );
+    MONGO_EXPORT_SERVER_PARAMETER( compactMonitorMinReclaimablePct, int, 30 );
+
+    class CompactMonitor : public BackgroundJob {
+    public:
+        CompactMonitor(){}
+        virtual ~CompactMonitor(){}
+
+        virtual string name() const { return "CompactMonitor"; }
+
+        virtual void run() {
+            Client::initThread( name().c_str() );
+            cc().getAuthorizationSession()->grantInternalAuthorization();
+
+            // wait a full interval after startup before considering anybody
+            time_t lastPass = time( 0 );
+
+            while ( ! inShutdown() ) {
+                sleepsecs( 60 );
+
+                if ( !compactMonitorEnabled )
+                    continue;
+
+                int intervalSecs = compactMonitorIntervalSecs;
+                if ( intervalSecs < 60 )
+                    intervalSecs = 60;
+                if ( time( 0 ) - lastPass < intervalSecs )
+                    continue;
+
+                if ( lockedForWriting() ) {
+                    LOG(3) << "CompactMonitor: locked for writing" << endl;
+                    continue;
+                }
+
+                lastPass = time( 0 );
+
+                try {
+                    _doOnePass();
+                }
+                catch ( const DBException& e ) {
+                    warning() << "CompactMonitor pass failed: " << e.toString();
+                }
+            }
+        }
+
+    private:
+        void _doOnePass() {
+            OperationContextImpl txn;
+
+            repl::ReplicationCoordinator* replCoord = repl::getGlobalReplicationCoordinator();
+            if ( replCoord->getCurrentMemberState().primary() ) {
+                // same policy as the compact command: don't take exclusive locks out from
+                // under an active primary, let the operator rotate through secondaries
+                LOG(1) << "CompactMonitor: skipping pass on primary" << endl;
+                return;
+            }
+
+            compactMonitorPasses.increment();
+
+            // One collection per pass bounds how much exclusive locking a single wakeup
+            // can cause; the rest of the backlog waits for the next interval.
+            string bestNs;
+            long long bestReclaimable = 0;
+
+            set<string> dbs;
+            dbHolder().getAllShortNames( dbs );
+            for ( set<string>::const_iterator i = dbs.begin(); i != dbs.end(); ++i ) {
+                if ( *i == "local" )
+                    continue;
+                _findCandidateInDB( &txn, *i, &bestNs, &bestReclaimable );
+            }
+
+            if ( bestNs.empty() ) {
+                LOG(2) << "CompactMonitor: no collection over thresholds" << endl;
+                return;
+            }
+
+            _compactCollection( &txn, bestNs, bestReclaimable );
+        }
+
+        /**
+         * Scans the collections of the given database under an IS lock and raises
+         * bestNs/bestReclaimable if one beats the thresholds and the best seen so far.
+         */
+        void _findCandidateInDB( OperationContext* txn, const string& dbName,
+                                 string* bestNs, long long* bestReclaimable ) {
+            const long long minBytes =
+                static_cast<long long>( compactMonitorMinReclaimableMB ) * 1024 * 1024;
+            const int minPct = compactMonitorMinReclaimablePct;
+
+            ScopedTransaction transaction( txn, MODE_IS );
+            Lock::DBLock dbLock( txn->lockState(), dbName, MODE_IS );
+
+            Database* db = dbHolder().get( txn, dbName );
+            if ( !db ) {
+                return;
+            }
+
+            list<string> namespaces;
+            db->getDatabaseCatalogEntry()->getCollectionNamespaces( &namespaces );
+
+            for ( list<string>::const_iterator it = namespaces.begin();
+                  it != namespaces.end(); ++it ) {
+
+                const string& ns = *it;
+                NamespaceString nss( ns );
+                if ( nss.isSystem() ) {
+                    // same restriction as the compact command, other code may hold
+                    // pointers into system collections
+                    continue;
+                }
+
+                Lock::CollectionLock collLock( txn->lockState(), ns, MODE_IS );
+                Collection* collection = db->getCollection( ns );
+                if ( !collection || collection->isCapped() )
+                    continue;
+
+                RecordStore* rs = collection->getRecordStore();
+                if ( !rs->compactSupported() )
+                    continue;
+
+                const long long reclaimable = rs->reclaimableSize( txn );
+                if ( reclaimable < minBytes || reclaimable <= *bestReclaimable )
+                    continue;
+
+                const long long storage = rs->storageSize( txn );
+                if ( storage <= 0 || reclaimable * 100 / storage < minPct )
+                    continue;
+
+                *bestNs = ns;
+                *bestReclaimable = reclaimable;
+            }
+        }
+
+        void _compactCollection( OperationContext* txn, const string& ns,
+                                 long long reclaimable ) {
+            ScopedTransaction transaction( txn, MODE_IX );
+            AutoGetDb autoDb( txn, nsToDatabaseSubstring( ns ), MODE_X );
+            Database* db = autoDb.getDb();
+            Collection* collection = db ? db->getCollection( ns ) : NULL;
+            if ( !collection || collection->isCapped() ) {
+                return; // dropped or changed since we looked
+            }
+
+            if ( repl::getGlobalReplicationCoordinator()->getCurrentMemberState().primary() ) {
+                return; // elected since the pass started
+            }
+
+            if ( BackgroundOperation::inProgForNs( ns ) ) {
+                LOG(1) << "CompactMonitor: background op in progress on " << ns
+                       << ", skipping" << endl;
+                return;
+            }
+
+            Client::Context ctx( txn, ns );
+
+            log() << "CompactMonitor: compact " << ns << " begin, ~"
+                  << ( reclaimable / ( 1024 * 1024 ) ) << "MB reclaimable";
+
+            CompactOptions options;
+            StatusWith<CompactStats> status = collection->compact( txn, &options );
+            if ( !status.isOK() ) {
+                warning() << "CompactMonitor: compact " << ns << " failed: "
+                          << status.getStatus();
+                return;
+            }
+
+            compactMonitorCompactions.increment();
+            log() << "CompactMonitor: compact " << ns << " end";
+        }
+    };
+
+    void startCompactMonitorBackgroundJob() {
+        CompactMonitor* monitor = new CompactMonitor();
+        monitor->go();
+    }
+
+}
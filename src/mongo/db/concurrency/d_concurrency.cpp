@@ -32,6 +32,7 @@
 
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/global_environment_experiment.h"
+#include "mongo/db/namespace_intern.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/util/assert_util.h"
@@ -140,6 +141,27 @@ namespace mongo {
 
         massert(28539, "need a valid database name", !db.empty() && nsIsDbOnly(db));
 
+        _acquire();
+    }
+
+    Lock::DBLock::DBLock(Locker* lockState,
+                         const InternedNamespace* interned,
+                         const StringData& db,
+                         LockMode mode)
+        : ScopedLock(lockState),
+          _id(interned ? interned->dbResourceId() : ResourceId(RESOURCE_DATABASE, db)),
+          _lockState(lockState),
+          _mode(mode) {
+
+        // the intern table only hands out entries for valid full namespaces
+        if (!interned) {
+            massert(28726, "need a valid database name", !db.empty() && nsIsDbOnly(db));
+        }
+
+        _acquire();
+    }
+
+    void Lock::DBLock::_acquire() {
         const bool isRead = (_mode == MODE_S || _mode == MODE_IS);
 
         _lockState->lockGlobal(isRead ? MODE_IS : MODE_IX);
@@ -184,10 +206,26 @@ namespace mongo {
                                          LockMode mode)
         : _id(RESOURCE_COLLECTION, ns),
           _lockState(lockState) {
-        const bool isRead = (mode == MODE_S || mode == MODE_IS);
         massert(28538, "need a non-empty collection name", nsIsFull(ns));
-        dassert(_lockState->isDbLockedForMode(nsToDatabaseSubstring(ns),
-                                              isRead ? MODE_IS : MODE_IX));
+        _acquire(mode, nsToDatabaseSubstring(ns));
+    }
+
+    Lock::CollectionLock::CollectionLock(Locker* lockState,
+                                         const InternedNamespace* interned,
+                                         const StringData& ns,
+                                         LockMode mode)
+        : _id(interned ? interned->collResourceId() : ResourceId(RESOURCE_COLLECTION, ns)),
+          _lockState(lockState) {
+        // the intern table only hands out entries for valid full namespaces
+        if (!interned) {
+            massert(28727, "need a non-empty collection name", nsIsFull(ns));
+        }
+        _acquire(mode, nsToDatabaseSubstring(ns));
+    }
+
+    void Lock::CollectionLock::_acquire(LockMode mode, const StringData& db) {
+        const bool isRead = (mode == MODE_S || mode == MODE_IS);
+        dassert(_lockState->isDbLockedForMode(db, isRead ? MODE_IS : MODE_IX));
         if (supportsDocLocking()) {
             _lockState->lock(_id, mode);
         } else if (enableCollectionLocking) {
@@ -39,6 +39,8 @@
 
 namespace mongo {
 
+    class InternedNamespace;
+
     class StringData;
 
     class Lock { 
@@ -146,6 +148,17 @@ namespace mongo {
         class DBLock : public ScopedLock {
         public:
             DBLock(Locker* lockState, const StringData& db, LockMode mode);
+
+            /**
+             * As above, but when 'interned' is non-NULL uses the ResourceId the
+             * namespace intern table precomputed instead of re-hashing the name.
+             * 'db' is still used for validation when falling back.
+             */
+            DBLock(Locker* lockState,
+                   const InternedNamespace* interned,
+                   const StringData& db,
+                   LockMode mode);
+
             ~DBLock();
 
             /**
@@ -157,6 +170,8 @@ namespace mongo {
             void relockWithMode(const LockMode newMode);
 
         private:
+            void _acquire();
+
             const ResourceId _id;
             Locker* const _lockState;
 
@@ -182,11 +197,24 @@ namespace mongo {
             MONGO_DISALLOW_COPYING(CollectionLock);
         public:
             CollectionLock(Locker* lockState, const StringData& ns, LockMode mode);
+
+            /**
+             * As above, but when 'interned' is non-NULL uses the ResourceId the
+             * namespace intern table precomputed instead of re-hashing the name.
+             * 'ns' is still used for validation when falling back.
+             */
+            CollectionLock(Locker* lockState,
+                           const InternedNamespace* interned,
+                           const StringData& ns,
+                           LockMode mode);
+
             ~CollectionLock();
 
             void relockWithMode( const LockMode mode, Lock::DBLock& dblock );
 
         private:
+            void _acquire(LockMode mode, const StringData& db);
+
             const ResourceId _id;
             Locker* const _lockState;
         };
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_trace.h"
+
+#include <algorithm>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+    LockContentionTrace globalLockContentionTrace;
+
+    MONGO_EXPORT_SERVER_PARAMETER(lockContentionTraceThresholdMillis, int, 100);
+
+    LockContentionTrace::LockContentionTrace() { }
+
+    void LockContentionTrace::record(ResourceId resId,
+                                     LockMode mode,
+                                     LockerId lockerId,
+                                     LockerId blockerId,
+                                     long long durationMicros) {
+
+        const unsigned long long claim = _nextSlot.fetchAndAdd(1);
+        Event& event = _events[claim % kNumEvents];
+
+        // Invalidate the slot for the duration of the write; readers which observe zero, or
+        // which observe different sequence values before and after copying, discard it.
+        event.sequence.store(0);
+
+        event.resId = resId;
+        event.mode = mode;
+        event.lockerId = lockerId;
+        event.blockerId = blockerId;
+        event.durationMicros = durationMicros;
+        event.endTimeMillis = curTimeMillis64();
+
+        event.sequence.store(claim + 1);
+    }
+
+    void LockContentionTrace::append(BSONArrayBuilder* events, int maxEvents) const {
+        const unsigned long long newestClaim = _nextSlot.load();
+        const unsigned long long numAvailable =
+            std::min(newestClaim, static_cast<unsigned long long>(kNumEvents));
+        const unsigned long long numWanted =
+            std::min(numAvailable, static_cast<unsigned long long>(std::max(maxEvents, 0)));
+
+        // Walk backwards from the most recently claimed slot
+        for (unsigned long long i = 0; i < numWanted; i++) {
+            const unsigned long long claim = newestClaim - 1 - i;
+            const Event& event = _events[claim % kNumEvents];
+
+            if (event.sequence.load() != claim + 1)
+                continue;
+
+            Event copy;
+            copy.resId = event.resId;
+            copy.mode = event.mode;
+            copy.lockerId = event.lockerId;
+            copy.blockerId = event.blockerId;
+            copy.durationMicros = event.durationMicros;
+            copy.endTimeMillis = event.endTimeMillis;
+
+            // The slot may have been overwritten while we copied it
+            if (event.sequence.load() != claim + 1)
+                continue;
+
+            BSONObjBuilder b(events->subobjStart());
+            b.appendDate("ts", Date_t(copy.endTimeMillis));
+            b.append("resourceId", copy.resId.toString());
+            b.append("mode", modeName(copy.mode));
+            b.appendNumber("lockerId", static_cast<long long>(copy.lockerId));
+            if (copy.blockerId != 0) {
+                b.appendNumber("blockedBy", static_cast<long long>(copy.blockerId));
+            }
+            b.appendNumber("durationMicros", copy.durationMicros);
+            b.doneFast();
+        }
+    }
+
+} // namespace mongo
@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/concurrency/lock_manager_defs.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+    class BSONArrayBuilder;
+
+    /**
+     * Fixed-size ring of recent lock contention events, so that "who blocked whom" can be
+     * answered after a stall has cleared. Lock waits longer than
+     * lockContentionTraceThresholdMillis are recorded here by LockerImpl::lockComplete.
+     *
+     * Writers are lock-free: a slot is claimed with a single atomic increment and each slot
+     * carries a sequence number, written last, which readers check before and after copying
+     * the slot so that a torn (concurrently overwritten) event is discarded rather than
+     * reported. Events are dropped in FIFO order once the ring wraps.
+     */
+    class LockContentionTrace {
+        MONGO_DISALLOW_COPYING(LockContentionTrace);
+    public:
+        enum { kNumEvents = 4096 };
+
+        LockContentionTrace();
+
+        /**
+         * Records one completed lock wait. blockerId is the id of a locker which was granted
+         * the resource while we waited, sampled mid-wait; zero if the wait ended before a
+         * blocker could be sampled.
+         */
+        void record(ResourceId resId,
+                    LockMode mode,
+                    LockerId lockerId,
+                    LockerId blockerId,
+                    long long durationMicros);
+
+        /**
+         * Appends up to maxEvents of the most recent events, newest first.
+         */
+        void append(BSONArrayBuilder* events, int maxEvents) const;
+
+    private:
+        struct Event {
+            // Slot number + 1 of the claim that wrote the fields below; zero while a write
+            // is in progress. Everything else is plain data guarded by this sequence.
+            AtomicUInt64 sequence;
+
+            ResourceId resId;
+            LockMode mode;
+            LockerId lockerId;
+            LockerId blockerId;
+            long long durationMicros;
+            unsigned long long endTimeMillis;
+        };
+
+        // Monotonically increasing; the slot for a claim c is c % kNumEvents.
+        AtomicUInt64 _nextSlot;
+
+        Event _events[kNumEvents];
+    };
+
+    // Single instance, shared by all lockers
+    extern LockContentionTrace globalLockContentionTrace;
+
+    // Lock waits of at least this many milliseconds are recorded in the trace; negative
+    // values disable recording. Settable at runtime via setParameter.
+    extern int lockContentionTraceThresholdMillis;
+
+} // namespace mongo
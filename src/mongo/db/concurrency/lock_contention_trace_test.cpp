@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_trace.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+    namespace {
+
+        std::vector<BSONElement> elementsOf(const BSONObj& array) {
+            std::vector<BSONElement> elements;
+            BSONObjIterator it(array);
+            while (it.more()) {
+                elements.push_back(it.next());
+            }
+            return elements;
+        }
+
+    } // namespace
+
+    TEST(LockContentionTrace, RecordAndAppend) {
+        LockContentionTrace trace;
+        const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.coll"));
+
+        trace.record(resId, MODE_X, 1, 2, 25000);
+
+        BSONArrayBuilder events;
+        trace.append(&events, 10);
+
+        std::vector<BSONElement> elements = elementsOf(events.arr());
+        ASSERT_EQUALS(1U, elements.size());
+
+        const BSONObj event = elements[0].Obj();
+        ASSERT_EQUALS(resId.toString(), event["resourceId"].str());
+        ASSERT_EQUALS(std::string("X"), event["mode"].str());
+        ASSERT_EQUALS(1, event["lockerId"].numberLong());
+        ASSERT_EQUALS(2, event["blockedBy"].numberLong());
+        ASSERT_EQUALS(25000, event["durationMicros"].numberLong());
+    }
+
+    TEST(LockContentionTrace, NewestFirstAndCapped) {
+        LockContentionTrace trace;
+        const ResourceId resId(RESOURCE_DATABASE, std::string("TestDB"));
+
+        for (int i = 0; i < 10; i++) {
+            trace.record(resId, MODE_S, i, 0, i * 1000);
+        }
+
+        BSONArrayBuilder events;
+        trace.append(&events, 3);
+        std::vector<BSONElement> elements = elementsOf(events.arr());
+
+        ASSERT_EQUALS(3U, elements.size());
+        ASSERT_EQUALS(9, elements[0].Obj()["lockerId"].numberLong());
+        ASSERT_EQUALS(8, elements[1].Obj()["lockerId"].numberLong());
+        ASSERT_EQUALS(7, elements[2].Obj()["lockerId"].numberLong());
+
+        // A blocker id of zero means unknown and is omitted
+        ASSERT_FALSE(elements[0].Obj().hasField("blockedBy"));
+    }
+
+    TEST(LockContentionTrace, WrapsAroundAndDropsOldest) {
+        LockContentionTrace trace;
+        const ResourceId resId(RESOURCE_DATABASE, std::string("TestDB"));
+
+        const int numRecorded = LockContentionTrace::kNumEvents + 5;
+        for (int i = 0; i < numRecorded; i++) {
+            trace.record(resId, MODE_IX, i, 0, 1000);
+        }
+
+        BSONArrayBuilder events;
+        trace.append(&events, numRecorded);
+        std::vector<BSONElement> elements = elementsOf(events.arr());
+
+        ASSERT_EQUALS(static_cast<size_t>(LockContentionTrace::kNumEvents), elements.size());
+        ASSERT_EQUALS(numRecorded - 1, elements[0].Obj()["lockerId"].numberLong());
+        ASSERT_EQUALS(numRecorded - LockContentionTrace::kNumEvents,
+                      elements.back().Obj()["lockerId"].numberLong());
+    }
+
+} // namespace mongo
@@ -28,6 +28,7 @@
 
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/platform/basic.h"
@@ -35,8 +36,10 @@
 #include "mongo/db/concurrency/lock_manager.h"
 
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/db/jsobj.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/stringutils.h"
 #include "mongo/util/timer.h"
 
@@ -98,6 +101,14 @@ namespace {
         return 1 << mode;
     }
 
+    uint32_t nextPowerOfTwo(uint32_t n) {
+        uint32_t result = 1;
+        while (result < n) {
+            result <<= 1;
+        }
+        return result;
+    }
+
 
     /**
      * Maps the resource id to a human-readable string.
@@ -407,13 +418,18 @@ namespace {
     //
 
     // Have more buckets than CPUs to reduce contention on lock and caches
-    const unsigned LockManager::_numLockBuckets(128);
+    LockManager::LockManager()
+        // Over-provision buckets relative to the number of cores, so that concurrently
+        // running threads rarely collide on the same bucket mutex even when their
+        // resources hash unluckily. 128 was the old fixed size and remains the floor.
+        : _numLockBuckets(std::max(128U, nextPowerOfTwo(8 * ProcessInfo().getNumCores()))),
+
+          // Balance scalability of intent locks against potential added cost of
+          // conflicting locks. The exact value doesn't appear very important, but there
+          // should be at least as many partitions as threads running concurrently and it
+          // must be a power of two. 32 was the old fixed size and remains the floor.
+          _numPartitions(std::max(32U, nextPowerOfTwo(2 * ProcessInfo().getNumCores()))) {
 
-    // Balance scalability of intent locks against potential added cost of conflicting locks.
-    // The exact value doesn't appear very important, but should be power of two
-    const unsigned LockManager::_numPartitions = 32;
-
-    LockManager::LockManager() {
         _lockBuckets = new LockBucket[_numLockBuckets];
         _partitions = new Partition[_numPartitions];
     }
@@ -787,11 +803,13 @@ namespace {
     }
 
     LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
-        return &_lockBuckets[resId % _numLockBuckets];
+        // Both counts are powers of two, so these reduce to a mask instead of a 64-bit
+        // division on the lock acquisition path.
+        return &_lockBuckets[resId & (_numLockBuckets - 1)];
     }
 
     LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-        return &_partitions[request->locker->getId() % _numPartitions];
+        return &_partitions[request->locker->getId() & (_numPartitions - 1)];
     }
 
     void LockManager::dump() const {
@@ -807,6 +825,81 @@ namespace {
         }
     }
 
+    void LockManager::getContendedLocks(BSONArrayBuilder* locks) const {
+        for (unsigned i = 0; i < _numLockBuckets; i++) {
+            LockBucket* bucket = &_lockBuckets[i];
+            SimpleMutex::scoped_lock scopedLock(bucket->mutex);
+
+            for (LockBucket::Map::const_iterator it = bucket->data.begin();
+                 it != bucket->data.end();
+                 it++) {
+
+                const LockHead* lock = it->second;
+
+                // Only contended resources are interesting; every pending request waits on
+                // every granted one.
+                if (lock->conflictList.empty()) {
+                    continue;
+                }
+
+                BSONObjBuilder lockObj(locks->subobjStart());
+                lockObj.append("resourceId", lock->resourceId.toString());
+
+                {
+                    BSONArrayBuilder granted(lockObj.subarrayStart("granted"));
+                    for (const LockRequest* iter = lock->grantedList._front;
+                         iter != NULL;
+                         iter = iter->next) {
+
+                        BSONObjBuilder request(granted.subobjStart());
+                        request.appendNumber("lockerId",
+                                             static_cast<long long>(iter->locker->getId()));
+                        request.append("mode", modeName(iter->mode));
+                        request.doneFast();
+                    }
+                }
+
+                {
+                    BSONArrayBuilder pending(lockObj.subarrayStart("pending"));
+                    for (const LockRequest* iter = lock->conflictList._front;
+                         iter != NULL;
+                         iter = iter->next) {
+
+                        BSONObjBuilder request(pending.subobjStart());
+                        request.appendNumber("lockerId",
+                                             static_cast<long long>(iter->locker->getId()));
+                        request.append("mode", modeName(iter->mode));
+                        request.doneFast();
+                    }
+                }
+
+                lockObj.doneFast();
+            }
+        }
+    }
+
+    LockerId LockManager::getFirstConflictingOwner(ResourceId resId, LockerId excludeId) const {
+        LockBucket* bucket = _getBucket(resId);
+        SimpleMutex::scoped_lock scopedLock(bucket->mutex);
+
+        LockBucket::Map::const_iterator it = bucket->data.find(resId);
+        if (it == bucket->data.end()) {
+            return 0;
+        }
+
+        for (const LockRequest* iter = it->second->grantedList._front;
+             iter != NULL;
+             iter = iter->next) {
+
+            const LockerId ownerId = iter->locker->getId();
+            if (ownerId != excludeId) {
+                return ownerId;
+            }
+        }
+
+        return 0;
+    }
+
     void LockManager::_dumpBucket(const LockBucket* bucket) const {
         for (LockBucket::Map::const_iterator it = bucket->data.begin();
              it != bucket->data.end();
@@ -43,6 +43,8 @@
 
 namespace mongo {
 
+    class BSONArrayBuilder;
+
     /**
      * Entry point for the lock manager scheduling functionality. Don't use it directly, but
      * instead go through the Locker interface.
@@ -120,6 +122,22 @@ namespace mongo {
          */
         void dump() const;
 
+        /**
+         * Appends one document per contended resource (one with pending requests), listing
+         * the granted and pending lockers with their modes. This is the wait-for graph at
+         * the time of the call: every pending locker waits on every granted one. Locks each
+         * bucket in turn, so the snapshot is consistent per-resource, but not across
+         * resources.
+         */
+        void getContendedLocks(BSONArrayBuilder* locks) const;
+
+        /**
+         * Returns the id of one locker, other than excludeId, which is currently granted
+         * the specified resource, or zero if there is none. Used for attributing lock waits
+         * to their blocker; which of several granted owners gets returned is arbitrary.
+         */
+        LockerId getFirstConflictingOwner(ResourceId resId, LockerId excludeId) const;
+
     private:
         // The deadlock detector needs to access the buckets and locks directly
         friend class DeadlockDetector;
@@ -179,10 +197,14 @@ namespace mongo {
          */
         void _onLockModeChanged(LockHead* lock, bool checkConflictQueue);
 
-        static const unsigned _numLockBuckets;
+        // Bucket and partition counts are fixed at construction: at least the old fixed
+        // sizes, scaled up with the number of cores so that hot resources spread over
+        // more mutexes on large machines. Both are powers of two so lookups reduce to a
+        // mask.
+        const unsigned _numLockBuckets;
         LockBucket* _lockBuckets;
 
-        static const unsigned _numPartitions;
+        const unsigned _numPartitions;
         Partition* _partitions;
     };
 
@@ -0,0 +1,79 @@
+// lock_manager_bench.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+    MONGO_BENCHMARK(LockerGlobalOnlyCycle) {
+        DefaultLockerImpl locker;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            locker.lockGlobal(MODE_IX);
+            locker.unlockAll();
+        }
+    }
+
+    MONGO_BENCHMARK(LockerCollectionHierarchyCycle) {
+        const ResourceId resIdDb(RESOURCE_DATABASE, std::string("BenchDB"));
+        const ResourceId resIdColl(RESOURCE_COLLECTION, std::string("BenchDB.coll"));
+
+        DefaultLockerImpl locker;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            locker.lockGlobal(MODE_IX);
+            locker.lock(resIdDb, MODE_IX);
+            locker.lock(resIdColl, MODE_IX);
+            locker.unlock(resIdColl);
+            locker.unlock(resIdDb);
+            locker.unlockAll();
+        }
+    }
+
+    MONGO_BENCHMARK(LockerRecursiveReLock) {
+        const ResourceId resIdDb(RESOURCE_DATABASE, std::string("BenchDB"));
+
+        DefaultLockerImpl locker;
+        locker.lockGlobal(MODE_IX);
+        locker.lock(resIdDb, MODE_IX);
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            locker.lock(resIdDb, MODE_IX);
+            locker.unlock(resIdDb);
+        }
+        locker.unlock(resIdDb);
+        locker.unlockAll();
+    }
+
+}  // namespace
+}  // namespace mongo
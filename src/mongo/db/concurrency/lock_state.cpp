@@ -33,6 +33,7 @@
 #include "mongo/db/concurrency/lock_state.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/lock_contention_trace.h"
 #include "mongo/db/global_environment_experiment.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/util/log.h"
@@ -211,6 +212,8 @@ namespace {
     template<bool IsForMMAPV1>
     LockerImpl<IsForMMAPV1>::LockerImpl()
         : _id(idCounter.addAndFetch(1)),
+          _lock("LockerImpl"),
+          _cumulativeLockWaitMicros(0),
           _wuowNestingLevel(0),
           _batchWriter(false),
           _lockPendingParallelWriter(false) {
@@ -600,6 +603,11 @@ namespace {
 
         LockResult result;
 
+        // Sampled once the wait crosses the contention trace threshold, while the blocker
+        // still holds the resource; remains zero for waits which end within one wakeup.
+        const int traceThresholdMs = lockContentionTraceThresholdMillis;
+        LockerId blockerId = 0;
+
         // Don't go sleeping without bound in order to be able to report long waits or wake up for
         // deadlock detection.
         unsigned waitTimeMs = std::min(timeoutMs, DeadlockTimeoutMs);
@@ -608,6 +616,11 @@ namespace {
 
             if (result == LOCK_OK) break;
 
+            if (blockerId == 0 && traceThresholdMs >= 0 &&
+                timer.millis() >= traceThresholdMs) {
+                blockerId = globalLockManager.getFirstConflictingOwner(resId, _id);
+            }
+
             if (checkDeadlock) {
                 DeadlockDetector wfg(globalLockManager, this);
                 if (wfg.check().hasCycle()) {
@@ -627,6 +640,14 @@ namespace {
             }
         }
 
+        const long long waitMicros = timer.micros();
+        _cumulativeLockWaitMicros += waitMicros;
+
+        if (traceThresholdMs >= 0 && waitMicros >= traceThresholdMs * 1000LL) {
+            globalLockContentionTrace.record(
+                resId, _requests.find(resId)->mode, _id, blockerId, waitMicros);
+        }
+
         // Cleanup the state, since this is an unused lock now
         if (result != LOCK_OK) {
             LockRequestsMap::Iterator it = _requests.find(resId);
@@ -126,6 +126,10 @@ namespace mongo {
 
         virtual void getLockerInfo(LockerInfo* lockerInfo) const;
 
+        virtual long long getCumulativeLockWaitMicros() const {
+            return _cumulativeLockWaitMicros;
+        }
+
         virtual bool saveLockStateAndUnlock(LockSnapshot* stateOut);
 
         virtual void restoreLockState(const LockSnapshot& stateToRestore);
@@ -193,6 +197,10 @@ namespace mongo {
         // and condition variable every time.
         CondVarLockGrantNotification _notify;
 
+        // Total time this locker has spent blocked in lockComplete, in microseconds. Only
+        // written by the owning thread, so no synchronization is required.
+        long long _cumulativeLockWaitMicros;
+
         // Delays release of exclusive/intent-exclusive locked resources until the write unit of
         // work completes. Value of 0 means we are not inside a write unit of work.
         int _wuowNestingLevel;
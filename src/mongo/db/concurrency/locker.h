@@ -210,6 +210,14 @@ namespace mongo {
 
         virtual void getLockerInfo(LockerInfo* lockerInfo) const = 0;
 
+        /**
+         * Returns the total time this locker has spent blocked waiting for lock
+         * acquisitions since it was constructed, in microseconds.  The value only ever
+         * grows; callers interested in the wait attributable to a single operation
+         * should take the difference across the operation.
+         */
+        virtual long long getCumulativeLockWaitMicros() const = 0;
+
         /**
          * LockSnapshot captures the state of all resources that are locked, what modes they're
          * locked in, and how many times they've been locked in that mode.
@@ -118,6 +118,10 @@ namespace mongo {
             invariant(false);
         }
 
+        virtual long long getCumulativeLockWaitMicros() const {
+            return 0;
+        }
+
         virtual bool saveLockStateAndUnlock(LockSnapshot* stateOut) {
             invariant(false);
         }
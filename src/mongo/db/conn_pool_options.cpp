@@ -37,6 +37,7 @@ namespace mongo {
 
     int ConnPoolOptions::maxConnsPerHost(200);
     int ConnPoolOptions::maxShardedConnsPerHost(200);
+    int ConnPoolOptions::minConnsPerHost(0);
 
     namespace {
 
@@ -54,6 +55,13 @@ namespace mongo {
                                         true,
                                         false /* can't change at runtime */);
 
+        ExportedServerParameter<int> //
+        minConnsPerHostParameter(ServerParameterSet::getGlobal(),
+                                 "connPoolMinConnsPerHost",
+                                 &ConnPoolOptions::minConnsPerHost,
+                                 true,
+                                 false /* can't change at runtime */);
+
         MONGO_INITIALIZER(InitializeConnectionPools)(InitializerContext* context) {
 
             // Initialize the sharded and unsharded outgoing connection pools
@@ -64,6 +72,7 @@ namespace mongo {
 
             pool.setName("connection pool");
             pool.setMaxPoolSize(ConnPoolOptions::maxConnsPerHost);
+            pool.setMinPoolSize(ConnPoolOptions::minConnsPerHost);
 
             shardConnectionPool.setName("sharded connection pool");
             shardConnectionPool.setMaxPoolSize(ConnPoolOptions::maxShardedConnsPerHost);
@@ -49,6 +49,12 @@ namespace mongo {
          * Maximum connections per host the sharded conn pool should use
          */
         static int maxShardedConnsPerHost;
+
+        /**
+         * Connections per host the connection pool's background task keeps
+         * pre-established (0 disables warm-up)
+         */
+        static int minConnsPerHost;
     };
 
 }
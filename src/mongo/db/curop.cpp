@@ -70,6 +70,7 @@ namespace mongo {
         _op = 0;
         _opNum = _nextOpNum.fetchAndAdd(1);
         _command = NULL;
+        OperationMemoryTracker::setCurrent( &_memoryTracker );
     }
 
     void CurOp::_reset() {
@@ -83,6 +84,7 @@ namespace mongo {
         _killPending.store(0);
         _numYields = 0;
         _expectedLatencyMs = 0;
+        _memoryTracker.reset();
     }
 
     void CurOp::reset() {
@@ -124,6 +126,7 @@ namespace mongo {
     }
 
     CurOp::~CurOp() {
+        OperationMemoryTracker::setCurrent( _wrapped ? &_wrapped->_memoryTracker : NULL );
         if ( _wrapped ) {
             boost::mutex::scoped_lock clientLock(Client::clientsMutex);
             _client->_curOp = _wrapped;
@@ -210,6 +213,11 @@ namespace mongo {
             builder->append("killPending", true);
 
         builder->append( "numYields" , _numYields );
+
+        if ( _memoryTracker.peak() > 0 ) {
+            builder->appendNumber( "memUsed" , _memoryTracker.used() );
+            builder->appendNumber( "memPeak" , _memoryTracker.peak() );
+        }
     }
 
     BSONObj CurOp::description() {
@@ -34,6 +34,7 @@
 #include <boost/noncopyable.hpp>
 
 #include "mongo/db/client.h"
+#include "mongo/db/operation_memory.h"
 #include "mongo/db/server_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/concurrency/spin_lock.h"
@@ -64,7 +65,7 @@ namespace mongo {
     public:
         enum { TOO_BIG_SENTINEL = 1 } ;
 
-        CachedBSONObj() {
+        CachedBSONObj() : _lock("CachedBSONObj") {
             _size = (int*)_buf;
             reset();
         }
@@ -180,6 +181,7 @@ namespace mongo {
         
         // response info
         int executionTime;
+        long long lockWaitMicros;  // time blocked acquiring locks during this op
         int nreturned;
         int responseLength;
     };
@@ -302,6 +304,10 @@ namespace mongo {
         bool killPending() const { return _killPending.loadRelaxed(); }
         void yielded() { _numYields++; }
         int numYields() const { return _numYields; }
+
+        /** byte accounting for this operation; see OperationMemoryTracker */
+        OperationMemoryTracker& memoryTracker() { return _memoryTracker; }
+        const OperationMemoryTracker& memoryTracker() const { return _memoryTracker; }
         
         long long getExpectedLatencyMs() const { return _expectedLatencyMs; }
         void setExpectedLatencyMs( long long latency ) { _expectedLatencyMs = latency; }
@@ -338,6 +344,7 @@ namespace mongo {
         ProgressMeter _progressMeter;
         AtomicInt32 _killPending;
         int _numYields;
+        OperationMemoryTracker _memoryTracker;
         
         // this is how much "extra" time a query might take
         // a writebacklisten for example will block for 30s 
@@ -54,6 +54,7 @@
 #include "mongo/db/catalog/index_key_validate.h"
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
+#include "mongo/db/compact_monitor.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db.h"
 #include "mongo/db/dbdirectclient.h"
@@ -228,7 +229,12 @@ namespace mongo {
 
         virtual void disconnected( AbstractMessagingPort* p ) {
             Client * c = currentClient.get();
-            if( c ) c->shutdown();
+            if( c ) {
+                c->shutdown();
+                // Delete the Client now rather than at thread exit so the thread can be
+                // reused for another connection.
+                currentClient.reset( NULL );
+            }
         }
 
     };
@@ -607,6 +613,8 @@ namespace mongo {
 
         }
 
+        startCompactMonitorBackgroundJob();
+
         startClientCursorMonitor();
 
         PeriodicTask::startRunningPeriodicTasks();
@@ -52,6 +52,7 @@
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/command_admission.h"
 #include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/shutdown.h"
 #include "mongo/db/db.h"
@@ -1458,6 +1459,16 @@ namespace mongo {
             return;
         }
 
+        // Flow control: when admission limits are configured, excess commands
+        // queue (or are shed) here, where waiting is cheap, instead of piling up
+        // on the lock manager and storage engine.  The slot is held until the
+        // command finishes.
+        CommandAdmission admission(txn, c, fromRepl);
+        if (!admission.status().isOK()) {
+            appendCommandStatus(result, admission.status());
+            return;
+        }
+
         std::string errmsg;
         bool retval = false;
 
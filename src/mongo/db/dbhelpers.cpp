@@ -55,6 +55,7 @@
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/db/operation_context_impl.h"
@@ -324,6 +325,13 @@ namespace mongo {
         return true;
     }
 
+    // How many documents a chunk cleanup deletes per collection lock acquisition, and how
+    // long it waits between batches.  The old behavior of re-locking and re-planning for
+    // every single document made post-migration cleanup compete with foreground writes
+    // for hours after a balance.
+    MONGO_EXPORT_SERVER_PARAMETER( rangeDeleterBatchSize, int, 500 );
+    MONGO_EXPORT_SERVER_PARAMETER( rangeDeleterBatchDelayMS, int, 20 );
+
     long long Helpers::removeRange( OperationContext* txn,
                                     const KeyRange& range,
                                     bool maxInclusive,
@@ -366,11 +374,20 @@ namespace mongo {
                << " with write concern: " << writeConcern.toBSON() << endl;
 
         long long numDeleted = 0;
-        
+
         long long millisWaitingForReplication = 0;
 
-        while ( 1 ) {
-            // Scoping for write lock.
+        int batchSize = rangeDeleterBatchSize;
+        if ( batchSize < 1 )
+            batchSize = 1;
+
+        bool done = false;
+        while ( !done ) {
+            int batchDeleted = 0;
+
+            // Scoping for write lock.  Each batch deletes up to 'batchSize' documents
+            // under one lock acquisition and one index scan, then releases the lock so
+            // foreground writes can interleave with a long cleanup.
             {
                 Client::WriteContext ctx(txn, ns);
                 Collection* collection = ctx.getCollection();
@@ -386,89 +403,111 @@ namespace mongo {
                                                                        maxInclusive,
                                                                        InternalPlanner::FORWARD,
                                                                        InternalPlanner::IXSCAN_FETCH));
+                // YIELD_AUTO also registers the executor, so it hears about the
+                // invalidations our own deletes below produce.
                 exec->setYieldPolicy(PlanExecutor::YIELD_AUTO);
 
-                RecordId rloc;
-                BSONObj obj;
-                PlanExecutor::ExecState state;
-                // This may yield so we cannot touch nsd after this.
-                state = exec->getNext(&obj, &rloc);
-                exec.reset();
-                if (PlanExecutor::IS_EOF == state) { break; }
-
-                if (PlanExecutor::DEAD == state) {
-                    warning(LogComponent::kSharding) << "cursor died: aborting deletion for "
-                              << min << " to " << max << " in " << ns
-                              << endl;
-                    break;
-                }
-
-                if (PlanExecutor::FAILURE == state) {
-                    warning(LogComponent::kSharding) << "cursor error while trying to delete "
-                              << min << " to " << max
-                              << " in " << ns << ": "
-                              << WorkingSetCommon::toStatusString(obj) << endl;
-                    break;
-                }
-
-                verify(PlanExecutor::ADVANCED == state);
+                while ( batchDeleted < batchSize ) {
+                    RecordId rloc;
+                    BSONObj obj;
+                    PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
 
-                WriteUnitOfWork wuow(txn);
-
-                if ( onlyRemoveOrphanedDocs ) {
-                    // Do a final check in the write lock to make absolutely sure that our
-                    // collection hasn't been modified in a way that invalidates our migration
-                    // cleanup.
-
-                    // We should never be able to turn off the sharding state once enabled, but
-                    // in the future we might want to.
-                    verify(shardingState.enabled());
+                    if (PlanExecutor::IS_EOF == state) {
+                        done = true;
+                        break;
+                    }
 
-                    // In write lock, so will be the most up-to-date version
-                    CollectionMetadataPtr metadataNow = shardingState.getCollectionMetadata( ns );
+                    if (PlanExecutor::DEAD == state) {
+                        warning(LogComponent::kSharding) << "cursor died: aborting deletion for "
+                                  << min << " to " << max << " in " << ns
+                                  << endl;
+                        done = true;
+                        break;
+                    }
 
-                    bool docIsOrphan;
-                    if ( metadataNow ) {
-                        ShardKeyPattern kp( metadataNow->getKeyPattern() );
-                        BSONObj key = kp.extractShardKeyFromDoc(obj);
-                        docIsOrphan = !metadataNow->keyBelongsToMe( key )
-                            && !metadataNow->keyIsPending( key );
+                    if (PlanExecutor::FAILURE == state) {
+                        warning(LogComponent::kSharding) << "cursor error while trying to delete "
+                                  << min << " to " << max
+                                  << " in " << ns << ": "
+                                  << WorkingSetCommon::toStatusString(obj) << endl;
+                        done = true;
+                        break;
                     }
-                    else {
-                        docIsOrphan = false;
+
+                    verify(PlanExecutor::ADVANCED == state);
+
+                    if ( onlyRemoveOrphanedDocs ) {
+                        // Do a final check in the write lock to make absolutely sure that our
+                        // collection hasn't been modified in a way that invalidates our
+                        // migration cleanup.
+
+                        // We should never be able to turn off the sharding state once enabled,
+                        // but in the future we might want to.
+                        verify(shardingState.enabled());
+
+                        // In write lock, so will be the most up-to-date version
+                        CollectionMetadataPtr metadataNow =
+                            shardingState.getCollectionMetadata( ns );
+
+                        bool docIsOrphan;
+                        if ( metadataNow ) {
+                            ShardKeyPattern kp( metadataNow->getKeyPattern() );
+                            BSONObj key = kp.extractShardKeyFromDoc(obj);
+                            docIsOrphan = !metadataNow->keyBelongsToMe( key )
+                                && !metadataNow->keyIsPending( key );
+                        }
+                        else {
+                            docIsOrphan = false;
+                        }
+
+                        if ( !docIsOrphan ) {
+                            warning(LogComponent::kSharding)
+                                      << "aborting migration cleanup for chunk "
+                                      << min << " to " << max
+                                      << ( metadataNow ?
+                                              (string) " at document " + obj.toString() : "" )
+                                      << ", collection " << ns << " has changed " << endl;
+                            done = true;
+                            break;
+                        }
                     }
 
-                    if ( !docIsOrphan ) {
-                        warning(LogComponent::kSharding)
-                                  << "aborting migration cleanup for chunk " << min << " to " << max
-                                  << ( metadataNow ? (string) " at document " + obj.toString() : "" )
-                                  << ", collection " << ns << " has changed " << endl;
-                        break;
+                    if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesForDatabase(
+                            ns)) {
+                        warning() << "stepped down from primary while deleting chunk; "
+                                  << "orphaning data in " << ns
+                                  << " in range [" << min << ", " << max << ")";
+                        return numDeleted;
                     }
-                }
 
-                if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesForDatabase(ns)) {
-                    warning() << "stepped down from primary while deleting chunk; "
-                              << "orphaning data in " << ns
-                              << " in range [" << min << ", " << max << ")";
-                    return numDeleted;
-                }
+                    if ( callback )
+                        callback->goingToDelete( obj );
+
+                    // The scan must be saved around the delete the same way the
+                    // multi-delete stage saves its child: the delete invalidates the
+                    // scan's current position.
+                    exec->saveState();
+
+                    {
+                        WriteUnitOfWork wuow(txn);
+                        BSONObj deletedId;
+                        collection->deleteDocument( txn, rloc, false, false, &deletedId );
+                        // The above throws on failure, and so is not logged
+                        repl::logOp(txn, "d", ns.c_str(), deletedId, 0, 0, fromMigrate);
+                        wuow.commit();
+                    }
 
-                if ( callback )
-                    callback->goingToDelete( obj );
+                    exec->restoreState(txn);
 
-                BSONObj deletedId;
-                collection->deleteDocument( txn, rloc, false, false, &deletedId );
-                // The above throws on failure, and so is not logged
-                repl::logOp(txn, "d", ns.c_str(), deletedId, 0, 0, fromMigrate);
-                wuow.commit();
-                numDeleted++;
+                    numDeleted++;
+                    batchDeleted++;
+                }
             }
 
             // TODO remove once the yielding below that references this timer has been removed
             Timer secondaryThrottleTime;
 
-            if (writeConcern.shouldWaitForOtherNodes() && numDeleted > 0) {
+            if (writeConcern.shouldWaitForOtherNodes() && batchDeleted > 0) {
                 repl::ReplicationCoordinator::StatusAndDuration replStatus =
                         repl::getGlobalReplicationCoordinator()->awaitReplication(txn,
                                                                                   txn->getClient()->getLastOp(),
@@ -483,8 +522,15 @@ namespace mongo {
                 }
                 millisWaitingForReplication += replStatus.duration.total_milliseconds();
             }
+
+            const int delayMS = rangeDeleterBatchDelayMS;
+            if ( !done && delayMS > 0 ) {
+                // Without the collection lock: give foreground operations a window
+                // between batches.
+                sleepmillis( delayMS );
+            }
         }
-        
+
         if (writeConcern.shouldWaitForOtherNodes())
             log(LogComponent::kSharding)
                   << "Helpers::removeRangeUnlocked time spent waiting for replication: "
@@ -207,6 +207,30 @@ namespace mongo {
     }
 
     void replyToQuery( int queryResultFlags, Message& response, const BSONObj& resultObj ) {
+        // If the object owns its buffer we can splice that buffer into the message behind a
+        // small header fragment rather than copying the whole object through a BufBuilder.
+        // The message shares ownership, so the buffer lives as long as the response does.
+        SharedBuffer sharedObjBuf = resultObj.sharedBuffer();
+        if ( sharedObjBuf.get() && sharedObjBuf.get() == resultObj.objdata() ) {
+            BufBuilder headerBuilder( sizeof( QueryResult::Value ) );
+            headerBuilder.skip( sizeof( QueryResult::Value ) );
+
+            QueryResult::View queryResult = headerBuilder.buf();
+            headerBuilder.decouple();
+
+            queryResult.setResultFlags(queryResultFlags);
+            queryResult.msgdata().setLen( sizeof( QueryResult::Value ) );
+            queryResult.msgdata().setOperation( opReply );
+            queryResult.setCursorId(0);
+            queryResult.setStartingFrom(0);
+            queryResult.setNReturned(1);
+
+            response.setData( queryResult.view2ptr(), true ); // transport will free
+            // updates the header's len to cover the spliced object
+            response.appendSharedData( sharedObjBuf.moveFrom(), resultObj.objsize() );
+            return;
+        }
+
         BufBuilder bufBuilder;
         bufBuilder.skip( sizeof( QueryResult::Value ));
         bufBuilder.appendBuf( reinterpret_cast< void *>(
@@ -41,6 +41,26 @@ namespace {
     // Stage execution will fail once size of all buffered data exceeds this threshold.
     const size_t kDefaultMaxMemUsageBytes = 32 * 1024 * 1024;
 
+    // Bloom filter geometry.  Start at 2^15 bits (4KB) and rebuild at 8x whenever
+    // there are fewer than 8 bits per hashed RecordId; with the two probe bits we
+    // set per key that keeps the false positive rate around 5%, and a false
+    // positive only costs the hash table probe we would have done anyway.
+    const size_t kBloomMinBits = 1 << 15;
+    const size_t kBloomBitsPerEntry = 8;
+
+    // 64-bit finalizer-style mixer.  RecordId reprs are clustered (sequential
+    // inserts get adjacent ids), so spread them over the whole word before we
+    // carve out bit positions.
+    unsigned long long bloomHash(const mongo::RecordId& loc) {
+        unsigned long long h = static_cast<unsigned long long>(loc.repr());
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
 } // namespace
 
 namespace mongo {
@@ -58,6 +78,7 @@ namespace mongo {
         : _collection(collection),
           _ws(ws),
           _filter(filter),
+          _bloomNumBits(0),
           _hashingChildren(true),
           _currentChild(0),
           _commonStats(kStageType),
@@ -71,6 +92,7 @@ namespace mongo {
         : _collection(collection),
           _ws(ws),
           _filter(filter),
+          _bloomNumBits(0),
           _hashingChildren(true),
           _currentChild(0),
           _commonStats(kStageType),
@@ -182,7 +204,7 @@ namespace mongo {
             if (_memUsage > _maxMemUsage) {
                 mongoutils::str::stream ss;
                 ss << "hashed AND stage buffered data usage of " << _memUsage
-                   << " bytes exceeds internal limit of " << kDefaultMaxMemUsageBytes << " bytes";
+                   << " bytes exceeds internal limit of " << _maxMemUsage << " bytes";
                 Status status(ErrorCodes::Overflow, ss);
                 *out = WorkingSetCommon::allocateStatusMember( _ws, status);
                 return PlanStage::FAILURE;
@@ -227,6 +249,14 @@ namespace mongo {
             return PlanStage::NEED_TIME;
         }
 
+        // Most last-child results miss; reject them with two bit tests before
+        // paying for the hash table probe.
+        if (!bloomFilterMayContain(member->loc)) {
+            _ws->free(*out);
+            ++_commonStats.needTime;
+            return PlanStage::NEED_TIME;
+        }
+
         DataMap::iterator it = _dataMap.find(member->loc);
         if (_dataMap.end() == it) {
             // Child's output wasn't in every previous child.  Throw it out.
@@ -290,6 +320,7 @@ namespace mongo {
             verify(_dataMap.end() == _dataMap.find(member->loc));
 
             _dataMap[member->loc] = id;
+            addToBloomFilter(member->loc);
 
             // Update memory stats.
             _memUsage += member->getMemUsage();
@@ -355,7 +386,8 @@ namespace mongo {
             }
 
             verify(member->hasLoc());
-            if (_dataMap.end() == _dataMap.find(member->loc)) {
+            if (!bloomFilterMayContain(member->loc)
+                || _dataMap.end() == _dataMap.find(member->loc)) {
                 // Ignore.  It's not in any previous child.
             }
             else {
@@ -441,6 +473,45 @@ namespace mongo {
         }
     }
 
+    void AndHashStage::addToBloomFilter(const RecordId& loc) {
+        if (!_bloomBits) {
+            _bloomNumBits = kBloomMinBits;
+            _bloomBits.reset(new unsigned long long[_bloomNumBits / 64]);
+            memset(_bloomBits.get(), 0, _bloomNumBits / 8);
+        }
+        else if (_dataMap.size() * kBloomBitsPerEntry > _bloomNumBits) {
+            // Getting too full; rebuild bigger from the map's keys.
+            _bloomNumBits *= 8;
+            _bloomBits.reset(new unsigned long long[_bloomNumBits / 64]);
+            memset(_bloomBits.get(), 0, _bloomNumBits / 8);
+            for (DataMap::const_iterator it = _dataMap.begin(); it != _dataMap.end(); ++it) {
+                setBloomFilterBits(bloomHash(it->first));
+            }
+        }
+
+        setBloomFilterBits(bloomHash(loc));
+    }
+
+    void AndHashStage::setBloomFilterBits(unsigned long long hash) {
+        const size_t bitA = hash & (_bloomNumBits - 1);
+        const size_t bitB = (hash >> 32) & (_bloomNumBits - 1);
+        _bloomBits[bitA / 64] |= 1ULL << (bitA % 64);
+        _bloomBits[bitB / 64] |= 1ULL << (bitB % 64);
+    }
+
+    bool AndHashStage::bloomFilterMayContain(const RecordId& loc) const {
+        if (!_bloomBits) {
+            // Nothing was ever inserted.
+            return false;
+        }
+
+        const unsigned long long hash = bloomHash(loc);
+        const size_t bitA = hash & (_bloomNumBits - 1);
+        const size_t bitB = (hash >> 32) & (_bloomNumBits - 1);
+        return (_bloomBits[bitA / 64] & (1ULL << (bitA % 64)))
+            && (_bloomBits[bitB / 64] & (1ULL << (bitB % 64)));
+    }
+
     void AndHashStage::saveState() {
         ++_commonStats.yields;
 
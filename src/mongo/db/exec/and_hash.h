@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/scoped_array.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <vector>
 
@@ -100,6 +101,15 @@ namespace mongo {
         StageState hashOtherChildren(WorkingSetID* out);
         StageState workChild(size_t childNo, WorkingSetID* out);
 
+        // Bloom filter over the RecordIds hashed from the first child.  Later
+        // children consult it before probing _dataMap, so most probe misses are
+        // rejected by two bit tests instead of a hash table lookup.  Never
+        // returns false for a RecordId in _dataMap; false positives (including
+        // entries later erased from the map) just fall through to the probe.
+        void addToBloomFilter(const RecordId& loc);
+        bool bloomFilterMayContain(const RecordId& loc) const;
+        void setBloomFilterBits(unsigned long long hash);
+
         // Not owned by us.
         const Collection* _collection;
 
@@ -127,6 +137,12 @@ namespace mongo {
         typedef unordered_set<RecordId, RecordId::Hasher> SeenMap;
         SeenMap _seenMap;
 
+        // Bit array backing the bloom filter; the bit count is always a power of
+        // two and grows (with a rebuild from _dataMap's keys) as the first child
+        // produces more results.  Scratch space, not counted towards _memUsage.
+        boost::scoped_array<unsigned long long> _bloomBits;
+        size_t _bloomNumBits;
+
         // True if we're still intersecting _children[0..._children.size()-1].
         bool _hashingChildren;
 
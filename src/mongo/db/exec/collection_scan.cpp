@@ -44,6 +44,12 @@
 
 namespace mongo {
 
+    namespace {
+        // How many records we hand the iterator per readahead hint, and how often we
+        // re-issue the hint. Advisory only; see RecordIterator::willNeed().
+        const int kScanReadaheadBatch = 128;
+    }
+
     // static
     const char* CollectionScan::kStageType = "COLLSCAN";
 
@@ -56,11 +62,18 @@ namespace mongo {
           _filter(filter),
           _params(params),
           _isDead(false),
+          _docsSinceWillNeed(0),
           _wsidForFetch(_workingSet->allocate()),
           _commonStats(kStageType) {
         // Explain reports the direction of the collection scan.
         _specificStats.direction = params.direction;
 
+        // Simple conjunctions of top-level predicates can be evaluated in one pass over
+        // the document's bytes instead of a tree walk per document.
+        if (NULL != _filter) {
+            _compiledFilter.reset(CompiledMatcher::compile(_filter));
+        }
+
         // We pre-allocate a WSM and use it to pass up fetch requests. This should never be used
         // for anything other than passing up NEED_FETCH. We use the loc and owned obj state, but
         // the loc isn't really pointing at any obj. The obj field of the WSM should never be used.
@@ -122,6 +135,15 @@ namespace mongo {
 
         _lastSeenLoc = curr;
 
+        // Periodically tell the iterator how far ahead we intend to read so storage
+        // engines that can start readahead for the upcoming range do so.
+        if (0 == _docsSinceWillNeed) {
+            _iter->willNeed(kScanReadaheadBatch);
+        }
+        if (++_docsSinceWillNeed >= kScanReadaheadBatch) {
+            _docsSinceWillNeed = 0;
+        }
+
         // See if the record we're about to access is in memory. If not, pass a fetch request up.
         // Note that curr() does not touch the record (on MMAPv1 which is the only place we use
         // NEED_FETCH) so we are able to yield before touching the record, as long as we do so
@@ -157,7 +179,15 @@ namespace mongo {
                                                           WorkingSetID* out) {
         ++_specificStats.docsTested;
 
-        if (Filter::passes(member, _filter)) {
+        bool passes;
+        if (NULL != _compiledFilter.get() && member->hasObj()) {
+            passes = _compiledFilter->matches(member->obj);
+        }
+        else {
+            passes = Filter::passes(member, _filter);
+        }
+
+        if (passes) {
             *out = memberID;
             ++_commonStats.advanced;
             return PlanStage::ADVANCED;
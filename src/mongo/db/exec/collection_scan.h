@@ -32,6 +32,7 @@
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/compiled_matcher.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 
@@ -91,6 +92,9 @@ namespace mongo {
         // The filter is not owned by us.
         const MatchExpression* _filter;
 
+        // Set when _filter flattens to a single-pass matcher over raw BSON. NULL otherwise.
+        boost::scoped_ptr<CompiledMatcher> _compiledFilter;
+
         boost::scoped_ptr<RecordIterator> _iter;
 
         CollectionScanParams _params;
@@ -99,6 +103,9 @@ namespace mongo {
 
         RecordId _lastSeenLoc;
 
+        // Counts records returned since the last readahead hint was passed to _iter.
+        int _docsSinceWillNeed;
+
         // We allocate a working set member with this id on construction of the stage. It gets
         // used for all fetch requests, changing the RecordId as appropriate.
         const WorkingSetID _wsidForFetch;
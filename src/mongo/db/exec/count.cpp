@@ -31,11 +31,20 @@
 #include "mongo/db/exec/count.h"
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/exec/count_scan.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 
 namespace mongo {
 
+    namespace {
+        // Minimum collection size before a count tries to partition its index range
+        // across worker threads. We don't know the range's key count up front, so the
+        // collection's record count is the proxy; below this the per-key loop finishes
+        // before the threads would pay for themselves.
+        const long long kPartitionedCountMinRecords = 1000 * 1000;
+    }
+
     // static
     const char* CountStage::kStageType = "COUNT";
 
@@ -48,6 +57,7 @@ namespace mongo {
           _collection(collection),
           _request(request),
           _leftToSkip(request.skip),
+          _triedPartitionedCount(false),
           _ws(ws),
           _child(child),
           _commonStats(kStageType) { }
@@ -55,7 +65,7 @@ namespace mongo {
     CountStage::~CountStage() { }
 
     bool CountStage::isEOF() {
-        if (_specificStats.trivialCount) {
+        if (_specificStats.trivialCount || _specificStats.partitionedCount) {
             return true;
         }
 
@@ -68,8 +78,32 @@ namespace mongo {
 
     void CountStage::trivialCount() {
         invariant(_collection);
-        long long nCounted = _collection->numRecords(_txn);
+        applySkipLimit(_collection->numRecords(_txn));
+        _specificStats.trivialCount = true;
+    }
 
+    bool CountStage::tryPartitionedCount() {
+        // Only worth attempting for a bare CountScan over a large collection; the
+        // scan itself decides whether the range can actually be partitioned.
+        if (NULL == _child.get() || STAGE_COUNT_SCAN != _child->stageType()) {
+            return false;
+        }
+        if (NULL == _collection ||
+            _collection->numRecords(_txn) < kPartitionedCountMinRecords) {
+            return false;
+        }
+
+        long long nScanned = 0;
+        if (!static_cast<CountScan*>(_child.get())->getPartitionedCount(&nScanned)) {
+            return false;
+        }
+
+        applySkipLimit(nScanned);
+        _specificStats.partitionedCount = true;
+        return true;
+    }
+
+    void CountStage::applySkipLimit(long long nCounted) {
         if (0 != _request.skip) {
             nCounted -= _request.skip;
             if (nCounted < 0) {
@@ -88,7 +122,6 @@ namespace mongo {
 
         _specificStats.nCounted = nCounted;
         _specificStats.nSkipped = _request.skip;
-        _specificStats.trivialCount = true;
     }
 
     PlanStage::StageState CountStage::work(WorkingSetID* out) {
@@ -107,6 +140,16 @@ namespace mongo {
             return PlanStage::IS_EOF;
         }
 
+        // A count over a large single-interval index range can be answered in one shot
+        // by partitioning the range across worker threads. Checked once, before the
+        // child has done any work.
+        if (!_triedPartitionedCount) {
+            _triedPartitionedCount = true;
+            if (tryPartitionedCount()) {
+                return PlanStage::IS_EOF;
+            }
+        }
+
         if (isEOF()) {
             _commonStats.isEOF = true;
             return PlanStage::IS_EOF;
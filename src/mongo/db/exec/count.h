@@ -111,6 +111,20 @@ namespace mongo {
          */
         void trivialCount();
 
+        /**
+         * If our child is a CountScan over a large, partitionable index range, counts
+         * the whole range at once on worker threads instead of working the child one
+         * key at a time. Returns true if the count was answered this way; the result
+         * is stored in '_specificStats'.
+         */
+        bool tryPartitionedCount();
+
+        /**
+         * Stores 'nCounted' in '_specificStats' after applying the request's skip and
+         * limit. Shared by the trivial and partitioned bulk count paths.
+         */
+        void applySkipLimit(long long nCounted);
+
         // Transactional context for read locks. Not owned by us.
         OperationContext* _txn;
 
@@ -122,6 +136,10 @@ namespace mongo {
         // The number of documents that we still need to skip.
         long long _leftToSkip;
 
+        // Whether we've already checked for a partitioned count. Checked once, on the
+        // first work() call.
+        bool _triedPartitionedCount;
+
         // The working set used to pass intermediate results between stages. Not owned
         // by us.
         WorkingSet* _ws;
@@ -26,14 +26,78 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
 #include "mongo/db/exec/count_scan.h"
 
+#include <limits>
+
 #include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/global_environment_experiment.h"
 #include "mongo/db/index/index_cursor.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
 
 namespace mongo {
 
+    namespace {
+
+        // How many sub-ranges a partitioned count splits its interval into. One worker
+        // thread per sub-range; past a handful the scan is storage bandwidth bound.
+        const int kCountPartitions = 4;
+
+        /**
+         * Counts the index entries in [startKey, endKey] on its own cursor and recovery
+         * unit. Runs on a worker thread, so it must not touch the stage's transactional
+         * context. The cursor logic mirrors CountScan::initIndexCursor()/checkEnd().
+         */
+        void countKeysInRange(const IndexAccessMethod* iam,
+                              const BSONObj& startKey,
+                              bool startKeyInclusive,
+                              const BSONObj& endKey,
+                              bool endKeyInclusive,
+                              long long* count,
+                              Status* result) {
+            try {
+                OperationContextNoop opCtx(
+                    getGlobalEnvironment()->getGlobalStorageEngine()->newRecoveryUnit());
+
+                CursorOptions cursorOptions;
+                cursorOptions.direction = CursorOptions::INCREASING;
+
+                IndexCursor* rawCursor;
+                Status s = iam->newCursor(&opCtx, cursorOptions, &rawCursor);
+                verify(s.isOK());
+                boost::scoped_ptr<BtreeIndexCursor> cursor(
+                    static_cast<BtreeIndexCursor*>(rawCursor));
+                cursor->seek(startKey, !startKeyInclusive);
+
+                IndexCursor* rawEndCursor;
+                verify(iam->newCursor(&opCtx, cursorOptions, &rawEndCursor).isOK());
+                boost::scoped_ptr<BtreeIndexCursor> endCursor(
+                    static_cast<BtreeIndexCursor*>(rawEndCursor));
+                endCursor->seek(endKey, endKeyInclusive);
+
+                long long n = 0;
+                while (!cursor->isEOF()) {
+                    if (!endCursor->isEOF() && cursor->pointsAt(*endCursor.get())) {
+                        break;
+                    }
+                    ++n;
+                    cursor->next();
+                }
+                *count = n;
+            }
+            catch (const DBException& ex) {
+                *result = ex.toStatus();
+            }
+        }
+
+    }  // namespace
+
     // static
     const char* CountScan::kStageType = "COUNT_SCAN";
 
@@ -102,6 +166,109 @@ namespace mongo {
         }
     }
 
+    bool CountScan::computeSplitPoints(int nRanges, std::vector<BSONObj>* splitPoints) const {
+        // Interior split points can only be synthesized when the scanned interval is a
+        // single field with numeric or date endpoints; anything else (strings, compound
+        // bounds, descending orderings) has no cheap midpoint and keeps the serial path.
+        if (1 != _params.startKey.nFields() || 1 != _params.endKey.nFields()) {
+            return false;
+        }
+
+        BSONElement startElt = _params.startKey.firstElement();
+        BSONElement endElt = _params.endKey.firstElement();
+
+        const bool numeric = startElt.isNumber() && endElt.isNumber();
+        const bool dates = (Date == startElt.type()) && (Date == endElt.type());
+        if (!numeric && !dates) {
+            return false;
+        }
+
+        const double start = numeric ? startElt.number()
+                                     : static_cast<double>(startElt.date().millis);
+        const double end = numeric ? endElt.number()
+                                   : static_cast<double>(endElt.date().millis);
+        if (!(start < end) || std::numeric_limits<double>::infinity() == end - start) {
+            return false;
+        }
+
+        splitPoints->clear();
+        for (int i = 1; i < nRanges; ++i) {
+            const double v = start + (end - start) * i / nRanges;
+            BSONObjBuilder bob;
+            if (numeric) {
+                // A double split key is a valid boundary for int and long entries too;
+                // index key order compares numerics by value, not by type.
+                bob.append("", v);
+            }
+            else {
+                bob.appendDate("", Date_t(static_cast<unsigned long long>(v)));
+            }
+            splitPoints->push_back(bob.obj());
+        }
+        return true;
+    }
+
+    bool CountScan::getPartitionedCount(long long* count) {
+        // Only valid before the first work(); after that the serial cursor owns the scan.
+        invariant(NULL == _btreeCursor.get());
+
+        // The workers read through their own recovery units with no-op lockers, which is
+        // only safe when the storage engine does its own document-level concurrency
+        // control. Each worker sees its own snapshot, so the result has the same
+        // consistency as the serial path counting across yields.
+        if (!supportsDocLocking()) {
+            return false;
+        }
+
+        // Duplicate RecordIds from a multikey index would need dedup across workers.
+        if (_shouldDedup) {
+            return false;
+        }
+
+        std::vector<BSONObj> splitPoints;
+        if (!computeSplitPoints(kCountPartitions, &splitPoints)) {
+            return false;
+        }
+
+        // Partition i covers [splitPoints[i-1], splitPoints[i]), with the scan's own
+        // endpoints (and their inclusiveness) at either end. Equal neighbouring split
+        // points just make an empty partition, which counts zero.
+        const int nRanges = static_cast<int>(splitPoints.size()) + 1;
+        std::vector<long long> counts(nRanges, 0);
+        std::vector<Status> results(nRanges, Status::OK());
+
+        threadpool::ThreadPool pool(nRanges, "PartitionedCount-");
+        for (int i = 0; i < nRanges; ++i) {
+            const BSONObj& lo = (0 == i) ? _params.startKey : splitPoints[i - 1];
+            const bool loInclusive = (0 == i) ? _params.startKeyInclusive : true;
+            const BSONObj& hi = (nRanges - 1 == i) ? _params.endKey : splitPoints[i];
+            const bool hiInclusive = (nRanges - 1 == i) ? _params.endKeyInclusive : false;
+            pool.schedule(stdx::bind(&countKeysInRange,
+                                     _iam,
+                                     lo,
+                                     loInclusive,
+                                     hi,
+                                     hiInclusive,
+                                     &counts[i],
+                                     &results[i]));
+        }
+        pool.join();
+
+        long long total = 0;
+        for (int i = 0; i < nRanges; ++i) {
+            if (!results[i].isOK()) {
+                warning() << "partitioned count worker failed: " << results[i]
+                          << ", falling back to a serial scan";
+                return false;
+            }
+            total += counts[i];
+        }
+
+        _specificStats.keysExamined += total;
+        *count = total;
+        return true;
+    }
+
     PlanStage::StageState CountScan::work(WorkingSetID* out) {
         ++_commonStats.works;
 
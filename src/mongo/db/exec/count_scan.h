@@ -71,6 +71,20 @@ namespace mongo {
         CountScan(OperationContext* txn, const CountScanParams& params, WorkingSet* workingSet);
         virtual ~CountScan() { }
 
+        /**
+         * Attempts to count the entire interval at once by splitting it into sub-ranges
+         * counted on worker threads, each through its own index cursor and recovery
+         * unit, with the per-worker tallies summed into 'count'.
+         *
+         * Returns true on success, in which case the caller must not work() this stage.
+         * Returns false and leaves the stage untouched when the range cannot be
+         * partitioned (multikey index, non-splittable endpoints, storage engine without
+         * document-level locking); the caller then drives the usual serial scan.
+         *
+         * May only be called before the first work().
+         */
+        bool getPartitionedCount(long long* count);
+
         virtual StageState work(WorkingSetID* out);
         virtual bool isEOF();
         virtual void saveState();
@@ -100,6 +114,13 @@ namespace mongo {
          */
         void checkEnd();
 
+        /**
+         * Computes the nRanges - 1 interior split keys for a partitioned count, in
+         * index order. Returns false if the interval's endpoints don't admit cheap
+         * interpolation (only single-field numeric or date endpoints do).
+         */
+        bool computeSplitPoints(int nRanges, std::vector<BSONObj>* splitPoints) const;
+
         // transactional context for read locks. Not owned by us
         OperationContext* _txn;
 
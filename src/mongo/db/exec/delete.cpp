@@ -102,6 +102,24 @@ namespace mongo {
                 }
             }
 
+            // If the caller wants the deleted document back (findAndModify), copy it out
+            // before the delete frees or reuses the record's bytes.
+            BSONObj docToReturn;
+            if (_params.returnDeleted) {
+                if (member->hasObj()) {
+                    docToReturn = member->obj.getOwned();
+                }
+                else if (_collection->findDoc(_txn, rloc, &docToReturn)) {
+                    docToReturn = docToReturn.getOwned();
+                }
+                else {
+                    // Doc is already deleted. Nothing more to do.
+                    _ws->free(id);
+                    ++_commonStats.needTime;
+                    return PlanStage::NEED_TIME;
+                }
+            }
+
             _ws->free(id);
 
             BSONObj deletedDoc;
@@ -144,6 +162,16 @@ namespace mongo {
 
             ++_specificStats.docsDeleted;
 
+            if (_params.returnDeleted) {
+                WorkingSetID retId = _ws->allocate();
+                WorkingSetMember* retMember = _ws->get(retId);
+                retMember->obj = docToReturn;
+                retMember->state = WorkingSetMember::OWNED_OBJ;
+                *out = retId;
+                ++_commonStats.advanced;
+                return PlanStage::ADVANCED;
+            }
+
             ++_commonStats.needTime;
             return PlanStage::NEED_TIME;
         }
@@ -43,7 +43,8 @@ namespace mongo {
             isMulti(false),
             shouldCallLogOp(false),
             fromMigrate(false),
-            isExplain(false) { }
+            isExplain(false),
+            returnDeleted(false) { }
 
         // Should we delete all documents returned from the child (a "multi delete"), or at most one
         // (a "single delete")?
@@ -58,11 +59,15 @@ namespace mongo {
 
         // Are we explaining a delete command rather than actually executing it?
         bool isExplain;
+
+        // Should we return the document we just deleted?
+        bool returnDeleted;
     };
 
     /**
      * This stage delete documents by RecordId that are returned from its child.  NEED_TIME
-     * is returned after deleting a document.
+     * is returned after deleting a document, unless the stage was asked to return the
+     * deleted document (findAndModify), in which case it ADVANCEs with that document.
      *
      * Callers of work() must be holding a write lock (and, for shouldCallLogOp=true deletes,
      * callers must have had the replication coordinator approve the write).
@@ -134,7 +134,40 @@ namespace mongo {
         }
     }
 
+    // Bound on the per-search distance memo - only matters for degenerate searches where
+    // huge numbers of documents straddle interval boundaries.
+    static const size_t kMaxDistanceCacheSize = 10 * 1000;
+
+    /**
+     * Attaches the distance and/or nearest-point metadata requested by the query to the
+     * member.  Split out so that cached distances get the same treatment as freshly
+     * computed ones.
+     */
+    static void addDistanceMetadata(const GeoNearParams& nearParams,
+                                    WorkingSetMember* member,
+                                    double minDistance,
+                                    const BSONObj& minDistanceObj) {
+
+        if (nearParams.addDistMeta) {
+            if (nearParams.nearQuery->unitsAreRadians) {
+                // Hack for nearSphere
+                // TODO: Remove nearSphere?
+                invariant(SPHERE == nearParams.nearQuery->centroid->crs);
+                member->addComputed(new GeoDistanceComputedData(minDistance
+                                                                / kRadiusOfEarthInMeters));
+            }
+            else {
+                member->addComputed(new GeoDistanceComputedData(minDistance));
+            }
+        }
+
+        if (nearParams.addPointMeta) {
+            member->addComputed(new GeoNearPointComputedData(minDistanceObj));
+        }
+    }
+
     static StatusWith<double> computeGeoNearDistance(const GeoNearParams& nearParams,
+                                                     GeoNearDistanceCache* cache,
                                                      WorkingSetMember* member) {
 
         //
@@ -148,6 +181,20 @@ namespace mongo {
 
         CRS queryCRS = nearParams.nearQuery->centroid->crs;
 
+        // Boundary documents are pulled out of the index once per interval they straddle -
+        // reuse the distance computed on the first visit rather than re-parsing the
+        // geometry.
+        if (member->hasLoc()) {
+            GeoNearDistanceCache::Map::const_iterator cacheIt = cache->map.find(member->loc);
+            if (cacheIt != cache->map.end()) {
+                const GeoNearDistanceCache::Entry& entry = cacheIt->second;
+                if (entry.distance >= 0) {
+                    addDistanceMetadata(nearParams, member, entry.distance, entry.minDistanceObj);
+                }
+                return StatusWith<double>(entry.distance);
+            }
+        }
+
         // Extract all the geometries out of this document for the near query
         OwnedPointerVector<StoredGeometry> geometriesOwned;
         vector<StoredGeometry*>& geometries = geometriesOwned.mutableVector();
@@ -181,27 +228,22 @@ namespace mongo {
             }
         }
 
+        if (member->hasLoc()) {
+            if (cache->map.size() >= kMaxDistanceCacheSize) {
+                cache->map.clear();
+            }
+            GeoNearDistanceCache::Entry& entry = cache->map[member->loc];
+            entry.distance = minDistance;
+            // Owned copy - the element points into member->obj, which won't outlive us
+            entry.minDistanceObj = minDistanceObj.getOwned();
+        }
+
         if (minDistance < 0) {
             // No distance to report
             return StatusWith<double>(-1);
         }
 
-        if (nearParams.addDistMeta) {
-            if (nearParams.nearQuery->unitsAreRadians) {
-                // Hack for nearSphere
-                // TODO: Remove nearSphere?
-                invariant(SPHERE == queryCRS);
-                member->addComputed(new GeoDistanceComputedData(minDistance
-                                                                / kRadiusOfEarthInMeters));
-            }
-            else {
-                member->addComputed(new GeoDistanceComputedData(minDistance));
-            }
-        }
-
-        if (nearParams.addPointMeta) {
-            member->addComputed(new GeoNearPointComputedData(minDistanceObj));
-        }
+        addDistanceMetadata(nearParams, member, minDistance, minDistanceObj);
 
         return StatusWith<double>(minDistance);
     }
@@ -810,7 +852,16 @@ namespace mongo {
     }
 
     StatusWith<double> GeoNear2DStage::computeDistance(WorkingSetMember* member) {
-        return computeGeoNearDistance(_nearParams, member);
+        return computeGeoNearDistance(_nearParams, &_distanceCache, member);
+    }
+
+    void GeoNear2DStage::invalidate(OperationContext* txn,
+                                    const RecordId& dl,
+                                    InvalidationType type) {
+        NearStage::invalidate(txn, dl, type);
+
+        // An updated document may have moved, so its remembered distance is no longer valid
+        _distanceCache.map.erase(dl);
     }
 
     //
@@ -1175,7 +1226,16 @@ namespace mongo {
     }
 
     StatusWith<double> GeoNear2DSphereStage::computeDistance(WorkingSetMember* member) {
-        return computeGeoNearDistance(_nearParams, member);
+        return computeGeoNearDistance(_nearParams, &_distanceCache, member);
+    }
+
+    void GeoNear2DSphereStage::invalidate(OperationContext* txn,
+                                          const RecordId& dl,
+                                          InvalidationType type) {
+        NearStage::invalidate(txn, dl, type);
+
+        // An updated document may have moved, so its remembered distance is no longer valid
+        _distanceCache.map.erase(dl);
     }
 
 } // namespace mongo
@@ -38,6 +38,8 @@
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/query/index_bounds.h"
+#include "mongo/db/record_id.h"
+#include "mongo/platform/unordered_map.h"
 
 namespace mongo {
 
@@ -62,6 +64,28 @@ namespace mongo {
         bool addDistMeta;
     };
 
+    /**
+     * Memo of per-document distances computed during a single GeoNear search.
+     *
+     * Consecutive search intervals share their boundary, so a document whose
+     * distance falls near a boundary is pulled out of the index and has its
+     * geometry fully re-parsed once per interval that sees it.  The stored
+     * geometry doesn't change between intervals, so we remember the computed
+     * distance (and the closest geometry element, for point metadata) by
+     * RecordId and skip the parse on later visits.  Entries are evicted on
+     * invalidation since an updated document may have moved.
+     */
+    struct GeoNearDistanceCache {
+
+        struct Entry {
+            double distance;
+            BSONObj minDistanceObj;
+        };
+
+        typedef unordered_map<RecordId, Entry, RecordId::Hasher> Map;
+        Map map;
+    };
+
     /**
      * Implementation of GeoNear on top of a 2D index
      */
@@ -76,6 +100,8 @@ namespace mongo {
 
         virtual ~GeoNear2DStage();
 
+        virtual void invalidate(OperationContext* txn, const RecordId& dl, InvalidationType type);
+
     protected:
 
         virtual StatusWith<CoveredInterval*> nextInterval(OperationContext* txn,
@@ -90,6 +116,9 @@ namespace mongo {
     private:
         const GeoNearParams _nearParams;
 
+        // Distances already computed for documents seen in earlier intervals
+        GeoNearDistanceCache _distanceCache;
+
         // The 2D index we're searching over
         // Not owned here
         IndexDescriptor* const _twoDIndex;
@@ -121,6 +150,8 @@ namespace mongo {
 
         virtual ~GeoNear2DSphereStage();
 
+        virtual void invalidate(OperationContext* txn, const RecordId& dl, InvalidationType type);
+
     protected:
 
         virtual StatusWith<CoveredInterval*> nextInterval(OperationContext* txn,
@@ -135,6 +166,9 @@ namespace mongo {
     private:
         const GeoNearParams _nearParams;
 
+        // Distances already computed for documents seen in earlier intervals
+        GeoNearDistanceCache _distanceCache;
+
         // The 2D index we're searching over
         // Not owned here
         IndexDescriptor* const _s2Index;
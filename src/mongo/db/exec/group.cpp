@@ -120,6 +120,10 @@ namespace mongo {
     }
 
     Status GroupStage::processObject(const BSONObj& obj) {
+        if (_native) {
+            return _native->processObject(obj);
+        }
+
         BSONObj key;
         Status getKeyStatus = getKey(obj, _request.keyPattern, _keyFunction, _scope.get(),
                                      &key);
@@ -148,6 +152,11 @@ namespace mongo {
     }
 
     BSONObj GroupStage::finalizeResults() {
+        if (_native) {
+            _specificStats.nGroups = _native->nGroups();
+            return _native->finalizeResults();
+        }
+
         if (!_request.finalize.empty()) {
             _scope->exec("$finalize = " + _request.finalize, "$group finalize define", false,
                          true, true, 100);
@@ -179,9 +188,15 @@ namespace mongo {
 
         if (isEOF()) { return PlanStage::IS_EOF; }
 
-        // On the first call to work(), call initGroupScripting().
+        // On the first call to work(), set up either native reduce execution or the
+        // Javascript machinery.
         if (_groupState == GroupState_Initializing) {
-            initGroupScripting();
+            if (_request.allowNativeReduce) {
+                _native.reset(NativeGroupReduce::make(_request));
+            }
+            if (!_native) {
+                initGroupScripting();
+            }
             _groupState = GroupState_ReadingFromChild;
             ++_commonStats.needTime;
             return PlanStage::NEED_TIME;
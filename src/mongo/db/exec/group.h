@@ -30,6 +30,7 @@
 
 #include <boost/scoped_ptr.hpp>
 
+#include "mongo/db/exec/group_native.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/scripting/engine.h"
 
@@ -68,6 +69,11 @@ namespace mongo {
         // A Javascript function that "finalizes" a group result.  Optional.
         std::string finalize;
 
+        // Whether a reduce function matching a known pattern may be executed natively,
+        // without Javascript. The group command clears this and retries when the
+        // native path meets a value it cannot mirror exactly.
+        bool allowNativeReduce;
+
         // Whether this is an explain of a group.
         bool explain;
     };
@@ -149,6 +155,11 @@ namespace mongo {
         // Current state for this stage.
         GroupState _groupState;
 
+        // Native execution of the reduce function, when its source matches a pattern
+        // NativeGroupReduce can run without Javascript. NULL when the scripting path
+        // is in use.
+        boost::scoped_ptr<NativeGroupReduce> _native;
+
         // The Scope object that all script operations for this group stage will use.  Initialized
         // by initGroupScripting().  Owned here.
         std::auto_ptr<Scope> _scope;
@@ -0,0 +1,375 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/group_native.h"
+
+#include <limits>
+#include <pcrecpp.h>
+#include <set>
+
+#include "mongo/db/exec/group.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    namespace {
+
+        std::string trimWhitespace(const std::string& s) {
+            const size_t begin = s.find_first_not_of(" \t\r\n");
+            if (std::string::npos == begin) {
+                return std::string();
+            }
+            const size_t end = s.find_last_not_of(" \t\r\n");
+            return s.substr(begin, end - begin + 1);
+        }
+
+    }  // namespace
+
+    NativeGroupReduce::NativeGroupReduce(const BSONObj& keyPattern,
+                                         const BSONObj& initial,
+                                         const std::vector<Op>& ops)
+        : _keyPattern(keyPattern),
+          _initial(initial),
+          _ops(ops) {}
+
+    // static
+    bool NativeGroupReduce::parseReduce(const std::string& code, std::vector<Op>* ops) {
+        std::string objVar, prevVar, body;
+        pcrecpp::RE headerRe("\\s*function\\s*\\(\\s*(\\w+)\\s*,\\s*(\\w+)\\s*\\)\\s*"
+                             "\\{(.*)\\}\\s*",
+                             pcrecpp::DOTALL());
+        if (!headerRe.FullMatch(code, &objVar, &prevVar, &body)) {
+            return false;
+        }
+
+        // The accepted grammar has no braces of its own (an if body with braces is the
+        // same statement without them), so strip braces before splitting on ';'.
+        // Anything that actually needed its braces won't match any pattern below and
+        // gets the whole function rejected.
+        std::string stripped;
+        for (size_t i = 0; i < body.size(); i++) {
+            if ('{' != body[i] && '}' != body[i]) {
+                stripped += body[i];
+            }
+        }
+
+        const std::string obj = pcrecpp::RE::QuoteMeta(objVar);
+        const std::string prev = pcrecpp::RE::QuoteMeta(prevVar);
+
+        // prev.f++ / ++prev.f / prev.f += 1
+        pcrecpp::RE countPost(prev + "\\.(\\w+)\\s*\\+\\+");
+        pcrecpp::RE countPre("\\+\\+\\s*" + prev + "\\.(\\w+)");
+        pcrecpp::RE countAdd(prev + "\\.(\\w+)\\s*\\+=\\s*1(?:\\.0)?");
+        // prev.f += obj.x
+        pcrecpp::RE sum(prev + "\\.(\\w+)\\s*\\+=\\s*" + obj + "\\.(\\w+)");
+        // if (obj.x < prev.f) prev.f = obj.x, with either operand order
+        pcrecpp::RE minObjFirst("if\\s*\\(\\s*" + obj + "\\.(\\w+)\\s*<\\s*" + prev +
+                                "\\.(\\w+)\\s*\\)\\s*" + prev + "\\.(\\w+)\\s*=\\s*" + obj +
+                                "\\.(\\w+)\\s*");
+        pcrecpp::RE minPrevFirst("if\\s*\\(\\s*" + prev + "\\.(\\w+)\\s*>\\s*" + obj +
+                                 "\\.(\\w+)\\s*\\)\\s*" + prev + "\\.(\\w+)\\s*=\\s*" + obj +
+                                 "\\.(\\w+)\\s*");
+        // if (obj.x > prev.f) prev.f = obj.x, with either operand order
+        pcrecpp::RE maxObjFirst("if\\s*\\(\\s*" + obj + "\\.(\\w+)\\s*>\\s*" + prev +
+                                "\\.(\\w+)\\s*\\)\\s*" + prev + "\\.(\\w+)\\s*=\\s*" + obj +
+                                "\\.(\\w+)\\s*");
+        pcrecpp::RE maxPrevFirst("if\\s*\\(\\s*" + prev + "\\.(\\w+)\\s*<\\s*" + obj +
+                                 "\\.(\\w+)\\s*\\)\\s*" + prev + "\\.(\\w+)\\s*=\\s*" + obj +
+                                 "\\.(\\w+)\\s*");
+        // prev.f.push(obj.x)
+        pcrecpp::RE push(prev + "\\.(\\w+)\\s*\\.\\s*push\\s*\\(\\s*" + obj +
+                         "\\.(\\w+)\\s*\\)");
+
+        ops->clear();
+
+        size_t pos = 0;
+        while (pos <= stripped.size()) {
+            size_t next = stripped.find(';', pos);
+            if (std::string::npos == next) {
+                next = stripped.size();
+            }
+            const std::string stmt = trimWhitespace(stripped.substr(pos, next - pos));
+            pos = next + 1;
+            if (stmt.empty()) {
+                continue;
+            }
+
+            Op op;
+            std::string f, x, f2, x2;
+            if (countPost.FullMatch(stmt, &f) ||
+                countPre.FullMatch(stmt, &f) ||
+                countAdd.FullMatch(stmt, &f)) {
+                op.type = Op::COUNT;
+                op.resultField = f;
+            }
+            else if (sum.FullMatch(stmt, &f, &x)) {
+                op.type = Op::SUM;
+                op.resultField = f;
+                op.objField = x;
+            }
+            else if (minObjFirst.FullMatch(stmt, &x, &f, &f2, &x2) ||
+                     maxPrevFirst.FullMatch(stmt, &f, &x, &f2, &x2)) {
+                if (f != f2 || x != x2) {
+                    return false;
+                }
+                op.type = Op::MIN;
+                op.resultField = f;
+                op.objField = x;
+            }
+            else if (maxObjFirst.FullMatch(stmt, &x, &f, &f2, &x2) ||
+                     minPrevFirst.FullMatch(stmt, &f, &x, &f2, &x2)) {
+                if (f != f2 || x != x2) {
+                    return false;
+                }
+                op.type = Op::MAX;
+                op.resultField = f;
+                op.objField = x;
+            }
+            else if (push.FullMatch(stmt, &f, &x)) {
+                op.type = Op::PUSH;
+                op.resultField = f;
+                op.objField = x;
+            }
+            else {
+                // A statement outside the recognized patterns; the whole function has
+                // to go through the scripting engine.
+                return false;
+            }
+
+            ops->push_back(op);
+        }
+
+        return !ops->empty();
+    }
+
+    // static
+    NativeGroupReduce* NativeGroupReduce::make(const GroupRequest& request) {
+        // A key function or finalizer is arbitrary Javascript; leave those alone. A
+        // reduce scope could rebind names the patterns assume are plain, so require
+        // none.
+        if (!request.keyFunctionCode.empty() ||
+            !request.finalize.empty() ||
+            !request.reduceScope.isEmpty()) {
+            return NULL;
+        }
+
+        std::vector<Op> ops;
+        if (!parseReduce(request.reduceCode, &ops)) {
+            return NULL;
+        }
+
+        // The accumulated fields must start from 'initial' the way Javascript's
+        // Object.extend sets them up, with values the accumulators can take over.
+        std::set<std::string> accumulatedFields;
+        for (size_t i = 0; i < ops.size(); i++) {
+            const Op& op = ops[i];
+            if (!accumulatedFields.insert(op.resultField).second) {
+                // Two statements fold into the same field; too clever for us.
+                return NULL;
+            }
+            if (request.keyPattern.hasField(op.resultField)) {
+                // The initial value would overwrite the key field; keep Javascript's
+                // extend semantics by not translating.
+                return NULL;
+            }
+            BSONElement init = request.initial.getField(op.resultField);
+            if (Op::PUSH == op.type) {
+                if (Array != init.type()) {
+                    return NULL;
+                }
+            }
+            else if (!init.isNumber()) {
+                return NULL;
+            }
+        }
+
+        return new NativeGroupReduce(request.keyPattern, request.initial, ops);
+    }
+
+    NativeGroupReduce::Group* NativeGroupReduce::getGroup(const BSONObj& key,
+                                                          Status* status) {
+        std::map<BSONObj, size_t, BSONObjCmp>::const_iterator it = _groupIndex.find(key);
+        if (it != _groupIndex.end()) {
+            return &_groups[it->second];
+        }
+
+        if (_groups.size() >= 20000) {
+            *status = Status(ErrorCodes::BadValue,
+                             "group() can't handle more than 20000 unique keys");
+            return NULL;
+        }
+
+        Group group;
+        group.key = key;
+        for (size_t i = 0; i < _ops.size(); i++) {
+            const Op& op = _ops[i];
+            const BSONElement init = _initial.getField(op.resultField);
+            boost::intrusive_ptr<Accumulator> acc;
+            switch (op.type) {
+            case Op::COUNT:
+            case Op::SUM:
+                acc = AccumulatorSum::create();
+                // Start from the initial value, in doubles, as Javascript would.
+                acc->process(Value(init.numberDouble()), false);
+                break;
+            case Op::MIN:
+                acc = AccumulatorMinMax::createMin();
+                acc->process(Value(init.numberDouble()), false);
+                break;
+            case Op::MAX:
+                acc = AccumulatorMinMax::createMax();
+                acc->process(Value(init.numberDouble()), false);
+                break;
+            case Op::PUSH: {
+                acc = AccumulatorPush::create();
+                BSONObjIterator arrIt(init.Obj());
+                while (arrIt.more()) {
+                    acc->process(Value(arrIt.next()), false);
+                }
+                break;
+            }
+            }
+            group.accumulators.push_back(acc);
+            group.poisoned.push_back(false);
+        }
+
+        _groupIndex[key] = _groups.size();
+        _groups.push_back(group);
+        return &_groups.back();
+    }
+
+    Status NativeGroupReduce::processObject(const BSONObj& obj) {
+        const BSONObj key = obj.extractFields(_keyPattern, true).getOwned();
+
+        Status status = Status::OK();
+        Group* group = getGroup(key, &status);
+        if (NULL == group) {
+            return status;
+        }
+
+        for (size_t i = 0; i < _ops.size(); i++) {
+            const Op& op = _ops[i];
+            if (Op::COUNT == op.type) {
+                group->accumulators[i]->process(Value(1.0), false);
+                continue;
+            }
+
+            const BSONElement elt = obj.getField(op.objField);
+            const bool missing = elt.eoo() || Undefined == elt.type();
+
+            switch (op.type) {
+            case Op::SUM:
+                if (missing) {
+                    // Javascript: adding undefined poisons the total to NaN.
+                    group->poisoned[i] = true;
+                }
+                else if (!elt.isNumber()) {
+                    return Status(ErrorCodes::NativeReduceFallback,
+                                  str::stream() << "non-numeric value for field '"
+                                                << op.objField
+                                                << "' flowing into a native group sum");
+                }
+                else if (!group->poisoned[i]) {
+                    group->accumulators[i]->process(Value(elt.numberDouble()), false);
+                }
+                break;
+            case Op::MIN:
+            case Op::MAX:
+                if (missing) {
+                    // Javascript: any comparison against undefined is false; skip.
+                    break;
+                }
+                if (!elt.isNumber()) {
+                    return Status(ErrorCodes::NativeReduceFallback,
+                                  str::stream() << "non-numeric value for field '"
+                                                << op.objField
+                                                << "' flowing into a native group "
+                                                << (Op::MIN == op.type ? "min" : "max"));
+                }
+                group->accumulators[i]->process(Value(elt.numberDouble()), false);
+                break;
+            case Op::PUSH:
+                if (missing) {
+                    return Status(ErrorCodes::NativeReduceFallback,
+                                  str::stream() << "missing value for field '"
+                                                << op.objField
+                                                << "' flowing into a native group push");
+                }
+                group->accumulators[i]->process(Value(elt), false);
+                break;
+            case Op::COUNT:
+                break;  // handled above
+            }
+        }
+
+        return Status::OK();
+    }
+
+    BSONObj NativeGroupReduce::finalizeResults() const {
+        BSONArrayBuilder arr;
+        for (size_t g = 0; g < _groups.size(); g++) {
+            const Group& group = _groups[g];
+            BSONObjBuilder b(arr.subobjStart());
+
+            // Mirror the Javascript result layout: the key's fields first, then the
+            // fields of 'initial' with the accumulated results substituted in.
+            b.appendElements(group.key);
+
+            BSONObjIterator it(_initial);
+            while (it.more()) {
+                const BSONElement elt = it.next();
+
+                size_t opIdx = _ops.size();
+                for (size_t i = 0; i < _ops.size(); i++) {
+                    if (_ops[i].resultField == elt.fieldName()) {
+                        opIdx = i;
+                        break;
+                    }
+                }
+
+                if (opIdx == _ops.size()) {
+                    // An initial field no statement touches passes through unchanged.
+                    b.append(elt);
+                }
+                else if (group.poisoned[opIdx]) {
+                    b.append(elt.fieldName(), std::numeric_limits<double>::quiet_NaN());
+                }
+                else {
+                    group.accumulators[opIdx]->getValue(false).addToBsonObj(
+                        &b, elt.fieldName());
+                }
+            }
+            b.done();
+        }
+        return arr.arr();
+    }
+
+}  // namespace mongo
@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/intrusive_ptr.hpp>
+
+#include "mongo/base/status.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/pipeline/accumulator.h"
+
+namespace mongo {
+
+    struct GroupRequest;
+
+    /**
+     * Native (non-Javascript) execution of a group command's reduce function.
+     *
+     * Most group reduce functions seen in the wild are one of a handful of patterns:
+     * counting, summing a field, taking a min or max, or collecting values into an
+     * array. Running those through the scripting engine costs a Javascript invocation
+     * per document. This class recognizes the patterns in the reduce function's source
+     * and executes them on the aggregation framework's Accumulators instead, keeping
+     * Javascript for reduce functions it cannot prove equivalent.
+     *
+     * The translation only engages when it can reproduce the Javascript result exactly:
+     * no $keyf, no finalizer, accumulated fields present in 'initial' with numeric
+     * starting values (an empty array for push), and numeric document values.
+     * Arithmetic is carried out in doubles, as Javascript's is. If a document carries
+     * a value the native path cannot mirror (say, a string flowing into a sum),
+     * processObject() fails with ErrorCodes::NativeReduceFallback and the group
+     * command re-runs the whole operation through the Javascript path.
+     */
+    class NativeGroupReduce {
+    public:
+        /**
+         * Returns a ready-to-use NativeGroupReduce if 'request' can be executed
+         * natively, or NULL if it must go through the scripting engine. Caller owns
+         * the result.
+         */
+        static NativeGroupReduce* make(const GroupRequest& request);
+
+        /**
+         * Folds 'obj' into its group. Returns ErrorCodes::NativeReduceFallback when
+         * the document holds a value whose Javascript semantics the native path can't
+         * reproduce; the caller should then retry the operation with the native path
+         * disabled.
+         */
+        Status processObject(const BSONObj& obj);
+
+        /**
+         * Builds the results array, one document per group in first-seen order, the
+         * same order the Javascript path produces.
+         */
+        BSONObj finalizeResults() const;
+
+        size_t nGroups() const { return _groups.size(); }
+
+    private:
+        struct Op {
+            enum Type {
+                COUNT,  // prev.f++ / ++prev.f / prev.f += 1
+                SUM,    // prev.f += obj.x
+                MIN,    // if (obj.x < prev.f) prev.f = obj.x
+                MAX,    // if (obj.x > prev.f) prev.f = obj.x
+                PUSH    // prev.f.push(obj.x)
+            };
+
+            Type type;
+
+            // The accumulated field in the result ('f' above).
+            std::string resultField;
+
+            // The document field being accumulated ('x' above). Empty for COUNT.
+            std::string objField;
+        };
+
+        // One group's accumulators, parallel to '_ops'.
+        struct Group {
+            BSONObj key;
+            std::vector<boost::intrusive_ptr<Accumulator> > accumulators;
+
+            // A sum whose field was missing from some document is NaN in Javascript
+            // (undefined propagates through +=). Tracked per op, parallel to
+            // 'accumulators'.
+            std::vector<bool> poisoned;
+        };
+
+        NativeGroupReduce(const BSONObj& keyPattern,
+                          const BSONObj& initial,
+                          const std::vector<Op>& ops);
+
+        /**
+         * Parses 'code' (the reduce function's source) into '*ops'. Returns false if
+         * any statement falls outside the recognized patterns.
+         */
+        static bool parseReduce(const std::string& code, std::vector<Op>* ops);
+
+        Group* getGroup(const BSONObj& key, Status* status);
+
+        const BSONObj _keyPattern;
+        const BSONObj _initial;
+        const std::vector<Op> _ops;
+
+        // Groups in first-seen order, plus an index for key lookup.
+        std::vector<Group> _groups;
+        std::map<BSONObj, size_t, BSONObjCmp> _groupIndex;
+    };
+
+}  // namespace mongo
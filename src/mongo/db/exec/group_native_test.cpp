@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * This file contains tests for mongo/db/exec/group_native.cpp
+ */
+
+#include <boost/scoped_ptr.hpp>
+
+#include "mongo/db/exec/group.h"
+#include "mongo/db/exec/group_native.h"
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+
+using namespace mongo;
+
+namespace {
+
+    using boost::scoped_ptr;
+
+    GroupRequest makeRequest(const char* keyPattern,
+                             const char* initial,
+                             const std::string& reduceCode) {
+        GroupRequest request;
+        request.ns = "unittests.group_native";
+        request.keyPattern = fromjson(keyPattern);
+        request.initial = fromjson(initial);
+        request.reduceCode = reduceCode;
+        request.allowNativeReduce = true;
+        request.explain = false;
+        return request;
+    }
+
+    TEST(GroupNativeTest, RecognizesCommonPatterns) {
+        GroupRequest request = makeRequest(
+            "{a: 1}",
+            "{count: 0, total: 0, lo: 100, hi: 0, vals: []}",
+            "function(obj, prev) {"
+            "  prev.count++;"
+            "  prev.total += obj.x;"
+            "  if (obj.x < prev.lo) prev.lo = obj.x;"
+            "  if (obj.x > prev.hi) prev.hi = obj.x;"
+            "  prev.vals.push(obj.x);"
+            "}");
+        scoped_ptr<NativeGroupReduce> native(NativeGroupReduce::make(request));
+        ASSERT(NULL != native.get());
+
+        ASSERT_OK(native->processObject(fromjson("{a: 1, x: 5}")));
+        ASSERT_OK(native->processObject(fromjson("{a: 1, x: 3}")));
+        ASSERT_OK(native->processObject(fromjson("{a: 2, x: 7}")));
+        ASSERT_EQUALS(2U, native->nGroups());
+
+        BSONObj results = native->finalizeResults();
+        ASSERT_EQUALS(fromjson("[{a: 1, count: 2, total: 8, lo: 3, hi: 5, vals: [5, 3]},"
+                               " {a: 2, count: 1, total: 7, lo: 7, hi: 7, vals: [7]}]"),
+                      results);
+    }
+
+    TEST(GroupNativeTest, RejectsIrreducibleFunctions) {
+        // An arbitrary reduce body has to go through the scripting engine.
+        GroupRequest request = makeRequest(
+            "{a: 1}", "{total: 0}",
+            "function(obj, prev) { prev.total += obj.x * obj.y; }");
+        scoped_ptr<NativeGroupReduce> native(NativeGroupReduce::make(request));
+        ASSERT(NULL == native.get());
+
+        // So does a finalizer, even with a recognized reduce.
+        request = makeRequest("{a: 1}", "{total: 0}",
+                              "function(obj, prev) { prev.total += obj.x; }");
+        request.finalize = "function(out) { out.total = -out.total; }";
+        native.reset(NativeGroupReduce::make(request));
+        ASSERT(NULL == native.get());
+
+        // And an accumulated field that doesn't start from a number in 'initial'.
+        request = makeRequest("{a: 1}", "{total: 'zero'}",
+                              "function(obj, prev) { prev.total += obj.x; }");
+        native.reset(NativeGroupReduce::make(request));
+        ASSERT(NULL == native.get());
+    }
+
+    TEST(GroupNativeTest, MissingFieldPoisonsSumButNotMinMax) {
+        GroupRequest request = makeRequest(
+            "{a: 1}", "{total: 0, lo: 100}",
+            "function(obj, prev) {"
+            "  prev.total += obj.x;"
+            "  if (obj.x < prev.lo) prev.lo = obj.x;"
+            "}");
+        scoped_ptr<NativeGroupReduce> native(NativeGroupReduce::make(request));
+        ASSERT(NULL != native.get());
+
+        ASSERT_OK(native->processObject(fromjson("{a: 1, x: 5}")));
+        ASSERT_OK(native->processObject(fromjson("{a: 1}")));
+
+        BSONObj results = native->finalizeResults();
+        BSONObj group = results.firstElement().Obj();
+        // Javascript's undefined += makes the sum NaN, but the comparison just skips.
+        const double total = group["total"].numberDouble();
+        ASSERT(total != total);  // only NaN is unequal to itself
+        ASSERT_EQUALS(5, group["lo"].numberInt());
+    }
+
+    TEST(GroupNativeTest, FallsBackOnValuesItCannotMirror) {
+        GroupRequest request = makeRequest(
+            "{a: 1}", "{total: 0}",
+            "function(obj, prev) { prev.total += obj.x; }");
+        scoped_ptr<NativeGroupReduce> native(NativeGroupReduce::make(request));
+        ASSERT(NULL != native.get());
+
+        ASSERT_OK(native->processObject(fromjson("{a: 1, x: 5}")));
+
+        // Javascript would concatenate; the native path asks for a retry instead.
+        Status status = native->processObject(fromjson("{a: 1, x: 'five'}"));
+        ASSERT_EQUALS(ErrorCodes::NativeReduceFallback, status.code());
+    }
+
+}  // namespace
@@ -45,11 +45,13 @@ namespace mongo {
     const char* IDHackStage::kStageType = "IDHACK";
 
     IDHackStage::IDHackStage(OperationContext* txn, const Collection* collection,
-                             CanonicalQuery* query, WorkingSet* ws)
+                             CanonicalQuery* query, WorkingSet* ws,
+                             const IndexDescriptor* descriptor)
         : _txn(txn),
           _collection(collection),
+          _descriptor(descriptor),
           _workingSet(ws),
-          _key(query->getQueryObj()["_id"].wrap()),
+          _key(query->getQueryObj()[descriptor->keyPattern().firstElementFieldName()].wrap()),
           _done(false),
           _idBeingPagedIn(WorkingSet::INVALID_ID),
           _commonStats(kStageType) {
@@ -65,6 +67,7 @@ namespace mongo {
                              const BSONObj& key, WorkingSet* ws)
         : _txn(txn),
           _collection(collection),
+          _descriptor(NULL),
           _workingSet(ws),
           _key(key),
           _done(false),
@@ -102,19 +105,22 @@ namespace mongo {
             return advance(id, member, out);
         }
 
-        // Use the index catalog to get the id index.
+        // Use the index catalog to get the index.
         const IndexCatalog* catalog = _collection->getIndexCatalog();
 
-        // Find the index we use.
-        IndexDescriptor* idDesc = catalog->findIdIndex(_txn);
-        if (NULL == idDesc) {
+        // Find the index we use.  If we weren't given one, use the id index.
+        const IndexDescriptor* desc = _descriptor;
+        if (NULL == desc) {
+            desc = catalog->findIdIndex(_txn);
+        }
+        if (NULL == desc) {
             _done = true;
             return PlanStage::IS_EOF;
         }
 
         // This may not be valid always.  See SERVER-12397.
         const BtreeBasedAccessMethod* accessMethod =
-            static_cast<const BtreeBasedAccessMethod*>(catalog->getIndex(idDesc));
+            static_cast<const BtreeBasedAccessMethod*>(catalog->getIndex(desc));
 
         // Look up the key by going directly to the Btree.
         RecordId loc = accessMethod->findSingle(_txn, _key);
@@ -158,7 +164,8 @@ namespace mongo {
 
         if (_addKeyMetadata) {
             BSONObjBuilder bob;
-            BSONObj ownedKeyObj = member->obj["_id"].wrap().getOwned();
+            BSONObj ownedKeyObj =
+                member->obj.getFieldDotted(_key.firstElementFieldName()).wrap().getOwned();
             bob.appendKeys(_key, ownedKeyObj);
             member->addComputed(new IndexKeyComputedData(bob.obj()));
         }
@@ -37,13 +37,19 @@ namespace mongo {
 
     /**
      * A standalone stage implementing the fast path for key-value retrievals
-     * via the _id index.
+     * via the _id index, or via any other single-field unique index.
      */
     class IDHackStage : public PlanStage {
     public:
-        /** Takes ownership of all the arguments -collection. */
+        /**
+         * Takes ownership of all the arguments -collection.
+         *
+         * 'descriptor' is the single-field unique index to look in and must outlive this
+         * stage.
+         */
         IDHackStage(OperationContext* txn, const Collection* collection,
-                    CanonicalQuery* query, WorkingSet* ws);
+                    CanonicalQuery* query, WorkingSet* ws,
+                    const IndexDescriptor* descriptor);
 
         IDHackStage(OperationContext* txn, Collection* collection,
                     const BSONObj& key, WorkingSet* ws);
@@ -88,10 +94,13 @@ namespace mongo {
         // Not owned here.
         const Collection* _collection;
 
+        // The index to look in, or NULL for the _id index.  Not owned here.
+        const IndexDescriptor* _descriptor;
+
         // The WorkingSet we annotate with results.  Not owned by us.
         WorkingSet* _workingSet;
 
-        // The value to match against the _id field.
+        // The value to match against the indexed field.
         BSONObj _key;
 
         // Have we returned our one document?
@@ -54,6 +54,9 @@ namespace mongo {
     // static
     const char* IndexScan::kStageType = "IXSCAN";
 
+    // static
+    const size_t IndexScan::kIndexKeyBatchSize = 64;
+
     IndexScan::IndexScan(OperationContext* txn,
                          const IndexScanParams& params,
                          WorkingSet* workingSet,
@@ -63,6 +66,7 @@ namespace mongo {
           _scanState(INITIALIZING),
           _filter(filter),
           _shouldDedup(true),
+          _batchPos(0),
           _params(params),
           _btreeCursor(NULL),
           _commonStats(kStageType) {
@@ -168,11 +172,21 @@ namespace mongo {
 
         if (GETTING_NEXT == _scanState) {
             // Grab the next (key, value) from the index.
-            BSONObj keyObj = _indexCursor->getKey();
-            RecordId loc = _indexCursor->getValue();
+            const bool fromBatch = _batchPos < _batch.size();
+            BSONObj keyObj;
+            RecordId loc;
+            if (fromBatch) {
+                // Batched entries were copied out of the index when the batch was filled.
+                keyObj = _batch[_batchPos].key;
+                loc = _batch[_batchPos].loc;
+            }
+            else {
+                keyObj = _indexCursor->getKey();
+                loc = _indexCursor->getValue();
+            }
 
             bool filterPasses = Filter::passes(keyObj, _keyPattern, _filter);
-            if ( filterPasses ) {
+            if ( filterPasses && !fromBatch ) {
                 // We must make a copy of the on-disk data since it can mutate during the execution
                 // of this query.
                 keyObj = keyObj.getOwned();
@@ -182,7 +196,12 @@ namespace mongo {
             // The underlying IndexCursor points at the *next* thing we want to return.  We do this
             // so that if we're scanning an index looking for docs to delete we don't continually
             // clobber the thing we're pointing at.
-            _indexCursor->next();
+            if (fromBatch) {
+                ++_batchPos;
+            }
+            else {
+                _indexCursor->next();
+            }
             _scanState = CHECKING_END;
 
             if (_shouldDedup) {
@@ -238,7 +257,13 @@ namespace mongo {
             }
         }
 
-        return HIT_END == _scanState || _indexCursor->isEOF();
+        if (HIT_END == _scanState) {
+            return true;
+        }
+
+        // Entries we pulled from the cursor in bulk but have not returned yet keep us alive
+        // even if the cursor itself has run off the end of the index.
+        return _batchPos == _batch.size() && _indexCursor->isEOF();
     }
 
     void IndexScan::saveState() {
@@ -262,11 +287,18 @@ namespace mongo {
 
         // We can have a valid position before we check isEOF(), restore the position, and then be
         // EOF upon restore.
-        if (!_indexCursor->restorePosition( opCtx ).isOK() || _indexCursor->isEOF()) {
+        if (!_indexCursor->restorePosition( opCtx ).isOK()
+            || (_indexCursor->isEOF() && _batchPos == _batch.size())) {
             _scanState = HIT_END;
             return;
         }
 
+        if (_indexCursor->isEOF()) {
+            // We still have batched entries to return; the cursor only marks where the next
+            // batch would start.
+            return;
+        }
+
         if (!_savedKey.binaryEqual(_indexCursor->getKey())
             || _savedLoc != _indexCursor->getValue()) {
             // Our restored position isn't the same as the saved position.  When we call work()
@@ -287,6 +319,16 @@ namespace mongo {
             return;
         }
 
+        // Drop any batched entries for this RecordId that we haven't returned yet.  The
+        // underlying cursor has already moved past them, so it won't skip them for us.
+        for (size_t i = _batch.size(); i > _batchPos; ) {
+            --i;
+            if (_batch[i].loc == dl) {
+                ++_specificStats.seenInvalidated;
+                _batch.erase(_batch.begin() + i);
+            }
+        }
+
         // If we see this RecordId again, it may not be the same document it was before, so we want
         // to return it if we see it again.
         unordered_set<RecordId, RecordId::Hasher>::iterator it = _returned.find(dl);
@@ -303,16 +345,28 @@ namespace mongo {
         }
 
         if (_params.bounds.isSimpleRange) {
-            _scanState = GETTING_NEXT;
-
             // "Normal" start -> end scanning.
             verify(NULL == _btreeCursor);
             verify(NULL == _checker.get());
 
+            // Refill the batch if we've drained the last one.  isEOF() above guarantees the
+            // cursor still has entries to give us.
+            if (_batchPos == _batch.size()) {
+                _batch.clear();
+                _batchPos = 0;
+                _indexCursor->nextBatch(&_batch, kIndexKeyBatchSize);
+                if (_batch.empty()) {
+                    _scanState = HIT_END;
+                    return;
+                }
+            }
+
+            _scanState = GETTING_NEXT;
+
             // If there is an empty endKey we will scan until we run out of index to scan over.
             if (_params.bounds.endKey.isEmpty()) { return; }
 
-            int cmp = sgn(_params.bounds.endKey.woCompare(_indexCursor->getKey(), _keyPattern));
+            int cmp = sgn(_params.bounds.endKey.woCompare(_batch[_batchPos].key, _keyPattern));
 
             if ((cmp != 0 && cmp != _params.direction)
                 || (cmp == 0 && !_params.bounds.endKeyInclusive)) {
@@ -162,6 +162,14 @@ namespace mongo {
         BSONObj _savedKey;
         RecordId _savedLoc;
 
+        // Batch of (key, RecordId) pairs pulled from the index cursor in bulk.  Only used
+        // for simple range scans, where it amortizes the per-key cursor dispatch over
+        // kIndexKeyBatchSize keys.  Entries in [_batchPos, _batch.size()) have not been
+        // returned yet; their keys are owned copies.
+        static const size_t kIndexKeyBatchSize;
+        std::vector<IndexKeyEntry> _batch;
+        size_t _batchPos;
+
         IndexScanParams _params;
 
         // For our "fast" Btree-only navigation AKA the index bounds optimization.
@@ -44,8 +44,8 @@ namespace mongo {
         : _collection(collection),
           _ws(ws),
           _pattern(params.pattern),
+          _ordering(Ordering::make(params.pattern)),
           _dedup(params.dedup),
-          _merging(StageWithValueComparison(ws, params.pattern)),
           _commonStats(kStageType) { }
 
     MergeSortStage::~MergeSortStage() {
@@ -121,6 +121,10 @@ namespace mongo {
                 value.stage = child;
                 _mergingData.push_front(value);
 
+                // Memoize the sort key now so that every heap comparison involving this
+                // result is a memcmp rather than a walk of the pattern's fields.
+                _mergingData.front().key = makeSortKey(id);
+
                 // Insert the result (indirectly) into our priority queue.
                 _merging.push(_mergingData.begin());
 
@@ -227,33 +231,31 @@ namespace mongo {
 
     // Is lhs less than rhs?  Note that priority_queue is a max heap by default so we invert
     // the return from the expected value.
+    //
+    // The sort keys are pre-encoded as KeyStrings with the pattern's directions applied,
+    // so this is a single memcmp.  Returning 'false' for equivalent keys satisfies the
+    // irreflexivity requirement of a strict weak ordering.
     bool MergeSortStage::StageWithValueComparison::operator()(
         const MergingRef& lhs, const MergingRef& rhs) {
+        return lhs->key.compare(rhs->key) > 0;
+    }
 
-        WorkingSetMember* lhsMember = _ws->get(lhs->id);
-        WorkingSetMember* rhsMember = _ws->get(rhs->id);
+    KeyString MergeSortStage::makeSortKey(WorkingSetID id) const {
+        WorkingSetMember* member = _ws->get(id);
 
+        // Pull out the fields of the pattern, in pattern order, with the field names
+        // dropped; the names play no part in the comparison.
+        BSONObjBuilder keyBob;
         BSONObjIterator it(_pattern);
         while (it.more()) {
             BSONElement patternElt = it.next();
-            string fn = patternElt.fieldName();
-
-            BSONElement lhsElt;
-            verify(lhsMember->getFieldDotted(fn, &lhsElt));
-
-            BSONElement rhsElt;
-            verify(rhsMember->getFieldDotted(fn, &rhsElt));
 
-            // false means don't compare field name.
-            int x = lhsElt.woCompare(rhsElt, false);
-            if (-1 == patternElt.number()) { x = -x; }
-            if (x != 0) { return x > 0; }
+            BSONElement elt;
+            verify(member->getFieldDotted(patternElt.fieldName(), &elt));
+            keyBob.appendAs(elt, "");
         }
 
-        // A comparator for use with sort is required to model a strict weak ordering, so
-        // to satisfy irreflexivity we must return 'false' for elements that we consider
-        // equivalent under the pattern.
-        return false;
+        return KeyString::make(keyBob.obj(), _ordering);
     }
 
     vector<PlanStage*> MergeSortStage::getChildren() const {
@@ -32,10 +32,12 @@
 #include <queue>
 #include <vector>
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/key_string.h"
 
 namespace mongo {
 
@@ -91,6 +93,9 @@ namespace mongo {
         // The pattern that we're sorting by.
         BSONObj _pattern;
 
+        // The pattern's per-field directions, baked into the memoized sort keys below.
+        const Ordering _ordering;
+
         // Are we deduplicating on RecordId?
         bool _dedup;
 
@@ -121,6 +126,10 @@ namespace mongo {
             StageWithValue() : id(WorkingSet::INVALID_ID), stage(NULL) { }
             WorkingSetID id;
             PlanStage* stage;
+            // The result's sort key, memoized in KeyString form with the pattern's
+            // directions baked in.  Each heap comparison is then a single memcmp
+            // instead of a per-field BSON comparison.
+            KeyString key;
         };
 
         // We have a priority queue of these.
@@ -129,18 +138,17 @@ namespace mongo {
         // The comparison function used in our priority queue.
         class StageWithValueComparison {
         public:
-            StageWithValueComparison(WorkingSet* ws, BSONObj pattern)
-                : _ws(ws), _pattern(pattern) {}
-
             // Is lhs less than rhs?  Note that priority_queue is a max heap by default so we invert
             // the return from the expected value.
             bool operator()(const MergingRef& lhs, const MergingRef& rhs);
-
-        private:
-            WorkingSet* _ws;
-            BSONObj _pattern;
         };
 
+        /**
+         * Encodes the sort key of the result 'id' (the fields of '_pattern', in pattern
+         * order) as a KeyString with '_ordering' applied.
+         */
+        KeyString makeSortKey(WorkingSetID id) const;
+
         // The min heap of the results we're returning.
         std::priority_queue<MergingRef, std::vector<MergingRef>, StageWithValueComparison> _merging;
 
@@ -102,4 +102,77 @@ namespace {
         auto_ptr<PlanStageStats> allStats(mock->getStats());
         ASSERT_TRUE(stats->isEOF);
     }
+
+    //
+    // Test the default workBatch() implementation: consecutive ADVANCED results are batched
+    // up, and the batch ends at the first non-ADVANCED state.
+    //
+    TEST(MockStageTest, workBatchBatchesAdvanced) {
+        WorkingSet ws;
+        auto_ptr<MockStage> mock(new MockStage(&ws));
+
+        const WorkingSetMember member;
+        mock->pushBack(member);
+        mock->pushBack(member);
+        mock->pushBack(member);
+        mock->pushBack(PlanStage::IS_EOF);
+
+        std::vector<WorkingSetID> results;
+        WorkingSetID wsID = WorkingSet::INVALID_ID;
+
+        // All three results come back in one batch.
+        ASSERT_EQUALS(PlanStage::ADVANCED, mock->workBatch(10, &results, &wsID));
+        ASSERT_EQUALS(results.size(), 3U);
+
+        // The next batch observes EOF.
+        results.clear();
+        ASSERT_EQUALS(PlanStage::IS_EOF, mock->workBatch(10, &results, &wsID));
+        ASSERT_EQUALS(results.size(), 0U);
+    }
+
+    TEST(MockStageTest, workBatchRespectsMaxResults) {
+        WorkingSet ws;
+        auto_ptr<MockStage> mock(new MockStage(&ws));
+
+        const WorkingSetMember member;
+        mock->pushBack(member);
+        mock->pushBack(member);
+        mock->pushBack(member);
+
+        std::vector<WorkingSetID> results;
+        WorkingSetID wsID = WorkingSet::INVALID_ID;
+
+        ASSERT_EQUALS(PlanStage::ADVANCED, mock->workBatch(2, &results, &wsID));
+        ASSERT_EQUALS(results.size(), 2U);
+    }
+
+    //
+    // NEED_TIME ends a non-empty batch so a caller interleaving yield checks regains
+    // control, and is returned as-is when no results have been gathered yet.
+    //
+    TEST(MockStageTest, workBatchStopsAtNeedTime) {
+        WorkingSet ws;
+        auto_ptr<MockStage> mock(new MockStage(&ws));
+
+        const WorkingSetMember member;
+        mock->pushBack(PlanStage::NEED_TIME);
+        mock->pushBack(member);
+        mock->pushBack(PlanStage::NEED_TIME);
+        mock->pushBack(member);
+
+        std::vector<WorkingSetID> results;
+        WorkingSetID wsID = WorkingSet::INVALID_ID;
+
+        // An empty batch returns NEED_TIME directly.
+        ASSERT_EQUALS(PlanStage::NEED_TIME, mock->workBatch(10, &results, &wsID));
+        ASSERT_EQUALS(results.size(), 0U);
+
+        // A non-empty batch ends at NEED_TIME with the results gathered so far.
+        ASSERT_EQUALS(PlanStage::ADVANCED, mock->workBatch(10, &results, &wsID));
+        ASSERT_EQUALS(results.size(), 1U);
+
+        results.clear();
+        ASSERT_EQUALS(PlanStage::ADVANCED, mock->workBatch(10, &results, &wsID));
+        ASSERT_EQUALS(results.size(), 1U);
+    }
 }
@@ -209,11 +209,26 @@ namespace mongo {
             numResults = std::min(numToReturn, numResults);
         }
 
+        // How often we check whether one candidate has opened up a decisive lead. Checking
+        // is cheap, but a lead is rarely decisive in the first few rounds.
+        const size_t kEarlyExitCheckInterval = 100;
+
         // Work the plans, stopping when a plan hits EOF or returns some
         // fixed number of results.
         for (size_t ix = 0; ix < numWorks; ++ix) {
             bool moreToDo = workAllPlans(numResults, yieldPolicy);
             if (!moreToDo) { break; }
+
+            // Periodically see if the leader is statistically certain to win, in which case
+            // the remaining trial rounds are wasted work. The losers' stats still make it
+            // into the ranking decision (and from there into the plan cache) below.
+            if (internalQueryPlanEvaluationEarlyExitLead > 0
+                && 0 == ((ix + 1) % kEarlyExitCheckInterval)
+                && hasDecisiveWinner(ix + 1)) {
+                QLOG() << "Ending plan evaluation early after " << (ix + 1)
+                       << " rounds: leader's advantage is decisive\n";
+                break;
+            }
         }
 
         if (_failure) {
@@ -344,6 +359,34 @@ namespace mongo {
         return candidateStats.release();
     }
 
+    bool MultiPlanStage::hasDecisiveWinner(size_t roundsWorked) const {
+        // Find the number of buffered results for the leader and the runner-up.
+        size_t leaderResults = 0;
+        size_t runnerUpResults = 0;
+        for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+            if (_candidates[ix].failed) { continue; }
+
+            size_t numResults = _candidates[ix].results.size();
+            if (numResults > leaderResults) {
+                runnerUpResults = leaderResults;
+                leaderResults = numResults;
+            }
+            else if (numResults > runnerUpResults) {
+                runnerUpResults = numResults;
+            }
+        }
+
+        // Treat each round as a trial in which a candidate either produces a result or
+        // doesn't. By a Hoeffding-style bound, a plan that is really no more productive
+        // than the runner-up accumulates a lead of z * sqrt(roundsWorked) results with
+        // probability at most exp(-z^2 / 2) -- about 1% for the default z of 3. Once the
+        // leader is that far ahead, more trial rounds cannot realistically change the
+        // ranking.
+        double lead = static_cast<double>(leaderResults) - static_cast<double>(runnerUpResults);
+        return lead > internalQueryPlanEvaluationEarlyExitLead
+                          * sqrt(static_cast<double>(roundsWorked));
+    }
+
     bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy) {
         bool doneWorking = false;
 
@@ -142,6 +142,13 @@ namespace mongo {
          */
         bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+        /**
+         * Returns true if, after 'roundsWorked' rounds of workAllPlans(), the candidate with
+         * the most buffered results is so far ahead of the runner-up that the remaining trial
+         * rounds cannot realistically change the ranking. Used to cut the trial period short.
+         */
+        bool hasDecisiveWinner(size_t roundsWorked) const;
+
         /**
          * Checks whether we need to perform either a timing-based yield or a yield for a document
          * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
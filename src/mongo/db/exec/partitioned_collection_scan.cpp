@@ -0,0 +1,222 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/partitioned_collection_scan.h"
+
+#include "mongo/db/exec/filter.h"
+#include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/storage/record_fetcher.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+    using std::auto_ptr;
+    using std::vector;
+
+    // static
+    const char* PartitionedCollectionScan::kStageType = "PARTITIONED_COLLSCAN";
+
+    PartitionedCollectionScan::PartitionedCollectionScan(OperationContext* txn,
+                                                         Collection* collection,
+                                                         size_t numPartitions,
+                                                         size_t partitionIndex,
+                                                         WorkingSet* workingSet,
+                                                         const MatchExpression* filter)
+        : _txn(txn),
+          _collection(collection),
+          _workingSet(workingSet),
+          _filter(filter),
+          _isDead(false),
+          _wsidForFetch(_workingSet->allocate()),
+          _commonStats(kStageType) {
+        invariant(numPartitions > 0);
+        invariant(partitionIndex < numPartitions);
+
+        // Deal our share of the record store's iterators into this partition. Partitions built
+        // with the same numPartitions and distinct indexes are disjoint and together cover the
+        // collection.
+        vector<RecordIterator*> iterators = _collection->getManyIterators(_txn, numPartitions);
+        for (size_t i = 0; i < iterators.size(); i++) {
+            if (i % numPartitions == partitionIndex) {
+                _iterators.push_back(iterators[i]);
+            }
+            else {
+                delete iterators[i];
+            }
+        }
+
+        // We pre-allocate a WSM and use it to pass up fetch requests. This should never be used
+        // for anything other than passing up NEED_FETCH. We use the loc and owned obj state, but
+        // the loc isn't really pointing at any obj. The obj field of the WSM should never be used.
+        WorkingSetMember* member = _workingSet->get(_wsidForFetch);
+        member->state = WorkingSetMember::LOC_AND_OWNED_OBJ;
+    }
+
+    PlanStage::StageState PartitionedCollectionScan::work(WorkingSetID* out) {
+        ++_commonStats.works;
+
+        // Adds the amount of time taken by work() to executionTimeMillis.
+        ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+        if (_isDead) { return PlanStage::DEAD; }
+
+        if (isEOF()) { return PlanStage::IS_EOF; }
+
+        // See if the record we're about to access is in memory. If not, pass a fetch request up
+        // so we yield while it is paged in.
+        {
+            const RecordId curr = _iterators.back()->curr();
+            if (!curr.isNull()) {
+                auto_ptr<RecordFetcher> fetcher(_collection->documentNeedsFetch(_txn, curr));
+                if (NULL != fetcher.get()) {
+                    WorkingSetMember* member = _workingSet->get(_wsidForFetch);
+                    member->loc = curr;
+                    // Pass the RecordFetcher off to the WSM.
+                    member->setFetcher(fetcher.release());
+                    *out = _wsidForFetch;
+                    ++_commonStats.needFetch;
+                    return NEED_FETCH;
+                }
+            }
+        }
+
+        const RecordId loc = _advance();
+        if (loc.isNull()) {
+            return isEOF() ? PlanStage::IS_EOF : PlanStage::NEED_TIME;
+        }
+
+        WorkingSetID id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->loc = loc;
+        member->obj = _collection->docFor(_txn, loc);
+        member->state = WorkingSetMember::LOC_AND_UNOWNED_OBJ;
+
+        ++_specificStats.docsTested;
+
+        if (Filter::passes(member, _filter)) {
+            *out = id;
+            ++_commonStats.advanced;
+            return PlanStage::ADVANCED;
+        }
+
+        _workingSet->free(id);
+        ++_commonStats.needTime;
+        return PlanStage::NEED_TIME;
+    }
+
+    RecordId PartitionedCollectionScan::_advance() {
+        while (!_iterators.empty()) {
+            const RecordId out = _iterators.back()->getNext();
+            if (!out.isNull()) {
+                return out;
+            }
+
+            // This iterator is exhausted; move on to the next one.
+            _iterators.popAndDeleteBack();
+        }
+        return RecordId();
+    }
+
+    bool PartitionedCollectionScan::isEOF() {
+        return _isDead || _iterators.empty();
+    }
+
+    void PartitionedCollectionScan::invalidate(OperationContext* txn,
+                                               const RecordId& dl,
+                                               InvalidationType type) {
+        ++_commonStats.invalidates;
+
+        // We don't care about mutations since we apply any filters to the result when we
+        // (possibly) return it.  Deletions can harm the underlying RecordIterators, though, so
+        // those must be passed down.
+        if (INVALIDATION_DELETION != type) {
+            return;
+        }
+
+        for (size_t i = 0; i < _iterators.size(); i++) {
+            _iterators[i]->invalidate(dl);
+        }
+    }
+
+    void PartitionedCollectionScan::saveState() {
+        _txn = NULL;
+        ++_commonStats.yields;
+        for (size_t i = 0; i < _iterators.size(); i++) {
+            _iterators[i]->saveState();
+        }
+    }
+
+    void PartitionedCollectionScan::restoreState(OperationContext* opCtx) {
+        invariant(_txn == NULL);
+        _txn = opCtx;
+        ++_commonStats.unyields;
+        for (size_t i = 0; i < _iterators.size(); i++) {
+            if (!_iterators[i]->restoreState(opCtx)) {
+                warning() << "Collection dropped or state deleted during yield of "
+                          << "PartitionedCollectionScan: " << opCtx->getNS();
+                _isDead = true;
+            }
+        }
+    }
+
+    vector<PlanStage*> PartitionedCollectionScan::getChildren() const {
+        vector<PlanStage*> empty;
+        return empty;
+    }
+
+    PlanStageStats* PartitionedCollectionScan::getStats() {
+        _commonStats.isEOF = isEOF();
+
+        // Add a BSON representation of the filter to the stats tree, if there is one.
+        if (NULL != _filter) {
+            BSONObjBuilder bob;
+            _filter->toBSON(&bob);
+            _commonStats.filter = bob.obj();
+        }
+
+        auto_ptr<PlanStageStats> ret(new PlanStageStats(_commonStats,
+                                                        STAGE_PARTITIONED_COLLSCAN));
+        ret->specific.reset(new CollectionScanStats(_specificStats));
+        return ret.release();
+    }
+
+    const CommonStats* PartitionedCollectionScan::getCommonStats() {
+        return &_commonStats;
+    }
+
+    const SpecificStats* PartitionedCollectionScan::getSpecificStats() {
+        return &_specificStats;
+    }
+
+}  // namespace mongo
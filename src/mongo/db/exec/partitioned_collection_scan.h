@@ -0,0 +1,121 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+    class OperationContext;
+    class WorkingSet;
+
+    /**
+     * Scans one partition of a collection: the subset of the record store's natural-order
+     * iterators (Collection::getManyIterators) whose position modulo 'numPartitions' equals
+     * 'partitionIndex'.  Cooperating cursors constructed with the same numPartitions and
+     * distinct partition indexes cover the whole collection exactly once between them, so a
+     * driver (a command handing cursors to client threads, or a future parallel executor) can
+     * scan the collection with N workers, each running its own operation and cursor.
+     *
+     * Like CollectionScan this stage applies an optional filter and reports docsTested, so each
+     * partition does its own matching close to the data instead of funnelling raw records to
+     * the merge point.
+     *
+     * Unlike CollectionScan this stage has no defined ordering and does not support tailable
+     * cursors or a start position.
+     */
+    class PartitionedCollectionScan : public PlanStage {
+    public:
+        PartitionedCollectionScan(OperationContext* txn,
+                                  Collection* collection,
+                                  size_t numPartitions,
+                                  size_t partitionIndex,
+                                  WorkingSet* workingSet,
+                                  const MatchExpression* filter);
+
+        virtual ~PartitionedCollectionScan() { }
+
+        virtual StageState work(WorkingSetID* out);
+        virtual bool isEOF();
+
+        virtual void invalidate(OperationContext* txn, const RecordId& dl, InvalidationType type);
+        virtual void saveState();
+        virtual void restoreState(OperationContext* opCtx);
+
+        virtual std::vector<PlanStage*> getChildren() const;
+
+        virtual StageType stageType() const { return STAGE_PARTITIONED_COLLSCAN; }
+
+        virtual PlanStageStats* getStats();
+
+        virtual const CommonStats* getCommonStats();
+
+        virtual const SpecificStats* getSpecificStats();
+
+        static const char* kStageType;
+
+    private:
+        /**
+         * Advances past the current record, dropping exhausted iterators.
+         * @return the RecordId advanced over, or a null RecordId at partition EOF.
+         */
+        RecordId _advance();
+
+        // transactional context for read locks. Not owned by us.
+        OperationContext* _txn;
+
+        // Not owned by us.
+        Collection* _collection;
+
+        // The subset of the collection's iterators making up our partition. We drain one
+        // iterator at a time, from the back.
+        OwnedPointerVector<RecordIterator> _iterators;
+
+        // WorkingSet is not owned by us.
+        WorkingSet* _workingSet;
+
+        // The filter is not owned by us.
+        const MatchExpression* _filter;
+
+        bool _isDead;
+
+        // We allocate a working set member with this id on construction of the stage. It gets
+        // used for all fetch requests, changing the RecordId as appropriate.
+        const WorkingSetID _wsidForFetch;
+
+        // Stats
+        CommonStats _commonStats;
+        CollectionScanStats _specificStats;
+    };
+
+}  // namespace mongo
@@ -40,6 +40,20 @@ namespace mongo {
     using boost::intrusive_ptr;
     using boost::shared_ptr;
 
+    /**
+     * Required to instantiate the sorter templates backing the result spool.  The
+     * spool only appends and replays in insertion order; nothing is ever compared.
+     */
+    class PipelineSpoolNoComparison {
+    public:
+        typedef std::pair<BSONObj, BSONObj> Data;
+
+        int operator() (const Data& l, const Data& r) const {
+            invariant(false); // the spool never sorts
+            return 0;
+        }
+    };
+
     PipelineProxyStage::PipelineProxyStage(intrusive_ptr<Pipeline> pipeline,
                                            const boost::shared_ptr<PlanExecutor>& child,
                                            WorkingSet* ws)
@@ -96,24 +110,97 @@ namespace mongo {
     }
 
     void PipelineProxyStage::saveState() {
-        _pipeline->getContext()->opCtx = NULL;
+        if (_pipeline) {
+            _pipeline->getContext()->opCtx = NULL;
+        }
     }
 
     void PipelineProxyStage::restoreState(OperationContext* opCtx) {
-        invariant(_pipeline->getContext()->opCtx == NULL);
-        _pipeline->getContext()->opCtx = opCtx;
+        if (_pipeline) {
+            invariant(_pipeline->getContext()->opCtx == NULL);
+            _pipeline->getContext()->opCtx = opCtx;
+        }
     }
 
     void PipelineProxyStage::pushBack(const BSONObj& obj) {
         _stash.push_back(obj);
     }
 
+    bool PipelineProxyStage::spoolAllResults(size_t maxMemoryUsageBytes,
+                                             bool allowDiskUse,
+                                             const std::string& tempDir) {
+        invariant(_pipeline);
+        invariant(_spool.empty() && !_spoolIter);
+
+        size_t memUsed = 0;
+        boost::scoped_ptr<SortedFileWriter<BSONObj, BSONObj> > writer;
+
+        while (boost::optional<BSONObj> next = getNextBson()) {
+            if (!writer && memUsed + next->objsize() > maxMemoryUsageBytes) {
+                if (!allowDiskUse) {
+                    // Not allowed to spill.  Keep what we have; it is served ahead of
+                    // the pipeline, which resumes lazily behind it.
+                    _spool.push_back(next->getOwned());
+                    return false;
+                }
+
+                // Shift the in-memory prefix into the spill file so it holds the full
+                // result set in order.
+                writer.reset(new SortedFileWriter<BSONObj, BSONObj>(
+                        SortOptions().TempDir(tempDir).ExtSortAllowed()));
+                for (std::deque<BSONObj>::const_iterator it = _spool.begin();
+                     it != _spool.end();
+                     ++it) {
+                    writer->addAlreadySorted(*it, BSONObj());
+                }
+                _spool.clear();
+            }
+
+            if (writer) {
+                writer->addAlreadySorted(*next, BSONObj());
+            }
+            else {
+                _spool.push_back(next->getOwned());
+                memUsed += _spool.back().objsize();
+            }
+        }
+
+        if (writer) {
+            _spoolIter.reset(writer->done());
+        }
+
+        // The pipeline ran to completion, so its accumulated state (and, through the
+        // disposed cursor source, the child executor) is no longer needed; from here
+        // on getNextBson() serves from the spool.
+        _pipeline.reset();
+        return true;
+    }
+
     vector<PlanStage*> PipelineProxyStage::getChildren() const {
         vector<PlanStage*> empty;
         return empty;
     }
 
     boost::optional<BSONObj> PipelineProxyStage::getNextBson() {
+        if (!_spool.empty()) {
+            const BSONObj next = _spool.front();
+            _spool.pop_front();
+            return next;
+        }
+
+        if (_spoolIter) {
+            if (_spoolIter->more()) {
+                // Objects handed back by the iterator are only valid until it is
+                // touched again.
+                return _spoolIter->next().first.getOwned();
+            }
+            _spoolIter.reset(); // deletes the spill file
+        }
+
+        if (!_pipeline) {
+            return boost::none;
+        }
+
         if (boost::optional<Document> next = _pipeline->output()->getNext()) {
             if (_includeMetaData) {
                 return next->toBsonWithMetaData();
@@ -131,3 +218,6 @@ namespace mongo {
     }
 
 } // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+MONGO_CREATE_SORTER(mongo::BSONObj, mongo::BSONObj, mongo::PipelineSpoolNoComparison);
@@ -30,14 +30,17 @@
 
 #include <boost/optional/optional.hpp>
 #include <boost/intrusive_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 #include <boost/weak_ptr.hpp>
+#include <deque>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -68,6 +71,22 @@ namespace mongo {
          */
         void pushBack(const BSONObj& obj);
 
+        /**
+         * Runs the pipeline to completion now, spooling its results so later work()
+         * calls are served without touching the pipeline or the underlying collection.
+         * Results are kept in memory up to 'maxMemoryUsageBytes'; past that they are
+         * spooled to a compressed temp file under 'tempDir' when 'allowDiskUse' is set.
+         *
+         * Returns true if the pipeline ran to completion and its resources (including
+         * accumulated $group/$sort state and the child executor) were released.
+         * Returns false if the memory budget was reached without permission to spill;
+         * the results gathered so far are then served ahead of the pipeline, which
+         * resumes lazily behind them.
+         */
+        bool spoolAllResults(size_t maxMemoryUsageBytes,
+                             bool allowDiskUse,
+                             const std::string& tempDir);
+
         /**
          * Return a shared pointer to the PlanExecutor that feeds the pipeline. The returned
          * pointer may be NULL.
@@ -92,8 +111,15 @@ namespace mongo {
         boost::optional<BSONObj> getNextBson();
 
         // Things in the _stash sould be returned before pulling items from _pipeline.
-        const boost::intrusive_ptr<Pipeline> _pipeline;
+        // NULL once spoolAllResults() has run the pipeline to completion.
+        boost::intrusive_ptr<Pipeline> _pipeline;
         vector<BSONObj> _stash;
+
+        // Filled by spoolAllResults() and served, in order, after the _stash.  The
+        // results live either in the deque or (if the memory budget was hit and disk
+        // use was allowed) entirely in the spill file behind _spoolIter.
+        std::deque<BSONObj> _spool;
+        boost::scoped_ptr<SortIteratorInterface<BSONObj, BSONObj> > _spoolIter;
         const bool _includeMetaData;
         boost::weak_ptr<PlanExecutor> _childExec;
 
@@ -171,6 +171,49 @@ namespace mongo {
          */
         virtual StageState work(WorkingSetID* out) = 0;
 
+        /**
+         * Perform work until up to 'maxResults' units of output have been produced, appending
+         * the id of each result to 'results'.  Returns ADVANCED if at least one id was
+         * appended.  Any other return value carries the same meaning as for work(), with *out
+         * set as work() would set it; ids already appended to 'results' are still valid
+         * results which the caller must consume before acting on the returned state.
+         *
+         * Batching amortizes the per-document virtual dispatch and state-machine overhead of
+         * the one-result-per-call work() protocol over a run of results.  The default
+         * implementation repeatedly calls work() and ends the batch at the first state other
+         * than ADVANCED, so a caller that interleaves yield checks with calls into the stage
+         * sees at most 'maxResults' results between checks.  Stages that can produce a run of
+         * results more cheaply than repeated work() calls may override this.
+         */
+        virtual StageState workBatch(size_t maxResults,
+                                     std::vector<WorkingSetID>* results,
+                                     WorkingSetID* out) {
+            for (;;) {
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                StageState code = work(&id);
+
+                if (ADVANCED == code) {
+                    results->push_back(id);
+                    if (results->size() >= maxResults) {
+                        return ADVANCED;
+                    }
+                }
+                else if (NEED_TIME == code) {
+                    // Hand back any output we have rather than burning time here; the caller
+                    // may want to check its yield policy.
+                    if (!results->empty()) {
+                        return ADVANCED;
+                    }
+                    return NEED_TIME;
+                }
+                else {
+                    // IS_EOF, NEED_FETCH, DEAD or FAILURE ends the batch.
+                    *out = id;
+                    return code;
+                }
+            }
+        }
+
         /**
          * Returns true if no more work can be done on the query / out of results.
          */
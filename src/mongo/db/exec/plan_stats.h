@@ -224,7 +224,8 @@ namespace mongo {
     };
 
     struct CountStats : public SpecificStats {
-        CountStats() : nCounted(0), nSkipped(0), trivialCount(false) { }
+        CountStats() : nCounted(0), nSkipped(0), trivialCount(false),
+                       partitionedCount(false) { }
 
         virtual SpecificStats* clone() const {
             CountStats* specific = new CountStats(*this);
@@ -240,6 +241,10 @@ namespace mongo {
         // A "trivial count" is one that we can answer by calling numRecords() on the
         // collection, without actually going through any query logic.
         bool trivialCount;
+
+        // A partitioned count split the index range across worker threads instead of
+        // working the child stage serially.
+        bool partitionedCount;
     };
 
     struct CountScanStats : public SpecificStats {
@@ -52,7 +52,9 @@ namespace mongo {
         : _ws(ws),
           _child(child),
           _commonStats(kStageType),
-          _projImpl(params.projImpl) {
+          _projImpl(params.projImpl),
+          _lastIncludedKeyIndex(-1),
+          _includedNameSize(0) {
 
         _projObj = params.projObj;
 
@@ -95,6 +97,8 @@ namespace mongo {
                         // If we are including this key field store its field name.
                         _keyFieldNames.push_back(*fieldIt);
                         _includeKey.push_back(true);
+                        _lastIncludedKeyIndex = static_cast<int>(_includeKey.size()) - 1;
+                        _includedNameSize += fieldIt->size() + 1;
                     }
                 }
             }
@@ -153,7 +157,7 @@ namespace mongo {
             return _exec->transform(member);
         }
 
-        BSONObjBuilder bob;
+        BSONObj newObj;
 
         // Note that even if our fast path analysis is bug-free something that is
         // covered might be invalidated and just be an obj.  In this case we just go
@@ -166,31 +170,46 @@ namespace mongo {
             invariant(member->hasObj());
 
             // Apply the SIMPLE_DOC projection.
+            BSONObjBuilder bob;
             transformSimpleInclusion(member->obj, _includedFields, bob);
+            newObj = bob.obj();
         }
         else {
             invariant(ProjectionStageParams::COVERED_ONE_INDEX == _projImpl);
             // We're pulling data out of the key.
             invariant(1 == member->keyData.size());
-            size_t keyIndex = 0;
 
-            // Look at every key element...
-            BSONObjIterator keyIterator(member->keyData[0].keyData);
-            while (keyIterator.more()) {
+            const BSONObj& key = member->keyData[0].keyData;
+
+            // The output is at most the key plus the precomputed field names, so reserve
+            // everything up front and emit the reply bytes directly.
+            BSONObjBuilder bob(key.objsize() + _includedNameSize);
+            BufBuilder& bb = bob.bb();
+
+            int keyIndex = 0;
+
+            // Look at every key element up to the last one we include...
+            BSONObjIterator keyIterator(key);
+            while (keyIterator.more() && keyIndex <= _lastIncludedKeyIndex) {
                 BSONElement elt = keyIterator.next();
                 // If we're supposed to include it...
                 if (_includeKey[keyIndex]) {
-                    // Do so.
-                    bob.appendAs(elt, _keyFieldNames[keyIndex]);
+                    // ...raw-copy the type byte and value bytes behind the precomputed
+                    // field name, as appendAs() would but without re-measuring the name.
+                    bb.appendNum(static_cast<char>(elt.type()));
+                    bb.appendStr(_keyFieldNames[keyIndex], true);
+                    bb.appendBuf(elt.value(), elt.valuesize());
                 }
                 ++keyIndex;
             }
+
+            newObj = bob.obj();
         }
 
         member->state = WorkingSetMember::OWNED_OBJ;
         member->keyData.clear();
         member->loc = RecordId();
-        member->obj = bob.obj();
+        member->obj = newObj;
         return Status::OK();
     }
 
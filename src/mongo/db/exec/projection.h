@@ -155,6 +155,14 @@ namespace mongo {
 
         // If the i-th entry of _includeKey is true this is the field name for the i-th key field.
         std::vector<StringData> _keyFieldNames;
+
+        // Index of the last included key field, so the per-document loop can stop early once
+        // every projected field has been copied.  -1 if no key fields are included.
+        int _lastIncludedKeyIndex;
+
+        // Total bytes of included field names (with their terminating NULs).  Added to the
+        // key size to pre-size the output buffer for covered projections.
+        int _includedNameSize;
     };
 
 }  // namespace mongo
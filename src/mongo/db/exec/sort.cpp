@@ -32,6 +32,7 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/index_names.h"
+#include "mongo/db/operation_memory.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
@@ -227,7 +228,8 @@ namespace mongo {
         params.options = QueryPlannerParams::NO_TABLE_SCAN;
 
         // We're creating a "virtual index" with key pattern equal to the sort order.
-        IndexEntry sortOrder(sortObj, IndexNames::BTREE, true, false, "doesnt_matter", BSONObj());
+        IndexEntry sortOrder(sortObj, IndexNames::BTREE, true, false, "doesnt_matter", NULL,
+                             BSONObj());
         params.indices.push_back(sortOrder);
 
         CanonicalQuery* rawQueryForSort;
@@ -268,13 +270,40 @@ namespace mongo {
         }
     }
 
-    SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) { }
+    SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p)
+        : pattern(p), ordering(Ordering::make(p)) { }
 
     bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const {
-        // False means ignore field names.
-        int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
-        if (0 != result) {
-            return result < 0;
+        // Field-by-field equivalent of woCompare(rhs.sortKey, pattern, false), but
+        // each element pair dispatches straight to a specialized comparator and the
+        // sort directions come from the precomputed Ordering instead of re-parsing
+        // the pattern per field.
+        BSONObjIterator lhsIt(lhs.sortKey);
+        BSONObjIterator rhsIt(rhs.sortKey);
+        unsigned mask = 1;
+        while (lhsIt.more() || rhsIt.more()) {
+            BSONElement lhsElt = lhsIt.more() ? lhsIt.next() : BSONElement();
+            BSONElement rhsElt = rhsIt.more() ? rhsIt.next() : BSONElement();
+            // As in woCompare, running out of fields is not direction-adjusted:
+            // the shorter key always sorts first.
+            if (lhsElt.eoo()) {
+                if (rhsElt.eoo()) {
+                    break;
+                }
+                return true;
+            }
+            if (rhsElt.eoo()) {
+                return false;
+            }
+
+            int result = compareElementsFast(lhsElt, rhsElt);
+            if (0 != result) {
+                if (ordering.descending(mask)) {
+                    result = -result;
+                }
+                return result < 0;
+            }
+            mask <<= 1;
         }
         // Indices use RecordId as an additional sort key so we must as well.
         return lhs.loc < rhs.loc;
@@ -295,7 +324,9 @@ namespace mongo {
           _memUsage(0) {
     }
 
-    SortStage::~SortStage() { }
+    SortStage::~SortStage() {
+        OperationMemoryTracker::releaseCurrent(_memUsage);
+    }
 
     bool SortStage::isEOF() {
         // We're done when our child has no more results, we've sorted the child's results, and
@@ -512,12 +543,15 @@ namespace mongo {
 
         if (_limit == 0) {
             _data.push_back(item);
-            _memUsage += _ws->get(item.wsid)->getMemUsage();
+            const size_t memUsage = _ws->get(item.wsid)->getMemUsage();
+            _memUsage += memUsage;
+            OperationMemoryTracker::chargeCurrent(memUsage);
         }
         else if (_limit == 1) {
             if (_data.empty()) {
                 _data.push_back(item);
                 _memUsage = _ws->get(item.wsid)->getMemUsage();
+                OperationMemoryTracker::chargeCurrent(_memUsage);
                 return;
             }
             wsidToFree = item.wsid;
@@ -526,7 +560,9 @@ namespace mongo {
             if (cmp(item, _data[0])) {
                 wsidToFree = _data[0].wsid;
                 _data[0] = item;
+                OperationMemoryTracker::releaseCurrent(_memUsage);
                 _memUsage = _ws->get(item.wsid)->getMemUsage();
+                OperationMemoryTracker::chargeCurrent(_memUsage);
             }
         }
         else {
@@ -535,7 +571,9 @@ namespace mongo {
             vector<SortableDataItem>::size_type limit(_limit);
             if (_dataSet->size() < limit) {
                 _dataSet->insert(item);
-                _memUsage += _ws->get(item.wsid)->getMemUsage();
+                const size_t memUsage = _ws->get(item.wsid)->getMemUsage();
+                _memUsage += memUsage;
+                OperationMemoryTracker::chargeCurrent(memUsage);
                 return;
             }
             // Limit will be exceeded - compare with item with lowest key
@@ -546,8 +584,12 @@ namespace mongo {
             const SortableDataItem& lastItem = *lastItemIt;
             const WorkingSetComparator& cmp = *_sortKeyComparator;
             if (cmp(item, lastItem)) {
-                _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
-                _memUsage += _ws->get(item.wsid)->getMemUsage();
+                const size_t removedMemUsage = _ws->get(lastItem.wsid)->getMemUsage();
+                const size_t addedMemUsage = _ws->get(item.wsid)->getMemUsage();
+                _memUsage -= removedMemUsage;
+                _memUsage += addedMemUsage;
+                OperationMemoryTracker::releaseCurrent(removedMemUsage);
+                OperationMemoryTracker::chargeCurrent(addedMemUsage);
                 wsidToFree = lastItem.wsid;
                 // According to std::set iterator validity rules,
                 // it does not matter which of erase()/insert() happens first.
@@ -217,13 +217,18 @@ namespace mongo {
         // Comparison object for data buffers (vector and set).
         // Items are compared on (sortKey, loc). This is also how the items are
         // ordered in the indices.
-        // Keys are compared using BSONObj::woCompare() with RecordId as a tie-breaker.
+        // Keys are compared field by field through the type-pair comparator table
+        // (see compareElementsFast), with RecordId as a tie-breaker.
         struct WorkingSetComparator {
             explicit WorkingSetComparator(BSONObj p);
 
             bool operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
 
             BSONObj pattern;
+
+            // Per-field ascending/descending bits baked out of 'pattern' so the
+            // comparator doesn't re-parse the pattern on every comparison.
+            Ordering ordering;
         };
 
         /**
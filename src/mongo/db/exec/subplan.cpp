@@ -175,12 +175,65 @@ namespace mongo {
                     ss << "No solutions for subchild " << branchResult->canonicalQuery->toString();
                     return Status(ErrorCodes::BadValue, ss);
                 }
+
+                if (1 == branchResult->solutions.size()) {
+                    // The MPS only writes a branch's winner to the plan cache after ranking
+                    // it against at least one other candidate, so a branch with a lone
+                    // solution would be enumerated afresh on every execution of this shape.
+                    // Cache it ourselves.
+                    cacheSingleSolutionBranch(branchResult);
+                }
             }
         }
 
         return Status::OK();
     }
 
+    void SubplanStage::cacheSingleSolutionBranch(BranchPlanningResult* branchResult) {
+        CanonicalQuery* branchCQ = branchResult->canonicalQuery.get();
+        QuerySolution* soln = branchResult->solutions.vector().front();
+
+        if (!PlanCache::shouldCacheQuery(*branchCQ)) {
+            return;
+        }
+
+        // As with the MPS, we can't cache a solution that has no cache data (e.g. anything
+        // answered with a 2d index).
+        if (NULL == soln->cacheData.get()) {
+            QLOG() << "Subplanner: not caching lone solution without cache data for "
+                   << branchCQ->toStringShort();
+            return;
+        }
+
+        soln->cacheData->indexFilterApplied = _plannerParams.indexFiltersApplied;
+
+        // A cache entry needs a ranking decision, but no ranking took place. Build the
+        // plan's stage tree just to take an (unexecuted) stats tree from it, and give the
+        // plan a neutral score; the cache's feedback mechanism compares executions of the
+        // cached plan against each other, not against this score.
+        WorkingSet ws;
+        PlanStage* rawRoot;
+        verify(StageBuilder::build(_txn, _collection, *soln, &ws, &rawRoot));
+        boost::scoped_ptr<PlanStage> root(rawRoot);
+
+        auto_ptr<PlanRankingDecision> why(new PlanRankingDecision());
+        why->stats.mutableVector().push_back(root->getStats());
+        why->scores.push_back(0);
+        why->candidateOrder.push_back(0);
+
+        std::vector<QuerySolution*> solutions;
+        solutions.push_back(soln);
+
+        // The cache makes its own copies; we keep ownership of 'soln'.
+        Status cacheStatus = _collection->infoCache()->getPlanCache()->add(*branchCQ,
+                                                                           solutions,
+                                                                           why.release());
+        if (!cacheStatus.isOK()) {
+            QLOG() << "Subplanner: failed to cache lone solution for "
+                   << branchCQ->toStringShort() << ": " << cacheStatus.reason();
+        }
+    }
+
     namespace {
 
         /**
@@ -60,7 +60,9 @@ namespace mongo {
      *   is used to determine the best plan for the clause; unless there is a tie between multiple
      *   candidate plans, the winner is inserted into the plan cache and used to plan subsequent
      *   executions of C. These subsequent executions of shape C could be either as a clause in
-     *   another rooted $or query, or shape C as its own query.
+     *   another rooted $or query, or shape C as its own query. A clause which produces exactly
+     *   one candidate plan never runs through the MultiPlanStage; its lone solution is inserted
+     *   into the plan cache directly so that subsequent executions skip enumeration as well.
      *
      *   --Plans for entire rooted $or queries are neither written to nor read from the plan cache.
      */
@@ -151,6 +153,16 @@ namespace mongo {
          */
         Status planSubqueries();
 
+        /**
+         * Inserts the lone query solution for a branch into the plan cache, so that
+         * subsequent executions of the branch's shape are planned from the cache rather
+         * than enumerated again. The MultiPlanStage handles caching for branches with
+         * two or more candidate plans, but never runs for a branch with one.
+         *
+         * Helper for planSubqueries().
+         */
+        void cacheSingleSolutionBranch(BranchPlanningResult* branchResult);
+
         /**
          * Uses the query planning results from planSubqueries() and the multi plan stage
          * to select the best plan for each branch.
@@ -146,6 +146,10 @@ namespace mongo {
             }
             _scores.erase(scoreIt);
         }
+
+        // Same for the negated-term rejections: the RecordId may be reused for a
+        // different document.
+        _negatedLocs.erase(dl);
     }
 
     vector<PlanStage*> TextStage::getChildren() const {
@@ -181,29 +185,24 @@ namespace mongo {
 
         _specificStats.parsedTextQuery = _params.query.toBSON();
 
+        // If we have no terms we go right to EOF.
+        if (0 == _params.query.getTerms().size()) {
+            _internalState = DONE;
+            return PlanStage::IS_EOF;
+        }
+
         // Get all the index scans for each term in our query.
         for (size_t i = 0; i < _params.query.getTerms().size(); i++) {
             const string& term = _params.query.getTerms()[i];
-            IndexScanParams params;
-            params.bounds.startKey = FTSIndexFormat::getIndexKey(MAX_WEIGHT,
-                                                                 term,
-                                                                 _params.indexPrefix,
-                                                                 _params.spec.getTextIndexVersion());
-            params.bounds.endKey = FTSIndexFormat::getIndexKey(0,
-                                                               term,
-                                                                _params.indexPrefix,
-                                                               _params.spec.getTextIndexVersion());
-            params.bounds.endKeyInclusive = true;
-            params.bounds.isSimpleRange = true;
-            params.descriptor = _params.index;
-            params.direction = -1;
-            _scanners.mutableVector().push_back(new IndexScan(_txn, params, _ws, NULL));
+            _scanners.mutableVector().push_back(newScannerForTerm(term));
         }
 
-        // If we have no terms we go right to EOF.
-        if (0 == _scanners.size()) {
-            _internalState = DONE;
-            return PlanStage::IS_EOF;
+        // Also scan for each negated term.  The index key alone proves a document contains
+        // the term, so these scans let us reject such documents without fetching them.
+        const std::set<string>& negatedTerms = _params.query.getNegatedTerms();
+        for (std::set<string>::const_iterator it = negatedTerms.begin();
+             it != negatedTerms.end(); ++it) {
+            _scanners.mutableVector().push_back(newScannerForTerm(*it));
         }
 
         // Transition to the next state.
@@ -211,6 +210,23 @@ namespace mongo {
         return PlanStage::NEED_TIME;
     }
 
+    IndexScan* TextStage::newScannerForTerm(const std::string& term) {
+        IndexScanParams params;
+        params.bounds.startKey = FTSIndexFormat::getIndexKey(MAX_WEIGHT,
+                                                             term,
+                                                             _params.indexPrefix,
+                                                             _params.spec.getTextIndexVersion());
+        params.bounds.endKey = FTSIndexFormat::getIndexKey(0,
+                                                           term,
+                                                           _params.indexPrefix,
+                                                           _params.spec.getTextIndexVersion());
+        params.bounds.endKeyInclusive = true;
+        params.bounds.isSimpleRange = true;
+        params.descriptor = _params.index;
+        params.direction = -1;
+        return new IndexScan(_txn, params, _ws, NULL);
+    }
+
     PlanStage::StageState TextStage::readFromSubScanners(WorkingSetID* out) {
         // This should be checked before we get here.
         invariant(_currentIndexScanner < _scanners.size());
@@ -223,8 +239,14 @@ namespace mongo {
             WorkingSetMember* wsm = _ws->get(id);
             invariant(1 == wsm->keyData.size());
             invariant(wsm->hasLoc());
-            IndexKeyDatum& keyDatum = wsm->keyData.back();
-            addTerm(keyDatum.keyData, id);
+            if (_currentIndexScanner >= _params.query.getTerms().size()) {
+                // Positive-term scanners come first; this scan covers a negated term.
+                addNegatedTerm(id);
+            }
+            else {
+                IndexKeyDatum& keyDatum = wsm->keyData.back();
+                addTerm(keyDatum.keyData, id);
+            }
             return PlanStage::NEED_TIME;
         }
         else if (PlanStage::IS_EOF == childState) {
@@ -279,6 +301,13 @@ namespace mongo {
             return PlanStage::NEED_TIME;
         }
 
+        // Ignore documents that a negated-term index scan saw; the key proves they contain
+        // a term the query forbids, so there is nothing to fetch and re-tokenize.
+        if (!_negatedLocs.empty() && _negatedLocs.count(wsm->loc) > 0) {
+            _ws->free(textRecordData.wsid);
+            return PlanStage::NEED_TIME;
+        }
+
         // Retrieve the document. We may already have the document due to force-fetching before
         // a yield. If not, then we fetch the document here.
         BSONObj doc;
@@ -292,9 +321,10 @@ namespace mongo {
             wsm->state = WorkingSetMember::LOC_AND_UNOWNED_OBJ;
         }
 
-        // Filter for phrases and negated terms
-        if (_params.query.hasNonTermPieces()) {
-            if (!_ftsMatcher.matchesNonTerm(doc)) {
+        // Filter for phrases.  Negated terms were already handled by the index scans
+        // above, so only phrase pieces still need the document's text.
+        if (!_params.query.getPhr().empty() || !_params.query.getNegatedPhr().empty()) {
+            if (!_ftsMatcher.phrasesMatch(doc)) {
                 _ws->free(textRecordData.wsid);
                 return PlanStage::NEED_TIME;
             }
@@ -364,6 +394,13 @@ namespace mongo {
         bool* _fetched;
     };
 
+    void TextStage::addNegatedTerm(WorkingSetID wsid) {
+        WorkingSetMember* wsm = _ws->get(wsid);
+        ++_specificStats.keysExamined;
+        _negatedLocs.insert(wsm->loc);
+        _ws->free(wsid);
+    }
+
     void TextStage::addTerm(const BSONObj key, WorkingSetID wsid) {
         WorkingSetMember* wsm = _ws->get(wsid);
         TextRecordData* textRecordData = &_scores[wsm->loc];
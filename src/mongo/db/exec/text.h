@@ -39,6 +39,7 @@
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_map.h"
+#include "mongo/platform/unordered_set.h"
 
 #include <map>
 #include <queue>
@@ -52,6 +53,7 @@ namespace mongo {
     using fts::FTSSpec;
     using fts::MAX_WEIGHT;
 
+    class IndexScan;
     class OperationContext;
 
     struct TextStageParams {
@@ -130,6 +132,11 @@ namespace mongo {
          */
         StageState initScans(WorkingSetID* out);
 
+        /**
+         * Builds an index scan over the key range of 'term'.  Caller owns the result.
+         */
+        IndexScan* newScannerForTerm(const std::string& term);
+
         /**
          * Helper for buffering results array.  Returns NEED_TIME (if any results were produced),
          * IS_EOF, or FAILURE.
@@ -143,6 +150,13 @@ namespace mongo {
          */
         void addTerm(const BSONObj key, WorkingSetID wsid);
 
+        /**
+         * Helper called from readFromSubScanners when the current scanner covers a negated
+         * term.  Records the document as rejected; the index key alone proves it contains
+         * the term, so no fetch is needed.
+         */
+        void addNegatedTerm(WorkingSetID wsid);
+
         /**
          * Possibly return a result.  FYI, this may perform a fetch directly if it is needed to
          * evaluate all filters.
@@ -191,6 +205,12 @@ namespace mongo {
         typedef unordered_map<RecordId, TextRecordData, RecordId::Hasher> ScoreMap;
         ScoreMap _scores;
         ScoreMap::const_iterator _scoreIterator;
+
+        // Documents rejected because a negated-term index scan saw them.  Filled out in
+        // READING_TERMS and consulted in RETURNING_RESULTS, which saves fetching every
+        // candidate document just to look for negated terms.
+        typedef unordered_set<RecordId, RecordId::Hasher> RejectedSet;
+        RejectedSet _negatedLocs;
     };
 
 } // namespace mongo
@@ -446,7 +446,7 @@ namespace mongo {
         _specificStats.isDocReplacement = params.driver->isDocReplacement();
     }
 
-    void UpdateStage::transformAndUpdate(BSONObj& oldObj, RecordId& loc) {
+    BSONObj UpdateStage::transformAndUpdate(BSONObj& oldObj, RecordId& loc) {
         const UpdateRequest* request = _params.request;
         UpdateDriver* driver = _params.driver;
         CanonicalQuery* cq = _params.canonicalQuery;
@@ -466,6 +466,13 @@ namespace mongo {
 
         BSONObj logObj;
 
+        // If the request wants the pre-image back, copy it out now: 'oldObj' may alias
+        // record store memory that the write below patches in place or moves.
+        BSONObj oldObjForReturn;
+        if (request->shouldReturnOldDocs()) {
+            oldObjForReturn = oldObj.getOwned();
+        }
+
         FieldRefSet updatedFields;
         bool docWasModified = false;
 
@@ -515,6 +522,8 @@ namespace mongo {
             docWasModified = false;
         }
 
+        BSONObj newObj;
+
         if (docWasModified) {
 
             // Verify that no immutable fields were changed and data is valid for storage.
@@ -533,19 +542,45 @@ namespace mongo {
 
 
             // Prepare to write back the modified document
-            BSONObj newObj;
             WriteUnitOfWork wunit(_txn);
 
+            // For mod-style updates the driver records every path the mods touched, which
+            // lets the collection skip indexes the update provably does not affect.  A
+            // replacement update can change anything, and a document that is just gaining
+            // its _id (via ensureIdAndFirst above) changed a path the driver never saw.
+            const FieldRefSet* updatedPaths =
+                (driver->isDocReplacement() || oldObj["_id"].eoo()) ? NULL : &updatedFields;
+
             if (inPlace) {
 
                 // Don't actually do the write if this is an explain.
                 if (!request->isExplain()) {
                     invariant(_collection);
-                    const RecordData oldRec(oldObj.objdata(), oldObj.objsize());
-                    _collection->updateDocumentWithDamages(_txn, loc, oldRec, source, _damages);
+
+                    // If the mods touch indexed fields, the damage write needs the
+                    // post-update image to refresh the affected index keys.  The document
+                    // itself is still patched in place.
+                    BSONObj objNew = oldObj;
+                    if (driver->modsAffectIndices() || request->shouldReturnNewDocs()) {
+                        objNew = _doc.getObject();
+                    }
+
+                    uassertStatusOK(_collection->updateDocumentWithDamages(
+                        _txn, loc, oldObj, objNew, source, _damages,
+                        driver->modsAffectIndices(), _params.opDebug, updatedPaths));
+
+                    // The document cannot move, but if the mod changes an indexed value we
+                    // might see it again.  For an example, see the comment above near
+                    // declaration of updatedLocs.
+                    if (_updatedLocs && driver->modsAffectIndices()) {
+                        _updatedLocs->insert(loc);
+                    }
                 }
 
-                newObj = oldObj;
+                // The pre-image still aliases the record's bytes, which the damage write
+                // just patched, so a caller wanting the post-image needs a materialized
+                // copy of the mutated document.
+                newObj = request->shouldReturnNewDocs() ? _doc.getObject() : oldObj;
                 _specificStats.fastmod = true;
 
             }
@@ -565,7 +600,8 @@ namespace mongo {
                         _txn,
                         loc, oldObj, newObj,
                         true, driver->modsAffectIndices(),
-                        _params.opDebug);
+                        _params.opDebug,
+                        updatedPaths);
                     uassertStatusOK(res.getStatus());
                     RecordId newLoc = res.getValue();
 
@@ -601,6 +637,15 @@ namespace mongo {
         if (docWasModified || request->isExplain()) {
             _specificStats.nModified++;
         }
+
+        if (request->shouldReturnOldDocs()) {
+            return oldObjForReturn;
+        }
+        if (request->shouldReturnNewDocs()) {
+            // A no-op update leaves the document as it was.
+            return docWasModified ? newObj.getOwned() : oldObj.getOwned();
+        }
+        return BSONObj();
     }
 
     void UpdateStage::doInsert() {
@@ -732,6 +777,19 @@ namespace mongo {
             // Even if we're done updating, we may have some inserting left to do.
             if (needInsert()) {
                 doInsert();
+
+                invariant(isEOF());
+                if (_params.request->shouldReturnNewDocs() && !_params.request->isExplain()) {
+                    // Hand the inserted document back to the caller (findAndModify with
+                    // {upsert: true, new: true}).
+                    WorkingSetID id = _ws->allocate();
+                    WorkingSetMember* member = _ws->get(id);
+                    member->obj = _specificStats.objInserted;
+                    member->state = WorkingSetMember::OWNED_OBJ;
+                    *out = id;
+                    ++_commonStats.advanced;
+                    return PlanStage::ADVANCED;
+                }
             }
 
             // At this point either we're done updating and there was no insert to do,
@@ -811,12 +869,13 @@ namespace mongo {
             _child->saveState();
 
             // Do the update and return.
+            BSONObj returnObj;
             BSONObj reFetched;
             uint64_t attempt = 1;
 
             while ( attempt++ ) {
                 try {
-                    transformAndUpdate(reFetched.isEmpty() ? oldObj : reFetched , loc);
+                    returnObj = transformAndUpdate(reFetched.isEmpty() ? oldObj : reFetched , loc);
                     break;
                 }
                 catch ( const WriteConflictException& de ) {
@@ -867,6 +926,19 @@ namespace mongo {
 
             _child->restoreState(_txn);
 
+            if (_params.request->shouldReturnAnyDocs() && !returnObj.isEmpty()) {
+                // Hand the requested version of the modified document back to the caller
+                // (findAndModify).  'returnObj' stays empty if the write-conflict loop
+                // above found the document deleted or no longer matching.
+                WorkingSetID retId = _ws->allocate();
+                WorkingSetMember* retMember = _ws->get(retId);
+                retMember->obj = returnObj;
+                retMember->state = WorkingSetMember::OWNED_OBJ;
+                *out = retId;
+                ++_commonStats.advanced;
+                return PlanStage::ADVANCED;
+            }
+
             ++_commonStats.needTime;
             return PlanStage::NEED_TIME;
         }
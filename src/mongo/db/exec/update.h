@@ -72,7 +72,9 @@ namespace mongo {
 
     /**
      * Execution stage responsible for updates to documents and upserts. NEED_TIME is returned
-     * after performing an update or an insert.
+     * after performing an update or an insert, unless the request asks for the old or new
+     * version of the modified document (findAndModify), in which case the stage ADVANCEs with
+     * that document instead.
      *
      * Callers of work() must be holding a write lock.
      */
@@ -119,8 +121,11 @@ namespace mongo {
         /**
          * Computes the result of applying mods to the document 'oldObj' at RecordId 'loc' in
          * memory, then commits these changes to the database.
+         *
+         * Returns the image of the document the request asked to get back (the old or the
+         * new version), or an empty BSONObj if the request does not return documents.
          */
-        void transformAndUpdate(BSONObj& oldObj, RecordId& loc);
+        BSONObj transformAndUpdate(BSONObj& oldObj, RecordId& loc);
 
         /**
          * Computes the document to insert and inserts it into the collection. Used if the
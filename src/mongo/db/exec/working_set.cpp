@@ -46,13 +46,19 @@ namespace mongo {
 
     WorkingSetID WorkingSet::allocate() {
         if (_freeList == INVALID_ID) {
-            // The free list is empty so we need to make a single new WSM to return. This relies on
-            // vector::resize being amortized O(1) for efficient allocation. Note that the free list
-            // remains empty until something is returned by a call to free().
-            WorkingSetID id = _data.size();
-            _data.resize(_data.size() + 1);
-            _data.back().nextFreeOrSelf = id;
-            _data.back().member = new WorkingSetMember();
+            // The free list is empty so we grow a chunk of new WSMs at once, return the first
+            // and push the rest onto the free list. This amortizes the allocator round trips
+            // over kAllocationChunk documents instead of paying one per document that flows
+            // through a stage while the set is still growing.
+            const WorkingSetID id = _data.size();
+            _data.resize(_data.size() + kAllocationChunk);
+            _data[id].nextFreeOrSelf = id; // in use
+            _data[id].member = new WorkingSetMember();
+            for (size_t i = id + 1; i < _data.size(); i++) {
+                _data[i].member = new WorkingSetMember();
+                _data[i].nextFreeOrSelf = _freeList;
+                _freeList = i;
+            }
             return id;
         }
 
@@ -90,14 +96,16 @@ namespace mongo {
     }
 
     void WorkingSet::clear() {
+        // Keep the WorkingSetMember allocations around but release their resources and chain
+        // every slot back onto the free list. Callers that clear between plan attempts (e.g.
+        // SubplanStage running each $or branch) then recycle the members instead of paying to
+        // reallocate them all.
+        _freeList = INVALID_ID;
         for (size_t i = 0; i < _data.size(); i++) {
-            delete _data[i].member;
+            _data[i].member->clear();
+            _data[i].nextFreeOrSelf = _freeList;
+            _freeList = i;
         }
-        _data.clear();
-
-        // Since working set is now empty, the free list pointer should
-        // point to nothing.
-        _freeList = INVALID_ID;
 
         _flagged.clear();
     }
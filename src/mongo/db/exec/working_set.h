@@ -161,6 +161,11 @@ namespace mongo {
         WorkingSet::iterator end();
 
     private:
+        // How many WorkingSetMembers allocate() news up when the free list runs dry. Recycling
+        // through free()/clear() means a scan's steady state allocates nothing; this just
+        // batches the allocations made while the set is still growing.
+        static const size_t kAllocationChunk = 16;
+
         struct MemberHolder {
             MemberHolder();
             ~MemberHolder();
@@ -243,4 +243,27 @@ namespace {
         ASSERT_EQ(counter, 1);
     }
 
+    TEST(WorkingSetTest, ClearRecyclesMembers) {
+        WorkingSet ws;
+
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* member = ws.get(id);
+        member->state = WorkingSetMember::OWNED_OBJ;
+        member->obj = BSON("a" << 1);
+
+        // clear() releases the member's resources but keeps the allocation for reuse.
+        ws.clear();
+
+        int counter = 0;
+        for (WorkingSet::iterator it = ws.begin(); it != ws.end(); ++it) {
+            counter++;
+        }
+        ASSERT_EQ(counter, 0);
+
+        WorkingSetID recycledId = ws.allocate();
+        WorkingSetMember* recycled = ws.get(recycledId);
+        ASSERT_EQUALS(WorkingSetMember::INVALID, recycled->state);
+        ASSERT_TRUE(recycled->obj.isEmpty());
+    }
+
 }  // namespace
@@ -79,7 +79,7 @@ namespace mongo {
                                                   const string& raw ) const {
 
             Tokenizer i( *language, raw );
-            Stemmer stemmer( *language );
+            const Stemmer& stemmer = Stemmer::forLanguage( *language );
             while ( i.more() ) {
                 Token t = i.next();
                 if ( t.type != Token::TEXT )
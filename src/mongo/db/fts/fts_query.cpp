@@ -55,7 +55,7 @@ namespace mongo {
             _language = swl.getValue();
 
             const StopWords* stopWords = StopWords::getStopWords( *_language );
-            Stemmer stemmer( *_language );
+            const Stemmer& stemmer = Stemmer::forLanguage( *_language );
 
             bool inNegation = false;
             bool inPhrase = false;
@@ -117,7 +117,7 @@ namespace mongo {
             return Status::OK();
         }
 
-        void FTSQuery::_addTerm( const StopWords* sw, Stemmer& stemmer, const string& term, bool negated ) {
+        void FTSQuery::_addTerm( const StopWords* sw, const Stemmer& stemmer, const string& term, bool negated ) {
             string word = tolowerString( term );
             if ( sw->isStopWord( word ) )
                 return;
@@ -91,7 +91,7 @@ namespace mongo {
             std::vector<std::string> _negatedPhrases;
 
         private:
-            void _addTerm( const StopWords* sw, Stemmer& stemmer, const std::string& term, bool negated );
+            void _addTerm( const StopWords* sw, const Stemmer& stemmer, const std::string& term, bool negated );
         };
 
     }
@@ -168,7 +168,7 @@ namespace mongo {
 
             while ( it.more() ) {
                 FTSIteratorValue val = it.next();
-                Stemmer stemmer( *val._language );
+                const Stemmer& stemmer = Stemmer::forLanguage( *val._language );
                 Tools tools( *val._language, &stemmer, StopWords::getStopWords( *val._language ) );
                 _scoreStringV2( tools, val._text, term_freqs, val._weight );
             }
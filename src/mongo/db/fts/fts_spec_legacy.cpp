@@ -160,7 +160,7 @@ namespace mongo {
 
             const FTSLanguage& language = _getLanguageToUseV1( obj );
 
-            Stemmer stemmer(language);
+            const Stemmer& stemmer = Stemmer::forLanguage(language);
             Tools tools(language, &stemmer, StopWords::getStopWords( language ));
 
             if ( wildcard() ) {
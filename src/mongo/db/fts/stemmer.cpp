@@ -29,8 +29,11 @@
 */
 
 #include <cstdlib>
+#include <map>
 #include <string>
 
+#include <boost/thread/tss.hpp>
+
 #include "mongo/db/fts/stemmer.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -38,6 +41,39 @@ namespace mongo {
 
     namespace fts {
 
+        namespace {
+
+            // One stemmer per language per thread, created on first use.  Building a
+            // snowball stemmer is far more expensive than stemming a word, and callers
+            // used to build one per document field.
+            typedef std::map<std::string, Stemmer*> StemmerPool;
+
+            void deleteStemmerPool( StemmerPool* pool ) {
+                for ( StemmerPool::const_iterator it = pool->begin();
+                      it != pool->end(); ++it ) {
+                    delete it->second;
+                }
+                delete pool;
+            }
+
+            boost::thread_specific_ptr<StemmerPool> threadStemmers( deleteStemmerPool );
+        }
+
+        // static
+        const Stemmer& Stemmer::forLanguage( const FTSLanguage& language ) {
+            StemmerPool* pool = threadStemmers.get();
+            if ( !pool ) {
+                pool = new StemmerPool();
+                threadStemmers.reset( pool );
+            }
+
+            Stemmer*& stemmer = (*pool)[language.str()];
+            if ( !stemmer ) {
+                stemmer = new Stemmer( language );
+            }
+            return *stemmer;
+        }
+
         Stemmer::Stemmer( const FTSLanguage& language ) {
             _stemmer = NULL;
             if ( language.str() != "none" )
@@ -55,6 +91,12 @@ namespace mongo {
             if ( !_stemmer )
                 return word.toString();
 
+            const string key = word.toString();
+            StemCache::const_iterator it = _cache.find( key );
+            if ( it != _cache.end() ) {
+                return it->second;
+            }
+
             const sb_symbol* sb_sym = sb_stemmer_stem( _stemmer,
                                                        (const sb_symbol*)word.rawData(),
                                                        word.size() );
@@ -64,7 +106,14 @@ namespace mongo {
                 abort();
             }
 
-            return string( (const char*)(sb_sym), sb_stemmer_length( _stemmer ) );
+            const string stemmed( (const char*)(sb_sym), sb_stemmer_length( _stemmer ) );
+
+            if ( _cache.size() >= kCacheSize ) {
+                _cache.clear();
+            }
+            _cache[key] = stemmed;
+
+            return stemmed;
         }
 
     }
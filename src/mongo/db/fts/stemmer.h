@@ -35,6 +35,7 @@
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/platform/unordered_map.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -45,6 +46,9 @@ namespace mongo {
          * maintains case
          * but works
          * running/Running -> run/Run
+         *
+         * Memoizes its results, so a single instance must not be shared between
+         * threads.  Use forLanguage() to get an instance owned by the current thread.
          */
         class Stemmer {
         public:
@@ -52,8 +56,24 @@ namespace mongo {
             ~Stemmer();
 
             std::string stem( const StringData& word ) const;
+
+            /**
+             * Returns a stemmer for 'language' owned by the current thread.  The
+             * instance (and its memo cache) lives for the life of the thread, so
+             * repeated indexing or matching work reuses both the snowball allocation
+             * and previously computed stems.
+             */
+            static const Stemmer& forLanguage( const FTSLanguage& language );
+
         private:
             struct sb_stemmer* _stemmer;
+
+            // Memoizes stem() results.  Natural-language fields repeat words
+            // constantly, so even a small cache hits most of the time.  Emptied when
+            // it reaches kCacheSize; real LRU bookkeeping costs more than it saves.
+            static const size_t kCacheSize = 10000;
+            typedef unordered_map<std::string, std::string> StemCache;
+            mutable StemCache _cache;
         };
     }
 }
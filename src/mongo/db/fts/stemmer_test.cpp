@@ -49,5 +49,19 @@ namespace mongo {
             ASSERT_EQUALS( "Unite", s.stem( "United" ) );
         }
 
+        // The memo cache must hand back the same answer on repeated stems, and
+        // forLanguage() must reuse one instance per language on a given thread.
+        TEST( English, CachedStems ) {
+            Stemmer s( languageEnglishV2 );
+            ASSERT_EQUALS( "run", s.stem( "running" ) );
+            ASSERT_EQUALS( "run", s.stem( "running" ) );
+            ASSERT_EQUALS( "Run", s.stem( "Running" ) );
+
+            const Stemmer& a = Stemmer::forLanguage( languageEnglishV2 );
+            const Stemmer& b = Stemmer::forLanguage( languageEnglishV2 );
+            ASSERT_EQUALS( &a, &b );
+            ASSERT_EQUALS( "run", a.stem( "running" ) );
+        }
+
     }
 }
@@ -99,6 +99,14 @@ namespace mongo {
         verify(_minLevel <= _maxLevel);
         dassert(_candidateQueue->empty());
         dassert(_results->empty());
+
+        // Axis-aligned boxes are the common case for viewport-style queries, and for
+        // them the subdivision search below is pure overhead - the covering can be read
+        // directly off the grid.
+        if (getBoxCovering(region, cover)) {
+            return;
+        }
+
         _region = &region;
 
         getInitialCandidates();
@@ -222,6 +230,68 @@ namespace mongo {
         addCandidate(newCandidate(GeoHash()));
     }
 
+    bool R2RegionCoverer::getBoxCovering( const R2Region& region, vector<GeoHash>* cover ) {
+        const Box bounds = region.getR2Bounds();
+
+        // Only an axis-aligned box contains its own bounding box.
+        if (!region.fastContains(bounds))
+            return false;
+
+        const unsigned finestLevel = min(_maxLevel, (unsigned)_hashConverter->getBits());
+        if (finestLevel < _minLevel)
+            return false;
+
+        const double domainMin = _hashConverter->getMin();
+        const double domainMax = _hashConverter->getMax();
+
+        // Expand by the same error bound unhashToBoxCovering() fudges cell boxes with,
+        // so the covering is never tighter than the one the subdivision search finds,
+        // then clamp to the hashable domain.
+        Box box(bounds);
+        box.fudge(GeoHashConverter::calcUnhashToBoxError(_hashConverter->getParams()));
+        box.truncate(domainMin, domainMax);
+
+        if (box._min.x > box._max.x || box._min.y > box._max.y) {
+            // Entirely outside the hashable domain - nothing can match
+            cover->clear();
+            return true;
+        }
+
+        // Find the finest level at which the box spans no more than _maxCells grid
+        // cells, or stop at _minLevel.  Cell indices are simply the coordinates
+        // expressed in units of the cell edge length at a given level.
+        unsigned level = finestLevel;
+        long long firstX = 0, lastX = 0, firstY = 0, lastY = 0;
+        for (;; --level) {
+            const double edge = _hashConverter->sizeEdge(level);
+            const long long lastIndex = (1LL << level) - 1;
+
+            firstX = max(0LL, min(lastIndex, (long long)floor((box._min.x - domainMin) / edge)));
+            lastX = max(0LL, min(lastIndex, (long long)floor((box._max.x - domainMin) / edge)));
+            firstY = max(0LL, min(lastIndex, (long long)floor((box._min.y - domainMin) / edge)));
+            lastY = max(0LL, min(lastIndex, (long long)floor((box._max.y - domainMin) / edge)));
+
+            if (level == _minLevel)
+                break;
+            if ((lastX - firstX + 1) * (lastY - firstY + 1) <= (long long)_maxCells)
+                break;
+        }
+
+        cover->clear();
+        const double edge = _hashConverter->sizeEdge(level);
+        for (long long i = firstX; i <= lastX; ++i) {
+            for (long long j = firstY; j <= lastY; ++j) {
+                // Hash the center of cell (i, j) and truncate to the covering level.
+                // Cell centers are always strictly inside the hashable domain.
+                const double x = domainMin + (i + 0.5) * edge;
+                const double y = domainMin + (j + 0.5) * edge;
+                cover->push_back(_hashConverter->hash(x, y).parent(level));
+            }
+        }
+
+        return true;
+    }
+
     //
     // R2CellUnion
     //
@@ -94,6 +94,13 @@ namespace mongo {
         // Computes a set of initial candidates that cover the given region.
         void getInitialCandidates();
 
+        // Fast path for regions which are exactly their own bounding box, i.e.
+        // axis-aligned box predicates.  Chooses a single cell level from the box
+        // dimensions and reads the covering straight off the grid with one hash per
+        // cell, instead of subdividing down from the full plane.  Returns false for
+        // non-box regions, which use the generic subdivision search.
+        bool getBoxCovering(const R2Region& region, vector<GeoHash>* cover);
+
         GeoHashConverter* _hashConverter; // Not owned.
         // min / max level as unsigned so as to be consistent with GeoHash
         unsigned int _minLevel;
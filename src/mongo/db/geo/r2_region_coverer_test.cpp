@@ -255,6 +255,42 @@ namespace {
         return container;
     }
 
+    // Generate a box within [0, MAXBOUND]
+    GeometryContainer* getRandomBox() {
+        double x1 = randDouble(0.0, MAXBOUND);
+        double y1 = randDouble(0.0, MAXBOUND);
+        double x2 = randDouble(0.0, MAXBOUND);
+        double y2 = randDouble(0.0, MAXBOUND);
+
+        // Format: { $box : [ [ x1, y1 ], [ x2, y2 ] ] }
+        GeometryContainer* container = new GeometryContainer();
+        container->parseFromQuery(BSON("$box"
+                << BSON_ARRAY(
+                        BSON_ARRAY(min(x1, x2) << min(y1, y2))
+                        << BSON_ARRAY(max(x1, x2) << max(y1, y2)))).firstElement());
+        return container;
+    }
+
+    // Test the covering for arbitrary random boxes, which take the direct grid covering
+    // path rather than the subdivision search.
+    TEST(R2RegionCoverer, RandomBoxes) {
+        GeoHashConverter converter(getConverterParams());
+        R2RegionCoverer coverer(&converter);
+        coverer.setMaxCells( 8 );
+
+        for (int i = 0; i < 1000; i++) {
+            coverer.setMinLevel( rand.nextInt32( 7 ) );
+            coverer.setMaxLevel( coverer.minLevel() + 4 );
+
+            auto_ptr<GeometryContainer> geometry(getRandomBox());
+            const R2Region& region = geometry->getR2Region();
+
+            vector<GeoHash> covering;
+            coverer.getCovering(region, &covering);
+            checkCovering(converter, region, coverer, covering);
+        }
+    }
+
     // Test the covering for arbitrary random circle.
     TEST(R2RegionCoverer, RandomCircles) {
         GeoHashConverter converter(getConverterParams());
@@ -34,11 +34,13 @@
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/index/btree_based_bulk_access_method.h"
 #include "mongo/db/index/btree_index_cursor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/matcher/expression.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/util/log.h"
@@ -62,17 +64,34 @@ namespace mongo {
         return !txn->isPrimaryFor(_btreeState->ns()) || !failIndexKeyTooLong;
     }
 
+    void BtreeBasedAccessMethod::computeKeys(const BSONObj& obj, BSONObjSet* keys) {
+        // Partial indexes only contain documents matching their filter expression.
+        const MatchExpression* filter = _btreeState->getFilterExpression();
+        if (filter && !filter->matchesBSON(obj)) {
+            return;
+        }
+
+        // Delegate to the subclass.
+        getKeys(obj, keys);
+    }
+
     // Find the keys for obj, put them in the tree pointing to loc
     Status BtreeBasedAccessMethod::insert(OperationContext* txn,
                                           const BSONObj& obj,
                                           const RecordId& loc,
                                           const InsertDeleteOptions& options,
                                           int64_t* numInserted) {
-        *numInserted = 0;
-
         BSONObjSet keys;
-        // Delegate to the subclass.
-        getKeys(obj, &keys);
+        computeKeys(obj, &keys);
+        return insertPrecomputedKeys(txn, keys, loc, options, numInserted);
+    }
+
+    Status BtreeBasedAccessMethod::insertPrecomputedKeys(OperationContext* txn,
+                                                         const BSONObjSet& keys,
+                                                         const RecordId& loc,
+                                                         const InsertDeleteOptions& options,
+                                                         int64_t* numInserted) {
+        *numInserted = 0;
 
         Status ret = Status::OK();
         for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
@@ -142,10 +161,16 @@ namespace mongo {
                                           const RecordId& loc,
                                           const InsertDeleteOptions &options,
                                           int64_t* numDeleted) {
+        *numDeleted = 0;
+
+        // A document not matching a partial index's filter was never indexed.
+        const MatchExpression* filter = _btreeState->getFilterExpression();
+        if (filter && !filter->matchesBSON(obj)) {
+            return Status::OK();
+        }
 
         BSONObjSet keys;
         getKeys(obj, &keys);
-        *numDeleted = 0;
 
         for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
             removeOneKey(txn, *i, loc, options.dupsAllowed);
@@ -244,8 +269,15 @@ namespace mongo {
         BtreeBasedPrivateUpdateData *data = new BtreeBasedPrivateUpdateData();
         status->_indexSpecificUpdateData.reset(data);
 
-        getKeys(from, &data->oldKeys);
-        getKeys(to, &data->newKeys);
+        // Documents falling outside a partial index's filter contribute no keys; an update
+        // moving a document across the filter boundary indexes or unindexes it here.
+        const MatchExpression* filter = _btreeState->getFilterExpression();
+        if (!filter || filter->matchesBSON(from)) {
+            getKeys(from, &data->oldKeys);
+        }
+        if (!filter || filter->matchesBSON(to)) {
+            getKeys(to, &data->newKeys);
+        }
         data->loc = record;
         data->dupsAllowed = options.dupsAllowed;
 
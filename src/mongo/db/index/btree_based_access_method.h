@@ -68,6 +68,23 @@ namespace mongo {
                               const InsertDeleteOptions& options,
                               int64_t* numInserted);
 
+        /**
+         * Computes the keys insert() would add for 'obj', honoring a partial index's filter
+         * expression.  Key generation has no side effects on the index, so this is safe to
+         * call from a worker thread while the writer thread does other work.
+         */
+        void computeKeys(const BSONObj& obj, BSONObjSet* keys);
+
+        /**
+         * As insert(), but takes 'keys' previously produced by computeKeys() for the
+         * document at 'loc'.
+         */
+        Status insertPrecomputedKeys(OperationContext* txn,
+                                     const BSONObjSet& keys,
+                                     const RecordId& loc,
+                                     const InsertDeleteOptions& options,
+                                     int64_t* numInserted);
+
         virtual Status remove(OperationContext* txn,
                               const BSONObj& obj,
                               const RecordId& loc,
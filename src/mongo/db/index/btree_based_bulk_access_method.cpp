@@ -98,8 +98,9 @@ namespace mongo {
                                               const RecordId& loc,
                                               const InsertDeleteOptions& options,
                                               int64_t* numInserted) {
+        // computeKeys() produces no keys for documents outside a partial index's filter.
         BSONObjSet keys;
-        _real->getKeys(obj, &keys);
+        _real->computeKeys(obj, &keys);
 
         _isMultiKey = _isMultiKey || (keys.size() > 1);
 
@@ -99,6 +99,11 @@ namespace mongo {
         advance();
     }
 
+    size_t BtreeIndexCursor::nextBatch(std::vector<IndexKeyEntry>* entries, size_t maxToFill) {
+        // Let the storage engine cursor fill the whole batch in one call.
+        return _cursor->nextBatch(entries, maxToFill);
+    }
+
     Status BtreeIndexCursor::savePosition() {
         _cursor->savePosition();
         return Status::OK();
@@ -68,6 +68,8 @@ namespace mongo {
         virtual RecordId getValue() const;
         virtual void next();
 
+        virtual size_t nextBatch(std::vector<IndexKeyEntry>* entries, size_t maxToFill);
+
         /**
          * BtreeIndexCursor-only.
          * Returns true if 'this' points at the same exact key as 'other'.
@@ -32,6 +32,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/index_entry_comparison.h"
 
 namespace mongo {
 
@@ -76,7 +77,29 @@ namespace mongo {
 
         // Move to the next key/value pair.  Assumes !isEOF().
         virtual void next() = 0;
-        
+
+        /**
+         * Append up to 'maxToFill' (key, RecordId) pairs to 'entries', starting with the
+         * entry the cursor points at and advancing once per entry appended.  Stops early
+         * at EOF.  The appended keys are owned copies.
+         *
+         * The default implementation loops over getKey()/getValue()/next().  Cursors
+         * backed by a storage engine should override this to fill the batch in a single
+         * call so bulk consumers avoid per-key virtual dispatch.
+         *
+         * Returns the number of entries appended.
+         */
+        virtual size_t nextBatch(std::vector<IndexKeyEntry>* entries, size_t maxToFill) {
+            size_t numAppended = 0;
+            while (numAppended < maxToFill && !isEOF()) {
+                entries->push_back(IndexKeyEntry(getKey().getOwned(), getValue()));
+                next();
+                numAppended++;
+            }
+            return numAppended;
+        }
+
+
         //
         // Accessors
         //
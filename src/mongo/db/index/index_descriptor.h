@@ -68,6 +68,8 @@ namespace mongo {
               _isIdIndex(isIdIndexPattern( _keyPattern )),
               _sparse(infoObj["sparse"].trueValue()),
               _unique( _isIdIndex || infoObj["unique"].trueValue() ),
+              _partialFilterExpression(
+                  infoObj.getObjectField("partialFilterExpression").getOwned()),
               _cachedEntry( NULL )
         {
             _indexNamespace = makeIndexNamespace( _parentNS, _indexName );
@@ -126,6 +128,14 @@ namespace mongo {
         // Is this index sparse?
         bool isSparse() const { return _sparse; }
 
+        // Is this a partial index?  Partial indexes only contain documents matching their
+        // filter expression.
+        bool isPartial() const { return !_partialFilterExpression.isEmpty(); }
+
+        // Return the filter expression of a partial index, or an empty object for a
+        // complete index.
+        const BSONObj& partialFilterExpression() const { return _partialFilterExpression; }
+
         // Is this index multikey?
         bool isMultikey( OperationContext* txn ) const {
             _checkOk();
@@ -200,6 +210,7 @@ namespace mongo {
         bool _isIdIndex;
         bool _sparse;
         bool _unique;
+        BSONObj _partialFilterExpression;
         int _version;
 
         // only used by IndexCatalogEntryContainer to do caching for perf
@@ -38,6 +38,7 @@
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/index_create.h"
@@ -161,7 +162,42 @@ namespace {
                 AutoGetDb autoDb(txn, *dbName, MODE_S);
 
                 Database* db = autoDb.getDb();
-                db->getDatabaseCatalogEntry()->getCollectionNamespaces(&collNames);
+                const DatabaseCatalogEntry* dbEntry = db->getDatabaseCatalogEntry();
+
+                std::list<std::string> allColls;
+                dbEntry->getCollectionNamespaces(&allColls);
+
+                // Only hand checkNS() the namespaces that actually have work: it takes
+                // the database lock exclusively and instantiates the collection and its
+                // index catalog for every name it is given, which for a large clean
+                // catalog is almost all of the startup cost. Everything else keeps its
+                // index metadata unloaded until the collection is first used.
+                for (std::list<std::string>::const_iterator ns = allColls.begin();
+                     ns != allColls.end();
+                     ++ns) {
+
+                    CollectionCatalogEntry* cce = dbEntry->getCollectionCatalogEntry(*ns);
+                    if (!cce)
+                        continue;
+
+                    std::vector<std::string> indexNames;
+                    cce->getAllIndexes(txn, &indexNames);
+
+                    bool check = false;
+                    if (NamespaceString::oplog(*ns)) {
+                        // checkNS() strips illegal oplog indexes, finished or not
+                        check = !indexNames.empty();
+                    }
+                    else {
+                        for (size_t i = 0; i < indexNames.size() && !check; i++) {
+                            check = !cce->isIndexReady(txn, indexNames[i]);
+                        }
+                    }
+
+                    if (check) {
+                        collNames.push_back(*ns);
+                    }
+                }
             }
             checkNS(txn, collNames);
         }
@@ -54,6 +54,7 @@
 #include "mongo/db/auth/security_key.h"
 #include "mongo/db/server_options.h"
 #include "mongo/logger/logger.h"
+#include "mongo/logger/async_message_appender.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/message_event.h"
 #include "mongo/logger/message_event_utf8_encoder.h"
@@ -280,11 +281,16 @@ namespace mongo {
             }
 
             LogManager* manager = logger::globalLogManager();
+            MessageLogDomain::EventAppender* fileAppender =
+                new RotatableFileAppender<MessageEventEphemeral>(
+                        new MessageEventDetailsEncoder, writer.getValue());
+            if (serverGlobalParams.logAsync) {
+                // Move encoding and file writes off the operation threads.
+                fileAppender = new logger::AsyncMessageAppender(fileAppender);
+            }
             manager->getGlobalDomain()->clearAppenders();
             manager->getGlobalDomain()->attachAppender(
-                    MessageLogDomain::AppenderAutoPtr(
-                            new RotatableFileAppender<MessageEventEphemeral>(
-                                    new MessageEventDetailsEncoder, writer.getValue())));
+                    MessageLogDomain::AppenderAutoPtr(fileAppender));
             manager->getNamedDomain("javascriptOutput")->attachAppender(
                     MessageLogDomain::AppenderAutoPtr(
                             new RotatableFileAppender<MessageEventEphemeral>(
@@ -63,6 +63,7 @@
 #include "mongo/db/lasterror.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/mongod_options.h"
+#include "mongo/db/namespace_intern.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/exec/delete.h"
@@ -79,6 +80,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/process_id.h"
@@ -208,6 +210,15 @@ namespace mongo {
                 Status status = client->getAuthorizationSession()->checkAuthForQuery(ns, q.query);
                 audit::logQueryAuthzCheck(client, ns, q.query, status.code());
                 uassertStatusOK(status);
+
+                // Plain queries never write through their own recovery unit, so let the
+                // storage engine skip its write bookkeeping. Not done for DBDirectClient
+                // queries, which run nested inside another operation whose recovery unit
+                // must keep whatever mode it already has. The declaration is dropped again
+                // below, before the profiler may want to write.
+                if (!fromDBDirectClient) {
+                    txn->recoveryUnit()->setIsReadOnly(true);
+                }
             }
             dbresponse.exhaustNS = runQuery(txn, m, q, op, *resp, fromDBDirectClient);
             verify( !resp->empty() );
@@ -221,6 +232,15 @@ namespace mongo {
             ok = false;
         }
 
+        // If runQuery handed the read-only recovery unit off to a ClientCursor, the
+        // operation now owns a fresh read-write unit and this is a no-op. Otherwise the
+        // reads are done and this drops the declaration (and the snapshot pinned under
+        // it), so anything that writes after the query -- the profiler in particular --
+        // goes through the normal write path.
+        if (!fromDBDirectClient) {
+            txn->recoveryUnit()->setIsReadOnly(false);
+        }
+
         if( ex ){
 
             op.debug().exceptionInfo = ex->getInfo();
@@ -377,6 +397,10 @@ namespace mongo {
         OpDebug& debug = currentOp.debug();
         debug.op = op;
 
+        // The locker's wait total spans the life of the client, so remember where it stood
+        // when this operation started in order to attribute the difference to it.
+        const long long lockWaitBase = txn->lockState()->getCumulativeLockWaitMicros();
+
         long long logThreshold = serverGlobalParams.slowMS;
         LogComponent responseComponent(LogComponent::kQuery);
         if (op == dbInsert ||
@@ -481,6 +505,13 @@ namespace mongo {
         currentOp.ensureStarted();
         currentOp.done();
         debug.executionTime = currentOp.totalTimeMillis();
+        debug.lockWaitMicros =
+            txn->lockState()->getCumulativeLockWaitMicros() - lockWaitBase;
+
+        globalLatencyHistograms.record(op,
+                                       isCommand,
+                                       currentOp.totalTimeMicros(),
+                                       debug.lockWaitMicros);
 
         logThreshold += currentOp.getExpectedLatencyMs();
 
@@ -533,7 +564,11 @@ namespace mongo {
 
     void receivedUpdate(OperationContext* txn, Message& m, CurOp& op) {
         DbMessage d(m);
-        NamespaceString ns(d.getns());
+        // Hot namespaces resolve to an interned entry: the parsed NamespaceString is
+        // shared rather than copied and the lock ResourceIds below are precomputed.
+        const InternedNamespace* const interned = InternedNamespace::intern(d.getns());
+        const NamespaceString uninterned(interned ? StringData() : StringData(d.getns()));
+        const NamespaceString& ns = interned ? interned->nss() : uninterned;
         uassertStatusOK( userAllowedWriteNS( ns ) );
         op.debug().ns = ns.ns();
         int flags = d.pullInt();
@@ -579,12 +614,12 @@ namespace mongo {
 
                 //  Tentatively take an intent lock, fix up if we need to create the collection
                 ScopedTransaction transaction(txn, MODE_IX);
-                Lock::DBLock dbLock(txn->lockState(), ns.db(), MODE_IX);
+                Lock::DBLock dbLock(txn->lockState(), interned, ns.db(), MODE_IX);
                 if (dbHolder().get(txn, ns.db()) == NULL) {
                     //  If DB doesn't exist, don't implicitly create it in Client::Context
                     break;
                 }
-                Lock::CollectionLock colLock(txn->lockState(), ns.ns(), MODE_IX);
+                Lock::CollectionLock colLock(txn->lockState(), interned, ns.ns(), MODE_IX);
                 Client::Context ctx(txn, ns);
 
                 //  The common case: no implicit collection creation
@@ -624,7 +659,7 @@ namespace mongo {
             uassertStatusOK(parsedUpdate.parseRequest());
 
             ScopedTransaction transaction(txn, MODE_IX);
-            Lock::DBLock dbLock(txn->lockState(), ns.db(), MODE_X);
+            Lock::DBLock dbLock(txn->lockState(), interned, ns.db(), MODE_X);
             Client::Context ctx(txn, ns);
             Database* db = ctx.db();
             if ( db->getCollection( ns ) ) {
@@ -658,7 +693,9 @@ namespace mongo {
 
     void receivedDelete(OperationContext* txn, Message& m, CurOp& op) {
         DbMessage d(m);
-        NamespaceString ns(d.getns());
+        const InternedNamespace* const interned = InternedNamespace::intern(d.getns());
+        const NamespaceString uninterned(interned ? StringData() : StringData(d.getns()));
+        const NamespaceString& ns = interned ? interned->nss() : uninterned;
         uassertStatusOK( userAllowedWriteNS( ns ) );
 
         op.debug().ns = ns.ns();
@@ -693,7 +730,7 @@ namespace mongo {
                     break;
                 }
 
-                Lock::CollectionLock colLock(txn->lockState(), ns.ns(), MODE_IX);
+                Lock::CollectionLock colLock(txn->lockState(), interned, ns.ns(), MODE_IX);
                 Client::Context ctx(txn, ns);
 
                 PlanExecutor* rawExec;
@@ -882,12 +919,12 @@ namespace mongo {
         wunit.commit();
     }
 
-    NOINLINE_DECL void insertMulti(OperationContext* txn,
-                                   Client::Context& ctx,
-                                   bool keepGoing,
-                                   const char *ns,
-                                   vector<BSONObj>& objs,
-                                   CurOp& op) {
+    NOINLINE_DECL void insertMultiSingletons(OperationContext* txn,
+                                             Client::Context& ctx,
+                                             bool keepGoing,
+                                             const char *ns,
+                                             vector<BSONObj>& objs,
+                                             CurOp& op) {
         size_t i;
         for (i=0; i<objs.size(); i++){
             try {
@@ -907,6 +944,53 @@ namespace mongo {
         op.debug().ninserted = i;
     }
 
+    NOINLINE_DECL void insertMulti(OperationContext* txn,
+                                   Client::Context& ctx,
+                                   bool keepGoing,
+                                   const char *ns,
+                                   vector<BSONObj>& objs,
+                                   CurOp& op) {
+        Collection* collection = ctx.db()->getCollection( ns );
+        if ( !collection ) {
+            // checkAndInsert() creates the collection (and logs the create) as it
+            // goes; implicit creation doesn't warrant a batched fast path.
+            insertMultiSingletons(txn, ctx, keepGoing, ns, objs, op);
+            return;
+        }
+
+        // Fast path: insert the whole batch in one unit of work with one vectored
+        // oplog append, rather than paying the commit and oplog locking overhead
+        // per document.  Any failure rolls the batch back before anything has been
+        // logged, and we redo it one document at a time so the error lands on the
+        // right document and the documents before it are preserved, exactly as the
+        // one-at-a-time path has always behaved.
+        try {
+            WriteUnitOfWork wunit(txn);
+
+            for (size_t i = 0; i < objs.size(); i++) {
+                StatusWith<BSONObj> fixed = fixDocumentForInsert( objs[i] );
+                uassertStatusOK( fixed.getStatus() );
+                if ( !fixed.getValue().isEmpty() )
+                    objs[i] = fixed.getValue();
+
+                StatusWith<RecordId> status = collection->insertDocument( txn, objs[i], true );
+                uassertStatusOK( status.getStatus() );
+            }
+
+            // Must come last: once an op is in the oplog the unit of work may no
+            // longer roll back.
+            repl::logOps(txn, "i", ns, objs);
+            wunit.commit();
+        }
+        catch (const UserException&) {
+            insertMultiSingletons(txn, ctx, keepGoing, ns, objs, op);
+            return;
+        }
+
+        globalOpCounters.incInsertInWriteLock(objs.size());
+        op.debug().ninserted = objs.size();
+    }
+
     static void convertSystemIndexInsertsToCommands(
             DbMessage& d,
             BSONArrayBuilder* allCmdsBuilder) {
@@ -993,7 +1077,9 @@ namespace mongo {
             insertSystemIndexes(txn, d, op);
             return;
         }
-        const NamespaceString nsString(ns);
+        const InternedNamespace* const interned = InternedNamespace::intern(ns);
+        const NamespaceString uninterned(interned ? StringData() : StringData(ns));
+        const NamespaceString& nsString = interned ? interned->nss() : uninterned;
 
         if( !d.moreJSObjs() ) {
             // strange.  should we complain?
@@ -1017,8 +1103,8 @@ namespace mongo {
             const bool isIndexBuild = (nsToCollectionSubstring(ns) == "system.indexes");
             const LockMode mode = isIndexBuild ? MODE_X : MODE_IX;
             ScopedTransaction transaction(txn, MODE_IX);
-            Lock::DBLock dbLock(txn->lockState(), nsString.db(), mode);
-            Lock::CollectionLock collLock(txn->lockState(), nsString.ns(), mode);
+            Lock::DBLock dbLock(txn->lockState(), interned, nsString.db(), mode);
+            Lock::CollectionLock collLock(txn->lockState(), interned, nsString.ns(), mode);
 
             // CONCURRENCY TODO: is being read locked in big log sufficient here?
             // writelock is used to synchronize stepdowns w/ writes
@@ -1045,7 +1131,7 @@ namespace mongo {
 
         // Collection didn't exist so try again with MODE_X
         ScopedTransaction transaction(txn, MODE_IX);
-        Lock::DBLock dbLock(txn->lockState(), nsString.db(), MODE_X);
+        Lock::DBLock dbLock(txn->lockState(), interned, nsString.db(), MODE_X);
 
         // CONCURRENCY TODO: is being read locked in big log sufficient here?
         // writelock is used to synchronize stepdowns w/ writes
@@ -37,22 +37,40 @@
 
 #include <boost/scoped_ptr.hpp>
 
+#include <vector>
+
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_set.h"
+#include "mongo/db/client.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/introspect.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/spin_lock.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 
     using boost::scoped_ptr;
 
+    // When enabled, profile() appends the profile document to an in-memory ring and
+    // returns immediately; a periodic task writes the buffered documents to the
+    // databases' system.profile collections. This keeps the lock acquisition and
+    // collection insert out of the operation being profiled.
+    MONGO_EXPORT_SERVER_PARAMETER( profilingRingBuffer, bool, false );
+
+    // How often the ring is drained to the profile collections. 0 disables draining
+    // and the ring simply retains the most recent documents.
+    MONGO_EXPORT_SERVER_PARAMETER( profilingRingBufferDrainMS, int, 100 );
+
 namespace {
     void _appendUserInfo(const CurOp& c,
                          BSONObjBuilder& builder,
@@ -81,30 +99,85 @@ namespace {
         builder.append("user", bestUser.getUser().empty() ? "" : bestUser.getFullName());
 
     }
-} // namespace
 
     /**
-     * @return if collection existed or was created
+     * Fixed-size ring of recent profile documents; a structured analogue of RamLog.
+     * push() is constant time and takes no database locks, so an operation being
+     * profiled only pays for building its document. When the ring is full the oldest
+     * entries are overwritten and counted as dropped.
      */
-    static bool _profile(OperationContext* txn,
-                         const Client& c,
-                         Database* db,
-                         CurOp& currentOp,
-                         BufBuilder& profileBufBuilder) {
-        dassert( db );
-
-        // build object
-        BSONObjBuilder b(profileBufBuilder);
+    class ProfileRing {
+    public:
+        struct Entry {
+            std::string dbname;
+            BSONObj doc;
+        };
+
+        static const size_t kSlots = 256;
+
+        ProfileRing() : _lock("profileRing"), _first(0), _count(0), _dropped(0) {}
+
+        void push(const std::string& dbname, const BSONObj& doc) {
+            // own the document's bytes before taking the lock; the builder's buffer
+            // dies with the operation
+            Entry e;
+            e.dbname = dbname;
+            e.doc = doc.getOwned();
+
+            scoped_spinlock lk(_lock);
+            size_t slot;
+            if (_count < kSlots) {
+                slot = (_first + _count) % kSlots;
+                _count++;
+            }
+            else {
+                // overwrite the oldest entry
+                slot = _first;
+                _first = (_first + 1) % kSlots;
+                _dropped++;
+            }
+            _slots[slot].dbname.swap(e.dbname);
+            _slots[slot].doc = e.doc;
+        }
 
-        currentOp.debug().append(currentOp, b);
+        /**
+         * Moves all buffered entries into 'out' (oldest first).
+         * @return number of entries overwritten before they could be drained
+         */
+        long long drain(std::vector<Entry>* out) {
+            scoped_spinlock lk(_lock);
+            for (size_t i = 0; i < _count; i++) {
+                Entry& e = _slots[(_first + i) % kSlots];
+                out->push_back(Entry());
+                out->back().dbname.swap(e.dbname);
+                out->back().doc = e.doc;
+                e.doc = BSONObj();
+            }
+            _first = 0;
+            _count = 0;
+            const long long dropped = _dropped;
+            _dropped = 0;
+            return dropped;
+        }
 
-        b.appendDate("ts", jsTime());
-        b.append("client", c.clientAddress());
+    private:
+        SpinLock _lock;
+        Entry _slots[kSlots];
+        size_t _first; // index of the oldest entry
+        size_t _count; // number of live entries
+        long long _dropped;
+    };
 
-        AuthorizationSession * authSession = c.getAuthorizationSession();
-        _appendUserInfo(currentOp, b, authSession);
+    ProfileRing profileRing;
+} // namespace
 
-        BSONObj p = b.done();
+    /**
+     * Writes 'p' into the database's profile collection.
+     * @return false if the collection didn't exist and couldn't be created (the caller
+     * may retry holding a database X lock)
+     */
+    static bool _writeProfileDoc(OperationContext* txn, Database* db, const BSONObj& p) {
+        dassert( db );
 
         WriteUnitOfWork wunit(txn);
 
@@ -121,15 +194,34 @@ namespace {
 
     void profile(OperationContext* txn, const Client& c, int op, CurOp& currentOp) {
         bool tryAgain = false;
-        while ( 1 ) {
-            try {
-                // initialize with 1kb to start, to avoid realloc later
-                // doing this outside the dblock to improve performance
-                BufBuilder profileBufBuilder(1024);
+        try {
+            // build the profile document first, outside of any locks
+            // initialize with 1kb to start, to avoid realloc later
+            BufBuilder profileBufBuilder(1024);
+            BSONObjBuilder b(profileBufBuilder);
+
+            currentOp.debug().append(currentOp, b);
+
+            b.appendDate("ts", jsTime());
+            b.append("client", c.clientAddress());
+
+            AuthorizationSession * authSession = c.getAuthorizationSession();
+            _appendUserInfo(currentOp, b, authSession);
 
+            const BSONObj p = b.done();
+
+            const string dbname(nsToDatabase(currentOp.getNS()));
+
+            if (profilingRingBuffer) {
+                // stash the document and get out of the operation's way; the drainer
+                // task below writes it to system.profile
+                profileRing.push(dbname, p);
+                return;
+            }
+
+            while ( 1 ) {
                 // NOTE: It's kind of weird that we lock the op's namespace, but have to for now
                 // since we're sometimes inside the lock already
-                const string dbname(nsToDatabase(currentOp.getNS()));
                 scoped_ptr<Lock::DBLock> lk;
 
                 // todo: this can be slow, perhaps can re-work
@@ -140,9 +232,13 @@ namespace {
                 }
                 Database* db = dbHolder().get(txn, dbname);
                 if (db != NULL) {
-                    Lock::CollectionLock clk(txn->lockState(), db->getProfilingNS(), MODE_X);
+                    // An IX lock is sufficient here: document-level locking engines order the
+                    // capped inserts themselves, and CollectionLock escalates IX to X for
+                    // engines that don't. Creation of the profile collection still requires a
+                    // database X lock, which the tryAgain path above arranges.
+                    Lock::CollectionLock clk(txn->lockState(), db->getProfilingNS(), MODE_IX);
                     Client::Context cx(txn, currentOp.getNS(), false);
-                    if ( !_profile(txn, c, cx.db(), currentOp, profileBufBuilder ) && lk.get() ) {
+                    if ( !_writeProfileDoc(txn, cx.db(), p) && lk.get() ) {
                         if ( tryAgain ) {
                             // we couldn't profile, but that's ok, we should have logged already
                             break;
@@ -158,14 +254,96 @@ namespace {
                 }
                 return;
             }
-            catch (const AssertionException& assertionEx) {
-                warning() << "Caught Assertion while trying to profile " << opToString(op)
-                          << " against " << currentOp.getNS()
-                          << ": " << assertionEx.toString() << endl;
+        }
+        catch (const AssertionException& assertionEx) {
+            warning() << "Caught Assertion while trying to profile " << opToString(op)
+                      << " against " << currentOp.getNS()
+                      << ": " << assertionEx.toString() << endl;
+        }
+    }
+
+namespace {
+
+    /**
+     * Periodically writes the profile documents buffered by the ring into the
+     * databases' system.profile collections, off the profiled operations' threads.
+     */
+    class ProfileRingDrainer : public PeriodicTask {
+    public:
+        virtual string taskName() const { return "ProfileRingDrainer"; }
+
+        virtual int taskPeriodMillis() const {
+            return profilingRingBufferDrainMS > 0 ? profilingRingBufferDrainMS : 1000;
+        }
+
+        virtual void taskDoWork() {
+            if ( inShutdown() )
+                return;
+
+            if ( profilingRingBufferDrainMS <= 0 ) {
+                // draining disabled; the ring just retains the most recent documents
+                return;
+            }
+
+            std::vector<ProfileRing::Entry> entries;
+            entries.reserve( ProfileRing::kSlots );
+            const long long dropped = profileRing.drain( &entries );
+            if ( dropped > 0 ) {
+                warning() << "profiling ring buffer overflowed; dropped " << dropped
+                          << " profile document(s) before they could be written" << endl;
+            }
+            if ( entries.empty() )
                 return;
+
+            // We run on the shared periodic task thread, which does no Client setup of
+            // its own.
+            if ( !haveClient() ) {
+                Client::initThread( "profileRingDrainer" );
+                cc().getAuthorizationSession()->grantInternalAuthorization();
+            }
+            OperationContextImpl txn;
+
+            for ( size_t i = 0; i < entries.size(); i++ ) {
+                try {
+                    _writeEntry( &txn, entries[i] );
+                }
+                catch ( const AssertionException& assertionEx ) {
+                    warning() << "Caught Assertion while draining profiling ring buffer "
+                              << "for " << entries[i].dbname
+                              << ": " << assertionEx.toString() << endl;
+                }
             }
         }
-    }
+
+    private:
+        void _writeEntry( OperationContext* txn, const ProfileRing::Entry& entry ) {
+            // same locking dance as the inline path in profile() above: write under an
+            // intent lock and escalate to X only if the profile collection has to be
+            // created
+            bool tryAgain = false;
+            while ( 1 ) {
+                Lock::DBLock lk( txn->lockState(),
+                                 entry.dbname,
+                                 tryAgain ? MODE_X : MODE_IX );
+                Database* db = dbHolder().get( txn, entry.dbname );
+                if ( db == NULL ) {
+                    // db went away since the operation was profiled; nothing to do
+                    return;
+                }
+                Lock::CollectionLock clk( txn->lockState(), db->getProfilingNS(), MODE_IX );
+                Client::Context cx( txn, db->getProfilingNS(), false );
+                if ( _writeProfileDoc( txn, cx.db(), entry.doc ) )
+                    return;
+                if ( tryAgain ) {
+                    // we couldn't create the profile collection; already logged
+                    return;
+                }
+                tryAgain = true;
+            }
+        }
+    } profileRingDrainer;
+
+} // namespace
 
     Collection* getOrCreateProfileCollection(OperationContext* txn,
                                              Database *db,
@@ -72,6 +72,16 @@ namespace mongo {
         DATE_RESERVE_SIZE = 64
     };
 
+    // Unquoted field names are restricted to identifier characters; classifying
+    // them directly is much cheaper than a strchr() over the combined set for
+    // every character of every key.
+    static inline bool isIdentChar(char c) {
+        return ('a' <= c && c <= 'z') ||
+            ('A' <= c && c <= 'Z') ||
+            ('0' <= c && c <= '9') ||
+            c == '_' || c == '$';
+    }
+
     static const char* LBRACE = "{",
                  *RBRACE = "}",
                  *LBRACKET = "[",
@@ -1044,7 +1054,16 @@ namespace mongo {
             if (!match(*_input, ALPHA "_$")) {
                 return parseError("First character in field must be [A-Za-z$_]");
             }
-            return chars(result, "", ALPHA DIGIT "_$");
+            const char* q = _input;
+            while (q < _input_end && isIdentChar(*q)) {
+                ++q;
+            }
+            if (q >= _input_end) {
+                return parseError("Unexpected end of input");
+            }
+            result->append(_input, q - _input);
+            _input = q;
+            return Status::OK();
         }
     }
 
@@ -1084,15 +1103,42 @@ namespace mongo {
         if (_input >= _input_end) {
             return parseError("Unexpected end of input");
         }
+        // Quoted strings and regex bodies come through here with a single
+        // terminal character and no allowed set.  For those, scan ahead to the
+        // next terminal, escape, or control byte and append whole runs at once,
+        // instead of paying a strchr() and a push_back() per character; string
+        // content is overwhelmingly plain runs.
+        const bool bulkRuns = (allowedSet == NULL &&
+                               terminalSet[0] != '\0' && terminalSet[1] == '\0');
+        const char terminal = terminalSet[0];
         const char* q = _input;
-        while (q < _input_end && !match(*q, terminalSet)) {
-            MONGO_JSON_DEBUG("q: " << q);
-            if (allowedSet != NULL) {
-                if (!match(*q, allowedSet)) {
+        for (;;) {
+            if (bulkRuns) {
+                const char* runStart = q;
+                while (q < _input_end) {
+                    const unsigned char c = static_cast<unsigned char>(*q);
+                    if (c == static_cast<unsigned char>(terminal) || c == '\\' || c <= 0x1F) {
+                        break;
+                    }
+                    ++q;
+                }
+                if (q != runStart) {
+                    result->append(runStart, q - runStart);
+                }
+                if (q >= _input_end || *q == terminal) {
+                    break;
+                }
+            }
+            else {
+                if (q >= _input_end || match(*q, terminalSet)) {
+                    break;
+                }
+                if (allowedSet != NULL && !match(*q, allowedSet)) {
                     _input = q;
                     return Status::OK();
                 }
             }
+            MONGO_JSON_DEBUG("q: " << q);
             if (0x00 <= *q && *q <= 0x1F) {
                 return parseError("Invalid control character");
             }
@@ -1157,20 +1203,26 @@ namespace mongo {
     }
 
     std::string JParse::encodeUTF8(unsigned char first, unsigned char second) const {
-        std::ostringstream oss;
+        // Built in a local buffer; a stringstream per \uXXXX escape is far too
+        // heavy for escape-dense documents.
+        char utf8[3];
+        size_t len;
         if (first == 0 && second < 0x80) {
-            oss << second;
+            utf8[0] = char( second );
+            len = 1;
         }
         else if (first < 0x08) {
-            oss << char( 0xc0 | (first << 2 | second >> 6) );
-            oss << char( 0x80 | (~0xc0 & second) );
+            utf8[0] = char( 0xc0 | (first << 2 | second >> 6) );
+            utf8[1] = char( 0x80 | (~0xc0 & second) );
+            len = 2;
         }
         else {
-            oss << char( 0xe0 | (first >> 4) );
-            oss << char( 0x80 | (~0xc0 & (first << 2 | second >> 6) ) );
-            oss << char( 0x80 | (~0xc0 & second) );
+            utf8[0] = char( 0xe0 | (first >> 4) );
+            utf8[1] = char( 0x80 | (~0xc0 & (first << 2 | second >> 6) ) );
+            utf8[2] = char( 0x80 | (~0xc0 & second) );
+            len = 3;
         }
-        return oss.str();
+        return std::string(utf8, len);
     }
 
     inline bool JParse::peekToken(const char* token) {
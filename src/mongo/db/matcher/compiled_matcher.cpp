@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/matcher/compiled_matcher.h"
+
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+
+namespace mongo {
+
+namespace {
+
+    // The evaluation loop tracks which predicates are resolved in a 64-bit mask.
+    const size_t kMaxCompiledPredicates = 64;
+
+    /**
+     * Returns true if 'rhs' is a constant for which a missing field or an array-embedded
+     * value is handled the same way by matchesSingleElement() as by our single-pass scan.
+     * null and undefined match missing fields, and MinKey/MaxKey have their own special
+     * cases in ComparisonMatchExpression::matchesSingleElement().
+     */
+    bool isPlainConstant(const BSONElement& rhs) {
+        return jstNULL != rhs.type() && Undefined != rhs.type()
+            && MinKey != rhs.type() && MaxKey != rhs.type();
+    }
+
+    /**
+     * Returns the predicate as a LeafMatchExpression if it can be evaluated against
+     * top-level elements directly, and NULL otherwise.
+     */
+    const LeafMatchExpression* asCompilablePredicate(const MatchExpression* expr) {
+        switch (expr->matchType()) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE: {
+            const ComparisonMatchExpression* cmp =
+                static_cast<const ComparisonMatchExpression*>(expr);
+            if (!isPlainConstant(cmp->getRHS())) {
+                return NULL;
+            }
+            break;
+        }
+        case MatchExpression::MATCH_IN: {
+            const InMatchExpression* in = static_cast<const InMatchExpression*>(expr);
+            const ArrayFilterEntries& entries = in->getData();
+            // Regexes need per-element regex evaluation machinery and null matches
+            // missing fields; both take the tree walk.
+            if (entries.numRegexes() > 0 || entries.hasNull()) {
+                return NULL;
+            }
+            break;
+        }
+        default:
+            return NULL;
+        }
+
+        // Dotted paths require the ElementPath traversal machinery.
+        if (expr->path().find('.') != std::string::npos) {
+            return NULL;
+        }
+
+        return static_cast<const LeafMatchExpression*>(expr);
+    }
+
+    /**
+     * Tests one top-level element against a predicate, mirroring the leaf array
+     * semantics of BSONElementIterator: the predicate is satisfied by the element
+     * itself or by any immediate member of an array element.
+     */
+    bool predicateMatches(const LeafMatchExpression* leaf, const BSONElement& e) {
+        if (leaf->matchesSingleElement(e)) {
+            return true;
+        }
+        if (Array == e.type()) {
+            BSONObjIterator it(e.Obj());
+            while (it.more()) {
+                if (leaf->matchesSingleElement(it.next())) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+}  // namespace
+
+    CompiledMatcher::CompiledMatcher(const std::vector<Predicate>& predicates)
+        : _predicates(predicates) { }
+
+    // static
+    CompiledMatcher* CompiledMatcher::compile(const MatchExpression* expr) {
+        std::vector<Predicate> predicates;
+
+        if (MatchExpression::AND == expr->matchType()) {
+            if (0 == expr->numChildren() || expr->numChildren() > kMaxCompiledPredicates) {
+                return NULL;
+            }
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                const LeafMatchExpression* leaf = asCompilablePredicate(expr->getChild(i));
+                if (NULL == leaf) {
+                    return NULL;
+                }
+                predicates.push_back(Predicate(leaf->path(), leaf));
+            }
+        }
+        else {
+            const LeafMatchExpression* leaf = asCompilablePredicate(expr);
+            if (NULL == leaf) {
+                return NULL;
+            }
+            predicates.push_back(Predicate(leaf->path(), leaf));
+        }
+
+        return new CompiledMatcher(predicates);
+    }
+
+    bool CompiledMatcher::matches(const BSONObj& doc) const {
+        unsigned long long resolved = 0;
+        size_t numUnresolved = _predicates.size();
+
+        BSONObjIterator it(doc);
+        while (it.more() && numUnresolved > 0) {
+            BSONElement e = it.next();
+            StringData fieldName = e.fieldNameStringData();
+
+            for (size_t i = 0; i < _predicates.size(); ++i) {
+                if (resolved & (1ULL << i)) {
+                    continue;
+                }
+                if (_predicates[i].field != fieldName) {
+                    continue;
+                }
+
+                // Only the first occurrence of a field counts, as with ElementPath.
+                resolved |= (1ULL << i);
+                --numUnresolved;
+
+                if (!predicateMatches(_predicates[i].leaf, e)) {
+                    return false;
+                }
+            }
+        }
+
+        // Predicates on fields absent from the document never match; constants for which
+        // a missing field would match (null, undefined, MinKey, MaxKey) are not compiled.
+        return 0 == numUnresolved;
+    }
+
+}  // namespace mongo
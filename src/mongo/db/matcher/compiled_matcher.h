@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+    class LeafMatchExpression;
+    class MatchExpression;
+
+    /**
+     * A CompiledMatcher is a flattened form of a conjunction of equality/range/$in
+     * predicates over top-level paths. Instead of walking the expression tree with a
+     * virtual matches() call and an ElementPath traversal per predicate, it evaluates all
+     * predicates in a single pass over the document's byte stream: each top-level element
+     * is tested against the (few) predicates naming its field as it streams by.
+     *
+     * A CompiledMatcher holds pointers into the expression tree it was compiled from; the
+     * tree must outlive it.
+     */
+    class CompiledMatcher {
+    public:
+        /**
+         * Attempts to flatten 'expr'. Returns NULL if the expression does not qualify,
+         * in which case callers must fall back on MatchExpression::matchesBSON().
+         * Caller owns the result.
+         *
+         * An expression qualifies if it is a single predicate or a one-level AND of
+         * predicates, where every predicate is an EQ/LT/LTE/GT/GTE or regex-free $in on
+         * a dotless path. Predicates whose constants change the treatment of missing
+         * fields (null, undefined, MinKey, MaxKey) are rejected so that the single-pass
+         * evaluation agrees with the tree walk.
+         */
+        static CompiledMatcher* compile(const MatchExpression* expr);
+
+        /**
+         * Returns true if 'doc' satisfies every compiled predicate. Equivalent to
+         * matchesBSON(doc, NULL) on the expression this was compiled from.
+         */
+        bool matches(const BSONObj& doc) const;
+
+    private:
+        struct Predicate {
+            Predicate(const StringData& field, const LeafMatchExpression* leaf)
+                : field(field), leaf(leaf) { }
+
+            // Top-level field the predicate applies to. Points into the expression tree.
+            StringData field;
+
+            // Not owned here.
+            const LeafMatchExpression* leaf;
+        };
+
+        explicit CompiledMatcher(const std::vector<Predicate>& predicates);
+
+        std::vector<Predicate> _predicates;
+    };
+
+}  // namespace mongo
@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/unittest/unittest.h"
+
+#include "mongo/db/matcher/compiled_matcher.h"
+
+#include <boost/scoped_ptr.hpp>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+
+namespace mongo {
+
+    using boost::scoped_ptr;
+
+    /**
+     * Parses 'queryStr', asserts that it compiles, and asserts that the compiled matcher
+     * agrees with matchesBSON() on 'docStr'.
+     */
+    void assertCompiledAgrees(const char* queryStr, const char* docStr) {
+        BSONObj query = fromjson(queryStr);
+        BSONObj doc = fromjson(docStr);
+
+        StatusWithMatchExpression result = MatchExpressionParser::parse(query);
+        ASSERT_TRUE(result.isOK());
+        scoped_ptr<MatchExpression> expr(result.getValue());
+
+        scoped_ptr<CompiledMatcher> compiled(CompiledMatcher::compile(expr.get()));
+        ASSERT(NULL != compiled.get());
+        ASSERT_EQUALS(expr->matchesBSON(doc), compiled->matches(doc));
+    }
+
+    void assertDoesNotCompile(const char* queryStr) {
+        BSONObj query = fromjson(queryStr);
+
+        StatusWithMatchExpression result = MatchExpressionParser::parse(query);
+        ASSERT_TRUE(result.isOK());
+        scoped_ptr<MatchExpression> expr(result.getValue());
+
+        scoped_ptr<CompiledMatcher> compiled(CompiledMatcher::compile(expr.get()));
+        ASSERT(NULL == compiled.get());
+    }
+
+    TEST(CompiledMatcherTest, Equality) {
+        assertCompiledAgrees("{a: 5}", "{a: 5}");
+        assertCompiledAgrees("{a: 5}", "{a: 6}");
+        assertCompiledAgrees("{a: 5}", "{b: 5}");
+        assertCompiledAgrees("{a: 5}", "{}");
+        assertCompiledAgrees("{a: 'x'}", "{a: 5}");
+    }
+
+    TEST(CompiledMatcherTest, Range) {
+        assertCompiledAgrees("{a: {$gt: 5}}", "{a: 6}");
+        assertCompiledAgrees("{a: {$gt: 5}}", "{a: 5}");
+        assertCompiledAgrees("{a: {$gt: 5}}", "{a: 'x'}");
+        assertCompiledAgrees("{a: {$gte: 5, $lt: 10}}", "{a: 5}");
+        assertCompiledAgrees("{a: {$gte: 5, $lt: 10}}", "{a: 10}");
+        assertCompiledAgrees("{a: {$lte: 5}}", "{}");
+    }
+
+    TEST(CompiledMatcherTest, In) {
+        assertCompiledAgrees("{a: {$in: [1, 2, 3]}}", "{a: 2}");
+        assertCompiledAgrees("{a: {$in: [1, 2, 3]}}", "{a: 4}");
+        assertCompiledAgrees("{a: {$in: [1, 2, 3]}}", "{}");
+    }
+
+    TEST(CompiledMatcherTest, Conjunction) {
+        assertCompiledAgrees("{a: 1, b: 2}", "{a: 1, b: 2}");
+        assertCompiledAgrees("{a: 1, b: 2}", "{a: 1, b: 3}");
+        assertCompiledAgrees("{a: 1, b: 2}", "{b: 2, a: 1}");
+        assertCompiledAgrees("{a: 1, b: 2}", "{a: 1}");
+    }
+
+    TEST(CompiledMatcherTest, ArrayValues) {
+        // A predicate is satisfied by an array element or any of its members.
+        assertCompiledAgrees("{a: 5}", "{a: [4, 5, 6]}");
+        assertCompiledAgrees("{a: 5}", "{a: [1, 2]}");
+        assertCompiledAgrees("{a: {$gt: 5}}", "{a: [1, 9]}");
+        assertCompiledAgrees("{a: {$in: [5]}}", "{a: [4, 5]}");
+        // ... but not by a doubly-nested member.
+        assertCompiledAgrees("{a: 5}", "{a: [[5]]}");
+    }
+
+    TEST(CompiledMatcherTest, EqualityOnDocumentsAndArrays) {
+        assertCompiledAgrees("{a: {b: 1}}", "{a: {b: 1}}");
+        assertCompiledAgrees("{a: {b: 1}}", "{a: {b: 2}}");
+        assertCompiledAgrees("{a: [1, 2]}", "{a: [1, 2]}");
+        assertCompiledAgrees("{a: [1, 2]}", "{a: [[1, 2]]}");
+    }
+
+    TEST(CompiledMatcherTest, NonCompilableExpressions) {
+        // Constants that match missing fields need the tree walk.
+        assertDoesNotCompile("{a: null}");
+        assertDoesNotCompile("{a: {$in: [1, null]}}");
+
+        // Dotted paths need ElementPath traversal.
+        assertDoesNotCompile("{'a.b': 1}");
+
+        // Operators outside the equality/range/$in set.
+        assertDoesNotCompile("{a: {$exists: true}}");
+        assertDoesNotCompile("{a: {$ne: 1}}");
+        assertDoesNotCompile("{a: /foo/}");
+        assertDoesNotCompile("{a: {$in: [/foo/]}}");
+        assertDoesNotCompile("{$or: [{a: 1}, {b: 1}]}");
+        assertDoesNotCompile("{a: {$size: 2}}");
+    }
+
+}  // namespace mongo
@@ -66,7 +66,8 @@ namespace mongo {
             GEO_NEAR, TEXT,
 
             // Expressions that are only created internally
-            INTERNAL_2DSPHERE_KEY_IN_REGION, INTERNAL_2D_KEY_IN_REGION, INTERNAL_2D_POINT_IN_ANNULUS
+            INTERNAL_2DSPHERE_KEY_IN_REGION, INTERNAL_2D_KEY_IN_REGION, INTERNAL_2D_POINT_IN_ANNULUS,
+            INTERNAL_WHERE_STRICT_EQ
         };
 
         MatchExpression( MatchType type );
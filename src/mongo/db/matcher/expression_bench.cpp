@@ -0,0 +1,127 @@
+// expression_bench.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+    /**
+     * Parses the query once in setUp so only the match itself is timed.
+     */
+    class MatcherBench : public benchmark::Benchmark {
+    public:
+        virtual void setUp() {
+            StatusWithMatchExpression result = MatchExpressionParser::parse(query());
+            invariant(result.isOK());
+            _expression.reset(result.getValue());
+        }
+
+        virtual void tearDown() {
+            _expression.reset();
+        }
+
+    protected:
+        virtual BSONObj query() const = 0;
+
+        MatchExpression* expression() const { return _expression.get(); }
+
+    private:
+        std::auto_ptr<MatchExpression> _expression;
+    };
+
+    class SimpleEqualityBench : public MatcherBench {
+    protected:
+        virtual BSONObj query() const { return BSON("a" << 5); }
+    };
+
+    MONGO_BENCHMARK_F(SimpleEqualityBench, Match) {
+        const BSONObj matching = BSON("a" << 5 << "b" << "x");
+        const BSONObj nonMatching = BSON("a" << 6 << "b" << "x");
+        volatile int sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            sink += expression()->matchesBSON(matching);
+            sink += expression()->matchesBSON(nonMatching);
+        }
+    }
+
+    class CompoundRangeBench : public MatcherBench {
+    protected:
+        virtual BSONObj query() const {
+            return BSON("a" << BSON("$gte" << 10 << "$lt" << 100)
+                        << "b" << "needle"
+                        << "c" << BSON("$in" << BSON_ARRAY(1 << 3 << 5 << 7 << 9)));
+        }
+    };
+
+    MONGO_BENCHMARK_F(CompoundRangeBench, Match) {
+        const BSONObj matching = BSON("a" << 42 << "b" << "needle" << "c" << 7);
+        const BSONObj nonMatching = BSON("a" << 42 << "b" << "haystack" << "c" << 7);
+        volatile int sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            sink += expression()->matchesBSON(matching);
+            sink += expression()->matchesBSON(nonMatching);
+        }
+    }
+
+    class DottedPathBench : public MatcherBench {
+    protected:
+        virtual BSONObj query() const { return BSON("a.b.c" << 5); }
+    };
+
+    MONGO_BENCHMARK_F(DottedPathBench, Match) {
+        const BSONObj matching = BSON("a" << BSON("b" << BSON("c" << 5)));
+        volatile int sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            sink += expression()->matchesBSON(matching);
+        }
+    }
+
+    MONGO_BENCHMARK(MatchExpressionParse) {
+        const BSONObj query = BSON("a" << BSON("$gte" << 10 << "$lt" << 100)
+                                   << "b" << "needle");
+        volatile int sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            StatusWithMatchExpression result = MatchExpressionParser::parse(query);
+            invariant(result.isOK());
+            delete result.getValue();
+            sink++;
+        }
+    }
+
+}  // namespace
+}  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include "mongo/db/matcher/expression_leaf.h"
 
+#include <algorithm>
 #include <pcrecpp.h>
 
 #include "mongo/bson/bsonobjiterator.h"
@@ -439,9 +440,81 @@ namespace mongo {
 
     // --------
 
+    namespace {
+
+        // Minimum number of equalities before finishBuilding() creates an accelerated
+        // lookup structure; below this the tree set is cheap enough.
+        const size_t kAccelerateMinEntries = 32;
+
+        /**
+         * If 'e' holds a numeric value that is exactly representable as a 64-bit
+         * integer, stores it in 'out' and returns true.
+         */
+        bool extractInteger( const BSONElement& e, long long* out ) {
+            switch ( e.type() ) {
+            case NumberInt:
+            case NumberLong:
+                *out = e.numberLong();
+                return true;
+            case NumberDouble: {
+                double d = e.numberDouble();
+                if ( d != d )
+                    return false; // NaN
+                if ( d < -9223372036854775808.0 || d >= 9223372036854775808.0 )
+                    return false;
+                long long ll = static_cast<long long>( d );
+                if ( static_cast<double>( ll ) != d )
+                    return false;
+                *out = ll;
+                return true;
+            }
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * Types for which value equality under woCompare() is a byte comparison of the
+         * value region, with String and Symbol comparing equal to each other. Numerics
+         * are excluded because they compare equal across types with different bytes.
+         */
+        bool isHashableType( BSONType t ) {
+            switch ( t ) {
+            case String:
+            case Symbol:
+            case jstOID:
+            case Bool:
+            case Date:
+            case Timestamp:
+            case BinData:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * FNV-1a over a type bucket and the element's value bytes. String and Symbol
+         * share a bucket because they compare equal.
+         */
+        unsigned hashElementValue( const BSONElement& e ) {
+            unsigned h = 2166136261U;
+            unsigned bucket = ( Symbol == e.type() ) ? String : e.type();
+            h = ( h ^ bucket ) * 16777619U;
+            const char* data = e.value();
+            const int len = e.valuesize();
+            for ( int i = 0; i < len; ++i ) {
+                h = ( h ^ static_cast<unsigned char>( data[i] ) ) * 16777619U;
+            }
+            return h;
+        }
+
+    } // namespace
+
     ArrayFilterEntries::ArrayFilterEntries(){
         _hasNull = false;
         _hasEmptyArray = false;
+        _lookupMode = LOOKUP_SET;
     }
 
     ArrayFilterEntries::~ArrayFilterEntries() {
@@ -475,6 +548,100 @@ namespace mongo {
         return Status::OK();
     }
 
+    void ArrayFilterEntries::finishBuilding() {
+        _sortedIntegers.clear();
+        _hashTable.clear();
+        _lookupMode = LOOKUP_SET;
+
+        if ( _equalities.size() < kAccelerateMinEntries )
+            return;
+
+        // Prefer the integer representation: it needs no per-lookup hashing and its
+        // binary search is branchless.
+        std::vector<long long> integers;
+        integers.reserve( _equalities.size() );
+        bool allIntegers = true;
+        for ( BSONElementSet::const_iterator it = _equalities.begin();
+              it != _equalities.end(); ++it ) {
+            long long value;
+            if ( !extractInteger( *it, &value ) ) {
+                allIntegers = false;
+                break;
+            }
+            integers.push_back( value );
+        }
+        if ( allIntegers ) {
+            std::sort( integers.begin(), integers.end() );
+            _sortedIntegers.swap( integers );
+            _lookupMode = LOOKUP_INTEGERS;
+            return;
+        }
+
+        // Otherwise hash, provided every literal's equality is a byte comparison.
+        for ( BSONElementSet::const_iterator it = _equalities.begin();
+              it != _equalities.end(); ++it ) {
+            if ( !isHashableType( it->type() ) )
+                return;
+        }
+
+        size_t capacity = 1;
+        while ( capacity < 2 * _equalities.size() )
+            capacity <<= 1;
+        _hashTable.resize( capacity );
+        const size_t mask = capacity - 1;
+        for ( BSONElementSet::const_iterator it = _equalities.begin();
+              it != _equalities.end(); ++it ) {
+            const unsigned h = hashElementValue( *it );
+            size_t idx = h & mask;
+            while ( !_hashTable[idx].elem.eoo() )
+                idx = ( idx + 1 ) & mask;
+            _hashTable[idx].hash = h;
+            _hashTable[idx].elem = *it;
+        }
+        _lookupMode = LOOKUP_HASHED;
+    }
+
+    bool ArrayFilterEntries::contains( const BSONElement& elem ) const {
+        switch ( _lookupMode ) {
+        case LOOKUP_INTEGERS: {
+            long long value;
+            if ( !extractInteger( elem, &value ) )
+                return false; // an all-integer set cannot contain it
+
+            // Branchless binary search: each step halves the candidate range with a
+            // conditional move instead of a branch.
+            const long long* base = &_sortedIntegers[0];
+            size_t n = _sortedIntegers.size();
+            while ( n > 1 ) {
+                const size_t half = n / 2;
+                base = ( base[half - 1] < value ) ? base + half : base;
+                n -= half;
+            }
+            return *base == value;
+        }
+
+        case LOOKUP_HASHED: {
+            if ( !isHashableType( elem.type() ) )
+                return false; // nothing in the table can compare equal to it
+
+            const unsigned h = hashElementValue( elem );
+            const size_t mask = _hashTable.size() - 1;
+            size_t idx = h & mask;
+            while ( !_hashTable[idx].elem.eoo() ) {
+                if ( _hashTable[idx].hash == h
+                     && 0 == elem.woCompare( _hashTable[idx].elem, false ) )
+                    return true;
+                idx = ( idx + 1 ) & mask;
+            }
+            return false;
+        }
+
+        case LOOKUP_SET:
+        default:
+            return _equalities.count( elem ) > 0;
+        }
+    }
+
     bool ArrayFilterEntries::equivalent( const ArrayFilterEntries& other ) const {
         if ( _hasNull != other._hasNull )
             return false;
@@ -494,6 +661,8 @@ namespace mongo {
         toFillIn._equalities = _equalities;
         for ( unsigned i = 0; i < _regexes.size(); i++ )
             toFillIn._regexes.push_back( static_cast<RegexMatchExpression*>(_regexes[i]->shallowClone()) );
+        if ( LOOKUP_SET != _lookupMode )
+            toFillIn.finishBuilding();
     }
 
     void ArrayFilterEntries::debugString( StringBuilder& debug ) const {
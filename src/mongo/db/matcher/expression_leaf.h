@@ -294,8 +294,16 @@ namespace mongo {
         Status addEquality( const BSONElement& e );
         Status addRegex( RegexMatchExpression* expr );
 
+        /**
+         * Builds an accelerated lookup structure for large literal sets: a sorted vector
+         * for integer-only sets, otherwise a flat open-addressing table of precomputed
+         * element hashes. Optional -- contains() is correct either way -- but call it
+         * after the last addEquality() to avoid tree-set lookups per evaluation.
+         */
+        void finishBuilding();
+
         const BSONElementSet& equalities() const { return _equalities; }
-        bool contains( const BSONElement& elem ) const { return _equalities.count(elem) > 0; }
+        bool contains( const BSONElement& elem ) const;
 
         size_t numRegexes() const { return _regexes.size(); }
         RegexMatchExpression* regex( int idx ) const { return _regexes[idx]; }
@@ -314,10 +322,34 @@ namespace mongo {
         void toBSON(BSONArrayBuilder* out) const;
 
     private:
+        // How contains() resolves lookups. The accelerated modes are selected by
+        // finishBuilding() when the literal set is large enough.
+        enum LookupMode {
+            LOOKUP_SET,       // search _equalities
+            LOOKUP_INTEGERS,  // binary search _sortedIntegers
+            LOOKUP_HASHED     // probe _hashTable
+        };
+
+        struct HashSlot {
+            HashSlot() : hash(0) { }
+
+            unsigned hash;
+            BSONElement elem;  // eoo() means the slot is empty
+        };
+
         bool _hasNull; // if _equalities has a jstNULL element in it
         bool _hasEmptyArray;
         BSONElementSet _equalities;
         std::vector<RegexMatchExpression*> _regexes;
+
+        LookupMode _lookupMode;
+
+        // Every equality as a 64-bit integer, sorted. Only used for LOOKUP_INTEGERS.
+        std::vector<long long> _sortedIntegers;
+
+        // Open-addressing table with linear probing, sized to a power of two at least
+        // twice the number of equalities. Only used for LOOKUP_HASHED.
+        std::vector<HashSlot> _hashTable;
     };
 
     /**
@@ -35,6 +35,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -1575,6 +1576,80 @@ namespace mongo {
         ASSERT_EQUALS( "1", details.elemMatchKey() );
     }
 
+    TEST( InMatchExpression, AcceleratedIntegerLookup ) {
+        // Large integer-only lists switch to a sorted-vector lookup in finishBuilding().
+        BSONArrayBuilder bab;
+        for ( int i = 0; i < 50; i++ ) {
+            bab.append( i * 3 );
+        }
+        BSONArray operand = bab.arr();
+
+        InMatchExpression in;
+        in.init( "a" );
+        BSONObjIterator it( operand );
+        while ( it.more() ) {
+            ASSERT_OK( in.getArrayFilterEntries()->addEquality( it.next() ) );
+        }
+        in.getArrayFilterEntries()->finishBuilding();
+
+        ASSERT( in.matchesBSON( BSON( "a" << 0 ), NULL ) );
+        ASSERT( in.matchesBSON( BSON( "a" << 147 ), NULL ) );
+        ASSERT( !in.matchesBSON( BSON( "a" << 148 ), NULL ) );
+        ASSERT( !in.matchesBSON( BSON( "a" << 150 ), NULL ) );
+
+        // Numeric comparison crosses bson number types.
+        ASSERT( in.matchesBSON( BSON( "a" << 21.0 ), NULL ) );
+        ASSERT( in.matchesBSON( BSON( "a" << 21LL ), NULL ) );
+        ASSERT( !in.matchesBSON( BSON( "a" << 21.5 ), NULL ) );
+        ASSERT( !in.matchesBSON( BSON( "a" << "21" ), NULL ) );
+    }
+
+    TEST( InMatchExpression, AcceleratedHashedLookup ) {
+        // Large string lists switch to a hashed lookup in finishBuilding().
+        BSONArrayBuilder bab;
+        for ( int i = 0; i < 50; i++ ) {
+            bab.append( mongoutils::str::stream() << "value" << i );
+        }
+        BSONArray operand = bab.arr();
+
+        InMatchExpression in;
+        in.init( "a" );
+        BSONObjIterator it( operand );
+        while ( it.more() ) {
+            ASSERT_OK( in.getArrayFilterEntries()->addEquality( it.next() ) );
+        }
+        in.getArrayFilterEntries()->finishBuilding();
+
+        ASSERT( in.matchesBSON( BSON( "a" << "value0" ), NULL ) );
+        ASSERT( in.matchesBSON( BSON( "a" << "value49" ), NULL ) );
+        ASSERT( !in.matchesBSON( BSON( "a" << "value50" ), NULL ) );
+        ASSERT( !in.matchesBSON( BSON( "a" << "valu" ), NULL ) );
+        ASSERT( !in.matchesBSON( BSON( "a" << 7 ), NULL ) );
+    }
+
+    TEST( InMatchExpression, AcceleratedMixedTypeLookup ) {
+        // Mixed-type lists keep the BSONElementSet representation.
+        BSONArrayBuilder bab;
+        for ( int i = 0; i < 25; i++ ) {
+            bab.append( i );
+            bab.append( mongoutils::str::stream() << "value" << i );
+        }
+        BSONArray operand = bab.arr();
+
+        InMatchExpression in;
+        in.init( "a" );
+        BSONObjIterator it( operand );
+        while ( it.more() ) {
+            ASSERT_OK( in.getArrayFilterEntries()->addEquality( it.next() ) );
+        }
+        in.getArrayFilterEntries()->finishBuilding();
+
+        ASSERT( in.matchesBSON( BSON( "a" << 24 ), NULL ) );
+        ASSERT( in.matchesBSON( BSON( "a" << "value24" ), NULL ) );
+        ASSERT( !in.matchesBSON( BSON( "a" << 25 ), NULL ) );
+        ASSERT( !in.matchesBSON( BSON( "a" << "value25" ), NULL ) );
+    }
+
     /**
     TEST( InMatchExpression, MatchesIndexKeyScalar ) {
         BSONObj operand = BSON( "$in" << BSON_ARRAY( 6 << 5 ) );
@@ -636,6 +636,10 @@ namespace mongo {
                     return s;
             }
         }
+
+        // Large literal sets get an accelerated lookup structure.
+        entries->finishBuilding();
+
         return Status::OK();
 
     }
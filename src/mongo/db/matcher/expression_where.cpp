@@ -37,6 +37,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/expression_where_rewrite.h"
 #include "mongo/scripting/engine.h"
 
 
@@ -186,6 +187,15 @@ namespace mongo {
             return StatusWithMatchExpression(ErrorCodes::BadValue,
                                              "no globalScriptEngine in $where parsing");
 
+        if (where.type() == String || where.type() == Code) {
+            // Simple comparison-only $where bodies translate into native match
+            // expressions and skip the javascript engine entirely.
+            MatchExpression* rewritten = rewriteWhereToMatchExpression(where.valuestr());
+            if (rewritten) {
+                return StatusWithMatchExpression(rewritten);
+            }
+        }
+
         auto_ptr<WhereMatchExpression> exp(new WhereMatchExpression(_txn));
         if (where.type() == String || where.type() == Code) {
             Status s = exp->init(_dbName, where.valuestr(), BSONObj());
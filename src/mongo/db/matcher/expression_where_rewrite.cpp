@@ -0,0 +1,421 @@
+// expression_where_rewrite.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/matcher/expression_where_rewrite.h"
+
+#include <cstdlib>
+#include <memory>
+
+#include "mongo/db/matcher/expression_tree.h"
+
+
+namespace mongo {
+
+    Status WhereStrictEqualityMatchExpression::init( const StringData& path,
+                                                     const BSONElement& rhs ) {
+        switch ( rhs.type() ) {
+        case NumberDouble:
+        case String:
+        case Bool:
+        case jstNULL:
+            break;
+        default:
+            return Status( ErrorCodes::BadValue, "invalid $where rewrite literal" );
+        }
+        _rhsObj = rhs.wrap();
+        _rhs = _rhsObj.firstElement();
+        _pathStorage = path.toString();
+        _fieldRef.parse( _pathStorage );
+        return initPath( _pathStorage );
+    }
+
+    bool WhereStrictEqualityMatchExpression::matches( const MatchableDocument* doc,
+                                                      MatchDetails* details ) const {
+        // Resolve the path the way javascript property access does: no implicit
+        // descent into arrays, and a missing or unreachable field is undefined,
+        // which is never strictly equal to our (primitive, non-undefined) literal.
+        BSONObj obj = doc->toBSON();
+        BSONElement e;
+        for ( size_t i = 0; i < _fieldRef.numParts(); i++ ) {
+            if ( i > 0 ) {
+                if ( !e.isABSONObj() )
+                    return false;
+                obj = e.Obj();
+            }
+            e = obj.getField( _fieldRef.getPart( i ) );
+            if ( e.eoo() )
+                return false;
+        }
+        return matchesSingleElement( e );
+    }
+
+    bool WhereStrictEqualityMatchExpression::matchesSingleElement( const BSONElement& e ) const {
+        switch ( e.type() ) {
+        case NumberInt:
+        case NumberDouble:
+            // NumberLong is deliberately excluded: the shell and server expose it
+            // to javascript as a wrapper object, which is never === a number.
+            return _rhs.type() == NumberDouble && e.numberDouble() == _rhs.numberDouble();
+        case String:
+        case Symbol:
+            return _rhs.type() == String &&
+                StringData( e.valuestr(), e.valuestrsize() - 1 ) ==
+                StringData( _rhs.valuestr(), _rhs.valuestrsize() - 1 );
+        case Bool:
+            return _rhs.type() == Bool && e.boolean() == _rhs.boolean();
+        case jstNULL:
+        case Undefined:
+            // Stored undefined surfaces as null in javascript, so === null sees both.
+            return _rhs.type() == jstNULL;
+        default:
+            // Objects, arrays, dates, etc. become objects in javascript and compare
+            // by reference, never === a primitive literal.
+            return false;
+        }
+    }
+
+    MatchExpression* WhereStrictEqualityMatchExpression::shallowClone() const {
+        WhereStrictEqualityMatchExpression* e = new WhereStrictEqualityMatchExpression();
+        e->init( path(), _rhs );
+        if ( getTag() ) {
+            e->setTag( getTag()->clone() );
+        }
+        return e;
+    }
+
+    void WhereStrictEqualityMatchExpression::debugString( StringBuilder& debug, int level ) const {
+        _debugAddSpace( debug, level );
+        debug << path() << " === " << _rhs.toString( false );
+
+        MatchExpression::TagData* td = getTag();
+        if ( NULL != td ) {
+            debug << " ";
+            td->debugString( &debug );
+        }
+
+        debug << "\n";
+    }
+
+    void WhereStrictEqualityMatchExpression::toBSON(BSONObjBuilder* out) const {
+        out->append( path(), BSON( "$_internalWhereStrictEq" << _rhs ) );
+    }
+
+    bool WhereStrictEqualityMatchExpression::equivalent( const MatchExpression* other ) const {
+        if ( matchType() != other->matchType() )
+            return false;
+        const WhereStrictEqualityMatchExpression* realOther =
+            static_cast<const WhereStrictEqualityMatchExpression*>( other );
+        return path() == realOther->path() &&
+            _rhs.type() == realOther->_rhs.type() &&
+            _rhs.valuesEqual( realOther->_rhs );
+    }
+
+    // -----------------
+
+    namespace {
+
+        /**
+         * Recursive descent over the translatable $where subset:
+         *
+         *     program    := funcForm | expr ';'? EOF
+         *     funcForm   := 'function' '(' ')' '{' 'return' expr ';'? '}' EOF
+         *     expr       := primary ( '&&' primary )*
+         *     primary    := comparison | '(' expr ')'
+         *     comparison := path ( '===' | '!==' ) literal
+         *     path       := ( 'this' | 'obj' ) ( '.' ident )+
+         *     literal    := number | string | 'true' | 'false' | 'null'
+         *
+         * Anything outside the grammar aborts the whole rewrite, leaving the
+         * original javascript to run under the engine.
+         */
+        class WhereRewriter {
+        public:
+            WhereRewriter( const StringData& code )
+                : _pos( code.rawData() ), _end( code.rawData() + code.size() ) {}
+
+            MatchExpression* parse() {
+                skipWhitespace();
+                std::auto_ptr<MatchExpression> result;
+                if ( acceptKeyword( "function" ) ) {
+                    if ( !accept( "(" ) || !accept( ")" ) || !accept( "{" ) )
+                        return NULL;
+                    if ( !acceptKeyword( "return" ) )
+                        return NULL;
+                    result.reset( parseConjunction() );
+                    if ( !result.get() )
+                        return NULL;
+                    accept( ";" );
+                    if ( !accept( "}" ) )
+                        return NULL;
+                }
+                else {
+                    result.reset( parseConjunction() );
+                    if ( !result.get() )
+                        return NULL;
+                    accept( ";" );
+                }
+                skipWhitespace();
+                if ( _pos != _end )
+                    return NULL;
+                return result.release();
+            }
+
+        private:
+            static bool isIdentStart( char c ) {
+                return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) ||
+                    c == '_' || c == '$';
+            }
+
+            static bool isIdentChar( char c ) {
+                return isIdentStart( c ) || ( c >= '0' && c <= '9' );
+            }
+
+            void skipWhitespace() {
+                while ( _pos != _end &&
+                        ( *_pos == ' ' || *_pos == '\t' || *_pos == '\n' || *_pos == '\r' ) ) {
+                    _pos++;
+                }
+            }
+
+            bool accept( const char* token ) {
+                skipWhitespace();
+                const char* p = _pos;
+                for ( ; *token; token++, p++ ) {
+                    if ( p == _end || *p != *token )
+                        return false;
+                }
+                _pos = p;
+                return true;
+            }
+
+            // Like accept(), but the match must not run into a longer identifier
+            // ("returned", "thisOne", ...).
+            bool acceptKeyword( const char* keyword ) {
+                skipWhitespace();
+                const char* save = _pos;
+                if ( !accept( keyword ) )
+                    return false;
+                if ( _pos != _end && isIdentChar( *_pos ) ) {
+                    _pos = save;
+                    return false;
+                }
+                return true;
+            }
+
+            MatchExpression* parseConjunction() {
+                std::auto_ptr<MatchExpression> first( parsePrimary() );
+                if ( !first.get() )
+                    return NULL;
+                if ( !accept( "&&" ) )
+                    return first.release();
+
+                std::auto_ptr<AndMatchExpression> andExpr( new AndMatchExpression() );
+                andExpr->add( first.release() );
+                do {
+                    MatchExpression* next = parsePrimary();
+                    if ( !next )
+                        return NULL;
+                    andExpr->add( next );
+                } while ( accept( "&&" ) );
+                return andExpr.release();
+            }
+
+            MatchExpression* parsePrimary() {
+                if ( accept( "(" ) ) {
+                    std::auto_ptr<MatchExpression> inner( parseConjunction() );
+                    if ( !inner.get() || !accept( ")" ) )
+                        return NULL;
+                    return inner.release();
+                }
+                return parseComparison();
+            }
+
+            MatchExpression* parseComparison() {
+                std::string path;
+                if ( !parsePath( &path ) )
+                    return NULL;
+
+                bool negated;
+                if ( accept( "===" ) ) {
+                    negated = false;
+                }
+                else if ( accept( "!==" ) ) {
+                    negated = true;
+                }
+                else {
+                    return NULL;
+                }
+
+                BSONObj literal;
+                if ( !parseLiteral( &literal ) )
+                    return NULL;
+
+                std::auto_ptr<WhereStrictEqualityMatchExpression> eq(
+                    new WhereStrictEqualityMatchExpression() );
+                if ( !eq->init( path, literal.firstElement() ).isOK() )
+                    return NULL;
+                if ( !negated )
+                    return eq.release();
+
+                // value !== literal is exactly !(value === literal) since our
+                // literals are never undefined.
+                std::auto_ptr<NotMatchExpression> notExpr( new NotMatchExpression() );
+                notExpr->init( eq.release() );
+                return notExpr.release();
+            }
+
+            bool parsePath( std::string* path ) {
+                if ( !acceptKeyword( "this" ) && !acceptKeyword( "obj" ) )
+                    return false;
+
+                std::string dotted;
+                bool firstPart = true;
+                while ( accept( "." ) ) {
+                    if ( _pos == _end || !isIdentStart( *_pos ) )
+                        return false;
+                    const char* start = _pos;
+                    while ( _pos != _end && isIdentChar( *_pos ) )
+                        _pos++;
+                    StringData part( start, _pos - start );
+
+                    // 'length' is a real javascript property of arrays and strings
+                    // but not a document field; leave those to the engine.
+                    if ( part == "length" )
+                        return false;
+
+                    if ( !firstPart )
+                        dotted.push_back( '.' );
+                    dotted.append( part.rawData(), part.size() );
+                    firstPart = false;
+                }
+                if ( firstPart )
+                    return false;
+                *path = dotted;
+                return true;
+            }
+
+            bool parseLiteral( BSONObj* literal ) {
+                skipWhitespace();
+                if ( _pos == _end )
+                    return false;
+
+                BSONObjBuilder bob;
+                if ( acceptKeyword( "true" ) ) {
+                    bob.appendBool( "", true );
+                }
+                else if ( acceptKeyword( "false" ) ) {
+                    bob.appendBool( "", false );
+                }
+                else if ( acceptKeyword( "null" ) ) {
+                    bob.appendNull( "" );
+                }
+                else if ( *_pos == '\'' || *_pos == '"' ) {
+                    std::string s;
+                    if ( !parseStringLiteral( &s ) )
+                        return false;
+                    bob.append( "", s );
+                }
+                else {
+                    double d;
+                    if ( !parseNumberLiteral( &d ) )
+                        return false;
+                    bob.append( "", d );
+                }
+                *literal = bob.obj();
+                return true;
+            }
+
+            bool parseStringLiteral( std::string* out ) {
+                const char quote = *_pos++;
+                StringBuilder sb;
+                while ( _pos != _end && *_pos != quote ) {
+                    char c = *_pos++;
+                    if ( c == '\\' ) {
+                        if ( _pos == _end )
+                            return false;
+                        switch ( *_pos++ ) {
+                        case '\\': c = '\\'; break;
+                        case '\'': c = '\''; break;
+                        case '"': c = '"'; break;
+                        case 'n': c = '\n'; break;
+                        case 't': c = '\t'; break;
+                        case 'r': c = '\r'; break;
+                        default:
+                            // Unicode and octal escapes aren't worth reproducing.
+                            return false;
+                        }
+                    }
+                    sb << c;
+                }
+                if ( _pos == _end )
+                    return false;
+                _pos++; // closing quote
+                *out = sb.str();
+                return true;
+            }
+
+            bool parseNumberLiteral( double* out ) {
+                const char* start = _pos;
+                if ( _pos != _end && *_pos == '-' )
+                    _pos++;
+                // Plain decimal only, so strtod can't sneak in hex or infinities.
+                const char* digitsStart = _pos;
+                while ( _pos != _end && ( ( *_pos >= '0' && *_pos <= '9' ) || *_pos == '.' ) )
+                    _pos++;
+                if ( _pos == digitsStart )
+                    return false;
+                if ( _pos != _end && ( *_pos == 'e' || *_pos == 'E' ) ) {
+                    _pos++;
+                    if ( _pos != _end && ( *_pos == '+' || *_pos == '-' ) )
+                        _pos++;
+                    const char* expStart = _pos;
+                    while ( _pos != _end && *_pos >= '0' && *_pos <= '9' )
+                        _pos++;
+                    if ( _pos == expStart )
+                        return false;
+                }
+                const std::string text( start, _pos - start );
+                char* endPtr = NULL;
+                *out = strtod( text.c_str(), &endPtr );
+                return endPtr == text.c_str() + text.size();
+            }
+
+            const char* _pos;
+            const char* _end;
+        };
+
+    }  // namespace
+
+    MatchExpression* rewriteWhereToMatchExpression( const StringData& code ) {
+        WhereRewriter rewriter( code );
+        return rewriter.parse();
+    }
+
+}  // namespace mongo
@@ -0,0 +1,101 @@
+// expression_where_rewrite.h
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/matcher/expression_leaf.h"
+
+namespace mongo {
+
+    /**
+     * Strict (===) javascript equality against a primitive literal, with javascript
+     * field resolution: no implicit array traversal, no type coercion, and a missing
+     * field is undefined rather than a match failure on null.
+     *
+     * Only created by rewriteWhereToMatchExpression() below; never parsed from user
+     * input and never indexed.
+     */
+    class WhereStrictEqualityMatchExpression : public LeafMatchExpression {
+    public:
+        WhereStrictEqualityMatchExpression()
+            : LeafMatchExpression( INTERNAL_WHERE_STRICT_EQ ) {}
+
+        virtual ~WhereStrictEqualityMatchExpression() {}
+
+        /**
+         * 'rhs' must be a NumberDouble, String, Bool, or jstNULL literal.  Copied.
+         */
+        Status init( const StringData& path, const BSONElement& rhs );
+
+        virtual bool matches( const MatchableDocument* doc, MatchDetails* details = 0 ) const;
+
+        virtual bool matchesSingleElement( const BSONElement& e ) const;
+
+        virtual MatchExpression* shallowClone() const;
+
+        virtual void debugString( StringBuilder& debug, int level = 0 ) const;
+
+        virtual void toBSON(BSONObjBuilder* out) const;
+
+        virtual bool equivalent( const MatchExpression* other ) const;
+
+        const BSONElement& getData() const { return _rhs; }
+
+    private:
+        // LeafMatchExpression only holds a StringData view of the path, so we keep
+        // the backing string ourselves; the path comes from parsed $where source.
+        std::string _pathStorage;
+        FieldRef _fieldRef;
+        BSONObj _rhsObj;
+        BSONElement _rhs;
+    };
+
+    /**
+     * Attempts to translate $where javascript source into an equivalent native
+     * MatchExpression tree, so that simple legacy predicates skip the javascript
+     * engine entirely.
+     *
+     * The recognized subset is conjunctions ('&&') of strict comparisons of a
+     * document field against a primitive literal:
+     *
+     *     this.a.b === 5 && this.c !== 'x'
+     *
+     * optionally wrapped in "function() { return ...; }".  Paths may start with
+     * 'this' or 'obj', and literals may be numbers, single or double quoted
+     * strings, true, false, or null.  Loose comparisons (==, <, ...) are not
+     * translated since they coerce types in javascript.
+     *
+     * Returns a newly allocated tree the caller owns, or NULL if the source is not
+     * in the translatable subset and must run under the javascript engine.
+     */
+    MatchExpression* rewriteWhereToMatchExpression( const StringData& code );
+
+}  // namespace mongo
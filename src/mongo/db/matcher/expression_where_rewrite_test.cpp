@@ -0,0 +1,150 @@
+// expression_where_rewrite_test.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include <memory>
+
+#include "mongo/unittest/unittest.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_where_rewrite.h"
+
+namespace mongo {
+
+    namespace {
+
+        bool rewrites( const char* code ) {
+            std::auto_ptr<MatchExpression> expr( rewriteWhereToMatchExpression( code ) );
+            return NULL != expr.get();
+        }
+
+        bool rewrittenMatches( const char* code, const BSONObj& doc ) {
+            std::auto_ptr<MatchExpression> expr( rewriteWhereToMatchExpression( code ) );
+            ASSERT( expr.get() );
+            return expr->matchesBSON( doc, NULL );
+        }
+
+    }  // namespace
+
+    TEST( WhereRewrite, AcceptsTranslatableSubset ) {
+        ASSERT( rewrites( "this.a === 5" ) );
+        ASSERT( rewrites( "obj.a.b !== 'x'" ) );
+        ASSERT( rewrites( "this.a === 1 && this.b !== true && this.c === null;" ) );
+        ASSERT( rewrites( "function() { return this.a === 5; }" ) );
+        ASSERT( rewrites( "( this.a === 1 ) && ( this.b === 2 && this.c === 3 )" ) );
+        ASSERT( rewrites( "this.a === -2.5e3" ) );
+    }
+
+    TEST( WhereRewrite, RejectsEverythingElse ) {
+        // Loose comparisons coerce types in javascript and cannot be translated.
+        ASSERT( !rewrites( "this.a == 5" ) );
+        ASSERT( !rewrites( "this.a != 5" ) );
+        ASSERT( !rewrites( "this.a < 5" ) );
+        // Disjunction, arbitrary expressions, function calls.
+        ASSERT( !rewrites( "this.a === 1 || this.b === 2" ) );
+        ASSERT( !rewrites( "this.a === this.b" ) );
+        ASSERT( !rewrites( "this.a.indexOf('x') >= 0" ) );
+        ASSERT( !rewrites( "sleep(100) || true" ) );
+        // 'length' is a live property of arrays and strings in javascript.
+        ASSERT( !rewrites( "this.a.length === 3" ) );
+        // Keyword prefixes must not match longer identifiers.
+        ASSERT( !rewrites( "thisx.a === 1" ) );
+        ASSERT( !rewrites( "this.a === nullx" ) );
+        // Trailing garbage.
+        ASSERT( !rewrites( "this.a === 1; this.b = 2" ) );
+        ASSERT( !rewrites( "" ) );
+    }
+
+    TEST( WhereRewrite, StrictNumberEquality ) {
+        const char* code = "this.a === 5";
+        ASSERT( rewrittenMatches( code, BSON( "a" << 5 ) ) );
+        ASSERT( rewrittenMatches( code, BSON( "a" << 5.0 ) ) );
+        ASSERT( !rewrittenMatches( code, BSON( "a" << 6 ) ) );
+        ASSERT( !rewrittenMatches( code, BSON( "a" << "5" ) ) );
+        // NumberLong is a wrapper object in javascript, never === a number.
+        ASSERT( !rewrittenMatches( code, BSON( "a" << 5LL ) ) );
+        // No implicit array traversal: [5] === 5 is false.
+        ASSERT( !rewrittenMatches( code, BSON( "a" << BSON_ARRAY( 5 ) ) ) );
+        ASSERT( !rewrittenMatches( code, BSONObj() ) );
+    }
+
+    TEST( WhereRewrite, StrictStringEquality ) {
+        const char* code = "this.a === 'x\\'y'";
+        ASSERT( rewrittenMatches( code, BSON( "a" << "x'y" ) ) );
+        ASSERT( !rewrittenMatches( code, BSON( "a" << "xy" ) ) );
+    }
+
+    TEST( WhereRewrite, NullMatchesNullAndUndefined ) {
+        const char* code = "this.a === null";
+        ASSERT( rewrittenMatches( code, BSON( "a" << BSONNULL ) ) );
+        // Stored undefined surfaces as null in javascript.
+        ASSERT( rewrittenMatches( code, BSON( "a" << BSONUndefined ) ) );
+        // But a missing field is undefined, which is not === null.
+        ASSERT( !rewrittenMatches( code, BSONObj() ) );
+        ASSERT( !rewrittenMatches( code, BSON( "a" << 0 ) ) );
+    }
+
+    TEST( WhereRewrite, NegationMatchesMissing ) {
+        const char* code = "this.a !== 5";
+        ASSERT( rewrittenMatches( code, BSON( "a" << 6 ) ) );
+        ASSERT( rewrittenMatches( code, BSONObj() ) );
+        ASSERT( rewrittenMatches( code, BSON( "a" << "5" ) ) );
+        ASSERT( !rewrittenMatches( code, BSON( "a" << 5.0 ) ) );
+    }
+
+    TEST( WhereRewrite, DottedPathsDoNotTraverseArrays ) {
+        const char* code = "this.a.b === 1";
+        ASSERT( rewrittenMatches( code, BSON( "a" << BSON( "b" << 1 ) ) ) );
+        // javascript sees no 'b' property on an array of subdocuments.
+        ASSERT( !rewrittenMatches( code,
+                                   BSON( "a" << BSON_ARRAY( BSON( "b" << 1 ) ) ) ) );
+        ASSERT( !rewrittenMatches( code, BSON( "a" << 1 ) ) );
+    }
+
+    TEST( WhereRewrite, ConjunctionAndFunctionForm ) {
+        const char* code = "function() { return this.a === 1 && this.b === 'x'; }";
+        ASSERT( rewrittenMatches( code, BSON( "a" << 1 << "b" << "x" ) ) );
+        ASSERT( !rewrittenMatches( code, BSON( "a" << 1 << "b" << "y" ) ) );
+        ASSERT( !rewrittenMatches( code, BSON( "b" << "x" ) ) );
+    }
+
+    TEST( WhereRewrite, EquivalentAndClone ) {
+        std::auto_ptr<MatchExpression> a( rewriteWhereToMatchExpression( "this.a === 5" ) );
+        std::auto_ptr<MatchExpression> b( rewriteWhereToMatchExpression( "this.a===5.0" ) );
+        std::auto_ptr<MatchExpression> c( rewriteWhereToMatchExpression( "this.b === 5" ) );
+        ASSERT( a->equivalent( b.get() ) );
+        ASSERT( !a->equivalent( c.get() ) );
+
+        std::auto_ptr<MatchExpression> clone( a->shallowClone() );
+        ASSERT( a->equivalent( clone.get() ) );
+        ASSERT( clone->matchesBSON( BSON( "a" << 5 ), NULL ) );
+    }
+
+}  // namespace mongo
@@ -54,12 +54,17 @@ namespace mongo {
                  result.isOK() );
 
         _expression.reset( result.getValue() );
+        _compiled.reset( CompiledMatcher::compile( _expression.get() ) );
     }
 
     bool Matcher::matches(const BSONObj& doc, MatchDetails* details ) const {
         if ( !_expression )
             return true;
 
+        // The compiled form cannot fill in match details.
+        if ( _compiled && NULL == details )
+            return _compiled->matches( doc );
+
         return _expression->matchesBSON( doc, details );
     }
 
@@ -35,6 +35,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/compiled_matcher.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/match_details.h"
@@ -63,6 +64,9 @@ namespace mongo {
         BSONObj _pattern;
 
         boost::scoped_ptr<MatchExpression> _expression;
+
+        // Set when _expression flattens to a single-pass matcher. NULL otherwise.
+        boost::scoped_ptr<CompiledMatcher> _compiled;
     };
 
 }  // namespace mongo
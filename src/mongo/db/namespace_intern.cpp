@@ -0,0 +1,86 @@
+// namespace_intern.cpp
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/namespace_intern.h"
+
+#include "mongo/util/concurrency/rwlock.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+    namespace {
+
+        // Entries are immortal, so cap how many distinct namespaces we are willing to
+        // remember. A workload cycling through more collections than this simply stays
+        // on the uninterned path for the excess.
+        const size_t kMaxInternedNamespaces = 10000;
+
+        RWLock internLock( "NamespaceIntern" );
+        StringMap<const InternedNamespace*> internTable;
+
+    }  // namespace
+
+    InternedNamespace::InternedNamespace( const NamespaceString& nss )
+        : _nss( nss ),
+          _dbResourceId( RESOURCE_DATABASE, nss.db() ),
+          _collResourceId( RESOURCE_COLLECTION, nss.ns() ) {
+    }
+
+    const InternedNamespace* InternedNamespace::intern( const StringData& ns ) {
+        {
+            rwlock_shared lk( internLock );
+            StringMap<const InternedNamespace*>::const_iterator it = internTable.find( ns );
+            if ( it != internTable.end() )
+                return it->second;
+        }
+
+        // Only remember well-formed collection namespaces; anything else goes down the
+        // uninterned path, where the caller's own validation reports the error.
+        NamespaceString nss( ns );
+        if ( !nss.isValid() || !nsIsFull( ns ) )
+            return NULL;
+
+        rwlock lk( internLock, true /* write */ );
+
+        StringMap<const InternedNamespace*>::const_iterator it = internTable.find( ns );
+        if ( it != internTable.end() )
+            return it->second;
+
+        if ( internTable.size() >= kMaxInternedNamespaces )
+            return NULL;
+
+        const InternedNamespace* entry = new InternedNamespace( nss );
+        internTable[ns] = entry;
+        return entry;
+    }
+
+}  // namespace mongo
@@ -0,0 +1,75 @@
+// namespace_intern.h
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/concurrency/lock_manager_defs.h"
+#include "mongo/db/namespace_string.h"
+
+namespace mongo {
+
+    /**
+     * An immortal, process-wide interned namespace entry.
+     *
+     * The first operation to touch a namespace pays for parsing the name and hashing it
+     * into the lock manager's ResourceIds; every later operation on the same namespace
+     * gets the entry back with a single hash table lookup and reuses the parsed
+     * NamespaceString and the precomputed ResourceIds without copying or re-hashing
+     * the name.
+     */
+    class InternedNamespace {
+        MONGO_DISALLOW_COPYING(InternedNamespace);
+    public:
+        /**
+         * Returns the entry for 'ns', creating it on first use. Returns NULL -- and the
+         * caller must use the plain uninterned path -- if 'ns' is not a valid collection
+         * namespace or the table has reached its cap (entries are never reclaimed, so
+         * the number of distinct namespaces we remember is bounded).
+         */
+        static const InternedNamespace* intern( const StringData& ns );
+
+        const NamespaceString& nss() const { return _nss; }
+        const std::string& ns() const { return _nss.ns(); }
+        StringData db() const { return _nss.db(); }
+
+        ResourceId dbResourceId() const { return _dbResourceId; }
+        ResourceId collResourceId() const { return _collResourceId; }
+
+    private:
+        explicit InternedNamespace( const NamespaceString& nss );
+
+        const NamespaceString _nss;
+        const ResourceId _dbResourceId;
+        const ResourceId _collResourceId;
+    };
+
+}  // namespace mongo
@@ -31,6 +31,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
 #include "mongo/base/string_data.h"
+#include "mongo/bson/util/builder_arena.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/d_concurrency.h"
@@ -137,8 +138,19 @@ namespace mongo {
          */
         virtual bool isPrimaryFor( const StringData& ns ) = 0;
 
+        /**
+         * Arena for transient BSON built while servicing this operation.  Buffers acquired here
+         * are recycled for the life of the operation and freed wholesale when it completes,
+         * instead of a malloc/free round trip per short-lived document.  Only the thread running
+         * the operation may touch it.  See ArenaBSONObjBuilder.
+         */
+        BufBuilderArena& builderArena() { return _builderArena; }
+
     protected:
         OperationContext() { }
+
+    private:
+        BufBuilderArena _builderArena;
     };
 
     class WriteUnitOfWork {
@@ -0,0 +1,102 @@
+// operation_memory.cpp
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_memory.h"
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    namespace {
+
+        // Upper bound on the bytes one operation may have charged at once.
+        // 0 means no limit.
+        MONGO_EXPORT_SERVER_PARAMETER(maxMemoryPerOperationMB, int, 0);
+
+        ThreadLocalValue<OperationMemoryTracker*> currentTracker;
+
+    }  // namespace
+
+    OperationMemoryTracker::OperationMemoryTracker() {
+    }
+
+    void OperationMemoryTracker::charge( long long bytes ) {
+        const long long total = _used.addAndFetch( bytes );
+        if ( total > _peak.loadRelaxed() )
+            _peak.store( total );
+
+        const long long capMB = maxMemoryPerOperationMB;
+        if ( capMB > 0 && total > capMB * 1024 * 1024 ) {
+            uasserted( 28638,
+                       str::stream() << "operation is holding " << total
+                                     << " bytes of memory, over the maxMemoryPerOperationMB"
+                                     << " limit of " << capMB );
+        }
+    }
+
+    void OperationMemoryTracker::release( long long bytes ) {
+        if ( _used.subtractAndFetch( bytes ) < 0 ) {
+            // The memory was charged to an earlier operation on this CurOp (see
+            // the class comment); don't let the current one go negative.
+            _used.store( 0 );
+        }
+    }
+
+    void OperationMemoryTracker::reset() {
+        _used.store( 0 );
+        _peak.store( 0 );
+    }
+
+    OperationMemoryTracker* OperationMemoryTracker::get() {
+        return currentTracker.get();
+    }
+
+    void OperationMemoryTracker::setCurrent( OperationMemoryTracker* tracker ) {
+        currentTracker.set( tracker );
+    }
+
+    void OperationMemoryTracker::chargeCurrent( long long bytes ) {
+        OperationMemoryTracker* tracker = currentTracker.get();
+        if ( tracker )
+            tracker->charge( bytes );
+    }
+
+    void OperationMemoryTracker::releaseCurrent( long long bytes ) {
+        OperationMemoryTracker* tracker = currentTracker.get();
+        if ( tracker )
+            tracker->release( bytes );
+    }
+
+}
@@ -0,0 +1,91 @@
+// operation_memory.h
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+    /**
+     * Byte accounting for the operation running on the current thread.
+     *
+     * Code that buffers unbounded amounts of data (in-memory sorts, aggregation
+     * documents) charges its growth here, so a memory spike can be attributed to
+     * an operation in currentOp output ("memUsed"/"memPeak"), and so the
+     * maxMemoryPerOperationMB server parameter can fail the one greedy operation
+     * instead of letting it OOM the whole node.  The parameter defaults to 0,
+     * which enforces no limit.
+     *
+     * Accounting is best effort: memory handed off to a long lived structure
+     * (e.g. a cursor that survives across getMores) stays charged to the
+     * operation that allocated it, and a release issued by a later operation
+     * saturates at zero rather than going negative.
+     */
+    class OperationMemoryTracker {
+        MONGO_DISALLOW_COPYING(OperationMemoryTracker);
+    public:
+        OperationMemoryTracker();
+
+        /**
+         * Records that the operation now holds "bytes" more memory.  Throws a
+         * UserException if this pushes the operation over the configured cap.
+         */
+        void charge( long long bytes );
+
+        /** Records that "bytes" previously charged have been freed. */
+        void release( long long bytes );
+
+        long long used() const { return _used.loadRelaxed(); }
+        long long peak() const { return _peak.loadRelaxed(); }
+
+        void reset();
+
+        /**
+         * The tracker of the operation running on this thread, or NULL when the
+         * thread has none (during startup, or in a process without CurOp, such
+         * as mongos).  CurOp installs the tracker with setCurrent().
+         */
+        static OperationMemoryTracker* get();
+        static void setCurrent( OperationMemoryTracker* tracker );
+
+        /** Charge/release against this thread's tracker; no-ops without one. */
+        static void chargeCurrent( long long bytes );
+        static void releaseCurrent( long long bytes );
+
+    private:
+        // Written only by the operation's own thread; read by currentOp
+        // reporting from other threads.
+        AtomicInt64 _used;
+        AtomicInt64 _peak;
+    };
+
+}
@@ -46,23 +46,28 @@ namespace mongo {
             _god(false),
             _fromMigrate(false),
             _isExplain(false),
+            _returnDeleted(false),
             _yieldPolicy(PlanExecutor::YIELD_MANUAL) {}
 
         void setQuery(const BSONObj& query) { _query = query; }
+        void setSort(const BSONObj& sort) { _sort = sort; }
         void setMulti(bool multi = true) { _multi = multi; }
         void setUpdateOpLog(bool logop = true) { _logop = logop; }
         void setGod(bool god = true) { _god = god; }
         void setFromMigrate(bool fromMigrate = true) { _fromMigrate = fromMigrate; }
         void setExplain(bool isExplain = true) { _isExplain = isExplain; }
+        void setReturnDeleted(bool returnDeleted = true) { _returnDeleted = returnDeleted; }
         void setYieldPolicy(PlanExecutor::YieldPolicy yieldPolicy) { _yieldPolicy = yieldPolicy; }
 
         const NamespaceString& getNamespaceString() const { return _nsString; }
         const BSONObj& getQuery() const { return _query; }
+        const BSONObj& getSort() const { return _sort; }
         bool isMulti() const { return _multi; }
         bool shouldCallLogOp() const { return _logop; }
         bool isGod() const { return _god; }
         bool isFromMigrate() const { return _fromMigrate; }
         bool isExplain() const { return _isExplain; }
+        bool shouldReturnDeleted() const { return _returnDeleted; }
         PlanExecutor::YieldPolicy getYieldPolicy() const { return _yieldPolicy; }
 
         std::string toString() const;
@@ -70,11 +75,17 @@ namespace mongo {
     private:
         const NamespaceString& _nsString;
         BSONObj _query;
+        // Determines which of several matching documents a single-document delete removes.
+        // Only meaningful when '_multi' is false.
+        BSONObj _sort;
         bool _multi;
         bool _logop;
         bool _god;
         bool _fromMigrate;
         bool _isExplain;
+        // True if the delete stage should produce each deleted document as an execution
+        // result (findAndModify).
+        bool _returnDeleted;
         PlanExecutor::YieldPolicy _yieldPolicy;
     };
 
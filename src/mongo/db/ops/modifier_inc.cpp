@@ -126,6 +126,23 @@ namespace mongo {
         return Status::OK();
     }
 
+    bool ModifierInc::rebind(const BSONElement& modExpr) {
+        // A positional path has its '$' part replaced with the matched array index during
+        // prepare(), so the original field name is gone and cannot be checked against.
+        if (_posDollar)
+            return false;
+
+        if (_fieldRef.dottedField() != modExpr.fieldName())
+            return false;
+
+        if (!modExpr.isNumber())
+            return false;
+
+        _val = modExpr;
+        dassert(_val.isValid());
+        return true;
+    }
+
     Status ModifierInc::prepare(mutablebson::Element root,
                                 const StringData& matchedField,
                                 ExecInfo* execInfo) {
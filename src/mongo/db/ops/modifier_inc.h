@@ -69,6 +69,11 @@ namespace mongo {
         virtual Status init(const BSONElement& modExpr, const Options& opts,
                             bool* positional = NULL);
 
+        /** Re-targets this mod at a new numeric argument for the same field. Refuses
+         *  positional paths, whose field name is rewritten during prepare().
+         */
+        virtual bool rebind(const BSONElement& modExpr);
+
         /** Evaluates the validity of applying $inc to the identified node, and computes
          *  effects, handling upcasting and overflow as necessary.
          */
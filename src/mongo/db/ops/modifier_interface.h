@@ -93,6 +93,18 @@ namespace mongo {
         virtual Status init(const BSONElement& modExpr, const Options& opts,
                             bool* positional = NULL) = 0;
 
+        /**
+         * Re-targets an already init()'d mod at 'modExpr', a new argument for the same
+         * modifier over the same field this mod was originally initialized with.  Returns
+         * true if the mod accepted the new argument and may be reused as if init() had
+         * been called with it.  Returns false if this mod type does not support rebinding
+         * or if 'modExpr' is not acceptable; the caller must then discard the mod and
+         * parse the expression from scratch.
+         *
+         * The lifetime note on init() applies to 'modExpr' here as well.
+         */
+        virtual bool rebind(const BSONElement& modExpr) { return false; }
+
         /**
          * Returns OK if it would be correct to apply this mod over the document 'root' (e.g, if
          * we're $inc-ing a field, is that field numeric in the current doc?).
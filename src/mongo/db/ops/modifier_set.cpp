@@ -119,6 +119,22 @@ namespace mongo {
         return Status::OK();
     }
 
+    bool ModifierSet::rebind(const BSONElement& modExpr) {
+        // A positional path has its '$' part replaced with the matched array index during
+        // prepare(), so the original field name is gone and cannot be checked against.
+        if (_posDollar)
+            return false;
+
+        if (_fieldRef.dottedField() != modExpr.fieldName())
+            return false;
+
+        if (!modExpr.ok())
+            return false;
+
+        _val = modExpr;
+        return true;
+    }
+
     Status ModifierSet::prepare(mutablebson::Element root,
                                 const StringData& matchedField,
                                 ExecInfo* execInfo) {
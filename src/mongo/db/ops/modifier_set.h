@@ -64,6 +64,12 @@ namespace mongo {
         virtual Status init(const BSONElement& modExpr, const Options& opts,
                             bool* positional = NULL);
 
+        /**
+         * Re-targets this mod at a new value for the same field. Refuses positional
+         * paths, whose field name is rewritten during prepare().
+         */
+        virtual bool rebind(const BSONElement& modExpr);
+
         /**
          * Looks up the field name in the sub-tree rooted at 'root', and binds, if necessary,
          * the '$' field part using the 'matchedfield' number. prepare() returns OK and
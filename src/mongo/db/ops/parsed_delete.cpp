@@ -66,11 +66,31 @@ namespace mongo {
         CanonicalQuery* cqRaw;
         const WhereCallbackReal whereCallback(_txn, _request->getNamespaceString().db());
 
-        Status status = CanonicalQuery::canonicalize(_request->getNamespaceString().ns(),
-                                                     _request->getQuery(),
-                                                     _request->isExplain(),
-                                                     &cqRaw,
-                                                     whereCallback);
+        Status status = Status::OK();
+        if (!_request->getSort().isEmpty()) {
+            // A sort determines which of several matching documents a single-document
+            // delete removes (findAndModify), so it must make it into the plan.
+            const BSONObj projection;
+            const long long skip = 0;
+            // A single-document delete stops at the first document in sort order;
+            // negative indicates a hard limit.
+            const long long limit = _request->isMulti() ? 0 : -1;
+            status = CanonicalQuery::canonicalize(_request->getNamespaceString().ns(),
+                                                  _request->getQuery(),
+                                                  _request->getSort(),
+                                                  projection,
+                                                  skip,
+                                                  limit,
+                                                  &cqRaw,
+                                                  whereCallback);
+        }
+        else {
+            status = CanonicalQuery::canonicalize(_request->getNamespaceString().ns(),
+                                                  _request->getQuery(),
+                                                  _request->isExplain(),
+                                                  &cqRaw,
+                                                  whereCallback);
+        }
 
         if (status.isOK()) {
             cqRaw->setIsForWrite(true);
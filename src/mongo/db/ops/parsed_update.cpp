@@ -31,6 +31,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/ops/parsed_update.h"
+#include "mongo/db/ops/update_driver_cache.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/query_planner_common.h"
@@ -40,9 +41,21 @@ namespace mongo {
     ParsedUpdate::ParsedUpdate(OperationContext* txn, const UpdateRequest* request) :
         _txn(txn),
         _request(request),
-        _driver(UpdateDriver::Options()),
+        _driver(NULL),
         _canonicalQuery() { }
 
+    ParsedUpdate::~ParsedUpdate() {
+        if (!_driver)
+            return;
+
+        if (!_driverCacheShape.empty()) {
+            UpdateDriverCache::forThread()->checkin(_driverCacheShape, _driver);
+        }
+        else {
+            delete _driver;
+        }
+    }
+
     Status ParsedUpdate::parseRequest() {
         // We parse the update portion before the query portion because the dispostion of the update
         // may determine whether or not we need to produce a CanonicalQuery at all.  For example, if
@@ -60,7 +73,7 @@ namespace mongo {
     Status ParsedUpdate::parseQuery() {
         dassert(!_canonicalQuery.get());
 
-        if (!_driver.needMatchDetails() && CanonicalQuery::isSimpleIdQuery(_request->getQuery())) {
+        if (!_driver->needMatchDetails() && CanonicalQuery::isSimpleIdQuery(_request->getQuery())) {
             return Status::OK();
         }
 
@@ -73,11 +86,31 @@ namespace mongo {
         CanonicalQuery* cqRaw;
         const WhereCallbackReal whereCallback(_txn, _request->getNamespaceString().db());
 
-        Status status = CanonicalQuery::canonicalize(_request->getNamespaceString().ns(),
-                                                     _request->getQuery(),
-                                                     _request->isExplain(),
-                                                     &cqRaw,
-                                                     whereCallback);
+        Status status = Status::OK();
+        if (!_request->getSort().isEmpty()) {
+            // A sort determines which of several matching documents a single-document
+            // update applies to (findAndModify), so it must make it into the plan.
+            const BSONObj projection;
+            const long long skip = 0;
+            // A single-document update stops at the first document in sort order;
+            // negative indicates a hard limit.
+            const long long limit = _request->isMulti() ? 0 : -1;
+            status = CanonicalQuery::canonicalize(_request->getNamespaceString().ns(),
+                                                  _request->getQuery(),
+                                                  _request->getSort(),
+                                                  projection,
+                                                  skip,
+                                                  limit,
+                                                  &cqRaw,
+                                                  whereCallback);
+        }
+        else {
+            status = CanonicalQuery::canonicalize(_request->getNamespaceString().ns(),
+                                                  _request->getQuery(),
+                                                  _request->isExplain(),
+                                                  &cqRaw,
+                                                  whereCallback);
+        }
         if (status.isOK()) {
             cqRaw->setIsForWrite(true);
             _canonicalQuery.reset(cqRaw);
@@ -97,11 +130,42 @@ namespace mongo {
                                       ns.isConfigDB() ||
                                       _request->isFromMigration());
 
-        _driver.setLogOp(true);
-        _driver.setModOptions(ModifierInterface::Options(_request->isFromReplication(),
-                                                         shouldValidate));
+        const ModifierInterface::Options modOptions(_request->isFromReplication(),
+                                                    shouldValidate);
+
+        // If this thread has already parsed an update of the same shape, re-target the
+        // cached driver at this request's values instead of parsing from scratch.
+        std::string shape;
+        if (UpdateDriverCache::computeShape(_request->getUpdates(), modOptions, &shape)) {
+            UpdateDriver* cached = UpdateDriverCache::forThread()->checkout(shape);
+            if (cached) {
+                if (cached->rebind(_request->getUpdates())) {
+                    // Execution toggles these (e.g. upserts turn off the oplog), so
+                    // restore them to their parse-time settings.
+                    cached->setLogOp(true);
+                    cached->setModOptions(modOptions);
+
+                    _driver = cached;
+                    _driverCacheShape = shape;
+                    return Status::OK();
+                }
+
+                // The new values were not acceptable to the cached mods (e.g. $inc by a
+                // non-number); fall through and parse from scratch so the user gets a
+                // proper error message.
+                delete cached;
+            }
+        }
+
+        _driver = new UpdateDriver(UpdateDriver::Options());
+        _driver->setLogOp(true);
+        _driver->setModOptions(modOptions);
 
-        return _driver.parse(_request->getUpdates(), _request->isMulti());
+        Status status = _driver->parse(_request->getUpdates(), _request->isMulti());
+        if (status.isOK())
+            _driverCacheShape = shape;
+
+        return status;
     }
 
     bool ParsedUpdate::canYield() const {
@@ -126,7 +190,7 @@ namespace mongo {
     }
 
     UpdateDriver* ParsedUpdate::getDriver() {
-        return &_driver;
+        return _driver;
     }
 
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
 #include "mongo/db/ops/update_driver.h"
@@ -59,6 +61,12 @@ namespace mongo {
          */
         ParsedUpdate(OperationContext* txn, const UpdateRequest* request);
 
+        /**
+         * Hands a successfully parsed driver back to this thread's UpdateDriverCache so
+         * the next update of the same shape can skip re-parsing.
+         */
+        ~ParsedUpdate();
+
         /**
          * Parses the update request to a canonical query and an update driver. On success, the
          * parsed update can be used to create a PlanExecutor for this update.
@@ -116,8 +124,14 @@ namespace mongo {
         // Unowned pointer to the request object to process.
         const UpdateRequest* const _request;
 
-        // Driver for processing updates on matched documents.
-        UpdateDriver _driver;
+        // Driver for processing updates on matched documents.  Either checked out of
+        // this thread's UpdateDriverCache (when an update of the same shape was parsed
+        // before) or freshly parsed.  Owned here until handed back to the cache.
+        UpdateDriver* _driver;
+
+        // Cache key for the update's shape, or the empty string if the driver was not
+        // successfully parsed or its shape is not cacheable.
+        std::string _driverCacheShape;
 
         // Parsed query object, or NULL if the query proves to be an id hack query.
         std::auto_ptr<CanonicalQuery> _canonicalQuery;
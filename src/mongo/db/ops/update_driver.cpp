@@ -141,6 +141,40 @@ namespace mongo {
         return Status::OK();
     }
 
+    bool UpdateDriver::rebind(const BSONObj& updateExpr) {
+        // Object replacement mods copy the whole object at init() time; there is nothing
+        // to be saved by rebinding them.
+        if (_replacementMode)
+            return false;
+
+        // Pair up each mod, in order, with the corresponding element of 'updateExpr'.
+        // The caller guarantees the two expressions have the same shape, but each mod
+        // still verifies its own field name and the validity of its new argument.
+        size_t which = 0;
+        BSONObjIterator outerIter(updateExpr);
+        while (outerIter.more()) {
+            BSONElement outerModElem = outerIter.next();
+            if (outerModElem.type() != Object)
+                return false;
+
+            BSONObjIterator innerIter(outerModElem.embeddedObject());
+            while (innerIter.more()) {
+                BSONElement innerModElem = innerIter.next();
+                if (which == _mods.size() || !_mods[which]->rebind(innerModElem))
+                    return false;
+                which++;
+            }
+        }
+        if (which != _mods.size())
+            return false;
+
+        // The next execution registers its own collection's index keys.
+        _indexedFields = NULL;
+        _affectIndices = false;
+
+        return true;
+    }
+
     inline Status UpdateDriver::addAndParse(const modifiertable::ModifierType type,
                                             const BSONElement& elem) {
         if (elem.eoo()) {
@@ -281,10 +315,10 @@ namespace mongo {
                                                 << "' at the same time");
                 }
 
-                // We start with the expectation that a mod will be in-place. But if the mod
-                // touched an indexed field and the mod will indeed be executed -- that is, it
-                // is not a no-op and it is in a valid context -- then we switch back to a
-                // non-in-place mode.
+                // Keep track of whether a mod touched an indexed field and will indeed be
+                // executed -- that is, it is not a no-op and it is in a valid context.  The
+                // mod may still be applied in place; the caller is responsible for bringing
+                // the affected indexes up to date when writing out such an update.
                 //
                 // TODO: make mightBeIndexed and fieldRef like each other.
                 if (!_affectIndices &&
@@ -292,7 +326,6 @@ namespace mongo {
                     _indexedFields &&
                     _indexedFields->mightBeIndexed(execInfo.fieldRef[i]->dottedField())) {
                     _affectIndices = true;
-                    doc->disableInPlaceUpdates();
                 }
             }
 
@@ -57,6 +57,16 @@ namespace mongo {
          */
         Status parse(const BSONObj& updateExpr, const bool multi = false);
 
+        /**
+         * Re-targets an already parsed driver at 'updateExpr', which must have the same
+         * shape as the expression this driver was parsed from: the same modifiers naming
+         * the same fields, in the same order.  Returns true if every mod accepted its new
+         * argument; the driver may then be reused as if parse() had been called with
+         * 'updateExpr'.  Returns false if any mod does not support rebinding or rejects
+         * its new argument, in which case the driver must be re-parsed before use.
+         */
+        bool rebind(const BSONObj& updateExpr);
+
         /**
          * Fills in document with any fields in the query which are valid.
          *
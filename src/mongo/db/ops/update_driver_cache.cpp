@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/ops/update_driver_cache.h"
+
+#include <boost/thread/tss.hpp>
+
+#include "mongo/bson/util/builder.h"
+
+namespace mongo {
+
+    namespace {
+
+        // One cache per connection thread; updates on a connection execute serially so
+        // the cache needs no locking.
+        boost::thread_specific_ptr<UpdateDriverCache> threadDriverCache;
+
+    }  // namespace
+
+    UpdateDriverCache::Entry::~Entry() {
+        delete driver;
+    }
+
+    UpdateDriverCache::UpdateDriverCache()
+        : _cache(kMaxCachedShapes) {
+    }
+
+    // static
+    UpdateDriverCache* UpdateDriverCache::forThread() {
+        UpdateDriverCache* cache = threadDriverCache.get();
+        if (!cache) {
+            cache = new UpdateDriverCache();
+            threadDriverCache.reset(cache);
+        }
+        return cache;
+    }
+
+    // static
+    bool UpdateDriverCache::computeShape(const BSONObj& updateExpr,
+                                         const ModifierInterface::Options& opts,
+                                         std::string* shapeOut) {
+        // A full object replacement has no shape to speak of.
+        if (updateExpr.isEmpty() || *updateExpr.firstElementFieldName() != '$')
+            return false;
+
+        StringBuilder shape;
+
+        // Parse options affect how mods validate their arguments, so drivers parsed
+        // under different options never share a cache slot.
+        shape << (opts.fromReplication ? 'r' : '-')
+              << (opts.enforceOkForStorage ? 'v' : '-');
+
+        BSONObjIterator outerIter(updateExpr);
+        while (outerIter.more()) {
+            BSONElement outerModElem = outerIter.next();
+            if (outerModElem.type() != Object)
+                return false;
+
+            shape << outerModElem.fieldName() << '(';
+            BSONObjIterator innerIter(outerModElem.embeddedObject());
+            while (innerIter.more()) {
+                shape << innerIter.next().fieldName() << ';';
+            }
+            shape << ')';
+        }
+
+        *shapeOut = shape.str();
+        return true;
+    }
+
+    UpdateDriver* UpdateDriverCache::checkout(const std::string& shape) {
+        Entry* entry;
+        if (!_cache.get(shape, &entry).isOK())
+            return NULL;
+
+        UpdateDriver* driver = entry->driver;
+        entry->driver = NULL;
+        _cache.remove(shape);
+        return driver;
+    }
+
+    void UpdateDriverCache::checkin(const std::string& shape, UpdateDriver* driver) {
+        Entry* entry = new Entry();
+        entry->driver = driver;
+        _cache.add(shape, entry);
+    }
+
+}  // namespace mongo
@@ -0,0 +1,107 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/ops/modifier_interface.h"
+#include "mongo/db/ops/update_driver.h"
+#include "mongo/db/query/lru_key_value.h"
+
+namespace mongo {
+
+    /**
+     * A cache of parsed UpdateDrivers keyed by update expression shape, mirroring the
+     * query PlanCache: workloads issuing the same modifiers over the same fields with
+     * different values (e.g. a stream of {$set: {a: <x>}, $inc: {b: <n>}}) skip
+     * re-parsing the modifier object on every update.
+     *
+     * A cached driver is re-targeted at the new expression's values via
+     * UpdateDriver::rebind() before being handed out; shapes whose mods do not support
+     * rebinding simply miss.
+     *
+     * Each cache instance belongs to a single thread (see forThread()) so no locking is
+     * required, and a checked-out driver is never shared.
+     */
+    class UpdateDriverCache {
+        MONGO_DISALLOW_COPYING(UpdateDriverCache);
+    public:
+
+        // Number of distinct update shapes a single cache keeps before evicting the
+        // least recently used one.
+        static const size_t kMaxCachedShapes = 100;
+
+        UpdateDriverCache();
+
+        /**
+         * Returns this thread's cache instance, creating it on first use.
+         */
+        static UpdateDriverCache* forThread();
+
+        /**
+         * Computes the cache key describing the shape of 'updateExpr' under parse
+         * options 'opts' -- the modifiers it uses, the fields they name, and the
+         * options -- and fills in 'shapeOut'.  Returns false, leaving 'shapeOut'
+         * unspecified, if the expression is not cacheable (e.g. a full object
+         * replacement).
+         */
+        static bool computeShape(const BSONObj& updateExpr,
+                                 const ModifierInterface::Options& opts,
+                                 std::string* shapeOut);
+
+        /**
+         * Returns the cached driver for 'shape', transferring ownership to the caller,
+         * or NULL if none is available.  The caller must rebind() the driver before use
+         * and hand it back with checkin() when done with it.
+         */
+        UpdateDriver* checkout(const std::string& shape);
+
+        /**
+         * Takes ownership of 'driver', a successfully parsed (or rebound) driver for
+         * 'shape', making it available to the next checkout.  Evicts the least recently
+         * used shape if the cache is full.
+         */
+        void checkin(const std::string& shape, UpdateDriver* driver);
+
+    private:
+        // A cache slot owning the parsed driver for one shape.  Checking a driver out
+        // removes its slot; checking it back in creates a fresh one.
+        struct Entry {
+            Entry() : driver(NULL) { }
+            ~Entry();
+
+            UpdateDriver* driver;
+        };
+
+        LRUKeyValue<std::string, Entry> _cache;
+    };
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/ops/update_driver_cache.h"
+
+#include <string>
+
+#include "mongo/db/json.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace {
+
+    using mongo::BSONObj;
+    using mongo::ModifierInterface;
+    using mongo::UpdateDriver;
+    using mongo::UpdateDriverCache;
+    using mongo::fromjson;
+    using mongoutils::str::stream;
+    using std::string;
+
+    TEST(ComputeShape, SameShapeDifferentValues) {
+        const ModifierInterface::Options opts = ModifierInterface::Options::normal();
+
+        string shapeA;
+        string shapeB;
+        ASSERT_TRUE(UpdateDriverCache::computeShape(fromjson("{$set:{a:1}, $inc:{b:1}}"),
+                                                    opts,
+                                                    &shapeA));
+        ASSERT_TRUE(UpdateDriverCache::computeShape(fromjson("{$set:{a:'x'}, $inc:{b:42}}"),
+                                                    opts,
+                                                    &shapeB));
+        ASSERT_EQUALS(shapeA, shapeB);
+    }
+
+    TEST(ComputeShape, DifferentFieldsDiffer) {
+        const ModifierInterface::Options opts = ModifierInterface::Options::normal();
+
+        string shapeA;
+        string shapeB;
+        ASSERT_TRUE(UpdateDriverCache::computeShape(fromjson("{$set:{a:1}}"), opts, &shapeA));
+        ASSERT_TRUE(UpdateDriverCache::computeShape(fromjson("{$set:{b:1}}"), opts, &shapeB));
+        ASSERT_NOT_EQUALS(shapeA, shapeB);
+    }
+
+    TEST(ComputeShape, DifferentOperatorsDiffer) {
+        const ModifierInterface::Options opts = ModifierInterface::Options::normal();
+
+        string shapeA;
+        string shapeB;
+        ASSERT_TRUE(UpdateDriverCache::computeShape(fromjson("{$set:{a:1}}"), opts, &shapeA));
+        ASSERT_TRUE(UpdateDriverCache::computeShape(fromjson("{$inc:{a:1}}"), opts, &shapeB));
+        ASSERT_NOT_EQUALS(shapeA, shapeB);
+    }
+
+    TEST(ComputeShape, DifferentOptionsDiffer) {
+        string shapeA;
+        string shapeB;
+        ASSERT_TRUE(UpdateDriverCache::computeShape(fromjson("{$set:{a:1}}"),
+                                                    ModifierInterface::Options::normal(),
+                                                    &shapeA));
+        ASSERT_TRUE(UpdateDriverCache::computeShape(fromjson("{$set:{a:1}}"),
+                                                    ModifierInterface::Options::fromRepl(),
+                                                    &shapeB));
+        ASSERT_NOT_EQUALS(shapeA, shapeB);
+    }
+
+    TEST(ComputeShape, ObjectReplacementNotCacheable) {
+        const ModifierInterface::Options opts = ModifierInterface::Options::normal();
+
+        string shape;
+        ASSERT_FALSE(UpdateDriverCache::computeShape(fromjson("{a:1}"), opts, &shape));
+        ASSERT_FALSE(UpdateDriverCache::computeShape(BSONObj(), opts, &shape));
+    }
+
+    TEST(Cache, CheckoutMissReturnsNull) {
+        UpdateDriverCache cache;
+        ASSERT(NULL == cache.checkout("no such shape"));
+    }
+
+    TEST(Cache, CheckinThenCheckout) {
+        UpdateDriverCache cache;
+
+        UpdateDriver* driver = new UpdateDriver(UpdateDriver::Options());
+        ASSERT_OK(driver->parse(fromjson("{$set:{a:1}}")));
+        cache.checkin("shape", driver);
+
+        // The same driver comes back, and only once.
+        ASSERT_EQUALS(driver, cache.checkout("shape"));
+        ASSERT(NULL == cache.checkout("shape"));
+
+        delete driver;
+    }
+
+    TEST(Cache, LeastRecentlyUsedShapeEvicted) {
+        UpdateDriverCache cache;
+
+        for (size_t i = 0; i < UpdateDriverCache::kMaxCachedShapes + 1; i++) {
+            UpdateDriver* driver = new UpdateDriver(UpdateDriver::Options());
+            ASSERT_OK(driver->parse(fromjson("{$set:{a:1}}")));
+            cache.checkin(stream() << "shape " << i, driver);
+        }
+
+        // The first shape checked in has been evicted; the most recent survives.
+        ASSERT(NULL == cache.checkout("shape 0"));
+        UpdateDriver* survivor =
+            cache.checkout(stream() << "shape " << UpdateDriverCache::kMaxCachedShapes);
+        ASSERT(NULL != survivor);
+        delete survivor;
+    }
+
+    TEST(Cache, ForThreadReturnsSameInstance) {
+        ASSERT_EQUALS(UpdateDriverCache::forThread(), UpdateDriverCache::forThread());
+    }
+
+}  // namespace
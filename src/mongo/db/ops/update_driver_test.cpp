@@ -104,6 +104,77 @@ namespace {
         ASSERT_NOT_OK(driver.parse(fromjson("{$set:[{a:1}]}")));
     }
 
+    TEST(Rebind, NewValuesApplied) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$set:{a:1}, $inc:{b:1}}")));
+
+        BSONObj newExpr = fromjson("{$set:{a:10}, $inc:{b:5}}");
+        ASSERT_TRUE(driver.rebind(newExpr));
+
+        Document doc(fromjson("{a:0, b:1}"));
+        ASSERT_OK(driver.update(StringData(), &doc));
+        ASSERT_EQUALS(fromjson("{a:10, b:6}"), doc);
+    }
+
+    TEST(Rebind, DifferentFieldRefused) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$set:{a:1}}")));
+
+        BSONObj newExpr = fromjson("{$set:{b:1}}");
+        ASSERT_FALSE(driver.rebind(newExpr));
+    }
+
+    TEST(Rebind, MismatchedModCountRefused) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$set:{a:1, b:1}}")));
+
+        BSONObj fewer = fromjson("{$set:{a:2}}");
+        ASSERT_FALSE(driver.rebind(fewer));
+
+        ASSERT_OK(driver.parse(fromjson("{$set:{a:1}}")));
+        BSONObj more = fromjson("{$set:{a:2, b:2}}");
+        ASSERT_FALSE(driver.rebind(more));
+    }
+
+    TEST(Rebind, ObjectReplacementRefused) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{obj: \"obj replacement\"}")));
+
+        BSONObj newExpr = fromjson("{obj: \"different replacement\"}");
+        ASSERT_FALSE(driver.rebind(newExpr));
+    }
+
+    TEST(Rebind, PositionalRefused) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$set:{'a.$':1}}")));
+
+        BSONObj newExpr = fromjson("{$set:{'a.$':2}}");
+        ASSERT_FALSE(driver.rebind(newExpr));
+    }
+
+    TEST(Rebind, UnsupportedModRefused) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$unset:{a:1}}")));
+
+        BSONObj newExpr = fromjson("{$unset:{a:1}}");
+        ASSERT_FALSE(driver.rebind(newExpr));
+    }
+
+    TEST(Rebind, NonNumericIncArgumentRefused) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$inc:{a:1}}")));
+
+        BSONObj newExpr = fromjson("{$inc:{a:'not a number'}}");
+        ASSERT_FALSE(driver.rebind(newExpr));
+    }
+
     TEST(Parse, ModsWithLaterObjReplacement)  {
         UpdateDriver::Options opts;
         UpdateDriver driver(opts);
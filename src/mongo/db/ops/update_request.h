@@ -43,6 +43,18 @@ namespace mongo {
 
     class UpdateRequest {
     public:
+
+        enum ReturnDocOption {
+            // Return no document.
+            RETURN_NONE,
+
+            // Return the document as it was before the update was applied.
+            RETURN_OLD,
+
+            // Return the document as it is after the update has been applied.
+            RETURN_NEW
+        };
+
         inline UpdateRequest(const NamespaceString& nsString)
             : _nsString(nsString)
             , _god(false)
@@ -53,6 +65,7 @@ namespace mongo {
             , _fromReplication(false)
             , _lifecycle(NULL)
             , _isExplain(false)
+            , _returnDocs(RETURN_NONE)
             , _yieldPolicy(PlanExecutor::YIELD_MANUAL) {}
 
         const NamespaceString& getNamespaceString() const {
@@ -67,6 +80,14 @@ namespace mongo {
             return _query;
         }
 
+        inline void setSort(const BSONObj& sort) {
+            _sort = sort;
+        }
+
+        inline const BSONObj& getSort() const {
+            return _sort;
+        }
+
         inline void setUpdates(const BSONObj& updates) {
             _updates = updates;
         }
@@ -142,6 +163,22 @@ namespace mongo {
             return _isExplain;
         }
 
+        inline void setReturnDocs(ReturnDocOption value) {
+            _returnDocs = value;
+        }
+
+        inline bool shouldReturnOldDocs() const {
+            return _returnDocs == RETURN_OLD;
+        }
+
+        inline bool shouldReturnNewDocs() const {
+            return _returnDocs == RETURN_NEW;
+        }
+
+        inline bool shouldReturnAnyDocs() const {
+            return _returnDocs != RETURN_NONE;
+        }
+
         inline void setYieldPolicy(PlanExecutor::YieldPolicy yieldPolicy) {
             _yieldPolicy = yieldPolicy;
         }
@@ -153,6 +190,7 @@ namespace mongo {
         const std::string toString() const {
             return str::stream()
                         << " query: " << _query
+                        << " sort: " << _sort
                         << " updated: " << _updates
                         << " god: " << _god
                         << " upsert: " << _upsert
@@ -169,6 +207,10 @@ namespace mongo {
         // Contains the query that selects documents to update.
         BSONObj _query;
 
+        // Determines which of several matching documents a single-document update applies to.
+        // Only meaningful when '_multi' is false.
+        BSONObj _sort;
+
         // Contains the modifiers to apply to matched objects, or a replacement document.
         BSONObj _updates;
 
@@ -199,6 +241,10 @@ namespace mongo {
         // Whether or not we are requesting an explained update. Explained updates are read-only.
         bool _isExplain;
 
+        // Whether the update stage should produce the old or new version of each updated
+        // document as an execution result (findAndModify), or none at all (plain updates).
+        ReturnDocOption _returnDocs;
+
         // Whether or not the update should yield. Defaults to YIELD_MANUAL.
         PlanExecutor::YieldPolicy _yieldPolicy;
 
@@ -47,6 +47,13 @@ namespace {
 
     void AccumulatorAvg::processInternal(const Value& input, bool merging) {
         if (!merging) {
+            // the common case, a homogeneous stream of doubles, skips the numeric() dispatch
+            if (input.getType() == NumberDouble) {
+                _total += input.getDouble();
+                _count += 1;
+                return;
+            }
+
             // non numeric types have no impact on average
             if (!input.numeric())
                 return;
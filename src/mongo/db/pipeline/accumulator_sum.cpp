@@ -39,6 +39,23 @@ namespace mongo {
     using boost::intrusive_ptr;
 
     void AccumulatorSum::processInternal(const Value& input, bool merging) {
+        // Once the total has settled on the input's type the stream is homogeneous so
+        // far, and the value can be accumulated straight out of the Value's storage
+        // without the type-promotion and coercion dispatch below.
+        const BSONType inputType = input.getType();
+        if (inputType == totalType) {
+            if (inputType == NumberDouble) {
+                doubleTotal += input.getDouble();
+                return;
+            }
+            if (inputType == NumberLong || inputType == NumberInt) {
+                const long long v = inputType == NumberInt ? input.getInt() : input.getLong();
+                longTotal += v;
+                doubleTotal += v;
+                return;
+            }
+        }
+
         // do nothing with non numeric types
         if (!input.numeric())
             return;
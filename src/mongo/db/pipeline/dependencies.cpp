@@ -141,8 +141,13 @@ namespace {
     Document documentHelper(const BSONObj& bson, const Document& neededFields) {
         MutableDocument md(neededFields.size());
 
+        // Once every needed field has been found the rest of the object doesn't need to be
+        // decoded at all. Fields are typically a small subset of the document, so this cuts
+        // the scan short rather than hopping over each remaining element's length prefix.
+        size_t remaining = neededFields.size();
+
         BSONObjIterator it(bson);
-        while (it.more()) {
+        while (remaining && it.more()) {
             BSONElement bsonElement (it.next());
             StringData fieldName = bsonElement.fieldNameStringData();
             Value isNeeded = neededFields[fieldName];
@@ -150,6 +155,8 @@ namespace {
             if (isNeeded.missing())
                 continue;
 
+            remaining--;
+
             if (isNeeded.getType() == Bool) {
                 md.addField(fieldName, Value(bsonElement));
                 continue;
@@ -34,11 +34,12 @@
 #include "mongo/db/pipeline/document.h"
 
 #include <boost/functional/hash.hpp>
-#include <boost/scoped_array.hpp>
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_memory.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/value_arena.h"
 
 namespace mongo {
     using namespace mongoutils;
@@ -134,6 +135,7 @@ namespace mongo {
         const bool firstAlloc = !_buffer;
         const bool doingRehash = needRehash();
         const size_t oldCapacity = _bufferEnd - _buffer;
+        const size_t oldAllocated = allocatedBytes();
 
         // make new bucket count big enough
         while (needRehash() || hashTabBuckets() < HASH_TAB_INIT_SIZE)
@@ -147,13 +149,14 @@ namespace mongo {
         uassert(16490, "Tried to make oversized document",
                 capacity <= size_t(BufferMaxSize));
 
-        boost::scoped_array<char> oldBuf(_buffer);
-        _buffer = new char[capacity];
+        char* const oldBuf = _buffer;
+        const bool oldBufOnArena = _bufferOnArena;
+        _buffer = allocBuffer(capacity);
         _bufferEnd = _buffer + capacity - hashTabBytes();
 
         if (!firstAlloc) {
             // This just copies the elements
-            memcpy(_buffer, oldBuf.get(), _usedBytes);
+            memcpy(_buffer, oldBuf, _usedBytes);
 
             if (_numFields >= HASH_TAB_MIN) {
                 // if we were hashing, deal with the hash table
@@ -162,10 +165,30 @@ namespace mongo {
                 }
                 else {
                     // no rehash needed so just slide table down to new position
-                    memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                    memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
                 }
             }
         }
+
+        if (!oldBufOnArena)
+            delete[] oldBuf; // arena buffers are freed in bulk with the arena
+
+        OperationMemoryTracker::chargeCurrent(allocatedBytes() - oldAllocated);
+    }
+
+    char* DocumentStorage::allocBuffer(size_t bytes) {
+        if (ValueArena* arena = ValueArena::current()) {
+            // The buffer has no destructor-needing state of its own (the Values inside
+            // are destroyed by ~DocumentStorage), so it can live on the pipeline's
+            // arena. The DocumentStorage object itself stays refcounted on the heap
+            // because isShared() drives Document's copy-on-write.
+            if (char* buf = static_cast<char*>(arena->allocate(bytes))) {
+                _bufferOnArena = true;
+                return buf;
+            }
+        }
+        _bufferOnArena = false;
+        return new char[bytes];
     }
 
     void DocumentStorage::reserveFields(size_t expectedFields) {
@@ -182,8 +205,9 @@ namespace mongo {
         uassert(16491, "Tried to make oversized document",
                 newSize <= size_t(BufferMaxSize));
 
-        _buffer = new char[newSize + hashTabBytes()];
+        _buffer = allocBuffer(newSize + hashTabBytes());
         _bufferEnd = _buffer + newSize;
+        OperationMemoryTracker::chargeCurrent(allocatedBytes());
     }
 
     intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
@@ -192,7 +216,7 @@ namespace mongo {
         // Make a copy of the buffer.
         // It is very important that the positions of each field are the same after cloning.
         const size_t bufferBytes = (_bufferEnd + hashTabBytes()) - _buffer;
-        out->_buffer = new char[bufferBytes];
+        out->_buffer = out->allocBuffer(bufferBytes);
         out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
         memcpy(out->_buffer, _buffer, bufferBytes);
 
@@ -203,6 +227,8 @@ namespace mongo {
         out->_hasTextScore = _hasTextScore;
         out->_textScore = _textScore;
 
+        OperationMemoryTracker::chargeCurrent(out->allocatedBytes());
+
         // Tell values that they have been memcpyed (updates ref counts)
         for (DocumentStorageIterator it = out->iteratorAll(); !it.atEnd(); it.advance()) {
             it->val.memcpyed();
@@ -212,11 +238,15 @@ namespace mongo {
     }
 
     DocumentStorage::~DocumentStorage() {
-        boost::scoped_array<char> deleteBufferAtScopeEnd (_buffer);
-
         for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
             it->val.~Value(); // explicit destructor call
         }
+
+        if (_buffer)
+            OperationMemoryTracker::releaseCurrent(allocatedBytes());
+
+        if (!_bufferOnArena)
+            delete[] _buffer; // arena buffers are freed in bulk with the arena
     }
 
     Document::Document(const BSONObj& bson) {
@@ -169,6 +169,7 @@ namespace mongo {
                           , _usedBytes(0)
                           , _numFields(0)
                           , _hashTabMask(0)
+                          , _bufferOnArena(false)
                           , _hasTextScore(false)
                           , _textScore(0)
         {}
@@ -267,6 +268,13 @@ namespace mongo {
         /// Allocates space in _buffer. Copies existing data if there is any.
         void alloc(unsigned newSize);
 
+        /** Returns bytes of storage for _buffer, from the current thread's ValueArena
+         *  if one is installed and has budget, otherwise from the heap. Sets
+         *  _bufferOnArena accordingly so the destructor and alloc() know whether to
+         *  delete[] the buffer.
+         */
+        char* allocBuffer(size_t bytes);
+
         /// Call after adding field to _buffer and increasing _numFields
         void addFieldToHashTable(Position pos);
 
@@ -328,6 +336,8 @@ namespace mongo {
         unsigned _numFields; // this includes removed fields
         unsigned _hashTabMask; // equal to hashTabBuckets()-1 but used more often
 
+        bool _bufferOnArena; // true if _buffer came from a ValueArena (never delete[]ed)
+
         bool _hasTextScore; // When adding more metadata fields, this should become a bitvector
         double _textScore;
         // When adding a field, make sure to update clone() method
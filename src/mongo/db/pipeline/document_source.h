@@ -37,6 +37,8 @@
 #include <boost/intrusive_ptr.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/unordered_map.hpp>
 #include <deque>
 
@@ -106,6 +108,14 @@ namespace mongo {
          */
         virtual void setSource(DocumentSource *pSource);
 
+        /**
+         * Re-points this stage at a different source, which unlike setSource() is
+         * permitted after stitching. Only used by Pipeline::runOnWorkerThread() to
+         * splice a DocumentSourceAsyncQueue in front of this stage (and to undo the
+         * splice afterwards); it deliberately skips any subclass setSource() checks.
+         */
+        void replaceSource(DocumentSource* newSource) { pSource = newSource; }
+
         /**
           Attempt to coalesce this DocumentSource with its successor in the
           document processing pipeline.  If successful, the successor
@@ -250,6 +260,72 @@ namespace mongo {
     };
 
 
+    /**
+     * A bounded queue of document batches used to hand documents from one pipeline
+     * segment to another running on a different thread. Never part of a user-visible
+     * pipeline; Pipeline::run() inserts one between the initial source and the rest of
+     * the stages when executing the CPU-heavy segment on a background worker.
+     *
+     * The producing thread feeds it with pushDocument()/finishProducing() while the
+     * consuming thread drains it through the normal getNext() interface. Either side
+     * may shut the queue down early: a disposed consumer makes pushDocument() return
+     * false, and a failed producer makes getNext() throw on the consumer thread.
+     */
+    class DocumentSourceAsyncQueue :
+        public DocumentSource {
+    public:
+        // virtuals from DocumentSource
+        virtual boost::optional<Document> getNext();
+        virtual const char *getSourceName() const;
+        virtual void setSource(DocumentSource *pSource);
+        virtual void dispose();
+        virtual Value serialize(bool explain = false) const;
+        virtual bool isValidInitialSource() const { return true; }
+
+        static boost::intrusive_ptr<DocumentSourceAsyncQueue> create(
+            const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+        /**
+         * Queues a document for the consumer, blocking while the queue is full.
+         * Returns false if the consumer has been disposed and no more input is
+         * wanted; the producer should stop pumping and call finishProducing().
+         */
+        bool pushDocument(const Document& doc);
+
+        /// Flushes any partial batch and signals EOF to the consumer.
+        void finishProducing();
+
+        /**
+         * Signals that the producer failed; the consumer's next getNext() throws so
+         * the worker unwinds. The producer's own exception carries the real error.
+         */
+        void abortProducing();
+
+    private:
+        DocumentSourceAsyncQueue(const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+        static const size_t kBatchDocs = 64; // documents handed over per queue entry
+        static const size_t kMaxQueuedBatches = 16;
+
+        typedef std::vector<Document> Batch;
+
+        boost::mutex _mutex;
+        boost::condition _hasRoom; // signaled when the producer may push again
+        boost::condition _hasInput; // signaled when the consumer may pop again
+        std::deque<boost::shared_ptr<Batch> > _queue;
+        bool _producerDone;
+        bool _producerFailed;
+        bool _consumerClosed;
+
+        // Only touched by the producing thread.
+        Batch _producerBatch;
+
+        // Only touched by the consuming thread.
+        Batch _consumerBatch;
+        size_t _consumerPos;
+    };
+
+
     class DocumentSourceBsonArray :
         public DocumentSource {
     public:
@@ -440,6 +516,18 @@ namespace mongo {
         virtual GetDepsReturn getDependencies(DepsTracker* deps) const;
         virtual void dispose();
         virtual Value serialize(bool explain = false) const;
+        virtual void serializeToArray(std::vector<Value>& array, bool explain = false) const;
+
+        /**
+         * Attempts to absorb an immediately preceding $unwind on unwindPath so that array
+         * elements are fed straight into the accumulators without materializing one document
+         * per element. Succeeds only when every _id and accumulated expression either ignores
+         * the unwound field entirely or reads it (or a subfield) through a top-level field
+         * path that can be rewritten to reference the current element.
+         *
+         * Returns true if the $unwind was absorbed and may be removed from the pipeline.
+         */
+        bool fuseWithUnwind(const std::string& unwindPath);
 
         /**
           Create a new grouping DocumentSource.
@@ -493,10 +581,30 @@ namespace mongo {
     private:
         DocumentSourceGroup(const boost::intrusive_ptr<ExpressionContext> &pExpCtx);
 
-        /// Spill groups map to disk and returns an iterator to the file.
-        boost::shared_ptr<Sorter<Value, Value>::Iterator> spill();
+        /**
+         * Group ids are hashed into this many partitions so that on memory pressure
+         * whole partitions can be spilled while the rest keep aggregating in memory.
+         */
+        static const size_t kNumPartitions = 16;
 
-        // Only used by spill. Would be function-local if that were legal in C++03.
+        /// Which partition a group id belongs to. Stable for the life of the group.
+        size_t partitionOf(const Value& id) const;
+
+        /**
+         * Writes the given partition's groups to a key-sorted run on disk and erases
+         * them from the groups map. A partition may spill several runs; they are
+         * merged together when the partition is output.
+         */
+        void spillPartition(size_t partition);
+
+        /**
+         * Points _sorterIterator at a merge over the runs of the next spilled
+         * partition and primes _firstPartOfNextGroup. Returns false when no spilled
+         * partitions remain.
+         */
+        bool startNextSpilledPartition();
+
+        // Only used by spillPartition. Would be function-local if that were legal in C++03.
         class SpillSTLComparator;
 
         /*
@@ -556,10 +664,23 @@ namespace mongo {
         std::vector<std::string> _idFieldNames; // used when id is a document
         std::vector<boost::intrusive_ptr<Expression> > _idExpressions;
 
-        // only used when !_spilled
+        // only used when a preceding $unwind has been absorbed by fuseWithUnwind()
+        boost::scoped_ptr<FieldPath> _fusedUnwindPath; // array field fed into the accumulators
+        Variables::Id _fusedElementId; // variable holding the current array element
+        Variables::Id _numVariables; // number of variables assigned when parsing this $group
+        // pre-rewrite copies of _idExpressions and vpExpression, kept so serialization and
+        // dependency analysis still describe the original $unwind + $group pair
+        std::vector<boost::intrusive_ptr<Expression> > _unfusedIdExpressions;
+        std::vector<boost::intrusive_ptr<Expression> > _unfusedExpressions;
+
+        // walks the groups that never left memory; when _spilled these are the hot
+        // partitions and are returned before any merging starts
         GroupsMap::iterator groupsIterator;
 
         // only used when _spilled
+        std::vector<std::vector<boost::shared_ptr<Sorter<Value, Value>::Iterator> > >
+            _partitionRuns; // sorted spill runs, per partition
+        size_t _currentPartition; // next partition to merge
         boost::scoped_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
         std::pair<Value, Value> _firstPartOfNextGroup;
         Value _currentId;
@@ -619,6 +740,8 @@ namespace mongo {
     public:
         typedef std::vector<std::pair<ConnectionString, CursorId> > CursorIds;
 
+        virtual ~DocumentSourceMergeCursors();
+
         // virtuals from DocumentSource
         boost::optional<Document> getNext();
         virtual void setSource(DocumentSource *pSource);
@@ -660,6 +783,23 @@ namespace mongo {
         // using list to enable removing arbitrary elements
         typedef std::list<boost::shared_ptr<CursorAndConnection> > Cursors;
 
+        // Bounded buffer filled by the background readers; defined in the .cpp.
+        struct PrefetchBuffer;
+
+        // Background thread draining one remote cursor into the shared PrefetchBuffer so
+        // that a slow shard doesn't stall the merge; defined in the .cpp.
+        class CursorReader;
+
+        // Spawns one CursorReader per cursor. Only used by getNext(), never by getCursors().
+        void startReaders();
+
+        // Asks all CursorReaders to stop and waits for their threads to finish.
+        void stopReaders();
+
+        // Returns the next prefetched document, blocking until one of the readers has
+        // produced something or every cursor is exhausted.
+        boost::optional<Document> nextFromPrefetch();
+
         DocumentSourceMergeCursors(
             const CursorIds& cursorIds,
             const boost::intrusive_ptr<ExpressionContext> &pExpCtx);
@@ -674,6 +814,10 @@ namespace mongo {
         Cursors _cursors;
         Cursors::iterator _currentCursor;
 
+        // Only set while background prefetching is in use.
+        boost::shared_ptr<PrefetchBuffer> _prefetched;
+        std::vector<boost::shared_ptr<CursorReader> > _readers;
+
         bool _unstarted;
     };
 
@@ -867,6 +1011,14 @@ namespace mongo {
         void populate();
         bool populated;
 
+        /** Dedicated $sort + $limit path. Keeps only the best getLimit() documents
+         *  seen so far in a bounded heap with their pre-extracted sort keys, never
+         *  touching the Sorter's spill machinery while the kept documents fit in
+         *  the memory budget. Falls back to the generic sorter (preserving
+         *  external-sort and error behavior) if they outgrow it.
+         */
+        void populateTopK();
+
         SortOptions makeSortOptions() const;
 
         // These are used to merge pre-sorted results from a DocumentSourceMergeCursors or a
@@ -874,6 +1026,7 @@ namespace mongo {
         // not.
         class IteratorFromCursor;
         class IteratorFromBsonArray;
+        class TopKIterator;
         void populateFromCursors(const std::vector<DBClientCursor*>& cursors);
         void populateFromBsonArrays(const std::vector<BSONArray>& arrays);
 
@@ -1045,6 +1198,9 @@ namespace mongo {
 
         static const char unwindName[];
 
+        /// Returns the dotted path of the array field being unwound, without any prefix.
+        std::string getUnwindPath() const { return _unwindPath->getPath(false); }
+
     private:
         DocumentSourceUnwind(const boost::intrusive_ptr<ExpressionContext> &pExpCtx);
 
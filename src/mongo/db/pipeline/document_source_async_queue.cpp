@@ -0,0 +1,144 @@
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#define MONGO_PCH_WHITELISTED
+#include "mongo/platform/basic.h"
+#include "mongo/pch.h"
+#undef MONGO_PCH_WHITELISTED
+
+#include <boost/make_shared.hpp>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/expression_context.h"
+
+namespace mongo {
+
+    using boost::intrusive_ptr;
+
+    DocumentSourceAsyncQueue::DocumentSourceAsyncQueue(
+            const intrusive_ptr<ExpressionContext>& pExpCtx)
+        : DocumentSource(pExpCtx)
+        , _producerDone(false)
+        , _producerFailed(false)
+        , _consumerClosed(false)
+        , _consumerPos(0)
+    {}
+
+    intrusive_ptr<DocumentSourceAsyncQueue> DocumentSourceAsyncQueue::create(
+            const intrusive_ptr<ExpressionContext>& pExpCtx) {
+        return new DocumentSourceAsyncQueue(pExpCtx);
+    }
+
+    const char *DocumentSourceAsyncQueue::getSourceName() const {
+        return "$asyncQueue";
+    }
+
+    void DocumentSourceAsyncQueue::setSource(DocumentSource *pSource) {
+        // The producer feeds this source directly; it never has an upstream stage.
+        verify(false);
+    }
+
+    Value DocumentSourceAsyncQueue::serialize(bool explain) const {
+        // Never serialized: only inserted at execution time, after explain is ruled out.
+        verify(false);
+        return Value();
+    }
+
+    boost::optional<Document> DocumentSourceAsyncQueue::getNext() {
+        if (_consumerPos == _consumerBatch.size()) {
+            boost::mutex::scoped_lock lk(_mutex);
+            while (_queue.empty() && !_producerDone && !_producerFailed) {
+                _hasInput.wait(lk);
+            }
+
+            massert(28617, "aggregation pipeline producer thread failed",
+                    !_producerFailed);
+
+            if (_queue.empty()) // _producerDone, and everything has been consumed
+                return boost::none;
+
+            boost::shared_ptr<Batch> batch = _queue.front();
+            _queue.pop_front();
+            _hasRoom.notify_one();
+
+            _consumerBatch.swap(*batch);
+            _consumerPos = 0;
+        }
+
+        return _consumerBatch[_consumerPos++];
+    }
+
+    void DocumentSourceAsyncQueue::dispose() {
+        // The producer owns the upstream stages, so unlike other sources we must not
+        // propagate dispose() to them from this (the consumer's) thread. Just stop
+        // accepting input; the producer will dispose its own segment.
+        boost::mutex::scoped_lock lk(_mutex);
+        _consumerClosed = true;
+        _queue.clear();
+        _hasRoom.notify_one();
+    }
+
+    bool DocumentSourceAsyncQueue::pushDocument(const Document& doc) {
+        _producerBatch.push_back(doc);
+        if (_producerBatch.size() < kBatchDocs)
+            return true;
+
+        boost::shared_ptr<Batch> batch = boost::make_shared<Batch>();
+        batch->swap(_producerBatch);
+
+        boost::mutex::scoped_lock lk(_mutex);
+        while (_queue.size() >= kMaxQueuedBatches && !_consumerClosed) {
+            _hasRoom.wait(lk);
+        }
+
+        if (_consumerClosed)
+            return false;
+
+        _queue.push_back(batch);
+        _hasInput.notify_one();
+        return true;
+    }
+
+    void DocumentSourceAsyncQueue::finishProducing() {
+        boost::mutex::scoped_lock lk(_mutex);
+        if (!_producerBatch.empty() && !_consumerClosed) {
+            boost::shared_ptr<Batch> batch = boost::make_shared<Batch>();
+            batch->swap(_producerBatch);
+            _queue.push_back(batch);
+        }
+        _producerDone = true;
+        _hasInput.notify_one();
+    }
+
+    void DocumentSourceAsyncQueue::abortProducing() {
+        boost::mutex::scoped_lock lk(_mutex);
+        _producerFailed = true;
+        _hasInput.notify_one();
+    }
+}
@@ -57,69 +57,73 @@ namespace mongo {
         if (!populated)
             populate();
 
-        if (_spilled) {
-            if (!_sorterIterator)
-                return boost::none;
+        // Groups that never spilled are returned straight from memory first.
+        if (groupsIterator != groups.end()) {
+            Document out = makeDocument(groupsIterator->first,
+                                        groupsIterator->second,
+                                        pExpCtx->inShard);
 
-            const size_t numAccumulators = vpAccumulatorFactory.size();
-            for (size_t i=0; i < numAccumulators; i++) {
-                _currentAccumulators[i]->reset(); // prep accumulators for a new group
-            }
+            if (++groupsIterator == groups.end() && !_spilled)
+                dispose();
 
-            _currentId = _firstPartOfNextGroup.first;
-            while (_currentId == _firstPartOfNextGroup.first) {
-                // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
-                // At loop exit, it is the first value to be processed in the next group.
+            return out;
+        }
 
-                switch (numAccumulators) { // mirrors switch in spill()
-                case 0: // no Accumulators so no Values
-                    break;
+        if (!_spilled || !_sorterIterator)
+            return boost::none;
 
-                case 1: // single accumulators serialize as a single Value
-                    _currentAccumulators[0]->process(_firstPartOfNextGroup.second,
+        // Merging the spill runs of one partition at a time.
+        const size_t numAccumulators = vpAccumulatorFactory.size();
+        for (size_t i=0; i < numAccumulators; i++) {
+            _currentAccumulators[i]->reset(); // prep accumulators for a new group
+        }
+
+        _currentId = _firstPartOfNextGroup.first;
+        while (_currentId == _firstPartOfNextGroup.first) {
+            // Inside of this loop, _firstPartOfNextGroup is the current data being processed.
+            // At loop exit, it is the first value to be processed in the next group.
+
+            switch (numAccumulators) { // mirrors switch in spillPartition()
+            case 0: // no Accumulators so no Values
+                break;
+
+            case 1: // single accumulators serialize as a single Value
+                _currentAccumulators[0]->process(_firstPartOfNextGroup.second,
+                                                 /*merging=*/true);
+                break;
+
+            default: { // multiple accumulators serialize as an array
+                const vector<Value>& accumulatorStates =
+                    _firstPartOfNextGroup.second.getArray();
+                for (size_t i=0; i < numAccumulators; i++) {
+                    _currentAccumulators[i]->process(accumulatorStates[i],
                                                      /*merging=*/true);
-                    break;
-
-                default: { // multiple accumulators serialize as an array
-                    const vector<Value>& accumulatorStates =
-                        _firstPartOfNextGroup.second.getArray();
-                    for (size_t i=0; i < numAccumulators; i++) {
-                        _currentAccumulators[i]->process(accumulatorStates[i],
-                                                         /*merging=*/true);
-                    }
-                    break;
-                }
                 }
+                break;
+            }
+            }
 
-                if (!_sorterIterator->more()) {
+            if (!_sorterIterator->more()) {
+                // This partition is exhausted. Equal ids always hash to the same
+                // partition, so the current group can't continue into the next one.
+                _sorterIterator.reset();
+                if (!startNextSpilledPartition())
                     dispose();
-                    break;
-                }
-
-                _firstPartOfNextGroup = _sorterIterator->next();
+                break;
             }
 
-            return makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
-
-        } else {
-            if (groups.empty())
-                return boost::none;
-
-            Document out = makeDocument(groupsIterator->first,
-                                        groupsIterator->second,
-                                        pExpCtx->inShard);
-
-            if (++groupsIterator == groups.end())
-                dispose();
-
-            return out;
+            _firstPartOfNextGroup = _sorterIterator->next();
         }
+
+        return makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
     }
 
     void DocumentSourceGroup::dispose() {
         // free our resources
         GroupsMap().swap(groups);
         _sorterIterator.reset();
+        _partitionRuns.assign(kNumPartitions,
+                              vector<shared_ptr<Sorter<Value, Value>::Iterator> >());
 
         // make us look done
         groupsIterator = groups.end();
@@ -144,17 +148,24 @@ namespace mongo {
     Value DocumentSourceGroup::serialize(bool explain) const {
         MutableDocument insides;
 
+        // When fused with a $unwind, serialize the expressions as originally parsed; the
+        // rewritten forms reference a variable that only exists inside this stage.
+        const vector<intrusive_ptr<Expression> >& idExpressions =
+            _fusedUnwindPath ? _unfusedIdExpressions : _idExpressions;
+        const vector<intrusive_ptr<Expression> >& expressions =
+            _fusedUnwindPath ? _unfusedExpressions : vpExpression;
+
         // add the _id
         if (_idFieldNames.empty()) {
-            invariant(_idExpressions.size() == 1);
-            insides["_id"] = _idExpressions[0]->serialize(explain);
+            invariant(idExpressions.size() == 1);
+            insides["_id"] = idExpressions[0]->serialize(explain);
         }
         else {
             // decomposed document case
-            invariant(_idExpressions.size() == _idFieldNames.size());
+            invariant(idExpressions.size() == _idFieldNames.size());
             MutableDocument md;
-            for (size_t i = 0; i < _idExpressions.size(); i++) {
-                md[_idFieldNames[i]] = _idExpressions[i]->serialize(explain);
+            for (size_t i = 0; i < idExpressions.size(); i++) {
+                md[_idFieldNames[i]] = idExpressions[i]->serialize(explain);
             }
             insides["_id"] = md.freezeToValue();
         }
@@ -164,7 +175,7 @@ namespace mongo {
         for(size_t i = 0; i < n; ++i) {
             intrusive_ptr<Accumulator> accum = vpAccumulatorFactory[i]();
             insides[vFieldName[i]] =
-                Value(DOC(accum->getOpName() << vpExpression[i]->serialize(explain)));
+                Value(DOC(accum->getOpName() << expressions[i]->serialize(explain)));
         }
 
         if (_doingMerge) {
@@ -177,16 +188,36 @@ namespace mongo {
         return Value(DOC(getSourceName() << insides.freeze()));
     }
 
+    void DocumentSourceGroup::serializeToArray(vector<Value>& array, bool explain) const {
+        // Re-emit the absorbed $unwind so the serialized pipeline reparses (and refuses)
+        // correctly, in particular when it is forwarded to the shards.
+        if (_fusedUnwindPath) {
+            array.push_back(
+                Value(DOC(DocumentSourceUnwind::unwindName << _fusedUnwindPath->getPath(true))));
+        }
+
+        array.push_back(serialize(explain));
+    }
+
     DocumentSource::GetDepsReturn DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
+        const vector<intrusive_ptr<Expression> >& idExpressions =
+            _fusedUnwindPath ? _unfusedIdExpressions : _idExpressions;
+        const vector<intrusive_ptr<Expression> >& expressions =
+            _fusedUnwindPath ? _unfusedExpressions : vpExpression;
+
+        // a fused $unwind needs the array field even if no expression references it
+        if (_fusedUnwindPath)
+            deps->fields.insert(_fusedUnwindPath->getPath(false));
+
         // add the _id
-        for (size_t i = 0; i < _idExpressions.size(); i++) {
-            _idExpressions[i]->addDependencies(deps);
+        for (size_t i = 0; i < idExpressions.size(); i++) {
+            idExpressions[i]->addDependencies(deps);
         }
 
         // add the rest
         const size_t n = vFieldName.size();
         for(size_t i = 0; i < n; ++i) {
-            vpExpression[i]->addDependencies(deps);
+            expressions[i]->addDependencies(deps);
         }
 
         return EXHAUSTIVE_ALL;
@@ -206,6 +237,10 @@ namespace mongo {
         , _spilled(false)
         , _extSortAllowed(pExpCtx->extSortAllowed && !pExpCtx->inRouter)
         , _maxMemoryUsageBytes(100*1024*1024)
+        , _fusedElementId(Variables::ROOT_ID)
+        , _numVariables(0)
+        , _partitionRuns(kNumPartitions)
+        , _currentPartition(0)
     {}
 
     void DocumentSourceGroup::addAccumulator(
@@ -339,11 +374,114 @@ namespace mongo {
         uassert(15955, "a group specification must include an _id",
                 !pGroup->_idExpressions.empty());
 
+        pGroup->_numVariables = idGenerator.getIdCount();
         pGroup->_variables.reset(new Variables(idGenerator.getIdCount()));
 
         return pGroup;
     }
 
+    namespace {
+        // Classifies how a top-level $group expression relates to the field being unwound.
+        enum FusedSlotAction {
+            KEEP,     // independent of the unwound field; evaluate against the input document
+            REWRITE,  // top-level path into the unwound field; redirect at the current element
+            REJECT,   // can't prove the unwound field isn't observed some other way
+        };
+
+        FusedSlotAction classifySlotForFusion(Expression* expr, const string& unwindPath) {
+            if (ExpressionFieldPath* fieldPath = dynamic_cast<ExpressionFieldPath*>(expr)) {
+                if (!fieldPath->isRootFieldPath())
+                    return REJECT; // rooted at some other variable; don't try to reason about it
+
+                if (fieldPath->getFieldPath().getPathLength() == 1)
+                    return REJECT; // "$$ROOT" sees the whole document, array included
+
+                const string path = fieldPath->getFieldPath().tail().getPath(false);
+                if (path == unwindPath || str::startsWith(path, unwindPath + '.'))
+                    return REWRITE;
+
+                if (str::startsWith(unwindPath, path + '.'))
+                    return REJECT; // reads a parent of the array, so it sees the whole array
+
+                return KEEP;
+            }
+
+            // Not a plain field path, so fall back to dependency analysis: the expression is
+            // safe to leave alone iff it can't observe the unwound field at all.
+            DepsTracker deps;
+            expr->addDependencies(&deps);
+            if (deps.needWholeDocument)
+                return REJECT;
+
+            for (set<string>::const_iterator it = deps.fields.begin();
+                    it != deps.fields.end(); ++it) {
+                const string& field = *it;
+                if (field == unwindPath
+                        || str::startsWith(field, unwindPath + '.')
+                        || str::startsWith(unwindPath, field + '.')) {
+                    return REJECT;
+                }
+            }
+
+            return KEEP;
+        }
+    }
+
+    bool DocumentSourceGroup::fuseWithUnwind(const string& unwindPath) {
+        invariant(!_fusedUnwindPath); // can absorb at most one $unwind
+
+        vector<FusedSlotAction> idActions;
+        for (size_t i = 0; i < _idExpressions.size(); i++) {
+            idActions.push_back(classifySlotForFusion(_idExpressions[i].get(), unwindPath));
+            if (idActions.back() == REJECT)
+                return false;
+        }
+
+        vector<FusedSlotAction> accumActions;
+        for (size_t i = 0; i < vpExpression.size(); i++) {
+            accumActions.push_back(classifySlotForFusion(vpExpression[i].get(), unwindPath));
+            if (accumActions.back() == REJECT)
+                return false;
+        }
+
+        // All slots check out, so commit to the fusion. Keep the original expressions around
+        // for serialization and dependency analysis.
+        _unfusedIdExpressions = _idExpressions;
+        _unfusedExpressions = vpExpression;
+
+        // Burn through the ids handed out while parsing so the element variable doesn't
+        // collide with one assigned to a $let inside an expression we're keeping.
+        VariablesIdGenerator idGenerator;
+        while (idGenerator.getIdCount() < _numVariables)
+            idGenerator.generateId();
+
+        VariablesParseState vps(&idGenerator);
+        _fusedElementId = vps.defineVariable("unwound");
+
+        for (size_t i = 0; i < _idExpressions.size(); i++) {
+            if (idActions[i] == REWRITE) {
+                const string path =
+                        static_cast<ExpressionFieldPath*>(_idExpressions[i].get())
+                            ->getFieldPath().tail().getPath(false);
+                _idExpressions[i] = ExpressionFieldPath::parse(
+                        "$$unwound" + path.substr(unwindPath.size()), vps);
+            }
+        }
+        for (size_t i = 0; i < vpExpression.size(); i++) {
+            if (accumActions[i] == REWRITE) {
+                const string path =
+                        static_cast<ExpressionFieldPath*>(vpExpression[i].get())
+                            ->getFieldPath().tail().getPath(false);
+                vpExpression[i] = ExpressionFieldPath::parse(
+                        "$$unwound" + path.substr(unwindPath.size()), vps);
+            }
+        }
+
+        _fusedUnwindPath.reset(new FieldPath(unwindPath));
+        _variables.reset(new Variables(idGenerator.getIdCount()));
+        return true;
+    }
+
     namespace {
         class SorterComparator {
         public:
@@ -358,87 +496,137 @@ namespace mongo {
         const size_t numAccumulators = vpAccumulatorFactory.size();
         dassert(numAccumulators == vpExpression.size());
 
-        // pushed to on spill()
-        vector<shared_ptr<Sorter<Value, Value>::Iterator> > sortedFiles;
         int memoryUsageBytes = 0;
+        vector<int> partitionMemory(kNumPartitions, 0);
 
         // This loop consumes all input from pSource and buckets it based on pIdExpression.
         while (boost::optional<Document> input = pSource->getNext()) {
-            if (memoryUsageBytes > _maxMemoryUsageBytes) {
-                uassert(16945, "Exceeded memory limit for $group, but didn't allow external sort."
-                               " Pass allowDiskUse:true to opt in.",
-                        _extSortAllowed);
-                sortedFiles.push_back(spill());
-                memoryUsageBytes = 0;
+            // When fused with a $unwind, each element of the unwound array is fed through
+            // the accumulators in turn, replicating the stream the $unwind would have
+            // produced without cloning a document per element.
+            size_t numElements = 1;
+            Value unwoundArray;
+            if (_fusedUnwindPath) {
+                unwoundArray = input->getNestedField(*_fusedUnwindPath);
+                if (unwoundArray.nullish())
+                    continue; // an absent or null array unwinds to nothing
+
+                uassert(28619, str::stream() << "Value at end of $unwind field path '"
+                        << _fusedUnwindPath->getPath(true) << "' must be an Array, but is a "
+                        << typeName(unwoundArray.getType()),
+                        unwoundArray.getType() == Array);
+
+                numElements = unwoundArray.getArrayLength();
             }
 
             _variables->setRoot(*input);
 
-            /* get the _id value */
-            Value id = computeId(_variables.get());
+            for (size_t elem = 0; elem < numElements; elem++) {
+                if (_fusedUnwindPath)
+                    _variables->setValue(_fusedElementId, unwoundArray[elem]);
+
+                if (memoryUsageBytes > _maxMemoryUsageBytes) {
+                    uassert(16945, "Exceeded memory limit for $group, but didn't allow external sort."
+                                   " Pass allowDiskUse:true to opt in.",
+                            _extSortAllowed);
+
+                    // Spill the heaviest partitions until we are under half the limit; the
+                    // remaining partitions keep aggregating purely in memory.
+                    while (memoryUsageBytes > _maxMemoryUsageBytes / 2) {
+                        const size_t victim = max_element(partitionMemory.begin(),
+                                                          partitionMemory.end())
+                                            - partitionMemory.begin();
+                        spillPartition(victim);
+                        memoryUsageBytes -= partitionMemory[victim];
+                        partitionMemory[victim] = 0;
+                    }
+                }
 
-            /* treat missing values the same as NULL SERVER-4674 */
-            if (id.missing())
-                id = Value(BSONNULL);
+                /* get the _id value */
+                Value id = computeId(_variables.get());
 
-            /*
-              Look for the _id value in the map; if it's not there, add a
-              new entry with a blank accumulator.
-            */
-            const size_t oldSize = groups.size();
-            vector<intrusive_ptr<Accumulator> >& group = groups[id];
-            const bool inserted = groups.size() != oldSize;
+                /* treat missing values the same as NULL SERVER-4674 */
+                if (id.missing())
+                    id = Value(BSONNULL);
 
-            if (inserted) {
-                memoryUsageBytes += id.getApproximateSize();
+                const size_t partition = partitionOf(id);
 
-                // Add the accumulators
-                group.reserve(numAccumulators);
-                for (size_t i = 0; i < numAccumulators; i++) {
-                    group.push_back(vpAccumulatorFactory[i]());
+                /*
+                  Look for the _id value in the map; if it's not there, add a
+                  new entry with a blank accumulator.
+                */
+                const size_t oldSize = groups.size();
+                vector<intrusive_ptr<Accumulator> >& group = groups[id];
+                const bool inserted = groups.size() != oldSize;
+
+                int memoryDelta = 0;
+                if (inserted) {
+                    memoryDelta += id.getApproximateSize();
+
+                    // Add the accumulators
+                    group.reserve(numAccumulators);
+                    for (size_t i = 0; i < numAccumulators; i++) {
+                        group.push_back(vpAccumulatorFactory[i]());
+                    }
+                } else {
+                    for (size_t i = 0; i < numAccumulators; i++) {
+                        // subtract old mem usage. New usage added back after processing.
+                        memoryDelta -= group[i]->memUsageForSorter();
+                    }
                 }
-            } else {
+
+                /* tickle all the accumulators for the group we found */
+                dassert(numAccumulators == group.size());
                 for (size_t i = 0; i < numAccumulators; i++) {
-                    // subtract old mem usage. New usage added back after processing.
-                    memoryUsageBytes -= group[i]->memUsageForSorter();
+                    group[i]->process(vpExpression[i]->evaluate(_variables.get()), _doingMerge);
+                    memoryDelta += group[i]->memUsageForSorter();
                 }
-            }
 
-            /* tickle all the accumulators for the group we found */
-            dassert(numAccumulators == group.size());
-            for (size_t i = 0; i < numAccumulators; i++) {
-                group[i]->process(vpExpression[i]->evaluate(_variables.get()), _doingMerge);
-                memoryUsageBytes += group[i]->memUsageForSorter();
+                memoryUsageBytes += memoryDelta;
+                partitionMemory[partition] += memoryDelta;
+
+                DEV {
+                    // In debug mode, spill every time we have a duplicate id to stress merge logic.
+                    if (!inserted // is a dup
+                            && !pExpCtx->inRouter // can't spill to disk in router
+                            && !_extSortAllowed // don't change behavior when testing external sort
+                            ) {
+                        size_t totalRuns = 0;
+                        for (size_t i = 0; i < kNumPartitions; i++) {
+                            totalRuns += _partitionRuns[i].size();
+                        }
+                        if (totalRuns < 20) { // don't open too many FDs
+                            for (size_t i = 0; i < kNumPartitions; i++) {
+                                spillPartition(i);
+                            }
+                            memoryUsageBytes = 0;
+                            fill(partitionMemory.begin(), partitionMemory.end(), 0);
+                        }
+                    }
+                }
             }
 
             // We are done with the ROOT document so release it.
             _variables->clearRoot();
-
-            DEV {
-                // In debug mode, spill every time we have a duplicate id to stress merge logic.
-                if (!inserted // is a dup
-                        && !pExpCtx->inRouter // can't spill to disk in router
-                        && !_extSortAllowed // don't change behavior when testing external sort
-                        && sortedFiles.size() < 20 // don't open too many FDs
-                        ) {
-                    sortedFiles.push_back(spill());
-                }
-            }
         }
 
         // These blocks do any final steps necessary to prepare to output results.
-        if (!sortedFiles.empty()) {
-            _spilled = true;
-            if (!groups.empty()) {
-                sortedFiles.push_back(spill());
-            }
+        bool anySpilled = false;
+        for (size_t i = 0; i < kNumPartitions; i++) {
+            if (!_partitionRuns[i].empty())
+                anySpilled = true;
+        }
 
-            // We won't be using groups again so free its memory.
-            GroupsMap().swap(groups);
+        if (anySpilled) {
+            _spilled = true;
 
-            _sorterIterator.reset(
-                    Sorter<Value,Value>::Iterator::merge(
-                        sortedFiles, SortOptions(), SorterComparator()));
+            // Flush the in-memory remainder of every spilled partition so its merge
+            // sees all of its data. Partitions that never spilled stay in 'groups' and
+            // are returned straight from memory.
+            for (size_t i = 0; i < kNumPartitions; i++) {
+                if (!_partitionRuns[i].empty())
+                    spillPartition(i);
+            }
 
             // prepare current to accumulate data
             _currentAccumulators.reserve(numAccumulators);
@@ -446,13 +634,13 @@ namespace mongo {
                 _currentAccumulators.push_back(vpAccumulatorFactory[i]());
             }
 
-            verify(_sorterIterator->more()); // we put data in, we should get something out.
-            _firstPartOfNextGroup = _sorterIterator->next();
-        } else {
-            // start the group iterator
-            groupsIterator = groups.begin();
+            _currentPartition = 0;
+            verify(startNextSpilledPartition()); // we put data in, we should get something out.
         }
 
+        // start the group iterator; empty when every partition spilled
+        groupsIterator = groups.begin();
+
         populated = true;
     }
 
@@ -463,13 +651,20 @@ namespace mongo {
         }
     };
 
-    shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
+    size_t DocumentSourceGroup::partitionOf(const Value& id) const {
+        return Value::Hash()(id) % kNumPartitions;
+    }
+
+    void DocumentSourceGroup::spillPartition(size_t partition) {
         vector<const GroupsMap::value_type*> ptrs; // using pointers to speed sorting
-        ptrs.reserve(groups.size());
         for (GroupsMap::const_iterator it=groups.begin(), end=groups.end(); it != end; ++it) {
-            ptrs.push_back(&*it);
+            if (partitionOf(it->first) == partition)
+                ptrs.push_back(&*it);
         }
 
+        if (ptrs.empty())
+            return; // nothing to write, and readers reject empty files
+
         stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator());
 
         SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
@@ -498,9 +693,31 @@ namespace mongo {
             break;
         }
 
-        groups.clear();
+        _partitionRuns[partition].push_back(
+                shared_ptr<Sorter<Value, Value>::Iterator>(writer.done()));
+
+        for (size_t i=0; i < ptrs.size(); i++) {
+            groups.erase(ptrs[i]->first);
+        }
+    }
+
+    bool DocumentSourceGroup::startNextSpilledPartition() {
+        while (_currentPartition < kNumPartitions && _partitionRuns[_currentPartition].empty()) {
+            _currentPartition++;
+        }
+
+        if (_currentPartition == kNumPartitions)
+            return false;
+
+        _sorterIterator.reset(
+                Sorter<Value,Value>::Iterator::merge(
+                    _partitionRuns[_currentPartition], SortOptions(), SorterComparator()));
+        _partitionRuns[_currentPartition].clear(); // the merge owns the files now
+        _currentPartition++;
 
-        return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
+        verify(_sorterIterator->more()); // runs are never empty
+        _firstPartOfNextGroup = _sorterIterator->next();
+        return true;
     }
 
     void DocumentSourceGroup::parseIdExpression(BSONElement groupField,
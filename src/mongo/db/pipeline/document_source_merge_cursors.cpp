@@ -35,10 +35,17 @@
 
 #include <boost/make_shared.hpp>
 
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/background.h"
+
 namespace mongo {
 
     using boost::intrusive_ptr;
 
+    // Maximum number of megabytes of prefetched documents buffered across all remote
+    // cursors of a $mergeCursors stage. <= 0 disables background prefetching.
+    MONGO_EXPORT_SERVER_PARAMETER(mergeCursorsPrefetchMB, int, 16);
+
     const char DocumentSourceMergeCursors::name[] = "$mergeCursors";
 
     const char* DocumentSourceMergeCursors::getSourceName() const {
@@ -93,6 +100,164 @@ namespace mongo {
         return Value(DOC(getSourceName() << Value(cursors)));
     }
 
+    // All CursorReaders of one stage share this bounded buffer. A single buffer (rather
+    // than one per reader) keeps fast shards flowing while a slow one is still waiting on
+    // the network, and gives the merge thread one place to wait for data from anywhere.
+    struct DocumentSourceMergeCursors::PrefetchBuffer {
+        explicit PrefetchBuffer(size_t maxBytes)
+            : maxBytes(maxBytes)
+            , bytes(0)
+            , activeReaders(0)
+            , stopRequested(false)
+            , errorCode(0)
+        {}
+
+        boost::mutex mutex;
+        boost::condition notEmpty; // data arrived, a reader finished, or an error was set
+        boost::condition notFull;  // data was consumed or stop was requested
+
+        std::deque<BSONObj> docs;
+        const size_t maxBytes;
+        size_t bytes;
+        int activeReaders;
+        bool stopRequested;
+
+        // first error reported by a reader; 0 means no error
+        int errorCode;
+        std::string errorMessage;
+    };
+
+    class DocumentSourceMergeCursors::CursorReader : public BackgroundJob {
+    public:
+        CursorReader(const boost::shared_ptr<CursorAndConnection>& cursor,
+                     const boost::shared_ptr<PrefetchBuffer>& buffer)
+            : BackgroundJob(false /* selfDelete */)
+            , _cursor(cursor)
+            , _buffer(buffer)
+        {}
+
+        virtual string name() const { return "MergeCursorsReader"; }
+
+        virtual void run() {
+            PrefetchBuffer& buf = *_buffer;
+            try {
+                while (_cursor->cursor.more()) {
+                    BSONObj next = _cursor->cursor.next();
+
+                    if (next.hasField("$err")) {
+                        const int code =
+                            next.hasField("code") ? next["code"].numberInt() : 17029;
+                        recordError(code, str::stream()
+                                << "Received error in response from "
+                                << _cursor->cursor.originalHost() << ": " << next);
+                        break;
+                    }
+
+                    next = next.getOwned(); // requestMore() will replace the batch buffer
+
+                    boost::unique_lock<boost::mutex> lk(buf.mutex);
+                    while (buf.bytes >= buf.maxBytes && !buf.stopRequested)
+                        buf.notFull.wait(lk);
+                    if (buf.stopRequested)
+                        break;
+
+                    buf.bytes += next.objsize();
+                    buf.docs.push_back(next);
+                    buf.notEmpty.notify_one();
+                }
+            }
+            catch (const DBException& e) {
+                recordError(e.getCode() > 0 ? e.getCode() : 17028,
+                            str::stream() << "error reading response from "
+                                          << _cursor->connection->toString()
+                                          << ": " << e.what());
+            }
+
+            bool drained;
+            {
+                boost::lock_guard<boost::mutex> lk(buf.mutex);
+                drained = !buf.stopRequested && !buf.errorCode;
+                buf.activeReaders--;
+                buf.notEmpty.notify_all();
+            }
+
+            // This thread had exclusive use of the connection, so when the cursor was
+            // cleanly drained the connection can go straight back to the pool.
+            if (drained)
+                _cursor->connection.done();
+        }
+
+    private:
+        void recordError(int code, const std::string& message) {
+            boost::lock_guard<boost::mutex> lk(_buffer->mutex);
+            if (!_buffer->errorCode) {
+                _buffer->errorCode = code;
+                _buffer->errorMessage = message;
+            }
+            _buffer->notEmpty.notify_all();
+        }
+
+        boost::shared_ptr<CursorAndConnection> _cursor;
+        boost::shared_ptr<PrefetchBuffer> _buffer;
+    };
+
+    DocumentSourceMergeCursors::~DocumentSourceMergeCursors() {
+        stopReaders(); // the reader threads reference our cursors and buffer
+    }
+
+    void DocumentSourceMergeCursors::startReaders() {
+        verify(_readers.empty());
+
+        _prefetched.reset(new PrefetchBuffer(size_t(mergeCursorsPrefetchMB) * 1024 * 1024));
+        _prefetched->activeReaders = _cursors.size();
+
+        for (Cursors::const_iterator it = _cursors.begin(); it != _cursors.end(); ++it) {
+            _readers.push_back(boost::make_shared<CursorReader>(*it, _prefetched));
+            _readers.back()->go();
+        }
+    }
+
+    void DocumentSourceMergeCursors::stopReaders() {
+        if (_readers.empty())
+            return;
+
+        {
+            boost::lock_guard<boost::mutex> lk(_prefetched->mutex);
+            _prefetched->stopRequested = true;
+            _prefetched->notFull.notify_all();
+        }
+
+        for (size_t i = 0; i < _readers.size(); i++) {
+            _readers[i]->wait();
+        }
+        _readers.clear();
+    }
+
+    boost::optional<Document> DocumentSourceMergeCursors::nextFromPrefetch() {
+        PrefetchBuffer& buf = *_prefetched;
+        BSONObj next;
+        {
+            boost::unique_lock<boost::mutex> lk(buf.mutex);
+            while (buf.docs.empty() && buf.activeReaders > 0)
+                buf.notEmpty.wait(lk);
+
+            if (buf.docs.empty()) {
+                // Surface any reader error only once the buffered documents are consumed;
+                // the documents before the error are still valid results.
+                if (buf.errorCode)
+                    uasserted(buf.errorCode, buf.errorMessage);
+                return boost::none; // every cursor is exhausted
+            }
+
+            next = buf.docs.front();
+            buf.docs.pop_front();
+            buf.bytes -= next.objsize();
+            buf.notFull.notify_one();
+        }
+
+        return Document::fromBsonWithMetaData(next);
+    }
+
     DocumentSourceMergeCursors::CursorAndConnection::CursorAndConnection(
             ConnectionString host,
             NamespaceString ns,
@@ -150,9 +315,18 @@ namespace mongo {
     }
 
     boost::optional<Document> DocumentSourceMergeCursors::getNext() {
-        if (_unstarted)
+        if (_unstarted) {
             start();
 
+            // Drain each remote in its own thread so a slow shard never stalls the merge
+            // and the network round trips to different shards overlap.
+            if (mergeCursorsPrefetchMB > 0 && _cursors.size() > 1)
+                startReaders();
+        }
+
+        if (_prefetched)
+            return nextFromPrefetch();
+
         // purge eof cursors and release their connections
         while (!_cursors.empty() && !(*_currentCursor)->cursor.more()) {
             (*_currentCursor)->connection.done();
@@ -173,6 +347,8 @@ namespace mongo {
     }
 
     void DocumentSourceMergeCursors::dispose() {
+        stopReaders();
+        _prefetched.reset();
         _cursors.clear();
         _currentCursor = _cursors.end();
     }
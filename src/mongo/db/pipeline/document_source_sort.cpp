@@ -238,6 +238,8 @@ namespace mongo {
             } else {
                 msgasserted(17196, "can only mergePresorted from MergeCursors and CommandShards");
             }
+        } else if (limitSrc) {
+            populateTopK();
         } else {
             scoped_ptr<MySorter> sorter (MySorter::make(makeSortOptions(), Comparator(*this)));
             while (boost::optional<Document> next = pSource->getNext()) {
@@ -248,6 +250,100 @@ namespace mongo {
         populated = true;
     }
 
+namespace {
+    /// Adapts an int-returning sorter comparator to an STL bool predicate.
+    template <typename Comp>
+    class IsBetter {
+    public:
+        explicit IsBetter(const Comp& comp) : _comp(comp) {}
+        template <typename Data>
+        bool operator()(const Data& lhs, const Data& rhs) const {
+            return _comp(lhs, rhs) < 0;
+        }
+    private:
+        const Comp& _comp;
+    };
+}
+
+    /// Returns the sorted top-k data set built by populateTopK().
+    class DocumentSourceSort::TopKIterator : public MySorter::Iterator {
+    public:
+        explicit TopKIterator(std::vector<Data>& data) : _pos(0) {
+            _data.swap(data);
+        }
+
+        bool more() { return _pos < _data.size(); }
+        Data next() { return _data[_pos++]; }
+
+    private:
+        std::vector<Data> _data;
+        size_t _pos;
+    };
+
+    void DocumentSourceSort::populateTopK() {
+        const SortOptions opts = makeSortOptions();
+        const size_t limit = opts.limit;
+        const Comparator comp(*this);
+        const IsBetter<Comparator> better(comp);
+
+        vector<MySorter::Data> data;
+        // Preallocate for small limits as the common case; for huge limits the
+        // array itself could be a meaningful fraction of the memory budget.
+        if (sizeof(MySorter::Data) * limit < opts.maxMemoryUsageBytes / 10)
+            data.reserve(limit);
+
+        size_t memUsed = 0;
+        while (boost::optional<Document> next = pSource->getNext()) {
+            MySorter::Data contender(extractKey(*next), *next);
+
+            if (data.size() < limit) {
+                memUsed += contender.first.memUsageForSorter();
+                memUsed += contender.second.memUsageForSorter();
+
+                data.push_back(contender);
+                if (data.size() == limit)
+                    std::make_heap(data.begin(), data.end(), better); // worst at front
+            }
+            else {
+                if (!better(contender, data.front()))
+                    continue; // not good enough
+
+                memUsed += contender.first.memUsageForSorter();
+                memUsed += contender.second.memUsageForSorter();
+                memUsed -= data.front().first.memUsageForSorter();
+                memUsed -= data.front().second.memUsageForSorter();
+
+                std::pop_heap(data.begin(), data.end(), better);
+                data.back() = contender;
+                std::push_heap(data.begin(), data.end(), better);
+            }
+
+            if (memUsed > opts.maxMemoryUsageBytes) {
+                // The kept documents alone outgrew the budget. Hand everything to
+                // the generic sorter, which knows how to spill to disk (or to
+                // produce the usual error when disk use isn't allowed).
+                scoped_ptr<MySorter> sorter (MySorter::make(opts, comp));
+                for (size_t i = 0; i < data.size(); i++) {
+                    sorter->add(data[i].first, data[i].second);
+                }
+                while (boost::optional<Document> rest = pSource->getNext()) {
+                    sorter->add(extractKey(*rest), *rest);
+                }
+                _output.reset(sorter->done());
+                return;
+            }
+        }
+
+        if (data.size() == limit) {
+            std::sort_heap(data.begin(), data.end(), better);
+        }
+        else {
+            std::stable_sort(data.begin(), data.end(), better);
+        }
+
+        _output.reset(new TopKIterator(data));
+    }
+
     class DocumentSourceSort::IteratorFromCursor : public MySorter::Iterator {
     public:
         IteratorFromCursor(DocumentSourceSort* sorter, DBClientCursor* cursor)
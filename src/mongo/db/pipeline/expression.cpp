@@ -437,6 +437,14 @@ namespace {
         }
     }
 
+    intrusive_ptr<Expression> ExpressionAdd::optimize() {
+        intrusive_ptr<Expression> optimized = ExpressionNary::optimize();
+        if (optimized.get() != this)
+            return optimized; // folded to a constant
+
+        return ExpressionCompiled::tryCompile(this);
+    }
+
     REGISTER_EXPRESSION("$add", ExpressionAdd::parse);
     const char *ExpressionAdd::getOpName() const {
         return "$add";
@@ -688,6 +696,298 @@ namespace {
         return cmpLookup[cmpOp].name;
     }
 
+    intrusive_ptr<Expression> ExpressionCompare::optimize() {
+        intrusive_ptr<Expression> optimized = ExpressionNary::optimize();
+        if (optimized.get() != this)
+            return optimized; // folded to a constant
+
+        return ExpressionCompiled::tryCompile(this);
+    }
+
+    /* ------------------------ ExpressionCompiled ---------------------------- */
+
+    ExpressionCompiled::ExpressionCompiled(const intrusive_ptr<Expression>& original)
+        : _original(original)
+        , _yieldsComparison(false)
+        , _depth(0)
+        , _maxDepth(0)
+    {}
+
+    intrusive_ptr<Expression> ExpressionCompiled::tryCompile(
+            const intrusive_ptr<Expression>& expr) {
+        intrusive_ptr<ExpressionCompiled> compiled(new ExpressionCompiled(expr));
+
+        if (ExpressionCompare* cmp = dynamic_cast<ExpressionCompare*>(expr.get())) {
+            // A comparison can only be the root of a program since its result isn't
+            // numeric.
+            if (!compiled->emit(cmp->vpOperand[0].get())
+                    || !compiled->emit(cmp->vpOperand[1].get()))
+                return expr;
+
+            Instruction ins = { COMPARE, cmp->cmpOp };
+            compiled->_program.push_back(ins);
+            compiled->_yieldsComparison = true;
+        }
+        else if (!compiled->emit(expr.get())) {
+            return expr;
+        }
+
+        // A lone leaf isn't worth a program.
+        if (compiled->_program.size() < 2)
+            return expr;
+
+        return compiled;
+    }
+
+    bool ExpressionCompiled::emit(Expression* expr) {
+        if (ExpressionConstant* constant = dynamic_cast<ExpressionConstant*>(expr)) {
+            const Value value = constant->getValue();
+            if (!value.numeric())
+                return false;
+
+            Num num;
+            num.type = value.getType();
+            num.longVal = value.coerceToLong();
+            num.doubleVal = value.coerceToDouble();
+
+            Instruction ins = { PUSH_CONSTANT, int(_constants.size()) };
+            _constants.push_back(num);
+            _program.push_back(ins);
+
+            if (++_depth > kMaxStackDepth)
+                return false;
+            _maxDepth = std::max(_maxDepth, _depth);
+            return true;
+        }
+
+        if (dynamic_cast<ExpressionFieldPath*>(expr)) {
+            Instruction ins = { PUSH_LEAF, int(_leaves.size()) };
+            _leaves.push_back(expr);
+            _program.push_back(ins);
+
+            if (++_depth > kMaxStackDepth)
+                return false;
+            _maxDepth = std::max(_maxDepth, _depth);
+            return true;
+        }
+
+        if (ExpressionCompiled* inner = dynamic_cast<ExpressionCompiled*>(expr)) {
+            // An already-compiled operand (optimize() runs bottom-up) gets its
+            // program spliced in rather than being evaluated through a Value.
+            if (inner->_yieldsComparison)
+                return false;
+            if (_depth + inner->_maxDepth > kMaxStackDepth)
+                return false;
+
+            inlineProgram(*inner);
+            _maxDepth = std::max(_maxDepth, _depth + inner->_maxDepth);
+            _depth++; // the net effect of a whole program is one pushed value
+            return true;
+        }
+
+        if (ExpressionAdd* add = dynamic_cast<ExpressionAdd*>(expr)) {
+            const size_t n = add->vpOperand.size();
+            for (size_t i = 0; i < n; ++i) {
+                if (!emit(add->vpOperand[i].get()))
+                    return false;
+            }
+            Instruction ins = { ADD, int(n) };
+            _program.push_back(ins);
+            _depth -= int(n) - 1;
+            return true;
+        }
+
+        if (ExpressionMultiply* multiply = dynamic_cast<ExpressionMultiply*>(expr)) {
+            const size_t n = multiply->vpOperand.size();
+            for (size_t i = 0; i < n; ++i) {
+                if (!emit(multiply->vpOperand[i].get()))
+                    return false;
+            }
+            Instruction ins = { MULTIPLY, int(n) };
+            _program.push_back(ins);
+            _depth -= int(n) - 1;
+            return true;
+        }
+
+        if (ExpressionSubtract* subtract = dynamic_cast<ExpressionSubtract*>(expr)) {
+            if (!emit(subtract->vpOperand[0].get()) || !emit(subtract->vpOperand[1].get()))
+                return false;
+            Instruction ins = { SUBTRACT, 0 };
+            _program.push_back(ins);
+            _depth--;
+            return true;
+        }
+
+        if (ExpressionDivide* divide = dynamic_cast<ExpressionDivide*>(expr)) {
+            if (!emit(divide->vpOperand[0].get()) || !emit(divide->vpOperand[1].get()))
+                return false;
+            Instruction ins = { DIVIDE, 0 };
+            _program.push_back(ins);
+            _depth--;
+            return true;
+        }
+
+        return false;
+    }
+
+    void ExpressionCompiled::inlineProgram(const ExpressionCompiled& other) {
+        const int constBase = int(_constants.size());
+        const int leafBase = int(_leaves.size());
+        _constants.insert(_constants.end(), other._constants.begin(), other._constants.end());
+        _leaves.insert(_leaves.end(), other._leaves.begin(), other._leaves.end());
+
+        for (size_t i = 0; i < other._program.size(); ++i) {
+            Instruction ins = other._program[i];
+            if (ins.op == PUSH_CONSTANT)
+                ins.arg += constBase;
+            else if (ins.op == PUSH_LEAF)
+                ins.arg += leafBase;
+            _program.push_back(ins);
+        }
+    }
+
+    ExpressionCompiled::Num ExpressionCompiled::makeNum(BSONType type,
+                                                        long long longVal,
+                                                        double doubleVal) {
+        Num out;
+        if (type == NumberDouble) {
+            out.type = NumberDouble;
+            out.doubleVal = doubleVal;
+            out.longVal = static_cast<long long>(doubleVal); // as Value::coerceToLong()
+            return out;
+        }
+
+        // mirrors Value::createIntOrLong()
+        if (type == NumberInt && static_cast<int>(longVal) != longVal)
+            type = NumberLong;
+
+        out.type = type;
+        out.longVal = longVal;
+        out.doubleVal = static_cast<double>(longVal);
+        return out;
+    }
+
+    Value ExpressionCompiled::boxNum(const Num& num) {
+        switch (num.type) {
+        case NumberInt:
+            return Value(static_cast<int>(num.longVal));
+        case NumberLong:
+            return Value(num.longVal);
+        default:
+            return Value(num.doubleVal);
+        }
+    }
+
+    Value ExpressionCompiled::evaluateInternal(Variables* vars) const {
+        Num stack[kMaxStackDepth];
+        int sp = 0;
+
+        const size_t programSize = _program.size();
+        for (size_t i = 0; i < programSize; ++i) {
+            const Instruction& ins = _program[i];
+            switch (ins.op) {
+            case PUSH_CONSTANT:
+                stack[sp++] = _constants[ins.arg];
+                break;
+
+            case PUSH_LEAF: {
+                const Value val = _leaves[ins.arg]->evaluateInternal(vars);
+                if (!val.numeric()) {
+                    // Nullish values, dates and type errors take the interpreted
+                    // path so behavior matches the original tree exactly.
+                    return _original->evaluateInternal(vars);
+                }
+                Num& num = stack[sp++];
+                num.type = val.getType();
+                num.longVal = val.coerceToLong();
+                num.doubleVal = val.coerceToDouble();
+                break;
+            }
+
+            case ADD: {
+                double doubleTotal = 0;
+                long long longTotal = 0;
+                BSONType totalType = NumberInt;
+                for (int j = sp - ins.arg; j < sp; ++j) {
+                    totalType = Value::getWidestNumeric(totalType, stack[j].type);
+                    doubleTotal += stack[j].doubleVal;
+                    longTotal += stack[j].longVal;
+                }
+                sp -= ins.arg;
+                stack[sp++] = makeNum(totalType, longTotal, doubleTotal);
+                break;
+            }
+
+            case MULTIPLY: {
+                double doubleProduct = 1;
+                long long longProduct = 1;
+                BSONType productType = NumberInt;
+                for (int j = sp - ins.arg; j < sp; ++j) {
+                    productType = Value::getWidestNumeric(productType, stack[j].type);
+                    doubleProduct *= stack[j].doubleVal;
+                    longProduct *= stack[j].longVal;
+                }
+                sp -= ins.arg;
+                stack[sp++] = makeNum(productType, longProduct, doubleProduct);
+                break;
+            }
+
+            case SUBTRACT: {
+                const Num& lhs = stack[sp - 2];
+                const Num& rhs = stack[sp - 1];
+                const BSONType diffType = Value::getWidestNumeric(rhs.type, lhs.type);
+                sp -= 2;
+                if (diffType == NumberDouble)
+                    stack[sp++] = makeNum(NumberDouble, 0, lhs.doubleVal - rhs.doubleVal);
+                else
+                    stack[sp++] = makeNum(diffType, lhs.longVal - rhs.longVal, 0);
+                break;
+            }
+
+            case DIVIDE: {
+                const Num& lhs = stack[sp - 2];
+                const Num& rhs = stack[sp - 1];
+                if (rhs.doubleVal == 0) {
+                    // the interpreted path throws the can't-$divide-by-zero error
+                    return _original->evaluateInternal(vars);
+                }
+                sp -= 2;
+                stack[sp++] = makeNum(NumberDouble, 0, lhs.doubleVal / rhs.doubleVal);
+                break;
+            }
+
+            case COMPARE: {
+                // Always the last instruction, over exactly two operands. Numeric
+                // Value construction doesn't allocate, so boxing here is cheap.
+                int cmp = Value::compare(boxNum(stack[sp - 2]), boxNum(stack[sp - 1]));
+                if (cmp < 0)
+                    cmp = -1;
+                else if (cmp > 0)
+                    cmp = 1;
+
+                if (ins.arg == ExpressionCompare::CMP)
+                    return Value(cmp);
+                return Value(cmpLookup[ins.arg].truthValue[cmp + 1]);
+            }
+            }
+        }
+
+        dassert(sp == 1);
+        return boxNum(stack[0]);
+    }
+
+    intrusive_ptr<Expression> ExpressionCompiled::optimize() {
+        return this; // compiled from an already-optimized subtree
+    }
+
+    void ExpressionCompiled::addDependencies(DepsTracker* deps, vector<string>* path) const {
+        _original->addDependencies(deps, path);
+    }
+
+    Value ExpressionCompiled::serialize(bool explain) const {
+        return _original->serialize(explain);
+    }
+
     /* ------------------------- ExpressionConcat ----------------------------- */
 
     Value ExpressionConcat::evaluateInternal(Variables* vars) const {
@@ -1051,6 +1351,14 @@ namespace {
         }
     }
 
+    intrusive_ptr<Expression> ExpressionDivide::optimize() {
+        intrusive_ptr<Expression> optimized = ExpressionNary::optimize();
+        if (optimized.get() != this)
+            return optimized; // folded to a constant
+
+        return ExpressionCompiled::tryCompile(this);
+    }
+
     REGISTER_EXPRESSION("$divide", ExpressionDivide::parse);
     const char *ExpressionDivide::getOpName() const {
         return "$divide";
@@ -1855,6 +2163,14 @@ namespace {
             massert(16418, "$multiply resulted in a non-numeric type", false);
     }
 
+    intrusive_ptr<Expression> ExpressionMultiply::optimize() {
+        intrusive_ptr<Expression> optimized = ExpressionNary::optimize();
+        if (optimized.get() != this)
+            return optimized; // folded to a constant
+
+        return ExpressionCompiled::tryCompile(this);
+    }
+
     REGISTER_EXPRESSION("$multiply", ExpressionMultiply::parse);
     const char *ExpressionMultiply::getOpName() const {
         return "$multiply";
@@ -2447,6 +2763,14 @@ namespace {
         }
     }
 
+    intrusive_ptr<Expression> ExpressionSubtract::optimize() {
+        intrusive_ptr<Expression> optimized = ExpressionNary::optimize();
+        if (optimized.get() != this)
+            return optimized; // folded to a constant
+
+        return ExpressionCompiled::tryCompile(this);
+    }
+
     REGISTER_EXPRESSION("$subtract", ExpressionSubtract::parse);
     const char *ExpressionSubtract::getOpName() const {
         return "$subtract";
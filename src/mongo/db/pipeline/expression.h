@@ -330,6 +330,8 @@ namespace mongo {
         ExpressionNary() {}
 
         ExpressionVector vpOperand;
+
+        friend class ExpressionCompiled; // flattens arithmetic subtrees at optimize time
     };
 
     /// Inherit from ExpressionVariadic or ExpressionFixedArity instead of directly from this class.
@@ -368,6 +370,7 @@ namespace mongo {
     class ExpressionAdd : public ExpressionVariadic<ExpressionAdd> {
     public:
         // virtuals from Expression
+        virtual boost::intrusive_ptr<Expression> optimize();
         virtual Value evaluateInternal(Variables* vars) const;
         virtual const char *getOpName() const;
         virtual bool isAssociativeAndCommutative() const { return true; }
@@ -436,6 +439,7 @@ namespace mongo {
         };
 
         // virtuals from ExpressionNary
+        virtual boost::intrusive_ptr<Expression> optimize();
         virtual Value evaluateInternal(Variables* vars) const;
         virtual const char *getOpName() const;
 
@@ -447,10 +451,88 @@ namespace mongo {
         ExpressionCompare(CmpOp cmpOp);
 
     private:
+        friend class ExpressionCompiled;
         CmpOp cmpOp;
     };
 
 
+    /** Internal expression that evaluates a flattened arithmetic subtree as a
+     *  postfix program over a stack of unboxed numbers, avoiding the per-node
+     *  virtual dispatch and intermediate Value creation of tree interpretation.
+     *
+     *  Instances are only produced by optimize() on the arithmetic expressions via
+     *  tryCompile(); they are never parsed from user input. Serialization and
+     *  dependency tracking delegate to the original subtree, which is also
+     *  evaluated unchanged whenever an input isn't numeric (nullish values, dates,
+     *  type errors, division by zero) so observable behavior is identical to the
+     *  interpreted tree.
+     */
+    class ExpressionCompiled : public Expression {
+    public:
+        // virtuals from Expression
+        virtual boost::intrusive_ptr<Expression> optimize();
+        virtual void addDependencies(DepsTracker* deps, std::vector<std::string>* path=NULL) const;
+        virtual Value evaluateInternal(Variables* vars) const;
+        virtual Value serialize(bool explain) const;
+
+        /** Compiles expr if it consists of $add/$multiply/$subtract/$divide nodes
+         *  (with an optional comparison at the root) over field path and numeric
+         *  constant leaves. Returns expr itself if any node is unsupported.
+         */
+        static boost::intrusive_ptr<Expression> tryCompile(
+            const boost::intrusive_ptr<Expression>& expr);
+
+    private:
+        explicit ExpressionCompiled(const boost::intrusive_ptr<Expression>& original);
+
+        enum Op {
+            PUSH_CONSTANT, // arg: index into _constants
+            PUSH_LEAF, // arg: index into _leaves
+            ADD, // arg: operand count
+            MULTIPLY, // arg: operand count
+            SUBTRACT,
+            DIVIDE,
+            COMPARE, // arg: ExpressionCompare::CmpOp; only valid as the last instruction
+        };
+
+        struct Instruction {
+            unsigned char op;
+            int arg;
+        };
+
+        /** An unboxed number. Like the $add/$multiply evaluators we carry the value
+         *  as both long long and double in parallel alongside the narrowest type, so
+         *  no Values are created between instructions.
+         */
+        struct Num {
+            BSONType type; // NumberInt, NumberLong or NumberDouble
+            long long longVal;
+            double doubleVal;
+        };
+
+        /** Appends instructions evaluating expr to _program, returning false if expr
+         *  contains anything the program can't represent.
+         */
+        bool emit(Expression* expr);
+
+        /// Appends another compiled expression's program with its indexes rebased.
+        void inlineProgram(const ExpressionCompiled& other);
+
+        static Num makeNum(BSONType type, long long longVal, double doubleVal);
+        static Value boxNum(const Num& num);
+
+        static const int kMaxStackDepth = 64;
+
+        boost::intrusive_ptr<Expression> _original;
+        std::vector<Instruction> _program;
+        std::vector<Num> _constants;
+        std::vector<boost::intrusive_ptr<Expression> > _leaves; // field paths
+        bool _yieldsComparison; // program ends in COMPARE so result isn't a Num
+        int _depth; // only used during emit()
+        int _maxDepth;
+    };
+
+
     class ExpressionConcat : public ExpressionVariadic<ExpressionConcat> {
     public:
         // virtuals from ExpressionNary
@@ -565,6 +647,7 @@ namespace mongo {
     class ExpressionDivide : public ExpressionFixedArity<ExpressionDivide, 2> {
     public:
         // virtuals from ExpressionNary
+        virtual boost::intrusive_ptr<Expression> optimize();
         virtual Value evaluateInternal(Variables* vars) const;
         virtual const char *getOpName() const;
     };
@@ -600,6 +683,9 @@ namespace mongo {
 
         const FieldPath& getFieldPath() const { return _fieldPath; }
 
+        /// True if this path is rooted at ROOT (or CURRENT when it is equivalent to ROOT).
+        bool isRootFieldPath() const { return _variable == Variables::ROOT_ID; }
+
     private:
         ExpressionFieldPath(const std::string& fieldPath, Variables::Id variable);
 
@@ -744,6 +830,7 @@ namespace mongo {
     class ExpressionMultiply : public ExpressionVariadic<ExpressionMultiply> {
     public:
         // virtuals from Expression
+        virtual boost::intrusive_ptr<Expression> optimize();
         virtual Value evaluateInternal(Variables* vars) const;
         virtual const char *getOpName() const;
         virtual bool isAssociativeAndCommutative() const { return true; }
@@ -973,6 +1060,7 @@ namespace mongo {
     class ExpressionSubtract : public ExpressionFixedArity<ExpressionSubtract, 2> {
     public:
         // virtuals from ExpressionNary
+        virtual boost::intrusive_ptr<Expression> optimize();
         virtual Value evaluateInternal(Variables* vars) const;
         virtual const char *getOpName() const;
     };
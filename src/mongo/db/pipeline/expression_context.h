@@ -28,11 +28,14 @@
 
 #pragma once
 
+#include <boost/scoped_ptr.hpp>
 #include <string>
 
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/intrusive_counter.h"
+#include "mongo/util/value_arena.h"
 
 namespace mongo {
 
@@ -44,6 +47,7 @@ namespace mongo {
             , extSortAllowed(false)
             , ns(ns)
             , opCtx(opCtx)
+            , inParallelWorker(false)
             , interruptCounter(interruptCheckPeriod)
         {}
 
@@ -51,13 +55,23 @@ namespace mongo {
          *  @throws if the operation has been interrupted
          */
         void checkForInterrupt() {
+            if (inParallelWorker) {
+                // opCtx is not safe to use concurrently from two threads, so while a
+                // worker thread runs part of the pipeline the thread that owns the
+                // operation checks for interrupts itself and forwards kill requests
+                // through this flag (see Pipeline::runOnWorkerThread()).
+                uassert(28618, "operation was interrupted",
+                        !parallelKillPending.load());
+                return;
+            }
+
             if (opCtx && --interruptCounter == 0) { // XXX SERVER-13931 for opCtx check
                 // The checkForInterrupt could be expensive, at least in relative terms.
                 opCtx->checkForInterrupt();
                 interruptCounter = interruptCheckPeriod;
             }
         }
-        
+
         bool inShard;
         bool inRouter;
         bool extSortAllowed;
@@ -65,6 +79,19 @@ namespace mongo {
         std::string tempDir; // Defaults to empty to prevent external sorting in mongos.
 
         OperationContext* opCtx;
+
+        // True while part of the pipeline is being executed by a background worker
+        // thread; only toggled while no worker is running. See checkForInterrupt().
+        bool inParallelWorker;
+
+        // Set by the operation-owning thread to interrupt a pipeline worker thread.
+        AtomicUInt32 parallelKillPending;
+
+        // Arena for Values created while this pipeline runs, created lazily by
+        // Pipeline::run(). Owned here so it outlives all of the pipeline's stages;
+        // everything allocated from it is freed when this context is destroyed.
+        boost::scoped_ptr<ValueArena> valueArena;
+
         static const int interruptCheckPeriod = 128;
         int interruptCounter; // when 0, check interruptStatus
     };
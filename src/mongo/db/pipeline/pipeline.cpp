@@ -44,12 +44,24 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/background.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
     using boost::intrusive_ptr;
 
+    // When enabled, Pipeline::run() may drain the stages after the initial source on a
+    // background worker thread, overlapping the initial source's reads with the CPU
+    // spent in $match/$project/$group and friends. See canRunSegmentInBackground().
+    MONGO_EXPORT_SERVER_PARAMETER(parallelAggregation, bool, false);
+
+    // Budget, per pipeline, for the arena that bump-allocates Value and Document
+    // storage while the pipeline runs (see util/value_arena.h). Allocations past the
+    // budget fall back to ordinary refcounted heap allocation. 0 disables the arena.
+    MONGO_EXPORT_SERVER_PARAMETER(pipelineValueArenaMB, int, 64);
+
     const char Pipeline::commandName[] = "aggregate";
     const char Pipeline::pipelineName[] = "pipeline";
     const char Pipeline::explainName[] = "explain";
@@ -218,6 +230,7 @@ namespace mongo {
         Optimizations::Local::moveMatchBeforeSort(pPipeline.get());
         Optimizations::Local::moveLimitBeforeSkip(pPipeline.get());
         Optimizations::Local::coalesceAdjacent(pPipeline.get());
+        Optimizations::Local::fuseUnwindWithGroup(pPipeline.get());
         Optimizations::Local::optimizeEachDocumentSource(pPipeline.get());
         Optimizations::Local::duplicateMatchBeforeInitalRedact(pPipeline.get());
 
@@ -302,6 +315,21 @@ namespace mongo {
         }
     }
 
+    void Pipeline::Optimizations::Local::fuseUnwindWithGroup(Pipeline* pipeline) {
+        SourceContainer& sources = pipeline->sources;
+        for (size_t srci = 1; srci < sources.size(); ++srci) {
+            DocumentSourceUnwind* unwind =
+                dynamic_cast<DocumentSourceUnwind*>(sources[srci - 1].get());
+            DocumentSourceGroup* group =
+                dynamic_cast<DocumentSourceGroup*>(sources[srci].get());
+
+            if (unwind && group && group->fuseWithUnwind(unwind->getUnwindPath())) {
+                // The group now consumes the array elements itself.
+                sources.erase(sources.begin() + (srci - 1));
+            }
+        }
+    }
+
     void Pipeline::Optimizations::Local::optimizeEachDocumentSource(Pipeline* pipeline) {
         SourceContainer& sources = pipeline->sources;
         for (SourceContainer::iterator it(sources.begin()); it != sources.end(); ++it) {
@@ -495,10 +523,162 @@ namespace mongo {
         }
     }
 
+    namespace {
+        /**
+         * Drains a pipeline segment on a background thread, building the result array
+         * there so document serialization overlaps with the producer's reads. Failures
+         * are parked in status() and rethrown by the producing thread.
+         */
+        class PipelineWorker : public BackgroundJob {
+        public:
+            PipelineWorker(DocumentSource* finalSource, DocumentSourceAsyncQueue* queue)
+                : BackgroundJob(false /* selfDelete */)
+                , _finalSource(finalSource)
+                , _queue(queue)
+                , _status(Status::OK())
+            {}
+
+            virtual std::string name() const { return "PipelineWorker"; }
+
+            virtual void run() {
+                try {
+                    BSONArrayBuilder resultArray;
+                    while (boost::optional<Document> next = _finalSource->getNext()) {
+                        // add the document to the result set
+                        BSONObjBuilder documentBuilder (resultArray.subobjStart());
+                        next->toBson(&documentBuilder);
+                        documentBuilder.doneFast();
+                        // object will be too large, assert. the extra 1KB is for headers
+                        uassert(16389,
+                                str::stream() << "aggregation result exceeds maximum document"
+                                                 " size ("
+                                              << BSONObjMaxUserSize / (1024 * 1024) << "MB)",
+                                resultArray.len() < BSONObjMaxUserSize - 1024);
+                    }
+                    resultArray.done();
+                    _result = resultArray.arr();
+                }
+                catch (const DBException& e) {
+                    _status = e.toStatus();
+                }
+                catch (const std::exception& e) {
+                    _status = Status(ErrorCodes::InternalError, e.what());
+                }
+
+                if (!_status.isOK()) {
+                    // Release a producer that may be blocked on a full queue.
+                    _queue->dispose();
+                }
+            }
+
+            Status status() const { return _status; }
+            BSONArray result() const { return _result; }
+
+        private:
+            DocumentSource* _finalSource;
+            DocumentSourceAsyncQueue* _queue;
+            Status _status;
+            BSONArray _result;
+        };
+    }
+
+    bool Pipeline::canRunSegmentInBackground() const {
+        // Need an initial source to pump plus at least one stage to hand off.
+        if (sources.size() < 2 || !sources.front()->isValidInitialSource())
+            return false;
+
+        bool cpuHeavy = false;
+        for (size_t i = 1; i < sources.size(); i++) {
+            DocumentSource* source = sources[i].get();
+
+            // Stages that need mongod must run on the thread owning the operation.
+            if (dynamic_cast<DocumentSourceNeedsMongod*>(source))
+                return false;
+
+            cpuHeavy = cpuHeavy
+                || dynamic_cast<DocumentSourceGroup*>(source)
+                || dynamic_cast<DocumentSourceProject*>(source)
+                || dynamic_cast<DocumentSourceMatch*>(source)
+                || dynamic_cast<DocumentSourceRedact*>(source)
+                || dynamic_cast<DocumentSourceSort*>(source);
+        }
+
+        return cpuHeavy;
+    }
+
+    void Pipeline::runOnWorkerThread(BSONObjBuilder& result) {
+        // Splice a queue between the initial source and the rest of the pipeline.
+        intrusive_ptr<DocumentSourceAsyncQueue> queue = DocumentSourceAsyncQueue::create(pCtx);
+        sources[1]->replaceSource(queue.get());
+
+        DocumentSource* input = sources.front().get();
+        PipelineWorker worker(sources.back().get(), queue.get());
+
+        pCtx->inParallelWorker = true; // the worker must not touch opCtx
+        worker.go();
+
+        try {
+            // This thread owns the operation, so it checks for interrupts on behalf of
+            // the worker; ExpressionContext::checkForInterrupt() relays a kill to the
+            // worker through parallelKillPending.
+            int interruptCounter = ExpressionContext::interruptCheckPeriod;
+            while (boost::optional<Document> next = input->getNext()) {
+                if (pCtx->opCtx && --interruptCounter == 0) {
+                    pCtx->opCtx->checkForInterrupt();
+                    interruptCounter = ExpressionContext::interruptCheckPeriod;
+                }
+
+                if (!queue->pushDocument(*next)) {
+                    // The worker stopped early ($limit) or failed; either way no more
+                    // input is wanted. Dispose of our segment from this thread.
+                    input->dispose();
+                    break;
+                }
+            }
+            queue->finishProducing();
+
+            // Stay responsive to killOp while the worker drains the tail of the
+            // pipeline (a large $group does most of its work after the last input).
+            while (!worker.wait(100)) {
+                if (pCtx->opCtx)
+                    pCtx->opCtx->checkForInterrupt();
+            }
+        }
+        catch (...) {
+            pCtx->parallelKillPending.store(1);
+            queue->abortProducing();
+            worker.wait();
+            pCtx->inParallelWorker = false;
+            sources[1]->replaceSource(input);
+            throw;
+        }
+
+        pCtx->inParallelWorker = false;
+        sources[1]->replaceSource(input);
+
+        uassertStatusOK(worker.status());
+        result.appendArray("result", worker.result());
+    }
+
     void Pipeline::run(BSONObjBuilder& result) {
         // should not get here in the explain case
         verify(!explain);
 
+        // Bump-allocate Value/Document storage created on this thread out of a
+        // per-pipeline arena; it is freed wholesale when pCtx goes away. A worker
+        // thread in the parallel case deliberately gets no arena since arenas are
+        // single-threaded.
+        if (pipelineValueArenaMB > 0 && !pCtx->valueArena) {
+            pCtx->valueArena.reset(
+                    new ValueArena(size_t(pipelineValueArenaMB) * 1024 * 1024));
+        }
+        ValueArena::Scope arenaScope(pCtx->valueArena.get());
+
+        if (parallelAggregation && canRunSegmentInBackground()) {
+            runOnWorkerThread(result);
+            return;
+        }
+
         // the array in which the aggregation results reside
         // cant use subArrayStart() due to error handling
         BSONArrayBuilder resultArray;
@@ -174,6 +174,21 @@ namespace mongo {
 
         Pipeline(const boost::intrusive_ptr<ExpressionContext> &pCtx);
 
+        /**
+         * True when the stages after the initial source may be drained by a background
+         * worker thread: none of them needs mongod (and therefore the
+         * OperationContext) and at least one of them is CPU-heavy enough to be worth
+         * decoupling from the initial source's reads.
+         */
+        bool canRunSegmentInBackground() const;
+
+        /**
+         * The parallel flavor of run(): splices a DocumentSourceAsyncQueue between the
+         * initial source and the rest of the pipeline, drains the downstream segment
+         * on a worker thread, and pumps the initial source from this thread.
+         */
+        void runOnWorkerThread(BSONObjBuilder& result);
+
         typedef std::deque<boost::intrusive_ptr<DocumentSource> > SourceContainer;
         SourceContainer sources;
         bool explain;
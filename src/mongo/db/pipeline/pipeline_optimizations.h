@@ -73,6 +73,16 @@ namespace mongo {
          */
         static void coalesceAdjacent(Pipeline* pipeline);
 
+        /**
+         * Fuses each [$unwind, $group] pair into a single $group that feeds the unwound
+         * array elements straight into its accumulators, avoiding the construction of one
+         * intermediate document per array element.
+         *
+         * Only fuses when the $group can prove it touches the unwound field exclusively
+         * through rewritable field paths; see DocumentSourceGroup::fuseWithUnwind().
+         */
+        static void fuseUnwindWithGroup(Pipeline* pipeline);
+
         /**
          * Gives each DocumentSource the opportunity to optimize itself.
          *
@@ -241,17 +241,6 @@ namespace mongo {
         return Value(intValue);
     }
 
-    double Value::getDouble() const {
-        BSONType type = getType();
-        if (type == NumberInt)
-            return _storage.intValue;
-        if (type == NumberLong)
-            return static_cast< double >( _storage.longValue );
-
-        verify(type == NumberDouble);
-        return _storage.doubleValue;
-    }
-
     Document Value::getDocument() const {
         verify(getType() == Object);
         return _storage.getDocument();
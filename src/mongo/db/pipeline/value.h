@@ -365,4 +365,16 @@ namespace mongo {
         verify(type == NumberLong);
         return _storage.longValue;
     }
+
+    // inline so tight numeric loops (eg the accumulators) don't pay a call per value
+    inline double Value::getDouble() const {
+        BSONType type = getType();
+        if (type == NumberInt)
+            return _storage.intValue;
+        if (type == NumberLong)
+            return static_cast< double >( _storage.longValue );
+
+        verify(type == NumberDouble);
+        return _storage.doubleValue;
+    }
 };
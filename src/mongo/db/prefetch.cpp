@@ -36,6 +36,7 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/dbhelpers.h"
+#include "mongo/db/global_environment_experiment.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/bgsync.h"
@@ -43,6 +44,7 @@
 #include "mongo/db/repl/repl_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
+#include "mongo/db/stats/working_set_tracker.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mmap.h"
 
@@ -119,7 +121,7 @@ namespace {
 
     // page in the data pages for a record associated with an object
     void prefetchRecordPages(OperationContext* txn,
-                             Database* db,
+                             Collection* collection,
                              const char* ns,
                              const BSONObj& obj) {
 
@@ -128,9 +130,26 @@ namespace {
             TimerHolder timer(&prefetchDocStats);
             BSONObjBuilder builder;
             builder.append(_id);
-            BSONObj result;
             try {
-                if (Helpers::findById(txn, db, ns, builder.done(), result)) {
+                const RecordId loc = Helpers::findById(txn, collection, builder.done());
+                if (loc.isNull()) {
+                    return;
+                }
+
+                // If the working set tracker saw this record a moment ago, whoever
+                // touched it already pulled it into cache; re-reading it here would just
+                // burn a prefetch thread.
+                if (globalWorkingSetTracker().checkAccessedAndMark(ns, loc)) {
+                    return;
+                }
+
+                // Reading the document is itself the prefetch for engines with a private
+                // cache (e.g. WiredTiger); the read faults the record in.
+                BSONObj result = collection->docFor(txn, loc);
+
+                if (getGlobalEnvironment()->getGlobalStorageEngine()->isMmapV1()) {
+                    // mmapv1 hands back a pointer straight into the mapped file, so the
+                    // read above may not have faulted anything yet.
                     // do we want to use Record::touch() here?  it's pretty similar.
                     volatile char _dummy_char = '\0';
 
@@ -156,6 +175,11 @@ namespace {
         invariant(db);
         const BackgroundSync::IndexPrefetchConfig prefetchConfig =
             BackgroundSync::get()->getIndexPrefetchConfig();
+
+        // "none" is the full off-switch: skip the record prefetch too, not just indexes.
+        if (prefetchConfig == BackgroundSync::PREFETCH_NONE)
+            return;
+
         const char *opField;
         const char *opType = op.getStringField("op");
         switch (*opType) {
@@ -174,9 +198,9 @@ namespace {
         BSONObj obj = op.getObjectField(opField);
         const char *ns = op.getStringField("ns");
 
-        // This will have to change for engines other than MMAP V1, because they might not have
-        // means for directly prefetching pages from the collection. For this purpose, acquire S
-        // lock on the database, instead of optimizing with IS.
+        // Prefetch is plain reads through the collection and index access methods, which
+        // works for any engine, but acquire S rather than IS so we never interleave with
+        // a concurrent catalog change on the collection.
         Lock::CollectionLock collLock(txn->lockState(), ns, MODE_S);
 
         Collection* collection = db->getCollection( ns );
@@ -213,7 +237,7 @@ namespace {
             // do not prefetch the data for capped collections because
             // they typically do not have an _id index for findById() to use.
             !collection->isCapped()) {
-            prefetchRecordPages(txn, db, ns, obj);
+            prefetchRecordPages(txn, collection, ns, obj);
         }
     }
 
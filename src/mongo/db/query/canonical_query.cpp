@@ -33,7 +33,9 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/query/lru_key_value.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/log.h"
 
 
@@ -143,6 +145,7 @@ namespace {
         case MatchExpression::ALWAYS_FALSE: return "af"; break;
         case MatchExpression::GEO_NEAR: return "gn"; break;
         case MatchExpression::TEXT: return "te"; break;
+        case MatchExpression::INTERNAL_WHERE_STRICT_EQ: return "we"; break;
         default: verify(0); return "";
         }
     }
@@ -247,6 +250,123 @@ namespace {
         }
     }
 
+    //
+    // Raw query shape cache
+    //
+    // Queries that differ only in the constants they compare against canonicalize to
+    // trees with identical cache key fragments. For a conservative class of filters we
+    // can recognize this from the unparsed BSON with one cheap walk, and reuse the
+    // fragment computed the first time the shape was seen instead of re-walking the
+    // expression tree for every query.
+    //
+
+    // Number of raw shape patterns we remember.
+    const size_t kShapeCacheSize = 1000;
+
+    // Protects 'shapeCache'.
+    SimpleMutex shapeCacheLock("queryShapeCache");
+
+    // Maps a raw shape pattern to the cache key fragment for the canonicalized tree.
+    LRUKeyValue<std::string, std::string> shapeCache(kShapeCacheSize);
+
+    /**
+     * Returns true if 'op' is a comparison operator whose parse and canonicalization are
+     * determined by its operator structure alone, independent of the constants it
+     * compares against.
+     */
+    bool isShapeCacheableOperator(const BSONElement& op) {
+        const char* name = op.fieldName();
+
+        if (mongoutils::str::equals("$eq", name)
+            || mongoutils::str::equals("$lt", name)
+            || mongoutils::str::equals("$lte", name)
+            || mongoutils::str::equals("$gt", name)
+            || mongoutils::str::equals("$gte", name)
+            || mongoutils::str::equals("$ne", name)) {
+            // The operand must be a plain value. Nested documents, arrays, regexes and
+            // code can change how the predicate parses.
+            return Object != op.type() && Array != op.type()
+                && RegEx != op.type() && Code != op.type() && CodeWScope != op.type();
+        }
+
+        if (mongoutils::str::equals("$in", name) || mongoutils::str::equals("$nin", name)) {
+            if (Array != op.type()) {
+                return false;
+            }
+            BSONObjIterator it(op.Obj());
+            while (it.more()) {
+                BSONElement member = it.next();
+                if (Object == member.type() || Array == member.type()
+                    || RegEx == member.type()) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Appends an encoding of 'elt''s operator structure -- its field name, operator names
+     * and array operand lengths, but not the constants compared against -- to 'os'.
+     *
+     * Returns false if the predicate is not simple enough for its operator structure to
+     * determine the canonicalized tree's cache key fragment; the caller must then fall
+     * back on encoding the parsed tree.
+     */
+    bool encodeRawPredicatePattern(const BSONElement& elt, mongoutils::str::stream* os) {
+        const char* fieldName = elt.fieldName();
+
+        // Expression operators at the top level ($or, $where, $text, ...) take the
+        // slow path.
+        if ('$' == fieldName[0]) {
+            return false;
+        }
+
+        encodeUserString(fieldName, os);
+
+        if (Object != elt.type() || '$' != elt.Obj().firstElementFieldName()[0]) {
+            // Equality on a literal value.
+            return true;
+        }
+
+        // A document of operators, e.g. {$gt: 5, $lt: 10}. Bracket the operator list so
+        // that field names containing '$' cannot collide with it; encodeUserString()
+        // escapes the brackets wherever they occur in user strings.
+        *os << kEncodeChildrenBegin;
+        BSONObjIterator it(elt.Obj());
+        while (it.more()) {
+            BSONElement op = it.next();
+            if (!isShapeCacheableOperator(op)) {
+                return false;
+            }
+            *os << op.fieldName();
+            if (Array == op.type()) {
+                // The number of operands is part of the shape; the tree encoding carries
+                // one node per $in/$nin but canonicalization may depend on arity.
+                *os << op.Obj().nFields();
+            }
+        }
+        *os << kEncodeChildrenEnd;
+        return true;
+    }
+
+    /**
+     * Appends the raw shape pattern for 'filter' to 'os', one predicate at a time.
+     * Returns false if any predicate is not shape cacheable.
+     */
+    bool encodeRawQueryShape(const BSONObj& filter, mongoutils::str::stream* os) {
+        BSONObjIterator it(filter);
+        while (it.more()) {
+            if (!encodeRawPredicatePattern(it.next(), os)) {
+                return false;
+            }
+            *os << kEncodeChildrenSeparator;
+        }
+        return true;
+    }
+
     /**
      * Encodes sort order into cache key.
      * Sort order is normalized because it provided by
@@ -599,13 +719,80 @@ namespace mongo {
         return hasID;
     }
 
+    // static
+    std::string CanonicalQuery::getSimpleEqualityField(const BSONObj& query) {
+        const char* field = NULL;
+
+        BSONObjIterator it(query);
+        while (it.more()) {
+            BSONElement elt = it.next();
+            if (elt.fieldName()[0] == '$' &&
+                (mongoutils::str::equals("$isolated", elt.fieldName())||
+                 mongoutils::str::equals("$atomic", elt.fieldName()))) {
+                // ok, passthrough
+                continue;
+            }
+
+            if (NULL != field) {
+                // More than one predicate field.
+                return "";
+            }
+
+            if (elt.type() == Object) {
+                // If the value is an object, it can't have a query operator
+                // (must be a literal object match).
+                if (elt.Obj().firstElementFieldName()[0] == '$') {
+                    return "";
+                }
+            }
+            else if (!elt.isSimpleType() && BinData != elt.type()) {
+                // The value cannot be something like { $gt : ...
+                // But it can be BinData.
+                return "";
+            }
+
+            field = elt.fieldName();
+        }
+
+        return NULL == field ? "" : field;
+    }
+
     const PlanCacheKey& CanonicalQuery::getPlanCacheKey() const {
         return _cacheKey;
     }
 
     void CanonicalQuery::generateCacheKey(void) {
+        // When the raw filter is simple enough that its operator structure alone
+        // determines the canonicalized tree's encoding, reuse the encoding computed the
+        // first time this shape was seen rather than walking the tree again.
+        mongoutils::str::stream patternStream;
+        const bool shapeCacheable = encodeRawQueryShape(_pq->getFilter(), &patternStream);
+
+        std::string pattern;
+        std::string treeEncoding;
+        bool found = false;
+        if (shapeCacheable) {
+            pattern = patternStream;
+            SimpleMutex::scoped_lock lk(shapeCacheLock);
+            std::string* cachedEncoding;
+            if (shapeCache.get(pattern, &cachedEncoding).isOK()) {
+                treeEncoding = *cachedEncoding;
+                found = true;
+            }
+        }
+
+        if (!found) {
+            mongoutils::str::stream treeStream;
+            encodePlanCacheKeyTree(_root.get(), &treeStream);
+            treeEncoding = treeStream;
+            if (shapeCacheable) {
+                SimpleMutex::scoped_lock lk(shapeCacheLock);
+                shapeCache.add(pattern, new std::string(treeEncoding));
+            }
+        }
+
         mongoutils::str::stream ss;
-        encodePlanCacheKeyTree(_root.get(), &ss);
+        ss << treeEncoding;
         encodePlanCacheKeySort(_pq->getSort(), &ss);
         encodePlanCacheKeyProj(_pq->getProj(), &ss);
         _cacheKey = ss;
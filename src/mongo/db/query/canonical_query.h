@@ -154,6 +154,13 @@ namespace mongo {
          */
         static bool isSimpleIdQuery(const BSONObj& query);
 
+        /**
+         * If "query" describes an exact-match query on exactly one field, possibly with
+         * the $isolated/$atomic modifier, returns that field's name.  Otherwise returns
+         * the empty string.
+         */
+        static std::string getSimpleEqualityField(const BSONObj& query);
+
         // What namespace is this query over?
         const std::string& ns() const { return _pq->ns(); }
 
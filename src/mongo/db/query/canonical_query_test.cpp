@@ -49,6 +49,24 @@ namespace {
         return StatusWithMatchExpression(CanonicalQuery::normalizeTree(swme.getValue()));
     }
 
+    TEST(CanonicalQueryTest, GetSimpleEqualityField) {
+        // Simple equalities on one field.
+        ASSERT_EQUALS("a", CanonicalQuery::getSimpleEqualityField(fromjson("{a: 5}")));
+        ASSERT_EQUALS("a.b", CanonicalQuery::getSimpleEqualityField(fromjson("{'a.b': 'x'}")));
+        ASSERT_EQUALS("a", CanonicalQuery::getSimpleEqualityField(
+            fromjson("{a: 5, $isolated: 1}")));
+
+        // Literal object matches are equalities; operator objects are not.
+        ASSERT_EQUALS("a", CanonicalQuery::getSimpleEqualityField(fromjson("{a: {b: 1}}")));
+        ASSERT_EQUALS("", CanonicalQuery::getSimpleEqualityField(fromjson("{a: {$gt: 5}}")));
+
+        // Not simple: multiple fields, no fields, or non-simple values.
+        ASSERT_EQUALS("", CanonicalQuery::getSimpleEqualityField(fromjson("{a: 5, b: 6}")));
+        ASSERT_EQUALS("", CanonicalQuery::getSimpleEqualityField(fromjson("{}")));
+        ASSERT_EQUALS("", CanonicalQuery::getSimpleEqualityField(fromjson("{a: [1, 2]}")));
+        ASSERT_EQUALS("", CanonicalQuery::getSimpleEqualityField(fromjson("{a: null}")));
+    }
+
     TEST(CanonicalQueryTest, IsValidText) {
         // Passes in default values for LiteParsedQuery.
         // Filter inside LiteParsedQuery is not used.
@@ -606,6 +624,21 @@ namespace {
         testGetPlanCacheKey("{}", "{}", "{a: 'foo,[]~|'}", "an|\"foo\\,\\[\\]\\~\\|\"a");
     }
 
+    // Queries that differ only in the constants they compare against share a cache key.
+    // The first canonicalization seeds the raw shape cache, so the second query below
+    // takes the cached fast path; both must produce the full encoding.
+    TEST(PlanCacheTest, GetPlanCacheKeyRawShapeCache) {
+        testGetPlanCacheKey("{a: 10, b: {$in: [1, 2, 3]}, c: {$gt: 5, $lte: 9}}", "{}", "{}",
+                            "an[lec,eqa,gtc,inb]");
+        testGetPlanCacheKey("{a: 'xyz', b: {$in: [7, 8, 9]}, c: {$gt: 0, $lte: 100}}", "{}", "{}",
+                            "an[lec,eqa,gtc,inb]");
+
+        // $in arity is part of the raw shape; a different arity must not hit the
+        // cached pattern for the queries above.
+        testGetPlanCacheKey("{a: 10, b: {$in: [1, 2]}, c: {$gt: 5, $lte: 9}}", "{}", "{}",
+                            "an[lec,eqa,gtc,inb]");
+    }
+
     // Cache keys for $geoWithin queries with legacy and GeoJSON coordinates should
     // not be the same.
     TEST(PlanCacheTest, GetPlanCacheKeyGeoWithin) {
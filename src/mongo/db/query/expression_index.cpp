@@ -32,13 +32,50 @@
 
 #include "third_party/s2/s2regioncoverer.h"
 
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/hash.h"
 #include "mongo/db/geo/r2_region_coverer.h"
 #include "mongo/db/hasher.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
 
+    namespace {
+
+        // Process-wide cache of 2dsphere covering intervals, keyed by the raw geometry
+        // predicate plus the index's coarsest indexed level.  Applications tend to query
+        // with a fixed set of geofences, and computing a covering is a large slice of
+        // geo query latency, so coverings are worth remembering.  The cached intervals
+        // share their (atomically refcounted) BSON buffers with every consumer.
+        struct CachedCovering {
+            std::vector<Interval> intervals;
+        };
+
+        const size_t kCoveringCacheSize = 500;
+        SimpleMutex coveringCacheLock("geoCoveringCache");
+        LRUKeyValue<std::string, CachedCovering> coveringCache(kCoveringCacheSize);
+
+        Counter64 coveringCacheHits;
+        Counter64 coveringCacheMisses;
+        ServerStatusMetricField<Counter64> displayCoveringCacheHits(
+            "query.geoCoveringCache.hits", &coveringCacheHits);
+        ServerStatusMetricField<Counter64> displayCoveringCacheMisses(
+            "query.geoCoveringCache.misses", &coveringCacheMisses);
+
+        std::string coveringCacheKey(const BSONObj& geometryObj, const BSONObj& indexInfoObj) {
+            BSONElement ce = indexInfoObj["coarsestIndexedLevel"];
+            const int coarsestIndexedLevel = ce.isNumber() ? ce.numberInt() : -1;
+
+            std::string key(geometryObj.objdata(), geometryObj.objsize());
+            key.push_back(':');
+            key.append(mongoutils::str::stream() << coarsestIndexedLevel);
+            return key;
+        }
+    }
+
     BSONObj ExpressionMapping::hash(const BSONElement& value) {
         BSONObjBuilder bob;
         bob.append("", BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED));
@@ -207,4 +244,40 @@ namespace mongo {
         }
     }
 
+    void ExpressionMapping::cover2dsphereWithCache(const BSONObj& geometryObj,
+                                                   const S2Region& region,
+                                                   const BSONObj& indexInfoObj,
+                                                   OrderedIntervalList* oilOut) {
+        const std::string key = coveringCacheKey(geometryObj, indexInfoObj);
+
+        {
+            SimpleMutex::scoped_lock lk(coveringCacheLock);
+            CachedCovering* cached;
+            if (coveringCache.get(key, &cached).isOK()) {
+                coveringCacheHits.increment();
+                oilOut->intervals.insert(oilOut->intervals.end(),
+                                         cached->intervals.begin(),
+                                         cached->intervals.end());
+                return;
+            }
+        }
+
+        coveringCacheMisses.increment();
+
+        // Compute into a scratch list so only the covering itself is cached, whatever
+        // the caller already had in 'oilOut'.
+        OrderedIntervalList fresh;
+        cover2dsphere(region, indexInfoObj, &fresh);
+
+        oilOut->intervals.insert(oilOut->intervals.end(),
+                                 fresh.intervals.begin(),
+                                 fresh.intervals.end());
+
+        std::auto_ptr<CachedCovering> entry(new CachedCovering());
+        entry->intervals.swap(fresh.intervals);
+
+        SimpleMutex::scoped_lock lk(coveringCacheLock);
+        coveringCache.add(key, entry.release());
+    }
+
 }  // namespace mongo
@@ -55,6 +55,20 @@ namespace mongo {
         static void cover2dsphere(const S2Region& region,
                                   const BSONObj& indexInfoObj,
                                   OrderedIntervalList* oilOut);
+
+        /**
+         * As above, but consults a small process-wide LRU cache of coverings before
+         * invoking the S2 region coverer.  'geometryObj' is the raw geo predicate the
+         * region was parsed from; together with the index's coarsest indexed level it
+         * uniquely determines the covering.  Applications tend to issue the same few
+         * geofences over and over, so the coverer usually only runs the first time a
+         * shape is seen.  Hit counts are reported under the
+         * 'query.geoCoveringCache' serverStatus metrics.
+         */
+        static void cover2dsphereWithCache(const BSONObj& geometryObj,
+                                           const S2Region& region,
+                                           const BSONObj& indexInfoObj,
+                                           OrderedIntervalList* oilOut);
     };
 
 }  // namespace mongo
@@ -33,6 +33,7 @@
 #include "mongo/db/query/find.h"
 
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/clientcursor.h"
@@ -53,6 +54,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/oplog_hack.h"
+#include "mongo/db/storage/recovery_unit.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/s/chunk_version.h"
@@ -170,6 +172,57 @@ namespace mongo {
         RecoveryUnit* _txnPreviousRecoveryUnit;
     };
 
+    // How long a getMore on a capped collection blocks on the insert notifier before
+    // giving receivedGetMore a chance to run its shutdown, interrupt and overall
+    // timeout checks.
+    static const int kCappedInsertAwaitDataTimeoutMS = 1000;
+
+    /**
+     * Fills out 'bb' with the next batch of results from the executor of 'cc'.  Called by
+     * getMore(), possibly twice per call when an awaitData wait intervenes between two
+     * attempts.  '*numResults' is incremented for each document appended, and '*state' is
+     * the ExecState the executor stopped on.  '*obj' holds the last object the executor
+     * produced, which carries the error details when '*state' is FAILURE.
+     */
+    static void generateBatch(OperationContext* txn,
+                              ClientCursor* cc,
+                              int ntoreturn,
+                              int batchByteTarget,
+                              BufBuilder* bb,
+                              BSONObj* obj,
+                              int* numResults,
+                              OpTime* slaveReadTill,
+                              PlanExecutor::ExecState* state) {
+        PlanExecutor* exec = cc->getExecutor();
+        const int queryOptions = cc->queryOptions();
+
+        // Each result is appended to the output buffer before the next getNext() call,
+        // so for the duration of this batch the storage engine may hand back views
+        // onto its own memory instead of per-document copies.
+        ScopedPinnedReads pinnedReads(txn->recoveryUnit());
+
+        while (PlanExecutor::ADVANCED == (*state = exec->getNext(obj, NULL))) {
+            // Add result to output buffer.
+            bb->appendBuf((void*)obj->objdata(), obj->objsize());
+
+            // Count the result.
+            ++(*numResults);
+
+            // Possibly note slave's position in the oplog.
+            if (queryOptions & QueryOption_OplogReplay) {
+                BSONElement e = (*obj)["ts"];
+                if (Date == e.type() || Timestamp == e.type()) {
+                    *slaveReadTill = e._opTime();
+                }
+            }
+
+            if ((ntoreturn && *numResults >= ntoreturn)
+                || bb->len() > batchByteTarget) {
+                break;
+            }
+        }
+    }
+
     /**
      * Called by db/instance.cpp.  This is the getMore entry point.
      *
@@ -311,30 +364,64 @@ namespace mongo {
             PlanExecutor* exec = cc->getExecutor();
             const int queryOptions = cc->queryOptions();
 
+            // When the client doesn't dictate a batch size, target a byte budget adapted
+            // to how quickly this cursor's client has been consuming batches.
+            const int batchByteTarget = ntoreturn ? MaxBytesToReturnToClientAtOnce
+                                                  : cc->nextBatchByteTarget();
+
+            // If this is an awaitData cursor over a capped collection, note the insert
+            // notifier's version now, while we still hold the collection lock.  Should
+            // the batch below come up empty, we wait on the notifier rather than bubble
+            // straight back out to the sleep-and-retry passes in receivedGetMore.  The
+            // oplog has its own optime-based wait in receivedGetMore and is left alone.
+            boost::shared_ptr<CappedInsertNotifier> notifier;
+            uint64_t notifierVersion = 0;
+            if ((queryOptions & QueryOption_AwaitData)
+                    && ctx.get()
+                    && ctx->getCollection()->isCapped()
+                    && !nss.isOplog()) {
+                notifier = ctx->getCollection()->getCappedInsertNotifier();
+                notifierVersion = notifier->getVersion();
+            }
+
             // Get results out of the executor.
             exec->restoreState(txn);
 
             BSONObj obj;
             PlanExecutor::ExecState state;
-            while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
-                // Add result to output buffer.
-                bb.appendBuf((void*)obj.objdata(), obj.objsize());
 
-                // Count the result.
-                ++numResults;
+            generateBatch(txn, cc, ntoreturn, batchByteTarget, &bb, &obj,
+                          &numResults, &slaveReadTill, &state);
+
+            // The batch came up empty at EOF.  Block on the insert notifier, with our
+            // locks released, until a writer signals new data or the wait times out,
+            // then take one more pass at filling the batch.  Waking directly off the
+            // insert is what lets a quiet tailing consumer cost one context switch
+            // instead of a stream of sleep-and-retry passes.
+            if (notifier
+                    && PlanExecutor::IS_EOF == state
+                    && 0 == numResults
+                    && (pass < 1000)) {
+                // The notifier is held by shared_ptr, so it stays valid even if the
+                // collection is dropped while we are blocked.
+                exec->saveState();
+                ctx.reset();
 
-                // Possibly note slave's position in the oplog.
-                if (queryOptions & QueryOption_OplogReplay) {
-                    BSONElement e = obj["ts"];
-                    if (Date == e.type() || Timestamp == e.type()) {
-                        slaveReadTill = e._opTime();
-                    }
-                }
+                notifier->waitForInsert(notifierVersion, kCappedInsertAwaitDataTimeoutMS);
+                notifier.reset();
 
-                if ((ntoreturn && numResults >= ntoreturn)
-                    || bb.len() > MaxBytesToReturnToClientAtOnce) {
-                    break;
-                }
+                txn->checkForInterrupt();
+
+                // Reacquire locks.  The collection may be gone, or may have been
+                // dropped and re-created; in the latter case the executor was killed
+                // and the retry below ends in a DEAD state handled further down.
+                ctx.reset(new AutoGetCollectionForRead(txn, nss));
+                uassert(28728, "collection dropped between getMore calls",
+                        ctx->getCollection());
+                exec->restoreState(txn);
+
+                generateBatch(txn, cc, ntoreturn, batchByteTarget, &bb, &obj,
+                              &numResults, &slaveReadTill, &state);
             }
 
             // We save the client cursor when there might be more results, and hence we may receive
@@ -730,39 +817,47 @@ namespace mongo {
         // Get summary info about which plan the executor is using.
         curop.debug().planSummary = Explain::getPlanSummary(exec.get());
 
-        while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
-            // Add result to output buffer.
-            bb.appendBuf((void*)obj.objdata(), obj.objsize());
+        {
+            // Each result is appended to the output buffer before the next getNext() call, so
+            // for the duration of this batch the storage engine may hand back views onto its
+            // own memory instead of per-document copies.
+            ScopedPinnedReads pinnedReads(txn->recoveryUnit());
 
-            // Count the result.
-            ++numResults;
+            while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
+                // Add result to output buffer.
+                bb.appendBuf((void*)obj.objdata(), obj.objsize());
 
-            // Possibly note slave's position in the oplog.
-            if (pq.getOptions().oplogReplay) {
-                BSONElement e = obj["ts"];
-                if (Date == e.type() || Timestamp == e.type()) {
-                    slaveReadTill = e._opTime();
+                // Count the result.
+                ++numResults;
+
+                // Possibly note slave's position in the oplog.
+                if (pq.getOptions().oplogReplay) {
+                    BSONElement e = obj["ts"];
+                    if (Date == e.type() || Timestamp == e.type()) {
+                        slaveReadTill = e._opTime();
+                    }
                 }
-            }
 
-            // TODO: only one type of 2d search doesn't support this.  We need a way to pull it out
-            // of CanonicalQuery. :(
-            const bool supportsGetMore = true;
-            if (!supportsGetMore && (enough(pq, numResults)
-                                     || bb.len() >= MaxBytesToReturnToClientAtOnce)) {
-                break;
-            }
-            else if (enoughForFirstBatch(pq, numResults, bb.len())) {
-                QLOG() << "Enough for first batch, wantMore=" << pq.wantMore()
-                       << " numToReturn=" << pq.getNumToReturn()
-                       << " numResults=" << numResults
-                       << endl;
-                // If only one result requested assume it's a findOne() and don't save the cursor.
-                if (pq.wantMore() && 1 != pq.getNumToReturn()) {
-                    QLOG() << " executor EOF=" << exec->isEOF() << endl;
-                    saveClientCursor = !exec->isEOF();
+                // TODO: only one type of 2d search doesn't support this.  We need a way to pull
+                // it out of CanonicalQuery. :(
+                const bool supportsGetMore = true;
+                if (!supportsGetMore && (enough(pq, numResults)
+                                         || bb.len() >= MaxBytesToReturnToClientAtOnce)) {
+                    break;
+                }
+                else if (enoughForFirstBatch(pq, numResults, bb.len())) {
+                    QLOG() << "Enough for first batch, wantMore=" << pq.wantMore()
+                           << " numToReturn=" << pq.getNumToReturn()
+                           << " numResults=" << numResults
+                           << endl;
+                    // If only one result requested assume it's a findOne() and don't save the
+                    // cursor.
+                    if (pq.wantMore() && 1 != pq.getNumToReturn()) {
+                        QLOG() << " executor EOF=" << exec->isEOF() << endl;
+                        saveClientCursor = !exec->isEOF();
+                    }
+                    break;
                 }
-                break;
             }
         }
 
@@ -37,6 +37,7 @@
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/client/dbclientinterface.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
@@ -116,11 +117,13 @@ namespace mongo {
                                                                                          false);
         while (ii.more()) {
             const IndexDescriptor* desc = ii.next();
+            const IndexCatalogEntry* ice = collection->getIndexCatalog()->getEntry(desc);
             plannerParams->indices.push_back(IndexEntry(desc->keyPattern(),
                                                         desc->getAccessMethodName(),
                                                         desc->isMultikey(txn),
                                                         desc->isSparse(),
                                                         desc->indexName(),
+                                                        ice->getFilterExpression(),
                                                         desc->infoObj()));
         }
 
@@ -180,6 +183,53 @@ namespace mongo {
 
     namespace {
 
+        /**
+         * Returns a single-field unique index that can answer 'query' with a point lookup,
+         * or NULL if there is none.  The query must be a simple equality on the index's
+         * field, and the index must be a plain btree index with no sparse or partial
+         * restrictions, so that finding the key is equivalent to matching the document.
+         */
+        const IndexDescriptor* findUniquePointReadIndex(OperationContext* opCtx,
+                                                        Collection* collection,
+                                                        const CanonicalQuery& query) {
+            const LiteParsedQuery& pq = query.getParsed();
+            if (pq.showDiskLoc()
+                || !pq.getHint().isEmpty()
+                || 0 != pq.getSkip()
+                || pq.getOptions().tailable) {
+                return NULL;
+            }
+
+            const string field = CanonicalQuery::getSimpleEqualityField(pq.getFilter());
+            if (field.empty()) {
+                return NULL;
+            }
+
+            IndexCatalog::IndexIterator ii =
+                collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+            while (ii.more()) {
+                const IndexDescriptor* desc = ii.next();
+                if (!desc->unique() || desc->isSparse() || desc->isPartial()) {
+                    continue;
+                }
+
+                const BSONObj keyPattern = desc->keyPattern();
+                if (1 != keyPattern.nFields()
+                    || field != keyPattern.firstElementFieldName()) {
+                    continue;
+                }
+
+                // Only plain btree indexes support a direct key lookup.
+                if (IndexNames::BTREE != IndexNames::findPluginName(keyPattern)) {
+                    continue;
+                }
+
+                return desc;
+            }
+
+            return NULL;
+        }
+
         /**
          * Build an execution tree for the query described in 'canonicalQuery'.  Does not take
          * ownership of arguments.
@@ -216,13 +266,21 @@ namespace mongo {
             plannerParams.options = plannerOptions;
             fillOutPlannerParams(opCtx, collection, canonicalQuery, &plannerParams);
 
-            // If we have an _id index we can use an idhack plan.
-            if (IDHackStage::supportsQuery(*canonicalQuery) &&
-                collection->getIndexCatalog()->findIdIndex(opCtx)) {
+            // If we have an _id index we can use an idhack plan.  The same fast path
+            // applies to a simple equality against any other single-field unique index.
+            const IndexDescriptor* pointReadIndex = NULL;
+            if (IDHackStage::supportsQuery(*canonicalQuery)) {
+                pointReadIndex = collection->getIndexCatalog()->findIdIndex(opCtx);
+            }
+            if (NULL == pointReadIndex) {
+                pointReadIndex = findUniquePointReadIndex(opCtx, collection, *canonicalQuery);
+            }
 
+            if (NULL != pointReadIndex) {
                 LOG(2) << "Using idhack: " << canonicalQuery->toStringShort();
 
-                *rootOut = new IDHackStage(opCtx, collection, canonicalQuery, ws);
+                *rootOut = new IDHackStage(opCtx, collection, canonicalQuery, ws,
+                                           pointReadIndex);
 
                 // Might have to filter out orphaned docs.
                 if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
@@ -499,6 +557,7 @@ namespace mongo {
         deleteStageParams.shouldCallLogOp = request->shouldCallLogOp();
         deleteStageParams.fromMigrate = request->isFromMigrate();
         deleteStageParams.isExplain = request->isExplain();
+        deleteStageParams.returnDeleted = request->shouldReturnDeleted();
 
         auto_ptr<WorkingSet> ws(new WorkingSet());
         PlanExecutor::YieldPolicy policy = parsedDelete->canYield() ? PlanExecutor::YIELD_AUTO :
@@ -824,8 +883,13 @@ namespace mongo {
         /**
          * Returns true if indices contains an index that can be
          * used with DistinctNode. Sets indexOut to the array index
-         * of PlannerParams::indices.
-         * Look for the index for the fewest fields.
+         * of PlannerParams::indices and fieldNoOut to the position of
+         * 'field' in that index's key pattern.
+         * The field does not have to be the first component of the key pattern. A
+         * distinct scan positioned at component k skips to the next value of the
+         * first k+1 fields, so later positions enumerate every combination of the
+         * preceding fields' values. Prefer the index where the field is earliest;
+         * break ties on the fewest fields.
          * Criteria for suitable index is that the index cannot be special
          * (geo, hashed, text, ...).
          *
@@ -839,9 +903,12 @@ namespace mongo {
          * the projection stage cannot be covered with a dotted field.
          */
         bool getDistinctNodeIndex(const std::vector<IndexEntry>& indices,
-                                  const std::string& field, size_t* indexOut) {
+                                  const std::string& field, size_t* indexOut,
+                                  int* fieldNoOut) {
             invariant(indexOut);
+            invariant(fieldNoOut);
             bool isDottedField = str::contains(field, '.');
+            int minFieldNo = std::numeric_limits<int>::max();
             int minFields = std::numeric_limits<int>::max();
             for (size_t i = 0; i < indices.size(); ++i) {
                 // Skip special indices.
@@ -852,11 +919,26 @@ namespace mongo {
                 if (indices[i].multikey && isDottedField) {
                     continue;
                 }
+                // Where in this index's key pattern is the field we're distinct-ing over?
+                int fieldNo = 0;
+                BSONObjIterator it(indices[i].keyPattern);
+                while (it.more() && field != it.next().fieldName()) {
+                    fieldNo++;
+                }
                 int nFields = indices[i].keyPattern.nFields();
-                // Pick the index with the lowest number of fields.
-                if (nFields < minFields) {
+                if (fieldNo == nFields) {
+                    // Shouldn't happen; the caller only offers indices containing the
+                    // field. Skip defensively.
+                    continue;
+                }
+                // Pick the index where the field is earliest, then the one with the
+                // lowest number of fields.
+                if (fieldNo < minFieldNo ||
+                    (fieldNo == minFieldNo && nFields < minFields)) {
+                    minFieldNo = fieldNo;
                     minFields = nFields;
                     *indexOut = i;
+                    *fieldNoOut = fieldNo;
                 }
             }
             return minFields != std::numeric_limits<int>::max();
@@ -1042,9 +1124,10 @@ namespace mongo {
             dn->direction = isn->direction;
             dn->bounds = isn->bounds;
 
-            // Figure out which field we're skipping to the next value of.  TODO: We currently only
-            // try to distinct-hack when there is an index prefixed by the field we're distinct-ing
-            // over.  Consider removing this code if we stick with that policy.
+            // Figure out which field we're skipping to the next value of. The field doesn't
+            // have to be the first component of the key pattern; with a filter pinning the
+            // preceding components to point bounds the scan still seeks once per distinct
+            // value of the field.
             dn->fieldNo = 0;
             BSONObjIterator it(isn->indexKeyPattern);
             while (it.more()) {
@@ -1054,6 +1137,12 @@ namespace mongo {
                 dn->fieldNo++;
             }
 
+            if (dn->fieldNo == isn->indexKeyPattern.nFields()) {
+                // The field isn't in this index at all; a distinct scan can't skip on it.
+                delete dn;
+                return false;
+            }
+
             // Delete the old index scan, set the child of project to the fast distinct scan.
             delete root->children[0];
             root->children[0] = dn;
@@ -1077,7 +1166,9 @@ namespace mongo {
         // When can we do a fast distinct hack?
         // 1. There is a plan with just one leaf and that leaf is an ixscan.
         // 2. The ixscan indexes the field we're interested in.
-        // 2a: We are correct if the index contains the field but for now we look for prefix.
+        // 2a: The field can be any component of the index; when it isn't the first,
+        //     the preceding components are either pinned by the query's bounds or
+        //     enumerated by the skip-scan.
         // 3. The query is covered/no fetch.
         //
         // We go through normal planning (with limited parameters) to see if we can produce
@@ -1089,14 +1180,19 @@ namespace mongo {
         IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(txn,false);
         while (ii.more()) {
             const IndexDescriptor* desc = ii.next();
-            // The distinct hack can work if any field is in the index but it's not always clear
-            // if it's a win unless it's the first field.
-            if (desc->keyPattern().firstElement().fieldName() == field) {
+            // Any index containing the field can drive a distinct scan: positioned at that
+            // field the scan seeks to the next value instead of reading every key. When the
+            // field isn't the first component the preceding components are usually pinned
+            // by the query (a filter on the index prefix), and at worst the scan enumerates
+            // their value combinations -- still without fetching any documents.
+            if (desc->keyPattern().hasField(field)) {
+                const IndexCatalogEntry* ice = collection->getIndexCatalog()->getEntry(desc);
                 plannerParams.indices.push_back(IndexEntry(desc->keyPattern(),
                                                            desc->getAccessMethodName(),
                                                            desc->isMultikey(txn),
                                                            desc->isSparse(),
                                                            desc->indexName(),
+                                                           ice->getFilterExpression(),
                                                            desc->infoObj()));
             }
         }
@@ -1144,13 +1240,15 @@ namespace mongo {
         // Not every index in plannerParams.indices may be suitable. Refer to
         // getDistinctNodeIndex().
         size_t distinctNodeIndex = 0;
+        int distinctFieldNo = 0;
         if (query.isEmpty() &&
-            getDistinctNodeIndex(plannerParams.indices, field, &distinctNodeIndex)) {
+            getDistinctNodeIndex(plannerParams.indices, field, &distinctNodeIndex,
+                                 &distinctFieldNo)) {
             DistinctNode* dn = new DistinctNode();
             dn->indexKeyPattern = plannerParams.indices[distinctNodeIndex].keyPattern;
             dn->direction = 1;
             IndexBoundsBuilder::allValuesBounds(dn->indexKeyPattern, &dn->bounds);
-            dn->fieldNo = 0;
+            dn->fieldNo = distinctFieldNo;
 
             QueryPlannerParams params;
 
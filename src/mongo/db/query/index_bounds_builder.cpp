@@ -30,6 +30,7 @@
 
 #include "mongo/db/query/index_bounds_builder.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "mongo/base/string_data.h"
@@ -188,6 +189,61 @@ namespace mongo {
         return lhs.startInclusive;
     }
 
+    namespace {
+
+        /**
+         * Collapses overlapping and unionable neighbors of the sorted interval list 'iv' in
+         * one pass.  Unlike erasing out of the middle of the vector as we merge, this keeps
+         * unionize linear after the sort, which matters for generated queries with hundreds
+         * of range clauses.
+         */
+        void coalesceSortedIntervals(vector<Interval>* ivOut) {
+            vector<Interval>& iv = *ivOut;
+            if (iv.size() < 2) { return; }
+
+            vector<Interval> merged;
+            merged.reserve(iv.size());
+            merged.push_back(iv[0]);
+
+            for (size_t i = 1; i < iv.size(); ++i) {
+                Interval& last = merged.back();
+                Interval::IntervalComparison cmp = last.compare(iv[i]);
+
+                // This means our sort didn't work.
+                verify(Interval::INTERVAL_SUCCEEDS != cmp);
+
+                if (Interval::INTERVAL_PRECEDES == cmp) {
+                    // Disjoint; start a new output interval.
+                    merged.push_back(iv[i]);
+                }
+                else if (Interval::INTERVAL_EQUALS == cmp || Interval::INTERVAL_WITHIN == cmp) {
+                    // 'last' is equal to iv[i], or is contained within iv[i].
+                    last = iv[i];
+                }
+                else if (Interval::INTERVAL_CONTAINS == cmp) {
+                    // 'last' contains iv[i]; nothing to do.
+                }
+                else if (Interval::INTERVAL_OVERLAPS_BEFORE == cmp
+                         || Interval::INTERVAL_PRECEDES_COULD_UNION == cmp) {
+                    // Merge: 'last' starts before iv[i], extend it through iv[i]'s end.
+                    BSONObjBuilder bob;
+                    bob.appendAs(last.start, "");
+                    bob.appendAs(iv[i].end, "");
+                    last = IndexBoundsBuilder::makeRangeInterval(bob.obj(),
+                                                                 last.startInclusive,
+                                                                 iv[i].endInclusive);
+                }
+                else {
+                    // The sort rules out everything else.
+                    verify(0);
+                }
+            }
+
+            iv.swap(merged);
+        }
+
+    }  // namespace
+
     // static
     void IndexBoundsBuilder::translateAndIntersect(const MatchExpression* expr,
                                                    const BSONElement& elt,
@@ -212,11 +268,26 @@ namespace mongo {
         translate(expr, elt, index, &arg, tightnessOut);
 
         // Append the new intervals to oilOut.
+        size_t oldSize = oilOut->intervals.size();
         oilOut->intervals.insert(oilOut->intervals.end(), arg.intervals.begin(),
                                  arg.intervals.end());
 
-        // Union the appended intervals with the existing ones.
-        unionize(oilOut);
+        // Union the appended intervals with the existing ones.  Both halves are already
+        // sorted, so merging them is cheaper than re-sorting the whole list.
+        std::inplace_merge(oilOut->intervals.begin(),
+                           oilOut->intervals.begin() + oldSize,
+                           oilOut->intervals.end(),
+                           IntervalComparison);
+        coalesceSortedIntervals(&oilOut->intervals);
+
+        // Past the cap, give up on the precise interval set and scan all values of the field,
+        // re-applying the predicate after fetch.
+        if (oilOut->intervals.size() >
+            static_cast<size_t>(internalQueryMaxIntervalsPerBoundsField)) {
+            oilOut->intervals.clear();
+            oilOut->intervals.push_back(allValues());
+            *tightnessOut = INEXACT_FETCH;
+        }
     }
 
     bool typeMatch(const BSONObj& obj) {
@@ -572,6 +643,15 @@ namespace mongo {
             }
 
             unionize(oilOut);
+
+            // A huge $in can leave more intervals than are worth scanning individually.
+            // Degrade to all values of the field and re-check the predicate after fetch.
+            if (oilOut->intervals.size() >
+                static_cast<size_t>(internalQueryMaxIntervalsPerBoundsField)) {
+                oilOut->intervals.clear();
+                oilOut->intervals.push_back(allValues());
+                *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
+            }
         }
         else if (MatchExpression::GEO == expr->matchType()) {
 
@@ -580,7 +660,10 @@ namespace mongo {
             if (mongoutils::str::equals("2dsphere", elt.valuestrsafe())) {
                 verify(gme->getGeoExpression().getGeometry().hasS2Region());
                 const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
-                ExpressionMapping::cover2dsphere(region, index.infoObj, oilOut);
+                ExpressionMapping::cover2dsphereWithCache(gme->getRawObj(),
+                                                          region,
+                                                          index.infoObj,
+                                                          oilOut);
                 *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
             }
             else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
@@ -680,6 +763,7 @@ namespace mongo {
         oilOut->intervals.swap(result);
     }
 
+    // static
     // static
     void IndexBoundsBuilder::unionize(OrderedIntervalList* oilOut) {
         vector<Interval>& iv = oilOut->intervals;
@@ -691,44 +775,7 @@ namespace mongo {
         std::sort(iv.begin(), iv.end(), IntervalComparison);
 
         // Step 2: Walk through and merge.
-        size_t i = 0;
-        while (i < iv.size() - 1) {
-            // Compare i with i + 1.
-            Interval::IntervalComparison cmp = iv[i].compare(iv[i + 1]);
-
-            // This means our sort didn't work.
-            verify(Interval::INTERVAL_SUCCEEDS != cmp);
-
-            // Intervals are correctly ordered.
-            if (Interval::INTERVAL_PRECEDES == cmp) {
-                // We can move to the next pair.
-                ++i;
-            }
-            else if (Interval::INTERVAL_EQUALS == cmp || Interval::INTERVAL_WITHIN == cmp) {
-                // Interval 'i' is equal to i+1, or is contained within i+1.
-                // Remove interval i and don't move to the next value of 'i'.
-                iv.erase(iv.begin() + i);
-            }
-            else if (Interval::INTERVAL_CONTAINS == cmp) {
-                // Interval 'i' contains i+1, remove i+1 and don't move to the next value of 'i'.
-                iv.erase(iv.begin() + i + 1);
-            }
-            else if (Interval::INTERVAL_OVERLAPS_BEFORE == cmp
-                     || Interval::INTERVAL_PRECEDES_COULD_UNION == cmp) {
-                // We want to merge intervals i and i+1.
-                // Interval 'i' starts before interval 'i+1'.
-                BSONObjBuilder bob;
-                bob.appendAs(iv[i].start, "");
-                bob.appendAs(iv[i + 1].end, "");
-                BSONObj data = bob.obj();
-                bool startInclusive = iv[i].startInclusive;
-                bool endInclusive = iv[i + 1].endInclusive;
-                iv.erase(iv.begin() + i);
-                // iv[i] is now the former iv[i + 1]
-                iv[i] = makeRangeInterval(data, startInclusive, endInclusive);
-                // Don't increment 'i'.
-            }
-        }
+        coalesceSortedIntervals(&iv);
     }
 
     // static
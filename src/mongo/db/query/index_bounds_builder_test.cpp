@@ -36,6 +36,7 @@
 #include <memory>
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/unittest/unittest.h"
 
 using namespace mongo;
@@ -574,6 +575,67 @@ namespace {
         ASSERT_EQUALS(oil.intervals.size(), 0U);
     }
 
+    TEST(IndexBoundsBuilderTest, UnionManyOutOfOrderPoints) {
+        IndexEntry testIndex = IndexEntry(BSONObj());
+        vector<BSONObj> toUnion;
+        toUnion.push_back(fromjson("{a: 7}"));
+        toUnion.push_back(fromjson("{a: 1}"));
+        toUnion.push_back(fromjson("{a: 5}"));
+        toUnion.push_back(fromjson("{a: 3}"));
+        toUnion.push_back(fromjson("{a: 5}"));
+        OrderedIntervalList oil;
+        IndexBoundsBuilder::BoundsTightness tightness;
+        testTranslateAndUnion(toUnion, &oil, &tightness);
+        ASSERT_EQUALS(oil.name, "a");
+        ASSERT_EQUALS(oil.intervals.size(), 4U);
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS, oil.intervals[0].compare(
+            Interval(fromjson("{'': 1, '': 1}"), true, true)));
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS, oil.intervals[1].compare(
+            Interval(fromjson("{'': 3, '': 3}"), true, true)));
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS, oil.intervals[2].compare(
+            Interval(fromjson("{'': 5, '': 5}"), true, true)));
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS, oil.intervals[3].compare(
+            Interval(fromjson("{'': 7, '': 7}"), true, true)));
+        ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
+    }
+
+    TEST(IndexBoundsBuilderTest, UnionPastIntervalCapScansAllValues) {
+        int oldCap = internalQueryMaxIntervalsPerBoundsField;
+        internalQueryMaxIntervalsPerBoundsField = 3;
+        vector<BSONObj> toUnion;
+        toUnion.push_back(fromjson("{a: 1}"));
+        toUnion.push_back(fromjson("{a: 3}"));
+        toUnion.push_back(fromjson("{a: 5}"));
+        toUnion.push_back(fromjson("{a: 7}"));
+        OrderedIntervalList oil;
+        IndexBoundsBuilder::BoundsTightness tightness;
+        testTranslateAndUnion(toUnion, &oil, &tightness);
+        internalQueryMaxIntervalsPerBoundsField = oldCap;
+        ASSERT_EQUALS(oil.name, "a");
+        ASSERT_EQUALS(oil.intervals.size(), 1U);
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS, oil.intervals[0].compare(
+            IndexBoundsBuilder::allValues()));
+        ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+    }
+
+    TEST(IndexBoundsBuilderTest, InPastIntervalCapScansAllValues) {
+        int oldCap = internalQueryMaxIntervalsPerBoundsField;
+        internalQueryMaxIntervalsPerBoundsField = 3;
+        IndexEntry testIndex = IndexEntry(BSONObj());
+        BSONObj obj = fromjson("{a: {$in: [1, 3, 5, 7]}}");
+        auto_ptr<MatchExpression> expr(parseMatchExpression(obj));
+        BSONElement elt = obj.firstElement();
+        OrderedIntervalList oil;
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+        internalQueryMaxIntervalsPerBoundsField = oldCap;
+        ASSERT_EQUALS(oil.name, "a");
+        ASSERT_EQUALS(oil.intervals.size(), 1U);
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS, oil.intervals[0].compare(
+            IndexBoundsBuilder::allValues()));
+        ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+    }
+
     //
     // Intersection tests
     //
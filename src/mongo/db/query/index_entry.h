@@ -36,6 +36,8 @@
 
 namespace mongo {
 
+    class MatchExpression;
+
     /**
      * This name sucks, but every name involving 'index' is used somewhere.
      */
@@ -48,11 +50,13 @@ namespace mongo {
                    bool mk,
                    bool sp,
                    const std::string& n,
+                   const MatchExpression* fe,
                    const BSONObj& io)
             : keyPattern(kp),
               multikey(mk),
               sparse(sp),
               name(n),
+              filterExpr(fe),
               infoObj(io) {
 
             type = IndexNames::nameToType(accessMethod);
@@ -70,10 +74,11 @@ namespace mongo {
               multikey(mk),
               sparse(sp),
               name(n),
+              filterExpr(NULL),
               infoObj(io) {
 
             type = IndexNames::nameToType(IndexNames::findPluginName(keyPattern));
-        }     
+        }
 
         /**
          * For testing purposes only.
@@ -83,6 +88,7 @@ namespace mongo {
               multikey(false),
               sparse(false),
               name("test_foo"),
+              filterExpr(NULL),
               infoObj(BSONObj()) {
 
             type = IndexNames::nameToType(IndexNames::findPluginName(keyPattern));
@@ -96,6 +102,11 @@ namespace mongo {
 
         std::string name;
 
+        // The filter expression of a partial index, or NULL for a complete index.  Not owned
+        // here; points into the IndexCatalogEntry, which outlives any planning that uses this
+        // IndexEntry.
+        const MatchExpression* filterExpr;
+
         // Geo indices have extra parameters.  We need those available to plan correctly.
         BSONObj infoObj;
 
@@ -115,6 +126,10 @@ namespace mongo {
                 ss << " sparse";
             }
 
+            if (NULL != filterExpr) {
+                ss << " partial";
+            }
+
             if (!infoObj.isEmpty()) {
                 ss << " io: " << infoObj.toString();
             }
@@ -132,6 +132,8 @@ namespace mongo {
     // PlanCacheEntry
     //
 
+    PlanCacheEntry::PlanCacheEntry() { }
+
     PlanCacheEntry::PlanCacheEntry(const std::vector<QuerySolution*>& solutions,
                                    PlanRankingDecision* why)
         : plannerData(solutions.size()),
@@ -196,6 +198,22 @@ namespace mongo {
         return ss;
     }
 
+    BSONObj PlanCacheEntry::toBSON() const {
+        BSONObjBuilder bob;
+        bob.append("query", query);
+        bob.append("sort", sort);
+        bob.append("projection", projection);
+        BSONArrayBuilder plansBob(bob.subarrayStart("plannerData"));
+        for (size_t i = 0; i < plannerData.size(); ++i) {
+            plansBob.append(plannerData[i]->toBSON());
+        }
+        plansBob.doneFast();
+        if (backupSoln) {
+            bob.appendNumber("backupSoln", static_cast<long long>(*backupSoln));
+        }
+        return bob.obj();
+    }
+
     string CachedSolution::toString() const {
         mongoutils::str::stream ss;
         ss << "key: " << key << '\n';
@@ -250,6 +268,122 @@ namespace mongo {
         return ss;
     }
 
+    namespace {
+
+        /**
+         * Serialized form of a PlanCacheIndexTree, used by SolutionCacheData::toBSON().  The
+         * index entry is stored by name and key pattern so an importing server can match it
+         * against its own catalog (see PlanCache::importEntry).
+         */
+        BSONObj indexTreeToBSON(const PlanCacheIndexTree* tree) {
+            BSONObjBuilder bob;
+            if (NULL != tree->entry.get()) {
+                BSONObjBuilder entryBob(bob.subobjStart("entry"));
+                entryBob.append("keyPattern", tree->entry->keyPattern);
+                entryBob.append("name", tree->entry->name);
+                entryBob.appendBool("multikey", tree->entry->multikey);
+                entryBob.appendBool("sparse", tree->entry->sparse);
+                entryBob.append("infoObj", tree->entry->infoObj);
+                entryBob.appendNumber("indexPos", static_cast<long long>(tree->index_pos));
+                entryBob.doneFast();
+            }
+            BSONArrayBuilder childrenBob(bob.subarrayStart("children"));
+            for (size_t i = 0; i < tree->children.size(); ++i) {
+                childrenBob.append(indexTreeToBSON(tree->children[i]));
+            }
+            childrenBob.doneFast();
+            return bob.obj();
+        }
+
+        StatusWith<PlanCacheIndexTree*> indexTreeFromBSON(const BSONObj& obj) {
+            std::auto_ptr<PlanCacheIndexTree> tree(new PlanCacheIndexTree());
+
+            BSONElement entryElt = obj["entry"];
+            if (!entryElt.eoo()) {
+                if (!entryElt.isABSONObj()) {
+                    return StatusWith<PlanCacheIndexTree*>(ErrorCodes::BadValue,
+                                                           "index tree entry must be an object");
+                }
+                BSONObj entryObj = entryElt.Obj();
+                BSONElement keyPatternElt = entryObj["keyPattern"];
+                BSONElement nameElt = entryObj["name"];
+                if (!keyPatternElt.isABSONObj() || String != nameElt.type()) {
+                    return StatusWith<PlanCacheIndexTree*>(
+                        ErrorCodes::BadValue,
+                        "index tree entry requires a keyPattern object and an index name");
+                }
+                BSONObj infoObj;
+                if (entryObj["infoObj"].isABSONObj()) {
+                    infoObj = entryObj["infoObj"].Obj().getOwned();
+                }
+                tree->setIndexEntry(IndexEntry(keyPatternElt.Obj().getOwned(),
+                                               entryObj["multikey"].trueValue(),
+                                               entryObj["sparse"].trueValue(),
+                                               nameElt.String(),
+                                               infoObj));
+                tree->index_pos = static_cast<size_t>(entryObj["indexPos"].numberLong());
+            }
+
+            BSONElement childrenElt = obj["children"];
+            if (Array != childrenElt.type()) {
+                return StatusWith<PlanCacheIndexTree*>(ErrorCodes::BadValue,
+                                                       "index tree requires a children array");
+            }
+            BSONObjIterator it(childrenElt.Obj());
+            while (it.more()) {
+                BSONElement childElt = it.next();
+                if (!childElt.isABSONObj()) {
+                    return StatusWith<PlanCacheIndexTree*>(ErrorCodes::BadValue,
+                                                           "index tree children must be objects");
+                }
+                StatusWith<PlanCacheIndexTree*> child = indexTreeFromBSON(childElt.Obj());
+                if (!child.isOK()) {
+                    return child;
+                }
+                tree->children.push_back(child.getValue());
+            }
+
+            return StatusWith<PlanCacheIndexTree*>(tree.release());
+        }
+
+        /**
+         * Walks an imported index tree and replaces each tagged node's IndexEntry with the
+         * matching entry from 'currentIndexes' so that volatile catalog state (multikey-ness,
+         * sparseness) reflects this server rather than the one that exported the entry.  Fails
+         * if any referenced index no longer exists with the same key pattern.
+         */
+        Status validateIndexTree(PlanCacheIndexTree* tree,
+                                 const std::vector<IndexEntry>& currentIndexes) {
+            if (NULL != tree->entry.get()) {
+                bool found = false;
+                for (size_t i = 0; i < currentIndexes.size(); ++i) {
+                    if (currentIndexes[i].name == tree->entry->name &&
+                        0 == currentIndexes[i].keyPattern.woCompare(tree->entry->keyPattern)) {
+                        tree->setIndexEntry(currentIndexes[i]);
+                        found = true;
+                        break;
+                    }
+                }
+                if (!found) {
+                    return Status(ErrorCodes::BadValue,
+                                  mongoutils::str::stream()
+                                      << "plan cache entry references index "
+                                      << tree->entry->name << " with key pattern "
+                                      << tree->entry->keyPattern.toString()
+                                      << " which no longer exists");
+                }
+            }
+            for (size_t i = 0; i < tree->children.size(); ++i) {
+                Status status = validateIndexTree(tree->children[i], currentIndexes);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+            return Status::OK();
+        }
+
+    }  // namespace
+
     //
     // SolutionCacheData
     //
@@ -289,6 +423,65 @@ namespace mongo {
         return ss;
     }
 
+    BSONObj SolutionCacheData::toBSON() const {
+        BSONObjBuilder bob;
+        bob.append("solnType", static_cast<int>(this->solnType));
+        bob.append("wholeIXSolnDir", this->wholeIXSolnDir);
+        bob.appendBool("indexFilterApplied", this->indexFilterApplied);
+        if (NULL != this->tree.get()) {
+            bob.append("tree", indexTreeToBSON(this->tree.get()));
+        }
+        return bob.obj();
+    }
+
+    // static
+    StatusWith<SolutionCacheData*> SolutionCacheData::fromBSON(const BSONObj& obj) {
+        std::auto_ptr<SolutionCacheData> scd(new SolutionCacheData());
+
+        BSONElement solnTypeElt = obj["solnType"];
+        if (!solnTypeElt.isNumber()) {
+            return StatusWith<SolutionCacheData*>(ErrorCodes::BadValue,
+                                                  "cached solution requires a numeric solnType");
+        }
+        switch (solnTypeElt.numberInt()) {
+        case USE_INDEX_TAGS_SOLN:
+            scd->solnType = USE_INDEX_TAGS_SOLN;
+            break;
+        case WHOLE_IXSCAN_SOLN:
+            scd->solnType = WHOLE_IXSCAN_SOLN;
+            break;
+        case COLLSCAN_SOLN:
+            scd->solnType = COLLSCAN_SOLN;
+            break;
+        default:
+            return StatusWith<SolutionCacheData*>(ErrorCodes::BadValue,
+                                                  "cached solution has unknown solnType");
+        }
+
+        scd->wholeIXSolnDir = obj["wholeIXSolnDir"].numberInt();
+        scd->indexFilterApplied = obj["indexFilterApplied"].trueValue();
+
+        BSONElement treeElt = obj["tree"];
+        if (!treeElt.eoo()) {
+            if (!treeElt.isABSONObj()) {
+                return StatusWith<SolutionCacheData*>(ErrorCodes::BadValue,
+                                                      "cached solution tree must be an object");
+            }
+            StatusWith<PlanCacheIndexTree*> tree = indexTreeFromBSON(treeElt.Obj());
+            if (!tree.isOK()) {
+                return StatusWith<SolutionCacheData*>(tree.getStatus());
+            }
+            scd->tree.reset(tree.getValue());
+        }
+
+        if (COLLSCAN_SOLN != scd->solnType && NULL == scd->tree.get()) {
+            return StatusWith<SolutionCacheData*>(ErrorCodes::BadValue,
+                                                  "cached index solution requires a tree");
+        }
+
+        return StatusWith<SolutionCacheData*>(scd.release());
+    }
+
     //
     // PlanCache
     //
@@ -492,6 +685,97 @@ namespace mongo {
         return entries;
     }
 
+    Status PlanCache::importEntry(const BSONObj& entryObj,
+                                  const std::vector<IndexEntry>& currentIndexes) {
+        if (!entryObj["query"].isABSONObj() ||
+            !entryObj["sort"].isABSONObj() ||
+            !entryObj["projection"].isABSONObj()) {
+            return Status(ErrorCodes::BadValue,
+                          "plan cache entry requires query, sort and projection objects");
+        }
+        if (Array != entryObj["plannerData"].type()) {
+            return Status(ErrorCodes::BadValue, "plan cache entry requires a plannerData array");
+        }
+
+        // Re-canonicalize the stored shape so that the cache key is computed by this server
+        // rather than trusted from the one that exported the entry.
+        CanonicalQuery* cqRaw;
+        Status cqStatus = CanonicalQuery::canonicalize(_ns,
+                                                       entryObj["query"].Obj(),
+                                                       entryObj["sort"].Obj(),
+                                                       entryObj["projection"].Obj(),
+                                                       &cqRaw);
+        if (!cqStatus.isOK()) {
+            return cqStatus;
+        }
+        boost::scoped_ptr<CanonicalQuery> cq(cqRaw);
+
+        OwnedPointerVector<SolutionCacheData> solnData;
+        BSONObjIterator planIt(entryObj["plannerData"].Obj());
+        while (planIt.more()) {
+            BSONElement planElt = planIt.next();
+            if (!planElt.isABSONObj()) {
+                return Status(ErrorCodes::BadValue, "plannerData entries must be objects");
+            }
+            StatusWith<SolutionCacheData*> swScd = SolutionCacheData::fromBSON(planElt.Obj());
+            if (!swScd.isOK()) {
+                return swScd.getStatus();
+            }
+            SolutionCacheData* scd = swScd.getValue();
+            solnData.mutableVector().push_back(scd);
+
+            if (NULL != scd->tree.get()) {
+                Status indexStatus = validateIndexTree(scd->tree.get(), currentIndexes);
+                if (!indexStatus.isOK()) {
+                    return indexStatus;
+                }
+            }
+        }
+        if (solnData.empty()) {
+            return Status(ErrorCodes::BadValue, "plan cache entry has no plans");
+        }
+
+        std::auto_ptr<PlanCacheEntry> entry(new PlanCacheEntry());
+        entry->plannerData.swap(solnData.mutableVector());
+        entry->query = entryObj["query"].Obj().getOwned();
+        entry->sort = entryObj["sort"].Obj().getOwned();
+        entry->projection = entryObj["projection"].Obj().getOwned();
+
+        BSONElement backupElt = entryObj["backupSoln"];
+        if (backupElt.isNumber()) {
+            const size_t backup = static_cast<size_t>(backupElt.numberLong());
+            if (backup >= entry->plannerData.size()) {
+                return Status(ErrorCodes::BadValue, "backupSoln out of range");
+            }
+            entry->backupSoln.reset(backup);
+        }
+
+        // We have no performance data from this server for the imported plans, but consumers
+        // of the entry (planCacheListPlans, explain) expect a ranking decision with one stats
+        // and score entry per plan.  Synthesize one that preserves the exported plan order;
+        // feedback gathered as the plans run re-scores them as usual.
+        std::auto_ptr<PlanRankingDecision> why(new PlanRankingDecision());
+        const size_t numPlans = entry->plannerData.size();
+        for (size_t i = 0; i < numPlans; ++i) {
+            why->stats.mutableVector().push_back(
+                new PlanStageStats(CommonStats("IMPORTED"), STAGE_UNKNOWN));
+            why->scores.push_back(static_cast<double>(numPlans - i));
+            why->candidateOrder.push_back(i);
+        }
+        entry->decision.reset(why.release());
+
+        boost::lock_guard<boost::mutex> cacheLock(_cacheMutex);
+        std::auto_ptr<PlanCacheEntry> evictedEntry =
+            _cache.add(cq->getPlanCacheKey(), entry.release());
+        if (NULL != evictedEntry.get()) {
+            LOG(1) << _ns << ": plan cache maximum size exceeded - "
+                   << "removed least recently used entry "
+                   << evictedEntry->toString();
+        }
+
+        return Status::OK();
+    }
+
     bool PlanCache::contains(const CanonicalQuery& cq) const {
         boost::lock_guard<boost::mutex> cacheLock(_cacheMutex);
         return _cache.hasKey(cq.getPlanCacheKey());
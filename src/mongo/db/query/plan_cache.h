@@ -33,6 +33,7 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/thread/mutex.hpp>
 
+#include "mongo/base/status_with.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/index_tag.h"
@@ -136,6 +137,14 @@ namespace mongo {
         // For debugging.
         std::string toString() const;
 
+        /**
+         * Serialization for the on-disk plan cache catalog (see planCacheExport /
+         * planCacheImport).  fromBSON() rebuilds from toBSON() output; the caller owns the
+         * returned pointer.
+         */
+        BSONObj toBSON() const;
+        static StatusWith<SolutionCacheData*> fromBSON(const BSONObj& obj);
+
         // Owned here. If 'wholeIXSoln' is false, then 'tree'
         // can be used to tag an isomorphic match expression. If 'wholeIXSoln'
         // is true, then 'tree' is used to store the relevant IndexEntry.
@@ -205,6 +214,10 @@ namespace mongo {
     class PlanCacheEntry {
     private:
         MONGO_DISALLOW_COPYING(PlanCacheEntry);
+
+        // For PlanCache::importEntry, which fills the fields in from serialized form.
+        PlanCacheEntry();
+        friend class PlanCache;
     public:
         /**
          * Create a new PlanCacheEntry.
@@ -224,6 +237,13 @@ namespace mongo {
         // For debugging.
         std::string toString() const;
 
+        /**
+         * Serialize the query shape and planner data so the entry can be stashed in an
+         * on-disk catalog and reimported after restart (see PlanCache::importEntry).
+         * Performance stats and feedback are not preserved.
+         */
+        BSONObj toBSON() const;
+
         //
         // Planner data
         //
@@ -369,6 +389,16 @@ namespace mongo {
          */
         std::vector<PlanCacheEntry*> getAllEntries() const;
 
+        /**
+         * Restores an entry previously serialized with PlanCacheEntry::toBSON, e.g. from an
+         * on-disk catalog written before a restart.  Every index the entry's plans refer to
+         * must still exist in 'currentIndexes' with the same name and key pattern; multikey
+         * and sparse state is refreshed from the catalog's current view rather than trusted
+         * from the serialized form.  Entries that no longer line up with the indexes are
+         * rejected with BadValue.
+         */
+        Status importEntry(const BSONObj& entryObj, const std::vector<IndexEntry>& currentIndexes);
+
         /**
          * Returns true if there is an entry in the cache for the 'query'.
          * Internally calls hasKey() on the LRU cache.
@@ -422,6 +422,63 @@ namespace {
         ASSERT_EQUALS(planCache.size(), 1U);
     }
 
+    // An exported entry can be imported into a fresh cache (e.g. after a restart) when the
+    // indexes it references still exist in the catalog.
+    TEST(PlanCacheTest, ImportExportedEntry) {
+        PlanCache planCache(ns);
+        auto_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+        QuerySolution qs;
+        qs.cacheData.reset(new SolutionCacheData());
+        qs.cacheData->solnType = SolutionCacheData::USE_INDEX_TAGS_SOLN;
+        qs.cacheData->tree.reset(new PlanCacheIndexTree());
+        qs.cacheData->tree->setIndexEntry(IndexEntry(BSON("a" << 1), false, false, "a_1",
+                                                     BSONObj()));
+        std::vector<QuerySolution*> solns;
+        solns.push_back(&qs);
+        ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+
+        PlanCacheEntry* entryRaw;
+        ASSERT_OK(planCache.getEntry(*cq, &entryRaw));
+        boost::scoped_ptr<PlanCacheEntry> entry(entryRaw);
+        BSONObj serialized = entry->toBSON();
+
+        std::vector<IndexEntry> indexes;
+        indexes.push_back(IndexEntry(BSON("a" << 1), false, false, "a_1", BSONObj()));
+
+        PlanCache importedCache(ns);
+        ASSERT_OK(importedCache.importEntry(serialized, indexes));
+        ASSERT_TRUE(importedCache.contains(*cq));
+        ASSERT_EQUALS(importedCache.size(), 1U);
+    }
+
+    // Importing an entry that references an index missing from the current catalog must fail
+    // rather than cache an unplannable solution.
+    TEST(PlanCacheTest, ImportEntryWithMissingIndexFails) {
+        PlanCache planCache(ns);
+        auto_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+        QuerySolution qs;
+        qs.cacheData.reset(new SolutionCacheData());
+        qs.cacheData->solnType = SolutionCacheData::USE_INDEX_TAGS_SOLN;
+        qs.cacheData->tree.reset(new PlanCacheIndexTree());
+        qs.cacheData->tree->setIndexEntry(IndexEntry(BSON("a" << 1), false, false, "a_1",
+                                                     BSONObj()));
+        std::vector<QuerySolution*> solns;
+        solns.push_back(&qs);
+        ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+
+        PlanCacheEntry* entryRaw;
+        ASSERT_OK(planCache.getEntry(*cq, &entryRaw));
+        boost::scoped_ptr<PlanCacheEntry> entry(entryRaw);
+        BSONObj serialized = entry->toBSON();
+
+        // The catalog no longer has the a_1 index.
+        std::vector<IndexEntry> indexes;
+
+        PlanCache importedCache(ns);
+        ASSERT_NOT_OK(importedCache.importEntry(serialized, indexes));
+        ASSERT_EQUALS(importedCache.size(), 0U);
+    }
+
     /**
      * Each test in the CachePlanSelectionTest suite goes through
      * the following flow:
@@ -40,6 +40,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/global_environment_experiment.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 
 #include "mongo/util/stacktrace.h"
@@ -151,7 +152,10 @@ namespace mongo {
           _qs(qs),
           _root(rt),
           _ns(ns),
-          _killed(false) {
+          _killed(false),
+          _batchPos(0),
+          _pendingCode(PlanStage::ADVANCED),
+          _pendingId(WorkingSet::INVALID_ID) {
         // We may still need to initialize _ns from either _collection or _cq.
         if (!_ns.empty()) {
             // We already have an _ns set, so there's nothing more to do.
@@ -270,6 +274,18 @@ namespace mongo {
 
     void PlanExecutor::invalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) {
         if (!_killed) { _root->invalidate(txn, dl, type); }
+
+        // Any batched results are no longer owned by a stage, so the stage tree above can't
+        // fix them up for us. Force-fetch any member that refers to the invalidated record.
+        for (size_t i = _batchPos; i < _batch.size(); ++i) {
+            if (WorkingSet::INVALID_ID == _batch[i]) {
+                continue;
+            }
+            WorkingSetMember* member = _workingSet->get(_batch[i]);
+            if (member->hasLoc() && member->loc == dl) {
+                WorkingSetCommon::fetchAndInvalidateLoc(txn, member, _collection);
+            }
+        }
     }
 
     PlanExecutor::ExecState PlanExecutor::getNext(BSONObj* objOut, RecordId* dlOut) {
@@ -302,7 +318,36 @@ namespace mongo {
             fetcher.reset();
 
             WorkingSetID id = WorkingSet::INVALID_ID;
-            PlanStage::StageState code = _root->work(&id);
+            PlanStage::StageState code;
+
+            if (_batchPos < _batch.size()) {
+                // Drain results batched up by a previous call before doing more work.
+                code = PlanStage::ADVANCED;
+                id = _batch[_batchPos++];
+            }
+            else if (PlanStage::ADVANCED != _pendingCode) {
+                // The last batch ended with a state we deferred while draining its results;
+                // act on it now that the batch is empty.
+                code = _pendingCode;
+                id = _pendingId;
+                _pendingCode = PlanStage::ADVANCED;
+                _pendingId = WorkingSet::INVALID_ID;
+            }
+            else {
+                _batch.clear();
+                _batchPos = 0;
+                code = _root->workBatch(internalQueryExecBatchSize, &_batch, &id);
+                if (!_batch.empty()) {
+                    if (PlanStage::ADVANCED != code) {
+                        // The batch ended on a non-ADVANCED state. Defer it until the
+                        // results in hand have been returned.
+                        _pendingCode = code;
+                        _pendingId = id;
+                    }
+                    code = PlanStage::ADVANCED;
+                    id = _batch[_batchPos++];
+                }
+            }
 
             if (PlanStage::ADVANCED == code) {
                 // Fast count.
@@ -378,7 +423,15 @@ namespace mongo {
     }
 
     bool PlanExecutor::isEOF() {
-        return _killed || _root->isEOF();
+        if (_killed) {
+            return true;
+        }
+        // Batched results not yet handed out by getNext() keep us from being EOF even if the
+        // stage tree is exhausted.
+        if (_batchPos < _batch.size() || PlanStage::ADVANCED != _pendingCode) {
+            return false;
+        }
+        return _root->isEOF();
     }
 
     void PlanExecutor::registerExec() {
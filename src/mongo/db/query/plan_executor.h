@@ -31,6 +31,7 @@
 #include <boost/scoped_ptr.hpp>
 
 #include "mongo/base/status.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/query/query_solution.h"
 
@@ -394,6 +395,18 @@ namespace mongo {
         // we'll be killed.
         bool _killed;
 
+        // Results batched up by the root stage (see PlanStage::workBatch) but not yet handed
+        // out by getNext(). getNext() drains '_batch' starting at '_batchPos' before asking
+        // the root stage for more. Members referenced here are owned by the working set and
+        // are fixed up directly on invalidate(), since no stage holds them any longer.
+        std::vector<WorkingSetID> _batch;
+        size_t _batchPos;
+
+        // When the root stage ends a batch with a state other than ADVANCED while the batch
+        // still holds results, that state is deferred here until the batch is drained.
+        PlanStage::StageState _pendingCode;
+        WorkingSetID _pendingId;
+
         // If the yield policy is YIELD_AUTO, this is used to enforce automatic yielding. The plan
         // may yield on any call to getNext() if this is non-NULL.
         boost::scoped_ptr<PlanYieldPolicy> _yieldPolicy;
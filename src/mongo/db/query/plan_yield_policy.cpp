@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/db/query/plan_yield_policy.h"
 
 #include "mongo/db/operation_context.h"
@@ -37,12 +39,14 @@
 namespace mongo {
 
     PlanYieldPolicy::PlanYieldPolicy(PlanExecutor* exec)
-        : _elapsedTracker(internalQueryExecYieldIterations, internalQueryExecYieldPeriodMS),
+        : _intervalGrowth(1),
+          _elapsedTracker(new ElapsedTracker(internalQueryExecYieldIterations,
+                                             internalQueryExecYieldPeriodMS)),
           _planYielding(exec) { }
 
     bool PlanYieldPolicy::shouldYield() {
         invariant(!_planYielding->getOpCtx()->lockState()->inAWriteUnitOfWork());
-        return _elapsedTracker.intervalHasElapsed();
+        return _elapsedTracker->intervalHasElapsed();
     }
 
     bool PlanYieldPolicy::yield(RecordFetcher* fetcher) {
@@ -66,7 +70,29 @@ namespace mongo {
         // Release and reacquire locks.
         QueryYield::yieldAllLocks(opCtx, fetcher);
 
-        _elapsedTracker.resetLastTime();
+        // Adapt the yield frequency to what the storage engine has been telling us.  A
+        // fetch-driven yield means the plan is faulting, so return to the aggressive
+        // knob-configured interval; a timer-driven yield on a plan that has not faulted
+        // means the data is in cache, so stretch the work-count interval and make the
+        // next yield cheaper to reach less often.
+        int newGrowth = _intervalGrowth;
+        if (NULL != fetcher) {
+            newGrowth = 1;
+        }
+        else if (_intervalGrowth < internalQueryExecYieldMaxIntervalGrowth) {
+            newGrowth = std::min(_intervalGrowth * 2,
+                                 internalQueryExecYieldMaxIntervalGrowth);
+        }
+
+        if (newGrowth != _intervalGrowth) {
+            _intervalGrowth = newGrowth;
+            _elapsedTracker.reset(
+                    new ElapsedTracker(internalQueryExecYieldIterations * _intervalGrowth,
+                                       internalQueryExecYieldPeriodMS));
+        }
+        else {
+            _elapsedTracker->resetLastTime();
+        }
 
         return _planYielding->restoreState(opCtx);
     }
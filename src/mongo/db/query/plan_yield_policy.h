@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/scoped_ptr.hpp>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/util/elapsed_tracker.h"
@@ -64,7 +66,17 @@ namespace mongo {
         // Default constructor disallowed in order to ensure initialization of '_planYielding'.
         PlanYieldPolicy();
 
-        ElapsedTracker _elapsedTracker;
+        // Multiplies the knob-configured work-count interval between yields.  Doubled after
+        // every yield the storage engine did not ask for (the plan is running from cache,
+        // so save/restore cycles are pure overhead), up to
+        // internalQueryExecYieldMaxIntervalGrowth; reset to one as soon as a yield is taken
+        // to page in a record.  The millisecond backstop is never stretched, so fairness to
+        // other operations is retained.
+        int _intervalGrowth;
+
+        // Rebuilt whenever _intervalGrowth changes, since the tracker's thresholds are
+        // fixed at construction.
+        boost::scoped_ptr<ElapsedTracker> _elapsedTracker;
 
         // The plan executor which this yield policy is responsible for yielding. Must
         // not outlive the plan executor.
@@ -36,6 +36,7 @@
 #include "mongo/db/index_names.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_text.h"
 #include "mongo/db/query/indexability.h"
 #include "mongo/db/query/index_tag.h"
@@ -72,6 +73,149 @@ namespace mongo {
         return ret;
     }
 
+    /**
+     * Returns true if 'elt' is a constant for which a single woCompare tells the whole
+     * matching story.  Comparisons involving arrays, null, and undefined have additional
+     * match semantics (traversal, missing fields) that the implication check below must
+     * not reason about.
+     */
+    static bool isSimpleComparisonConstant(const BSONElement& elt) {
+        return Array != elt.type() && jstNULL != elt.type() && Undefined != elt.type();
+    }
+
+    /**
+     * Returns true if every document matched by the leaf predicate 'queryPred' is also matched
+     * by 'filterPred', one predicate of a partial index's filter.  This check is conservative:
+     * returning false merely keeps the planner from considering the partial index.
+     */
+    static bool predicateImpliesFilterPredicate(const MatchExpression* queryPred,
+                                                const MatchExpression* filterPred) {
+        if (queryPred->equivalent(filterPred)) {
+            return true;
+        }
+
+        const MatchExpression::MatchType queryType = queryPred->matchType();
+        const MatchExpression::MatchType filterType = filterPred->matchType();
+
+        const bool queryIsComparison = MatchExpression::EQ == queryType
+                                    || MatchExpression::LT == queryType
+                                    || MatchExpression::LTE == queryType
+                                    || MatchExpression::GT == queryType
+                                    || MatchExpression::GTE == queryType;
+
+        if (!queryIsComparison && MatchExpression::MATCH_IN != queryType) {
+            return false;
+        }
+
+        const LeafMatchExpression* queryLeaf =
+            static_cast<const LeafMatchExpression*>(queryPred);
+
+        const bool filterIsRelevantLeaf = MatchExpression::EQ == filterType
+                                       || MatchExpression::LT == filterType
+                                       || MatchExpression::LTE == filterType
+                                       || MatchExpression::GT == filterType
+                                       || MatchExpression::GTE == filterType
+                                       || MatchExpression::MATCH_IN == filterType
+                                       || MatchExpression::EXISTS == filterType;
+
+        if (!filterIsRelevantLeaf) {
+            return false;
+        }
+
+        const LeafMatchExpression* filterLeaf =
+            static_cast<const LeafMatchExpression*>(filterPred);
+
+        if (queryLeaf->path() != filterLeaf->path()) {
+            return false;
+        }
+
+        if (queryIsComparison) {
+            const BSONElement bound =
+                static_cast<const ComparisonMatchExpression*>(queryPred)->getData();
+            if (!isSimpleComparisonConstant(bound)) {
+                return false;
+            }
+
+            // A comparison to a non-null constant only matches documents with the field
+            // present.
+            if (MatchExpression::EXISTS == filterType) {
+                return true;
+            }
+
+            if (MatchExpression::EQ == queryType) {
+                // {path: c} implies any filter predicate that c itself satisfies.
+                return filterLeaf->matchesSingleElement(bound);
+            }
+
+            // A one-sided range implies a looser range on the same side iff the stricter
+            // bound satisfies the looser predicate.
+            if (MatchExpression::GT == queryType || MatchExpression::GTE == queryType) {
+                return (MatchExpression::GT == filterType ||
+                        MatchExpression::GTE == filterType)
+                    && filterLeaf->matchesSingleElement(bound);
+            }
+            return (MatchExpression::LT == filterType || MatchExpression::LTE == filterType)
+                && filterLeaf->matchesSingleElement(bound);
+        }
+
+        // $in: every literal in the list must satisfy the filter predicate.
+        const ArrayFilterEntries& entries =
+            static_cast<const InMatchExpression*>(queryPred)->getData();
+        if (entries.numRegexes() > 0 || entries.equalities().empty()) {
+            return false;
+        }
+        for (BSONElementSet::const_iterator it = entries.equalities().begin();
+             it != entries.equalities().end();
+             ++it) {
+            if (!isSimpleComparisonConstant(*it)) {
+                return false;
+            }
+            if (MatchExpression::EXISTS != filterType &&
+                !filterLeaf->matchesSingleElement(*it)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Returns true if every document matched by 'queryExpr' is also matched by 'filterExpr',
+     * the filter of a partial index.
+     */
+    static bool queryImpliesFilter(const MatchExpression* queryExpr,
+                                   const MatchExpression* filterExpr) {
+        // Every predicate of the filter must be implied separately.
+        if (MatchExpression::AND == filterExpr->matchType()) {
+            for (size_t i = 0; i < filterExpr->numChildren(); ++i) {
+                if (!queryImpliesFilter(queryExpr, filterExpr->getChild(i))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Any one conjunct of the query restricting the result set suffices.
+        if (MatchExpression::AND == queryExpr->matchType()) {
+            for (size_t i = 0; i < queryExpr->numChildren(); ++i) {
+                if (predicateImpliesFilterPredicate(queryExpr->getChild(i), filterExpr)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        return predicateImpliesFilterPredicate(queryExpr, filterExpr);
+    }
+
+    // static
+    bool QueryPlannerIXSelect::canUseFilteredIndex(const MatchExpression* queryExpr,
+                                                   const IndexEntry& index) {
+        if (NULL == index.filterExpr) {
+            return true;
+        }
+        return queryImpliesFilter(queryExpr, index.filterExpr);
+    }
+
     // static
     void QueryPlannerIXSelect::getFields(MatchExpression* node,
                                          string prefix,
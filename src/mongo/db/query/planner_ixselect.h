@@ -56,6 +56,16 @@ namespace mongo {
                                         const std::vector<IndexEntry>& indices,
                                         std::vector<IndexEntry>* out);
 
+        /**
+         * Return true if 'index' can answer 'queryExpr'.  A complete index always can; a
+         * partial index only contains documents matching its filter expression, so it can only
+         * be used when the query provably selects a subset of those documents.  The implication
+         * check is conservative and only reasons about top-level comparison, $in and $exists
+         * predicates.
+         */
+        static bool canUseFilteredIndex(const MatchExpression* queryExpr,
+                                        const IndexEntry& index);
+
         /**
          * Return true if the index key pattern field 'elt' (which belongs to 'index') can be used
          * to answer the predicate 'node'.
@@ -38,6 +38,8 @@ namespace mongo {
 
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationEarlyExitLead, double, 3.0);
+
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
@@ -62,10 +64,18 @@ namespace mongo {
 
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxIntervalsPerBoundsField, int, 1000);
+
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
 
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecBatchSize, int, 16);
+
     // Yield every 128 cycles or 10ms.
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
     MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+    // A plan that never yields to fetch a record may check in up to 1024 times less
+    // often, leaving the 10ms period as the only trigger.
+    MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldMaxIntervalGrowth, int, 1024);
+
 }  // namespace mongo
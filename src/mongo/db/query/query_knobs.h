@@ -45,6 +45,11 @@ namespace mongo {
     // Stop working plans once a plan returns this many results.
     extern int internalQueryPlanEvaluationMaxResults;
 
+    // Stop the plan evaluation trial period early once the leading plan is ahead of the
+    // runner-up by more than this many times sqrt(rounds worked) results. Set to zero or
+    // a negative value to always run the full trial period.
+    extern double internalQueryPlanEvaluationEarlyExitLead;
+
     // Do we give a big ranking bonus to intersection plans?
     extern bool internalQueryForceIntersectionPlans;
 
@@ -92,16 +97,30 @@ namespace mongo {
     // during explodeForSort?
     extern int internalQueryMaxScansToExplode;
 
+    // Cap on the number of intervals the bounds builder keeps for a single indexed field.
+    // Past the cap the field's bounds degrade to a full scan of that field with the
+    // predicate applied after fetching, rather than burning planner CPU merging thousands
+    // of intervals.
+    extern int internalQueryMaxIntervalsPerBoundsField;
+
     //
     // Query execution.
     //
 
     extern int internalQueryExecMaxBlockingSortBytes;
 
+    // How many results the executor asks the root stage to batch up per workBatch() call.
+    extern int internalQueryExecBatchSize;
+
     // Yield after this many "should yield?" checks.
     extern int internalQueryExecYieldIterations;
 
     // Yield if it's been at least this many milliseconds since we last yielded.
     extern int internalQueryExecYieldPeriodMS;
 
+    // Upper bound on the factor by which the yield policy may stretch the
+    // iterations-between-yields interval for plans that are not faulting.  The
+    // millisecond period above is never stretched.
+    extern int internalQueryExecYieldMaxIntervalGrowth;
+
 }  // namespace mongo
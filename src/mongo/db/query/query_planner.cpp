@@ -546,6 +546,20 @@ namespace mongo {
 
         if (hintIndex.isEmpty()) {
             QueryPlannerIXSelect::findRelevantIndices(fields, params.indices, &relevantIndices);
+
+            // A partial index only contains documents matching its filter expression; it can
+            // only answer queries that provably select a subset of those documents.
+            for (size_t i = 0; i < relevantIndices.size();) {
+                if (!QueryPlannerIXSelect::canUseFilteredIndex(query.root(),
+                                                               relevantIndices[i])) {
+                    QLOG() << "Partial index " << relevantIndices[i].toString()
+                           << " does not cover the query, discarding." << endl;
+                    relevantIndices.erase(relevantIndices.begin() + i);
+                }
+                else {
+                    ++i;
+                }
+            }
         }
         else {
             // Sigh.  If the hint is specified it might be using the index name.
@@ -580,6 +594,12 @@ namespace mongo {
             if (hintIndexNumber == numeric_limits<size_t>::max()) {
                 return Status(ErrorCodes::BadValue, "bad hint");
             }
+
+            if (!QueryPlannerIXSelect::canUseFilteredIndex(query.root(),
+                                                           params.indices[hintIndexNumber])) {
+                return Status(ErrorCodes::BadValue,
+                              "hinted partial index does not cover the query");
+            }
         }
 
         // Deal with the .min() and .max() query options.  If either exist we can only use an index
@@ -631,6 +651,11 @@ namespace mongo {
                 for (size_t i = 0; i < params.indices.size(); ++i) {
                     const BSONObj& kp = params.indices[i].keyPattern;
 
+                    if (!QueryPlannerIXSelect::canUseFilteredIndex(query.root(),
+                                                                   params.indices[i])) {
+                        continue;
+                    }
+
                     BSONObj toUse = minObj.isEmpty() ? maxObj : minObj;
                     if (indexCompatibleMaxMin(toUse, kp)) {
                         // In order to be fully compatible, the min has to be less than the max
@@ -853,6 +878,11 @@ namespace mongo {
                         continue;
                     }
 
+                    // Like sparse indexes, partial indexes can miss documents the query needs.
+                    if (NULL != index.filterExpr) {
+                        continue;
+                    }
+
                     // TODO: Sparse indexes can't normally provide a sort, because non-indexed
                     // documents could potentially be missing from the result set.  However, if the
                     // query predicate can be used to guarantee that all documents to be returned
@@ -930,6 +960,18 @@ namespace mongo {
             }
         }
 
+        // Whether a partial index covers a query depends on the query's constants, but the plan
+        // cache discriminates queries by shape only.  If a partial index was in play, none of
+        // the resulting plans may be cached.
+        for (size_t i = 0; i < relevantIndices.size(); ++i) {
+            if (NULL != relevantIndices[i].filterExpr) {
+                for (size_t j = 0; j < out->size(); ++j) {
+                    (*out)[j]->cacheData.reset();
+                }
+                break;
+            }
+        }
+
         return Status::OK();
     }
 
@@ -35,6 +35,7 @@
 #include "mongo/db/query/query_planner_test_lib.h"
 
 #include <ostream>
+#include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
@@ -94,6 +95,16 @@ namespace {
             params.indices.push_back(IndexEntry(keyPattern, false, false, "foo", infoObj));
         }
 
+        void addPartialIndex(BSONObj keyPattern, BSONObj filterObj) {
+            StatusWithMatchExpression res = MatchExpressionParser::parse(filterObj);
+            ASSERT_OK(res.getStatus());
+            partialFilters.mutableVector().push_back(res.getValue());
+
+            IndexEntry entry(keyPattern, false, false, "partial_index", BSONObj());
+            entry.filterExpr = res.getValue();
+            params.indices.push_back(entry);
+        }
+
         //
         // Execute planner.
         //
@@ -327,6 +338,9 @@ namespace {
         CanonicalQuery* cq;
         QueryPlannerParams params;
         vector<QuerySolution*> solns;
+
+        // Owns the filter expressions of any partial indexes added via addPartialIndex().
+        OwnedPointerVector<MatchExpression> partialFilters;
     };
 
     //
@@ -3072,6 +3086,68 @@ namespace {
                                 "{filter: null, pattern: {a: 1}}}}}");
     }
 
+    //
+    // Partial indices
+    //
+
+    TEST_F(QueryPlannerTest, PartialIndexCoveringPredicate) {
+        addPartialIndex(fromjson("{a: 1}"), fromjson("{a: {$gt: 0}}"));
+        runQuery(fromjson("{a: 5}"));
+
+        assertNumSolutions(2U);
+        assertSolutionExists("{cscan: {dir: 1, filter: {a: 5}}}");
+        assertSolutionExists("{fetch: {filter: null, node: {ixscan: "
+                                "{filter: null, pattern: {a: 1}}}}}");
+    }
+
+    TEST_F(QueryPlannerTest, PartialIndexNotCoveringPredicate) {
+        addPartialIndex(fromjson("{a: 1}"), fromjson("{a: {$gt: 0}}"));
+        runQuery(fromjson("{a: -5}"));
+
+        assertNumSolutions(1U);
+        assertSolutionExists("{cscan: {dir: 1, filter: {a: -5}}}");
+    }
+
+    TEST_F(QueryPlannerTest, PartialIndexFilterOnOtherField) {
+        addPartialIndex(fromjson("{a: 1}"), fromjson("{status: 'active'}"));
+        runQuery(fromjson("{a: 5, status: 'active'}"));
+
+        assertNumSolutions(2U);
+        assertSolutionExists("{cscan: {dir: 1}}");
+        assertSolutionExists("{fetch: {node: {ixscan: {pattern: {a: 1}}}}}");
+    }
+
+    TEST_F(QueryPlannerTest, PartialIndexFilterConstantMismatch) {
+        addPartialIndex(fromjson("{a: 1}"), fromjson("{status: 'active'}"));
+        runQuery(fromjson("{a: 5, status: 'inactive'}"));
+
+        assertNumSolutions(1U);
+        assertSolutionExists("{cscan: {dir: 1}}");
+    }
+
+    TEST_F(QueryPlannerTest, PartialIndexStricterRangeCovers) {
+        addPartialIndex(fromjson("{a: 1}"), fromjson("{a: {$gte: 0}}"));
+        runQuery(fromjson("{a: {$gt: 10}}"));
+
+        assertNumSolutions(2U);
+        assertSolutionExists("{cscan: {dir: 1}}");
+        assertSolutionExists("{fetch: {filter: null, node: {ixscan: "
+                                "{filter: null, pattern: {a: 1}}}}}");
+    }
+
+    TEST_F(QueryPlannerTest, PartialIndexLooserRangeDoesNotCover) {
+        addPartialIndex(fromjson("{a: 1}"), fromjson("{a: {$gt: 10}}"));
+        runQuery(fromjson("{a: {$gt: 0}}"));
+
+        assertNumSolutions(1U);
+        assertSolutionExists("{cscan: {dir: 1}}");
+    }
+
+    TEST_F(QueryPlannerTest, PartialIndexHintRejectedWhenNotCovering) {
+        addPartialIndex(fromjson("{a: 1}"), fromjson("{a: {$gt: 0}}"));
+        runInvalidQueryHint(fromjson("{a: -5}"), fromjson("{a: 1}"));
+    }
+
     //
     // Regex
     //
@@ -82,6 +82,10 @@ namespace mongo {
         STAGE_MULTI_PLAN,
         STAGE_OPLOG_START,
         STAGE_OR,
+
+        // Scans a disjoint subset of a collection's record-store iterators so cooperating
+        // cursors can divide a full scan between them.
+        STAGE_PARTITIONED_COLLSCAN,
         STAGE_PROJECTION,
 
         // Stage for running aggregation pipelines.
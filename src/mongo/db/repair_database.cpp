@@ -51,6 +51,13 @@
 
 namespace mongo {
 namespace {
+    // Records stream through validation and the bulk index builder in batches, each
+    // committed as a single unit of work, so the per-record commit overhead is paid
+    // once per batch instead of once per document.  The byte budget bounds how much
+    // uncommitted work a batch can accumulate.
+    const int kRepairBatchDocs = 1000;
+    const long long kRepairBatchBytes = 16 * 1024 * 1024;
+
     Status rebuildIndexesOnCollection(OperationContext* txn,
                                       DatabaseCatalogEntry* dbce,
                                       const std::string& collectionName) {
@@ -123,28 +130,35 @@ namespace {
         RecordStore* rs = collection->getRecordStore();
         boost::scoped_ptr<RecordIterator> it(rs->getIterator(txn));
         while (!it->isEOF()) {
-            RecordId id = it->curr();
-            RecordData data = it->dataFor(id);
-            invariant(id == it->getNext());
+            int batchDocs = 0;
+            long long batchBytes = 0;
 
-            Status status = validateBSON(data.data(), data.size());
-            if (!status.isOK()) {
-                log() << "Invalid BSON detected at " << id << ": " << status << ". Deleting.";
-                it->saveState();
-                {
-                    WriteUnitOfWork wunit(txn);
+            WriteUnitOfWork wunit(txn);
+            while (!it->isEOF() &&
+                   batchDocs < kRepairBatchDocs &&
+                   batchBytes < kRepairBatchBytes) {
+                RecordId id = it->curr();
+                RecordData data = it->dataFor(id);
+                invariant(id == it->getNext());
+
+                Status status = validateBSON(data.data(), data.size());
+                if (!status.isOK()) {
+                    log() << "Invalid BSON detected at " << id << ": " << status
+                          << ". Deleting.";
+                    it->saveState();
                     rs->deleteRecord(txn, id);
-                    wunit.commit();
+                    it->restoreState(txn);
+                    continue;
                 }
-                it->restoreState(txn);
-                continue;
-            }
 
-            // Now index the record.
-            // TODO SERVER-14812 add a mode that drops duplicates rather than failing
-            WriteUnitOfWork wunit(txn);
-            status = indexer->insert(data.releaseToBson(), id);
-            if (!status.isOK()) return status;
+                batchDocs++;
+                batchBytes += data.size();
+
+                // Now index the record.
+                // TODO SERVER-14812 add a mode that drops duplicates rather than failing
+                status = indexer->insert(data.releaseToBson(), id);
+                if (!status.isOK()) return status;
+            }
             wunit.commit();
         }
 
@@ -33,6 +33,7 @@
 #include "mongo/db/repl/bgsync.h"
 
 #include "mongo/base/counter.h"
+#include "mongo/base/init.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync.h"
@@ -44,6 +45,7 @@
 #include "mongo/db/repl/repl_coordinator_impl.h"
 #include "mongo/db/repl/rs_rollback.h"
 #include "mongo/db/repl/rs_sync.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
@@ -91,6 +93,22 @@ namespace {
     static ServerStatusMetricField<int> displayBufferMaxSize( "repl.buffer.maxSizeBytes",
                                                                 &bufferMaxSizeGauge );
 
+    // Byte budget for the fetch buffer between the sync source and the applier.
+    // A deeper buffer lets the network fetch run far ahead of apply, which keeps
+    // high-latency (cross-DC) links busy through apply stalls.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replBufferMaxSizeBytes, int, 256*1024*1024);
+
+    MONGO_INITIALIZER_GENERAL(ReplBufferSizeBounds,
+                              ("EndStartupOptionHandling"),
+                              ("default"))(InitializerContext* context) {
+        if (replBufferMaxSizeBytes < 1*1024*1024) {
+            return Status(ErrorCodes::BadValue,
+                          "replBufferMaxSizeBytes must be at least 1MB");
+        }
+        bufferMaxSizeGauge = replBufferMaxSizeBytes;
+        return Status::OK();
+    }
+
 
     BackgroundSyncInterface::~BackgroundSyncInterface() {}
 
@@ -327,9 +345,29 @@ namespace {
             }
 
             // At this point, we are guaranteed to have at least one thing to read out
-            // of the oplogreader cursor.
-            BSONObj o = _syncSourceReader.nextSafe().getOwned();
-            opsReadStats.increment();
+            // of the oplogreader cursor.  Drain the rest of the network batch and repackage
+            // it into a single shared buffer; each op handed to the queue (and from there to
+            // the applier) is then a refcounted view into that buffer rather than its own
+            // malloc'd copy.
+            std::vector<BSONObj> batch;
+            int batchBytes = 0;
+            while (_syncSourceReader.moreInCurrentBatch()) {
+                // Unowned; points into the cursor's current network message, which stays
+                // valid until the next receiveMore().
+                BSONObj o = _syncSourceReader.nextSafe();
+                batchBytes += o.objsize();
+                batch.push_back(o);
+            }
+
+            SharedBuffer backing = SharedBuffer::allocate(batchBytes);
+            char* position = backing.get();
+            for (size_t i = 0; i < batch.size(); i++) {
+                memcpy(position, batch[i].objdata(), batch[i].objsize());
+                batch[i] = BSONObj(position, backing);
+                position += batch[i].objsize();
+            }
+
+            opsReadStats.increment(batch.size());
 
             {
                 boost::unique_lock<boost::mutex> lock(_mutex);
@@ -340,14 +378,20 @@ namespace {
                 LOG(2) << "bgsync buffer has " << _buffer.size() << " bytes";
             }
 
-            bufferCountGauge.increment();
-            bufferSizeGauge.increment(getSize(o));
-            _buffer.push(o);
+            for (size_t i = 0; i < batch.size(); i++) {
+                bufferCountGauge.increment();
+                bufferSizeGauge.increment(getSize(batch[i]));
+            }
+
+            // Publishes the whole network batch with a single consumer wakeup; if the
+            // buffer fills mid-batch the queue parks us until the applier drains it.
+            _buffer.pushBatch(batch.begin(), batch.end());
 
             {
+                const BSONObj& last = batch.back();
                 boost::unique_lock<boost::mutex> lock(_mutex);
-                _lastFetchedHash = o["h"].numberLong();
-                _lastOpTimeFetched = o["ts"]._opTime();
+                _lastFetchedHash = last["h"].numberLong();
+                _lastOpTimeFetched = last["ts"]._opTime();
                 LOG(3) << "replSet lastOpTimeFetched: " << _lastOpTimeFetched.toStringPretty();
             }
         }
@@ -359,9 +403,23 @@ namespace {
             return true;
         }
 
-        // check other members: is any member's optime more than MaxSyncSourceLag seconds 
-        // ahead of the current sync source?
-        return _replCoord->shouldChangeSyncSource(_syncSourceReader.getHost());
+        OpTime lastOpTimeFetched;
+        {
+            boost::unique_lock<boost::mutex> lock(_mutex);
+            lastOpTimeFetched = _lastOpTimeFetched;
+        }
+
+        // check other members: is any member's optime more than MaxSyncSourceLag seconds
+        // ahead of the current sync source, or is the current sync source feeding us ops
+        // more than MaxSyncSourceLag seconds behind its own optime?
+        if (_replCoord->shouldChangeSyncSource(_syncSourceReader.getHost(), lastOpTimeFetched)) {
+            // Blacklist the old sync source briefly so that the next selection, which favors
+            // the lowest-ping candidate, doesn't immediately pick it again.
+            _replCoord->blacklistSyncSource(_syncSourceReader.getHost(),
+                                            Date_t(curTimeMillis64() + 10*1000));
+            return true;
+        }
+        return false;
     }
 
 
@@ -30,7 +30,7 @@
 
 #include <boost/thread/mutex.hpp>
 
-#include "mongo/util/queue.h"
+#include "mongo/util/spsc_queue.h"
 #include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/jsobj.h"
 
@@ -121,8 +121,9 @@ namespace repl {
         // protects creation of s_instance
         static boost::mutex s_mutex;
 
-        // Production thread
-        BlockingQueue<BSONObj> _buffer;
+        // Filled by the production thread, drained by the applier's batcher thread;
+        // other threads only observe empty()/size(), which the queue allows.
+        SingleProducerSingleConsumerQueue<BSONObj> _buffer;
         OplogReader _syncSourceReader;
 
         // _mutex protects all of the class variables except _syncSourceReader and _buffer
@@ -98,52 +98,69 @@ namespace {
 
 
     /**
-     * Allocates an optime for a new entry in the oplog, and updates the replication coordinator to
-     * reflect that new optime.  Returns the new optime and the correct value of the "h" field for
-     * the new oplog entry.
+     * Allocates optimes for "count" new entries in the oplog, and updates the replication
+     * coordinator to reflect the last of them.  Fills in "slotsOut" with the new optimes and the
+     * correct values of the "h" field for the new oplog entries; the optimes form one contiguous
+     * sequence with no other writer interleaved.
      *
-     * NOTE: From the time this function returns to the time that the new oplog entry is written
-     * to the storage system, all errors must be considered fatal.  This is because the this
-     * function registers the new optime with the storage system and the replication coordinator,
-     * and provides no facility to revert those registrations on rollback.
+     * NOTE: From the time this function returns to the time that the new oplog entries are
+     * written to the storage system, all errors must be considered fatal.  This is because the
+     * this function registers the new optimes with the storage system and the replication
+     * coordinator, and provides no facility to revert those registrations on rollback.
      */
-    std::pair<OpTime, long long> getNextOpTime(OperationContext* txn,
-                                               Collection* oplog,
-                                               const char* ns,
-                                               ReplicationCoordinator* replCoord,
-                                               const char* opstr) {
+    void getNextOpTimes(OperationContext* txn,
+                        Collection* oplog,
+                        const char* ns,
+                        ReplicationCoordinator* replCoord,
+                        const char* opstr,
+                        size_t count,
+                        std::pair<OpTime, long long>* slotsOut) {
+        invariant(count > 0);
         mutex::scoped_lock lk(newOpMutex);
-        OpTime ts = getNextGlobalOptime();
-        newOptimeNotifier.notify_all();
 
-        fassert(28560, oplog->getRecordStore()->oplogDiskLocRegister(txn, ts));
+        const bool replSet =
+            replCoord->getReplicationMode() == ReplicationCoordinator::modeReplSet;
+        long long hashNew = replSet ? BackgroundSync::get()->getLastAppliedHash() : 0;
 
-        long long hashNew;
+        for (size_t i = 0; i < count; i++) {
+            OpTime ts = getNextGlobalOptime();
 
-        if (replCoord->getReplicationMode() == ReplicationCoordinator::modeReplSet) {
+            fassert(28560, oplog->getRecordStore()->oplogDiskLocRegister(txn, ts));
 
-            hashNew = BackgroundSync::get()->getLastAppliedHash();
+            if (replSet) {
+                // Check to make sure logOp() is legal at this point.
+                if (*opstr == 'n') {
+                    // 'n' operations are always logged
+                    invariant(*ns == '\0');
 
-            // Check to make sure logOp() is legal at this point.
-            if (*opstr == 'n') {
-                // 'n' operations are always logged
-                invariant(*ns == '\0');
-
-                // 'n' operations do not advance the hash, since they are not rolled back
+                    // 'n' operations do not advance the hash, since they are not rolled back
+                }
+                else {
+                    // Advance the hash
+                    hashNew = (hashNew * 131 + ts.asLL()) * 17 + replCoord->getMyId();
+                }
             }
-            else {
-                // Advance the hash
-                hashNew = (hashNew * 131 + ts.asLL()) * 17 + replCoord->getMyId();
 
-                BackgroundSync::get()->setLastAppliedHash(hashNew);
-            }
+            slotsOut[i] = std::pair<OpTime,long long>(ts, hashNew);
         }
-        else {
-            hashNew = 0;
+
+        if (replSet && *opstr != 'n') {
+            BackgroundSync::get()->setLastAppliedHash(hashNew);
         }
 
-        replCoord->setMyLastOptime(ts);
-        return std::pair<OpTime,long long>(ts, hashNew);
+        newOptimeNotifier.notify_all();
+
+        replCoord->setMyLastOptime(slotsOut[count - 1].first);
+    }
+
+    std::pair<OpTime, long long> getNextOpTime(OperationContext* txn,
+                                               Collection* oplog,
+                                               const char* ns,
+                                               ReplicationCoordinator* replCoord,
+                                               const char* opstr) {
+        std::pair<OpTime, long long> slot;
+        getNextOpTimes(txn, oplog, ns, replCoord, opstr, 1, &slot);
+        return slot;
     }
 
     /**
@@ -274,6 +291,67 @@ namespace {
 
     }
 
+    void _logOpsRS(OperationContext* txn,
+                   const char *opstr,
+                   const char *ns,
+                   const std::vector<BSONObj>& objs,
+                   bool fromMigrate ) {
+        if ( strncmp(ns, "local.", 6) == 0 ) {
+            return;
+        }
+
+        ScopedTransaction transaction(txn, MODE_IX);
+        Lock::DBLock lk(txn->lockState(), "local", MODE_IX);
+        Lock::CollectionLock lk2(txn->lockState(), rsoplog, MODE_IX);
+
+        if ( localOplogRSCollection == 0 ) {
+            Client::Context ctx(txn, rsoplog);
+            localDB = ctx.db();
+            invariant( localDB );
+            localOplogRSCollection = localDB->getCollection( rsoplog );
+            massert(28639, "local.oplog.rs missing. did you drop it? if so restart server", localOplogRSCollection);
+        }
+
+        ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
+        if (ns && ns[0] && !replCoord->canAcceptWritesForDatabase(nsToDatabaseSubstring(ns))) {
+            severe() << "replSet error : logOps() but can't accept write to collection " << ns;
+            fassertFailed(28640);
+        }
+
+        Client::Context ctx(txn, rsoplog, localDB);
+        WriteUnitOfWork wunit(txn);
+
+        // One pass through the optime allocator for the whole batch, so the entries
+        // land in the oplog as one contiguous run with no other writer interleaved.
+        std::vector< std::pair<OpTime,long long> > slots(objs.size());
+        getNextOpTimes(txn,
+                       localOplogRSCollection,
+                       ns,
+                       replCoord,
+                       opstr,
+                       objs.size(),
+                       &slots[0]);
+
+        for (size_t i = 0; i < objs.size(); i++) {
+            BSONObjBuilder b(256);
+            b.appendTimestamp("ts", slots[i].first.asDate());
+            b.append("h", slots[i].second);
+            b.append("v", OPLOG_VERSION);
+            b.append("op", opstr);
+            b.append("ns", ns);
+            if (fromMigrate)
+                b.appendBool("fromMigrate", true);
+            BSONObj partial = b.done();
+
+            OplogDocWriter writer( partial, objs[i] );
+            checkOplogInsert( localOplogRSCollection->insertDocument( txn, &writer, false ) );
+        }
+
+        ctx.getClient()->setLastOp( slots[objs.size() - 1].first );
+
+        wunit.commit();
+    }
+
     void _logOpOld(OperationContext* txn,
                           const char *opstr,
                           const char *ns,
@@ -339,6 +417,17 @@ namespace {
         wunit.commit();
     }
 
+    // The master/slave oplog has no batched fast path; just log one op at a time.
+    void _logOpsOld(OperationContext* txn,
+                    const char *opstr,
+                    const char *ns,
+                    const std::vector<BSONObj>& objs,
+                    bool fromMigrate ) {
+        for (size_t i = 0; i < objs.size(); i++) {
+            _logOpOld(txn, opstr, ns, 0, objs[i], 0, 0, fromMigrate);
+        }
+    }
+
     void (*_logOp)(OperationContext* txn,
                           const char *opstr,
                           const char *ns,
@@ -347,9 +436,27 @@ namespace {
                           BSONObj *o2,
                           bool *bb,
                           bool fromMigrate ) = _logOpRS;
+
+    void (*_logOps)(OperationContext* txn,
+                           const char *opstr,
+                           const char *ns,
+                           const std::vector<BSONObj>& objs,
+                           bool fromMigrate ) = _logOpsRS;
+
+    // TODO SERVER-15192 remove this once all listeners are rollback-safe.
+    class RollbackPreventer : public RecoveryUnit::Change {
+        virtual void commit() {}
+        virtual void rollback() {
+            severe() << "Rollback of logOp not currently allowed (SERVER-15192)";
+            fassertFailed(18805);
+        }
+    };
 }  // namespace
 
-    void oldRepl() { _logOp = _logOpOld; }
+    void oldRepl() {
+        _logOp = _logOpOld;
+        _logOps = _logOpsOld;
+    }
 
     void logKeepalive(OperationContext* txn) {
         _logOp(txn, "n", "", 0, BSONObj(), 0, 0, false);
@@ -376,14 +483,6 @@ namespace {
                bool* b,
                bool fromMigrate) {
         try {
-            // TODO SERVER-15192 remove this once all listeners are rollback-safe.
-            class RollbackPreventer : public RecoveryUnit::Change {
-                virtual void commit() {}
-                virtual void rollback() {
-                    severe() << "Rollback of logOp not currently allowed (SERVER-15192)";
-                    fassertFailed(18805);
-                }
-            };
             txn->recoveryUnit()->registerChange(new RollbackPreventer());
 
             if ( getGlobalReplicationCoordinator()->isReplEnabled() ) {
@@ -412,6 +511,42 @@ namespace {
         }
     }
 
+    void logOps(OperationContext* txn,
+                const char* opstr,
+                const char* ns,
+                const std::vector<BSONObj>& objs,
+                bool fromMigrate) {
+        try {
+            txn->recoveryUnit()->registerChange(new RollbackPreventer());
+
+            if ( getGlobalReplicationCoordinator()->isReplEnabled() ) {
+                _logOps(txn, opstr, ns, objs, fromMigrate);
+            }
+
+            for (size_t i = 0; i < objs.size(); i++) {
+                logOpForSharding(txn, opstr, ns, objs[i], 0, fromMigrate);
+                logOpForDbHash(ns);
+                getGlobalAuthorizationManager()->logOp(opstr, ns, objs[i], 0, 0);
+            }
+
+            if ( strstr( ns, ".system.js" ) ) {
+                Scope::storedFuncMod(); // this is terrible
+            }
+        }
+        catch (const DBException& ex) {
+            severe() << "Fatal DBException in logOps(): " << ex.toString();
+            std::terminate();
+        }
+        catch (const std::exception& ex) {
+            severe() << "Fatal std::exception in logOps(): " << ex.what();
+            std::terminate();
+        }
+        catch (...) {
+            severe() << "Fatal error in logOps()";
+            std::terminate();
+        }
+    }
+
     /** write an op to the oplog that is already built.
         todo : make _logOpRS() call this so we don't repeat ourself?
 
@@ -30,6 +30,7 @@
 
 #include <cstddef>
 #include <string>
+#include <vector>
 
 namespace mongo {
     class BSONObj;
@@ -79,6 +80,21 @@ namespace repl {
                 bool *b = NULL,
                 bool fromMigrate = false);
 
+    /** Log a batch of operations of the same type against the same namespace to
+        the local oplog with one lock acquisition and one contiguous sequence of
+        optimes, rather than paying the locking and commit overhead per document.
+        Currently only used for vectored inserts ('i'); there is no per-op 'o2'
+        or 'b' field.
+
+        The entries only become durable when the caller's unit of work commits,
+        so this must be the last thing a batch does before committing.
+    */
+    void logOps(OperationContext* txn,
+                const char* opstr,
+                const char* ns,
+                const std::vector<BSONObj>& objs,
+                bool fromMigrate = false);
+
     // Log an empty no-op operation to the local oplog
     void logKeepalive(OperationContext* txn);
 
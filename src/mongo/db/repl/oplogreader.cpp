@@ -82,11 +82,35 @@ namespace repl {
         /* TODO: slaveOk maybe shouldn't use? */
         _tailingQueryOptions |= QueryOption_AwaitData;
 
+        // Stream the oplog in exhaust mode: the sync source pipelines batches on its
+        // own instead of waiting for a getMore per batch, removing a round trip of
+        // dead time between batches. TCP backpressure throttles the source if we
+        // fall behind. The connection is dedicated to the stream while the cursor is
+        // live -- see resetCursor() and findOne() for how one-off queries cope.
+        _tailingQueryOptions |= QueryOption_Exhaust;
+
         readersCreatedStats.increment();
     }
 
+    void OplogReader::resetCursor() {
+        // Abandoning a live exhaust cursor fails the connection (the server keeps
+        // streaming batches until the socket closes), so rebuild it to keep conn()
+        // usable for the one-off queries that typically follow, e.g. during rollback.
+        const bool rebuild = haveExhaustStream();
+        const HostAndPort host = _host;
+        cursor.reset();
+        if (rebuild && !host.empty()) {
+            _conn.reset();
+            _host = HostAndPort();
+            uassert(28725,
+                    str::stream() << "lost connection to sync source " << host.toString()
+                                  << " while dropping exhaust oplog cursor",
+                    connect(host));
+        }
+    }
+
     bool OplogReader::connect(const HostAndPort& host) {
-        if (conn() == NULL || _host != host) {
+        if (conn() == NULL || _host != host || _conn->isFailed()) {
             resetConnection();
             _conn = shared_ptr<DBClientConnection>(new DBClientConnection(false,
                                                                           0,
@@ -67,14 +67,26 @@ namespace repl {
     public:
         OplogReader();
         ~OplogReader() { }
-        void resetCursor() { cursor.reset(); }
+        void resetCursor();
         void resetConnection() {
             cursor.reset();
             _conn.reset();
             _host = HostAndPort();
         }
         DBClientConnection* conn() { return _conn.get(); }
+
+        /* true while the tailing cursor is streaming in exhaust mode; the connection
+           is dedicated to the stream until the cursor is dropped */
+        bool haveExhaustStream() const {
+            return cursor.get() && cursor->isExhaust() && cursor->getCursorId();
+        }
+
         BSONObj findOne(const char *ns, const Query& q) {
+            // a live exhaust stream owns the connection; resetCursor() drops it and
+            // rebuilds the connection so a one-off query can be sent
+            if (haveExhaustStream()) {
+                resetCursor();
+            }
             return conn()->findOne(ns, q, 0, QueryOption_SlaveOk);
         }
         BSONObj getLastOp(const char *ns) {
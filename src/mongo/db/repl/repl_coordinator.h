@@ -541,8 +541,10 @@ namespace repl {
         /**
          * Determines if a new sync source should be considered.
          * currentSource: the current sync source
+         * lastOpTimeFetched: the last optime the caller has fetched from that source
          */
-        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource) = 0;
+        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource,
+                                            const OpTime& lastOpTimeFetched) = 0;
 
     protected:
 
@@ -104,11 +104,17 @@ namespace {
 
     struct ReplicationCoordinatorImpl::WaiterInfo {
 
+        // The write concern class a waiter belongs to; within one class waiters are
+        // satisfied in optime order.
+        static WriteConcernClass classOf(const WriteConcernOptions& writeConcern) {
+            return WriteConcernClass(writeConcern.wMode, writeConcern.wNumNodes);
+        }
+
         /**
-         * Constructor takes the list of waiters and enqueues itself on the list, removing itself
-         * in the destructor.
+         * Constructor takes the map of waiters and enqueues itself under its write
+         * concern class, removing itself in the destructor.
          */
-        WaiterInfo(std::vector<WaiterInfo*>* _list,
+        WaiterInfo(WaiterClassMap* _list,
                    unsigned int _opID,
                    const OpTime* _opTime,
                    const WriteConcernOptions* _writeConcern,
@@ -118,14 +124,20 @@ namespace {
                                                           opTime(_opTime),
                                                           writeConcern(_writeConcern),
                                                           condVar(_condVar) {
-            list->push_back(this);
+            where = (*list)[classOf(*_writeConcern)].insert(std::make_pair(*_opTime, this));
         }
 
         ~WaiterInfo() {
-            list->erase(std::remove(list->begin(), list->end(), this), list->end());
+            WaiterClassMap::iterator classIt = list->find(classOf(*writeConcern));
+            invariant(classIt != list->end());
+            classIt->second.erase(where);
+            if (classIt->second.empty()) {
+                list->erase(classIt);
+            }
         }
 
-        std::vector<WaiterInfo*>* list;
+        WaiterClassMap* list;
+        WaitersByOpTime::iterator where;
         bool master; // Set to false to indicate that stepDown was called while waiting
         const unsigned int opID;
         const OpTime* opTime;
@@ -350,10 +362,13 @@ namespace {
                 return;
             }
             fassert(18823, _rsConfigState != kConfigStartingUp);
-            for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                    it != _replicationWaiterList.end(); ++it) {
-                WaiterInfo* waiter = *it;
-                waiter->condVar->notify_all();
+            for (WaiterClassMap::iterator classIt = _replicationWaiterList.begin();
+                    classIt != _replicationWaiterList.end(); ++classIt) {
+                for (WaitersByOpTime::iterator it = classIt->second.begin();
+                        it != classIt->second.end(); ++it) {
+                    WaiterInfo* waiter = it->second;
+                    waiter->condVar->notify_all();
+                }
             }
 
             // Since we've set _inShutdown we know that _heartbeatReconfigThread will not be
@@ -792,12 +807,15 @@ namespace {
 
     void ReplicationCoordinatorImpl::interrupt(unsigned opId) {
         boost::lock_guard<boost::mutex> lk(_mutex);
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                it != _replicationWaiterList.end(); ++it) {
-            WaiterInfo* info = *it;
-            if (info->opID == opId) {
-                info->condVar->notify_all();
-                return;
+        for (WaiterClassMap::iterator classIt = _replicationWaiterList.begin();
+                classIt != _replicationWaiterList.end(); ++classIt) {
+            for (WaitersByOpTime::iterator it = classIt->second.begin();
+                    it != classIt->second.end(); ++it) {
+                WaiterInfo* info = it->second;
+                if (info->opID == opId) {
+                    info->condVar->notify_all();
+                    return;
+                }
             }
         }
 
@@ -809,10 +827,12 @@ namespace {
 
     void ReplicationCoordinatorImpl::interruptAll() {
         boost::lock_guard<boost::mutex> lk(_mutex);
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                it != _replicationWaiterList.end(); ++it) {
-            WaiterInfo* info = *it;
-            info->condVar->notify_all();
+        for (WaiterClassMap::iterator classIt = _replicationWaiterList.begin();
+                classIt != _replicationWaiterList.end(); ++classIt) {
+            for (WaitersByOpTime::iterator it = classIt->second.begin();
+                    it != classIt->second.end(); ++it) {
+                it->second->condVar->notify_all();
+            }
         }
 
         _replExecutor.scheduleWork(
@@ -1902,11 +1922,14 @@ namespace {
         PostMemberStateUpdateAction result;
         if (_currentState.primary() || newState.removed()) {
             // Wake up any threads blocked in awaitReplication, close connections, etc.
-            for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                 it != _replicationWaiterList.end(); ++it) {
-                WaiterInfo* info = *it;
-                info->master = false;
-                info->condVar->notify_all();
+            for (WaiterClassMap::iterator classIt = _replicationWaiterList.begin();
+                 classIt != _replicationWaiterList.end(); ++classIt) {
+                for (WaitersByOpTime::iterator it = classIt->second.begin();
+                     it != classIt->second.end(); ++it) {
+                    WaiterInfo* info = it->second;
+                    info->master = false;
+                    info->condVar->notify_all();
+                }
             }
             _isWaitingForDrainToComplete = false;
             _canAcceptNonLocalWrites = false;
@@ -2072,10 +2095,17 @@ namespace {
      }
 
     void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock(){
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-                it != _replicationWaiterList.end(); ++it) {
-            WaiterInfo* info = *it;
-            if (_doneWaitingForReplication_inlock(*info->opTime, *info->writeConcern)) {
+        for (WaiterClassMap::iterator classIt = _replicationWaiterList.begin();
+                classIt != _replicationWaiterList.end(); ++classIt) {
+            WaitersByOpTime& waiters = classIt->second;
+            for (WaitersByOpTime::iterator it = waiters.begin(); it != waiters.end(); ++it) {
+                WaiterInfo* info = it->second;
+                if (!_doneWaitingForReplication_inlock(*info->opTime, *info->writeConcern)) {
+                    // Waiters in a class are ordered by optime, so once the
+                    // earliest one is unsatisfied none of the later ones can be
+                    // satisfied either; skip the rest of the class.
+                    break;
+                }
                 info->condVar->notify_all();
             }
         }
@@ -2319,20 +2349,23 @@ namespace {
     void ReplicationCoordinatorImpl::_shouldChangeSyncSource(
             const ReplicationExecutor::CallbackData& cbData,
             const HostAndPort& currentSource,
+            const OpTime& lastOpTimeFetched,
             bool* shouldChange) {
         if (cbData.status == ErrorCodes::CallbackCanceled) {
             return;
         }
-        *shouldChange = _topCoord->shouldChangeSyncSource(currentSource);
+        *shouldChange = _topCoord->shouldChangeSyncSource(currentSource, lastOpTimeFetched);
     }
 
-    bool ReplicationCoordinatorImpl::shouldChangeSyncSource(const HostAndPort& currentSource) {
+    bool ReplicationCoordinatorImpl::shouldChangeSyncSource(const HostAndPort& currentSource,
+                                                            const OpTime& lastOpTimeFetched) {
         bool shouldChange(false);
         CBHStatus cbh = _replExecutor.scheduleWork(
             stdx::bind(&ReplicationCoordinatorImpl::_shouldChangeSyncSource,
                        this,
                        stdx::placeholders::_1,
                        currentSource,
+                       lastOpTimeFetched,
                        &shouldChange));
         if (cbh.getStatus() == ErrorCodes::ShutdownInProgress) {
             return false;
@@ -32,6 +32,9 @@
 #include <boost/thread.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/condition_variable.hpp>
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "mongo/base/status.h"
@@ -220,7 +223,8 @@ namespace repl {
 
         virtual void resetLastOpTimeFromOplog(OperationContext* txn);
 
-        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource);
+        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource,
+                                            const OpTime& lastOpTimeFetched);
 
 
         // ================== Test support API ===================
@@ -287,6 +291,15 @@ namespace repl {
         // Struct that holds information about clients waiting for replication.
         struct WaiterInfo;
 
+        // Waiters on replication progress are grouped by write concern class (the
+        // wMode string plus wNumNodes) and ordered within a class by the optime
+        // waited for.  Within one class satisfaction is monotonic in optime, so a
+        // progress update can stop scanning a class at its first unsatisfied
+        // waiter instead of re-evaluating every waiter on every update.
+        typedef std::pair<std::string, int> WriteConcernClass;
+        typedef std::multimap<OpTime, WaiterInfo*> WaitersByOpTime;
+        typedef std::map<WriteConcernClass, WaitersByOpTime> WaiterClassMap;
+
         // Struct that holds information about nodes in this replication group, mainly used for
         // tracking replication progress for write concern satisfaction.
         struct SlaveInfo {
@@ -675,6 +688,7 @@ namespace repl {
          */
         void _shouldChangeSyncSource(const ReplicationExecutor::CallbackData& cbData,
                                      const HostAndPort& currentSource,
+                                     const OpTime& lastOpTimeFetched,
                                      bool* shouldChange);
 
         /**
@@ -792,9 +806,9 @@ namespace repl {
         // TODO: ideally this should only change on rollbacks NOT on mongod restarts also.
         int _rbid;                                                                        // (M)
 
-        // list of information about clients waiting on replication.  Does *not* own the
-        // WaiterInfos.
-        std::vector<WaiterInfo*> _replicationWaiterList;                                  // (M)
+        // information about clients waiting on replication, grouped by write concern
+        // class and ordered by waited-for optime.  Does *not* own the WaiterInfos.
+        WaiterClassMap _replicationWaiterList;                                            // (M)
 
         // Set to true when we are in the process of shutting down replication.
         bool _inShutdown;                                                                 // (M)
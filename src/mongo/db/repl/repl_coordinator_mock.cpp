@@ -283,7 +283,8 @@ namespace repl {
         invariant(false);
     }
 
-    bool ReplicationCoordinatorMock::shouldChangeSyncSource(const HostAndPort& currentSource) {
+    bool ReplicationCoordinatorMock::shouldChangeSyncSource(const HostAndPort& currentSource,
+                                                            const OpTime& lastOpTimeFetched) {
         invariant(false);
     }
 
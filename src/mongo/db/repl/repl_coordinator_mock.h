@@ -176,7 +176,8 @@ namespace repl {
 
         virtual void resetLastOpTimeFromOplog(OperationContext* txn);
 
-        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource);
+        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource,
+                                            const OpTime& lastOpTimeFetched);
 
     private:
 
@@ -40,6 +40,12 @@ namespace repl {
 
 namespace {
     stdx::function<void ()> makeNoExcept(const stdx::function<void ()> &fn);
+
+    // Maximum number of ready callbacks the run loop claims from the ready queue in one
+    // _mutex acquisition.  Bounded so that sleepers coming due (election timeouts, in
+    // particular) are re-examined at least this often while draining a backlog of
+    // heartbeat response callbacks.
+    const size_t kWorkBatchSize = 16;
 }  // namespace
 
     const ReplicationExecutor::Milliseconds ReplicationExecutor::kNoTimeout(-1);
@@ -86,17 +92,20 @@ namespace {
         setThreadName("ReplicationExecutor");
         _networkInterface->startup();
         _dblockWorkers.startThreads();
-        std::pair<WorkItem, CallbackHandle> work;
-        while ((work = getWork()).first.callback) {
-            {
-                boost::lock_guard<boost::mutex> lk(_terribleExLockSyncMutex);
-                const Status inStatus = work.first.isCanceled ?
-                    Status(ErrorCodes::CallbackCanceled, "Callback canceled") :
-                    Status::OK();
-                makeNoExcept(stdx::bind(work.first.callback,
-                                        CallbackData(this, work.second, inStatus)))();
+        std::vector<std::pair<WorkItem, CallbackHandle> > batch;
+        while (getWorkBatch(&batch)) {
+            for (size_t i = 0; i < batch.size(); ++i) {
+                const WorkItem& work = batch[i].first;
+                {
+                    boost::lock_guard<boost::mutex> lk(_terribleExLockSyncMutex);
+                    const Status inStatus = work.isCanceled ?
+                        Status(ErrorCodes::CallbackCanceled, "Callback canceled") :
+                        Status::OK();
+                    makeNoExcept(stdx::bind(work.callback,
+                                            CallbackData(this, batch[i].second, inStatus)))();
+                }
+                signalEvent(work.finishedEvent);
             }
-            signalEvent(work.first.finishedEvent);
         }
         finishShutdown();
         _networkInterface->shutdown();
@@ -397,8 +406,9 @@ namespace {
         waitForEvent(cbHandle._finishedEvent);
     }
 
-    std::pair<ReplicationExecutor::WorkItem, ReplicationExecutor::CallbackHandle>
-    ReplicationExecutor::getWork() {
+    bool ReplicationExecutor::getWorkBatch(
+            std::vector<std::pair<WorkItem, CallbackHandle> >* batch) {
+        batch->clear();
         boost::unique_lock<boost::mutex> lk(_mutex);
         while (true) {
             const Date_t now = _networkInterface->now();
@@ -407,7 +417,7 @@ namespace {
                 break;
             }
             else if (_inShutdown) {
-                return std::make_pair(WorkItem(), CallbackHandle());
+                return false;
             }
             lk.unlock();
             if (nextWakeupDate == Date_t(~0ULL)) {
@@ -418,11 +428,13 @@ namespace {
             }
             lk.lock();
         }
-        const CallbackHandle cbHandle(_readyQueue.begin());
-        const WorkItem work = *cbHandle._iter;
-        _readyQueue.begin()->callback = CallbackFn();
-        _freeQueue.splice(_freeQueue.begin(), _readyQueue, _readyQueue.begin());
-        return std::make_pair(work, cbHandle);
+        while (!_readyQueue.empty() && batch->size() < kWorkBatchSize) {
+            const CallbackHandle cbHandle(_readyQueue.begin());
+            batch->push_back(std::make_pair(*cbHandle._iter, cbHandle));
+            _readyQueue.begin()->callback = CallbackFn();
+            _freeQueue.splice(_freeQueue.begin(), _readyQueue, _readyQueue.begin());
+        }
+        return true;
     }
 
     int64_t ReplicationExecutor::nextRandomInt64(int64_t limit) {
@@ -434,7 +446,10 @@ namespace {
         while ((iter != _sleepersQueue.end()) && (iter->readyDate <= now)) {
             ++iter;
         }
-        _readyQueue.splice(_readyQueue.end(), _sleepersQueue, _sleepersQueue.begin(), iter);
+        // Deadline-driven work goes to the front of the ready queue; it should not wait
+        // behind however many heartbeat response callbacks have accumulated since the last
+        // pass through the run loop.
+        _readyQueue.splice(_readyQueue.begin(), _sleepersQueue, _sleepersQueue.begin(), iter);
         if (iter == _sleepersQueue.end()) {
             // indicate no sleeper to wait for
             return Date_t(~0ULL);
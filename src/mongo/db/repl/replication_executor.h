@@ -33,6 +33,8 @@
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
@@ -315,15 +317,22 @@ namespace repl {
         StatusWith<EventHandle> makeEvent_inlock();
 
         /**
-         * Gets a single piece of work to execute.
+         * Gets a batch of work for the run loop to execute, blocking until work is
+         * available or the executor is shutting down.
          *
-         * If the "callback" member of the returned WorkItem is falsey, that is a signal
-         * to the run loop to wait for shutdown.
+         * Grabs up to kWorkBatchSize items per call, so that the run loop pays for one
+         * _mutex round trip per batch rather than per item; with large replica sets the
+         * network threads delivering heartbeat responses contend heavily on _mutex.
+         *
+         * Returns false when the executor is shutting down and there is no work left to run.
          */
-        std::pair<WorkItem, CallbackHandle> getWork();
+        bool getWorkBatch(std::vector<std::pair<WorkItem, CallbackHandle> >* batch);
 
         /**
          * Marks as runnable any sleepers whose ready date has passed as of "now".
+         * Ready sleepers are placed at the front of the ready queue, ahead of already-ready
+         * work, because they represent deadlines (e.g. election timeouts) that should not
+         * wait behind a backlog of heartbeat response callbacks.
          * Returns the date when the next sleeper will be ready, or Date_t(~0ULL) if there are no
          * remaining sleepers.
          */
@@ -592,7 +601,7 @@ namespace repl {
      * requires a unique generation identifier in CallbackHandles and WorkItem objects.
      *
      * WorkItem is copyable so that it may be stored in a list.  However, in practice they
-     * should only be copied by getWork() and when allocating new entries into a WorkQueue (not
+     * should only be copied by getWorkBatch() and when allocating new entries into a WorkQueue (not
      * when moving entries between work lists).
      */
     struct ReplicationExecutor::WorkItem {
@@ -32,9 +32,11 @@
 
 #include "mongo/db/repl/rs_initialsync.h"
 
+#include "mongo/base/init.h"
 #include "mongo/bson/optime.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_manager_global.h"
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
 #include "mongo/db/cloner.h"
@@ -47,6 +49,9 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -88,17 +93,40 @@ namespace {
         wunit.commit();
     }
 
-    bool _initialSyncClone(OperationContext* txn,
-                           Cloner& cloner,
-                           const std::string& host,
-                           const list<string>& dbs,
-                           bool dataPass) {
+    // Number of databases cloned (and later indexed) concurrently during initial
+    // sync.  Each cloner pool worker opens its own connection to the sync source
+    // and takes its own database lock, so cloning one database never waits on the
+    // network reads or index builds of another.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncClonerThreadCount, int, 4);
+
+    MONGO_INITIALIZER_GENERAL(InitialSyncClonerThreadCountBounds,
+                              ("EndStartupOptionHandling"),
+                              ("default"))(InitializerContext* context) {
+        if (initialSyncClonerThreadCount < 1 || initialSyncClonerThreadCount > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "initialSyncClonerThreadCount must be between 1 and 64");
+        }
+        return Status::OK();
+    }
+
+    /**
+     * Clones the data (or builds the indexes) of one database from the sync source.
+     * Runs on a cloner pool worker with its own client, operation context, and
+     * connection; databases are disjoint in the lock manager, so workers don't
+     * serialize on each other's writes.
+     */
+    void _initialSyncCloneDatabase(const std::string host,
+                                   const std::string db,
+                                   bool dataPass,
+                                   AtomicUInt32* failures) {
+        if (!ClientBasic::getCurrent()) {
+            Client::initThreadIfNotAlready();
+            cc().getAuthorizationSession()->grantInternalAuthorization();
+        }
+
+        try {
+            OperationContextImpl txn;
 
-        for( list<string>::const_iterator i = dbs.begin(); i != dbs.end(); i++ ) {
-            const string db = *i;
-            if ( db == "local" )
-                continue;
-            
             if ( dataPass )
                 log() << "initial sync cloning db: " << db;
             else
@@ -118,18 +146,42 @@ namespace {
             options.syncIndexes = ! dataPass;
 
             // Make database stable
-            ScopedTransaction transaction(txn, MODE_IX);
-            Lock::DBLock dbWrite(txn->lockState(), db, MODE_X);
+            ScopedTransaction transaction(&txn, MODE_IX);
+            Lock::DBLock dbWrite(txn.lockState(), db, MODE_X);
 
-            if (!cloner.go(txn, db, host, options, NULL, err, &errCode)) {
+            Cloner cloner;
+            if (!cloner.go(&txn, db, host, options, NULL, err, &errCode)) {
                 log() << "initial sync: error while "
                       << (dataPass ? "cloning " : "indexing ") << db
                       << ".  " << (err.empty() ? "" : err + ".  ");
-                return false;
+                failures->fetchAndAdd(1);
             }
         }
+        catch (const DBException& e) {
+            log() << "initial sync: exception while "
+                  << (dataPass ? "cloning " : "indexing ") << db << causedBy(e);
+            failures->fetchAndAdd(1);
+        }
+    }
 
-        return true;
+    bool _initialSyncClone(const std::string& host,
+                           const list<string>& dbs,
+                           bool dataPass) {
+
+        threadpool::ThreadPool clonerPool(initialSyncClonerThreadCount,
+                                          "initial sync cloner ");
+        AtomicUInt32 failures(0);
+
+        for( list<string>::const_iterator i = dbs.begin(); i != dbs.end(); i++ ) {
+            const string db = *i;
+            if ( db == "local" )
+                continue;
+
+            clonerPool.schedule(&_initialSyncCloneDatabase, host, db, dataPass, &failures);
+        }
+        clonerPool.join();
+
+        return failures.load() == 0;
     }
 
     /**
@@ -320,8 +372,7 @@ namespace {
 
         list<string> dbs = r.conn()->getDatabaseNames();
 
-        Cloner cloner;
-        if (!_initialSyncClone(&txn, cloner, r.conn()->getServerAddress(), dbs, true)) {
+        if (!_initialSyncClone(r.conn()->getServerAddress(), dbs, true)) {
             return Status(ErrorCodes::InitialSyncFailure, "initial sync failed data cloning");
         }
 
@@ -351,7 +402,7 @@ namespace {
 
         msg = "initial sync building indexes";
         log() << msg;
-        if (!_initialSyncClone(&txn, cloner, r.conn()->getServerAddress(), dbs, false)) {
+        if (!_initialSyncClone(r.conn()->getServerAddress(), dbs, false)) {
             return Status(ErrorCodes::InitialSyncFailure,
                           str::stream() << "initial sync failed: " << msg);
         }
@@ -391,25 +391,66 @@ namespace {
         DocID doc;
         unsigned long long numFetched = 0;
         try {
-            for (set<DocID>::iterator it = fixUpInfo.toRefetch.begin();
-                    it != fixUpInfo.toRefetch.end();
-                    it++) {
+            // toRefetch is sorted by ns, so each run of equal namespaces becomes a
+            // handful of $in queries with streamed results rather than a findOne
+            // round trip per document.
+            const size_t kMaxIdsPerBatch = 500;
+
+            set<DocID>::iterator it = fixUpInfo.toRefetch.begin();
+            while (it != fixUpInfo.toRefetch.end()) {
                 doc = *it;
+                const char* ns = it->ns;
+
+                // Collect one batch of _ids for this namespace.
+                typedef map<BSONElement, const DocID*, BSONElementCmpWithoutField> IdMap;
+                IdMap batch;
+                BSONArrayBuilder ids;
+                while (it != fixUpInfo.toRefetch.end() &&
+                       strcmp(it->ns, ns) == 0 &&
+                       batch.size() < kMaxIdsPerBatch) {
+                    verify(!it->_id.eoo());
+                    batch[it->_id] = &*it;
+                    ids.append(it->_id);
+                    ++it;
+                }
 
-                verify(!doc._id.eoo());
+                auto_ptr<DBClientCursor> cursor =
+                    them->query(ns,
+                                Query(BSON("_id" << BSON("$in" << ids.arr()))),
+                                0, 0, NULL, QueryOption_SlaveOk);
+                uassert(28641, "rollback error querying for good versions of documents",
+                        cursor.get());
+
+                while (cursor->more()) {
+                    BSONObj good = cursor->nextSafe().getOwned();
+                    IdMap::iterator found = batch.find(good["_id"]);
+                    if (found == batch.end()) {
+                        // could be a duplicate under a different _id type ordering;
+                        // a document we didn't ask for is simply ignored
+                        continue;
+                    }
 
-                {
-                    // TODO : slow.  lots of round trips.
                     numFetched++;
-                    BSONObj good = them->findOne(doc.ns, doc._id.wrap(),
-                                                     NULL, QueryOption_SlaveOk).getOwned();
                     totalSize += good.objsize();
                     uassert(13410, "replSet too much data to roll back",
                             totalSize < 300 * 1024 * 1024);
 
-                    // note good might be eoo, indicating we should delete it
-                    goodVersions.push_back(pair<DocID, BSONObj>(doc,good));
+                    goodVersions.push_back(pair<DocID, BSONObj>(*found->second, good));
+                    batch.erase(found);
                 }
+
+                // Anything the sync source no longer has comes back empty, which
+                // tells the fixup pass below to delete our copy.
+                for (IdMap::iterator missing = batch.begin();
+                        missing != batch.end();
+                        ++missing) {
+                    numFetched++;
+                    goodVersions.push_back(pair<DocID, BSONObj>(*missing->second, BSONObj()));
+                }
+
+                // A batch boundary is a safe place to give up; nothing has been
+                // changed locally yet and a retry refetches from scratch.
+                txn->checkForInterrupt();
             }
             newMinValid = oplogreader->getLastOp(rsoplog);
             if (newMinValid.isEmpty()) {
@@ -38,6 +38,7 @@
 #include "third_party/murmurhash3/MurmurHash3.h"
 
 #include "mongo/base/counter.h"
+#include "mongo/base/init.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
@@ -51,6 +52,7 @@
 #include "mongo/db/repl/minvalid.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/util/exit.h"
@@ -61,15 +63,39 @@ namespace mongo {
 
 namespace repl {
 #if defined(MONGO_PLATFORM_64)
-    const int replWriterThreadCount = 16;
-    const int replPrefetcherThreadCount = 16;
+    const int kDefaultReplWriterThreadCount = 16;
+    const int kDefaultReplPrefetcherThreadCount = 16;
 #elif defined(MONGO_PLATFORM_32)
-    const int replWriterThreadCount = 2;
-    const int replPrefetcherThreadCount = 2;
+    const int kDefaultReplWriterThreadCount = 2;
+    const int kDefaultReplPrefetcherThreadCount = 2;
 #else
 #error need to include something that defines MONGO_PLATFORM_XX
 #endif
 
+    // Number of threads applying (resp. prefetching) oplog entries in parallel.
+    // CRUD entries are partitioned across the appliers by a hash of namespace and
+    // document _id (see fillWriterVectors), so on a document-locking storage
+    // engine raising this scales apply throughput with document distribution,
+    // even for a single hot collection.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replWriterThreadCount, int,
+                                          kDefaultReplWriterThreadCount);
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replPrefetcherThreadCount, int,
+                                          kDefaultReplPrefetcherThreadCount);
+
+    MONGO_INITIALIZER_GENERAL(ReplApplierThreadCountBounds,
+                              ("EndStartupOptionHandling"),
+                              ("default"))(InitializerContext* context) {
+        if (replWriterThreadCount < 1 || replWriterThreadCount > 256) {
+            return Status(ErrorCodes::BadValue,
+                          "replWriterThreadCount must be between 1 and 256");
+        }
+        if (replPrefetcherThreadCount < 1 || replPrefetcherThreadCount > 256) {
+            return Status(ErrorCodes::BadValue,
+                          "replPrefetcherThreadCount must be between 1 and 256");
+        }
+        return Status::OK();
+    }
+
     static Counter64 opsAppliedStats;
 
     //The oplog entries applied
@@ -322,16 +348,6 @@ namespace repl {
         }
     }
 
-    // Doles out all the work to the reader pool threads and waits for them to complete
-    void SyncTail::prefetchOps(const std::deque<BSONObj>& ops) {
-        for (std::deque<BSONObj>::const_iterator it = ops.begin();
-             it != ops.end();
-             ++it) {
-            _prefetcherPool.schedule(&prefetchOp, *it);
-        }
-        _prefetcherPool.join();
-    }
-    
     // Doles out all the work to the writer pool threads and waits for them to complete
     void SyncTail::applyOps(const std::vector< std::vector<BSONObj> >& writerVectors) {
         TimerHolder timer(&applyBatchStats);
@@ -348,11 +364,13 @@ namespace repl {
     // Doles out all the work to the writer pool threads and waits for them to complete
     OpTime SyncTail::multiApply(OperationContext* txn, std::deque<BSONObj>& ops) {
 
-        if (getGlobalEnvironment()->getGlobalStorageEngine()->isMmapV1()) {
-            // Use a ThreadPool to prefetch all the operations in a batch.
-            prefetchOps(ops);
-        }
-        
+        // Prefetch of the batch was kicked off op by op as tryPopAndWaitForMore
+        // queued them; wait for the reader pool to finish warming the pages before
+        // taking the batch writer lock.  Engines that would not benefit can skip
+        // prefetching via the replIndexPrefetch parameter.
+        _prefetcherPool.join();
+
+
         std::vector< std::vector<BSONObj> > writerVectors(replWriterThreadCount);
         fillWriterVectors(ops, &writerVectors);
         LOG(2) << "replication batch size is " << ops.size() << endl;
@@ -377,6 +395,13 @@ namespace repl {
     }
 
 
+    // Partitions a batch across the writer threads.  Entries hash by namespace,
+    // and CRUD entries on a document-locking engine additionally hash by the
+    // document _id, so two ops for the same document always land on the same
+    // thread (preserving their relative order) while ops for different documents
+    // in one hot collection spread across all appliers.  Commands and index
+    // builds never reach this point: tryPopAndWaitForMore cuts the batch so they
+    // apply alone, acting as barriers around anything with multi-document scope.
     void SyncTail::fillWriterVectors(const std::deque<BSONObj>& ops,
                                      std::vector< std::vector<BSONObj> >* writerVectors) {
 
@@ -646,6 +671,12 @@ namespace {
         ops->push_back(op);
         _networkQueue->consume();
 
+        // Overlap page prefetch with batch accumulation: warm this op's pages
+        // now, while the network fetch is still filling out the rest of the
+        // batch, instead of in a serial prefetch pass before apply.  multiApply
+        // joins the pool before it takes the batch writer lock.
+        _prefetcherPool.schedule(&prefetchOp, ops->getDeque().back());
+
         // Go back for more ops
         return false;
     }
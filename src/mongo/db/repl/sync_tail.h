@@ -123,8 +123,6 @@ namespace repl {
         // Function to use during applyOps
         MultiSyncApplyFunc _applyFunc;
 
-        // Doles out all the work to the reader pool threads and waits for them to complete
-        void prefetchOps(const std::deque<BSONObj>& ops);
         // Used by the thread pool readers to prefetch an op
         static void prefetchOp(const BSONObj& op);
 
@@ -132,9 +132,12 @@ namespace repl {
         /**
          * Determines if a new sync source should be chosen, if a better candidate sync source is
          * available.  If the current sync source's last optime is more than _maxSyncSourceLagSecs
-         * behind any syncable source, this function returns true.
+         * behind any syncable source, this function returns true.  The same applies if the source
+         * itself is keeping up but has served us ("lastOpTimeFetched") less than what it has by
+         * more than _maxSyncSourceLagSecs -- i.e. the source is underperforming, not lagging.
          */
-        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource) const = 0;
+        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource,
+                                            const OpTime& lastOpTimeFetched) const = 0;
 
         /**
          * Checks whether we are a single node set and we are not in a stepdown period.  If so,
@@ -1410,9 +1410,21 @@ namespace {
         response->append("date", now);
         response->append("myState", myState.s);
 
-        // Add sync source info
+        // Add sync source info, including the inputs to sync source (re)selection so that
+        // chaining decisions can be diagnosed from the status output.
         if (!_syncSource.empty() && !myState.primary() && !myState.removed()) {
             response->append("syncingTo", _syncSource.toString());
+
+            const int sourceIndex = _currentConfig.findMemberIndexByHostAndPort(_syncSource);
+            if (sourceIndex != -1) {
+                BSONObjBuilder sourceInfo(response->subobjStart("syncSourceInfo"));
+                sourceInfo.append("host", _syncSource.toString());
+                sourceInfo.appendTimestamp("optime", _hbdata[sourceIndex].getOpTime().asDate());
+                sourceInfo.append("pingMs", _getPing(_syncSource));
+                sourceInfo.appendIntOrLL("maxSyncSourceLagSecs",
+                                         _maxSyncSourceLagSecs.total_seconds());
+                sourceInfo.done();
+            }
         }
 
         response->append("members", membersOut);
@@ -2001,12 +2013,15 @@ namespace {
         return _maintenanceModeCalls;
     }
 
-    bool TopologyCoordinatorImpl::shouldChangeSyncSource(const HostAndPort& currentSource) const
+    bool TopologyCoordinatorImpl::shouldChangeSyncSource(const HostAndPort& currentSource,
+                                                         const OpTime& lastOpTimeFetched) const
     {
         // Methodology:
         // If there exists a viable sync source member other than currentSource, whose oplog has
         // reached an optime greater than _maxSyncSourceLagSecs later than currentSource's, return
-        // true.
+        // true.  Likewise if currentSource's own oplog, as reported by heartbeat, is more than
+        // _maxSyncSourceLagSecs ahead of what it has actually served us (lastOpTimeFetched) and a
+        // viable alternative exists -- the source isn't lagging, it's just feeding us slowly.
 
         // If the user requested a sync source change, return true.
         if (_forceSyncSourceIndex != -1) {
@@ -2028,23 +2043,44 @@ namespace {
         unsigned int currentSecs = currentOpTime.getSecs();
         unsigned int goalSecs = currentSecs + _maxSyncSourceLagSecs.total_seconds();
 
+        // The source is underperforming if its own oplog has advanced more than
+        // _maxSyncSourceLagSecs past the last op it has served us; in that case any other viable
+        // candidate that has at least what we've fetched is an improvement.
+        const bool sourceServingSlowly = !lastOpTimeFetched.isNull() &&
+            currentSecs > lastOpTimeFetched.getSecs() + _maxSyncSourceLagSecs.total_seconds();
+
         for (std::vector<MemberHeartbeatData>::const_iterator it = _hbdata.begin();
              it != _hbdata.end();
              ++it) {
             const int itIndex = indexOfIterator(_hbdata, it);
             const MemberConfig& candidateConfig = _currentConfig.getMemberAt(itIndex);
-            if (it->up() &&
-                (candidateConfig.shouldBuildIndexes() || !_selfConfig().shouldBuildIndexes()) &&
-                it->getState().readable() &&
-                goalSecs < it->getOpTime().getSecs()) {
+            if (!it->up() ||
+                (!candidateConfig.shouldBuildIndexes() && _selfConfig().shouldBuildIndexes()) ||
+                !it->getState().readable()) {
+                continue;
+            }
+            if (goalSecs < it->getOpTime().getSecs()) {
                 log() << "changing sync target because current sync target's most recent OpTime is "
                       << currentOpTime.toStringLong() << " which is more than "
-                      << _maxSyncSourceLagSecs.total_seconds() << " seconds behind member " 
+                      << _maxSyncSourceLagSecs.total_seconds() << " seconds behind member "
                       <<  candidateConfig.getHostAndPort().toString()
                       << " whose most recent OpTime is " << it->getOpTime().toStringLong();
                 invariant(itIndex != _selfIndex);
                 return true;
             }
+            if (sourceServingSlowly &&
+                itIndex != currentMemberIndex &&
+                lastOpTimeFetched.getSecs() < it->getOpTime().getSecs()) {
+                log() << "changing sync target because current sync target "
+                      << currentSource.toString() << " has an OpTime of "
+                      << currentOpTime.toStringLong() << " but has only served us up to "
+                      << lastOpTimeFetched.toStringLong() << ", more than "
+                      << _maxSyncSourceLagSecs.total_seconds() << " seconds behind, and member "
+                      << candidateConfig.getHostAndPort().toString()
+                      << " is also available";
+                invariant(itIndex != _selfIndex);
+                return true;
+            }
         }
         return false;
     }
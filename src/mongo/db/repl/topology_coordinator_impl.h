@@ -130,7 +130,8 @@ namespace repl {
                                                 const OpTime& lastOpApplied);
         virtual void blacklistSyncSource(const HostAndPort& host, Date_t until);
         virtual void clearSyncSourceBlacklist();
-        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource) const;
+        virtual bool shouldChangeSyncSource(const HostAndPort& currentSource,
+                                            const OpTime& lastOpTimeFetched) const;
         virtual bool becomeCandidateIfStepdownPeriodOverAndSingleNodeSet(Date_t now);
         virtual void setElectionSleepUntil(Date_t newTime);
         virtual void setFollowerMode(MemberState::MS newMode);
@@ -427,8 +427,8 @@ namespace {
         getTopoCoord().setForceSyncSourceIndex(1);
         // force should cause shouldChangeSyncSource() to return true
         // even if the currentSource is the force target
-        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("h2")));
-        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("h3")));
+        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("h2"), OpTime()));
+        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("h3"), OpTime()));
         getTopoCoord().chooseNewSyncSource(now()++, OpTime(0,0));
         ASSERT_EQUALS(HostAndPort("h2"), getTopoCoord().getSyncSourceAddress());
 
@@ -3736,14 +3736,14 @@ namespace {
     TEST_F(HeartbeatResponseTest, ShouldChangeSyncSourceMemberNotInConfig) {
         // In this test, the TopologyCoordinator should tell us to change sync sources away from
         // "host4" since "host4" is absent from the config
-        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host4")));
+        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host4"), OpTime()));
     }
 
     TEST_F(HeartbeatResponseTest, ShouldChangeSyncSourceMemberHasYetToHeartbeat) {
         // In this test, the TopologyCoordinator should not tell us to change sync sources away from
         // "host2" since we do not yet have a heartbeat (and as a result do not yet have an optime)
         // for "host2"
-        ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2")));
+        ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2"), OpTime()));
     }
 
     TEST_F(HeartbeatResponseTest, ShouldChangeSyncSourceFresherHappierMemberExists) {
@@ -3772,7 +3772,7 @@ namespace {
 
         // set up complete, time for actual check
         startCapturingLogMessages();
-        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2")));
+        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2"), OpTime()));
         stopCapturingLogMessages();
         ASSERT_EQUALS(1, countLogLinesContaining("changing sync target"));
     }
@@ -3805,7 +3805,7 @@ namespace {
         // set up complete, time for actual check
         nextAction = receiveDownHeartbeat(HostAndPort("host3"), "rs0", lastOpTimeApplied);
         ASSERT_NO_ACTION(nextAction.getAction());
-        ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2")));
+        ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2"), OpTime()));
     }
 
     TEST_F(HeartbeatResponseTest, ShouldChangeSyncSourceFresherMemberIsNotReadable) {
@@ -3834,7 +3834,7 @@ namespace {
         ASSERT_NO_ACTION(nextAction.getAction());
 
         // set up complete, time for actual check
-        ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2")));
+        ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2"), OpTime()));
     }
 
     TEST_F(HeartbeatResponseTest, ShouldChangeSyncSourceFresherMemberDoesNotBuildIndexes) {
@@ -3870,7 +3870,7 @@ namespace {
         ASSERT_NO_ACTION(nextAction.getAction());
 
         // set up complete, time for actual check
-        ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2")));
+        ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2"), OpTime()));
     }
 
     TEST_F(HeartbeatResponseTest, ShouldChangeSyncSourceFresherMemberDoesNotBuildIndexesNorDoWe) {
@@ -3908,11 +3908,71 @@ namespace {
 
         // set up complete, time for actual check
         startCapturingLogMessages();
-        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2")));
+        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2"), OpTime()));
         stopCapturingLogMessages();
         ASSERT_EQUALS(1, countLogLinesContaining("changing sync target"));
     }
 
+    TEST_F(HeartbeatResponseTest, ShouldChangeSyncSourceMemberServingUsSlowly) {
+        // In this test, the TopologyCoordinator should tell us to change sync sources away from
+        // "host2", not because "host2" is lagged, but because it has served us ops only up to an
+        // optime more than maxSyncSourceLagSecs(30) behind its own optime while "host3" is a
+        // viable alternative
+        OpTime election = OpTime(0,0);
+        OpTime lastOpTimeApplied = OpTime(3005,0);
+        // behind the sync source's optime by more than maxSyncSourceLagSecs (30)
+        OpTime lastOpTimeFetched = OpTime(4,0);
+
+        HeartbeatResponseAction nextAction = receiveUpHeartbeat(HostAndPort("host2"),
+                                                                "rs0",
+                                                                MemberState::RS_SECONDARY,
+                                                                election,
+                                                                lastOpTimeApplied,
+                                                                lastOpTimeApplied);
+        ASSERT_NO_ACTION(nextAction.getAction());
+
+        nextAction = receiveUpHeartbeat(HostAndPort("host3"),
+                                        "rs0",
+                                        MemberState::RS_SECONDARY,
+                                        election,
+                                        lastOpTimeApplied,
+                                        lastOpTimeApplied);
+        ASSERT_NO_ACTION(nextAction.getAction());
+
+        // set up complete, time for actual check
+        startCapturingLogMessages();
+        ASSERT_TRUE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2"),
+                                                          lastOpTimeFetched));
+        stopCapturingLogMessages();
+        ASSERT_EQUALS(1, countLogLinesContaining("has only served us up to"));
+    }
+
+    TEST_F(HeartbeatResponseTest, ShouldChangeSyncSourceMemberServingUsSlowlyNoAlternative) {
+        // In this test, the TopologyCoordinator should not tell us to change sync sources away
+        // from "host2" despite it having served us ops only up to an optime more than
+        // maxSyncSourceLagSecs(30) behind its own optime, since "host3" is down and there is no
+        // alternative
+        OpTime election = OpTime(0,0);
+        OpTime lastOpTimeApplied = OpTime(3005,0);
+        // behind the sync source's optime by more than maxSyncSourceLagSecs (30)
+        OpTime lastOpTimeFetched = OpTime(4,0);
+
+        HeartbeatResponseAction nextAction = receiveUpHeartbeat(HostAndPort("host2"),
+                                                                "rs0",
+                                                                MemberState::RS_SECONDARY,
+                                                                election,
+                                                                lastOpTimeApplied,
+                                                                lastOpTimeApplied);
+        ASSERT_NO_ACTION(nextAction.getAction());
+
+        nextAction = receiveDownHeartbeat(HostAndPort("host3"), "rs0", lastOpTimeApplied);
+        ASSERT_NO_ACTION(nextAction.getAction());
+
+        // set up complete, time for actual check
+        ASSERT_FALSE(getTopoCoord().shouldChangeSyncSource(HostAndPort("host2"),
+                                                           lastOpTimeFetched));
+    }
+
     TEST_F(TopoCoordTest, CheckShouldStandForElectionWithPrimary) {
         updateConfig(BSON("_id" << "rs0" <<
                           "version" << 1 <<
@@ -228,6 +228,10 @@ namespace {
         options->addOptionChaining("systemLog.logAppend", "logappend", moe::Switch,
                 "append to logpath instead of over-writing");
 
+        options->addOptionChaining("systemLog.logAsync", "logAsync", moe::Switch,
+                "write log entries from a background thread instead of the operation "
+                "thread; entries may be dropped if the writer cannot keep up");
+
         options->addOptionChaining("systemLog.logRotate", "logRotate", moe::String,
                 "set the log rotation behavior (rename|reopen)");
 
@@ -869,6 +873,11 @@ namespace {
             serverGlobalParams.logAppend = true;
         }
 
+        if (params.count("systemLog.logAsync") &&
+            params["systemLog.logAsync"].as<bool>() == true) {
+            serverGlobalParams.logAsync = true;
+        }
+
         if (params.count("systemLog.logRotate")) {
             std::string logRotateParam = params["systemLog.logRotate"].as<string>();
             if (logRotateParam == "reopen") {
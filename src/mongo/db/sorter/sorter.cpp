@@ -47,13 +47,21 @@
 
 #include "mongo/db/sorter/sorter.h"
 
+#include <boost/bind.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/make_shared.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/condition.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
 #include <snappy.h>
+#include <third_party/murmurhash3/MurmurHash3.h>
 
 #include "mongo/base/string_data.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_memory.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/assert_util.h"
@@ -68,6 +76,17 @@ namespace mongo {
         using boost::shared_ptr;
         using namespace mongoutils;
 
+        /**
+         * Checksum over a spill block's uncompressed bytes. Stored in each block's
+         * header so temp-file corruption is detected at read time rather than
+         * surfacing as garbage sort output.
+         */
+        inline uint32_t blockChecksum(const char* data, size_t size) {
+            uint32_t out;
+            MurmurHash3_x86_32(data, size, 0, &out);
+            return out;
+        }
+
         // We need to use the "real" errno everywhere, not GetLastError() on Windows
         inline std::string myErrnoWithDescription() {
             int errnoCopy = errno;
@@ -151,6 +170,9 @@ namespace mongo {
             std::deque<Data> _data;
         };
 
+        template <typename Key, typename Value>
+        class ReadAheadPool;
+
         /** Returns results in order from a single file */
         template <typename Key, typename Value>
         class FileIterator : public SortIteratorInterface<Key, Value> {
@@ -168,6 +190,9 @@ namespace mongo {
                 , _fileName(fileName)
                 , _fileDeleter(fileDeleter)
                 , _file(_fileName.c_str(), std::ios::in | std::ios::binary)
+                , _pool(NULL)
+                , _raState(kRaLoading)
+                , _raSize(0)
             {
                 massert(16814, str::stream() << "error opening file \"" << _fileName << "\": "
                                              << myErrnoWithDescription(),
@@ -194,7 +219,23 @@ namespace mongo {
                 return out;
             }
 
+            /**
+             * Hands all further reading of this file to 'pool', which keeps the next
+             * block loaded before it is asked for. Must be called before iteration
+             * starts.
+             */
+            void enableReadAhead(ReadAheadPool<Key, Value>* pool) {
+                verify(!_reader && !_pool);
+                _pool = pool;
+                _pool->watch(this);
+            }
+
         private:
+            friend class ReadAheadPool<Key, Value>;
+
+            // Read-ahead state for this file, guarded by the pool's mutex once attached.
+            enum RaState { kRaLoading, kRaReady, kRaEof, kRaError };
+
             void fillIfNeeded() {
                 verify(!_done);
 
@@ -203,54 +244,85 @@ namespace mongo {
             }
 
             void fill() {
+                boost::scoped_array<char> buffer;
+                size_t blockSize = 0;
+                const bool haveBlock = _pool ? _pool->take(this, &buffer, &blockSize)
+                                             : loadBlock(&buffer, &blockSize);
+                if (!haveBlock) {
+                    _done = true;
+                    return;
+                }
+
+                _buffer.swap(buffer);
+                _reader.reset(new BufReader(_buffer.get(), blockSize));
+            }
+
+            /**
+             * Reads and decompresses the next block of the file into 'out'. Returns false
+             * on a clean EOF, asserts on a short or corrupt file. Touches nothing but the
+             * file, so the pool's thread may call this while the merge consumes an
+             * earlier block.
+             */
+            bool loadBlock(boost::scoped_array<char>* out, size_t* outSize) {
                 int32_t rawSize;
-                read(&rawSize, sizeof(rawSize));
-                if (_done) return;
+                if (!read(&rawSize, sizeof(rawSize)))
+                    return false;
 
                 // negative size means compressed
                 const bool compressed = rawSize < 0;
                 const int32_t blockSize = std::abs(rawSize);
 
-                _buffer.reset(new char[blockSize]);
-                read(_buffer.get(), blockSize);
-                massert(16816, "file too short?", !_done);
+                uint32_t checksum;
+                massert(28614, "file too short?", read(&checksum, sizeof(checksum)));
+
+                boost::scoped_array<char> buffer(new char[blockSize]);
+                massert(16816, "file too short?", read(buffer.get(), blockSize));
 
                 if (!compressed) {
-                    _reader.reset(new BufReader(_buffer.get(), blockSize));
-                    return;
+                    massert(28615, str::stream() << "checksum mismatch in \"" << _fileName
+                                                 << "\" - temp file corrupted?",
+                            checksum == blockChecksum(buffer.get(), blockSize));
+                    out->swap(buffer);
+                    *outSize = blockSize;
+                    return true;
                 }
 
-                dassert(snappy::IsValidCompressedBuffer(_buffer.get(), blockSize));
+                dassert(snappy::IsValidCompressedBuffer(buffer.get(), blockSize));
 
                 size_t uncompressedSize;
                 massert(17061, "couldn't get uncompressed length",
-                        snappy::GetUncompressedLength(_buffer.get(), blockSize, &uncompressedSize));
+                        snappy::GetUncompressedLength(buffer.get(), blockSize,
+                                                      &uncompressedSize));
 
                 boost::scoped_array<char> decompressionBuffer(new char[uncompressedSize]);
                 massert(17062, "decompression failed",
-                        snappy::RawUncompress(_buffer.get(),
+                        snappy::RawUncompress(buffer.get(),
                                               blockSize,
                                               decompressionBuffer.get()));
 
+                massert(28616, str::stream() << "checksum mismatch in \"" << _fileName
+                                             << "\" - temp file corrupted?",
+                        checksum == blockChecksum(decompressionBuffer.get(), uncompressedSize));
+
                 // hold on to decompressed data and throw out compressed data at block exit
-                _buffer.swap(decompressionBuffer);
-                _reader.reset(new BufReader(_buffer.get(), uncompressedSize));
+                out->swap(decompressionBuffer);
+                *outSize = uncompressedSize;
+                return true;
             }
 
-            // sets _done to true on EOF - asserts on any other error
-            void read(void* out, size_t size) {
+            // returns false on EOF at a block boundary - asserts on any other error
+            bool read(void* out, size_t size) {
                 _file.read(reinterpret_cast<char*>(out), size);
                 if (!_file.good()) {
-                    if (_file.eof()) {
-                        _done = true;
-                        return;
-                    }
+                    if (_file.eof())
+                        return false;
 
                     msgasserted(16817, str::stream() << "error reading file \""
                                                      << _fileName << "\": "
                                                      << myErrnoWithDescription());
                 }
                 verify(_file.gcount() == static_cast<std::streamsize>(size));
+                return true;
             }
 
             const Settings _settings;
@@ -260,9 +332,135 @@ namespace mongo {
             string _fileName;
             boost::shared_ptr<FileDeleter> _fileDeleter; // Must outlive _file
             std::ifstream _file;
+
+            ReadAheadPool<Key, Value>* _pool; // not owned, NULL when reading synchronously
+            RaState _raState;
+            boost::scoped_array<char> _raBuffer; // the block loaded ahead of its use
+            size_t _raSize;
+            std::string _raError;
         };
 
-        /** Merge-sorts results from 0 or more FileIterators */
+        /**
+         * A single background thread that keeps the next block of every spill file in a
+         * merge decompressed and waiting, so the merge only blocks on disk if it outruns
+         * the drive outright. Each file is double buffered: while the merge consumes one
+         * block, the thread loads the one after it.
+         */
+        template <typename Key, typename Value>
+        class ReadAheadPool {
+        public:
+            typedef FileIterator<Key, Value> Iter;
+
+            ReadAheadPool() : _shutdown(false) {
+                _thread.reset(new boost::thread(boost::bind(&ReadAheadPool::_run, this)));
+            }
+
+            ~ReadAheadPool() {
+                {
+                    boost::mutex::scoped_lock lk(_mutex);
+                    _shutdown = true;
+                    _workAvailable.notify_one();
+                }
+                _thread->join();
+            }
+
+            /** Starts loading the first block of 'it'. */
+            void watch(Iter* it) {
+                boost::mutex::scoped_lock lk(_mutex);
+                it->_raState = Iter::kRaLoading;
+                _queue.push_back(it);
+                _workAvailable.notify_one();
+            }
+
+            /**
+             * Takes the block loaded ahead for 'it', waiting for it if the merge got here
+             * first, and queues the load of the block after it. Returns false at EOF.
+             */
+            bool take(Iter* it, boost::scoped_array<char>* out, size_t* outSize) {
+                boost::mutex::scoped_lock lk(_mutex);
+                while (it->_raState == Iter::kRaLoading) {
+                    _blockReady.wait(lk);
+                }
+
+                if (it->_raState == Iter::kRaError)
+                    msgasserted(28613, it->_raError);
+
+                if (it->_raState == Iter::kRaEof)
+                    return false;
+
+                out->swap(it->_raBuffer);
+                *outSize = it->_raSize;
+
+                it->_raState = Iter::kRaLoading;
+                _queue.push_back(it);
+                _workAvailable.notify_one();
+                return true;
+            }
+
+        private:
+            void _run() {
+                while (true) {
+                    Iter* it;
+                    {
+                        boost::mutex::scoped_lock lk(_mutex);
+                        while (_queue.empty() && !_shutdown) {
+                            _workAvailable.wait(lk);
+                        }
+                        if (_shutdown)
+                            return;
+                        it = _queue.front();
+                        _queue.pop_front();
+                    }
+
+                    // The file read and decompression happen outside the mutex; this
+                    // thread is the only one touching the file while a load is in
+                    // flight. Failures are parked on the iterator and rethrown on the
+                    // consuming thread in take().
+                    boost::scoped_array<char> buffer;
+                    size_t blockSize = 0;
+                    bool haveBlock = false;
+                    std::string error;
+                    try {
+                        haveBlock = it->loadBlock(&buffer, &blockSize);
+                    }
+                    catch (const std::exception& e) {
+                        error = e.what();
+                    }
+
+                    boost::mutex::scoped_lock lk(_mutex);
+                    if (!error.empty()) {
+                        it->_raError = error;
+                        it->_raState = Iter::kRaError;
+                    }
+                    else if (haveBlock) {
+                        it->_raBuffer.swap(buffer);
+                        it->_raSize = blockSize;
+                        it->_raState = Iter::kRaReady;
+                    }
+                    else {
+                        it->_raState = Iter::kRaEof;
+                    }
+                    _blockReady.notify_all();
+                }
+            }
+
+            boost::mutex _mutex; // guards the queue and all watched iterators' _ra state
+            boost::condition _workAvailable;
+            boost::condition _blockReady;
+            std::deque<Iter*> _queue;
+            bool _shutdown;
+            boost::scoped_ptr<boost::thread> _thread;
+        };
+
+        /**
+         * Merge-sorts results from 0 or more FileIterators.
+         *
+         * The merge itself is a loser tree over the input streams: a tournament tree
+         * whose internal nodes remember the loser of each match, so replacing the winner
+         * after it is consumed costs one comparison per level (ceil(log2(k)) for k
+         * streams) instead of a heap's pop-and-push. Spill-file inputs additionally get
+         * their blocks loaded ahead of use by a shared ReadAheadPool thread.
+         */
         template <typename Key, typename Value, typename Comparator>
         class MergeIterator : public SortIteratorInterface<Key, Value> {
         public:
@@ -277,33 +475,59 @@ namespace mongo {
                 , _remaining(opts.limit ? opts.limit : numeric_limits<unsigned long long>::max())
                 , _first(true)
                 , _greater(comp)
+                , _padded(1)
+                , _winner(0)
+                , _liveStreams(0)
             {
+                // Wire up read-ahead before the priming pass below touches the files.
+                for (size_t i = 0; i < iters.size(); i++) {
+                    FileIterator<Key, Value>* fileIter =
+                        dynamic_cast<FileIterator<Key, Value>*>(iters[i].get());
+                    if (!fileIter)
+                        continue;
+                    if (!_readAhead)
+                        _readAhead.reset(new ReadAheadPool<Key, Value>());
+                    fileIter->enableReadAhead(_readAhead.get());
+                }
+
                 for (size_t i = 0; i < iters.size(); i++) {
                     if (iters[i]->more()) {
-                        _heap.push_back(
+                        _streams.push_back(
                             boost::make_shared<Stream>(i, iters[i]->next(), iters[i]));
+                        _liveStreams++;
+                    }
+                    else {
+                        // keep leaf i aligned with input i; empty slots always lose
+                        _streams.push_back(boost::shared_ptr<Stream>());
                     }
                 }
 
-                if (_heap.empty()) {
+                if (_liveStreams == 0) {
                     _remaining = 0;
                     return;
                 }
 
-                std::make_heap(_heap.begin(), _heap.end(), _greater);
-                std::pop_heap(_heap.begin(), _heap.end(), _greater);
-                _current = _heap.back();
-                _heap.pop_back();
+                while (_padded < _streams.size())
+                    _padded *= 2;
+                _streams.resize(_padded); // pad the leaves out to a full tree
+
+                _tree.assign(_padded, 0);
+                _winner = _build(1);
             }
 
             bool more() {
-                if (_remaining > 0 && (_first || !_heap.empty() || _current->more()))
+                if (_remaining > 0 && _liveStreams > 0 &&
+                    (_first || _liveStreams > 1 || _streams[_winner]->more()))
                     return true;
 
                 // We are done so clean up resources.
                 // Can't do this in next() due to lifetime guarantees of unowned Data.
-                _heap.clear();
-                _current.reset();
+                // The pool's thread may still be loading a block for a stream, so it has
+                // to go before the streams do.
+                _readAhead.reset();
+                _streams.clear();
+                _tree.clear();
+                _liveStreams = 0;
                 _remaining = 0;
 
                 return false;
@@ -316,22 +540,17 @@ namespace mongo {
 
                 if (_first) {
                     _first = false;
-                    return _current->current();
+                    return _streams[_winner]->current();
                 }
 
-                if (!_current->advance()) {
-                    verify(!_heap.empty());
-
-                    std::pop_heap(_heap.begin(), _heap.end(), _greater);
-                    _current = _heap.back();
-                    _heap.pop_back();
-                } else if (!_heap.empty() && _greater(_current, _heap.front())) {
-                    std::pop_heap(_heap.begin(), _heap.end(), _greater);
-                    std::swap(_current, _heap.back());
-                    std::push_heap(_heap.begin(), _heap.end(), _greater);
+                if (!_streams[_winner]->advance()) {
+                    _streams[_winner].reset();
+                    _liveStreams--;
                 }
+                _replay(_winner);
 
-                return _current->current();
+                verify(_streams[_winner]);
+                return _streams[_winner]->current();
             }
 
 
@@ -377,12 +596,66 @@ namespace mongo {
                 const Comparator _comp;
             };
 
+            /**
+             * Whether the stream at leaf 'a' should come out of the merge before the one
+             * at leaf 'b'. Exhausted and padding slots always lose, so they sink to the
+             * bottom of the tree; between live streams the comparator's fileNum tiebreak
+             * makes this a strict total order.
+             */
+            bool _beats(size_t a, size_t b) const {
+                if (!_streams[b])
+                    return true;
+                if (!_streams[a])
+                    return false;
+                return !_greater(_streams[a], _streams[b]);
+            }
+
+            /**
+             * Plays the initial tournament below 'node', recording each match's loser at
+             * that node, and returns the winning leaf.
+             */
+            size_t _build(size_t node) {
+                if (node >= _padded)
+                    return node - _padded;
+
+                const size_t left = _build(2 * node);
+                const size_t right = _build(2 * node + 1);
+                if (_beats(left, right)) {
+                    _tree[node] = right;
+                    return left;
+                }
+                _tree[node] = left;
+                return right;
+            }
+
+            /**
+             * Replays the matches on the path from 'leaf' to the root after that leaf's
+             * stream has advanced (or run out), updating _winner.
+             */
+            void _replay(size_t leaf) {
+                size_t cur = leaf;
+                for (size_t node = (_padded + leaf) / 2; node >= 1; node /= 2) {
+                    if (_beats(_tree[node], cur))
+                        std::swap(cur, _tree[node]);
+                }
+                _winner = cur;
+            }
+
             SortOptions _opts;
             unsigned long long _remaining;
             bool _first;
-            boost::shared_ptr<Stream> _current;
-            std::vector<boost::shared_ptr<Stream> > _heap; // MinHeap
             STLComparator _greater; // named so calls make sense
+
+            // Loser tree. Leaf i holds input i's stream, NULL once exhausted (or as
+            // padding); _tree[n] is the leaf that lost the match at internal node n.
+            std::vector<boost::shared_ptr<Stream> > _streams;
+            std::vector<size_t> _tree;
+            size_t _padded; // number of leaves, _streams.size() rounded up to a power of 2
+            size_t _winner; // leaf that won the last tournament
+            size_t _liveStreams;
+
+            // Loads spill-file blocks ahead of the merge; destroyed before _streams.
+            boost::scoped_ptr<ReadAheadPool<Key, Value> > _readAhead;
         };
 
         template <typename Key, typename Value, typename Comparator>
@@ -406,8 +679,9 @@ namespace mongo {
             void add(const Key& key, const Value& val) {
                 _data.push_back(std::make_pair(key, val));
 
-                _memUsed += key.memUsageForSorter();
-                _memUsed += val.memUsageForSorter();
+                const size_t memUsage = key.memUsageForSorter() + val.memUsageForSorter();
+                _memUsed += memUsage;
+                OperationMemoryTracker::chargeCurrent(memUsage);
 
                 if (_memUsed > _opts.maxMemoryUsageBytes)
                     spill();
@@ -473,6 +747,7 @@ namespace mongo {
 
                 _iters.push_back(boost::shared_ptr<Iterator>(writer.done()));
 
+                OperationMemoryTracker::releaseCurrent(_memUsed);
                 _memUsed = 0;
             }
 
@@ -571,8 +846,9 @@ namespace mongo {
 
                     _data.push_back(contender);
 
-                    _memUsed += key.memUsageForSorter();
-                    _memUsed += val.memUsageForSorter();
+                    const size_t memUsage = key.memUsageForSorter() + val.memUsageForSorter();
+                    _memUsed += memUsage;
+                    OperationMemoryTracker::chargeCurrent(memUsage);
 
                     if (_data.size() == _opts.limit)
                         std::make_heap(_data.begin(), _data.end(), less);
@@ -590,11 +866,13 @@ namespace mongo {
 
                 // Remove the old worst pair and insert the contender, adjusting _memUsed
 
-                _memUsed += key.memUsageForSorter();
-                _memUsed += val.memUsageForSorter();
-
-                _memUsed -= _data.front().first.memUsageForSorter();
-                _memUsed -= _data.front().second.memUsageForSorter();
+                const size_t addedMemUsage = key.memUsageForSorter() + val.memUsageForSorter();
+                const size_t removedMemUsage = _data.front().first.memUsageForSorter()
+                                             + _data.front().second.memUsageForSorter();
+                _memUsed += addedMemUsage;
+                _memUsed -= removedMemUsage;
+                OperationMemoryTracker::chargeCurrent(addedMemUsage);
+                OperationMemoryTracker::releaseCurrent(removedMemUsage);
 
                 std::pop_heap(_data.begin(), _data.end(), less);
                 _data.back() = contender;
@@ -748,6 +1026,7 @@ namespace mongo {
 
                 _iters.push_back(boost::shared_ptr<Iterator>(writer.done()));
 
+                OperationMemoryTracker::releaseCurrent(_memUsed);
                 _memUsed = 0;
             }
 
@@ -832,14 +1111,19 @@ namespace mongo {
         snappy::Compress(_buffer.buf(), _buffer.len(), &compressed);
         verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
 
+        // Always over the uncompressed bytes so decompression is covered too.
+        const uint32_t checksum = sorter::blockChecksum(_buffer.buf(), _buffer.len());
+
         try {
             if (compressed.size() < size_t(_buffer.len()/10*9)) {
                 const int32_t size = -int32_t(compressed.size()); // negative means compressed
                 _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+                _file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
                 _file.write(compressed.data(), compressed.size());
             } else {
                 const int32_t size = _buffer.len();
                 _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+                _file.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
                 _file.write(_buffer.buf(), _buffer.len());
             }
         } catch (const std::exception&) {
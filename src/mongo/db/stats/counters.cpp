@@ -40,41 +40,41 @@
 #include "mongo/util/log.h"
 
 namespace mongo {
-    OpCounters::OpCounters() {}
+    OpCounters::OpCounters() : _slab( kNumCounters ) {}
 
     void OpCounters::incInsertInWriteLock(int n) {
         RARELY _checkWrap();
-        _insert.fetchAndAdd(n);
+        _slab.increment(kInsert, n);
     }
 
     void OpCounters::gotInsert() {
         RARELY _checkWrap();
-        _insert.fetchAndAdd(1);
+        _slab.increment(kInsert);
     }
 
     void OpCounters::gotQuery() {
         RARELY _checkWrap();
-        _query.fetchAndAdd(1);
+        _slab.increment(kQuery);
     }
 
     void OpCounters::gotUpdate() {
         RARELY _checkWrap();
-        _update.fetchAndAdd(1);
+        _slab.increment(kUpdate);
     }
 
     void OpCounters::gotDelete() {
         RARELY _checkWrap();
-        _delete.fetchAndAdd(1);
+        _slab.increment(kDelete);
     }
 
     void OpCounters::gotGetMore() {
         RARELY _checkWrap();
-        _getmore.fetchAndAdd(1);
+        _slab.increment(kGetmore);
     }
 
     void OpCounters::gotCommand() {
         RARELY _checkWrap();
-        _command.fetchAndAdd(1);
+        _slab.increment(kCommand);
     }
 
     void OpCounters::gotOp( int op , bool isCommand ) {
@@ -99,66 +99,60 @@ namespace mongo {
     }
 
     void OpCounters::_checkWrap() {
-        const unsigned MAX = 1 << 30;
-        
-        bool wrap =
-            _insert.loadRelaxed() > MAX ||
-            _query.loadRelaxed() > MAX ||
-            _update.loadRelaxed() > MAX ||
-            _delete.loadRelaxed() > MAX ||
-            _getmore.loadRelaxed() > MAX ||
-            _command.loadRelaxed() > MAX;
-        
+        const long long MAX = 1 << 30;
+
+        bool wrap = false;
+        for ( int i = 0; i < kNumCounters; i++ ) {
+            if ( _slab.sum(i) > MAX ) {
+                wrap = true;
+                break;
+            }
+        }
+
         if ( wrap ) {
-            _insert.store(0);
-            _query.store(0);
-            _update.store(0);
-            _delete.store(0);
-            _getmore.store(0);
-            _command.store(0);
+            _slab.reset();
         }
     }
 
+    const AtomicUInt32 * OpCounters::_snapshot( int counter ) const {
+        _snapshots[counter].store( static_cast<unsigned>( _slab.sum(counter) ) );
+        return &_snapshots[counter];
+    }
+
     BSONObj OpCounters::getObj() const {
         BSONObjBuilder b;
-        b.append( "insert" , _insert.loadRelaxed() );
-        b.append( "query" , _query.loadRelaxed() );
-        b.append( "update" , _update.loadRelaxed() );
-        b.append( "delete" , _delete.loadRelaxed() );
-        b.append( "getmore" , _getmore.loadRelaxed() );
-        b.append( "command" , _command.loadRelaxed() );
+        b.appendNumber( "insert" , _slab.sum(kInsert) );
+        b.appendNumber( "query" , _slab.sum(kQuery) );
+        b.appendNumber( "update" , _slab.sum(kUpdate) );
+        b.appendNumber( "delete" , _slab.sum(kDelete) );
+        b.appendNumber( "getmore" , _slab.sum(kGetmore) );
+        b.appendNumber( "command" , _slab.sum(kCommand) );
         return b.obj();
     }
 
+    NetworkCounter::NetworkCounter() : _slab( kNumCounters ) {}
+
     void NetworkCounter::hit( long long bytesIn , long long bytesOut ) {
-        const long long MAX = 1ULL << 60;
-
-        // don't care about the race as its just a counter
-        bool overflow = _bytesIn > MAX || _bytesOut > MAX;
-
-        if ( overflow ) {
-            _lock.lock();
-            _overflows++;
-            _bytesIn = bytesIn;
-            _bytesOut = bytesOut;
-            _requests = 1;
-            _lock.unlock();
-        }
-        else {
-            _lock.lock();
-            _bytesIn += bytesIn;
-            _bytesOut += bytesOut;
-            _requests++;
-            _lock.unlock();
+        RARELY _checkOverflow();
+
+        _slab.increment(kBytesIn, bytesIn);
+        _slab.increment(kBytesOut, bytesOut);
+        _slab.increment(kRequests);
+    }
+
+    void NetworkCounter::_checkOverflow() {
+        const long long MAX = 1LL << 60;
+
+        if ( _slab.sum(kBytesIn) > MAX || _slab.sum(kBytesOut) > MAX ) {
+            _overflows.fetchAndAdd(1);
+            _slab.reset();
         }
     }
 
     void NetworkCounter::append( BSONObjBuilder& b ) {
-        _lock.lock();
-        b.appendNumber( "bytesIn" , _bytesIn );
-        b.appendNumber( "bytesOut" , _bytesOut );
-        b.appendNumber( "numRequests" , _requests );
-        _lock.unlock();
+        b.appendNumber( "bytesIn" , _slab.sum(kBytesIn) );
+        b.appendNumber( "bytesOut" , _slab.sum(kBytesOut) );
+        b.appendNumber( "numRequests" , _slab.sum(kRequests) );
     }
 
 
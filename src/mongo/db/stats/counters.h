@@ -37,13 +37,15 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/processinfo.h"
+#include "mongo/util/concurrency/counter_slab.h"
 #include "mongo/util/concurrency/spin_lock.h"
 
 namespace mongo {
 
     /**
-     * for storing operation counters
-     * note: not thread safe.  ok with that for speed
+     * for storing operation counters.  increments go to the calling thread's stripe of a
+     * CounterSlab, so the hot path never contends on a shared cache line; reads sum the
+     * stripes lazily.
      */
     class OpCounters {
     public:
@@ -60,26 +62,39 @@ namespace mongo {
         void gotOp( int op , bool isCommand );
 
         BSONObj getObj() const;
-        
-        // thse are used by snmp, and other things, do not remove
-        const AtomicUInt32 * getInsert() const { return &_insert; }
-        const AtomicUInt32 * getQuery() const { return &_query; }
-        const AtomicUInt32 * getUpdate() const { return &_update; }
-        const AtomicUInt32 * getDelete() const { return &_delete; }
-        const AtomicUInt32 * getGetMore() const { return &_getmore; }
-        const AtomicUInt32 * getCommand() const { return &_command; }
+
+        // thse are used by snmp, and other things, do not remove.
+        // Each call refreshes the pointed-to value from the striped cells; the pointer
+        // stays valid for the life of the OpCounters, but callers must call again to
+        // observe a fresh value.
+        const AtomicUInt32 * getInsert() const { return _snapshot( kInsert ); }
+        const AtomicUInt32 * getQuery() const { return _snapshot( kQuery ); }
+        const AtomicUInt32 * getUpdate() const { return _snapshot( kUpdate ); }
+        const AtomicUInt32 * getDelete() const { return _snapshot( kDelete ); }
+        const AtomicUInt32 * getGetMore() const { return _snapshot( kGetmore ); }
+        const AtomicUInt32 * getCommand() const { return _snapshot( kCommand ); }
+
+        // 64-bit totals which, unlike the snmp views above, never wrap; used by the stats
+        // history sampler
+        long long getInsertTotal() const { return _slab.sum( kInsert ); }
+        long long getQueryTotal() const { return _slab.sum( kQuery ); }
+        long long getUpdateTotal() const { return _slab.sum( kUpdate ); }
+        long long getDeleteTotal() const { return _slab.sum( kDelete ); }
+        long long getGetMoreTotal() const { return _slab.sum( kGetmore ); }
+        long long getCommandTotal() const { return _slab.sum( kCommand ); }
 
     private:
+        enum Counter {
+            kInsert = 0, kQuery, kUpdate, kDelete, kGetmore, kCommand, kNumCounters
+        };
+
         void _checkWrap();
-        
-        // todo: there will be a lot of cache line contention on these.  need to do something 
-        //       else eventually.
-        AtomicUInt32 _insert;
-        AtomicUInt32 _query;
-        AtomicUInt32 _update;
-        AtomicUInt32 _delete;
-        AtomicUInt32 _getmore;
-        AtomicUInt32 _command;
+        const AtomicUInt32 * _snapshot( int counter ) const;
+
+        CounterSlab _slab;
+
+        // refreshed-on-read 32-bit views of the striped cells for the pointer getters above
+        mutable AtomicUInt32 _snapshots[kNumCounters];
     };
 
     extern OpCounters globalOpCounters;
@@ -87,17 +102,21 @@ namespace mongo {
 
     class NetworkCounter {
     public:
-        NetworkCounter() : _bytesIn(0), _bytesOut(0), _requests(0), _overflows(0) {}
+        NetworkCounter();
         void hit( long long bytesIn , long long bytesOut );
         void append( BSONObjBuilder& b );
+
+        long long getBytesIn() const { return _slab.sum( kBytesIn ); }
+        long long getBytesOut() const { return _slab.sum( kBytesOut ); }
+        long long getRequests() const { return _slab.sum( kRequests ); }
+
     private:
-        long long _bytesIn;
-        long long _bytesOut;
-        long long _requests;
+        enum Counter { kBytesIn = 0, kBytesOut, kRequests, kNumCounters };
 
-        long long _overflows;
+        void _checkOverflow();
 
-        SpinLock _lock;
+        CounterSlab _slab;
+        AtomicInt64 _overflows;
     };
 
     extern NetworkCounter networkCounter;
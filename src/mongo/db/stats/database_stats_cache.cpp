@@ -0,0 +1,112 @@
+// database_stats_cache.cpp
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/db/stats/database_stats_cache.h"
+
+#include <map>
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+    // Maximum age of a cached per-database stats entry before dbStats/listDatabases
+    // recompute it. 0 disables the cache.
+    MONGO_EXPORT_SERVER_PARAMETER( databaseStatsCacheAgeMillis, int, 5000 );
+
+    namespace {
+
+        struct CachedEntry {
+            CachedEntry() : statsComputedAt(0), sizeOnDisk(0), sizeOnDiskComputedAt(0) {}
+
+            DatabaseStatsEntry stats;
+            unsigned long long statsComputedAt; // 0 if never computed
+
+            long long sizeOnDisk;
+            unsigned long long sizeOnDiskComputedAt; // 0 if never computed
+        };
+
+        SimpleMutex cacheMutex( "databaseStatsCache" );
+        typedef std::map<std::string, CachedEntry> CacheMap;
+        CacheMap statsCache;
+
+        bool fresh( unsigned long long computedAt ) {
+            if ( databaseStatsCacheAgeMillis <= 0 )
+                return false;
+            return computedAt != 0 &&
+                curTimeMillis64() - computedAt <
+                    static_cast<unsigned long long>( databaseStatsCacheAgeMillis );
+        }
+    }
+
+    bool DatabaseStatsCache::getStats( const std::string& dbname, DatabaseStatsEntry* out ) {
+        SimpleMutex::scoped_lock lk( cacheMutex );
+        CacheMap::const_iterator it = statsCache.find( dbname );
+        if ( it == statsCache.end() || !fresh( it->second.statsComputedAt ) )
+            return false;
+        *out = it->second.stats;
+        return true;
+    }
+
+    void DatabaseStatsCache::putStats( const std::string& dbname,
+                                       const DatabaseStatsEntry& entry ) {
+        if ( databaseStatsCacheAgeMillis <= 0 )
+            return;
+        SimpleMutex::scoped_lock lk( cacheMutex );
+        CachedEntry& cached = statsCache[dbname];
+        cached.stats = entry;
+        cached.statsComputedAt = curTimeMillis64();
+    }
+
+    bool DatabaseStatsCache::getSizeOnDisk( const std::string& dbname, long long* out ) {
+        SimpleMutex::scoped_lock lk( cacheMutex );
+        CacheMap::const_iterator it = statsCache.find( dbname );
+        if ( it == statsCache.end() || !fresh( it->second.sizeOnDiskComputedAt ) )
+            return false;
+        *out = it->second.sizeOnDisk;
+        return true;
+    }
+
+    void DatabaseStatsCache::putSizeOnDisk( const std::string& dbname, long long size ) {
+        if ( databaseStatsCacheAgeMillis <= 0 )
+            return;
+        SimpleMutex::scoped_lock lk( cacheMutex );
+        CachedEntry& cached = statsCache[dbname];
+        cached.sizeOnDisk = size;
+        cached.sizeOnDiskComputedAt = curTimeMillis64();
+    }
+
+    void DatabaseStatsCache::invalidate( const std::string& dbname ) {
+        SimpleMutex::scoped_lock lk( cacheMutex );
+        statsCache.erase( dbname );
+    }
+
+}
@@ -0,0 +1,88 @@
+// database_stats_cache.h
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <string>
+
+namespace mongo {
+
+    /**
+     * Aggregate size statistics for one database, as reported by dbStats. All values
+     * are unscaled; callers apply the user's 'scale' when rendering.
+     */
+    struct DatabaseStatsEntry {
+        DatabaseStatsEntry()
+            : collections(0),
+              objects(0),
+              dataSize(0),
+              storageSize(0),
+              numExtents(0),
+              indexes(0),
+              indexSize(0) {}
+
+        long long collections;
+        long long objects;
+        long long dataSize;
+        long long storageSize;
+        long long numExtents;
+        long long indexes;
+        long long indexSize;
+    };
+
+    /**
+     * Process-wide cache of per-database size statistics, refreshed at most once per
+     * databaseStatsCacheAgeMillis per database. Monitoring tools poll dbStats and
+     * listDatabases every few seconds; record counts and data sizes are already kept
+     * in memory by the engines (e.g. the WiredTiger size storer), but storage, index
+     * and on-disk sizes come from engine statistics and touch disk. With the cache,
+     * repeated polls are map reads that never visit the collections.
+     *
+     * Entries may be stale by at most the cache age, so ordinary writes need no
+     * invalidation hooks; dropDatabase invalidates explicitly.
+     */
+    class DatabaseStatsCache {
+    public:
+        /**
+         * @return true and fill in 'out' if a fresh enough entry exists. Always
+         * returns false when the cache is disabled (databaseStatsCacheAgeMillis <= 0).
+         */
+        static bool getStats( const std::string& dbname, DatabaseStatsEntry* out );
+        static void putStats( const std::string& dbname, const DatabaseStatsEntry& entry );
+
+        /** same, for the sizeOnDisk number reported by listDatabases */
+        static bool getSizeOnDisk( const std::string& dbname, long long* out );
+        static void putSizeOnDisk( const std::string& dbname, long long size );
+
+        /** drops any cached entry, forcing the next reader to recompute */
+        static void invalidate( const std::string& dbname );
+    };
+
+}
@@ -42,6 +42,8 @@ namespace mongo {
 
         virtual bool includeByDefault() const { return true; }
 
+        virtual bool includeInStatusSnapshot() const { return true; }
+
         virtual BSONObj generateSection(OperationContext* txn,
                                         const BSONElement& configElement) const {
 
@@ -123,6 +125,7 @@ namespace mongo {
     public:
         LockStatsServerStatusSection() : ServerStatusSection("locks"){}
         virtual bool includeByDefault() const { return true; }
+        virtual bool includeInStatusSnapshot() const { return true; }
 
         BSONObj generateSection(OperationContext* txn,
                                 const BSONElement& configElement) const {
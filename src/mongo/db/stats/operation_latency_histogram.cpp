@@ -0,0 +1,161 @@
+// operation_latency_histogram.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_latency_histogram.h"
+
+#include "mongo/db/commands/server_status.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+    OperationLatencyHistograms globalLatencyHistograms;
+
+    namespace {
+
+        int bucketFor( long long micros ) {
+            int bucket = 0;
+            while ( micros >= 2 && bucket < LatencyHistogram::kNumBuckets - 1 ) {
+                micros >>= 1;
+                bucket++;
+            }
+            return bucket;
+        }
+
+    }  // namespace
+
+    void LatencyHistogram::increment( long long micros ) {
+        if ( micros < 0 )
+            micros = 0;
+        _ops.fetchAndAdd( 1 );
+        _totalMicros.fetchAndAdd( micros );
+        _buckets[bucketFor( micros )].fetchAndAdd( 1 );
+    }
+
+    void LatencyHistogram::append( BSONObjBuilder& b ) const {
+        b.appendNumber( "ops", _ops.load() );
+        b.appendNumber( "totalMicros", _totalMicros.load() );
+
+        BSONObjBuilder hist( b.subobjStart( "histogram" ) );
+        for ( int i = 0; i < kNumBuckets; i++ ) {
+            const long long count = _buckets[i].load();
+            if ( count == 0 )
+                continue;
+            const long long lowerBound = ( i == 0 ) ? 0 : ( 1LL << i );
+            StringBuilder name;
+            name << lowerBound;
+            hist.appendNumber( name.str(), count );
+        }
+        hist.done();
+    }
+
+    OperationLatencyHistograms::OpType OperationLatencyHistograms::_opType( int op,
+                                                                            bool iscommand ) {
+        switch ( op ) {
+        case dbQuery:
+            return iscommand ? opCommand : opQuery;
+        case dbGetMore:
+            return opGetMore;
+        case dbInsert:
+            return opInsert;
+        case dbUpdate:
+            return opUpdate;
+        case dbDelete:
+            return opDelete;
+        default:
+            return opOther;
+        }
+    }
+
+    void OperationLatencyHistograms::record( int op,
+                                             bool iscommand,
+                                             long long totalMicros,
+                                             long long lockWaitMicros ) {
+        const OpType type = _opType( op, iscommand );
+        _total[type].increment( totalMicros );
+        _lockWait[type].increment( lockWaitMicros );
+    }
+
+    long long OperationLatencyHistograms::totalOpMicros() const {
+        long long total = 0;
+        for ( int i = 0; i < numOpTypes; i++ ) {
+            total += _total[i].totalMicros();
+        }
+        return total;
+    }
+
+    long long OperationLatencyHistograms::totalLockWaitMicros() const {
+        long long total = 0;
+        for ( int i = 0; i < numOpTypes; i++ ) {
+            total += _lockWait[i].totalMicros();
+        }
+        return total;
+    }
+
+    void OperationLatencyHistograms::append( BSONObjBuilder& b ) const {
+        static const char* typeNames[numOpTypes] =
+            { "query", "getmore", "command", "insert", "update", "delete", "other" };
+
+        for ( int type = 0; type < numOpTypes; type++ ) {
+            BSONObjBuilder typeBuilder( b.subobjStart( typeNames[type] ) );
+
+            BSONObjBuilder totalBuilder( typeBuilder.subobjStart( "total" ) );
+            _total[type].append( totalBuilder );
+            totalBuilder.done();
+
+            BSONObjBuilder lockWaitBuilder( typeBuilder.subobjStart( "lockWait" ) );
+            _lockWait[type].append( lockWaitBuilder );
+            lockWaitBuilder.done();
+
+            typeBuilder.done();
+        }
+    }
+
+    namespace {
+
+        class LatencyHistogramsSection : public ServerStatusSection {
+        public:
+            LatencyHistogramsSection() : ServerStatusSection( "latencyHistograms" ) {}
+
+            virtual bool includeByDefault() const { return false; }
+
+            virtual BSONObj generateSection(OperationContext* txn,
+                                            const BSONElement& configElement) const {
+                BSONObjBuilder b;
+                globalLatencyHistograms.append( b );
+                return b.obj();
+            }
+
+        } latencyHistogramsSection;
+
+    }  // namespace
+
+}  // namespace mongo
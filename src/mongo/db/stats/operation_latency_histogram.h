@@ -0,0 +1,113 @@
+// operation_latency_histogram.h
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+    /**
+     * Histogram of latencies in microseconds with exponentially sized buckets.
+     * Bucket 0 counts latencies below 2 microseconds and bucket i counts
+     * latencies in [2^i, 2^(i+1)) microseconds, so each bucket bounds its
+     * contents to within a factor of two -- enough resolution to tell a lock
+     * stall from a disk stall at the tail.
+     *
+     * increment() only touches atomic counters and may be called concurrently
+     * from many threads; append() may run while increments are in progress and
+     * then reflects a slightly stale but consistent-enough view.
+     */
+    class LatencyHistogram {
+    public:
+        static const int kNumBuckets = 32;
+
+        void increment( long long micros );
+
+        /**
+         * Appends { ops: N, totalMicros: N, histogram: { "<lowerBound>": N, ... } }
+         * to "b", where each histogram key is the bucket's lower bound in
+         * microseconds.  Empty buckets are omitted.
+         */
+        void append( BSONObjBuilder& b ) const;
+
+        long long ops() const { return _ops.load(); }
+        long long totalMicros() const { return _totalMicros.load(); }
+
+    private:
+        AtomicInt64 _ops;
+        AtomicInt64 _totalMicros;
+        AtomicInt64 _buckets[kNumBuckets];
+    };
+
+    /**
+     * Server-wide latency histograms, broken down by operation type and then by
+     * phase.  For every completed operation the total latency and the portion
+     * spent blocked acquiring locks are recorded, so a p999 spike can be
+     * attributed to lock waits versus everything else without attaching a
+     * debugger.  Reported by the "latencyHistograms" serverStatus section.
+     */
+    class OperationLatencyHistograms {
+    public:
+        /**
+         * Records one completed operation.  "op" is the wire protocol opcode
+         * (dbQuery, dbInsert, ...) and "iscommand" splits commands out of the
+         * dbQuery bucket, mirroring OpCounters.
+         */
+        void record( int op, bool iscommand, long long totalMicros, long long lockWaitMicros );
+
+        void append( BSONObjBuilder& b ) const;
+
+        // Totals across all operation types; used by the stats history sampler
+        long long totalOpMicros() const;
+        long long totalLockWaitMicros() const;
+
+    private:
+        enum OpType {
+            opQuery = 0,
+            opGetMore,
+            opCommand,
+            opInsert,
+            opUpdate,
+            opDelete,
+            opOther,
+            numOpTypes
+        };
+
+        static OpType _opType( int op, bool iscommand );
+
+        LatencyHistogram _total[numOpTypes];
+        LatencyHistogram _lockWait[numOpTypes];
+    };
+
+    extern OperationLatencyHistograms globalLatencyHistograms;
+
+}  // namespace mongo
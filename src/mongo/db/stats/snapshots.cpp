@@ -37,8 +37,14 @@
 
 #include "mongo/db/stats/snapshots.h"
 
+#include <boost/shared_ptr.hpp>
+
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/global_environment_experiment.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/stats/stats_history.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 
@@ -103,6 +109,17 @@ namespace mongo {
         return _snapshots[x];
     }
 
+    namespace {
+        // Latest published status snapshot. Replaced wholesale every cadence; only
+        // access through boost::atomic_load/atomic_store.
+        boost::shared_ptr<const BSONObj> statusSnapshot;
+    }
+
+    BSONObj getStatusSnapshot() {
+        boost::shared_ptr<const BSONObj> snap = boost::atomic_load(&statusSnapshot);
+        return snap ? *snap : BSONObj();
+    }
+
     void SnapshotThread::run() {
         Client::initThread("snapshot");
         Client& client = cc();
@@ -113,15 +130,31 @@ namespace mongo {
 
         while ( ! inShutdown() ) {
             try {
-                const SnapshotData* s = statsSnapshots.takeSnapshot();
-                prev = s;
+                // one-second history sample every tick; the heavier work below keeps its
+                // original four second cadence
+                globalStatsHistory.takeSample();
+
+                if ( numLoops % 4 == 0 ) {
+                    const SnapshotData* s = statsSnapshots.takeSnapshot();
+                    prev = s;
+
+                    // rebuild the cached copy of the expensive serverStatus sections so
+                    // monitoring scrapes can read them without touching the request path
+                    boost::scoped_ptr<OperationContext> txn(
+                            getGlobalEnvironment()->newOpCtx());
+                    BSONObjBuilder b;
+                    b.appendDate( "localTime" , jsTime() );
+                    appendStatusSnapshotSections( txn.get(), &b );
+                    boost::shared_ptr<const BSONObj> snap( new BSONObj( b.obj() ) );
+                    boost::atomic_store( &statusSnapshot, snap );
+                }
             }
             catch ( std::exception& e ) {
                 log() << "ERROR in SnapshotThread: " << e.what() << endl;
             }
 
             numLoops++;
-            sleepsecs(4);
+            sleepsecs(1);
         }
 
         client.shutdown();
@@ -108,6 +108,14 @@ namespace mongo {
         void run();
     };
 
+    /**
+     * Returns the latest immutable copy of the expensive serverStatus sections (lock
+     * stats, storage engine stats - see ServerStatusSection::includeInStatusSnapshot),
+     * rebuilt by the snapshot thread at its fixed cadence. Lock-free, so monitoring
+     * scrapes never perturb the request path. Empty until the first copy is published.
+     */
+    BSONObj getStatusSnapshot();
+
     extern Snapshots statsSnapshots;
     extern SnapshotThread snapshotThread;
 
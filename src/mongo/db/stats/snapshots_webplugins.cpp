@@ -119,5 +119,22 @@ namespace {
         virtual void init() {}
     } dbtopStatus;
 
+    class StatusSnapshotPlugin : public WebStatusPlugin {
+    public:
+        StatusSnapshotPlugin()
+            : WebStatusPlugin( "status snapshot" , 52 ,
+                               "cached expensive serverStatus sections, refreshed every 4 sec" ) {}
+        virtual void init() {}
+
+        virtual void run(OperationContext* txn, stringstream& ss) {
+            // reads the snapshot thread's latest copy; never takes the locks the live
+            // sections would
+            BSONObj snapshot = getStatusSnapshot();
+            if ( snapshot.isEmpty() )
+                return;
+            ss << "<pre>" << snapshot.jsonString( Strict, 1 ) << "</pre>\n";
+        }
+    } statusSnapshotPlugin;
+
 }  // namespace
 }  // namespace mongo
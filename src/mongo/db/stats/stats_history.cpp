@@ -0,0 +1,260 @@
+// stats_history.cpp
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/stats_history.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+    StatsHistory globalStatsHistory;
+
+    // How many one-second samples to retain; at a steady-state few dozen bytes per sample
+    // the default four hours costs well under a megabyte.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(statsHistorySeconds, int, 4 * 3600);
+
+    namespace {
+
+        const char* const kCounterNames[StatsHistory::kNumCounters] = {
+            "insert",
+            "query",
+            "update",
+            "delete",
+            "getmore",
+            "command",
+            "bytesIn",
+            "bytesOut",
+            "requests",
+            "opMicros",
+            "lockWaitMicros",
+        };
+
+        /**
+         * Appends "value" as a zigzag varint: the sign bit is moved to bit zero so small
+         * negative deltas stay small, then seven bits per byte, high bit set on all but
+         * the last.
+         */
+        void appendVarint( long long value, std::string* out ) {
+            unsigned long long zigzag =
+                ( static_cast<unsigned long long>( value ) << 1 ) ^
+                static_cast<unsigned long long>( value >> 63 );
+            do {
+                unsigned char byte = zigzag & 0x7F;
+                zigzag >>= 7;
+                if ( zigzag )
+                    byte |= 0x80;
+                out->push_back( static_cast<char>( byte ) );
+            } while ( zigzag );
+        }
+
+        long long readVarint( const char** pp ) {
+            unsigned long long zigzag = 0;
+            int shift = 0;
+            for ( ;; ) {
+                const unsigned char byte = static_cast<unsigned char>( *(*pp)++ );
+                zigzag |= static_cast<unsigned long long>( byte & 0x7F ) << shift;
+                if ( !( byte & 0x80 ) )
+                    break;
+                shift += 7;
+            }
+            return static_cast<long long>( zigzag >> 1 ) ^
+                   -static_cast<long long>( zigzag & 1 );
+        }
+
+    } // namespace
+
+    StatsHistory::StatsHistory()
+        : _lock( "StatsHistory" ),
+          _maxSamples( 0 ) {
+        for ( int i = 0; i < kNumCounters; i++ ) {
+            _base[i] = 0;
+            _last[i] = 0;
+        }
+    }
+
+    const char* StatsHistory::counterName( int counter ) {
+        verify( counter >= 0 && counter < kNumCounters );
+        return kCounterNames[counter];
+    }
+
+    void StatsHistory::takeSample() {
+        long long counters[kNumCounters];
+
+        counters[kInsert] = globalOpCounters.getInsertTotal();
+        counters[kQuery] = globalOpCounters.getQueryTotal();
+        counters[kUpdate] = globalOpCounters.getUpdateTotal();
+        counters[kDelete] = globalOpCounters.getDeleteTotal();
+        counters[kGetmore] = globalOpCounters.getGetMoreTotal();
+        counters[kCommand] = globalOpCounters.getCommandTotal();
+
+        counters[kBytesIn] = networkCounter.getBytesIn();
+        counters[kBytesOut] = networkCounter.getBytesOut();
+        counters[kRequests] = networkCounter.getRequests();
+
+        counters[kOpMicros] = globalLatencyHistograms.totalOpMicros();
+        counters[kLockWaitMicros] = globalLatencyHistograms.totalLockWaitMicros();
+
+        _record( curTimeMillis64(), counters );
+    }
+
+    void StatsHistory::_record( unsigned long long timeMillis, const long long* counters ) {
+        scoped_lock lk( _lock );
+
+        if ( _maxSamples == 0 ) {
+            _maxSamples = static_cast<size_t>( std::max( statsHistorySeconds, 60 ) );
+        }
+
+        Sample sample;
+        sample.timeMillis = timeMillis;
+        for ( int i = 0; i < kNumCounters; i++ ) {
+            appendVarint( counters[i] - _last[i], &sample.deltas );
+            _last[i] = counters[i];
+        }
+        _samples.push_back( sample );
+
+        while ( _samples.size() > _maxSamples ) {
+            // Fold the evicted sample into the base so the front stays reconstructible
+            const char* p = _samples.front().deltas.data();
+            for ( int i = 0; i < kNumCounters; i++ ) {
+                _base[i] += readVarint( &p );
+            }
+            _samples.pop_front();
+        }
+    }
+
+    void StatsHistory::query( unsigned long long startMillis,
+                              unsigned long long endMillis,
+                              BSONArrayBuilder* samples ) const {
+        scoped_lock lk( _lock );
+
+        long long absolute[kNumCounters];
+        for ( int i = 0; i < kNumCounters; i++ ) {
+            absolute[i] = _base[i];
+        }
+
+        for ( std::deque<Sample>::const_iterator it = _samples.begin();
+              it != _samples.end();
+              ++it ) {
+
+            const char* p = it->deltas.data();
+            for ( int i = 0; i < kNumCounters; i++ ) {
+                absolute[i] += readVarint( &p );
+            }
+
+            if ( it->timeMillis < startMillis || it->timeMillis > endMillis )
+                continue;
+
+            BSONObjBuilder b( samples->subobjStart() );
+            b.appendDate( "ts", Date_t( it->timeMillis ) );
+            for ( int i = 0; i < kNumCounters; i++ ) {
+                b.appendNumber( kCounterNames[i], absolute[i] );
+            }
+            b.doneFast();
+        }
+    }
+
+    /**
+     * Returns the retained one-second samples whose timestamps fall within the requested
+     * range, oldest first, with absolute counter values.
+     *
+     * Format: { statsHistory: 1, start: <Date>, end: <Date> }
+     *
+     * start and end are optional (Date or milliseconds since epoch) and default to the
+     * whole retained window.
+     */
+    class StatsHistoryCmd : public Command {
+    public:
+        StatsHistoryCmd() : Command( "statsHistory" ) {}
+
+        virtual bool slaveOk() const { return true; }
+        virtual bool adminOnly() const { return true; }
+        virtual bool isWriteCommandForConfigServer() const { return false; }
+
+        virtual void addRequiredPrivileges(const std::string& dbname,
+                                           const BSONObj& cmdObj,
+                                           std::vector<Privilege>* out) {
+            ActionSet actions;
+            actions.addAction(ActionType::serverStatus);
+            out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+        }
+
+        virtual void help( std::stringstream& h ) const {
+            h << "Returns retained one-second samples of server-wide counters, "
+                 "optionally restricted to { start: <Date>, end: <Date> }.";
+        }
+
+        bool run(OperationContext* txn,
+                 const std::string& dbname,
+                 BSONObj& cmdObj,
+                 int,
+                 std::string& errmsg,
+                 BSONObjBuilder& result,
+                 bool fromRepl) {
+
+            unsigned long long startMillis = 0;
+            unsigned long long endMillis = std::numeric_limits<unsigned long long>::max();
+
+            if ( !cmdObj["start"].eoo() ) {
+                startMillis = _millisOf( cmdObj["start"] );
+            }
+            if ( !cmdObj["end"].eoo() ) {
+                endMillis = _millisOf( cmdObj["end"] );
+            }
+
+            BSONArrayBuilder samples( result.subarrayStart( "samples" ) );
+            globalStatsHistory.query( startMillis, endMillis, &samples );
+            samples.doneFast();
+
+            return true;
+        }
+
+    private:
+        static unsigned long long _millisOf( const BSONElement& e ) {
+            if ( e.type() == Date )
+                return e.Date().millis;
+            uassert( 28716, "start/end must be dates or milliseconds", e.isNumber() );
+            return static_cast<unsigned long long>( e.numberLong() );
+        }
+
+    } statsHistoryCmd;
+
+} // namespace mongo
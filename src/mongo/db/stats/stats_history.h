@@ -0,0 +1,118 @@
+// stats_history.h
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include <deque>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/concurrency/mutex.h"
+
+namespace mongo {
+
+    /**
+     * High-resolution history of server-wide counters, sampled once per second by the
+     * snapshot thread and retained for hours, so that the evidence of a short incident is
+     * still there when someone comes looking after it has ended.
+     *
+     * Each sample stores the change of every counter since the previous sample as a
+     * zigzag varint, which keeps a steady-state sample to a few dozen bytes; absolute
+     * values are reconstructed by summing forward from the base of the ring. Retention is
+     * bounded at statsHistorySeconds samples (a startup parameter, default four hours),
+     * and the ring is queryable by time range through the statsHistory command.
+     */
+    class StatsHistory {
+        MONGO_DISALLOW_COPYING(StatsHistory);
+    public:
+        enum Counter {
+            kInsert = 0,
+            kQuery,
+            kUpdate,
+            kDelete,
+            kGetmore,
+            kCommand,
+            kBytesIn,
+            kBytesOut,
+            kRequests,
+            kOpMicros,
+            kLockWaitMicros,
+            kNumCounters
+        };
+
+        StatsHistory();
+
+        /**
+         * Reads the global counters (opcounters, network totals, latency and lock wait
+         * totals) and appends one sample to the ring. Called once per second by the
+         * snapshot thread.
+         */
+        void takeSample();
+
+        /**
+         * Appends one document per sample whose timestamp falls within
+         * [startMillis, endMillis], oldest first, with absolute counter values.
+         */
+        void query(unsigned long long startMillis,
+                   unsigned long long endMillis,
+                   BSONArrayBuilder* samples) const;
+
+        static const char* counterName(int counter);
+
+    private:
+        struct Sample {
+            unsigned long long timeMillis;
+
+            // kNumCounters zigzag varints: each counter's change since the previous sample
+            std::string deltas;
+        };
+
+        void _record(unsigned long long timeMillis, const long long* counters);
+
+        mutable mongo::mutex _lock;
+
+        std::deque<Sample> _samples;
+
+        // Absolute counter values just before the oldest stored sample; evicted samples
+        // fold their deltas in here so reconstruction can always start at the front.
+        long long _base[kNumCounters];
+
+        // Absolute counter values at the newest stored sample
+        long long _last[kNumCounters];
+
+        // Fixed after the first sample; zero until then so the startup parameter has been
+        // parsed by the time it is read.
+        size_t _maxSamples;
+    };
+
+    extern StatsHistory globalStatsHistory;
+
+} // namespace mongo
@@ -36,6 +36,8 @@
 
 #include "mongo/db/stats/top.h"
 
+#include "mongo/util/concurrency/threadlocal.h"
+
 #include "mongo/db/auth/action_set.h"
 #include "mongo/db/auth/action_type.h"
 #include "mongo/db/auth/authorization_manager.h"
@@ -65,19 +67,74 @@ namespace mongo {
 
     }
 
+    void Top::CollectionData::add( const CollectionData& other ) {
+        total.add( other.total );
+        readLock.add( other.readLock );
+        writeLock.add( other.writeLock );
+        queries.add( other.queries );
+        getmore.add( other.getmore );
+        insert.add( other.insert );
+        update.add( other.update );
+        remove.add( other.remove );
+        commands.add( other.commands );
+    }
+
+    // Each thread records into its own slice of Top::global, so the TSP is effectively part
+    // of the (singleton) global instance.
+    TSP_DECLARE(Top::ThreadUsage, topThreadUsage)
+    TSP_DEFINE(Top::ThreadUsage, topThreadUsage)
+
+    Top::ThreadUsage::~ThreadUsage() {
+        Top::global._retire( this );
+    }
+
+    Top::ThreadUsage* Top::_threadUsage() {
+        ThreadUsage* t = topThreadUsage.get();
+        if ( NULL == t ) {
+            t = new ThreadUsage();
+            {
+                SimpleMutex::scoped_lock lk(_lock);
+                t->lastDropped = _lastDropped;
+                _threads.push_back( t );
+            }
+            topThreadUsage.reset( t );
+        }
+        return t;
+    }
+
+    void Top::_retire( Top::ThreadUsage* tu ) {
+        SimpleMutex::scoped_lock lk(_lock);
+        _merge( &_retired, tu->usage );
+        for ( std::vector<ThreadUsage*>::iterator it = _threads.begin();
+                it != _threads.end(); ++it ) {
+            if ( *it == tu ) {
+                _threads.erase( it );
+                break;
+            }
+        }
+    }
+
+    // static
+    void Top::_merge( Top::UsageMap* into, const Top::UsageMap& from ) {
+        for ( UsageMap::const_iterator i = from.begin(); i != from.end(); ++i ) {
+            (*into)[i->first].add( i->second );
+        }
+    }
+
     void Top::record( const StringData& ns, int op, int lockType, long long micros, bool command ) {
         if ( ns[0] == '?' )
             return;
 
         //cout << "record: " << ns << "\t" << op << "\t" << command << endl;
-        SimpleMutex::scoped_lock lk(_lock);
+        ThreadUsage* t = _threadUsage();
+        SimpleMutex::scoped_lock lk(t->lock);
 
-        if ( ( command || op == dbQuery ) && ns == _lastDropped ) {
-            _lastDropped = "";
+        if ( ( command || op == dbQuery ) && ns == t->lastDropped ) {
+            t->lastDropped = "";
             return;
         }
 
-        CollectionData& coll = _usage[ns];
+        CollectionData& coll = t->usage[ns];
         _record( coll, op, lockType, micros, command );
     }
 
@@ -125,18 +182,28 @@ namespace mongo {
 
     void Top::collectionDropped( const StringData& ns ) {
         SimpleMutex::scoped_lock lk(_lock);
-        _usage.erase(ns);
+        _retired.erase(ns);
         _lastDropped = ns.toString();
+        for ( size_t i = 0; i < _threads.size(); i++ ) {
+            SimpleMutex::scoped_lock sl(_threads[i]->lock);
+            _threads[i]->usage.erase(ns);
+            _threads[i]->lastDropped = _lastDropped;
+        }
     }
 
     void Top::cloneMap(Top::UsageMap& out) const {
         SimpleMutex::scoped_lock lk(_lock);
-        out = _usage;
+        out = _retired;
+        for ( size_t i = 0; i < _threads.size(); i++ ) {
+            SimpleMutex::scoped_lock sl(_threads[i]->lock);
+            _merge( &out, _threads[i]->usage );
+        }
     }
 
     void Top::append( BSONObjBuilder& b ) {
-        SimpleMutex::scoped_lock lk( _lock );
-        _appendToUsageMap( b, _usage );
+        UsageMap merged;
+        cloneMap( merged );
+        _appendToUsageMap( b, merged );
     }
 
     void Top::_appendToUsageMap( BSONObjBuilder& b, const UsageMap& map ) const {
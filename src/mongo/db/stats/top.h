@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "mongo/util/concurrency/mutex.h"
@@ -54,6 +56,11 @@ namespace mongo {
                 count++;
                 time += micros;
             }
+
+            void add( const UsageData& other ) {
+                time  += other.time;
+                count += other.count;
+            }
         };
 
         struct CollectionData {
@@ -63,6 +70,8 @@ namespace mongo {
             CollectionData() {}
             CollectionData( const CollectionData& older, const CollectionData& newer );
 
+            void add( const CollectionData& other );
+
             UsageData total;
 
             UsageData readLock;
@@ -78,6 +87,23 @@ namespace mongo {
 
         typedef StringMap<CollectionData> UsageMap;
 
+        /**
+         * One thread's slice of the usage map.  record() only ever touches the calling
+         * thread's slice, so recording on the request path locks a mutex no other writer
+         * contends on; readers (the top command, collection stats) merge every live slice
+         * plus the retired counts of exited threads, paying the aggregation cost at read
+         * time instead of serializing every operation on one lock.
+         */
+        struct ThreadUsage {
+            ThreadUsage() : lock("Top::ThreadUsage") {}
+            ~ThreadUsage();
+
+            // Held by the owning thread in record() and by readers while merging.
+            SimpleMutex lock;
+            UsageMap usage;
+            std::string lastDropped;
+        };
+
     public:
         void record( const StringData& ns, int op, int lockType, long long micros, bool command );
         void append( BSONObjBuilder& b );
@@ -92,8 +118,24 @@ namespace mongo {
         void _appendStatsEntry( BSONObjBuilder& b, const char * statsName, const UsageData& map ) const;
         void _record( CollectionData& c, int op, int lockType, long long micros, bool command );
 
+        /**
+         * Returns the calling thread's slice, registering a new one on first use.
+         */
+        ThreadUsage* _threadUsage();
+
+        /**
+         * Called by ~ThreadUsage: folds an exiting thread's counts into _retired and
+         * unregisters the slice.
+         */
+        void _retire( ThreadUsage* tu );
+
+        static void _merge( UsageMap* into, const UsageMap& from );
+
+        // Protects _threads, _retired and _lastDropped.  record() does not take this lock;
+        // it is only held at thread registration/exit and by readers.
         mutable SimpleMutex _lock;
-        UsageMap _usage;
+        std::vector<ThreadUsage*> _threads;
+        UsageMap _retired;
         std::string _lastDropped;
     };
 
@@ -0,0 +1,100 @@
+// working_set_tracker.cpp
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/working_set_tracker.h"
+
+#include "mongo/db/commands/server_status.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+    WorkingSetTracker::WorkingSetTracker() {
+        // The sketch is fed synthetic addresses, so asking the OS whether the
+        // "page" is resident would be nonsense.
+        _tracker.disableSystemBlockInMemCheck();
+    }
+
+    // static
+    const void* WorkingSetTracker::_syntheticAddress(const StringData& ns, const RecordId& loc) {
+        // RecordAccessTracker works at 4KB page granularity (address >> 12). Shift the
+        // RecordId up by a page so that neighboring records (WiredTiger hands out
+        // consecutive 64-bit ids) land in distinct sketch pages, and spread
+        // collections apart with a namespace hash in the high bits.
+        const uint64_t nsHash = StringData::Hasher()(ns);
+        const uint64_t page = (nsHash << 44) ^ (static_cast<uint64_t>(loc.repr()) << 12);
+        return reinterpret_cast<const void*>(static_cast<uintptr_t>(page));
+    }
+
+    void WorkingSetTracker::markAccessed(const StringData& ns, const RecordId& loc) {
+        _accesses.fetchAndAdd(1);
+        _tracker.markAccessed(_syntheticAddress(ns, loc));
+    }
+
+    bool WorkingSetTracker::checkAccessedAndMark(const StringData& ns, const RecordId& loc) {
+        _accesses.fetchAndAdd(1);
+        if (!_tracker.checkAccessedAndMark(_syntheticAddress(ns, loc)))
+            return false;
+        _recentHits.fetchAndAdd(1);
+        return true;
+    }
+
+    namespace {
+        WorkingSetTracker globalTracker;
+    } // namespace
+
+    WorkingSetTracker& globalWorkingSetTracker() {
+        return globalTracker;
+    }
+
+    namespace {
+
+        class WorkingSetTrackerSSS : public ServerStatusSection {
+        public:
+            WorkingSetTrackerSSS() : ServerStatusSection( "workingSetTracker" ) {
+            }
+
+            virtual bool includeByDefault() const { return false; }
+
+            virtual BSONObj generateSection(OperationContext* txn,
+                                            const BSONElement& configElement) const {
+                const WorkingSetTracker& tracker = globalWorkingSetTracker();
+                BSONObjBuilder b;
+                b.appendNumber( "accesses", tracker.accesses() );
+                b.appendNumber( "recentHits", tracker.recentHits() );
+                return b.obj();
+            }
+
+        } workingSetTrackerSSS;
+
+    } // namespace
+
+} // namespace mongo
@@ -0,0 +1,88 @@
+// working_set_tracker.h
+
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects for
+*    all of the code used other than as permitted herein. If you modify file(s)
+*    with this exception, you may extend this exception to your version of the
+*    file(s), but you are not obligated to do so. If you do not wish to do so,
+*    delete this exception statement from your version. If you delete this
+*    exception statement from all source files in the program, then also delete
+*    it in the license file.
+*/
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/mmap_v1/record_access_tracker.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+    /**
+     * Storage-engine-neutral estimate of which records have been touched recently.
+     *
+     * This reuses the time-sliced access sketch from RecordAccessTracker (which, despite
+     * living under mmap_v1/, has no dependency on that engine), but feeds it synthetic
+     * addresses derived from a record's namespace and RecordId instead of real mmap
+     * pointers. A "recently accessed" answer therefore means the record was seen within
+     * the sketch's rotation window, regardless of which engine owns the data; it says
+     * nothing about physical memory and the system in-memory fallback is disabled.
+     *
+     * Used by replication prefetch to avoid re-warming records touched a moment ago, and
+     * surfaced through the 'workingSetTracker' serverStatus section. Thread-safe.
+     */
+    class WorkingSetTracker {
+        MONGO_DISALLOW_COPYING(WorkingSetTracker);
+    public:
+        WorkingSetTracker();
+
+        /**
+         * Informs the tracker that the record at 'loc' in 'ns' has been accessed.
+         */
+        void markAccessed(const StringData& ns, const RecordId& loc);
+
+        /**
+         * @return whether the record was already marked as recently accessed. Also has
+         * the side effect of marking it as accessed, like
+         * RecordAccessTracker::checkAccessedAndMark.
+         */
+        bool checkAccessedAndMark(const StringData& ns, const RecordId& loc);
+
+        long long accesses() const { return _accesses.load(); }
+        long long recentHits() const { return _recentHits.load(); }
+
+    private:
+        static const void* _syntheticAddress(const StringData& ns, const RecordId& loc);
+
+        RecordAccessTracker _tracker;
+
+        AtomicInt64 _accesses; // total calls into the tracker
+        AtomicInt64 _recentHits; // how often the record had been seen recently
+    };
+
+    /**
+     * The process-wide tracker. Safe to call from any thread.
+     */
+    WorkingSetTracker& globalWorkingSetTracker();
+
+} // namespace mongo
@@ -129,7 +129,8 @@ namespace mongo {
             return new EmptyRecordIterator();
         }
 
-        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn ) const {
+        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn,
+                                                               size_t numWanted = 0 ) const {
             std::vector<RecordIterator*> v;
             v.push_back( new EmptyRecordIterator() );
             return v;
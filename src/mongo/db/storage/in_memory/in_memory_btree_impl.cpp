@@ -32,9 +32,12 @@
 
 #include "mongo/db/storage/in_memory/in_memory_btree_impl.h"
 
+#include <algorithm>
 #include <boost/make_shared.hpp>
 #include <boost/shared_ptr.hpp>
-#include <set>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/storage/index_entry_comparison.h"
@@ -68,7 +71,441 @@ namespace {
         return bb.obj();
     }
 
-    typedef std::set<IndexKeyEntry, IndexEntryComparison> IndexSet;
+    /**
+     * Ordered (key, RecordId) container exposing the subset of the std::set interface the
+     * code below uses, but storing entries packed into fixed-size pages instead of one tree
+     * node plus one owned BSONObj allocation per entry.
+     *
+     * Within a page, a slot array keeps the entries in key order and each entry stores only
+     * the bytes of its key that differ from the page's base key (the key the page was last
+     * rewritten around), so long runs of nearly identical index keys share storage. Lookups
+     * binary search the pages by their smallest entry and then the slots of one page,
+     * reconstructing at most one key per probe into a stack buffer.
+     *
+     * Iterators are only valid until the container is next modified; cursors already
+     * re-seek by saved key across writes (see savePosition()/restorePosition() below).
+     */
+    class IndexSet {
+    public:
+        typedef IndexKeyEntry value_type;
+
+        class const_iterator {
+        public:
+            const_iterator() : _set(NULL), _page(0), _slot(0) {}
+
+            const IndexKeyEntry& operator*() const { return *_materialize(); }
+            const IndexKeyEntry* operator->() const { return _materialize(); }
+
+            const_iterator& operator++() {
+                dassert(_page < _set->_pages.size());
+                if (++_slot == _set->_pages[_page]->slots.size()) {
+                    ++_page;
+                    _slot = 0;
+                }
+                _entry.reset();
+                return *this;
+            }
+
+            const_iterator& operator--() {
+                if (_slot == 0) {
+                    dassert(_page > 0);
+                    --_page;
+                    _slot = _set->_pages[_page]->slots.size() - 1;
+                }
+                else {
+                    --_slot;
+                }
+                _entry.reset();
+                return *this;
+            }
+
+            bool operator==(const const_iterator& other) const {
+                return _page == other._page && _slot == other._slot;
+            }
+            bool operator!=(const const_iterator& other) const { return !(*this == other); }
+
+        private:
+            friend class IndexSet;
+
+            const_iterator(const IndexSet* set, size_t page, size_t slot)
+                : _set(set), _page(page), _slot(slot) {}
+
+            const IndexKeyEntry* _materialize() const {
+                if (!_entry) {
+                    char buffer[TempKeyMaxSize];
+                    const IndexKeyEntry entry =
+                        IndexSet::_entryAt(*_set->_pages[_page], _slot, buffer);
+                    _entry = boost::make_shared<IndexKeyEntry>(entry.key.getOwned(),
+                                                               entry.loc);
+                }
+                return _entry.get();
+            }
+
+            const IndexSet* _set;
+            size_t _page;
+            size_t _slot;
+
+            // Lazily reconstructed copy of the entry; shared so copying iterators is cheap.
+            mutable shared_ptr<IndexKeyEntry> _entry;
+        };
+
+        /**
+         * Minimal stand-in for std::reverse_iterator: refers to the entry just before its
+         * base iterator, so constructing one from end() yields the last entry and one from
+         * begin() is rend(). Not using std::reverse_iterator because our operator* returns
+         * a reference into the iterator itself, which would dangle off the temporary that
+         * std::reverse_iterator dereferences.
+         */
+        class const_reverse_iterator {
+        public:
+            explicit const_reverse_iterator(const const_iterator& base)
+                : _base(base), _valid(false) {}
+
+            const IndexKeyEntry& operator*() const { return *_position(); }
+            const IndexKeyEntry* operator->() const { return _position().operator->(); }
+
+            const_reverse_iterator& operator++() {
+                --_base;
+                _valid = false;
+                return *this;
+            }
+
+            bool operator==(const const_reverse_iterator& other) const {
+                return _base == other._base;
+            }
+            bool operator!=(const const_reverse_iterator& other) const {
+                return !(*this == other);
+            }
+
+        private:
+            const const_iterator& _position() const {
+                if (!_valid) {
+                    _current = _base;
+                    --_current;
+                    _valid = true;
+                }
+                return _current;
+            }
+
+            const_iterator _base;
+            mutable const_iterator _current;
+            mutable bool _valid;
+        };
+
+        explicit IndexSet(const IndexEntryComparison& comparator)
+            : _comparator(comparator), _size(0) {}
+
+        ~IndexSet() {
+            for (size_t i = 0; i < _pages.size(); i++) {
+                delete _pages[i];
+            }
+        }
+
+        const IndexEntryComparison& key_comp() const { return _comparator; }
+
+        bool empty() const { return _size == 0; }
+        size_t size() const { return _size; }
+
+        long long memUsageBytes() const {
+            long long bytes = sizeof(*this) + _pages.capacity() * sizeof(Page*);
+            for (size_t i = 0; i < _pages.size(); i++) {
+                const Page& page = *_pages[i];
+                bytes += sizeof(Page) + page.baseKey.capacity()
+                       + page.slots.capacity() * sizeof(uint16_t);
+            }
+            return bytes;
+        }
+
+        const_iterator begin() const { return const_iterator(this, 0, 0); }
+        const_iterator end() const { return const_iterator(this, _pages.size(), 0); }
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+        const_iterator lower_bound(const IndexKeyEntry& query) const {
+            if (_pages.empty())
+                return end();
+
+            const size_t pageIdx = _pageFor(query, false);
+            size_t lo = 0;
+            size_t hi = _pages[pageIdx]->slots.size();
+            while (lo < hi) {
+                const size_t mid = (lo + hi) / 2;
+                if (_compareAt(pageIdx, mid, query) < 0)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return _normalize(pageIdx, lo);
+        }
+
+        const_iterator upper_bound(const IndexKeyEntry& query) const {
+            if (_pages.empty())
+                return end();
+
+            const size_t pageIdx = _pageFor(query, true);
+            size_t lo = 0;
+            size_t hi = _pages[pageIdx]->slots.size();
+            while (lo < hi) {
+                const size_t mid = (lo + hi) / 2;
+                if (_compareAt(pageIdx, mid, query) <= 0)
+                    lo = mid + 1;
+                else
+                    hi = mid;
+            }
+            return _normalize(pageIdx, lo);
+        }
+
+        const_iterator find(const IndexKeyEntry& query) const {
+            const const_iterator it = lower_bound(query);
+            if (it == end() || _compareAt(it._page, it._slot, query) != 0)
+                return end();
+            return it;
+        }
+
+        std::pair<const_iterator, bool> insert(const IndexKeyEntry& entry) {
+            dassert(entry.key.objsize() < TempKeyMaxSize);
+
+            if (_pages.empty()) {
+                Page* page = new Page();
+                page->baseKey.assign(entry.key.objdata(), entry.key.objsize());
+                _pages.push_back(page);
+                _appendRecord(page, 0, entry);
+                _size++;
+                return std::make_pair(const_iterator(this, 0, 0), true);
+            }
+
+            const const_iterator pos = lower_bound(entry);
+            if (pos != end() && _compareAt(pos._page, pos._slot, entry) == 0)
+                return std::make_pair(pos, false);
+
+            // When the position is the first slot of a page, append to the previous page
+            // instead so pages fill from the back like the (sorted) bulk-loaded case.
+            size_t pageIdx;
+            size_t slot;
+            if (pos == end()) {
+                pageIdx = _pages.size() - 1;
+                slot = _pages[pageIdx]->slots.size();
+            }
+            else if (pos._slot == 0 && pos._page > 0) {
+                pageIdx = pos._page - 1;
+                slot = _pages[pageIdx]->slots.size();
+            }
+            else {
+                pageIdx = pos._page;
+                slot = pos._slot;
+            }
+
+            Page* page = _pages[pageIdx];
+            if (page->used + _recordSize(*page, entry) <= kPageBytes) {
+                _appendRecord(page, slot, entry);
+                _size++;
+                return std::make_pair(const_iterator(this, pageIdx, slot), true);
+            }
+
+            const std::pair<size_t, size_t> where = _rewritePage(pageIdx, slot, entry);
+            _size++;
+            return std::make_pair(const_iterator(this, where.first, where.second), true);
+        }
+
+        size_t erase(const IndexKeyEntry& entry) {
+            const const_iterator pos = lower_bound(entry);
+            if (pos == end() || _compareAt(pos._page, pos._slot, entry) != 0)
+                return 0;
+
+            // The entry's bytes go dead in the arena; they are reclaimed the next time the
+            // page fills up and is rewritten.
+            Page* page = _pages[pos._page];
+            page->slots.erase(page->slots.begin() + pos._slot);
+            if (page->slots.empty()) {
+                delete page;
+                _pages.erase(_pages.begin() + pos._page);
+            }
+            _size--;
+            return 1;
+        }
+
+    private:
+        friend class const_iterator;
+
+        enum {
+            kPageBytes = 4096,
+
+            // uint16 key length, uint16 prefix length, int64 RecordId
+            kEntryHeaderBytes = 2 + 2 + 8
+        };
+
+        struct Page {
+            Page() : used(0) {}
+
+            // Uncompressed copy of the key that entry prefixes refer to. Only changes when
+            // the page is rewritten, so removing any slot (even the first) stays cheap.
+            std::string baseKey;
+
+            std::vector<uint16_t> slots; // arena offset of each entry, in key order
+            size_t used;                 // arena bytes consumed, including dead entries
+            char arena[kPageBytes];
+        };
+
+        /**
+         * Reconstructs the full key for 'slot' into 'buffer', which must have room for
+         * TempKeyMaxSize bytes. The returned entry's key points into 'buffer'.
+         */
+        static IndexKeyEntry _entryAt(const Page& page, size_t slot, char* buffer) {
+            const char* record = page.arena + page.slots[slot];
+            uint16_t keyLen;
+            uint16_t prefixLen;
+            int64_t locRepr;
+            memcpy(&keyLen, record, sizeof(keyLen));
+            memcpy(&prefixLen, record + 2, sizeof(prefixLen));
+            memcpy(&locRepr, record + 4, sizeof(locRepr));
+            memcpy(buffer, page.baseKey.data(), prefixLen);
+            memcpy(buffer + prefixLen, record + kEntryHeaderBytes, keyLen - prefixLen);
+            return IndexKeyEntry(BSONObj(buffer), RecordId(locRepr));
+        }
+
+        int _compareAt(size_t pageIdx, size_t slot, const IndexKeyEntry& query) const {
+            char buffer[TempKeyMaxSize];
+            return _comparator.compare(_entryAt(*_pages[pageIdx], slot, buffer), query);
+        }
+
+        /**
+         * Returns the page that must hold the lower_bound (or, with 'upperBound' set, the
+         * upper_bound) of 'query', i.e. the last page whose smallest entry is strictly
+         * before that bound. A later page starting with an entry equal to the query must
+         * not be chosen for lower_bound, since equal entries (think duplicate keys probed
+         * with a null RecordId) may extend back into the previous page. Only call when
+         * there is at least one page.
+         */
+        size_t _pageFor(const IndexKeyEntry& query, bool upperBound) const {
+            size_t lo = 0;
+            size_t hi = _pages.size() - 1;
+            while (lo < hi) {
+                const size_t mid = (lo + hi + 1) / 2;
+                const int cmp = _compareAt(mid, 0, query);
+                if (cmp < 0 || (upperBound && cmp == 0))
+                    lo = mid;
+                else
+                    hi = mid - 1;
+            }
+            return lo;
+        }
+
+        const_iterator _normalize(size_t pageIdx, size_t slot) const {
+            if (slot == _pages[pageIdx]->slots.size()) {
+                ++pageIdx;
+                slot = 0;
+            }
+            return const_iterator(this, pageIdx, slot);
+        }
+
+        static size_t _commonPrefix(const Page& page, const IndexKeyEntry& entry) {
+            const char* key = entry.key.objdata();
+            const size_t limit = std::min(size_t(entry.key.objsize()), page.baseKey.size());
+            size_t common = 0;
+            while (common < limit && key[common] == page.baseKey[common]) {
+                common++;
+            }
+            return common;
+        }
+
+        static size_t _recordSize(const Page& page, const IndexKeyEntry& entry) {
+            return kEntryHeaderBytes + entry.key.objsize() - _commonPrefix(page, entry);
+        }
+
+        /**
+         * Appends the entry's record to the page's arena and inserts its offset at 'slot'.
+         * The caller has checked that it fits.
+         */
+        static void _appendRecord(Page* page, size_t slot, const IndexKeyEntry& entry) {
+            const uint16_t keyLen = entry.key.objsize();
+            const uint16_t prefixLen = _commonPrefix(*page, entry);
+            const int64_t locRepr = entry.loc.repr();
+            char* record = page->arena + page->used;
+            memcpy(record, &keyLen, sizeof(keyLen));
+            memcpy(record + 2, &prefixLen, sizeof(prefixLen));
+            memcpy(record + 4, &locRepr, sizeof(locRepr));
+            memcpy(record + kEntryHeaderBytes,
+                   entry.key.objdata() + prefixLen,
+                   keyLen - prefixLen);
+            page->slots.insert(page->slots.begin() + slot,
+                               static_cast<uint16_t>(page->used));
+            page->used += kEntryHeaderBytes + keyLen - prefixLen;
+        }
+
+        /**
+         * Packs 'entries' (already in key order) into fresh pages, starting a new page
+         * whenever 'limitBytes' of arena would be exceeded.
+         */
+        static std::vector<Page*> _encodeEntries(const std::vector<IndexKeyEntry>& entries,
+                                                 size_t limitBytes) {
+            std::vector<Page*> pages;
+            for (size_t i = 0; i < entries.size(); i++) {
+                if (!pages.empty() &&
+                    pages.back()->used + _recordSize(*pages.back(), entries[i])
+                        <= limitBytes) {
+                    _appendRecord(pages.back(), pages.back()->slots.size(), entries[i]);
+                    continue;
+                }
+                Page* page = new Page();
+                page->baseKey.assign(entries[i].key.objdata(), entries[i].key.objsize());
+                pages.push_back(page);
+                _appendRecord(page, 0, entries[i]);
+            }
+            return pages;
+        }
+
+        /**
+         * Rewrites a page that can no longer absorb an insert at 'slot', compacting out
+         * dead bytes and splitting into half-full pages if the live entries still do not
+         * fit. Returns the (page, slot) position of the newly inserted entry.
+         */
+        std::pair<size_t, size_t> _rewritePage(size_t pageIdx,
+                                               size_t slot,
+                                               const IndexKeyEntry& entry) {
+            Page* oldPage = _pages[pageIdx];
+
+            std::vector<IndexKeyEntry> entries;
+            entries.reserve(oldPage->slots.size() + 1);
+            char buffer[TempKeyMaxSize];
+            for (size_t i = 0; i < oldPage->slots.size(); i++) {
+                if (i == slot)
+                    entries.push_back(entry);
+                const IndexKeyEntry old = _entryAt(*oldPage, i, buffer);
+                entries.push_back(IndexKeyEntry(old.key.getOwned(), old.loc));
+            }
+            if (slot == oldPage->slots.size())
+                entries.push_back(entry);
+
+            std::vector<Page*> newPages = _encodeEntries(entries, kPageBytes);
+            if (newPages.size() > 1) {
+                // The live data needs more than one page; re-split at half capacity so both
+                // halves can keep absorbing inserts without splitting again right away.
+                for (size_t i = 0; i < newPages.size(); i++) {
+                    delete newPages[i];
+                }
+                newPages = _encodeEntries(entries, kPageBytes / 2);
+            }
+
+            _pages[pageIdx] = newPages[0];
+            _pages.insert(_pages.begin() + pageIdx + 1,
+                          newPages.begin() + 1, newPages.end());
+            delete oldPage;
+
+            // Locate the inserted entry among the new pages.
+            size_t n = slot;
+            for (size_t p = 0; p < newPages.size(); p++) {
+                if (n < newPages[p]->slots.size())
+                    return std::make_pair(pageIdx + p, n);
+                n -= newPages[p]->slots.size();
+            }
+            invariant(false);
+            return std::make_pair(size_t(0), size_t(0)); // not reached
+        }
+
+        const IndexEntryComparison _comparator;
+        std::vector<Page*> _pages; // ordered by smallest entry; pages are never empty
+        size_t _size;
+    };
 
     // taken from btree_logic.cpp
     Status dupKeyError(const BSONObj& key) {
@@ -90,9 +527,8 @@ namespace {
 
     class InMemoryBtreeBuilderImpl : public SortedDataBuilderInterface {
     public:
-        InMemoryBtreeBuilderImpl(IndexSet* data, long long* currentKeySize, bool dupsAllowed)
+        InMemoryBtreeBuilderImpl(IndexSet* data, bool dupsAllowed)
                 : _data(data),
-                  _currentKeySize( currentKeySize ),
                   _dupsAllowed(dupsAllowed),
                   _comparator(_data->key_comp()) {
             invariant(_data->empty());
@@ -110,42 +546,43 @@ namespace {
 
             if (!_data->empty()) {
                 // Compare specified key with last inserted key, ignoring its RecordId
-                int cmp = _comparator.compare(IndexKeyEntry(key, RecordId()), *_last);
-                if (cmp < 0 || (_dupsAllowed && cmp == 0 && loc < _last->loc)) {
+                int cmp = _comparator.compare(IndexKeyEntry(key, RecordId()),
+                                              IndexKeyEntry(_lastKey, _lastLoc));
+                if (cmp < 0 || (_dupsAllowed && cmp == 0 && loc < _lastLoc)) {
                     return Status(ErrorCodes::InternalError,
                                   "expected ascending (key, RecordId) order in bulk builder");
                 }
-                else if (!_dupsAllowed && cmp == 0 && loc != _last->loc) {
+                else if (!_dupsAllowed && cmp == 0 && loc != _lastLoc) {
                     return dupKeyError(key);
                 }
             }
 
             BSONObj owned = key.getOwned();
-            _last = _data->insert(_data->end(), IndexKeyEntry(owned, loc));
-            *_currentKeySize += key.objsize();
+            _data->insert(IndexKeyEntry(owned, loc));
+            _lastKey = owned;
+            _lastLoc = loc;
 
             return Status::OK();
         }
 
     private:
         IndexSet* const _data;
-        long long* _currentKeySize;
         const bool _dupsAllowed;
 
-        IndexEntryComparison _comparator;  // used by the bulk builder to detect duplicate keys
-        IndexSet::const_iterator _last;    // or (key, RecordId) ordering violations
+        IndexEntryComparison _comparator; // used by the bulk builder to detect duplicate keys
+        BSONObj _lastKey;                 // or (key, RecordId) ordering violations
+        RecordId _lastLoc;
     };
 
     class InMemoryBtreeImpl : public SortedDataInterface {
     public:
         InMemoryBtreeImpl(IndexSet* data)
             : _data(data) {
-            _currentKeySize = 0;
         }
 
         virtual SortedDataBuilderInterface* getBulkBuilder(OperationContext* txn,
                                                            bool dupsAllowed) {
-            return new InMemoryBtreeBuilderImpl(_data, &_currentKeySize, dupsAllowed);
+            return new InMemoryBtreeBuilderImpl(_data, dupsAllowed);
         }
 
         virtual Status insert(OperationContext* txn,
@@ -169,7 +606,6 @@ namespace {
 
             IndexKeyEntry entry(key.getOwned(), loc);
             if ( _data->insert(entry).second ) {
-                _currentKeySize += key.objsize();
                 txn->recoveryUnit()->registerChange(new IndexChange(_data, entry, true));
             }
             return Status::OK();
@@ -186,7 +622,6 @@ namespace {
             const size_t numDeleted = _data->erase(entry);
             invariant(numDeleted <= 1);
             if ( numDeleted == 1 ) {
-                _currentKeySize -= key.objsize();
                 txn->recoveryUnit()->registerChange(new IndexChange(_data, entry, false));
             }
         }
@@ -203,7 +638,7 @@ namespace {
         }
 
         virtual long long getSpaceUsedBytes( OperationContext* txn ) const {
-            return _currentKeySize + ( sizeof(IndexKeyEntry) * _data->size() );
+            return _data->memUsageBytes();
         }
 
         virtual Status dupKeyCheck(OperationContext* txn, const BSONObj& key, const RecordId& loc) {
@@ -483,7 +918,6 @@ namespace {
         };
 
         IndexSet* _data;
-        long long _currentKeySize;
     };
 } // namespace
 
@@ -30,14 +30,17 @@
 
 #include "mongo/db/storage/in_memory/in_memory_btree_impl.h"
 
+#include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
 #include "mongo/db/storage/in_memory/in_memory_recovery_unit.h"
+#include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/db/storage/sorted_data_interface_test_harness.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
 
+    using boost::scoped_ptr;
     using boost::shared_ptr;
 
     class InMemoryHarnessHelper : public HarnessHelper {
@@ -63,4 +66,84 @@ namespace mongo {
         return new InMemoryHarnessHelper();
     }
 
+    // Insert enough keys, out of order, to span many pages of the paged representation, then
+    // verify a forward cursor sees all of them in ascending order.
+    TEST( InMemoryBtreeImpl, ManyKeysAcrossPages ) {
+        scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
+        scoped_ptr<SortedDataInterface> sorted( harnessHelper->newSortedDataInterface( false ) );
+
+        const int nKeys = 2000;
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            WriteUnitOfWork uow( opCtx.get() );
+            for ( int i = 0; i < nKeys; i++ ) {
+                const int key = ( i * 7919 ) % nKeys; // visits every key in [0, nKeys) once
+                ASSERT_OK( sorted->insert( opCtx.get(),
+                                           BSON( "" << key ),
+                                           RecordId( 1, key * 2 ),
+                                           true ) );
+            }
+            uow.commit();
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            ASSERT_EQUALS( nKeys, sorted->numEntries( opCtx.get() ) );
+
+            scoped_ptr<SortedDataInterface::Cursor> cursor(
+                sorted->newCursor( opCtx.get(), 1 ) );
+            cursor->locate( BSON( "" << 0 ), RecordId::min() );
+            for ( int i = 0; i < nKeys; i++ ) {
+                ASSERT( !cursor->isEOF() );
+                ASSERT_EQUALS( BSON( "" << i ), cursor->getKey() );
+                ASSERT_EQUALS( RecordId( 1, i * 2 ), cursor->getRecordId() );
+                cursor->advance();
+            }
+            ASSERT( cursor->isEOF() );
+        }
+    }
+
+    // Delete every other key of a multi-page index and verify the survivors are intact.
+    TEST( InMemoryBtreeImpl, EraseAcrossPages ) {
+        scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
+        scoped_ptr<SortedDataInterface> sorted( harnessHelper->newSortedDataInterface( false ) );
+
+        const int nKeys = 2000;
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            WriteUnitOfWork uow( opCtx.get() );
+            for ( int i = 0; i < nKeys; i++ ) {
+                ASSERT_OK( sorted->insert( opCtx.get(),
+                                           BSON( "" << i ),
+                                           RecordId( 1, i * 2 ),
+                                           true ) );
+            }
+            uow.commit();
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            WriteUnitOfWork uow( opCtx.get() );
+            for ( int i = 0; i < nKeys; i += 2 ) {
+                sorted->unindex( opCtx.get(), BSON( "" << i ), RecordId( 1, i * 2 ), true );
+            }
+            uow.commit();
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            ASSERT_EQUALS( nKeys / 2, sorted->numEntries( opCtx.get() ) );
+
+            scoped_ptr<SortedDataInterface::Cursor> cursor(
+                sorted->newCursor( opCtx.get(), 1 ) );
+            cursor->locate( BSON( "" << 0 ), RecordId::min() );
+            for ( int i = 1; i < nKeys; i += 2 ) {
+                ASSERT( !cursor->isEOF() );
+                ASSERT_EQUALS( BSON( "" << i ), cursor->getKey() );
+                cursor->advance();
+            }
+            ASSERT( cursor->isEOF() );
+        }
+    }
+
 }
@@ -370,7 +370,7 @@ namespace mongo {
     }
 
     std::vector<RecordIterator*> InMemoryRecordStore::getManyIterators(
-            OperationContext* txn) const {
+            OperationContext* txn, size_t numWanted) const {
         std::vector<RecordIterator*> out;
         // TODO maybe find a way to return multiple iterators.
         out.push_back(new InMemoryRecordIterator(txn, _data->records, *this));
@@ -93,7 +93,8 @@ namespace mongo {
 
         virtual RecordIterator* getIteratorForRepair( OperationContext* txn ) const;
 
-        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn ) const;
+        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn,
+                                                               size_t numWanted = 0 ) const;
 
         virtual Status truncate( OperationContext* txn );
 
@@ -170,6 +170,20 @@ namespace mongo {
         void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
             const char* input = static_cast<const char*>(src);
             char* output = static_cast<char*>(dst);
+
+            // Inverting is XOR with all-ones, so flip whole machine words at a time.  The
+            // memcpy in/out keeps this correct for unaligned buffers and compiles to plain
+            // loads and stores (or wider vector ops) on the platforms we care about.
+            while (bytes >= sizeof(uint64_t)) {
+                uint64_t word;
+                memcpy(&word, input, sizeof(word));
+                word = ~word;
+                memcpy(output, &word, sizeof(word));
+                input += sizeof(word);
+                output += sizeof(word);
+                bytes -= sizeof(word);
+            }
+
             const char* const end = input + bytes;
             while (input != end) {
                 *output++ = ~(*input++);
@@ -0,0 +1,72 @@
+// key_string_bench.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/ordering.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+    MONGO_BENCHMARK(KeyStringFromInt) {
+        const BSONObj key = BSON("" << 42);
+        const Ordering allAscending = Ordering::make(BSONObj());
+        volatile size_t sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            sink += KeyString::make(key, allAscending, RecordId(17)).getSize();
+        }
+    }
+
+    MONGO_BENCHMARK(KeyStringFromCompoundStringKey) {
+        const BSONObj key = BSON("" << "some string of typical key length"
+                                 << "" << 12345
+                                 << "" << OID::gen());
+        const Ordering allAscending = Ordering::make(BSONObj());
+        volatile size_t sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            sink += KeyString::make(key, allAscending, RecordId(17)).getSize();
+        }
+    }
+
+    MONGO_BENCHMARK(KeyStringToBson) {
+        const Ordering allAscending = Ordering::make(BSONObj());
+        const KeyString ks = KeyString::make(BSON("" << "abcdefghij" << "" << 42),
+                                             allAscending);
+        volatile int sink = 0;
+        for (long long i = 0; i < _benchmarkIterations; i++) {
+            sink += KeyString::toBson(ks.getBuffer(), ks.getSize(), allAscending).nFields();
+        }
+    }
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/db/storage/kv/kv_catalog.h"
 
+#include <algorithm>
 #include <boost/scoped_ptr.hpp>
 #include <stdlib.h>
 
@@ -63,8 +64,9 @@ namespace {
 
         virtual void commit() {}
         virtual void rollback() {
-            boost::mutex::scoped_lock lk(_catalog->_identsLock);
-            _catalog->_idents.erase(_ident);
+            IdentBucket& bucket = _catalog->_bucketFor(_ident);
+            boost::mutex::scoped_lock lk(bucket.lock);
+            bucket.idents.erase(_ident);
         }
 
         KVCatalog* const _catalog;
@@ -79,8 +81,9 @@ namespace {
 
         virtual void commit() {}
         virtual void rollback() {
-            boost::mutex::scoped_lock lk(_catalog->_identsLock);
-            _catalog->_idents[_ident] = _entry;
+            IdentBucket& bucket = _catalog->_bucketFor(_ident);
+            boost::mutex::scoped_lock lk(bucket.lock);
+            bucket.idents[_ident] = _entry;
         }
 
         KVCatalog* const _catalog;
@@ -110,16 +113,24 @@ namespace {
 
     bool KVCatalog::_hasEntryCollidingWithRand() const {
         // Only called from init() so don't need to lock.
-        for (NSToIdentMap::const_iterator it = _idents.begin(); it != _idents.end(); ++it) {
-            if (StringData(it->first).endsWith(_rand))
-                return true;
+        for (int b = 0; b < kNumIdentBuckets; b++) {
+            const NSToIdentMap& idents = _identBuckets[b].idents;
+            for (NSToIdentMap::const_iterator it = idents.begin(); it != idents.end(); ++it) {
+                if (StringData(it->first).endsWith(_rand))
+                    return true;
+            }
         }
         return false;
     }
 
-    std::string KVCatalog::_newUniqueIdent(const StringData& ns, const char* kind) {
+    std::string KVCatalog::_newUniqueIdent(const StringData& ns,
+                                           const char* kind,
+                                           const StringData& tier) {
         // If this changes to not put _rand at the end, _hasEntryCollidingWithRand will need fixing.
         StringBuilder buf;
+        if ( !tier.empty() ) {
+            buf << tier << '/';
+        }
         if ( _directoryPerDb ) {
             buf << nsToDatabaseSubstring( ns ) << '/';
         }
@@ -129,6 +140,10 @@ namespace {
         return buf.str();
     }
 
+    KVCatalog::IdentBucket& KVCatalog::_bucketFor( const StringData& ns ) const {
+        return _identBuckets[StringData::Hasher()( ns ) % kNumIdentBuckets];
+    }
+
     void KVCatalog::init( OperationContext* opCtx ) {
         // No locking needed since called single threaded.
         scoped_ptr<RecordIterator> it( _rs->getIterator( opCtx ) );
@@ -141,7 +156,7 @@ namespace {
             // No rollback since this is just loading already committed data.
             string ns = obj["ns"].String();
             string ident = obj["ident"].String();
-            _idents[ns] = Entry( ident, loc );
+            _bucketFor( ns ).idents[ns] = Entry( ident, loc );
         }
 
         // In the unlikely event that we have used this _rand before generate a new one.
@@ -151,10 +166,18 @@ namespace {
     }
 
     void KVCatalog::getAllCollections( std::vector<std::string>* out ) const {
-        boost::mutex::scoped_lock lk( _identsLock );
-        for ( NSToIdentMap::const_iterator it = _idents.begin(); it != _idents.end(); ++it ) {
-            out->push_back( it->first );
+        for ( int b = 0; b < kNumIdentBuckets; b++ ) {
+            const IdentBucket& bucket = _identBuckets[b];
+            boost::mutex::scoped_lock lk( bucket.lock );
+            for ( NSToIdentMap::const_iterator it = bucket.idents.begin();
+                  it != bucket.idents.end();
+                  ++it ) {
+                out->push_back( it->first );
+            }
         }
+        // each bucket is sorted but the stripes interleave; restore the order the single
+        // map used to provide
+        std::sort( out->begin(), out->end() );
     }
 
     Status KVCatalog::newCollection( OperationContext* opCtx,
@@ -170,12 +193,21 @@ namespace {
                                              MODE_X));
         }
 
-        const string ident = _newUniqueIdent(ns, "collection");
+        // Collection data goes on the tier the options ask for; the engine creates the
+        // matching subdirectory when it sees the '/' in the ident. Indexes stay on the
+        // default (fast) tier, see below.
+        const string ident = _newUniqueIdent(ns, "collection", options.tier);
 
-        boost::mutex::scoped_lock lk( _identsLock );
-        Entry& old = _idents[ns.toString()];
-        if ( !old.ident.empty() ) {
-            return Status( ErrorCodes::NamespaceExists, "collection already exists" );
+        {
+            IdentBucket& bucket = _bucketFor( ns );
+            boost::mutex::scoped_lock lk( bucket.lock );
+            NSToIdentMap::const_iterator it = bucket.idents.find( ns.toString() );
+            if ( it != bucket.idents.end() && !it->second.ident.empty() ) {
+                return Status( ErrorCodes::NamespaceExists, "collection already exists" );
+            }
+            // reserve the slot; filled in below after the record store write, which must
+            // not run under the bucket lock. Erased again by AddIdentChange on rollback.
+            bucket.idents[ns.toString()];
         }
 
         opCtx->recoveryUnit()->registerChange(new AddIdentChange(this, ns));
@@ -196,15 +228,20 @@ namespace {
         if ( !res.isOK() )
             return res.getStatus();
 
-        old = Entry( ident, res.getValue() );
+        {
+            IdentBucket& bucket = _bucketFor( ns );
+            boost::mutex::scoped_lock lk( bucket.lock );
+            bucket.idents[ns.toString()] = Entry( ident, res.getValue() );
+        }
         LOG(1) << "stored meta data for " << ns << " @ " << res.getValue();
         return Status::OK();
     }
 
     std::string KVCatalog::getCollectionIdent( const StringData& ns ) const {
-        boost::mutex::scoped_lock lk( _identsLock );
-        NSToIdentMap::const_iterator it = _idents.find( ns.toString() );
-        invariant( it != _idents.end() );
+        IdentBucket& bucket = _bucketFor( ns );
+        boost::mutex::scoped_lock lk( bucket.lock );
+        NSToIdentMap::const_iterator it = bucket.idents.find( ns.toString() );
+        invariant( it != bucket.idents.end() );
         return it->second.ident;
     }
 
@@ -229,9 +266,10 @@ namespace {
 
         RecordId dl;
         {
-            boost::mutex::scoped_lock lk( _identsLock );
-            NSToIdentMap::const_iterator it = _idents.find( ns.toString() );
-            invariant( it != _idents.end() );
+            IdentBucket& bucket = _bucketFor( ns );
+            boost::mutex::scoped_lock lk( bucket.lock );
+            NSToIdentMap::const_iterator it = bucket.idents.find( ns.toString() );
+            invariant( it != bucket.idents.end() );
             dl = it->second.storedLoc;
         }
 
@@ -355,15 +393,26 @@ namespace {
             invariant( status.getValue() == loc );
         }
 
-        boost::mutex::scoped_lock lk( _identsLock );
-        const NSToIdentMap::iterator fromIt = _idents.find(fromNS.toString());
-        invariant(fromIt != _idents.end());
-
-        opCtx->recoveryUnit()->registerChange(new RemoveIdentChange(this, fromNS, fromIt->second));
-        opCtx->recoveryUnit()->registerChange(new AddIdentChange(this, toNS));
+        // The two namespaces may hash to different buckets; move the entry one bucket at
+        // a time rather than holding both locks. Readers cannot observe the intermediate
+        // state because the caller excludes them with its database X lock.
+        {
+            IdentBucket& fromBucket = _bucketFor( fromNS );
+            boost::mutex::scoped_lock lk( fromBucket.lock );
+            const NSToIdentMap::iterator fromIt = fromBucket.idents.find(fromNS.toString());
+            invariant(fromIt != fromBucket.idents.end());
+
+            opCtx->recoveryUnit()->registerChange(
+                    new RemoveIdentChange(this, fromNS, fromIt->second));
+            fromBucket.idents.erase(fromIt);
+        }
 
-        _idents.erase(fromIt);
-        _idents[toNS.toString()] = Entry( old["ident"].String(), loc );
+        {
+            IdentBucket& toBucket = _bucketFor( toNS );
+            boost::mutex::scoped_lock lk( toBucket.lock );
+            opCtx->recoveryUnit()->registerChange(new AddIdentChange(this, toNS));
+            toBucket.idents[toNS.toString()] = Entry( old["ident"].String(), loc );
+        }
 
         return Status::OK();
     }
@@ -379,17 +428,24 @@ namespace {
                                              MODE_X));
         }
 
-        boost::mutex::scoped_lock lk( _identsLock );
-        const NSToIdentMap::iterator it = _idents.find(ns.toString());
-        if (it == _idents.end()) {
-            return Status( ErrorCodes::NamespaceNotFound, "collection not found" );
-        }
+        Entry entry;
+        {
+            IdentBucket& bucket = _bucketFor( ns );
+            boost::mutex::scoped_lock lk( bucket.lock );
+            const NSToIdentMap::iterator it = bucket.idents.find(ns.toString());
+            if (it == bucket.idents.end()) {
+                return Status( ErrorCodes::NamespaceNotFound, "collection not found" );
+            }
 
-        opCtx->recoveryUnit()->registerChange(new RemoveIdentChange(this, ns, it->second));
+            entry = it->second;
+            opCtx->recoveryUnit()->registerChange(new RemoveIdentChange(this, ns, entry));
+            bucket.idents.erase(it);
+        }
 
-        LOG(1) << "deleting metadata for " << ns << " @ " << it->second.storedLoc;
-        _rs->deleteRecord( opCtx, it->second.storedLoc );
-        _idents.erase(it);
+        // the record store delete runs outside the bucket lock so lookups on other
+        // namespaces in this bucket don't stall behind it
+        LOG(1) << "deleting metadata for " << ns << " @ " << entry.storedLoc;
+        _rs->deleteRecord( opCtx, entry.storedLoc );
 
         return Status::OK();
     }
@@ -397,9 +453,12 @@ namespace {
     std::vector<std::string> KVCatalog::getAllIdentsForDB( const StringData& db ) const {
         std::vector<std::string> v;
 
-        {
-            boost::mutex::scoped_lock lk( _identsLock );
-            for ( NSToIdentMap::const_iterator it = _idents.begin(); it != _idents.end(); ++it ) {
+        for ( int b = 0; b < kNumIdentBuckets; b++ ) {
+            const IdentBucket& bucket = _identBuckets[b];
+            boost::mutex::scoped_lock lk( bucket.lock );
+            for ( NSToIdentMap::const_iterator it = bucket.idents.begin();
+                  it != bucket.idents.end();
+                  ++it ) {
                 NamespaceString ns( it->first );
                 if ( ns.db() != db )
                     continue;
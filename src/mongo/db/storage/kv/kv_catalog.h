@@ -104,8 +104,11 @@ namespace mongo {
          * Generates a new unique identifier for a new "thing".
          * @param ns - the containing ns
          * @param kind - what this "thing" is, likely collection or index
+         * @param tier - optional storage tier; becomes the leading directory of the ident
          */
-        std::string _newUniqueIdent(const StringData& ns, const char* kind);
+        std::string _newUniqueIdent(const StringData& ns,
+                                    const char* kind,
+                                    const StringData& tier = StringData());
 
         // Helpers only used by constructor and init(). Don't call from elsewhere.
         static std::string _newRand();
@@ -128,8 +131,22 @@ namespace mongo {
             RecordId storedLoc;
         };
         typedef std::map<std::string,Entry> NSToIdentMap;
-        NSToIdentMap _idents;
-        mutable boost::mutex _identsLock;
+
+        // The ns -> ident map is striped into buckets, each guarded by its own mutex, so
+        // lookups on the request path only contend with DDL touching a namespace in the
+        // same bucket. Bucket mutexes are never held across record store operations; DDL
+        // does its record store write outside the bucket lock and atomicity comes from the
+        // caller's database X lock on the namespace plus rollback Changes.
+        struct IdentBucket {
+            NSToIdentMap idents;
+            mutable boost::mutex lock;
+        };
+
+        static const int kNumIdentBuckets = 16;
+
+        IdentBucket& _bucketFor( const StringData& ns ) const;
+
+        mutable IdentBucket _identBuckets[kNumIdentBuckets];
     };
 
 }
@@ -95,6 +95,19 @@ namespace mongo {
         // optional
         virtual int flushAllFiles( bool sync ) { return 0; }
 
+        /**
+         * See StorageEngine::beginBackup. Optional; engines that cannot pin a
+         * checkpoint while accepting writes keep the default.
+         */
+        virtual Status beginBackup( OperationContext* opCtx,
+                                    bool incremental,
+                                    std::vector<std::string>* files ) {
+            return Status( ErrorCodes::CommandNotSupported,
+                           "the current storage engine does not support hot backup" );
+        }
+
+        virtual void endBackup( OperationContext* opCtx ) {}
+
         virtual bool isDurable() const = 0;
 
         /**
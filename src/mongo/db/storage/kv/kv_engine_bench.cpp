@@ -0,0 +1,212 @@
+// kv_engine_bench.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/db/storage/kv/kv_engine_bench.h"
+
+#include <boost/scoped_ptr.hpp>
+#include <vector>
+
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/platform/random.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+    const char* const kNs = "bench.coll";
+    const char* const kIdent = "bench-collection";
+    const int kPayloadBytes = 256;
+    const int kPreloadRecords = 10000;
+    const int kRecordsPerRange = 100;
+    const long long kCappedSizeBytes = 16 * 1024 * 1024;
+
+    class BenchOperationContext : public OperationContextNoop {
+    public:
+        explicit BenchOperationContext( KVEngine* engine )
+            : OperationContextNoop( engine->newRecoveryUnit() ) {
+        }
+    };
+
+    enum Workload {
+        SEQUENTIAL_INSERT,
+        RANDOM_POINT_READ,
+        RANGE_READ,
+        UPDATE_IN_PLACE,
+        CAPPED_APPEND
+    };
+
+    class KVWorkloadBenchmark : public benchmark::Benchmark {
+    public:
+        KVWorkloadBenchmark( const std::string& engineName,
+                             KVBenchHarness* (*factory)(),
+                             Workload workload,
+                             const char* workloadName )
+            : _name( engineName + "KV" + workloadName )
+            , _factory( factory )
+            , _workload( workload )
+            , _rand( 0 ) // fixed seed so runs are comparable
+            , _payload( kPayloadBytes, 'x' ) {
+        }
+
+        virtual std::string name() const { return _name; }
+
+        virtual void setUp() {
+            _harness.reset( _factory() );
+            KVEngine* engine = _harness->getEngine();
+
+            CollectionOptions options;
+            if ( _workload == CAPPED_APPEND ) {
+                options.capped = true;
+                options.cappedSize = kCappedSizeBytes;
+            }
+
+            BenchOperationContext opCtx( engine );
+            {
+                WriteUnitOfWork uow( &opCtx );
+                Status status = engine->createRecordStore( &opCtx, kNs, kIdent, options );
+                invariant( status.isOK() );
+                uow.commit();
+            }
+            _rs.reset( engine->getRecordStore( &opCtx, kNs, kIdent, options ) );
+
+            // Reads and updates need something to hit.
+            if ( _workload == RANDOM_POINT_READ ||
+                 _workload == RANGE_READ ||
+                 _workload == UPDATE_IN_PLACE ) {
+                for ( int i = 0; i < kPreloadRecords; i++ ) {
+                    WriteUnitOfWork uow( &opCtx );
+                    StatusWith<RecordId> res = _rs->insertRecord( &opCtx,
+                                                                  &_payload[0],
+                                                                  kPayloadBytes,
+                                                                  false );
+                    invariant( res.isOK() );
+                    _locs.push_back( res.getValue() );
+                    uow.commit();
+                }
+            }
+        }
+
+        virtual void tearDown() {
+            _locs.clear();
+            _rs.reset();
+            _harness.reset();
+        }
+
+        virtual void run( long long iterations ) {
+            KVEngine* engine = _harness->getEngine();
+            BenchOperationContext opCtx( engine );
+
+            switch ( _workload ) {
+            case SEQUENTIAL_INSERT:
+            case CAPPED_APPEND: {
+                for ( long long i = 0; i < iterations; i++ ) {
+                    WriteUnitOfWork uow( &opCtx );
+                    StatusWith<RecordId> res = _rs->insertRecord( &opCtx,
+                                                                  &_payload[0],
+                                                                  kPayloadBytes,
+                                                                  false );
+                    invariant( res.isOK() );
+                    uow.commit();
+                }
+                break;
+            }
+            case RANDOM_POINT_READ: {
+                volatile int sink = 0;
+                for ( long long i = 0; i < iterations; i++ ) {
+                    sink += _rs->dataFor( &opCtx, _randomLoc() ).size();
+                }
+                break;
+            }
+            case RANGE_READ: {
+                // One iteration is one kRecordsPerRange record scan from a random start.
+                volatile int sink = 0;
+                for ( long long i = 0; i < iterations; i++ ) {
+                    boost::scoped_ptr<RecordIterator> it(
+                        _rs->getIterator( &opCtx, _randomLoc() ) );
+                    for ( int j = 0; j < kRecordsPerRange && !it->isEOF(); j++ ) {
+                        const RecordId loc = it->getNext();
+                        sink += it->dataFor( loc ).size();
+                    }
+                }
+                break;
+            }
+            case UPDATE_IN_PLACE: {
+                for ( long long i = 0; i < iterations; i++ ) {
+                    WriteUnitOfWork uow( &opCtx );
+                    StatusWith<RecordId> res = _rs->updateRecord( &opCtx,
+                                                                  _randomLoc(),
+                                                                  &_payload[0],
+                                                                  kPayloadBytes,
+                                                                  false,
+                                                                  NULL );
+                    invariant( res.isOK() );
+                    uow.commit();
+                }
+                break;
+            }
+            }
+        }
+
+    private:
+        RecordId _randomLoc() {
+            return _locs[_rand.nextInt32( _locs.size() )];
+        }
+
+        const std::string _name;
+        KVBenchHarness* (*const _factory)();
+        const Workload _workload;
+        PseudoRandom _rand;
+        const std::vector<char> _payload;
+
+        boost::scoped_ptr<KVBenchHarness> _harness;
+        boost::scoped_ptr<RecordStore> _rs;
+        std::vector<RecordId> _locs;
+    };
+
+}  // namespace
+
+    void registerKVEngineBenchmarks( const std::string& engineName,
+                                     KVBenchHarness* (*factory)() ) {
+        benchmark::registerBenchmark( new KVWorkloadBenchmark(
+            engineName, factory, SEQUENTIAL_INSERT, "SequentialInsert" ) );
+        benchmark::registerBenchmark( new KVWorkloadBenchmark(
+            engineName, factory, RANDOM_POINT_READ, "RandomPointRead" ) );
+        benchmark::registerBenchmark( new KVWorkloadBenchmark(
+            engineName, factory, RANGE_READ, "RangeRead" ) );
+        benchmark::registerBenchmark( new KVWorkloadBenchmark(
+            engineName, factory, UPDATE_IN_PLACE, "UpdateInPlace" ) );
+        benchmark::registerBenchmark( new KVWorkloadBenchmark(
+            engineName, factory, CAPPED_APPEND, "CappedAppend" ) );
+    }
+
+}
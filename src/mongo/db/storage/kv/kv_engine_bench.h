@@ -0,0 +1,61 @@
+// kv_engine_bench.h
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace mongo {
+
+    class KVEngine;
+
+    /**
+     * One engine instance plus whatever it needs to stay alive (dbpath, connection).
+     * The workload benchmarks create one per benchmark, outside the timed region.
+     */
+    class KVBenchHarness {
+    public:
+        virtual ~KVBenchHarness() {}
+
+        // Valid for the life of this harness.
+        virtual KVEngine* getEngine() = 0;
+    };
+
+    /**
+     * Registers the standard KVEngine workload benchmarks (sequential insert, random
+     * point read, range read, update in place, capped append) against the engine the
+     * factory produces. Call once per engine at static initialization time, the same
+     * way MONGO_BENCHMARK registers; benchmark names come out as
+     * "<engineName>KV<Workload>" so one engine can be selected with the name filter.
+     */
+    void registerKVEngineBenchmarks( const std::string& engineName,
+                                     KVBenchHarness* (*factory)() );
+
+}
@@ -408,5 +408,49 @@ namespace mongo {
 
     }
 
+    TEST( KVCatalogTest, Tier1 ) {
+        scoped_ptr<KVHarnessHelper> helper( KVHarnessHelper::create() );
+        KVEngine* engine = helper->getEngine();
+
+        scoped_ptr<RecordStore> rs;
+        scoped_ptr<KVCatalog> catalog;
+        {
+            MyOperationContext opCtx( engine );
+            WriteUnitOfWork uow( &opCtx );
+            ASSERT_OK( engine->createRecordStore( &opCtx, "catalog", "catalog", CollectionOptions() ) );
+            rs.reset( engine->getRecordStore( &opCtx, "catalog", "catalog", CollectionOptions() ) );
+            catalog.reset( new KVCatalog( rs.get(), true, false, false) );
+            uow.commit();
+        }
+
+        { // collection lands under the tier directory
+            MyOperationContext opCtx( engine );
+            WriteUnitOfWork uow( &opCtx );
+            CollectionOptions options;
+            options.tier = "cold";
+            ASSERT_OK( catalog->newCollection( &opCtx, "a.b", options ) );
+            ASSERT_STRING_CONTAINS( catalog->getCollectionIdent( "a.b" ), "cold/" );
+            ASSERT_TRUE( catalog->isUserDataIdent( catalog->getCollectionIdent( "a.b" ) ) );
+            uow.commit();
+        }
+
+        { // indexes stay on the default tier
+            MyOperationContext opCtx( engine );
+            WriteUnitOfWork uow( &opCtx );
+
+            BSONCollectionCatalogEntry::MetaData md;
+            md.ns ="a.b";
+            md.indexes.push_back( BSONCollectionCatalogEntry::IndexMetaData( BSON( "name" << "foo" ),
+                                                                             false,
+                                                                             RecordId(),
+                                                                             false ) );
+            catalog->putMetaData( &opCtx, "a.b", md );
+            ASSERT_EQUALS( std::string::npos,
+                           catalog->getIndexIdent( &opCtx, "a.b", "foo" ).find( "cold/" ) );
+            uow.commit();
+        }
+
+    }
+
 
 }
@@ -32,15 +32,38 @@
 
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 
+#include <algorithm>
+
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 
     namespace {
         const std::string catalogInfo = "_mdb_catalog";
+
+        // Limits for the parallel catalog load in the constructor. Below the collection
+        // threshold the worker threads cost more than they save.
+        const int kMaxCatalogLoadThreads = 8;
+        const size_t kParallelCatalogLoadThreshold = 64;
+
+        void initCollectionsForDB( KVEngine* engine,
+                                   KVDatabaseCatalogEntry* dbEntry,
+                                   const std::vector<std::string>* collections,
+                                   Status* result ) {
+            try {
+                OperationContextNoop opCtx( engine->newRecoveryUnit() );
+                for ( size_t i = 0; i < collections->size(); i++ ) {
+                    dbEntry->initCollection( &opCtx, (*collections)[i] );
+                }
+            }
+            catch ( const DBException& ex ) {
+                *result = ex.toStatus();
+            }
+        }
     }
 
     class KVStorageEngine::RemoveDBChange : public RecoveryUnit::Change {
@@ -103,23 +126,70 @@ namespace mongo {
                                            _options.directoryForIndexes) );
             _catalog->init( &opCtx );
 
+            uow.commit();
+        }
+
+        {
             std::vector<std::string> collections;
             _catalog->getAllCollections( &collections );
 
+            typedef std::map<std::string, std::vector<std::string> > CollectionsByDbMap;
+            CollectionsByDbMap collectionsByDb;
             for ( size_t i = 0; i < collections.size(); i++ ) {
-                std::string coll = collections[i];
-                NamespaceString nss( coll );
-                string dbName = nss.db().toString();
+                NamespaceString nss( collections[i] );
+                collectionsByDb[ nss.db().toString() ].push_back( collections[i] );
+            }
 
+            for ( CollectionsByDbMap::const_iterator it = collectionsByDb.begin();
+                  it != collectionsByDb.end(); ++it ) {
                 // No rollback since this is only for committed dbs.
-                KVDatabaseCatalogEntry*& db = _dbs[dbName];
+                KVDatabaseCatalogEntry*& db = _dbs[it->first];
                 if ( !db ) {
-                    db = new KVDatabaseCatalogEntry( dbName, this );
+                    db = new KVDatabaseCatalogEntry( it->first, this );
                 }
-                db->initCollection( &opCtx, coll );
             }
 
-            uow.commit();
+            if ( _supportsDocLocking &&
+                 collectionsByDb.size() > 1 &&
+                 collections.size() >= kParallelCatalogLoadThreshold ) {
+                // Load databases in parallel, one task per database so no two workers
+                // touch the same database catalog entry. Everything read here committed
+                // above, and each worker reads through its own recovery unit. Engines
+                // whose record stores need external locking keep the serial path, since
+                // the no-op lockers below would not exclude each other.
+                const int nThreads = static_cast<int>(
+                    std::min( collectionsByDb.size(),
+                              static_cast<size_t>( kMaxCatalogLoadThreads ) ) );
+                log() << "loading catalog metadata for " << collections.size()
+                      << " collections in " << collectionsByDb.size()
+                      << " databases using " << nThreads << " threads";
+
+                std::vector<Status> results( collectionsByDb.size(), Status::OK() );
+                threadpool::ThreadPool pool( nThreads, "KVCatalogLoad-" );
+                size_t idx = 0;
+                for ( CollectionsByDbMap::const_iterator it = collectionsByDb.begin();
+                      it != collectionsByDb.end(); ++it, ++idx ) {
+                    pool.schedule( stdx::bind( &initCollectionsForDB,
+                                               _engine.get(),
+                                               _dbs[it->first],
+                                               &it->second,
+                                               &results[idx] ) );
+                }
+                pool.join();
+
+                for ( size_t i = 0; i < results.size(); i++ ) {
+                    fassert( 28717, results[i] );
+                }
+            }
+            else {
+                for ( CollectionsByDbMap::const_iterator it = collectionsByDb.begin();
+                      it != collectionsByDb.end(); ++it ) {
+                    KVDatabaseCatalogEntry* db = _dbs[it->first];
+                    for ( size_t i = 0; i < it->second.size(); i++ ) {
+                        db->initCollection( &opCtx, it->second[i] );
+                    }
+                }
+            }
         }
 
         opCtx.recoveryUnit()->commitAndRestart();
@@ -254,6 +324,16 @@ namespace mongo {
         return _engine->flushAllFiles( sync );
     }
 
+    Status KVStorageEngine::beginBackup( OperationContext* txn,
+                                         bool incremental,
+                                         std::vector<std::string>* files ) {
+        return _engine->beginBackup( txn, incremental, files );
+    }
+
+    void KVStorageEngine::endBackup( OperationContext* txn ) {
+        _engine->endBackup( txn );
+    }
+
     bool KVStorageEngine::isDurable() const {
         return _engine->isDurable();
     }
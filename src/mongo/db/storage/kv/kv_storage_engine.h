@@ -83,6 +83,12 @@ namespace mongo {
 
         virtual int flushAllFiles( bool sync );
 
+        virtual Status beginBackup( OperationContext* txn,
+                                    bool incremental,
+                                    std::vector<std::string>* files );
+
+        virtual void endBackup( OperationContext* txn );
+
         virtual bool isDurable() const;
 
         virtual Status repairRecordStore(OperationContext* txn, const std::string& ns);
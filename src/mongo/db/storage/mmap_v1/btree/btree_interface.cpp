@@ -213,6 +213,20 @@ namespace mongo {
                 }
             }
 
+            virtual size_t nextBatch(vector<IndexKeyEntry>* entries, size_t maxToFill) {
+                // Walk the tree directly so that filling a batch costs one virtual call
+                // rather than three per entry.
+                size_t numAppended = 0;
+                while (numAppended < maxToFill && !_bucket.isNull()) {
+                    entries->push_back(IndexKeyEntry(
+                            _btree->getKey(_txn, _bucket, _ofs).getOwned(),
+                            _btree->getDiskLoc(_txn, _bucket, _ofs).toRecordId()));
+                    _btree->advance(_txn, &_bucket, &_ofs, _direction);
+                    numAppended++;
+                }
+                return numAppended;
+            }
+
             virtual void savePosition() {
                 if (!_bucket.isNull()) {
                     _saved.bucket = _bucket;
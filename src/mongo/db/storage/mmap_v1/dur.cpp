@@ -115,6 +115,27 @@ namespace {
     // Remap loop state
     unsigned remapFileToStartAt;
 
+    // Hand-off slot between durThread and the journal writer thread. durThread deposits at
+    // most one prepared section here and the writer consumes it, so the write to the journal
+    // file and the apply to the shared view for group commit N happen while durThread is
+    // already preparing the log buffer for group commit N + 1. All of the state below is
+    // guarded by journalWriterMutex.
+    struct JournalBatch {
+        JournalBatch() : builder(NULL), commitNumber(0) { }
+
+        JSectHeader header;
+        const AlignedBuilder* builder;
+        NotifyAll::When commitNumber;
+    };
+
+    boost::mutex journalWriterMutex;
+    boost::condition_variable journalWriterWork;  // a batch was queued (or shutdown requested)
+    boost::condition_variable journalWriterDrain; // the queued batch was written and applied
+
+    JournalBatch journalBatch;
+    bool journalBatchPending = false; // a batch is deposited, but not yet picked up
+    bool journalWriterBusy = false;   // the writer is working on a picked-up batch
+
 
     /**
      * MMAP V1 durability server status section.
@@ -238,6 +259,125 @@ namespace {
     }
 
 
+    //
+    // Journal writer thread
+    //
+
+    /**
+     * Writes out prepared sections handed off by durThread. For each batch this performs the
+     * I/O to the journal file, acknowledges the commit to any waiting getLastError j:true
+     * callers (reaching the journal is what they are waiting for) and then applies the
+     * section on top of the shared view. Running these phases on their own thread lets
+     * durThread prepare the log buffer for the next group commit while the previous one is
+     * still being fsynced.
+     */
+    static void journalWriterThread() {
+        Client::initThread("journal writer");
+
+        while (true) {
+            JournalBatch batch;
+
+            {
+                boost::mutex::scoped_lock lk(journalWriterMutex);
+
+                while (!journalBatchPending) {
+                    if (shutdownRequested.loadRelaxed()) {
+                        cc().shutdown();
+                        return;
+                    }
+
+                    journalWriterWork.wait(lk);
+                }
+
+                batch = journalBatch;
+                journalBatchPending = false;
+                journalWriterBusy = true;
+            }
+
+            try {
+                // This performs an I/O to the journal file
+                WRITETOJOURNAL(batch.header, *batch.builder);
+
+                // Data is now in the journal, which is sufficient for acknowledging
+                // getLastError. Note that the next group commit may already have begun, which
+                // is alright because we acknowledge with the commit number captured when this
+                // batch was prepared; writers which came in later wait for the next batch.
+                commitJob._notify.notifyAll(batch.commitNumber);
+
+                // Apply the journal entries on top of the shared view so that when flush is
+                // requested it would write the latest.
+                WRITETODATAFILES(batch.header, *batch.builder);
+            }
+            catch (DBException& e) {
+                severe() << "dbexception in journalWriterThread causing immediate shutdown: "
+                         << e.toString();
+                invariant(false);
+            }
+            catch (std::ios_base::failure& e) {
+                severe() << "ios_base exception in journalWriterThread causing immediate "
+                         << "shutdown: " << e.what();
+                invariant(false);
+            }
+            catch (std::bad_alloc& e) {
+                severe() << "bad_alloc exception in journalWriterThread causing immediate "
+                         << "shutdown: " << e.what();
+                invariant(false);
+            }
+            catch (std::exception& e) {
+                severe() << "exception in journalWriterThread causing immediate shutdown: "
+                         << e.what();
+                invariant(false);
+            }
+            catch (...) {
+                severe() << "unhandled exception in journalWriterThread causing immediate "
+                         << "shutdown";
+                invariant(false);
+            }
+
+            {
+                boost::mutex::scoped_lock lk(journalWriterMutex);
+                journalWriterBusy = false;
+                journalWriterDrain.notify_all();
+            }
+        }
+    }
+
+    /**
+     * Hands a prepared section to the journal writer thread. Blocks until the previous batch
+     * has been fully written and applied, so there is never more than one batch in flight and
+     * the log buffer which is not being queued here is guaranteed to be reusable.
+     */
+    static void queueJournalBatch(const JSectHeader& h,
+                                  const AlignedBuilder* builder,
+                                  NotifyAll::When commitNumber) {
+        boost::mutex::scoped_lock lk(journalWriterMutex);
+
+        while (journalBatchPending || journalWriterBusy) {
+            journalWriterDrain.wait(lk);
+        }
+
+        journalBatch.header = h;
+        journalBatch.builder = builder;
+        journalBatch.commitNumber = commitNumber;
+        journalBatchPending = true;
+
+        journalWriterWork.notify_one();
+    }
+
+    /**
+     * Waits until any handed-off batch is on disk in the journal and applied to the shared
+     * view. If no new writes can come in (e.g., because the flush lock is held), after this
+     * returns the shared view is fully caught up with everything that has been committed.
+     */
+    static void waitForJournalBatchDrain() {
+        boost::mutex::scoped_lock lk(journalWriterMutex);
+
+        while (journalBatchPending || journalWriterBusy) {
+            journalWriterDrain.wait(lk);
+        }
+    }
+
+
     //
     // DurableInterface
     //
@@ -289,6 +429,11 @@ namespace {
         flushRequested.notify_one();
         commitJob._notify.waitFor(when);
 
+        // The notification above fires when the commit is in the journal. Callers such as
+        // syncDataAndTruncateJournal also need it applied to the shared view before they
+        // flush the data files, so wait for the journal writer to finish the batch.
+        waitForJournalBatchDrain();
+
         return true;
     }
 
@@ -335,6 +480,10 @@ namespace {
         flushRequested.notify_one();
         commitJob._notify.waitFor(when);
 
+        // Don't let the rest of shutdown start closing files until the last batch has also
+        // been applied to the shared view.
+        waitForJournalBatchDrain();
+
         shutdownRequested.store(1);
     }
 
@@ -558,12 +707,21 @@ namespace {
 
         }
 
-        // Pre-allocated buffer for building the journal
-        AlignedBuilder journalBuilder(4 * 1024 * 1024);
+        // The thread which writes queued sections to the journal and applies them to the
+        // shared view; see journalWriterThread
+        boost::thread journalWriter(journalWriterThread);
+
+        // Pre-allocated buffers for building the journal. Two of them, used in alternation,
+        // so one can be filled by PREPLOGBUFFER while the journal writer is still flushing
+        // the other. queueJournalBatch guarantees at most one is ever in flight.
+        AlignedBuilder journalBuilderA(4 * 1024 * 1024);
+        AlignedBuilder journalBuilderB(4 * 1024 * 1024);
+        AlignedBuilder* journalBuilder = &journalBuilderA;
 
         // Used as an estimate of how much to remap
         uint64_t estimatedPrivateMapSize(0);
         uint64_t remapLastTimestamp(0);
+        unsigned commitsSinceRemap(0);
 
         while (shutdownRequested.loadRelaxed() == 0) {
             unsigned ms = mmapv1GlobalOptions.journalCommitInterval;
@@ -612,9 +770,14 @@ namespace {
                 }
                 else {
                     JSectHeader h;
-                    PREPLOGBUFFER(h, journalBuilder);
+                    PREPLOGBUFFER(h, *journalBuilder);
 
                     estimatedPrivateMapSize += commitJob.bytes();
+                    commitsSinceRemap++;
+
+                    // Capture the commit number now; by the time the journal writer gets to
+                    // acknowledge this batch, commitingBegin may have been called again.
+                    const NotifyAll::When commitNumber = commitJob.commitNumber();
 
                     // Need to reset the commit job's contents while under the S flush lock,
                     // because otherwise someone might have done a write and this would wipe out
@@ -628,51 +791,67 @@ namespace {
                     //
                     // TODO: Instead of the time-based logic above, consider using ProcessInfo and
                     //       watching for getResidentSize to drop, which is more precise.
-                    double remapFraction = (curTimeMicros64() - remapLastTimestamp) / 2000000.0;
-
-                    if (mmapv1GlobalOptions.journalOptions &
-                                MMAPV1Options::JournalAlwaysRemap) {
-                        remapFraction = 1;
-                    }
-                    else {
-                        // We don't want to get close to the UncommittedBytesLimit
-                        const double f =
-                            estimatedPrivateMapSize / ((double)UncommittedBytesLimit);
-                        if (f > remapFraction) {
-                            remapFraction = f;
+                    const bool shouldRemap =
+                        (estimatedPrivateMapSize >= UncommittedBytesLimit) ||
+                        (commitsSinceRemap >= NumCommitsBeforeRemap) ||
+                        (mmapv1GlobalOptions.journalOptions & MMAPV1Options::JournalAlwaysRemap);
+
+                    if (shouldRemap) {
+                        double remapFraction =
+                            (curTimeMicros64() - remapLastTimestamp) / 2000000.0;
+
+                        if (mmapv1GlobalOptions.journalOptions &
+                                    MMAPV1Options::JournalAlwaysRemap) {
+                            remapFraction = 1;
+                        }
+                        else {
+                            // We don't want to get close to the UncommittedBytesLimit
+                            const double f =
+                                estimatedPrivateMapSize / ((double)UncommittedBytesLimit);
+                            if (f > remapFraction) {
+                                remapFraction = f;
+                            }
                         }
-                    }
 
-                    // This performs an I/O to the journal file
-                    WRITETOJOURNAL(h, journalBuilder);
+                        // Keep the S flush lock so no new writes land in the private view
+                        // between this batch and the remap, and wait for the journal writer to
+                        // put the batch in the journal and on the shared view.
+                        queueJournalBatch(h, journalBuilder, commitNumber);
+                        waitForJournalBatchDrain();
 
-                    // Data is now in the journal, which is sufficient for acknowledging
-                    // getLastError. Note that we are doing this outside of the flush lock, which
-                    // is alright because we will acknowledge the previous commit. If any writes
-                    // happened after we released the flush lock, those will not be in the
-                    // journalBuilder and hence will not be persisted, but in this case
-                    // commitJob.commitingBegin() bumps the commit number, so those writers will
-                    // wait for the next run of this loop.
-                    commitJob.committingNotifyCommitted();
+                        // Data has now been written to the shared view. Upgrade the flush lock
+                        // to X so no writes can happen and remap the private view.
+                        autoFlushLock.upgradeFlushLockToExclusive();
+                        remapPrivateView(remapFraction);
 
-                    // Apply the journal entries on top of the shared view so that when flush
-                    // is requested it would write the latest.
-                    WRITETODATAFILES(h, journalBuilder);
+                        autoFlushLock.release();
 
-                    // Data has now been written to the shared view. Upgrade the flush lock to X so
-                    // no writes can happen and remap the private view.
-                    autoFlushLock.upgradeFlushLockToExclusive();
-                    remapPrivateView(remapFraction);
-
-                    autoFlushLock.release();
+                        // Reset the private map estimate outside of the lock
+                        estimatedPrivateMapSize = 0;
+                        commitsSinceRemap = 0;
+                        remapLastTimestamp = curTimeMicros64();
+                    }
+                    else {
+                        // The rest of the work happens on the journal writer thread, which
+                        // does not need the commit job or the private view, so new writes can
+                        // be let in. Anything which comes in from here on will not be in this
+                        // batch, but commitJob.commitingBegin() bumps the commit number, so
+                        // those writers will wait for the next run of this loop.
+                        autoFlushLock.release();
+
+                        queueJournalBatch(h, journalBuilder, commitNumber);
+                    }
 
-                    // Reset the private map estimate outside of the lock
-                    estimatedPrivateMapSize = 0;
-                    remapLastTimestamp = curTimeMicros64();
+                    // Swap to the other pre-allocated buffer so the next PREPLOGBUFFER can run
+                    // while the journal writer is still working on this one. The buffer being
+                    // swapped in is necessarily idle, because queueJournalBatch drains the
+                    // previous batch before accepting a new one.
+                    journalBuilder = (journalBuilder == &journalBuilderA) ? &journalBuilderB
+                                                                          : &journalBuilderA;
 
                     // Do this reset after all locks have been released in order to not do
                     // unnecessary work under lock.
-                    journalBuilder.reset();
+                    journalBuilder->reset();
                 }
 
                 LOG(4) << "groupCommit end";
@@ -703,6 +882,14 @@ namespace {
             }
         }
 
+        // Wake the journal writer so it notices the shutdown request; it finishes any
+        // queued batch before exiting.
+        {
+            boost::mutex::scoped_lock lk(journalWriterMutex);
+            journalWriterWork.notify_one();
+        }
+        journalWriter.join();
+
         cc().shutdown();
     }
 
@@ -160,10 +160,16 @@ namespace mongo {
             /** these called by the groupCommit code as it goes along */
             void commitingBegin();
             /** the commit code calls this when data reaches the journal (on disk) */
-            void committingNotifyCommitted() { 
-                _notify.notifyAll(_commitNumber); 
+            void committingNotifyCommitted() {
+                _notify.notifyAll(_commitNumber);
             }
 
+            /** the commit number which committingNotifyCommitted() would acknowledge. the
+                journal writer thread captures this before handing a section off so it can
+                issue the notification once that particular section is on disk, even if a
+                newer commit has begun by then. */
+            NotifyAll::When commitNumber() const { return _commitNumber; }
+
             /** we use the commitjob object over and over, calling reset() rather than reconstructing */
             void committingReset();
 
@@ -103,7 +103,8 @@ namespace mongo {
             invariant(false);
         }
 
-        virtual std::vector<RecordIterator*> getManyIterators(OperationContext* txn) const {
+        virtual std::vector<RecordIterator*> getManyIterators(OperationContext* txn,
+                                                              size_t numWanted = 0) const {
             invariant(false);
         }
 
@@ -154,6 +154,14 @@ namespace mongo {
         return total;
     }
 
+    int64_t RecordStoreV1Base::reclaimableSize( OperationContext* txn ) const {
+        // Extent bytes not holding live records: padding, the deleted record lists and
+        // unfilled extent tails, all of which compact gives back. Sizing the freelists
+        // exactly would mean walking them, so this stays an estimate.
+        int64_t reclaimable = storageSize( txn ) - dataSize( txn );
+        return reclaimable > 0 ? reclaimable : 0;
+    }
+
     RecordData RecordStoreV1Base::dataFor( OperationContext* txn, const RecordId& loc ) const {
         return recordFor(DiskLoc::fromRecordId(loc))->toRecordData();
     }
@@ -127,6 +127,7 @@ namespace mongo {
             SavedCursorRegistry* _registry;
         };
 
+        SavedCursorRegistry() : _mutex("SavedCursorRegistry") {}
         ~SavedCursorRegistry();
 
         /**
@@ -187,6 +188,8 @@ namespace mongo {
                                      BSONObjBuilder* extraInfo = NULL,
                                      int level = 0 ) const;
 
+        virtual int64_t reclaimableSize( OperationContext* txn ) const;
+
         virtual RecordData dataFor( OperationContext* txn, const RecordId& loc ) const;
 
         virtual bool findRecord( OperationContext* txn, const RecordId& loc, RecordData* rd ) const;
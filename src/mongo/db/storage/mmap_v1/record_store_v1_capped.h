@@ -66,7 +66,18 @@ namespace mongo {
                                              const RecordId& start,
                                              const CollectionScanParams::Direction& dir) const;
 
-        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn ) const;
+        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn,
+                                                               size_t numWanted = 0 ) const;
+
+        /**
+         * For the oplog only: finds a starting position at or below 'startingPosition'
+         * (an oploghack key) by probing the first record of each extent in insertion
+         * order, instead of scanning records. The result is extent-granular -- the
+         * caller's forward scan still applies its ts filter -- but costs one document
+         * read per extent rather than a multi-minute backwards scan on a large oplog.
+         */
+        virtual boost::optional<RecordId> oplogStartHack( OperationContext* txn,
+                                                          const RecordId& startingPosition ) const;
 
         virtual bool compactSupported() const { return false; }
 
@@ -35,6 +35,7 @@
 #include "mongo/db/storage/mmap_v1/record.h"
 #include "mongo/db/storage/mmap_v1/extent.h"
 #include "mongo/db/storage/mmap_v1/record_store_v1_test_help.h"
+#include "mongo/db/storage/oplog_hack.h"
 
 #include "mongo/unittest/unittest.h"
 
@@ -99,6 +100,67 @@ namespace {
         simpleInsertTest("abcdefgh", 8);
     }
 
+    TEST(CappedRecordStoreV1, OplogStartHack) {
+        OperationContextNoop txn;
+        DummyExtentManager em;
+        DummyRecordStoreV1MetaData* md = new DummyRecordStoreV1MetaData( true, 0 );
+        DummyCappedDocumentDeleteCallback cb;
+        CappedRecordStoreV1 rs( &txn, &cb, "local.oplog.hack", md, &em, false );
+
+        rs.increaseStorageSize( &txn, 1024, false );
+
+        const RecordId futureKey = oploghack::keyForOptime( OpTime( 100, 0 ) ).getValue();
+
+        // Empty: no entry is at or below any position.
+        ASSERT_EQUALS( rs.oplogStartHack( &txn, futureKey ), RecordId() );
+
+        // A few entries in the first extent.
+        vector<RecordId> locs;
+        for ( int secs = 2; secs <= 5; secs++ ) {
+            BSONObjBuilder b;
+            b.appendTimestamp( "ts", OpTime( secs, 0 ).asDate() );
+            BSONObj obj = b.obj();
+            StatusWith<RecordId> res = rs.insertRecord( &txn, obj.objdata(), obj.objsize(), false );
+            ASSERT_OK( res.getStatus() );
+            locs.push_back( res.getValue() );
+        }
+
+        // Below the oldest entry there is nothing.
+        ASSERT_EQUALS( rs.oplogStartHack( &txn,
+                                          oploghack::keyForOptime( OpTime( 1, 0 ) ).getValue() ),
+                       RecordId() );
+
+        // The result is extent granular: any goal at or past the first entry starts at
+        // the extent's first record.
+        ASSERT_EQUALS( rs.oplogStartHack( &txn,
+                                          oploghack::keyForOptime( OpTime( 3, 0 ) ).getValue() ),
+                       locs[0] );
+        ASSERT_EQUALS( rs.oplogStartHack( &txn, futureKey ), locs[0] );
+
+        // Fill into a second extent; once entries land there, a late goal starts in it
+        // rather than at the very first record.
+        rs.increaseStorageSize( &txn, 1024, false );
+        boost::optional<RecordId> start;
+        for ( int secs = 6; secs < 200; secs++ ) {
+            BSONObjBuilder b;
+            b.appendTimestamp( "ts", OpTime( secs, 0 ).asDate() );
+            b.append( "padding", string( 120, 'x' ) );
+            BSONObj obj = b.obj();
+            ASSERT_OK( rs.insertRecord( &txn, obj.objdata(), obj.objsize(), false ).getStatus() );
+            start = rs.oplogStartHack( &txn, futureKey );
+            ASSERT( start );
+            if ( *start != locs[0] )
+                break;
+        }
+        ASSERT( cb.deleted.empty() ); // must not have wrapped
+        ASSERT( *start != locs[0] );
+
+        // Early goals still resolve to the oldest extent's first record.
+        ASSERT_EQUALS( rs.oplogStartHack( &txn,
+                                          oploghack::keyForOptime( OpTime( 3, 0 ) ).getValue() ),
+                       locs[0] );
+    }
+
     TEST(CappedRecordStoreV1, EmptySingleExtent) {
         OperationContextNoop txn;
         DummyExtentManager em;
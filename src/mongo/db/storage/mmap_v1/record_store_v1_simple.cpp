@@ -242,7 +242,10 @@ namespace mongo {
         return new SimpleRecordStoreV1Iterator( txn, this, start, dir );
     }
 
-    vector<RecordIterator*> SimpleRecordStoreV1::getManyIterators( OperationContext* txn ) const {
+    vector<RecordIterator*> SimpleRecordStoreV1::getManyIterators( OperationContext* txn,
+                                                                   size_t numWanted ) const {
+        // One iterator per extent regardless of 'numWanted'; extents are the natural
+        // partitioning unit here and the caller round-robins them over its cursors.
         OwnedPointerVector<RecordIterator> iterators;
         const Extent* ext;
         for (DiskLoc extLoc = details()->firstExtent(txn); !extLoc.isNull(); extLoc = ext->xnext) {
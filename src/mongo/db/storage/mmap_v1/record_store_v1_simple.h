@@ -53,7 +53,8 @@ namespace mongo {
         virtual RecordIterator* getIterator( OperationContext* txn, const RecordId& start,
                                              const CollectionScanParams::Direction& dir) const;
 
-        virtual std::vector<RecordIterator*> getManyIterators(OperationContext* txn) const;
+        virtual std::vector<RecordIterator*> getManyIterators(OperationContext* txn,
+                                                              size_t numWanted = 0) const;
 
         virtual Status truncate(OperationContext* txn);
 
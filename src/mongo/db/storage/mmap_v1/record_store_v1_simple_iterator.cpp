@@ -131,4 +131,23 @@ namespace mongo {
         return _recordStore->dataFor( _txn, loc );
     }
 
+    void SimpleRecordStoreV1Iterator::willNeed( int numRecords ) {
+        // The advice granularity here is a whole extent, so there is nothing finer
+        // grained to do with 'numRecords'. Backward scans fight the kernel's readahead
+        // direction, so only advise forward scans.
+        if ( isEOF() || CollectionScanParams::FORWARD != _direction )
+            return;
+
+        const DiskLoc extentLoc = _recordStore->_extentManager->extentLocForV1( _curr );
+        if ( extentLoc.isNull() || extentLoc == _advisedExtent )
+            return;
+
+        // Drop the old advice before taking new advice so the previous extent's pages
+        // go back to normal caching.
+        _extentAdvice.reset();
+        _extentAdvice.reset( _recordStore->_extentManager->cacheHint(
+                                 extentLoc, ExtentManager::Sequential ) );
+        _advisedExtent = extentLoc;
+    }
+
 }
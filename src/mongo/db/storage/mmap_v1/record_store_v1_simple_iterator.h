@@ -28,7 +28,10 @@
 
 #pragma once
 
+#include <boost/scoped_ptr.hpp>
+
 #include "mongo/db/storage/mmap_v1/diskloc.h"
+#include "mongo/db/storage/mmap_v1/extent_manager.h"
 #include "mongo/db/storage/record_store.h"
 
 namespace mongo {
@@ -59,6 +62,8 @@ namespace mongo {
 
         virtual RecordData dataFor( const RecordId& loc ) const;
 
+        virtual void willNeed( int numRecords );
+
     private:
          // for getNext, not owned
         OperationContext* _txn;
@@ -69,6 +74,11 @@ namespace mongo {
         const SimpleRecordStoreV1* _recordStore;
 
         CollectionScanParams::Direction _direction;
+
+        // Active readahead advice for the extent the scan is currently in, held until
+        // willNeed() sees the scan move to another extent. NULL when no advice is active.
+        boost::scoped_ptr<ExtentManager::CacheHint> _extentAdvice;
+        DiskLoc _advisedExtent;
     };
 
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/scoped_ptr.hpp>
 
+#include "mongo/bson/bson_validate.h"
 #include "mongo/db/background.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
@@ -397,21 +398,45 @@ namespace mongo {
                         return status;
                 }
 
+                // Copy and index in batches, each committed as a single unit of work,
+                // so the per-record commit overhead is paid once per batch instead of
+                // once per document.  The byte budget bounds the uncommitted work.
+                const int kRepairBatchDocs = 1000;
+                const long long kRepairBatchBytes = 16 * 1024 * 1024;
+
                 scoped_ptr<RecordIterator> iterator(originalCollection->getIterator(txn));
                 while ( !iterator->isEOF() ) {
-                    RecordId loc = iterator->getNext();
-                    invariant( !loc.isNull() );
-
-                    BSONObj doc = originalCollection->docFor( txn, loc );
+                    int batchDocs = 0;
+                    long long batchBytes = 0;
 
                     WriteUnitOfWork wunit(txn);
-                    StatusWith<RecordId> result = tempCollection->insertDocument(txn,
-                                                                                 doc,
-                                                                                 &indexer,
-                                                                                 false);
-                    if ( !result.isOK() )
-                        return result.getStatus();
+                    while ( !iterator->isEOF() &&
+                            batchDocs < kRepairBatchDocs &&
+                            batchBytes < kRepairBatchBytes ) {
+                        RecordId loc = iterator->curr();
+                        invariant( !loc.isNull() );
+                        RecordData data = iterator->dataFor( loc );
+                        invariant( loc == iterator->getNext() );
+
+                        Status validStatus = validateBSON( data.data(), data.size() );
+                        if ( !validStatus.isOK() ) {
+                            log() << "Invalid BSON detected in " << ns << " at " << loc
+                                  << ": " << validStatus << ". Skipping.";
+                            continue;
+                        }
 
+                        BSONObj doc = data.releaseToBson();
+
+                        StatusWith<RecordId> result = tempCollection->insertDocument(txn,
+                                                                                     doc,
+                                                                                     &indexer,
+                                                                                     false);
+                        if ( !result.isOK() )
+                            return result.getStatus();
+
+                        batchDocs++;
+                        batchBytes += doc.objsize();
+                    }
                     wunit.commit();
                     txn->checkForInterrupt();
                 }
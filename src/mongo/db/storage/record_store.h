@@ -113,6 +113,13 @@ namespace mongo {
         // normally this will just go back to the RecordStore and convert
         // but this gives the iterator an oppurtnity to optimize
         virtual RecordData dataFor( const RecordId& loc ) const = 0;
+
+        /**
+         * Hint that the caller is about to read the next 'numRecords' records in
+         * iteration order. Engines that can start disk readahead for that range do so;
+         * the default does nothing. Advisory only - correctness never depends on it.
+         */
+        virtual void willNeed( int numRecords ) { }
     };
 
 
@@ -146,6 +153,12 @@ namespace mongo {
                                      BSONObjBuilder* extraInfo = NULL,
                                      int infoLevel = 0 ) const = 0;
 
+        /**
+         * Estimate of how many bytes compact() could give back. Engines that cannot tell
+         * return 0, which callers should read as "unknown", not "nothing to reclaim".
+         */
+        virtual int64_t reclaimableSize( OperationContext* txn ) const { return 0; }
+
         // CRUD related
 
         virtual RecordData dataFor( OperationContext* txn, const RecordId& loc) const = 0;
@@ -169,6 +182,30 @@ namespace mongo {
                                                   const DocWriter* doc,
                                                   bool enforceQuota ) = 0;
 
+        /**
+         * Inserts all of 'records', in order, in the caller's unit of work.  Stops at the
+         * first record that cannot be inserted; 'locsOut' receives the locations of the
+         * records inserted before the failure.  The default implementation inserts one
+         * record at a time; storage engines that can allocate space for a whole batch in
+         * one pass may override it.
+         */
+        virtual Status insertRecords( OperationContext* txn,
+                                      const std::vector<RecordData>& records,
+                                      bool enforceQuota,
+                                      std::vector<RecordId>* locsOut ) {
+            locsOut->reserve( locsOut->size() + records.size() );
+            for ( size_t i = 0; i < records.size(); i++ ) {
+                StatusWith<RecordId> res = insertRecord( txn,
+                                                         records[i].data(),
+                                                         records[i].size(),
+                                                         enforceQuota );
+                if ( !res.isOK() )
+                    return res.getStatus();
+                locsOut->push_back( res.getValue() );
+            }
+            return Status::OK();
+        }
+
         /**
          * @param notifier - this is called if the document is moved
          *                   it is to be called after the document has been written to new
@@ -237,8 +274,14 @@ namespace mongo {
         /**
          * Returns many iterators that partition the RecordStore into many disjoint sets. Iterating
          * all returned iterators is equivalent to Iterating the full store.
+         *
+         * 'numWanted' is a hint for how many iterators the caller can put to use.
+         * Implementations should try to return close to that many when they can partition the
+         * store, but may return more (e.g. one per extent) or fewer (down to a single
+         * iterator) as their layout dictates. Zero means no preference.
          */
-        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn ) const = 0;
+        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn,
+                                                               size_t numWanted = 0 ) const = 0;
 
         // higher level
 
@@ -114,6 +114,54 @@ namespace mongo {
         }
     }
 
+    // Insert a batch of records in one call and verify the number of entries in the
+    // collection equals the number that were inserted, and that each record is
+    // retrievable at the location reported for it.
+    TEST( RecordStoreTestHarness, InsertRecordsAsBatch ) {
+        scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
+        scoped_ptr<RecordStore> rs( harnessHelper->newNonCappedRecordStore() );
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            ASSERT_EQUALS( 0, rs->numRecords( opCtx.get() ) );
+        }
+
+        const int nToInsert = 10;
+        std::vector<std::string> datas;
+        for ( int i = 0; i < nToInsert; i++ ) {
+            stringstream ss;
+            ss << "record " << i;
+            datas.push_back( ss.str() );
+        }
+
+        std::vector<RecordId> locs;
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            {
+                std::vector<RecordData> records;
+                for ( int i = 0; i < nToInsert; i++ ) {
+                    records.push_back( RecordData( datas[i].c_str(),
+                                                   datas[i].size() + 1 ) );
+                }
+
+                WriteUnitOfWork uow( opCtx.get() );
+                Status res = rs->insertRecords( opCtx.get(), records, false, &locs );
+                ASSERT_OK( res );
+                ASSERT_EQUALS( static_cast<size_t>( nToInsert ), locs.size() );
+                uow.commit();
+            }
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            ASSERT_EQUALS( nToInsert, rs->numRecords( opCtx.get() ) );
+            for ( int i = 0; i < nToInsert; i++ ) {
+                RecordData record = rs->dataFor( opCtx.get(), locs[i] );
+                ASSERT_EQUALS( string( record.data() ), datas[i] );
+            }
+        }
+    }
+
     // Insert a record using a DocWriter and verify the number of entries
     // in the collection is 1.
     TEST( RecordStoreTestHarness, InsertRecordUsingDocWriter ) {
@@ -100,6 +100,32 @@ namespace mongo {
 
         virtual uint64_t getMyTransactionCount() const { return 0; }
 
+        /**
+         * Declares that the caller is about to hold pointers into storage-engine-owned memory
+         * (unowned RecordData and BSONObjs derived from it) across several reads. While reads
+         * are pinned, the engine must keep every buffer it has handed out valid, which lets it
+         * return views directly onto its cache instead of copying each record out. Engines
+         * which cannot provide this cheaply may ignore the pin and keep returning owned
+         * copies, so callers must not assume the data they get back is unowned.
+         *
+         * Pinned buffers do not survive commitAndRestart(); anything that must outlive a yield
+         * has to be copied before the snapshot is abandoned (the query system does this in
+         * PlanExecutor::saveState, see WorkingSetCommon::forceFetchAllLocs). Calls may nest;
+         * each pinReads() must be matched by exactly one unpinReads().
+         */
+        virtual void pinReads() { }
+        virtual void unpinReads() { }
+
+        /**
+         * Declares whether this unit will be used only for reading. Engines may use the
+         * declaration to skip write-tracking bookkeeping (e.g. snapshot registration for
+         * conflict detection) that pure reads never benefit from. Advisory: engines with
+         * no such bookkeeping ignore it. Must be declared before the first read; engines
+         * may refuse (and silently keep the current mode) once the unit has been used.
+         * Writing through a unit while it is declared read-only is illegal.
+         */
+        virtual void setIsReadOnly(bool readOnly) { }
+
         /**
          * A Change is an action that is registerChange()'d while a WriteUnitOfWork exists. The
          * change is either rollback()'d or commit()'d when the WriteUnitOfWork goes out of scope.
@@ -163,4 +189,18 @@ namespace mongo {
         RecoveryUnit() { }
     };
 
+    /**
+     * RAII for RecoveryUnit::pinReads()/unpinReads(). Wrap this around a batch of reads whose
+     * results are each consumed before the next yield (e.g. appended to an outgoing buffer).
+     */
+    class ScopedPinnedReads {
+        MONGO_DISALLOW_COPYING(ScopedPinnedReads);
+    public:
+        explicit ScopedPinnedReads(RecoveryUnit* ru) : _ru(ru) { _ru->pinReads(); }
+        ~ScopedPinnedReads() { _ru->unpinReads(); }
+
+    private:
+        RecoveryUnit* const _ru; // not owned
+    };
+
 }  // namespace mongo
@@ -39,12 +39,16 @@
 
 #include <rocksdb/comparator.h>
 #include <rocksdb/db.h>
+#include <rocksdb/filter_policy.h>
 #include <rocksdb/slice.h>
+#include <rocksdb/slice_transform.h>
 #include <rocksdb/options.h>
+#include <rocksdb/table.h>
 #include <rocksdb/utilities/write_batch_with_index.h>
 
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/rocks/rocks_record_store.h"
 #include "mongo/db/storage/rocks/rocks_recovery_unit.h"
@@ -62,6 +66,7 @@ namespace mongo {
 
     const std::string RocksEngine::kOrderingPrefix("indexordering-");
     const std::string RocksEngine::kCollectionPrefix("collection-");
+    const std::string RocksEngine::kIndexConfigPrefix("indexconfig-");
 
     RocksEngine::RocksEngine(const std::string& path, bool durable)
         : _path(path),
@@ -70,6 +75,7 @@ namespace mongo {
 
         auto columnFamilyNames = _loadColumnFamilies();       // vector of column family names
         std::unordered_map<std::string, Ordering> orderings;  // column family name -> Ordering
+        std::unordered_map<std::string, bool> indexConfigs;   // column family name -> point-heavy
         std::set<std::string> collections;                    // set of collection names
 
         if (columnFamilyNames.empty()) {  // new DB
@@ -81,6 +87,7 @@ namespace mongo {
             ROCKS_STATUS_OK(s);
             auto itr = dbReadOnly->NewIterator(rocksdb::ReadOptions());
             orderings = _loadOrderingMetaData(itr);
+            indexConfigs = _loadIndexConfigMetaData(itr);
             collections = _loadCollections(itr);
             delete itr;
             delete dbReadOnly;
@@ -100,7 +107,14 @@ namespace mongo {
             bool isCollection = collections_iter != collections.end();
             invariant(!isIndex || !isCollection);
             if (isIndex) {
-                columnFamilies.emplace_back(cf, _indexOptions(orderings_iter->second));
+                // indexes created before the per-index config metadata existed get the
+                // range-scan tuning, which matches their old behavior most closely
+                auto config_iter = indexConfigs.find(cf);
+                bool pointLookupHeavy =
+                    config_iter != indexConfigs.end() && config_iter->second;
+                columnFamilies.emplace_back(cf,
+                                            _indexOptions(orderings_iter->second,
+                                                          pointLookupHeavy));
             } else if (isCollection) {
                 columnFamilies.emplace_back(cf, _collectionOptions());
             } else {
@@ -169,9 +183,19 @@ namespace mongo {
         }
         auto keyPattern = desc->keyPattern();
 
+        // unique indexes (the _id index included) are read overwhelmingly by exact key, so
+        // their column families get the point-lookup tuning; everything else is assumed to
+        // serve range scans. Persisted alongside the ordering so reopening the engine
+        // rebuilds the column family with the same options.
+        const bool pointLookupHeavy = desc->unique();
+        const BSONObj config = BSON("pointLookup" << pointLookupHeavy);
+
         _db->Put(rocksdb::WriteOptions(), kOrderingPrefix + ident.toString(),
                  rocksdb::Slice(keyPattern.objdata(), keyPattern.objsize()));
-        return _createColumnFamily(_indexOptions(Ordering::make(keyPattern)), ident);
+        _db->Put(rocksdb::WriteOptions(), kIndexConfigPrefix + ident.toString(),
+                 rocksdb::Slice(config.objdata(), config.objsize()));
+        return _createColumnFamily(_indexOptions(Ordering::make(keyPattern), pointLookupHeavy),
+                                   ident);
     }
 
     SortedDataInterface* RocksEngine::getSortedDataInterface(OperationContext* opCtx,
@@ -185,6 +209,7 @@ namespace mongo {
         rocksdb::WriteBatch wb;
         // TODO is there a more efficient way?
         wb.Delete(kOrderingPrefix + ident.toString());
+        wb.Delete(kIndexConfigPrefix + ident.toString());
         wb.Delete(kCollectionPrefix + ident.toString());
         auto s = _db->Write(rocksdb::WriteOptions(), &wb);
         if (!s.ok()) {
@@ -267,6 +292,22 @@ namespace mongo {
         return orderings;
     }
 
+    std::unordered_map<std::string, bool> RocksEngine::_loadIndexConfigMetaData(
+        rocksdb::Iterator* itr) {
+        std::unordered_map<std::string, bool> configs;
+        for (itr->Seek(kIndexConfigPrefix); itr->Valid(); itr->Next()) {
+            rocksdb::Slice key(itr->key());
+            if (!key.starts_with(kIndexConfigPrefix)) {
+                break;
+            }
+            key.remove_prefix(kIndexConfigPrefix.size());
+            std::string value(itr->value().ToString());
+            configs.insert({key.ToString(), BSONObj(value.c_str()).getBoolField("pointLookup")});
+        }
+        ROCKS_STATUS_OK(itr->status());
+        return configs;
+    }
+
     std::set<std::string> RocksEngine::_loadCollections(rocksdb::Iterator* itr) {
         std::set<std::string> collections;
         for (itr->Seek(kCollectionPrefix); itr->Valid() ; itr->Next()) {
@@ -326,10 +367,34 @@ namespace mongo {
         return options;
     }
 
-    rocksdb::ColumnFamilyOptions RocksEngine::_indexOptions(const Ordering& order) const {
+    rocksdb::ColumnFamilyOptions RocksEngine::_indexOptions(const Ordering& order,
+                                                            bool pointLookupHeavy) const {
         rocksdb::ColumnFamilyOptions options;
         invariant( _collectionComparator.get() );
         options.comparator = RocksSortedDataImpl::newRocksComparator(order);
+
+        // Bloom filters let an exact-key probe reject an sst file without reading its data
+        // blocks. unindex() and the dup key check do such a probe on every index write, so
+        // this pays off on all indexes; point-lookup heavy ones get more bits per key.
+        rocksdb::BlockBasedTableOptions tableOptions;
+        tableOptions.filter_policy.reset(
+            rocksdb::NewBloomFilterPolicy(pointLookupHeavy ? 16 : 10));
+
+        // point lookups read single entries, so smaller blocks waste less cache and IO per
+        // read; range indexes amortize larger blocks over long scans
+        tableOptions.block_size = pointLookupHeavy ? 4 * 1024 : 16 * 1024;
+        options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(tableOptions));
+
+        // additionally bloom on the BSONObj portion of the entry (the trailing RecordId
+        // stripped), so probes that know the key but not the RecordId still benefit. All
+        // index iterators must pass total_order_seek (see RocksRecoveryUnit::NewIterator)
+        // so range scans keep full ordering semantics despite the extractor.
+        options.prefix_extractor.reset(RocksSortedDataImpl::newBloomPrefixExtractor());
+        if (pointLookupHeavy) {
+            // the memtable has no sst filter blocks to lean on, so give it its own bloom
+            options.memtable_prefix_bloom_bits = 8 * 1024 * 1024;
+        }
+
         return options;
     }
 
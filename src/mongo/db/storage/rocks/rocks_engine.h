@@ -132,11 +132,13 @@ namespace mongo {
         boost::shared_ptr<rocksdb::ColumnFamilyHandle> _getColumnFamily(const StringData& ident);
 
         std::unordered_map<std::string, Ordering> _loadOrderingMetaData(rocksdb::Iterator* itr);
+        std::unordered_map<std::string, bool> _loadIndexConfigMetaData(rocksdb::Iterator* itr);
         std::set<std::string> _loadCollections(rocksdb::Iterator* itr);
         std::vector<std::string> _loadColumnFamilies();
 
         rocksdb::ColumnFamilyOptions _collectionOptions() const;
-        rocksdb::ColumnFamilyOptions _indexOptions(const Ordering& order) const;
+        rocksdb::ColumnFamilyOptions _indexOptions(const Ordering& order,
+                                                   bool pointLookupHeavy) const;
 
         rocksdb::Options _dbOptions() const;
 
@@ -160,6 +162,7 @@ namespace mongo {
 
         static const std::string kOrderingPrefix;
         static const std::string kCollectionPrefix;
+        static const std::string kIndexConfigPrefix;
     };
 
     Status toMongoStatus( rocksdb::Status s );
@@ -480,10 +480,36 @@ namespace mongo {
         return new Iterator(txn, _db, _columnFamily, _cappedVisibilityManager, dir, start);
     }
 
-    std::vector<RecordIterator*> RocksRecordStore::getManyIterators( OperationContext* txn ) const {
-        // AFB: any way to get the split point keys for the bottom layer of the lsm tree?
+    std::vector<RecordIterator*> RocksRecordStore::getManyIterators( OperationContext* txn,
+                                                                     size_t numWanted ) const {
         std::vector<RecordIterator*> iterators;
-        iterators.push_back( getIterator( txn ) );
+
+        // Capped collections (including the oplog) tie visibility to scan order and assign
+        // record ids outside the counter, so they keep the single-iterator behavior.
+        const int64_t highest = _isOplog ? 0 : static_cast<int64_t>(_nextIdNum.load()) - 1;
+        int64_t numRanges = 0;
+        if (!_isCapped && numWanted > 1) {
+            numRanges = std::min(static_cast<int64_t>(numWanted), highest);
+        }
+
+        if (numRanges < 2) {
+            iterators.push_back(getIterator(txn));
+            return iterators;
+        }
+
+        // Ordinary collections allocate record ids from a dense counter, so carving the id
+        // space into equal ranges carves the key space into roughly equal pieces; deletes
+        // just leave some ranges lighter than others.
+        const int64_t step = highest / numRanges;
+        int64_t start = 1;
+        for (int64_t i = 0; i < numRanges; i++) {
+            const RecordId end(i + 1 == numRanges ? highest : start + step - 1);
+            iterators.push_back(new Iterator(txn, _db, _columnFamily, _cappedVisibilityManager,
+                                             CollectionScanParams::FORWARD, RecordId(start),
+                                             end));
+            start = end.repr() + 1;
+        }
+
         return iterators;
     }
 
@@ -774,7 +800,8 @@ namespace mongo {
         OperationContext* txn, rocksdb::DB* db,
         boost::shared_ptr<rocksdb::ColumnFamilyHandle> columnFamily,
         boost::shared_ptr<CappedVisibilityManager> cappedVisibilityManager,
-        const CollectionScanParams::Direction& dir, const RecordId& start)
+        const CollectionScanParams::Direction& dir, const RecordId& start,
+        const RecordId& end)
         : _txn(txn),
           _db(db),
           _cf(columnFamily),
@@ -782,8 +809,10 @@ namespace mongo {
           _dir(dir),
           _eof(true),
           _readUntilForOplog(RocksRecoveryUnit::getRocksRecoveryUnit(txn)->getOplogReadTill()),
+          _end(end),
           _iterator(RocksRecoveryUnit::getRocksRecoveryUnit(txn)->NewIterator(_cf.get())) {
 
+        invariant(_end.isNull() || _forward());
         _locate(start);
     }
 
@@ -839,10 +868,19 @@ namespace mongo {
             // we leave _curr as it is on purpose
         }
 
+        _checkEnd();
         _checkStatus();
         return toReturn;
     }
 
+    void RocksRecordStore::Iterator::_checkEnd() {
+        if (!_eof && !_end.isNull() && _curr > _end) {
+            // Ran off the end of the key range this iterator covers. _curr is left alone,
+            // matching the plain EOF case above.
+            _eof = true;
+        }
+    }
+
     void RocksRecordStore::Iterator::invalidate( const RecordId& dl ) {
         // this should never be called
     }
@@ -901,6 +939,7 @@ namespace mongo {
         } else {
             _curr = _decodeCurr();
         }
+        _checkEnd();
     }
 
     RecordId RocksRecordStore::Iterator::_decodeCurr() const {
@@ -141,7 +141,8 @@ namespace mongo {
                                              const CollectionScanParams::Direction& dir =
                                              CollectionScanParams::FORWARD ) const;
 
-        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn ) const;
+        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn,
+                                                               size_t numWanted = 0 ) const;
 
         virtual Status truncate( OperationContext* txn );
 
@@ -190,10 +191,14 @@ namespace mongo {
         // shared_ptrs
         class Iterator : public RecordIterator {
         public:
+            // A non-null 'end' is an inclusive upper bound on the records returned and is
+            // only supported for forward scans. With an end bound, 'start' need not name an
+            // existing record; the scan begins at the first record at or after it.
             Iterator(OperationContext* txn, rocksdb::DB* db,
                      boost::shared_ptr<rocksdb::ColumnFamilyHandle> columnFamily,
                      boost::shared_ptr<CappedVisibilityManager> cappedVisibilityManager,
-                     const CollectionScanParams::Direction& dir, const RecordId& start);
+                     const CollectionScanParams::Direction& dir, const RecordId& start,
+                     const RecordId& end = RecordId());
 
             virtual bool isEOF();
             virtual RecordId curr();
@@ -205,6 +210,7 @@ namespace mongo {
 
         private:
             void _locate(const RecordId& loc);
+            void _checkEnd();
             RecordId _decodeCurr() const;
             bool _forward() const;
             void _checkStatus();
@@ -216,6 +222,7 @@ namespace mongo {
             CollectionScanParams::Direction _dir;
             bool _eof;
             const RecordId _readUntilForOplog;
+            const RecordId _end; // if non-null, the last record this iterator may return
             RecordId _curr;
             boost::scoped_ptr<rocksdb::Iterator> _iterator;
         };
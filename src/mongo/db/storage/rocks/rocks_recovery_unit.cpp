@@ -52,6 +52,7 @@ namespace mongo {
         : _transactionEngine(transactionEngine),
           _db(db),
           _durable(durable),
+          _readOnly(false),
           _transaction(transactionEngine),
           _writeBatch(),
           _snapshot(NULL),
@@ -102,6 +103,9 @@ namespace mongo {
     // lazily initialized because Recovery Units are sometimes initialized just for reading,
     // which does not require write batches
     rocksdb::WriteBatchWithIndex* RocksRecoveryUnit::writeBatch() {
+        // a snapshot pinned in read-only mode was never registered with the transaction
+        // engine, so it must not be used for write conflict detection
+        invariant(!_readOnly);
         if (!_writeBatch) {
             // this assumes that default column family uses default comparator. change this if you
             // change default column family's comparator
@@ -114,6 +118,28 @@ namespace mongo {
 
     void RocksRecoveryUnit::setOplogReadTill(const RecordId& record) { _oplogReadTill = record; }
 
+    void RocksRecoveryUnit::setIsReadOnly(bool readOnly) {
+        if (readOnly == _readOnly) {
+            return;
+        }
+        if (readOnly) {
+            // only adopt the declaration while the unit is untouched -- a snapshot pinned
+            // in read-write mode is already registered with the transaction engine and has
+            // to keep its bookkeeping until released
+            if (_snapshot || _writeBatch) {
+                return;
+            }
+            _readOnly = true;
+        } else {
+            // reads are done; drop the unregistered snapshot so that any writes which
+            // follow (e.g. the profiler's) pin a fresh one through the normal, registered
+            // path
+            invariant(!_writeBatch);
+            _releaseSnapshot();
+            _readOnly = false;
+        }
+    }
+
     void RocksRecoveryUnit::registerChange(Change* change) { _changes.push_back(change); }
 
     void RocksRecoveryUnit::_releaseSnapshot() {
@@ -167,10 +193,16 @@ namespace mongo {
 
     const rocksdb::Snapshot* RocksRecoveryUnit::snapshot() {
         if ( !_snapshot ) {
-            // Order of operations here is important. It needs to be synchronized with
-            // _db->Write() and _transaction.commit()
-            _transaction.recordSnapshotId();
-            _snapshot = _db->GetSnapshot();
+            if (_readOnly) {
+                // pure reads don't participate in write conflict detection, so pin a plain
+                // snapshot without going through the transaction engine and its lock
+                _snapshot = _db->GetSnapshot();
+            } else {
+                // Order of operations here is important. It needs to be synchronized with
+                // _db->Write() and _transaction.commit()
+                _transaction.recordSnapshotId();
+                _snapshot = _db->GetSnapshot();
+            }
         }
 
         return _snapshot;
@@ -202,6 +234,10 @@ namespace mongo {
 
         rocksdb::ReadOptions options;
         options.snapshot = snapshot();
+        // index column families configure a prefix extractor for their bloom filters;
+        // without this flag the iterator would silently switch to prefix-only iteration
+        // and stop at bson key boundaries mid range scan
+        options.total_order_seek = true;
         auto iterator = _db->NewIterator(options, columnFamily);
         if (_writeBatch && _writeBatch->GetWriteBatch()->Count() > 0) {
             iterator = _writeBatch->NewIteratorWithBase(columnFamily, iterator);
@@ -80,6 +80,8 @@ namespace mongo {
 
         virtual void registerChange(Change* change);
 
+        virtual void setIsReadOnly(bool readOnly);
+
         // local api
 
         rocksdb::WriteBatchWithIndex* writeBatch();
@@ -87,6 +89,8 @@ namespace mongo {
         const rocksdb::Snapshot* snapshot();
         bool hasSnapshot() { return _snapshot != nullptr; }
 
+        bool isReadOnly() const { return _readOnly; }
+
         RocksTransaction* transaction() { return &_transaction; }
 
         rocksdb::Status Get(rocksdb::ColumnFamilyHandle* columnFamily, const rocksdb::Slice& key,
@@ -128,6 +132,11 @@ namespace mongo {
 
         const bool _durable;
 
+        // When true, snapshots are pinned without registering with the transaction engine,
+        // skipping its global lock entirely, and writing through this unit is illegal. See
+        // setIsReadOnly().
+        bool _readOnly;
+
         RocksTransaction _transaction;
 
         boost::scoped_ptr<rocksdb::WriteBatchWithIndex> _writeBatch; // owned
@@ -40,6 +40,7 @@
 #include <rocksdb/comparator.h>
 #include <rocksdb/db.h>
 #include <rocksdb/iterator.h>
+#include <rocksdb/slice_transform.h>
 #include <rocksdb/utilities/write_batch_with_index.h>
 
 #include "mongo/bson/bsonobjbuilder.h"
@@ -380,6 +381,46 @@ namespace mongo {
                 const IndexEntryComparison _indexComparator;
         };
 
+        /**
+         * Maps an index entry (the bytes of a BSONObj followed by a RecordId) to just the
+         * BSONObj bytes. Bloom filters built over this prefix answer "is this bson key
+         * present under any RecordId", which lets exact-key probes skip sst files even
+         * when the RecordId is unknown. Anything not shaped like an index entry is kept
+         * out of the filter via InDomain().
+         */
+        class BloomPrefixExtractor : public rocksdb::SliceTransform {
+            public:
+                virtual const char* Name() const {
+                    // like the comparator name above, this is persisted in sst metadata and
+                    // must not change
+                    return "mongodb.BsonKeyPrefix";
+                }
+
+                virtual rocksdb::Slice Transform(const rocksdb::Slice& src) const {
+                    invariant( InDomain( src ) );
+                    return rocksdb::Slice( src.data(), src.size() - sizeof( RecordId ) );
+                }
+
+                virtual bool InDomain(const rocksdb::Slice& src) const {
+                    const size_t kMinBSONSize = 5; // empty object
+                    if ( src.size() < kMinBSONSize + sizeof( RecordId ) ) {
+                        return false;
+                    }
+                    // an index entry is a bson object followed immediately by a RecordId,
+                    // so the object's self-described length must account for all but the
+                    // last sizeof(RecordId) bytes
+                    int bsonSize;
+                    memcpy( &bsonSize, src.data(), sizeof( bsonSize ) );
+                    return bsonSize > 0 &&
+                        static_cast<size_t>( bsonSize ) == src.size() - sizeof( RecordId );
+                }
+
+                virtual bool InRange(const rocksdb::Slice& dst) const {
+                    const size_t kMinBSONSize = 5;
+                    return dst.size() >= kMinBSONSize;
+                }
+        };
+
         class RocksBulkSortedBuilderImpl : public SortedDataBuilderInterface {
         public:
             RocksBulkSortedBuilderImpl(RocksSortedDataImpl* index, OperationContext* txn,
@@ -532,8 +573,11 @@ namespace mongo {
 
     Status RocksSortedDataImpl::touch(OperationContext* txn) const {
         boost::scoped_ptr<rocksdb::Iterator> itr;
-        // no need to use snapshot to load into memory
-        itr.reset(_db->NewIterator(rocksdb::ReadOptions(), _columnFamily.get()));
+        // no need to use snapshot to load into memory. total_order_seek because this
+        // column family has a prefix extractor and we want the whole index
+        rocksdb::ReadOptions readOptions;
+        readOptions.total_order_seek = true;
+        itr.reset(_db->NewIterator(readOptions, _columnFamily.get()));
         itr->SeekToFirst();
         for (; itr->Valid(); itr->Next()) {
             invariant(itr->status().ok());
@@ -580,6 +624,11 @@ namespace mongo {
         return new RocksIndexEntryComparator( order );
     }
 
+    // ownership passes to caller
+    rocksdb::SliceTransform* RocksSortedDataImpl::newBloomPrefixExtractor() {
+        return new BloomPrefixExtractor();
+    }
+
     std::string RocksSortedDataImpl::_getTransactionID(const BSONObj& key) const {
         // TODO optimize in the future
         return _ident + std::string(key.objdata(), key.objsize());
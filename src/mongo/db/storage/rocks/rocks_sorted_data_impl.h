@@ -44,6 +44,7 @@
 namespace rocksdb {
     class ColumnFamilyHandle;
     class DB;
+    class SliceTransform;
 }
 
 namespace mongo {
@@ -107,6 +108,11 @@ namespace mongo {
         // rocksdb::Options class
         static rocksdb::Comparator* newRocksComparator( const Ordering& order );
 
+        // ownership passes to caller. Maps an index entry to the bytes of its BSONObj (the
+        // trailing RecordId stripped), so bloom filters built over the prefix can answer
+        // "is this bson key present under any RecordId"
+        static rocksdb::SliceTransform* newBloomPrefixExtractor();
+
     private:
         std::string _getTransactionID(const BSONObj& key) const;
 
@@ -31,6 +31,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/index_entry_comparison.h"
 #include "mongo/db/storage/record_store.h"
 
 #pragma once
@@ -305,6 +306,28 @@ namespace mongo {
              */
             virtual void advance() = 0;
 
+            /**
+             * Append up to 'maxToFill' entries to 'entries', starting with the entry
+             * 'this' cursor is positioned at and advancing once per entry appended.
+             * Stops early if the cursor reaches EOF. The appended keys are owned
+             * copies that remain valid after further cursor movement.
+             *
+             * The default implementation loops over getKey(), getRecordId() and
+             * advance(). Implementations should override it with a tight loop so
+             * that bulk consumers do not pay a virtual dispatch per entry.
+             *
+             * @return the number of entries appended
+             */
+            virtual size_t nextBatch(vector<IndexKeyEntry>* entries, size_t maxToFill) {
+                size_t numAppended = 0;
+                while (numAppended < maxToFill && !isEOF()) {
+                    entries->push_back(IndexKeyEntry(getKey().getOwned(), getRecordId()));
+                    advance();
+                    numAppended++;
+                }
+                return numAppended;
+            }
+
             //
             // Saving and restoring state
             //
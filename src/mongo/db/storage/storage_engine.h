@@ -156,6 +156,29 @@ namespace mongo {
          */
         virtual int flushAllFiles( bool sync ) = 0;
 
+        /**
+         * Opens a consistent checkpoint of the data files for a hot backup and returns in
+         * 'files' the list of files (relative to the dbpath) an external tool has to copy.
+         * Writes continue while the backup is in progress; the engine guarantees the listed
+         * files are not modified or removed until endBackup() is called. If 'incremental'
+         * is true only the files written since the last checkpoint are listed, for engines
+         * that support it.
+         *
+         * The default implementation returns CommandNotSupported.
+         */
+        virtual Status beginBackup( OperationContext* txn,
+                                    bool incremental,
+                                    std::vector<std::string>* files ) {
+            return Status( ErrorCodes::CommandNotSupported,
+                           "the current storage engine does not support hot backup" );
+        }
+
+        /**
+         * Releases the checkpoint opened by beginBackup(). A no-op if no backup is in
+         * progress.
+         */
+        virtual void endBackup( OperationContext* txn ) {}
+
         /**
          * Recover as much data as possible from a potentially corrupt RecordStore.
          * This only recovers the record data, not indexes or anything else.
@@ -103,6 +103,7 @@ namespace mongo {
                                             bool repair )
         : _path( path ),
           _durable( durable ),
+          _backupSession( NULL ),
           _sizeStorerSyncTracker( 100000, 60 * 1000 ) {
 
         _eventHandler.handle_error = mdb_handle_error;
@@ -191,8 +192,15 @@ namespace mongo {
 
     void WiredTigerKVEngine::cleanShutdown() {
         log() << "WiredTigerKVEngine shutting down";
-        syncSizeInfo(true);
+        // this is the only sync that marks the table clean; nothing writes after it
+        syncSizeInfo(true, true);
         if (_conn) {
+            // release any backup checkpoint still pinned by a backup cursor
+            if (_backupSession) {
+                _backupSession->close(_backupSession, NULL);
+                _backupSession = NULL;
+            }
+
             // this must be the last thing we do before _conn->close();
             _sessionCache->shuttingDown();
 
@@ -267,7 +275,72 @@ namespace mongo {
         return 1;
     }
 
-    void WiredTigerKVEngine::syncSizeInfo( bool sync ) const {
+    Status WiredTigerKVEngine::beginBackup( OperationContext* opCtx,
+                                            bool incremental,
+                                            std::vector<std::string>* files ) {
+        boost::mutex::scoped_lock lk( _backupSessionMutex );
+        if ( _backupSession ) {
+            return Status( ErrorCodes::OperationFailed,
+                           "a hot backup is already in progress" );
+        }
+
+        if ( incremental && !_durable ) {
+            return Status( ErrorCodes::CommandNotSupported,
+                           "incremental backup requires the journal to be enabled" );
+        }
+
+        // The backup cursor has to stay open until the files have been copied, so it
+        // gets a dedicated session rather than one from the session cache.
+        WT_SESSION* session;
+        int ret = _conn->open_session( _conn, NULL, NULL, &session );
+        if ( ret != 0 ) {
+            return wtRCToStatus( ret );
+        }
+
+        // Opening a backup cursor forces a checkpoint and pins it: WiredTiger neither
+        // modifies nor removes the files it lists until the cursor is closed, while new
+        // writes keep flowing into later checkpoints and the log. An incremental backup
+        // lists only the log files written since the last full backup; log archiving is
+        // suspended while the cursor is open so those files stay on disk.
+        WT_CURSOR* cursor;
+        ret = session->open_cursor( session,
+                                    "backup:",
+                                    NULL,
+                                    incremental ? "target=(\"log:\")" : NULL,
+                                    &cursor );
+        if ( ret != 0 ) {
+            session->close( session, NULL );
+            return wtRCToStatus( ret );
+        }
+
+        const char* filename;
+        while ( ( ret = cursor->next( cursor ) ) == 0 ) {
+            invariantWTOK( cursor->get_key( cursor, &filename ) );
+            files->push_back( filename );
+        }
+        if ( ret != WT_NOTFOUND ) {
+            cursor->close( cursor );
+            session->close( session, NULL );
+            files->clear();
+            return wtRCToStatus( ret );
+        }
+
+        // Closing the session closes the cursor, so only the session is kept.
+        _backupSession = session;
+        return Status::OK();
+    }
+
+    void WiredTigerKVEngine::endBackup( OperationContext* opCtx ) {
+        boost::mutex::scoped_lock lk( _backupSessionMutex );
+        if ( !_backupSession ) {
+            return;
+        }
+        // closing the session closes the backup cursor and unpins the checkpoint
+        invariantWTOK( _backupSession->close( _backupSession, NULL ) );
+        _backupSession = NULL;
+    }
+
+    void WiredTigerKVEngine::syncSizeInfo( bool sync, bool markCleanShutdown ) const {
         if ( !_sizeStorer )
             return;
 
@@ -275,7 +348,7 @@ namespace mongo {
             WiredTigerSession session(_conn);
             WT_SESSION* s = session.getSession();
             invariantWTOK( s->begin_transaction( s, sync ? "sync=true" : NULL ) );
-            _sizeStorer->storeInto( &session, _sizeStorerUri );
+            _sizeStorer->storeInto( &session, _sizeStorerUri, markCleanShutdown );
             invariantWTOK( s->commit_transaction( s, NULL ) );
         }
         catch (const WriteConflictException&) {
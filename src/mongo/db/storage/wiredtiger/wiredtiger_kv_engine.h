@@ -95,6 +95,12 @@ namespace mongo {
 
         virtual int flushAllFiles( bool sync );
 
+        virtual Status beginBackup( OperationContext* opCtx,
+                                    bool incremental,
+                                    std::vector<std::string>* files );
+
+        virtual void endBackup( OperationContext* opCtx );
+
         virtual int64_t getIdentSize( OperationContext* opCtx,
                                       const StringData& ident );
 
@@ -116,7 +122,7 @@ namespace mongo {
         void dropAllQueued();
         bool haveDropsQueued() const;
 
-        void syncSizeInfo(bool sync) const;
+        void syncSizeInfo(bool sync, bool markCleanShutdown = false) const;
 
     private:
 
@@ -134,6 +140,12 @@ namespace mongo {
         std::string _path;
         bool _durable;
 
+        // Holds the open backup cursor for the duration of a hot backup; NULL when no
+        // backup is in progress. Deliberately not from the session cache, as the cursor
+        // stays open across operations.
+        WT_SESSION* _backupSession;
+        mutable boost::mutex _backupSessionMutex;
+
         string _rsOptions;
         string _indexOptions;
 
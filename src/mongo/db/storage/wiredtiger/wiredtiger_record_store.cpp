@@ -35,6 +35,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <algorithm>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_array.hpp>
 #include <wiredtiger.h>
@@ -165,9 +166,10 @@ namespace {
               _cappedMaxDocs( cappedMaxDocs ),
               _cappedDeleteCallback( cappedDeleteCallback ),
               _cappedDeleteCheckCount(0),
+              _oplogStoneMaxBytes(0),
+              _oplogStonesEngaged(false),
               _useOplogHack(shouldUseOplogHack(ctx, _uri)),
-              _sizeStorer( sizeStorer ),
-              _sizeStorerCounter(0)
+              _sizeStorer( sizeStorer )
     {
         Status versionStatus = WiredTigerUtil::checkApplicationMetadataFormatVersion(
             ctx, uri, kMinimumRecordStoreVersion, kMaximumRecordStoreVersion);
@@ -179,6 +181,13 @@ namespace {
             invariant(_cappedMaxSize > 0);
             invariant(_cappedMaxDocs == -1 || _cappedMaxDocs > 0);
         }
+
+        if (_isOplog) {
+            // Reclaim the oplog one-tenth of the cap at a time. Data already on disk when
+            // we start up predates stone bookkeeping and is trimmed by the scanning
+            // fallback in _oplogTruncateAsNeeded.
+            _oplogStoneMaxBytes = std::max( _cappedMaxSize / 10, static_cast<int64_t>( 1 ) );
+        }
         else {
             invariant(_cappedMaxSize == -1);
             invariant(_cappedMaxDocs == -1);
@@ -199,12 +208,14 @@ namespace {
             RecordId maxLoc = iterator->curr();
             int64_t max = _makeKey( maxLoc );
             _oplog_highestSeen = maxLoc;
+            _oplog_highestAtStartup = maxLoc;
             _nextIdNum.store( 1 + max );
 
+            long long highestIdAtLastFlush = 0;
             if ( _sizeStorer ) {
                 long long numRecords;
                 long long dataSize;
-                _sizeStorer->load( uri, &numRecords, &dataSize );
+                _sizeStorer->load( uri, &numRecords, &dataSize, &highestIdAtLastFlush );
                 _numRecords.store( numRecords );
                 _dataSize.store( dataSize );
                 _sizeStorer->onCreate( this, numRecords, dataSize );
@@ -227,6 +238,39 @@ namespace {
                     _sizeStorer->store( _uri, _numRecords.load(), _dataSize.load() );
                 }
             }
+            else if ( !_sizeStorer->loadedFromCleanShutdown() &&
+                      !_isCapped &&
+                      highestIdAtLastFlush > 0 &&
+                      highestIdAtLastFlush < max ) {
+                // The last run crashed before flushing final counts. Inserts always get ids
+                // above the highest one recorded with the flushed counts, so scanning just
+                // that id tail picks them up without visiting the whole collection. Deletes
+                // and updates of older records stay unaccounted for until a full validate,
+                // same as before.
+                LOG(1) << "unclean shutdown, scanning id tail of collection " << ns
+                       << " to adjust size info";
+
+                WiredTigerCursor cursor( _uri, _instanceId, ctx );
+                WT_CURSOR* c = cursor.get();
+                c->set_key( c, highestIdAtLastFlush );
+                int cmp;
+                int ret = c->search_near( c, &cmp );
+                if ( ret != WT_NOTFOUND ) {
+                    invariantWTOK( ret );
+                    if ( cmp <= 0 )
+                        ret = c->next( c );
+                    for ( ; ret == 0; ret = c->next( c ) ) {
+                        WT_ITEM value;
+                        invariantWTOK( c->get_value( c, &value ) );
+                        _numRecords.fetchAndAdd( 1 );
+                        _dataSize.fetchAndAdd( value.size );
+                    }
+                    if ( ret != WT_NOTFOUND )
+                        invariantWTOK( ret );
+                }
+
+                _sizeStorer->store( _uri, _numRecords.load(), _dataSize.load() );
+            }
 
         }
 
@@ -284,6 +328,17 @@ namespace {
         return size;
     }
 
+    int64_t WiredTigerRecordStore::reclaimableSize( OperationContext* txn ) const {
+        // Blocks the block manager has freed but not yet returned to the filesystem;
+        // this is what WT_SESSION::compact can actually give back.
+        WiredTigerSession* session = WiredTigerRecoveryUnit::get(txn)->getSession();
+        StatusWith<int64_t> result = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+            session->getSession(),
+            "statistics:" + getURI(), "statistics=(fast)", WT_STAT_DSRC_BLOCK_REUSE_BYTES);
+        uassertStatusOK(result.getStatus());
+        return result.getValue();
+    }
+
     // Retrieve the value from a positioned cursor.
     RecordData WiredTigerRecordStore::_getData(const WiredTigerCursor& cursor) const {
         WT_ITEM value;
@@ -295,7 +350,42 @@ namespace {
         return RecordData(data.moveFrom(), value.size);
     }
 
+    RecordData WiredTigerRecordStore::_getDataPinned(
+            WiredTigerRecoveryUnit* wru,
+            std::auto_ptr<WiredTigerCursor>& cursor ) const {
+        WT_CURSOR* c = cursor->get();
+        WT_ITEM value;
+        int ret = c->get_value(c, &value);
+        invariantWTOK(ret);
+
+        if ( wru->pinCursor( cursor.get() ) ) {
+            // The recovery unit now keeps the positioned cursor untouched, so the memory
+            // WiredTiger returned stays valid and the caller gets a view directly onto the
+            // cache page instead of a copy.
+            cursor.release();
+            return RecordData( static_cast<const char*>( value.data ), value.size );
+        }
+
+        // Too many cursors pinned already; copy like an unpinned read would.
+        return _getData( *cursor );
+    }
+
     RecordData WiredTigerRecordStore::dataFor(OperationContext* txn, const RecordId& loc) const {
+        WiredTigerRecoveryUnit* wru = _getRecoveryUnit( txn );
+        if ( wru->readsPinned() ) {
+            std::auto_ptr<WiredTigerCursor> curwrap(
+                new WiredTigerCursor( _uri, _instanceId, txn ) );
+            WT_CURSOR *c = curwrap->get();
+            invariant( c );
+            c->set_key(c, _makeKey(loc));
+            int ret = c->search(c);
+            massert( 28611,
+                     "Didn't find RecordId in WiredTigerRecordStore",
+                     ret != WT_NOTFOUND );
+            invariantWTOK(ret);
+            return _getDataPinned( wru, curwrap );
+        }
+
         // ownership passes to the shared_array created below
         WiredTigerCursor curwrap( _uri, _instanceId, txn);
         WT_CURSOR *c = curwrap.get();
@@ -311,6 +401,21 @@ namespace {
 
     bool WiredTigerRecordStore::findRecord( OperationContext* txn,
                                             const RecordId& loc, RecordData* out ) const {
+        WiredTigerRecoveryUnit* wru = _getRecoveryUnit( txn );
+        if ( wru->readsPinned() ) {
+            std::auto_ptr<WiredTigerCursor> curwrap(
+                new WiredTigerCursor( _uri, _instanceId, txn ) );
+            WT_CURSOR *c = curwrap->get();
+            invariant( c );
+            c->set_key(c, _makeKey(loc));
+            int ret = c->search(c);
+            if ( ret == WT_NOTFOUND )
+                return false;
+            invariantWTOK(ret);
+            *out = _getDataPinned( wru, curwrap );
+            return true;
+        }
+
         WiredTigerCursor curwrap( _uri, _instanceId, txn);
         WT_CURSOR *c = curwrap.get();
         invariant( c );
@@ -452,6 +557,145 @@ namespace {
         txn->setRecoveryUnit( realRecoveryUnit );
     }
 
+    void WiredTigerRecordStore::_oplogStoneInserted( OperationContext* txn,
+                                                     const RecordId& loc,
+                                                     int len ) {
+        {
+            boost::mutex::scoped_lock lk( _oplogStonesMutex );
+            _currentOplogStone.bytes += len;
+            _currentOplogStone.records++;
+            if ( loc > _currentOplogStone.lastRecord ) {
+                _currentOplogStone.lastRecord = loc;
+            }
+
+            if ( _currentOplogStone.bytes >= _oplogStoneMaxBytes ) {
+                _oplogStones.push_back( _currentOplogStone );
+                _currentOplogStone = OplogStone();
+            }
+        }
+
+        _oplogTruncateAsNeeded( txn, loc );
+    }
+
+    void WiredTigerRecordStore::_oplogStonesReset( const RecordId& highest ) {
+        // After records are removed out from under the stones (full truncate or a rollback
+        // of the tail), the stones' counters no longer describe what is on disk.  Treat
+        // whatever survived like data found at startup: let the scanning fallback reclaim
+        // it and rebuild stones from new inserts.
+        boost::mutex::scoped_lock lk( _oplogStonesMutex );
+        _oplogStones.clear();
+        _currentOplogStone = OplogStone();
+        _oplog_highestAtStartup = highest;
+        _oplogStonesEngaged = false;
+    }
+
+    void WiredTigerRecordStore::_oplogTruncateAsNeeded( OperationContext* txn,
+                                                        const RecordId& justInserted ) {
+        if ( _dataSize.load() <= _cappedMaxSize )
+            return;
+
+        if ( !_oplogStonesEngaged ) {
+            // Data that was on disk at startup predates stone bookkeeping and has to be
+            // reclaimed by the legacy scanning path. Once it has all aged out, the stones
+            // cover everything before the current stone and they take over for good.
+            WiredTigerCursor curwrap( _uri, _instanceId, txn);
+            WT_CURSOR *c = curwrap.get();
+            int ret = c->next(c);
+            if ( ret != WT_NOTFOUND ) {
+                invariantWTOK(ret);
+                int64_t key;
+                invariantWTOK( c->get_key(c, &key) );
+                if ( _fromKey(key) <= _oplog_highestAtStartup ) {
+                    cappedDeleteAsNeeded( txn, justInserted );
+                    return;
+                }
+            }
+
+            boost::mutex::scoped_lock lk( _oplogStonesMutex );
+            _oplogStonesEngaged = true;
+        }
+
+        OplogStone stone;
+        {
+            boost::mutex::scoped_lock lk( _oplogStonesMutex );
+            if ( _oplogStones.empty() ) {
+                // Wait for the current stone to fill; we overshoot the cap by at most one
+                // stone's worth of data.
+                return;
+            }
+            stone = _oplogStones.front();
+        }
+
+        // Never truncate through the record we just inserted.
+        if ( stone.lastRecord >= justInserted )
+            return;
+
+        // ensure only one thread at a time can do deletes, otherwise they'll conflict.
+        boost::mutex::scoped_lock lock(_cappedDeleterMutex, boost::try_to_lock);
+        if ( !lock )
+            return;
+
+        // we do this is a sub transaction in case it aborts
+        WiredTigerRecoveryUnit* realRecoveryUnit =
+            dynamic_cast<WiredTigerRecoveryUnit*>( txn->releaseRecoveryUnit() );
+        invariant( realRecoveryUnit );
+        WiredTigerSessionCache* sc = realRecoveryUnit->getSessionCache();
+        txn->setRecoveryUnit( new WiredTigerRecoveryUnit( sc ) );
+
+        try {
+            WiredTigerCursor curwrap( _uri, _instanceId, txn);
+            WT_CURSOR *c = curwrap.get();
+
+            // Position on the stone's boundary record, or the nearest record before it if
+            // the boundary's insert rolled back after the stone was cut.
+            int cmp;
+            c->set_key(c, _makeKey(stone.lastRecord));
+            int ret = c->search_near(c, &cmp);
+            if (ret == 0 && cmp > 0) ret = c->prev(c); // landed one higher than the boundary
+            if ( ret == WT_NOTFOUND ) {
+                // Nothing at or before the boundary; the stone is already empty.
+                delete txn->releaseRecoveryUnit();
+                txn->setRecoveryUnit( realRecoveryUnit );
+                boost::mutex::scoped_lock lk( _oplogStonesMutex );
+                if ( !_oplogStones.empty() &&
+                     _oplogStones.front().lastRecord == stone.lastRecord ) {
+                    _oplogStones.pop_front();
+                }
+                return;
+            }
+            invariantWTOK(ret);
+
+            WriteUnitOfWork wuow( txn );
+            ret = c->session->truncate(c->session, NULL, NULL, c, NULL);
+            invariantWTOK(ret);
+            _changeNumRecords(txn, -stone.records);
+            _increaseDataSize(txn, -stone.bytes);
+            wuow.commit();
+        }
+        catch ( const WriteConflictException& wce ) {
+            delete txn->releaseRecoveryUnit();
+            txn->setRecoveryUnit( realRecoveryUnit );
+            log() << "got conflict truncating capped, ignoring";
+            return;
+        }
+        catch ( ... ) {
+            delete txn->releaseRecoveryUnit();
+            txn->setRecoveryUnit( realRecoveryUnit );
+            throw;
+        }
+
+        delete txn->releaseRecoveryUnit();
+        txn->setRecoveryUnit( realRecoveryUnit );
+
+        {
+            boost::mutex::scoped_lock lk( _oplogStonesMutex );
+            if ( !_oplogStones.empty() &&
+                 _oplogStones.front().lastRecord == stone.lastRecord ) {
+                _oplogStones.pop_front();
+            }
+        }
+    }
+
     StatusWith<RecordId> WiredTigerRecordStore::extractAndCheckLocForOplog(const char* data,
                                                                            int len) {
         return oploghack::extractKey(data, len);
@@ -505,7 +749,12 @@ namespace {
         _changeNumRecords( txn, 1 );
         _increaseDataSize( txn, len );
 
-        cappedDeleteAsNeeded(txn, loc);
+        if ( _isOplog ) {
+            _oplogStoneInserted( txn, loc, len );
+        }
+        else {
+            cappedDeleteAsNeeded(txn, loc);
+        }
 
         return StatusWith<RecordId>( loc );
     }
@@ -611,13 +860,38 @@ namespace {
 
 
     std::vector<RecordIterator*> WiredTigerRecordStore::getManyIterators(
-        OperationContext* txn ) const {
-
-        // XXX do we want this to actually return a set of iterators?
+        OperationContext* txn, size_t numWanted ) const {
 
         std::vector<RecordIterator*> iterators;
-        iterators.push_back( new Iterator(*this, txn, RecordId(),
-                                          CollectionScanParams::FORWARD, true) );
+
+        // Capped collections (including the oplog) tie visibility to scan order and assign
+        // record ids outside the counter, so they keep the single-iterator behavior.
+        const int64_t highest = highestRecordId();
+        int64_t numRanges = 0;
+        if ( !_isCapped && numWanted > 1 ) {
+            numRanges = std::min( static_cast<int64_t>( numWanted ), highest );
+        }
+
+        if ( numRanges < 2 ) {
+            iterators.push_back( new Iterator(*this, txn, RecordId(),
+                                              CollectionScanParams::FORWARD, true) );
+            return iterators;
+        }
+
+        // Ordinary collections allocate record ids from a dense counter, so carving the id
+        // space into equal ranges carves the tree into roughly equal pieces; deletes just
+        // leave some ranges lighter than others. Records inserted after the split point is
+        // taken land above 'highest' and are not covered, the same visibility callers of a
+        // plain scan already accept.
+        const int64_t step = highest / numRanges;
+        int64_t start = 1;
+        for ( int64_t i = 0; i < numRanges; i++ ) {
+            const RecordId end( i + 1 == numRanges ? highest : start + step - 1 );
+            iterators.push_back( new Iterator(*this, txn, RecordId(start),
+                                              CollectionScanParams::FORWARD, true,
+                                              end) );
+            start = end.repr() + 1;
+        }
 
         return iterators;
     }
@@ -630,6 +904,10 @@ namespace {
             deleteRecord( txn, loc );
         }
 
+        if ( _isOplog ) {
+            _oplogStonesReset( RecordId() );
+        }
+
         // WiredTigerRecoveryUnit* ru = _getRecoveryUnit( txn );
 
         return Status::OK();
@@ -918,9 +1196,8 @@ namespace {
             }
         }
 
-        if ( _sizeStorer && _sizeStorerCounter++ % 1000 == 0 ) {
-            _sizeStorer->store( _uri, _numRecords.load(), _dataSize.load() );
-        }
+        // No size storer call here: the periodic sync reads the counters straight out of
+        // this record store, so the write path never touches the storer's mutex.
     }
 
     int64_t WiredTigerRecordStore::_makeKey( const RecordId& loc ) {
@@ -937,16 +1214,21 @@ namespace {
         OperationContext *txn,
         const RecordId& start,
         const CollectionScanParams::Direction& dir,
-        bool forParallelCollectionScan)
+        bool forParallelCollectionScan,
+        const RecordId& end)
         : _rs( rs ),
           _txn( txn ),
           _forward( dir == CollectionScanParams::FORWARD ),
           _forParallelCollectionScan( forParallelCollectionScan ),
           _cursor( new WiredTigerCursor( rs.getURI(), rs.instanceId(), txn ) ),
           _eof(false),
-          _readUntilForOplog(WiredTigerRecoveryUnit::get(txn)->getOplogReadTill()) {
+          _readUntilForOplog(WiredTigerRecoveryUnit::get(txn)->getOplogReadTill()),
+          _end(end) {
         RS_ITERATOR_TRACE("start");
-        _locate(start, true);
+        invariant( _end.isNull() || _forward );
+        // A bounded range's start need not name an existing record, so seek inexactly to
+        // the first record at or after it.
+        _locate(start, _end.isNull());
     }
 
     WiredTigerRecordStore::Iterator::~Iterator() {
@@ -962,6 +1244,7 @@ namespace {
             _eof = (ret == WT_NOTFOUND);
             if (!_eof) invariantWTOK(ret);
             _loc = _curr();
+            _checkEnd();
 
             RS_ITERATOR_TRACE("_locate   null loc eof: " << _eof);
             return;
@@ -997,9 +1280,18 @@ namespace {
         if (ret != WT_NOTFOUND) invariantWTOK(ret);
         _eof = (ret == WT_NOTFOUND);
         _loc = _curr();
+        _checkEnd();
         RS_ITERATOR_TRACE("_locate   not null loc eof: " << _eof);
     }
 
+    void WiredTigerRecordStore::Iterator::_checkEnd() {
+        if ( !_eof && !_end.isNull() && _loc > _end ) {
+            // Ran off the end of the key range this iterator covers.
+            _eof = true;
+            _loc = RecordId();
+        }
+    }
+
     bool WiredTigerRecordStore::Iterator::isEOF() {
         RS_ITERATOR_TRACE( "isEOF " << _eof << " " << _lastLoc );
         return _eof;
@@ -1056,6 +1348,7 @@ namespace {
                     }
                 }
             }
+            _checkEnd();
         }
 
         if (_eof) {
@@ -1162,5 +1455,9 @@ namespace {
             }
         }
         wuow.commit();
+
+        if ( _isOplog ) {
+            _oplogStonesReset( end );
+        }
     }
 }
@@ -31,6 +31,8 @@
 
 #pragma once
 
+#include <deque>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -100,6 +102,8 @@ namespace mongo {
                                      BSONObjBuilder* extraInfo = NULL,
                                      int infoLevel = 0 ) const;
 
+        virtual int64_t reclaimableSize( OperationContext* txn ) const;
+
         // CRUD related
 
         virtual RecordData dataFor( OperationContext* txn, const RecordId& loc ) const;
@@ -137,7 +141,8 @@ namespace mongo {
                                              const CollectionScanParams::Direction& dir =
                                              CollectionScanParams::FORWARD ) const;
 
-        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn ) const;
+        virtual std::vector<RecordIterator*> getManyIterators( OperationContext* txn,
+                                                               size_t numWanted = 0 ) const;
 
         virtual Status truncate( OperationContext* txn );
 
@@ -187,6 +192,13 @@ namespace mongo {
         const std::string& getURI() const { return _uri; }
         uint64_t instanceId() const { return _instanceId; }
 
+        /**
+         * Highest record id handed out so far. Only meaningful for non-capped collections,
+         * where ids are allocated from a counter; the oplog assigns ids from optimes and
+         * does not update it.
+         */
+        int64_t highestRecordId() const { return _nextIdNum.load() - 1; }
+
         void setSizeStorer( WiredTigerSizeStorer* ss ) { _sizeStorer = ss; }
 
         void dealtWithCappedLoc( const RecordId& loc );
@@ -196,11 +208,17 @@ namespace mongo {
 
         class Iterator : public RecordIterator {
         public:
+            /**
+             * A non-null 'end' is an inclusive upper bound on the records returned and is
+             * only supported for forward scans. With an end bound, 'start' need not name
+             * an existing record; the scan begins at the first record at or after it.
+             */
             Iterator( const WiredTigerRecordStore& rs,
                       OperationContext* txn,
                       const RecordId& start,
                       const CollectionScanParams::Direction& dir,
-                      bool forParallelCollectionScan );
+                      bool forParallelCollectionScan,
+                      const RecordId& end = RecordId() );
 
             virtual ~Iterator();
 
@@ -215,6 +233,7 @@ namespace mongo {
         private:
             void _getNext();
             void _locate( const RecordId &loc, bool exact );
+            void _checkEnd();
             RecordId _curr() const; // const version of public curr method
 
             const WiredTigerRecordStore& _rs;
@@ -225,6 +244,7 @@ namespace mongo {
             boost::scoped_ptr<WiredTigerCursor> _cursor;
             bool _eof;
             const RecordId _readUntilForOplog;
+            const RecordId _end; // if non-null, the last record this iterator may return
 
             RecordId _loc; // Cached key of _cursor. Update any time _cursor is moved.
             RecordId _lastLoc; // the last thing returned from getNext()
@@ -248,9 +268,30 @@ namespace mongo {
         void _changeNumRecords(OperationContext* txn, int64_t diff);
         void _increaseDataSize(OperationContext* txn, int amount);
         RecordData _getData( const WiredTigerCursor& cursor) const;
+        RecordData _getDataPinned( WiredTigerRecoveryUnit* wru,
+                                   std::auto_ptr<WiredTigerCursor>& cursor ) const;
         StatusWith<RecordId> extractAndCheckLocForOplog(const char* data, int len);
         void _oplogSetStartHack( WiredTigerRecoveryUnit* wru ) const;
 
+        /**
+         * Oplog truncation bookkeeping.  Inserts into the oplog only bump counters under a
+         * briefly-held mutex; each time a whole chunk of new data (see _oplogStoneMaxBytes)
+         * has accumulated, its boundary RecordId is remembered as a "stone".  Once the
+         * collection exceeds its cap, one writer reclaims the oldest chunk with a single
+         * range truncate through the stone's boundary, so the write path never walks the
+         * collection record by record and stalls are amortized over a whole chunk.
+         */
+        struct OplogStone {
+            OplogStone() : bytes(0), records(0) { }
+            RecordId lastRecord; // highest record covered by this stone
+            int64_t bytes;
+            int64_t records;
+        };
+
+        void _oplogStoneInserted( OperationContext* txn, const RecordId& loc, int len );
+        void _oplogTruncateAsNeeded( OperationContext* txn, const RecordId& justInserted );
+        void _oplogStonesReset( const RecordId& highest );
+
         const std::string _uri;
         const uint64_t _instanceId; // not persisted
 
@@ -263,6 +304,20 @@ namespace mongo {
         int _cappedDeleteCheckCount; // see comment in ::cappedDeleteAsNeeded
         boost::mutex _cappedDeleterMutex; // see comment in ::cappedDeleteAsNeeded
 
+        // Oplog-only truncation state; see OplogStone.  The counters can drift slightly if
+        // insert transactions roll back, which only shifts stone boundaries a little.
+        int64_t _oplogStoneMaxBytes;
+        std::deque<OplogStone> _oplogStones;
+        OplogStone _currentOplogStone;
+        boost::mutex _oplogStonesMutex;
+
+        // Highest record present when the record store was opened; anything at or below it
+        // is not covered by a stone.  Stones only start truncating once all such data has
+        // aged out (_oplogStonesEngaged flips to true exactly once; reading it without the
+        // mutex is benign).
+        RecordId _oplog_highestAtStartup;
+        bool _oplogStonesEngaged;
+
         const bool _useOplogHack;
 
         typedef std::vector<RecordId> SortedDiskLocs;
@@ -276,6 +331,5 @@ namespace mongo {
         AtomicInt64 _numRecords;
 
         WiredTigerSizeStorer* _sizeStorer; // not owned, can be NULL
-        int _sizeStorerCounter;
     };
 }
@@ -31,9 +31,11 @@
 #include "mongo/platform/basic.h"
 
 #include <boost/scoped_ptr.hpp>
+#include <set>
 #include <sstream>
 #include <string>
 
+#include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -269,6 +271,50 @@ namespace mongo {
         }
     }
 
+    TEST(WiredTigerRecordStoreTest, GetManyIteratorsPartitions) {
+        scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
+        scoped_ptr<RecordStore> rs( harnessHelper->newNonCappedRecordStore() );
+
+        const int N = 20;
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            WriteUnitOfWork uow( opCtx.get() );
+            for ( int i = 0; i < N; i++ ) {
+                ASSERT_OK( rs->insertRecord( opCtx.get(), "a", 2, false ).getStatus() );
+            }
+            uow.commit();
+        }
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            OwnedPointerVector<RecordIterator> iterators(
+                rs->getManyIterators( opCtx.get(), 4 ) );
+            ASSERT_EQUALS( 4U, iterators.size() );
+
+            // Together the iterators return every record exactly once, each in
+            // increasing order.
+            std::set<RecordId> seen;
+            for ( size_t i = 0; i < iterators.size(); i++ ) {
+                RecordId prev;
+                while ( !iterators[i]->isEOF() ) {
+                    RecordId loc = iterators[i]->getNext();
+                    ASSERT_GREATER_THAN( loc, prev );
+                    prev = loc;
+                    ASSERT( seen.insert( loc ).second );
+                }
+            }
+            ASSERT_EQUALS( static_cast<size_t>( N ), seen.size() );
+        }
+
+        {
+            // Asking for more iterators than records caps out at one record per iterator.
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            OwnedPointerVector<RecordIterator> iterators(
+                rs->getManyIterators( opCtx.get(), 10 * N ) );
+            ASSERT_EQUALS( static_cast<size_t>( N ), iterators.size() );
+        }
+    }
+
     TEST(WiredTigerRecordStoreTest, SizeStorer1 ) {
         scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
         scoped_ptr<RecordStore> rs( harnessHelper->newNonCappedRecordStore() );
@@ -350,6 +396,80 @@ namespace mongo {
         rs.reset( NULL ); // this has to be deleted before ss
     }
 
+    TEST(WiredTigerRecordStoreTest, SizeStorerUncleanRestart ) {
+        scoped_ptr<HarnessHelper> harnessHelper( newHarnessHelper() );
+        scoped_ptr<RecordStore> rs( harnessHelper->newNonCappedRecordStore() );
+
+        string uri = dynamic_cast<WiredTigerRecordStore*>( rs.get() )->getURI();
+
+        WiredTigerSizeStorer ss;
+        dynamic_cast<WiredTigerRecordStore*>( rs.get() )->setSizeStorer( &ss );
+
+        const long long N = WiredTigerRecordStore::kCollectionScanOnCreationThreshold;
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            WriteUnitOfWork uow( opCtx.get() );
+            for ( long long i = 0; i < N; i++ ) {
+                ASSERT_OK( rs->insertRecord( opCtx.get(), "a", 2, false ).getStatus() );
+            }
+            uow.commit();
+        }
+
+        string storerUri = "table:sizes";
+        {
+            // flush counts without a clean shutdown marker, as a crash would leave them
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            WriteUnitOfWork uow( opCtx.get() );
+            ss.storeInto( WiredTigerRecoveryUnit::get( opCtx.get() )->getSession(), storerUri );
+            uow.commit();
+        }
+
+        {
+            // these inserts come after the "crash point" so the table never sees them
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            WriteUnitOfWork uow( opCtx.get() );
+            for ( int i = 0; i < 10; i++ ) {
+                ASSERT_OK( rs->insertRecord( opCtx.get(), "bb", 3, false ).getStatus() );
+            }
+            uow.commit();
+        }
+
+        rs.reset( NULL );
+
+        {
+            scoped_ptr<OperationContext> opCtx( harnessHelper->newOperationContext() );
+            WiredTigerSizeStorer ss2;
+            ss2.loadFrom( WiredTigerRecoveryUnit::get( opCtx.get() )->getSession(), storerUri );
+            ASSERT( !ss2.loadedFromCleanShutdown() );
+
+            // reopening the record store should recover the tail inserts from the id
+            // range above the flushed high water mark, without a full scan
+            rs.reset( new WiredTigerRecordStore( opCtx.get(), "a.b", uri,
+                                                 false, -1, -1, NULL, &ss2 ) );
+            ASSERT_EQUALS( N + 10, rs->numRecords( opCtx.get() ) );
+            ASSERT_EQUALS( N * 2 + 10 * 3, rs->dataSize( opCtx.get() ) );
+
+            // a flush that marks a clean shutdown is seen by exactly one load
+            ss2.storeInto( WiredTigerRecoveryUnit::get( opCtx.get() )->getSession(),
+                           storerUri, true );
+            {
+                WiredTigerSizeStorer ss3;
+                ss3.loadFrom( WiredTigerRecoveryUnit::get( opCtx.get() )->getSession(),
+                              storerUri );
+                ASSERT( ss3.loadedFromCleanShutdown() );
+            }
+            {
+                WiredTigerSizeStorer ss4;
+                ss4.loadFrom( WiredTigerRecoveryUnit::get( opCtx.get() )->getSession(),
+                              storerUri );
+                ASSERT( !ss4.loadedFromCleanShutdown() );
+            }
+
+            rs.reset( NULL ); // this has to be deleted before ss2
+        }
+    }
+
 namespace {
 
     class GoodValidateAdaptor : public ValidateAdaptor {
@@ -34,45 +34,103 @@
 #include <boost/thread/mutex.hpp>
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stacktrace.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+    // How long a group commit leader lingers before flushing, so that writers arriving
+    // just behind it share the same log flush instead of paying for their own.  Zero
+    // flushes immediately.
+    MONGO_EXPORT_SERVER_PARAMETER(wiredTigerGroupCommitWindowMicros, int, 200);
+
     namespace {
-        struct AwaitCommitData {
-            AwaitCommitData() :
-                numWaitingForSync(0),
-                lastSyncTime(0) {
+        /**
+         * Batches concurrent durability requests into a single durable log flush.  A writer
+         * that needs its commit journaled publishes a commit number and waits; the first
+         * waiter through becomes the leader, lingers for the configured commit window so
+         * that writers arriving just behind it can join, then performs one flush covering
+         * every commit published before the flush started and wakes the whole group.  Under
+         * N concurrent j:true writers this costs one sync per batch instead of one sync per
+         * writer.
+         */
+        struct GroupCommitter {
+            GroupCommitter() :
+                _commitNumber(0),
+                _durableTo(0),
+                _flushing(false) {
             }
 
-            void syncHappend() {
-                boost::mutex::scoped_lock lk( mutex );
-                lastSyncTime++;
-                condvar.notify_all();
+            /**
+             * Blocks until everything committed before this call is durable.
+             */
+            void waitUntilDurable( WiredTigerSessionCache* sessionCache ) {
+                boost::mutex::scoped_lock lk( _mutex );
+                const unsigned long long myNumber = ++_commitNumber;
+                while ( _durableTo < myNumber ) {
+                    if ( !_flushing ) {
+                        // Become the leader: hold the flush open for the commit window so
+                        // that concurrent writers can pile on, then flush on behalf of
+                        // everybody who has published a commit number by then.
+                        _flushing = true;
+                        const int windowMicros = wiredTigerGroupCommitWindowMicros;
+                        if ( windowMicros > 0 ) {
+                            lk.unlock();
+                            sleepmicros( windowMicros );
+                            lk.lock();
+                        }
+                        const unsigned long long flushTo = _commitNumber;
+                        lk.unlock();
+                        _flush( sessionCache );
+                        lk.lock();
+                        _flushing = false;
+                        _durableTo = flushTo;
+                        _condvar.notify_all();
+                    }
+                    else {
+                        // A leader is already flushing; it either covers us or we get a
+                        // turn to lead the next batch when it finishes.
+                        _condvar.wait( lk );
+                    }
+                }
             }
 
-            // return true if happened
-            bool awaitCommit() {
-                boost::mutex::scoped_lock lk( mutex );
-                long long start = lastSyncTime;
-                numWaitingForSync.fetchAndAdd(1);
-                condvar.timed_wait(lk,boost::posix_time::milliseconds(50));
-                numWaitingForSync.fetchAndAdd(-1);
-                return lastSyncTime > start;
+        private:
+            void _flush( WiredTigerSessionCache* sessionCache ) {
+                // This version of WiredTiger has no log-only flush: committing an
+                // empty transaction with sync skips the log write entirely, and
+                // checkpoint targets must be backed by a file.  A full checkpoint is
+                // the available durability barrier; the commit window above lets one
+                // checkpoint cover a whole batch of waiters.
+                WiredTigerSession* session = sessionCache->getSession();
+                WT_SESSION* s = session->getSession();
+                invariantWTOK( s->checkpoint( s, NULL ) );
+                LOG(2) << "WT checkpoint (group commit)";
+                sessionCache->releaseSession( session );
             }
 
-            AtomicUInt32 numWaitingForSync;
+            boost::mutex _mutex; // protects all members below
+            boost::condition _condvar;
+
+            // Ticket handed to each waiter; the leader flushes through the latest one.
+            unsigned long long _commitNumber;
+
+            // All commits numbered <= this are known durable.
+            unsigned long long _durableTo;
 
-            boost::mutex mutex; // this just protects lastSyncTime
-            boost::condition condvar;
-            long long lastSyncTime;
-        } awaitCommitData;
+            // True while a leader's flush is in flight.
+            bool _flushing;
+        } groupCommitter;
     }
 
+    // static
+    const size_t WiredTigerRecoveryUnit::kMaxPinnedCursors = 1000;
+
     WiredTigerRecoveryUnit::WiredTigerRecoveryUnit(WiredTigerSessionCache* sc) :
         _sessionCache( sc ),
         _session( NULL ),
@@ -81,11 +139,13 @@ namespace mongo {
         _myTransactionCount( 0 ),
         _everStartedWrite( false ),
         _currentlySquirreled( false ),
-        _syncing( false ) {
+        _syncing( false ),
+        _readPinDepth( 0 ) {
     }
 
     WiredTigerRecoveryUnit::~WiredTigerRecoveryUnit() {
         invariant( _depth == 0 );
+        _releasePinnedCursors();
         _abort();
         if ( _session ) {
             _sessionCache->releaseSession( _session );
@@ -93,6 +153,32 @@ namespace mongo {
         }
     }
 
+    void WiredTigerRecoveryUnit::pinReads() {
+        _readPinDepth++;
+    }
+
+    void WiredTigerRecoveryUnit::unpinReads() {
+        invariant( _readPinDepth > 0 );
+        if ( --_readPinDepth == 0 ) {
+            _releasePinnedCursors();
+        }
+    }
+
+    bool WiredTigerRecoveryUnit::pinCursor( WiredTigerCursor* cursor ) {
+        dassert( _readPinDepth > 0 );
+        if ( _pinnedCursors.size() >= kMaxPinnedCursors )
+            return false;
+        _pinnedCursors.push_back( cursor );
+        return true;
+    }
+
+    void WiredTigerRecoveryUnit::_releasePinnedCursors() {
+        for ( size_t i = 0; i < _pinnedCursors.size(); i++ ) {
+            delete _pinnedCursors[i];
+        }
+        _pinnedCursors.clear();
+    }
+
     void WiredTigerRecoveryUnit::reportState( BSONObjBuilder* b ) const {
         b->append( "wt_depth", _depth );
         b->append( "wt_active", _active );
@@ -154,10 +240,10 @@ namespace mongo {
 
     bool WiredTigerRecoveryUnit::awaitCommit() {
         if ( _syncing && _everStartedWrite ) {
-            // we did a sync, so we're good
+            // _txnClose already put us through a group-committed flush, so we're good
             return true;
         }
-        awaitCommitData.awaitCommit();
+        groupCommitter.waitUntilDurable( _sessionCache );
         return true;
     }
 
@@ -199,12 +285,20 @@ namespace mongo {
 
     void WiredTigerRecoveryUnit::_txnClose( bool commit ) {
         invariant( _active );
+
+        // Buffers handed out under a read pin are only valid within the transaction; any
+        // caller that yields has copied what it still needs by now (see pinReads).
+        _releasePinnedCursors();
+
         WT_SESSION *s = _session->getSession();
         if ( commit ) {
             invariantWTOK( s->commit_transaction(s, NULL) );
             LOG(2) << "WT commit_transaction";
-            if ( _syncing )
-                awaitCommitData.syncHappend();
+            if ( _syncing ) {
+                // The commit is in WT's log buffer; join (or lead) a group flush to make
+                // it durable rather than paying a private sync per transaction.
+                groupCommitter.waitUntilDurable( _sessionCache );
+            }
         }
         else {
             invariantWTOK( s->rollback_transaction(s, NULL) );
@@ -221,8 +315,9 @@ namespace mongo {
     void WiredTigerRecoveryUnit::_txnOpen() {
         invariant( !_active );
         WT_SESSION *s = _session->getSession();
-        _syncing = _syncing || awaitCommitData.numWaitingForSync.load() > 0;
-        invariantWTOK( s->begin_transaction(s, _syncing ? "sync=true" : NULL) );
+        // Durability is provided by the group-committed log flush at _txnClose, so the
+        // transaction itself never needs to be opened with a private sync.
+        invariantWTOK( s->begin_transaction(s, NULL) );
         LOG(2) << "WT begin_transaction";
         _timer.reset();
         _active = true;
@@ -33,6 +33,7 @@
 #include <wiredtiger.h>
 
 #include <memory.h>
+#include <vector>
 
 #include <boost/scoped_ptr.hpp>
 
@@ -45,6 +46,7 @@
 namespace mongo {
 
     class BSONObjBuilder;
+    class WiredTigerCursor;
     class WiredTigerSession;
     class WiredTigerSessionCache;
 
@@ -77,6 +79,9 @@ namespace mongo {
 
         virtual uint64_t getMyTransactionCount() const;
 
+        virtual void pinReads();
+        virtual void unpinReads();
+
         // ---- WT STUFF
 
         WiredTigerSession* getSession();
@@ -90,6 +95,18 @@ namespace mongo {
         void setOplogReadTill( const RecordId& loc );
         RecordId getOplogReadTill() const { return _oplogReadTill; }
 
+        bool readsPinned() const { return _readPinDepth > 0; }
+
+        /**
+         * While reads are pinned (see RecoveryUnit::pinReads), a record store can hand over a
+         * positioned cursor whose most recently returned value is being used unowned by a
+         * caller. The cursor is never touched again, so WiredTiger keeps the value's memory
+         * valid; the cursor goes back to the session when reads are unpinned or the current
+         * transaction closes, whichever comes first. Returns false without taking ownership
+         * once too many cursors are pinned, in which case the caller should copy as usual.
+         */
+        bool pinCursor( WiredTigerCursor* cursor );
+
         static WiredTigerRecoveryUnit* get(OperationContext *txn);
 
     private:
@@ -100,6 +117,12 @@ namespace mongo {
         void _txnClose( bool commit );
         void _txnOpen();
 
+        void _releasePinnedCursors();
+
+        // Caps how much of the cache a single batch can pin through open cursors; past this
+        // point pinCursor refuses and reads fall back to copying.
+        static const size_t kMaxPinnedCursors;
+
         WiredTigerSessionCache* _sessionCache; // not owned
         WiredTigerSession* _session; // owned, but from pool
         bool _defaultCommit;
@@ -111,6 +134,8 @@ namespace mongo {
         bool _currentlySquirreled;
         bool _syncing;
         RecordId _oplogReadTill;
+        int _readPinDepth;
+        std::vector<WiredTigerCursor*> _pinnedCursors; // owned; see pinCursor
 
         typedef OwnedPointerVector<Change> Changes;
         Changes _changes;
@@ -56,6 +56,10 @@ namespace mongo {
         return true;
     }
 
+    bool WiredTigerServerStatusSection::includeInStatusSnapshot() const {
+        return true;
+    }
+
     BSONObj WiredTigerServerStatusSection::generateSection(
                 OperationContext* txn,
                 const BSONElement& configElement) const {
@@ -35,6 +35,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -107,6 +108,25 @@ namespace mongo {
     namespace {
         AtomicUInt64 nextCursorId(1);
         AtomicUInt64 cachePartitionGen(0);
+
+        /**
+         * Each thread draws sessions from a single cache partition, assigned round-robin
+         * the first time the thread asks for a session.  With threads pinned to partitions
+         * the partition spinlock is uncontended in the common case and a thread gets back
+         * the sessions (and their warm cursor caches) it released earlier, instead of every
+         * getSession call bumping one globally shared counter and hopping partitions.
+         */
+        struct SessionCachePartitionId {
+            SessionCachePartitionId() {
+                value = static_cast<int>(
+                    cachePartitionGen.addAndFetch(1) %
+                    WiredTigerSessionCache::NumSessionCachePartitions);
+            }
+            int value;
+        };
+
+        TSP_DECLARE(SessionCachePartitionId, threadSessionCachePartition)
+        TSP_DEFINE(SessionCachePartitionId, threadSessionCachePartition)
     }
     // static
     uint64_t WiredTigerSession::genCursorId() {
@@ -169,8 +189,10 @@ namespace mongo {
         // operations should be allowed to start.
         invariant(!_shuttingDown.loadRelaxed());
 
-        // Spread sessions uniformly across the cache partitions
-        const int cachePartition = cachePartitionGen.addAndFetch(1) % NumSessionCachePartitions;
+        // Threads have affinity to one cache partition (see SessionCachePartitionId), so
+        // this lock is effectively private to the calling thread unless threads outnumber
+        // the partitions.
+        const int cachePartition = threadSessionCachePartition.getMake()->value;
 
         int epoch;
 
@@ -118,11 +118,11 @@ namespace mongo {
 
         void shuttingDown();
 
+        enum { NumSessionCachePartitions = 64 };
+
     private:
         typedef std::vector<WiredTigerSession*> SessionPool;
 
-        enum { NumSessionCachePartitions = 64 };
-
         struct SessionCachePartition {
             SessionCachePartition() : epoch(0) { }
             ~SessionCachePartition() {
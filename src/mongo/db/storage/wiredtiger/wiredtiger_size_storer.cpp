@@ -45,10 +45,16 @@ namespace mongo {
 
     namespace {
         int MAGIC = 123123;
+
+        // Key of the clean shutdown marker row. Table uris all start with "table:" so
+        // this can never collide with a real entry.
+        const std::string CLEAN_SHUTDOWN_KEY( "_cleanShutdown" );
     }
 
     WiredTigerSizeStorer::WiredTigerSizeStorer() {
         _magic = MAGIC;
+        // nothing loaded yet, so nothing in here can be stale
+        _cleanShutdown = true;
     }
 
     WiredTigerSizeStorer::~WiredTigerSizeStorer() {
@@ -79,6 +85,7 @@ namespace mongo {
         Entry& entry = _entries[rs->getURI()];
         entry.numRecords = rs->numRecords( NULL );
         entry.dataSize = rs->dataSize( NULL );
+        entry.highestId = rs->highestRecordId();
         entry.dirty = true;
         entry.rs = NULL;
     }
@@ -95,17 +102,22 @@ namespace mongo {
     }
 
     void WiredTigerSizeStorer::load( const StringData& uri,
-                                     long long* numRecords, long long* dataSize ) const {
+                                     long long* numRecords, long long* dataSize,
+                                     long long* highestId ) const {
         _checkMagic();
         boost::mutex::scoped_lock lk( _entriesMutex );
         Map::const_iterator it = _entries.find( uri.toString() );
         if ( it == _entries.end() ) {
             *numRecords = 0;
             *dataSize = 0;
+            if ( highestId )
+                *highestId = 0;
             return;
         }
         *numRecords = it->second.numRecords;
         *dataSize = it->second.dataSize;
+        if ( highestId )
+            *highestId = it->second.highestId;
     }
 
     void WiredTigerSizeStorer::loadFrom( WiredTigerSession* session,
@@ -113,6 +125,7 @@ namespace mongo {
         _checkMagic();
 
         Map m;
+        bool cleanShutdown = false;
         {
             WT_SESSION* s = session->getSession();
             WT_CURSOR* c = NULL;
@@ -129,6 +142,10 @@ namespace mongo {
                 invariantWTOK( c->get_key(c, &key ) );
                 invariantWTOK( c->get_value(c, &value ) );
                 std::string uriKey( reinterpret_cast<const char*>( key.data ), key.size );
+                if ( uriKey == CLEAN_SHUTDOWN_KEY ) {
+                    cleanShutdown = true;
+                    continue;
+                }
                 BSONObj data( reinterpret_cast<const char*>( value.data ) );
 
                 LOG(2) << "WiredTigerSizeStorer::loadFrom " << uriKey << " -> " << data;
@@ -136,18 +153,32 @@ namespace mongo {
                 Entry& e = m[uriKey];
                 e.numRecords = data["numRecords"].safeNumberLong();
                 e.dataSize = data["dataSize"].safeNumberLong();
+                e.highestId = data["highestId"].safeNumberLong();
                 e.dirty = false;
                 e.rs = NULL;
             }
+
+            if ( cleanShutdown ) {
+                // consume the marker so that a crash from here on reads as unclean on
+                // the next startup
+                WiredTigerItem key( CLEAN_SHUTDOWN_KEY.c_str(), CLEAN_SHUTDOWN_KEY.size() );
+                c->set_key( c, key.Get() );
+                ret = c->remove( c );
+                if ( ret != WT_NOTFOUND )
+                    invariantWTOK( ret );
+            }
+
             invariantWTOK( c->close(c) );
         }
 
         boost::mutex::scoped_lock lk( _entriesMutex );
         _entries = m;
+        _cleanShutdown = cleanShutdown;
     }
 
     void WiredTigerSizeStorer::storeInto( WiredTigerSession* session,
-                                          const std::string& uri ) {
+                                          const std::string& uri,
+                                          bool markCleanShutdown ) {
         Map myMap;
         {
             boost::mutex::scoped_lock lk( _entriesMutex );
@@ -163,6 +194,7 @@ namespace mongo {
                         entry.numRecords = entry.rs->numRecords( NULL );
                         entry.dirty = true;
                     }
+                    entry.highestId = entry.rs->highestRecordId();
                 }
 
                 if ( !entry.dirty )
@@ -189,6 +221,7 @@ namespace mongo {
                 BSONObjBuilder b;
                 b.append( "numRecords", entry.numRecords );
                 b.append( "dataSize", entry.dataSize );
+                b.append( "highestId", entry.highestId );
                 data = b.obj();
             }
 
@@ -204,6 +237,15 @@ namespace mongo {
             c->reset(c);
         }
 
+        if ( markCleanShutdown ) {
+            BSONObj marker = BSON( "clean" << true );
+            WiredTigerItem key( CLEAN_SHUTDOWN_KEY.c_str(), CLEAN_SHUTDOWN_KEY.size() );
+            WiredTigerItem value( marker.objdata(), marker.objsize() );
+            c->set_key( c, key.Get() );
+            c->set_value( c, value.Get() );
+            invariantWTOK( c->insert(c) );
+        }
+
         invariantWTOK( c->close(c) );
 
     }
@@ -55,23 +55,39 @@ namespace mongo {
                     long long numRecords, long long dataSize );
 
         void load( const StringData& uri,
-                   long long* numRecords, long long* dataSize ) const;
+                   long long* numRecords, long long* dataSize,
+                   long long* highestId = NULL ) const;
 
         void loadFrom( WiredTigerSession* cursor, const std::string& uri );
-        void storeInto( WiredTigerSession* cursor, const std::string& uri );
+
+        /**
+         * If markCleanShutdown is set, a marker row goes into the table along with the
+         * entries. loadFrom() consumes the marker, so finding one at startup means the
+         * previous shutdown flushed final counts; only the shutdown sync should set it.
+         */
+        void storeInto( WiredTigerSession* cursor, const std::string& uri,
+                        bool markCleanShutdown = false );
+
+        /**
+         * Returns false if the last loadFrom() read a table left behind by a crash, in
+         * which case the stored counts may predate the most recent writes.
+         */
+        bool loadedFromCleanShutdown() const { return _cleanShutdown; }
 
     private:
         void _checkMagic() const;
 
         struct Entry {
-            Entry() : numRecords(0), dataSize(0), dirty(false), rs(NULL){}
+            Entry() : numRecords(0), dataSize(0), highestId(0), dirty(false), rs(NULL){}
             long long numRecords;
             long long dataSize;
+            long long highestId; // highest record id at the time the counts were taken
             bool dirty;
             WiredTigerRecordStore* rs; // not owned
         };
 
         int _magic;
+        bool _cleanShutdown;
 
         typedef std::map<std::string,Entry> Map;
         Map _entries;
@@ -34,12 +34,15 @@
 
 #include "mongo/db/ttl.h"
 
+#include <boost/scoped_ptr.hpp>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
@@ -47,10 +50,13 @@
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/operation_context_impl.h"
-#include "mongo/db/ops/delete.h"
+#include "mongo/db/ops/delete_request.h"
+#include "mongo/db/ops/parsed_delete.h"
+#include "mongo/db/query/get_executor.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 
@@ -64,62 +70,123 @@ namespace mongo {
 
     MONGO_EXPORT_SERVER_PARAMETER( ttlMonitorEnabled, bool, true );
 
-    class TTLMonitor : public BackgroundJob {
+    // How many documents a TTL pass deletes per collection lock acquisition, and how long
+    // it waits between batches.  Small batches with a pause keep a large expired backlog
+    // from monopolizing the collection lock for the whole pass.
+    MONGO_EXPORT_SERVER_PARAMETER( ttlDeleteBatchSize, int, 1000 );
+    MONGO_EXPORT_SERVER_PARAMETER( ttlDeleteBatchDelayMS, int, 10 );
+
+    namespace {
+
+        // Per-collection counters reported by the "ttl" serverStatus section below.
+        struct TTLCollectionStats {
+            TTLCollectionStats() : deletedDocuments(0), batches(0), lastPassDeleted(0) {}
+            long long deletedDocuments;
+            long long batches;
+            long long lastPassDeleted;
+        };
+
+        SimpleMutex ttlStatsMutex( "ttlStats" );
+        typedef map<string, TTLCollectionStats> TTLStatsMap;
+        TTLStatsMap ttlStatsByCollection;
+
+        void recordTTLPass( const string& ns, long long numDeleted, long long numBatches ) {
+            if ( numBatches == 0 && numDeleted == 0 ) {
+                // We bailed out before doing any work; don't invent a stats entry.
+                return;
+            }
+            ttlDeletedDocuments.increment( numDeleted );
+            SimpleMutex::scoped_lock lk( ttlStatsMutex );
+            TTLCollectionStats& stats = ttlStatsByCollection[ns];
+            stats.deletedDocuments += numDeleted;
+            stats.batches += numBatches;
+            stats.lastPassDeleted = numDeleted;
+        }
+
+        class TTLServerStatusSection : public ServerStatusSection {
+        public:
+            TTLServerStatusSection() : ServerStatusSection( "ttl" ) {}
+            virtual bool includeByDefault() const { return false; }
+
+            virtual BSONObj generateSection(OperationContext* txn,
+                                            const BSONElement& configElement) const {
+                BSONObjBuilder result;
+                SimpleMutex::scoped_lock lk( ttlStatsMutex );
+                for ( TTLStatsMap::const_iterator it = ttlStatsByCollection.begin();
+                      it != ttlStatsByCollection.end(); ++it ) {
+                    BSONObjBuilder sub( result.subobjStart( it->first ) );
+                    sub.appendNumber( "deletedDocuments", it->second.deletedDocuments );
+                    sub.appendNumber( "batches", it->second.batches );
+                    sub.appendNumber( "lastPassDeleted", it->second.lastPassDeleted );
+                    sub.done();
+                }
+                return result.obj();
+            }
+        } ttlServerStatusSection;
+
+    }  // namespace
+
+    class TTLMonitor : public PeriodicTask {
     public:
         TTLMonitor(){}
         virtual ~TTLMonitor(){}
 
-        virtual string name() const { return "TTLMonitor"; }
+        virtual string taskName() const { return "TTLMonitor"; }
+
+        virtual int taskPeriodMillis() const { return 60 * 1000; }
 
         static string secondsExpireField;
 
-        virtual void run() {
-            Client::initThread( name().c_str() );
-            cc().getAuthorizationSession()->grantInternalAuthorization();
+        virtual void taskDoWork() {
+            if ( inShutdown() )
+                return;
 
-            while ( ! inShutdown() ) {
-                sleepsecs( 60 );
+            LOG(3) << "TTLMonitor thread awake" << endl;
 
-                LOG(3) << "TTLMonitor thread awake" << endl;
+            if ( !ttlMonitorEnabled ) {
+               LOG(1) << "TTLMonitor is disabled" << endl;
+               return;
+            }
 
-                if ( !ttlMonitorEnabled ) {
-                   LOG(1) << "TTLMonitor is disabled" << endl;
-                   continue;
-                }
+            if ( lockedForWriting() ) {
+                // note: this is not perfect as you can go into fsync+lock between
+                // this and actually doing the delete later
+                LOG(3) << " locked for writing" << endl;
+                return;
+            }
 
-                if ( lockedForWriting() ) {
-                    // note: this is not perfect as you can go into fsync+lock between
-                    // this and actually doing the delete later
-                    LOG(3) << " locked for writing" << endl;
-                    continue;
-                }
+            // We run on the shared periodic task thread, which does no Client setup of
+            // its own.
+            if ( !haveClient() ) {
+                Client::initThread( "TTLMonitor" );
+                cc().getAuthorizationSession()->grantInternalAuthorization();
+            }
 
-                // Count it as active from the moment the TTL thread wakes up
-                OperationContextImpl txn;
+            // Count it as active from the moment the TTL pass starts
+            OperationContextImpl txn;
 
-                // if part of replSet but not in a readable state (e.g. during initial sync), skip.
-                if (repl::getGlobalReplicationCoordinator()->getReplicationMode() ==
-                        repl::ReplicationCoordinator::modeReplSet &&
-                        !repl::getGlobalReplicationCoordinator()->getCurrentMemberState().readable())
-                    continue;
+            // if part of replSet but not in a readable state (e.g. during initial sync), skip.
+            if (repl::getGlobalReplicationCoordinator()->getReplicationMode() ==
+                    repl::ReplicationCoordinator::modeReplSet &&
+                    !repl::getGlobalReplicationCoordinator()->getCurrentMemberState().readable())
+                return;
 
-                set<string> dbs;
-                dbHolder().getAllShortNames( dbs );
+            set<string> dbs;
+            dbHolder().getAllShortNames( dbs );
 
-                ttlPasses.increment();
+            ttlPasses.increment();
 
-                for ( set<string>::const_iterator i=dbs.begin(); i!=dbs.end(); ++i ) {
-                    string db = *i;
+            for ( set<string>::const_iterator i=dbs.begin(); i!=dbs.end(); ++i ) {
+                string db = *i;
 
-                    vector<BSONObj> indexes;
-                    getTTLIndexesForDB(&txn, db, &indexes);
+                vector<BSONObj> indexes;
+                getTTLIndexesForDB(&txn, db, &indexes);
 
-                    for ( vector<BSONObj>::const_iterator it = indexes.begin();
-                          it != indexes.end(); ++it ) {
+                for ( vector<BSONObj>::const_iterator it = indexes.begin();
+                      it != indexes.end(); ++it ) {
 
-                        if ( !doTTLForIndex( &txn, db, *it ) ) {
-                            break;  // stop processing TTL indexes on this database
-                        }
+                    if ( !doTTLForIndex( &txn, db, *it ) ) {
+                        break;  // stop processing TTL indexes on this database
                     }
                 }
             }
@@ -206,62 +273,126 @@ namespace mongo {
 
             LOG(1) << "TTL: " << key << " \t " << query << endl;
 
+            const string ns = idx["ns"].String();
+
+            int batchSize = ttlDeleteBatchSize;
+            if ( batchSize < 1 )
+                batchSize = 1;
+
             long long numDeleted = 0;
+            long long numBatches = 0;
             int attempt = 1;
             while (1) {
-                const string ns = idx["ns"].String();
+                long long batchDeleted = 0;
+                bool moreToDelete = false;
+
+                // Each batch takes and releases the collection lock, so foreground
+                // operations interleave with a long expired backlog instead of
+                // stalling behind one mass delete.
+                {
+                    ScopedTransaction scopedXact(txn, MODE_IX);
+                    AutoGetDb autoDb(txn, dbName, MODE_IX);
+                    Database* db = autoDb.getDb();
+                    if (!db) {
+                        recordTTLPass( ns, numDeleted, numBatches );
+                        return false;
+                    }
 
-                ScopedTransaction scopedXact(txn, MODE_IX);
-                AutoGetDb autoDb(txn, dbName, MODE_IX);
-                Database* db = autoDb.getDb();
-                if (!db) {
-                    return false;
-                }
+                    Lock::CollectionLock collLock( txn->lockState(), ns, MODE_IX );
 
-                Lock::CollectionLock collLock( txn->lockState(), ns, MODE_IX );
+                    Collection* collection = db->getCollection( ns );
+                    if ( !collection ) {
+                        // collection was dropped
+                        recordTTLPass( ns, numDeleted, numBatches );
+                        return true;
+                    }
 
-                Collection* collection = db->getCollection( ns );
-                if ( !collection ) {
-                    // collection was dropped
-                    return true;
-                }
+                    if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesForDatabase(
+                            dbName)) {
+                        // we've stepped down since we started this function,
+                        // so we should stop working as we only do deletes on the primary
+                        recordTTLPass( ns, numDeleted, numBatches );
+                        return false;
+                    }
 
-                if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesForDatabase(dbName)) {
-                    // we've stepped down since we started this function,
-                    // so we should stop working as we only do deletes on the primary
-                    return false;
-                }
+                    if ( collection->getIndexCatalog()->findIndexByKeyPattern( txn, key )
+                            == NULL ) {
+                        // index not finished yet
+                        LOG(1) << " skipping index because not finished";
+                        recordTTLPass( ns, numDeleted, numBatches );
+                        return true;
+                    }
+
+                    try {
+                        const NamespaceString nss( ns );
+                        DeleteRequest request( nss );
+                        request.setQuery( query );
+                        // Deleting in the TTL index's own order keeps each batch
+                        // unlinking neighbouring btree entries instead of hopping
+                        // around the tree.
+                        request.setSort( key );
+                        request.setMulti();
+                        request.setUpdateOpLog();
+                        // When asked to return the deleted documents the stage
+                        // advances once per delete, which is what lets us cut the
+                        // plan off at a batch boundary.
+                        request.setReturnDeleted();
+                        request.setYieldPolicy( PlanExecutor::YIELD_AUTO );
+
+                        ParsedDelete parsedDelete( txn, &request );
+                        uassertStatusOK( parsedDelete.parseRequest() );
+
+                        PlanExecutor* rawExec;
+                        uassertStatusOK( getExecutorDelete( txn, collection, &parsedDelete,
+                                                            &rawExec ) );
+                        boost::scoped_ptr<PlanExecutor> exec( rawExec );
+
+                        PlanExecutor::ExecState state = PlanExecutor::IS_EOF;
+                        while ( batchDeleted < batchSize ) {
+                            state = exec->getNext( NULL, NULL );
+                            if ( PlanExecutor::ADVANCED != state )
+                                break;
+                            batchDeleted++;
+                        }
 
-                if ( collection->getIndexCatalog()->findIndexByKeyPattern( txn, key ) == NULL ) {
-                    // index not finished yet
-                    LOG(1) << " skipping index because not finished";
-                    return true;
+                        if ( PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state ) {
+                            warning() << "TTL delete plan on " << ns << " stopped early: "
+                                      << PlanExecutor::statestr( state );
+                        }
+                        else {
+                            moreToDelete = ( PlanExecutor::ADVANCED == state );
+                        }
+                    }
+                    catch (const WriteConflictException& dle) {
+                        WriteConflictException::logAndBackoff(attempt++, "ttl", ns);
+                        // Deletes that committed before the conflict stick; retry the
+                        // rest of the backlog with freshly acquired locks.
+                        moreToDelete = true;
+                    }
                 }
 
-                try {
-                    numDeleted = deleteObjects(txn,
-                                               db,
-                                               ns,
-                                               query,
-                                               PlanExecutor::YIELD_AUTO,
-                                               false,
-                                               true);
+                numDeleted += batchDeleted;
+                numBatches++;
+
+                if ( !moreToDelete )
                     break;
-                }
-                catch (const WriteConflictException& dle) {
-                    WriteConflictException::logAndBackoff(attempt++, "ttl", ns);
+
+                const int delayMS = ttlDeleteBatchDelayMS;
+                if ( delayMS > 0 ) {
+                    sleepmillis( delayMS );
                 }
             }
 
-            ttlDeletedDocuments.increment(numDeleted);
+            recordTTLPass( ns, numDeleted, numBatches );
             LOG(1) << "\tTTL deleted: " << numDeleted << endl;
             return true;
         }
     };
 
     void startTTLBackgroundJob() {
-        TTLMonitor* ttl = new TTLMonitor();
-        ttl->go();
+        // The monitor registers itself with the shared periodic task runner, which is
+        // started right after this call during startup; no dedicated thread anymore.
+        new TTLMonitor();
     }
 
     string TTLMonitor::secondsExpireField = "expireAfterSeconds";
@@ -31,8 +31,10 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/bind.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
 #include <iostream>
 
 #include "mongo/db/operation_context_impl.h"
@@ -42,6 +44,8 @@
 #include "mongo/util/paths.h"
 #include "mongo/util/ptr.h"
 #include "mongo/util/queue.h"
+#include "mongo/util/shared_buffer.h"
+#include "mongo/util/spsc_queue.h"
 #include "mongo/util/stringutils.h"
 #include "mongo/util/text.h"
 #include "mongo/util/thread_safe_string.h"
@@ -472,6 +476,67 @@ namespace BasicTests {
         }
     };
 
+    class SPSCQueueTest {
+    public:
+        static const int N = 1000;
+
+        void run() {
+            // only 16 slots, so the batch below wraps the ring many times and
+            // blocks the producer at the full edge while the consumer drains
+            SingleProducerSingleConsumerQueue<int> q( 1000 * 1000, &_getSizeDefault, 16 );
+            int x;
+
+            ASSERT( q.empty() );
+            ASSERT( ! q.tryPop( x ) );
+            ASSERT( ! q.peek( x ) );
+
+            int vals[] = { 1, 2, 3, 4, 5 };
+            q.pushBatch( vals, vals + 5 );
+            ASSERT_EQUALS( 5, q.count() );
+            ASSERT( q.peek( x ) );
+            ASSERT_EQUALS( 1, x );
+            for ( int i = 1; i <= 5; i++ ) {
+                ASSERT( q.tryPop( x ) );
+                ASSERT_EQUALS( i, x );
+            }
+            ASSERT( q.empty() );
+            ASSERT( ! q.blockingPop( x, 1 ) );
+
+            boost::thread consumer( boost::bind( &SPSCQueueTest::drain, this, &q ) );
+            std::vector<int> many;
+            for ( int i = 0; i < N; i++ )
+                many.push_back( i );
+            q.pushBatch( many.begin(), many.end() );
+            consumer.join();
+            ASSERT( q.empty() );
+        }
+
+        void drain( SingleProducerSingleConsumerQueue<int>* q ) {
+            for ( int i = 0; i < N; i++ ) {
+                ASSERT_EQUALS( i, q->blockingPop() );
+            }
+        }
+    };
+
+    class SharedBufferViewTest {
+    public:
+        void run() {
+            SharedBuffer buf = SharedBuffer::allocate( 4 );
+            memcpy( buf.get(), "abc", 4 );
+            ASSERT( buf.unique() );
+
+            // borrowing doesn't touch the refcount
+            SharedBuffer::View view = buf.view();
+            ASSERT_EQUALS( buf.get(), view.get() );
+            ASSERT( buf.unique() );
+
+            // promoting does
+            SharedBuffer owned = view.own();
+            ASSERT_EQUALS( buf.get(), owned.get() );
+            ASSERT( ! buf.unique() );
+        }
+    };
+
     class StrTests {
     public:
 
@@ -551,6 +616,8 @@ namespace BasicTests {
             add< IsValidUTF8Test >();
 
             add< QueueTest >();
+            add< SPSCQueueTest >();
+            add< SharedBufferViewTest >();
 
             add< StrTests >();
 
@@ -374,6 +374,54 @@ namespace JsobjTests {
             }
         };
 
+        // the table-dispatched comparator must order exactly like woCompare
+        // without field names, for same-type, mixed-numeric and mixed-canonical
+        // pairs alike
+        class CompareElementsFastAgrees : public Base {
+        public:
+            void run() {
+                std::vector< BSONObj > vals;
+                vals.push_back( BSON( "" << 1.5 ) );
+                vals.push_back( BSON( "" << 3 ) );
+                vals.push_back( BSON( "" << 12345678901234LL ) );
+                vals.push_back( BSON( "" << ( 1ll << 60 ) ) );
+                vals.push_back( BSON( "" << 9.3e18 ) );
+                vals.push_back( BSON( "" << std::numeric_limits<double>::quiet_NaN() ) );
+                vals.push_back( BSON( "" << "ab" ) );
+                vals.push_back( BSON( "" << "abc" ) );
+                vals.push_back( BSON( "" << BSONSymbol( "abc" ) ) );
+                vals.push_back( BSON( "" << BSONCode( "abc" ) ) );
+                vals.push_back( BSON( "" << true ) );
+                vals.push_back( BSON( "" << OID( "4c88d4f2a10f6711b9ad6b43" ) ) );
+                vals.push_back( BSON( "" << Date_t( 1234567 ) ) );
+                vals.push_back( BSON( "" << BSON( "a" << 1 ) ) );
+                vals.push_back( BSON( "" << BSONNULL ) );
+                vals.push_back( BSON( "" << MINKEY ) );
+                vals.push_back( BSON( "" << MAXKEY ) );
+                vals.push_back( BSON( "" << BSONRegEx( "^a", "i" ) ) );
+                vals.push_back( BSON( "" << BSONBinData( "1234", 4, BinDataGeneral ) ) );
+                {
+                    BSONObjBuilder b;
+                    b.appendTimestamp( "", 1000, 1 );
+                    vals.push_back( b.obj() );
+                }
+
+                for ( size_t i = 0; i < vals.size(); i++ ) {
+                    for ( size_t j = 0; j < vals.size(); j++ ) {
+                        BSONElement l = vals[ i ].firstElement();
+                        BSONElement r = vals[ j ].firstElement();
+                        ASSERT_EQUALS( sign( l.woCompare( r, false ) ),
+                                       sign( compareElementsFast( l, r ) ) );
+                    }
+                }
+            }
+
+        private:
+            static int sign( int x ) {
+                return x < 0 ? -1 : ( x > 0 ? 1 : 0 );
+            }
+        };
+
         class WoSortOrder : public Base {
         public:
             void run() {
@@ -2205,6 +2253,7 @@ namespace JsobjTests {
             add< BSONObjTests::WoCompareEmbeddedArray >();
             add< BSONObjTests::WoCompareOrdered >();
             add< BSONObjTests::WoCompareDifferentLength >();
+            add< BSONObjTests::CompareElementsFastAgrees >();
             add< BSONObjTests::WoSortOrder >();
             add< BSONObjTests::IsPrefixOf >();
             add< BSONObjTests::MultiKeySortOrder > ();
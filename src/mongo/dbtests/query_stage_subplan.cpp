@@ -155,6 +155,59 @@ namespace QueryStageSubplan {
         }
     };
 
+    /**
+     * Test that a branch with exactly one candidate plan is inserted into the plan cache,
+     * even though the MultiPlanStage never runs for it.
+     */
+    class QueryStageSubplanSingleSolutionCached : public QueryStageSubplanBase {
+    public:
+        void run() {
+            Client::WriteContext ctx(&_txn, ns());
+
+            addIndex(BSON("a" << 1));
+            addIndex(BSON("b" << 1));
+
+            for (int i = 0; i < 10; i++) {
+                insert(BSON("a" << i << "b" << i));
+            }
+
+            // Each branch is answerable by exactly one of the indices, so each branch has a
+            // single candidate plan and no multi-planning takes place.
+            BSONObj query = fromjson("{$or: [{a: 1}, {b: 1}]}");
+
+            Collection* collection = ctx.getCollection();
+
+            CanonicalQuery* rawCq;
+            ASSERT_OK(CanonicalQuery::canonicalize(ns(), query, &rawCq));
+            boost::scoped_ptr<CanonicalQuery> cq(rawCq);
+
+            // Get planner params.
+            QueryPlannerParams plannerParams;
+            fillOutPlannerParams(&_txn, collection, cq.get(), &plannerParams);
+
+            WorkingSet ws;
+            boost::scoped_ptr<SubplanStage> subplan(new SubplanStage(&_txn, collection, &ws,
+                                                                     plannerParams, cq.get()));
+
+            // NULL means that 'subplan' should not yield during plan selection.
+            ASSERT_OK(subplan->pickBestPlan(NULL));
+
+            // Nothing is in the cache yet.
+            ASSERT_FALSE(subplan->branchPlannedFromCache(0));
+            ASSERT_FALSE(subplan->branchPlannedFromCache(1));
+
+            // The lone solutions should have been cached, so repeating the same query
+            // plans both branches from the cache.
+            ws.clear();
+            subplan.reset(new SubplanStage(&_txn, collection, &ws, plannerParams, cq.get()));
+
+            ASSERT_OK(subplan->pickBestPlan(NULL));
+
+            ASSERT_TRUE(subplan->branchPlannedFromCache(0));
+            ASSERT_TRUE(subplan->branchPlannedFromCache(1));
+        }
+    };
+
     class All : public Suite {
     public:
         All() : Suite("query_stage_subplan") {}
@@ -162,6 +215,7 @@ namespace QueryStageSubplan {
         void setupTests() {
             add<QueryStageSubplanGeo2dOr>();
             add<QueryStageSubplanPlanFromCache>();
+            add<QueryStageSubplanSingleSolutionCached>();
         }
     };
 
@@ -325,9 +325,17 @@ namespace ThreadedTests {
                 tp.schedule(&ThreadPoolTest::increment, this, 2);
             }
 
+            // also exercise affinity-hinted and batch submission
+            std::vector<threadpool::Task> batch;
+            for (unsigned i=0; i < iterations; i++) {
+                tp.scheduleWithAffinity(stdx::bind(&ThreadPoolTest::increment, this, 1), i);
+                batch.push_back(stdx::bind(&ThreadPoolTest::increment, this, 1));
+            }
+            tp.scheduleBatch(batch);
+
             tp.join();
 
-            ASSERT_EQUALS(counter.load(), iterations * 2);
+            ASSERT_EQUALS(counter.load(), iterations * 4);
         }
     };
 
@@ -809,6 +817,46 @@ namespace ThreadedTests {
 
     };
 
+    // Exercises the deadline and priority extensions of TicketHolder: an exhausted
+    // holder must time out waiters, and while a high priority waiter is queued a
+    // released ticket must not be handed out at normal priority.
+    class TicketHolderDeadlinesAndPriority {
+    public:
+        TicketHolderDeadlinesAndPriority() : _highGotTicket( false ) {}
+
+        void run() {
+            TicketHolder tickets( 1 );
+
+            verify( tickets.tryAcquire() );
+            verify( !tickets.waitForTicket( TicketHolder::PRIORITY_NORMAL, 100 ) );
+
+            boost::thread high( stdx::bind( &TicketHolderDeadlinesAndPriority::highWaiter,
+                                            this,
+                                            &tickets ) );
+            sleepmillis( 300 ); // let the high priority waiter queue up
+            tickets.release();
+
+            // either the high priority waiter holds the ticket already, or the free
+            // ticket is reserved for it; both ways normal priority must lose
+            verify( !tickets.tryAcquire() );
+
+            high.join();
+            verify( _highGotTicket );
+            verify( tickets.tryAcquire() );
+            tickets.release();
+        }
+
+    private:
+        void highWaiter( TicketHolder* tickets ) {
+            verify( tickets->waitForTicket( TicketHolder::PRIORITY_HIGH, 10 * 1000 ) );
+            _highGotTicket = true;
+            sleepmillis( 300 );
+            tickets->release();
+        }
+
+        bool _highGotTicket;
+    };
+
     class All : public Suite {
     public:
         All() : Suite( "threading" ) { }
@@ -838,6 +886,7 @@ namespace ThreadedTests {
 
             add< MongoMutexTest >();
             add< TicketHolderWaits >();
+            add< TicketHolderDeadlinesAndPriority >();
         }
     };
 
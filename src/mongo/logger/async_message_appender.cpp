@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_message_appender.h"
+
+#include <boost/bind.hpp>
+#include <memory>
+#include <sstream>
+
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+
+    AsyncMessageAppender::AsyncMessageAppender(Appender<MessageEventEphemeral>* target,
+                                               size_t maxQueueSize)
+        : _target(target),
+          _maxQueueSize(maxQueueSize),
+          _numDropped(0),
+          _shutdown(false),
+          _writer(boost::bind(&AsyncMessageAppender::writeLoop, this)) {
+    }
+
+    AsyncMessageAppender::~AsyncMessageAppender() {
+        {
+            boost::lock_guard<boost::mutex> lk(_mutex);
+            _shutdown = true;
+            _newEvent.notify_one();
+        }
+        _writer.join();
+    }
+
+    Status AsyncMessageAppender::append(const MessageEventEphemeral& event) {
+        std::auto_ptr<QueuedEvent> queued(new QueuedEvent(event));
+        const bool waitForDrain = event.getSeverity() >= LogSeverity::Error();
+
+        boost::unique_lock<boost::mutex> lk(_mutex);
+        if (_shutdown) {
+            // The writer thread is gone; this can only happen for stragglers
+            // logging during teardown.  Write through synchronously.
+            lk.unlock();
+            return _target->append(event);
+        }
+        if (_queue.size() >= _maxQueueSize) {
+            ++_numDropped;
+            return Status::OK();
+        }
+        _queue.push_back(queued.release());
+        _newEvent.notify_one();
+        if (waitForDrain) {
+            while (!_queue.empty()) {
+                _drained.wait(lk);
+            }
+        }
+        return Status::OK();
+    }
+
+    void AsyncMessageAppender::writeLoop() {
+        boost::unique_lock<boost::mutex> lk(_mutex);
+        while (!_shutdown || !_queue.empty()) {
+            if (_queue.empty()) {
+                _newEvent.wait(lk);
+                continue;
+            }
+
+            EventQueue batch;
+            batch.swap(_queue);
+            const uint64_t numDropped = _numDropped;
+            _numDropped = 0;
+
+            lk.unlock();
+            for (EventQueue::const_iterator it = batch.begin(); it != batch.end(); ++it) {
+                QueuedEvent* e = *it;
+                _target->append(MessageEventEphemeral(
+                        e->date, e->severity, e->component, e->contextName, e->message));
+                delete e;
+            }
+            if (numDropped > 0) {
+                std::ostringstream oss;
+                oss << "log writer fell behind; dropped " << numDropped << " log line(s)\n";
+                _target->append(MessageEventEphemeral(
+                        curTimeMillis64(), LogSeverity::Warning(), "log", oss.str()));
+            }
+            lk.lock();
+
+            if (_queue.empty()) {
+                _drained.notify_all();
+            }
+        }
+    }
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/message_event.h"
+
+namespace mongo {
+namespace logger {
+
+    /**
+     * Appender decorator that moves encoding and writing of message events off the
+     * logging thread.  append() copies the event into a bounded in-memory queue and
+     * returns; a dedicated writer thread drains the queue into the wrapped appender
+     * in batches.
+     *
+     * If the queue is full, events are dropped and counted, and a single warning
+     * line reporting how many were dropped is written once the writer catches up.
+     * Events of Error severity or worse wait for the queue to drain, so that
+     * serious messages reach their sink before a possible crash.
+     */
+    class AsyncMessageAppender : public Appender<MessageEventEphemeral> {
+        MONGO_DISALLOW_COPYING(AsyncMessageAppender);
+
+    public:
+        static const size_t kDefaultMaxQueueSize = 10 * 1000;
+
+        /**
+         * Constructs an appender that forwards events to "target", of which it
+         * takes ownership, and starts the writer thread.
+         */
+        explicit AsyncMessageAppender(Appender<MessageEventEphemeral>* target,
+                                      size_t maxQueueSize = kDefaultMaxQueueSize);
+
+        /**
+         * Drains any queued events into the target and stops the writer thread.
+         */
+        virtual ~AsyncMessageAppender();
+
+        virtual Status append(const MessageEventEphemeral& event);
+
+    private:
+        /**
+         * Owned copy of one event; MessageEventEphemeral does not own its storage
+         * so its fields must be captured before the logging statement returns.
+         */
+        struct QueuedEvent {
+            QueuedEvent(const MessageEventEphemeral& event)
+                : date(event.getDate()),
+                  severity(event.getSeverity()),
+                  component(event.getComponent()),
+                  contextName(event.getContextName().toString()),
+                  message(event.getMessage().toString()) {}
+
+            Date_t date;
+            LogSeverity severity;
+            LogComponent component;
+            std::string contextName;
+            std::string message;
+        };
+
+        typedef std::deque<QueuedEvent*> EventQueue;
+
+        void writeLoop();
+
+        boost::scoped_ptr<Appender<MessageEventEphemeral> > _target;
+        const size_t _maxQueueSize;
+
+        boost::mutex _mutex;  // Guards all state below.
+        boost::condition_variable _newEvent;
+        boost::condition_variable _drained;
+        EventQueue _queue;
+        uint64_t _numDropped;
+        bool _shutdown;
+
+        boost::thread _writer;  // Started last; must follow the state it uses.
+    };
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,164 @@
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "mongo/logger/async_message_appender.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+namespace {
+
+    /**
+     * Appender that records the messages it receives, and can optionally block
+     * inside append() until released, to simulate a slow sink.
+     */
+    class CapturingAppender : public Appender<MessageEventEphemeral> {
+    public:
+        CapturingAppender() : _blocked(false) {}
+
+        virtual Status append(const MessageEventEphemeral& event) {
+            boost::unique_lock<boost::mutex> lk(_mutex);
+            while (_blocked) {
+                _unblocked.wait(lk);
+            }
+            _messages.push_back(event.getMessage().toString());
+            return Status::OK();
+        }
+
+        void setBlocked(bool blocked) {
+            boost::lock_guard<boost::mutex> lk(_mutex);
+            _blocked = blocked;
+            if (!blocked) {
+                _unblocked.notify_all();
+            }
+        }
+
+        std::vector<std::string> messages() {
+            boost::lock_guard<boost::mutex> lk(_mutex);
+            return _messages;
+        }
+
+    private:
+        boost::mutex _mutex;
+        boost::condition_variable _unblocked;
+        bool _blocked;
+        std::vector<std::string> _messages;
+    };
+
+    /**
+     * Non-owning pass-through, since AsyncMessageAppender takes ownership of its
+     * target and the tests need to inspect the capture after the async appender
+     * is destroyed.
+     */
+    class ForwardingAppender : public Appender<MessageEventEphemeral> {
+    public:
+        explicit ForwardingAppender(Appender<MessageEventEphemeral>* target) : _target(target) {}
+        virtual Status append(const MessageEventEphemeral& event) {
+            return _target->append(event);
+        }
+    private:
+        Appender<MessageEventEphemeral>* _target;  // Not owned.
+    };
+
+    MessageEventEphemeral makeEvent(const std::string& message,
+                                    LogSeverity severity = LogSeverity::Log()) {
+        return MessageEventEphemeral(curTimeMillis64(), severity, "tst", message);
+    }
+
+    TEST(AsyncMessageAppender, DeliversEventsInOrder) {
+        CapturingAppender capture;
+        std::vector<std::string> expected;
+        {
+            AsyncMessageAppender async(new ForwardingAppender(&capture));
+            for (int i = 0; i < 100; i++) {
+                std::ostringstream oss;
+                oss << "message " << i;
+                expected.push_back(oss.str());
+                ASSERT_OK(async.append(makeEvent(expected.back())));
+            }
+            // Destruction drains the queue.
+        }
+        ASSERT_EQUALS(expected.size(), capture.messages().size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            ASSERT_EQUALS(expected[i], capture.messages()[i]);
+        }
+    }
+
+    TEST(AsyncMessageAppender, ErrorSeverityWaitsForDrain) {
+        CapturingAppender capture;
+        AsyncMessageAppender async(new ForwardingAppender(&capture));
+        for (int i = 0; i < 10; i++) {
+            ASSERT_OK(async.append(makeEvent("filler")));
+        }
+        ASSERT_OK(async.append(makeEvent("boom", LogSeverity::Error())));
+        // Everything queued before and including the error must have reached the
+        // target by the time append() returns.
+        ASSERT_EQUALS(11U, capture.messages().size());
+        ASSERT_EQUALS("boom", capture.messages().back());
+    }
+
+    TEST(AsyncMessageAppender, DropsAndReportsWhenQueueIsFull) {
+        CapturingAppender capture;
+        capture.setBlocked(true);
+        {
+            AsyncMessageAppender async(new ForwardingAppender(&capture), 2 /* maxQueueSize */);
+            for (int i = 0; i < 10; i++) {
+                ASSERT_OK(async.append(makeEvent("flood")));
+            }
+            capture.setBlocked(false);
+            // Destruction drains whatever was queued.
+        }
+        const std::vector<std::string> messages = capture.messages();
+        // At most one event in flight plus two queued could survive.
+        size_t delivered = 0;
+        size_t droppedReports = 0;
+        for (size_t i = 0; i < messages.size(); i++) {
+            if (messages[i] == "flood") {
+                delivered++;
+            }
+            else if (messages[i].find("dropped") != std::string::npos) {
+                droppedReports++;
+            }
+        }
+        ASSERT_LESS_THAN_OR_EQUALS(delivered, 3U);
+        ASSERT_EQUALS(1U, droppedReports);
+    }
+
+}  // namespace
+}  // namespace logger
+}  // namespace mongo
@@ -131,6 +131,19 @@ namespace mongo {
             return _value.fetch_add(increment);
         }
 
+        /**
+         * Get the current value of this, add "increment" and store it, atomically.
+         *
+         * Returns the value of this before incrementing.
+         *
+         * Has relaxed semantics: suitable only when the operation itself carries
+         * no publication obligations, e.g. acquiring an additional reference to
+         * data this thread can already safely access.
+         */
+        WordType fetchAndAddRelaxed(WordType increment) {
+            return _value.fetch_add(increment, std::memory_order_relaxed);
+        }
+
         /**
          * Get the current value of this, subtract "decrement" and store it, atomically.
          *
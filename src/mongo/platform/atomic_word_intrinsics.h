@@ -113,6 +113,19 @@ namespace mongo {
             return AtomicIntrinsics<WordType>::fetchAndAdd(&_value, increment);
         }
 
+        /**
+         * Get the current value of this, add "increment" and store it, atomically.
+         *
+         * Returns the value of this before incrementing.
+         *
+         * Requires only relaxed semantics; the intrinsics layer has no relaxed
+         * read-modify-write operations, so this falls back to the full-barrier
+         * fetchAndAdd.
+         */
+        WordType fetchAndAddRelaxed(WordType increment) {
+            return fetchAndAdd(increment);
+        }
+
         /**
          * Get the current value of this, subtract "decrement" and store it, atomically.
          *
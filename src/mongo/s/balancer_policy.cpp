@@ -33,6 +33,8 @@
 
 #include <algorithm>
 
+#include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/balancer_policy.h"
 #include "mongo/s/chunk.h"
 #include "mongo/s/config.h"
@@ -48,9 +50,123 @@ namespace mongo {
         return str::stream() << min << " -->> " << max << "  on  " << tag;
     }
 
+    // Which load measure the balancer equalizes across shards: "chunks" (the historical
+    // chunk-count policy), "dataSize" (shard-reported data size), or "ops" (shard-reported
+    // ops/s).
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(balancerLoadMetric, std::string, "chunks");
+
+    double ChunkCountMetric::shardLoad( const DistributionStatus& distribution,
+                                        const string& shard,
+                                        const string& tag ) const {
+        return distribution.numberOfChunksInShardWithTag( shard, tag );
+    }
+
+    double ChunkCountMetric::receiverLoad( const DistributionStatus& distribution,
+                                           const string& shard,
+                                           const string& tag ) const {
+        return distribution.numberOfChunksInShard( shard );
+    }
+
+    bool ChunkCountMetric::needsBalancing( double donorLoad,
+                                           double receiverLoad,
+                                           int chunkThreshold ) const {
+        return donorLoad - receiverLoad >= chunkThreshold;
+    }
+
+    namespace {
+
+        /**
+         * Shard-level stats are not broken down by tag, so approximate the per-tag share by
+         * scaling the shard total by the fraction of its chunks carrying the tag.
+         */
+        double tagFraction( const DistributionStatus& distribution,
+                            const string& shard,
+                            const string& tag ) {
+            const unsigned total = distribution.numberOfChunksInShard( shard );
+            if ( total == 0 )
+                return 0;
+            return static_cast<double>(
+                    distribution.numberOfChunksInShardWithTag( shard, tag ) ) / total;
+        }
+    }
+
+    double DataSizeMetric::shardLoad( const DistributionStatus& distribution,
+                                      const string& shard,
+                                      const string& tag ) const {
+        return distribution.shardInfo( shard ).getCurrSizeMB() *
+                tagFraction( distribution, shard, tag );
+    }
+
+    double DataSizeMetric::receiverLoad( const DistributionStatus& distribution,
+                                         const string& shard,
+                                         const string& tag ) const {
+        return distribution.shardInfo( shard ).getCurrSizeMB();
+    }
+
+    bool DataSizeMetric::needsBalancing( double donorLoad,
+                                         double receiverLoad,
+                                         int chunkThreshold ) const {
+        // move on a 4/3 skew, but never to chase less than roughly one chunk worth of data
+        return donorLoad > receiverLoad * 4 / 3 && donorLoad - receiverLoad >= 64;
+    }
+
+    double ShardOpsMetric::shardLoad( const DistributionStatus& distribution,
+                                      const string& shard,
+                                      const string& tag ) const {
+        return distribution.shardInfo( shard ).getOpsPerSec() *
+                tagFraction( distribution, shard, tag );
+    }
+
+    double ShardOpsMetric::receiverLoad( const DistributionStatus& distribution,
+                                         const string& shard,
+                                         const string& tag ) const {
+        return distribution.shardInfo( shard ).getOpsPerSec();
+    }
+
+    bool ShardOpsMetric::needsBalancing( double donorLoad,
+                                         double receiverLoad,
+                                         int chunkThreshold ) const {
+        // move on a 4/3 skew, but not for traffic too light to be worth a migration
+        return donorLoad > receiverLoad * 4 / 3 && donorLoad - receiverLoad >= 100;
+    }
+
+    namespace {
+        const ChunkCountMetric chunkCountMetric;
+        const DataSizeMetric dataSizeMetric;
+        const ShardOpsMetric shardOpsMetric;
+
+        const BalanceMetric* activeBalanceMetric = &chunkCountMetric;
+    }
+
+    MONGO_INITIALIZER_GENERAL(BalancerLoadMetric,
+                              ("EndStartupOptionHandling"),
+                              ("default"))(InitializerContext* context) {
+        if (balancerLoadMetric == "chunks") {
+            activeBalanceMetric = &chunkCountMetric;
+        }
+        else if (balancerLoadMetric == "dataSize") {
+            activeBalanceMetric = &dataSizeMetric;
+        }
+        else if (balancerLoadMetric == "ops") {
+            activeBalanceMetric = &shardOpsMetric;
+        }
+        else {
+            return Status(ErrorCodes::BadValue,
+                          "balancerLoadMetric must be one of 'chunks', 'dataSize' or 'ops'");
+        }
+        return Status::OK();
+    }
+
+    const BalanceMetric* defaultBalanceMetric() {
+        return activeBalanceMetric;
+    }
+
     DistributionStatus::DistributionStatus( const ShardInfoMap& shardInfo,
-                                            const ShardToChunksMap& shardToChunksMap )
-        : _shardInfo( shardInfo ), _shardChunks( shardToChunksMap ) {
+                                            const ShardToChunksMap& shardToChunksMap,
+                                            const BalanceMetric* metric )
+        : _shardInfo( shardInfo ),
+          _shardChunks( shardToChunksMap ),
+          _metric( metric ? metric : defaultBalanceMetric() ) {
 
         for ( ShardInfoMap::const_iterator i = _shardInfo.begin(); i != _shardInfo.end(); ++i ) {
             _shards.insert( i->first );
@@ -102,7 +218,7 @@ namespace mongo {
 
     string DistributionStatus::getBestReceieverShard( const string& tag ) const {
         string best;
-        unsigned minChunks = numeric_limits<unsigned>::max();
+        double minLoad = numeric_limits<double>::max();
 
         for ( ShardInfoMap::const_iterator i = _shardInfo.begin(); i != _shardInfo.end(); ++i ) {
             if ( i->second.isSizeMaxed() ) {
@@ -120,14 +236,14 @@ namespace mongo {
                 continue;
             }
 
-            unsigned myChunks = numberOfChunksInShard( i->first );
-            if ( myChunks >= minChunks ) {
-                LOG(1) << i->first << " has more chunks me:" << myChunks << " best: " << best << ":" << minChunks << endl;
+            double myLoad = _metric->receiverLoad( *this, i->first, tag );
+            if ( myLoad >= minLoad ) {
+                LOG(1) << i->first << " is more loaded me:" << myLoad << " best: " << best << ":" << minLoad << endl;
                 continue;
             }
 
             best = i->first;
-            minChunks = myChunks;
+            minLoad = myLoad;
         }
 
         return best;
@@ -135,15 +251,15 @@ namespace mongo {
 
     string DistributionStatus::getMostOverloadedShard( const string& tag ) const {
         string worst;
-        unsigned maxChunks = 0;
+        double maxLoad = 0;
 
         for ( ShardInfoMap::const_iterator i = _shardInfo.begin(); i != _shardInfo.end(); ++i ) {
-            unsigned myChunks = numberOfChunksInShardWithTag( i->first, tag );
-            if ( myChunks <= maxChunks )
+            double myLoad = _metric->shardLoad( *this, i->first, tag );
+            if ( myLoad <= maxLoad )
                 continue;
 
             worst = i->first;
-            maxChunks = myChunks;
+            maxLoad = myLoad;
         }
 
         return worst;
@@ -249,13 +365,21 @@ namespace mongo {
                                   errMsg);
                 }
 
+                // only pay for the extra serverStatus round trip when the configured
+                // metric actually balances on ops/s
+                long long opsPerSec = 0;
+                if (defaultBalanceMetric()->wantsShardOps()) {
+                    opsPerSec = Shard::getShardOpsPerSec(shard.getHost());
+                }
+
                 std::set<std::string> dummy;
                 ShardInfo newShardEntry(shard.getMaxSize(),
                                         Shard::getShardDataSizeBytes(shard.getHost()) /
                                             1024 / 1024,
                                         shard.getDraining(),
                                         dummy,
-                                        Shard::getShardMongoVersion(shard.getHost()));
+                                        Shard::getShardMongoVersion(shard.getHost()),
+                                        opsPerSec);
 
                 if (shard.isTagsSet()) {
                     BSONArrayIteratorSorted tagIter(shard.getTags());
@@ -484,16 +608,16 @@ namespace mongo {
                 return NULL;
             }
 
-            unsigned min = distribution.numberOfChunksInShardWithTag( to, tag );
-
-            const int imbalance = max - min;
+            const BalanceMetric& metric = distribution.metric();
+            const double donorLoad = metric.shardLoad( distribution, from, tag );
+            const double receiverLoad = metric.shardLoad( distribution, to, tag );
 
             LOG(1) << "collection : " << ns << endl;
-            LOG(1) << "donor      : " << from << " chunks on " << max << endl;
-            LOG(1) << "receiver   : " << to << " chunks on " << min << endl;
+            LOG(1) << "donor      : " << from << " load " << donorLoad << " chunks on " << max << endl;
+            LOG(1) << "receiver   : " << to << " load " << receiverLoad << endl;
             LOG(1) << "threshold  : " << threshold << endl;
 
-            if ( imbalance < threshold )
+            if ( ! metric.needsBalancing( donorLoad, receiverLoad, threshold ) )
                 continue;
 
             const vector<ChunkType *>& chunks = distribution.getChunks(from);
@@ -534,18 +658,21 @@ namespace mongo {
                          long long currSizeMB,
                          bool draining,
                          const set<string>& tags,
-                         const string& mongoVersion):
+                         const string& mongoVersion,
+                         long long opsPerSec):
         _maxSizeMB(maxSizeMB),
         _currSizeMB(currSizeMB),
         _draining(draining),
         _tags(tags),
-        _mongoVersion(mongoVersion) {
+        _mongoVersion(mongoVersion),
+        _opsPerSec(opsPerSec) {
     }
 
     ShardInfo::ShardInfo()
         : _maxSizeMB(0),
           _currSizeMB(0),
-          _draining(false) {
+          _draining(false),
+          _opsPerSec(0) {
     }
 
     void ShardInfo::addTag( const string& tag ) {
@@ -570,6 +697,7 @@ namespace mongo {
         StringBuilder ss;
         ss << " maxSizeMB: " << _maxSizeMB;
         ss << " currSizeMB: " << _currSizeMB;
+        ss << " opsPerSec: " << _opsPerSec;
         ss << " draining: " << _draining;
         if ( _tags.size() > 0 ) {
             ss << "tags : ";
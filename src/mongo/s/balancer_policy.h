@@ -70,6 +70,100 @@ namespace mongo {
         std::string toString() const;
     };
     
+    class DistributionStatus;
+
+    /**
+     * A pluggable measure of how loaded a shard is.  The balancer picks donor and receiver
+     * shards, and decides whether a migration is worthwhile, by equalizing this measure
+     * rather than raw chunk counts.  Implementations must be stateless; a single instance
+     * is shared by all balancing rounds.
+     */
+    class BalanceMetric {
+    public:
+        virtual ~BalanceMetric() {}
+
+        /**
+         * @return the load this metric attributes to 'shard' for chunks carrying 'tag',
+         *         used to pick the donor shard and to size up the imbalance
+         */
+        virtual double shardLoad( const DistributionStatus& distribution,
+                                  const std::string& shard,
+                                  const std::string& tag ) const = 0;
+
+        /**
+         * @return the load used when ranking candidate receiver shards
+         */
+        virtual double receiverLoad( const DistributionStatus& distribution,
+                                     const std::string& shard,
+                                     const std::string& tag ) const = 0;
+
+        /**
+         * @param chunkThreshold the chunk-count imbalance threshold the balancer computed
+         *        for this round, only meaningful to metrics that count chunks
+         * @return true if the gap between donor and receiver justifies a migration
+         */
+        virtual bool needsBalancing( double donorLoad,
+                                     double receiverLoad,
+                                     int chunkThreshold ) const = 0;
+
+        /** @return true if the metric needs ops/s collected from the shards */
+        virtual bool wantsShardOps() const { return false; }
+    };
+
+    /**
+     * The historical policy: balance on the number of chunks per shard.
+     */
+    class ChunkCountMetric : public BalanceMetric {
+    public:
+        virtual double shardLoad( const DistributionStatus& distribution,
+                                  const std::string& shard,
+                                  const std::string& tag ) const;
+        virtual double receiverLoad( const DistributionStatus& distribution,
+                                     const std::string& shard,
+                                     const std::string& tag ) const;
+        virtual bool needsBalancing( double donorLoad,
+                                     double receiverLoad,
+                                     int chunkThreshold ) const;
+    };
+
+    /**
+     * Balances on the data size each shard reports, so shards whose chunks are fatter
+     * than average shed data even when chunk counts look even.
+     */
+    class DataSizeMetric : public BalanceMetric {
+    public:
+        virtual double shardLoad( const DistributionStatus& distribution,
+                                  const std::string& shard,
+                                  const std::string& tag ) const;
+        virtual double receiverLoad( const DistributionStatus& distribution,
+                                     const std::string& shard,
+                                     const std::string& tag ) const;
+        virtual bool needsBalancing( double donorLoad,
+                                     double receiverLoad,
+                                     int chunkThreshold ) const;
+    };
+
+    /**
+     * Balances on the ops/s each shard reports, so hot chunks spread out even when both
+     * chunk counts and data sizes look even.
+     */
+    class ShardOpsMetric : public BalanceMetric {
+    public:
+        virtual double shardLoad( const DistributionStatus& distribution,
+                                  const std::string& shard,
+                                  const std::string& tag ) const;
+        virtual double receiverLoad( const DistributionStatus& distribution,
+                                     const std::string& shard,
+                                     const std::string& tag ) const;
+        virtual bool needsBalancing( double donorLoad,
+                                     double receiverLoad,
+                                     int chunkThreshold ) const;
+        virtual bool wantsShardOps() const { return true; }
+    };
+
+    /** @return the metric selected by the balancerLoadMetric startup parameter */
+    const BalanceMetric* defaultBalanceMetric();
+
     class ShardInfo {
     public:
         ShardInfo();
@@ -77,7 +171,8 @@ namespace mongo {
                   long long currSizeMB,
                   bool draining,
                   const std::set<std::string>& tags = std::set<std::string>(),
-                  const std::string& _mongoVersion = std::string(""));
+                  const std::string& _mongoVersion = std::string(""),
+                  long long opsPerSec = 0);
 
         void addTag( const std::string& tag );
 
@@ -101,16 +196,20 @@ namespace mongo {
 
         long long getCurrSizeMB() const { return _currSizeMB; }
 
+        /** @return ops/s the shard reported in the last stats sampling, 0 if not collected */
+        long long getOpsPerSec() const { return _opsPerSec; }
+
         std::string getMongoVersion() const { return _mongoVersion; }
 
         std::string toString() const;
-        
+
     private:
         long long _maxSizeMB;
         long long _currSizeMB;
         bool _draining;
         std::set<std::string> _tags;
         std::string _mongoVersion;
+        long long _opsPerSec;
     };
     
     struct MigrateInfo {
@@ -130,8 +229,13 @@ namespace mongo {
 
     class DistributionStatus : boost::noncopyable {
     public:
+        /**
+         * @param metric how to measure shard load, NULL for the metric selected by the
+         *        balancerLoadMetric startup parameter
+         */
         DistributionStatus( const ShardInfoMap& shardInfo,
-                            const ShardToChunksMap& shardToChunksMap );
+                            const ShardToChunksMap& shardToChunksMap,
+                            const BalanceMetric* metric = NULL );
 
         // only used when building
         
@@ -180,6 +284,9 @@ namespace mongo {
 
         /** @return the ShardInfo for the shard */
         const ShardInfo& shardInfo( const std::string& shard ) const;
+
+        /** @return the load metric this distribution is balanced with */
+        const BalanceMetric& metric() const { return *_metric; }
         
         /** writes all state to log() */
         void dump() const;
@@ -209,6 +316,7 @@ namespace mongo {
     private:
         const ShardInfoMap& _shardInfo;
         const ShardToChunksMap& _shardChunks;
+        const BalanceMetric* _metric;
         std::map<BSONObj,TagRange> _tagRanges;
         std::set<std::string> _allTags;
         std::set<std::string> _shards;
@@ -79,6 +79,69 @@ namespace mongo {
             ASSERT( c );
         }
 
+        TEST( BalancerPolicyTests , BalanceByOpsMetric ) {
+            // 1 chunk on each shard, so chunk counts are perfectly even, but one shard
+            // serves nearly all the traffic
+            OwnedShardToChunksMap chunkMap;
+            auto_ptr<OwnedPointerVector<ChunkType> > chunks(new OwnedPointerVector<ChunkType>());
+
+            auto_ptr<ChunkType> chunk(new ChunkType());
+            chunk->setMin(BSON("x" << BSON("$minKey" << 1)));
+            chunk->setMax(BSON("x" << 49));
+            chunks->push_back(chunk.release());
+
+            chunkMap.mutableMap()["shard0"] = chunks.release();
+
+            chunks.reset(new OwnedPointerVector<ChunkType>());
+            chunk.reset(new ChunkType());
+            chunk->setMin(BSON("x" << 49));
+            chunk->setMax(BSON("x" << BSON("$maxKey" << 1)));
+            chunks->push_back(chunk.release());
+
+            chunkMap.mutableMap()["shard1"] = chunks.release();
+
+            // ShardInfo(maxSize, currSize, draining, tags, version, opsPerSec)
+            ShardInfoMap info;
+            info["shard0"] = ShardInfo(0, 2, false, set<string>(), "", 2000);
+            info["shard1"] = ShardInfo(0, 2, false, set<string>(), "", 100);
+
+            ShardOpsMetric metric;
+            DistributionStatus status(info, chunkMap.map(), &metric);
+            scoped_ptr<MigrateInfo> c(BalancerPolicy::balance( "ns", status, 1 ));
+            ASSERT( c );
+            ASSERT_EQUALS( "shard0", c->from );
+            ASSERT_EQUALS( "shard1", c->to );
+        }
+
+        TEST( BalancerPolicyTests , OpsMetricEvenLoadMovesNothing ) {
+            OwnedShardToChunksMap chunkMap;
+            auto_ptr<OwnedPointerVector<ChunkType> > chunks(new OwnedPointerVector<ChunkType>());
+
+            auto_ptr<ChunkType> chunk(new ChunkType());
+            chunk->setMin(BSON("x" << BSON("$minKey" << 1)));
+            chunk->setMax(BSON("x" << 49));
+            chunks->push_back(chunk.release());
+
+            chunkMap.mutableMap()["shard0"] = chunks.release();
+
+            chunks.reset(new OwnedPointerVector<ChunkType>());
+            chunk.reset(new ChunkType());
+            chunk->setMin(BSON("x" << 49));
+            chunk->setMax(BSON("x" << BSON("$maxKey" << 1)));
+            chunks->push_back(chunk.release());
+
+            chunkMap.mutableMap()["shard1"] = chunks.release();
+
+            ShardInfoMap info;
+            info["shard0"] = ShardInfo(0, 2, false, set<string>(), "", 1000);
+            info["shard1"] = ShardInfo(0, 2, false, set<string>(), "", 1000);
+
+            ShardOpsMetric metric;
+            DistributionStatus status(info, chunkMap.map(), &metric);
+            scoped_ptr<MigrateInfo> c(BalancerPolicy::balance( "ns", status, 1 ));
+            ASSERT( ! c );
+        }
+
 
         TEST( BalancerPolicyTests , BalanceJumbo  ) {
             // 2 chunks and 0 chunk shards
@@ -945,7 +945,10 @@ namespace mongo {
 
                 c->setBytesWritten( oldC->getBytesWritten() );
 
-                chunkMap.insert( make_pair( oldC->getMax(), c ) );
+                // The old map is already sorted, so hint each insert to the end - that's an
+                // amortized constant-time insert, versus a shard key comparison per tree level
+                // for every chunk when the collection has a large routing table.
+                chunkMap.insert( chunkMap.end(), make_pair( oldC->getMax(), c ) );
             }
 
             LOG(2) << "loading chunk manager for collection " << _ns
@@ -1287,7 +1290,8 @@ namespace mongo {
         QueryPlannerParams plannerParams;
         // Must use "shard key" index
         plannerParams.options = QueryPlannerParams::NO_TABLE_SCAN;
-        IndexEntry indexEntry(key, accessMethod, false /* multiKey */, false /* sparse */, "shardkey", BSONObj());
+        IndexEntry indexEntry(key, accessMethod, false /* multiKey */, false /* sparse */,
+                              "shardkey", NULL /* filterExpr */, BSONObj());
         plannerParams.indices.push_back(indexEntry);
 
         OwnedPointerVector<QuerySolution> solutions;
@@ -1569,7 +1573,8 @@ namespace mongo {
                 ++begin;
 
             shared_ptr<ChunkRange> cr (new ChunkRange(first, begin));
-            _ranges[cr->getMax()] = cr;
+            // Ranges are built in ascending max-key order, so hint the insert to the end
+            _ranges.insert(_ranges.end(), make_pair(cr->getMax(), cr));
         }
     }
 
@@ -75,6 +75,7 @@ namespace mongo {
 
         // Get either the chunk manager or primary shard
         config->getChunkManagerOrPrimary( _nss.ns(), _manager, _primary );
+        _recentChunks.clear();
 
         return Status::OK();
     }
@@ -384,12 +385,36 @@ namespace mongo {
         return Status::OK();
     }
 
+    namespace {
+        // Number of recently targeted chunks remembered per targeter, see _recentChunks
+        const size_t kMaxRecentChunks = 4;
+    }
+
     Status ChunkManagerTargeter::targetShardKey(const BSONObj& shardKey,
                                                 long long estDataSize,
                                                 ShardEndpoint** endpoint) const {
         invariant(NULL != _manager);
 
-        ChunkPtr chunk = _manager->findIntersectingChunk(shardKey);
+        // Check the recently targeted chunks before doing a full chunk map lookup
+        ChunkPtr chunk;
+        for (size_t i = 0; i < _recentChunks.size(); ++i) {
+            if (_recentChunks[i]->containsKey(shardKey)) {
+                chunk = _recentChunks[i];
+                if (i > 0) {
+                    // Move to the front of the MRU list
+                    _recentChunks.erase(_recentChunks.begin() + i);
+                    _recentChunks.insert(_recentChunks.begin(), chunk);
+                }
+                break;
+            }
+        }
+
+        if (!chunk) {
+            chunk = _manager->findIntersectingChunk(shardKey);
+            _recentChunks.insert(_recentChunks.begin(), chunk);
+            if (_recentChunks.size() > kMaxRecentChunks)
+                _recentChunks.pop_back();
+        }
 
         // Track autosplit stats for sharded collections
         // Note: this is only best effort accounting and is not accurate.
@@ -673,6 +698,7 @@ namespace mongo {
 
         // Get either the chunk manager or primary shard
         config->getChunkManagerOrPrimary( _nss.ns(), _manager, _primary );
+        _recentChunks.clear();
 
         // We now have the latest metadata from the cache.
 
@@ -768,6 +794,7 @@ namespace mongo {
                 return Status( ErrorCodes::UnknownError, ex.toString() );
             }
             config->getChunkManagerOrPrimary( _nss.ns(), _manager, _primary );
+            _recentChunks.clear();
         }
         else if ( refreshType == RefreshType_ReloadDatabase ) {
             try {
@@ -780,6 +807,7 @@ namespace mongo {
                 return Status( ErrorCodes::UnknownError, ex.toString() );
             }
             config->getChunkManagerOrPrimary( _nss.ns(), _manager, _primary );
+            _recentChunks.clear();
         }
 
         return Status::OK();
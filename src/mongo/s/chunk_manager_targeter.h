@@ -30,6 +30,7 @@
 
 #include <boost/scoped_ptr.hpp>
 #include <map>
+#include <vector>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/namespace_string.h"
@@ -151,6 +152,11 @@ namespace mongo {
         typedef std::map<std::string, ChunkVersion> ShardVersionMap;
         ShardVersionMap _remoteShardVersions;
 
+        // Small MRU cache of recently targeted chunks, most-recent first.  Insert batches
+        // often hit the same chunk many times in a row, so checking here avoids a full
+        // chunk map lookup per document.  Invalidated whenever the metadata is reloaded.
+        mutable std::vector<ChunkPtr> _recentChunks;
+
         // Stores whether we need to check the remote server on refresh
         bool _needsTargetingRefresh;
 
@@ -116,6 +116,11 @@ namespace mongo {
         return info;
     }
 
+    void ClientInfo::destroy() {
+        // thread_specific_ptr::reset() deletes the previous value
+        _tlInfo.reset( NULL );
+    }
+
     ClientInfo * ClientInfo::get(AbstractMessagingPort* messagingPort) {
         ClientInfo * info = _tlInfo.get();
         if (!info) {
@@ -129,6 +129,9 @@ namespace mongo {
         static ClientInfo * get(AbstractMessagingPort* messagingPort = NULL);
         // Creates a ClientInfo and stores it in _tlInfo
         static ClientInfo* create(AbstractMessagingPort* messagingPort);
+        // Deletes this thread's ClientInfo, if any, so the thread can be reused for
+        // another connection
+        static void destroy();
 
     private:
 
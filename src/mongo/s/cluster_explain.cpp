@@ -239,7 +239,12 @@ namespace mongo {
         long long keysExamined = 0;
         long long docsExamined = 0;
         long long totalChildMillis = 0;
+        long long maxRoundTripMicros = -1;
         for (size_t i = 0; i < shardResults.size(); i++) {
+            if (shardResults[i].roundTripMicros > maxRoundTripMicros) {
+                maxRoundTripMicros = shardResults[i].roundTripMicros;
+            }
+
             BSONObj execStats = shardResults[i].result["executionStats"].Obj();
             if (execStats.hasField("nReturned")) {
                 nReturned += execStats["nReturned"].numberLong();
@@ -273,6 +278,14 @@ namespace mongo {
         executionStatsBob.appendNumber("totalDocsExamined", docsExamined);
         executionStagesBob.append("totalChildMillis", totalChildMillis);
 
+        // The shards run in parallel, so the merge cost at mongos is roughly the total
+        // elapsed time minus the slowest shard's round trip.
+        if (maxRoundTripMicros >= 0) {
+            long long mongosMergeMillis = millisElapsed - (maxRoundTripMicros / 1000);
+            executionStagesBob.appendNumber("mongosMergeMillis",
+                                            mongosMergeMillis > 0 ? mongosMergeMillis : 0);
+        }
+
         BSONArrayBuilder execShardsBuilder(executionStagesBob.subarrayStart("shards"));
         for (size_t i = 0; i < shardResults.size(); i++) {
             BSONObjBuilder singleShardBob(execShardsBuilder.subobjStart());
@@ -282,6 +295,21 @@ namespace mongo {
 
             singleShardBob.append("shardName", shardResults[i].shardTarget.getName());
 
+            // Attribute mongos-observed latency for this shard.  The round trip covers
+            // network transit plus any queueing at the shard before execution started;
+            // subtracting the shard's own execution time isolates that overhead.
+            if (shardResults[i].roundTripMicros >= 0) {
+                long long roundTripMillis = shardResults[i].roundTripMicros / 1000;
+                singleShardBob.appendNumber("roundTripMillis", roundTripMillis);
+                if (execStats.hasField("executionTimeMillis")) {
+                    long long networkAndQueueMillis =
+                        roundTripMillis - execStats["executionTimeMillis"].numberLong();
+                    singleShardBob.appendNumber("networkAndQueueMillis",
+                                                networkAndQueueMillis > 0 ?
+                                                    networkAndQueueMillis : 0);
+                }
+            }
+
             // Append error-related fields, if present.
             if (!execStats["executionSuccess"].eoo()) {
                 singleShardBob.append(execStats["executionSuccess"]);
@@ -361,10 +361,13 @@ namespace mongo {
         BSONObj key;
         ChunkVersion oldVersion;
         ChunkManagerPtr oldManager;
+        unsigned long long startingRefreshGeneration;
 
         {
             scoped_lock lk( _lock );
-            
+
+            startingRefreshGeneration = _refreshGenerations[ns];
+
             bool earlyReload = ! _collections[ns].isSharded() && ( shouldReload || forceReload );
             if ( earlyReload ) {
                 // this is to catch cases where there this is a new sharded collection
@@ -420,7 +423,23 @@ namespace mongo {
 
         {
             scoped_lock lll ( _hitConfigServerLock );
-            
+
+            {
+                // If another thread finished refreshing this collection while we were
+                // waiting for the config server lock, its snapshot is already newer than
+                // the version we saw go stale - retry against it instead of hitting the
+                // config servers again.  This collapses stale-config storms into a
+                // single reload.
+                scoped_lock lk( _lock );
+                CollectionInfo& ci = _collections[ns];
+                if ( _refreshGenerations[ns] != startingRefreshGeneration &&
+                     ci.isSharded() && ci.getCM() ) {
+                    LOG(1) << "skipping chunk manager reload for collection '" << ns
+                           << "', already refreshed by another thread" << endl;
+                    return ci.getCM();
+                }
+            }
+
             if ( ! newest.isEmpty() && ! forceReload ) {
                 // if we have a target we're going for
                 // see if we've hit already
@@ -451,12 +470,18 @@ namespace mongo {
             if ( temp->numChunks() == 0 ) {
                 // maybe we're not sharded any more
                 reload(); // this is a full reload
+                {
+                    scoped_lock lk( _lock );
+                    _refreshGenerations[ns]++;
+                }
                 return getChunkManager( ns , false );
             }
         }
 
         scoped_lock lk( _lock );
-        
+
+        _refreshGenerations[ns]++;
+
         CollectionInfo& ci = _collections[ns];
         uassert( 14822 ,  (string)"state changed in the middle: " + ns , ci.isSharded() );
 
@@ -210,6 +210,12 @@ namespace mongo {
 
         Collections _collections;
 
+        // Incremented each time a chunk manager refresh for a collection completes.  Lets
+        // threads queued behind _hitConfigServerLock detect that another thread already
+        // refreshed the collection after they observed it stale, so a storm of stale
+        // requests results in a single config server load.  Guarded by _lock.
+        std::map<std::string,unsigned long long> _refreshGenerations;
+
         mutable mongo::mutex _lock; // TODO: change to r/w lock ??
         mutable mongo::mutex _hitConfigServerLock;
     };
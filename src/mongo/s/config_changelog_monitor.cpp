@@ -0,0 +1,168 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/config_changelog_monitor.h"
+
+#include <set>
+
+#include "mongo/base/init.h"
+#include "mongo/client/connpool.h"
+#include "mongo/client/dbclientcursor.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/config.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/type_changelog.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+    // Seconds between polls of config.changelog for metadata events.  0 disables the
+    // monitor entirely.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(configChangelogPollSecs, int, 10);
+
+    MONGO_INITIALIZER_GENERAL(ConfigChangelogPollSecsBounds,
+                              ("EndStartupOptionHandling"),
+                              ("default"))(InitializerContext* context) {
+        if (configChangelogPollSecs < 0 || configChangelogPollSecs > 3600) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "configChangelogPollSecs must be between 0 and 3600"
+                                        << " but was set to " << configChangelogPollSecs);
+        }
+        return Status::OK();
+    }
+
+    ConfigChangelogMonitor configChangelogMonitor;
+
+    ConfigChangelogMonitor::ConfigChangelogMonitor() : _lastSeenTime(0) {
+    }
+
+    ConfigChangelogMonitor::~ConfigChangelogMonitor() {
+    }
+
+    void ConfigChangelogMonitor::run() {
+
+        // Entries older than our startup either predate this mongos or get picked up
+        // lazily when the namespace is first loaded.
+        _lastSeenTime = jsTime();
+
+        while ( ! inShutdown() ) {
+
+            if ( configChangelogPollSecs < 1 ) {
+                // Disabled - don't busy loop, but keep checking in case of shutdown
+                sleepsecs( 10 );
+                continue;
+            }
+
+            sleepsecs( configChangelogPollSecs );
+
+            try {
+                _pollChangelog();
+            }
+            catch ( const DBException& e ) {
+                warning() << "could not poll config changelog" << causedBy( e ) << endl;
+            }
+            catch ( const std::exception& e ) {
+                warning() << "could not poll config changelog" << causedBy( e ) << endl;
+            }
+        }
+    }
+
+    void ConfigChangelogMonitor::_pollChangelog() {
+
+        set<string> changedDBs;
+        set<string> changedColls;
+        Date_t maxTime = _lastSeenTime;
+
+        ScopedDbConnection conn(configServer.getPrimary().getConnString(), 30.0);
+
+        auto_ptr<DBClientCursor> cursor =
+            conn->query(ChangelogType::ConfigNS,
+                        Query(BSON(ChangelogType::time() << GT << _lastSeenTime))
+                            .sort(ChangelogType::time()));
+
+        while ( cursor->more() ) {
+            BSONObj entry = cursor->nextSafe();
+
+            Date_t entryTime = entry[ChangelogType::time()].Date();
+            if ( entryTime > maxTime ) maxTime = entryTime;
+
+            string ns = entry[ChangelogType::ns()].str();
+            if ( ns.empty() ) continue;
+
+            string what = entry[ChangelogType::what()].str();
+
+            if ( nsToCollectionSubstring( ns ).empty() ) {
+                // Database-level event, e.g. dropDatabase or movePrimary
+                changedDBs.insert( ns );
+            }
+            else if ( str::startsWith( what, "drop" ) ) {
+                // A refresh of a dropped collection can't succeed, reload the db info
+                changedDBs.insert( nsToDatabase( ns ) );
+            }
+            else {
+                changedColls.insert( ns );
+            }
+        }
+
+        conn.done();
+
+        _lastSeenTime = maxTime;
+
+        for ( set<string>::const_iterator it = changedDBs.begin();
+              it != changedDBs.end(); ++it ) {
+
+            // Only refresh what we already have cached - everything else loads lazily
+            DBConfigPtr conf = grid.getDBConfig( *it, false );
+            if ( ! conf ) continue;
+
+            LOG(1) << "config changelog: reloading database " << *it << endl;
+            conf->reload();
+        }
+
+        for ( set<string>::const_iterator it = changedColls.begin();
+              it != changedColls.end(); ++it ) {
+
+            const string db = nsToDatabase( *it );
+            if ( changedDBs.count( db ) ) continue;
+
+            DBConfigPtr conf = grid.getDBConfig( db, false );
+            if ( ! conf ) continue;
+
+            LOG(1) << "config changelog: refreshing chunk manager for " << *it << endl;
+            conf->getChunkManagerIfExists( *it, true );
+        }
+    }
+
+} // namespace mongo
@@ -40,11 +40,13 @@
 
 #include <algorithm>
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/thread/thread.hpp>
 #include <map>
 #include <string>
 #include <vector>
 
+#include "mongo/base/init.h"
 #include "mongo/client/connpool.h"
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/db/auth/action_set.h"
@@ -69,6 +71,7 @@
 #include "mongo/db/range_deleter_service.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/repl_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/logger/ramlog.h"
@@ -80,6 +83,7 @@
 #include "mongo/s/shard.h"
 #include "mongo/s/type_chunk.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/compress.h"
 #include "mongo/util/elapsed_tracker.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
@@ -131,6 +135,20 @@ namespace mongo {
 
     Tee* migrateLog = RamLog::get("migrate");
 
+    // Number of parallel streams the recipient shard uses to copy documents from the donor
+    // during the initial bulk clone step of a migration.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(migrateCloneStreams, int, 2);
+
+    MONGO_INITIALIZER_GENERAL(MigrateCloneStreamsBounds,
+                              ("EndStartupOptionHandling"),
+                              ("default"))(InitializerContext* context) {
+        if (migrateCloneStreams < 1 || migrateCloneStreams > 16) {
+            return Status(ErrorCodes::BadValue,
+                          "migrateCloneStreams must be between 1 and 16");
+        }
+        return Status::OK();
+    }
+
     class MoveTimingHelper {
     public:
         MoveTimingHelper(OperationContext* txn,
@@ -592,7 +610,13 @@ namespace mongo {
             return true;
         }
 
-        bool clone(OperationContext* txn, string& errmsg , BSONObjBuilder& result ) {
+        /**
+         * Fills "result" with the next batch of documents to clone.  If "compress" is true the
+         * batch is returned snappy-compressed in an "objectsCompressed" BinData field instead of
+         * the plain "objects" array; the recipient asks for this when it knows how to decompress,
+         * so mixed-version migrations keep working.
+         */
+        bool clone(OperationContext* txn, string& errmsg, BSONObjBuilder& result, bool compress) {
             ElapsedTracker tracker(internalQueryExecYieldIterations,
                                    internalQueryExecYieldPeriodMS);
 
@@ -671,7 +695,21 @@ namespace mongo {
                 }
             }
 
-            result.appendArray("objects", clonedDocsArrayBuilder.arr());
+            if (compress) {
+                // Bulk clone batches are highly compressible BSON; one compress call per batch
+                // keeps the wire cost down on bandwidth-limited links without any extra
+                // per-document buffering.
+                const BSONArray arr = clonedDocsArrayBuilder.arr();
+                std::string compressed;
+                mongo::compress(arr.objdata(), arr.objsize(), &compressed);
+                result.appendBinData("objectsCompressed",
+                                     compressed.size(),
+                                     BinDataGeneral,
+                                     compressed.data());
+            }
+            else {
+                result.appendArray("objects", clonedDocsArrayBuilder.arr());
+            }
             return true;
         }
 
@@ -897,7 +935,7 @@ namespace mongo {
             out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
         }
         bool run(OperationContext* txn, const string& , BSONObj& cmdObj, int, string& errmsg, BSONObjBuilder& result, bool) {
-            return migrateFromStatus.clone(txn, errmsg, result);
+            return migrateFromStatus.clone(txn, errmsg, result, cmdObj["compress"].trueValue());
         }
     } initialCloneCommand;
 
@@ -2062,84 +2100,42 @@ namespace mongo {
                 // 3. initial bulk clone
                 setState(CLONE);
 
-                while ( true ) {
-                    BSONObj res;
-                    if ( ! conn->runCommand( "admin" , BSON( "_migrateClone" << 1 ) , res ) ) {  // gets array of objects to copy, in disk order
-                        setState(FAIL);
-                        errmsg = "_migrateClone failed: ";
-                        errmsg += res.toString();
-                        error() << errmsg << migrateLog;
-                        conn.done();
-                        return;
-                    }
-
-                    BSONObj arr = res["objects"].Obj();
-                    int thisTime = 0;
-
-                    BSONObjIterator i( arr );
-                    while( i.more() ) {
-                        txn->checkForInterrupt();
-
-                        if ( getState() == ABORT ) {
-                            errmsg = str::stream() << "Migration abort requested while "
-                                                   << "copying documents";
-                            error() << errmsg << migrateLog;
-                            return;
-                        }
-
-                        BSONObj docToClone = i.next().Obj();
-                        {
-                            Client::WriteContext cx(txn, ns );
-
-                            BSONObj localDoc;
-                            if (willOverrideLocalId(txn,
-                                                    ns,
-                                                    min,
-                                                    max,
-                                                    shardKeyPattern,
-                                                    cx.ctx().db(),
-                                                    docToClone,
-                                                    &localDoc)) {
-                                string errMsg =
-                                    str::stream() << "cannot migrate chunk, local document "
-                                    << localDoc
-                                    << " has same _id as cloned "
-                                    << "remote document " << docToClone;
-
-                                warning() << errMsg << endl;
-
-                                // Exception will abort migration cleanly
-                                uasserted( 16976, errMsg );
-                            }
-
-                            Helpers::upsert( txn, ns, docToClone, true );
-                        }
-                        thisTime++;
-
-                        {
-                            scoped_lock statsLock(_mutex);
-                            _numCloned++;
-                            _clonedBytes += docToClone.objsize();
-                        }
+                // The donor hands each _migrateClone request a batch that no other request
+                // will see, so several streams can pull in parallel without explicit range
+                // partitioning; the extra streams overlap the network round trips with the
+                // local inserts.
+                std::vector<boost::shared_ptr<boost::thread> > streams;
+                for ( int i = 0; i < migrateCloneStreams; i++ ) {
+                    streams.push_back(boost::shared_ptr<boost::thread>(
+                            new boost::thread(&MigrateStatus::_cloneOneStream,
+                                              this,
+                                              ns,
+                                              min,
+                                              max,
+                                              shardKeyPattern,
+                                              fromShard,
+                                              writeConcern)));
+                }
+
+                for ( size_t i = 0; i < streams.size(); i++ ) {
+                    streams[i]->join();
+                }
+
+                if ( getState() == ABORT ) {
+                    errmsg = str::stream() << "Migration abort requested while "
+                                           << "copying documents";
+                    error() << errmsg << migrateLog;
+                    return;
+                }
 
-                        if (writeConcern.shouldWaitForOtherNodes() && thisTime > 0) {
-                            repl::ReplicationCoordinator::StatusAndDuration replStatus =
-                                    repl::getGlobalReplicationCoordinator()->awaitReplication(
-                                            txn,
-                                            txn->getClient()->getLastOp(),
-                                            writeConcern);
-                            if (replStatus.status.code() == ErrorCodes::ExceededTimeLimit) {
-                                warning() << "secondaryThrottle on, but doc insert timed out; "
-                                             "continuing";
-                            }
-                            else {
-                                massertStatusOK(replStatus.status);
-                            }
-                        }
+                if ( getState() == FAIL ) {
+                    // the failing stream already logged and recorded the error
+                    {
+                        scoped_lock sl(_mutex);
+                        errmsg = _errmsg;
                     }
-
-                    if ( thisTime == 0 )
-                        break;
+                    conn.done();
+                    return;
                 }
 
                 timing.done(3);
@@ -2288,6 +2284,147 @@ namespace mongo {
             conn.done();
         }
 
+        /**
+         * Copies documents from the donor shard until the donor reports that none are left
+         * for the range being migrated.  Several of these run in parallel during the CLONE
+         * step; the donor serves each _migrateClone request a disjoint batch, so the streams
+         * never clone the same document twice.  On failure, marks the migration FAIL so the
+         * sibling streams and the main migrate thread stop.
+         */
+        void _cloneOneStream(std::string ns,
+                             BSONObj min,
+                             BSONObj max,
+                             BSONObj shardKeyPattern,
+                             std::string fromShard,
+                             WriteConcernOptions writeConcern) {
+            Client::initThread( "migrateCloneStream" );
+            OperationContextImpl txn;
+            if (getGlobalAuthorizationManager()->isAuthEnabled()) {
+                ShardedConnectionInfo::addHook();
+                txn.getClient()->getAuthorizationSession()->grantInternalAuthorization();
+            }
+
+            try {
+                ScopedDbConnection conn(fromShard);
+
+                while ( getState() == CLONE ) {
+                    BSONObj res;
+                    // ask for a compressed batch; older donors ignore the flag and reply with
+                    // the plain "objects" array
+                    if ( ! conn->runCommand( "admin" ,
+                                             BSON( "_migrateClone" << 1 << "compress" << true ) ,
+                                             res ) ) {  // gets array of objects to copy, in disk order
+                        uasserted( 28643, str::stream() << "_migrateClone failed: "
+                                                        << res.toString() );
+                    }
+
+                    std::string decompressed;
+                    BSONObj arr;
+                    if (res.hasField("objectsCompressed")) {
+                        int compressedLen = 0;
+                        const char* compressedData =
+                            res["objectsCompressed"].binData(compressedLen);
+                        uassert(28642,
+                                "_migrateClone returned a corrupt compressed batch",
+                                mongo::uncompress(compressedData, compressedLen, &decompressed));
+                        // points into 'decompressed', which outlives the iteration below
+                        arr = BSONObj(decompressed.data());
+                    }
+                    else {
+                        arr = res["objects"].Obj();
+                    }
+                    int thisTime = 0;
+
+                    BSONObjIterator i( arr );
+                    while( i.more() ) {
+                        txn.checkForInterrupt();
+
+                        // stop if the migration was aborted or a sibling stream failed
+                        if ( getState() != CLONE ) {
+                            conn.done();
+                            cc().shutdown();
+                            return;
+                        }
+
+                        BSONObj docToClone = i.next().Obj();
+                        {
+                            Client::WriteContext cx(&txn, ns );
+
+                            BSONObj localDoc;
+                            if (willOverrideLocalId(&txn,
+                                                    ns,
+                                                    min,
+                                                    max,
+                                                    shardKeyPattern,
+                                                    cx.ctx().db(),
+                                                    docToClone,
+                                                    &localDoc)) {
+                                string errMsg =
+                                    str::stream() << "cannot migrate chunk, local document "
+                                    << localDoc
+                                    << " has same _id as cloned "
+                                    << "remote document " << docToClone;
+
+                                warning() << errMsg << endl;
+
+                                // Exception will abort migration cleanly
+                                uasserted( 16976, errMsg );
+                            }
+
+                            Helpers::upsert( &txn, ns, docToClone, true );
+                        }
+                        thisTime++;
+
+                        {
+                            scoped_lock statsLock(_mutex);
+                            _numCloned++;
+                            _clonedBytes += docToClone.objsize();
+                        }
+
+                        if (writeConcern.shouldWaitForOtherNodes() && thisTime > 0) {
+                            repl::ReplicationCoordinator::StatusAndDuration replStatus =
+                                    repl::getGlobalReplicationCoordinator()->awaitReplication(
+                                            &txn,
+                                            txn.getClient()->getLastOp(),
+                                            writeConcern);
+                            if (replStatus.status.code() == ErrorCodes::ExceededTimeLimit) {
+                                warning() << "secondaryThrottle on, but doc insert timed out; "
+                                             "continuing";
+                            }
+                            else {
+                                massertStatusOK(replStatus.status);
+                            }
+                        }
+                    }
+
+                    if ( thisTime == 0 )
+                        break;
+                }
+
+                conn.done();
+            }
+            catch ( const DBException& e ) {
+                error() << "migrate clone stream failed: " << e.what() << migrateLog;
+
+                scoped_lock sl(_mutex);
+                if (_state != ABORT) {
+                    _state = FAIL;
+                    _errmsg = e.toString();
+                }
+            }
+            catch ( const std::exception& e ) {
+                error() << "migrate clone stream failed: " << e.what() << migrateLog;
+
+                scoped_lock sl(_mutex);
+                if (_state != ABORT) {
+                    _state = FAIL;
+                    _errmsg = e.what();
+                }
+            }
+
+            cc().shutdown();
+        }
+
         void status(BSONObjBuilder& b) {
             scoped_lock sl(_mutex);
 
@@ -29,6 +29,7 @@
 #include "mongo/s/dbclient_multi_command.h"
 
 #include <boost/scoped_ptr.hpp>
+#include <vector>
 
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/audit.h"
@@ -39,6 +40,7 @@
 #include "mongo/s/write_ops/batched_command_request.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/socket_poll.h"
 
 namespace mongo {
 
@@ -169,10 +171,54 @@ namespace mongo {
         return static_cast<int>( _pendingCommands.size() );
     }
 
+    DBClientMultiCommand::PendingQueue::iterator DBClientMultiCommand::_chooseNextRecv() {
+        dassert( !_pendingCommands.empty() );
+
+        std::vector<pollfd> pollInfo;
+        std::vector<PendingQueue::iterator> pollable;
+        for ( PendingQueue::iterator it = _pendingCommands.begin();
+            it != _pendingCommands.end(); ++it ) {
+
+            PendingCommand* command = *it;
+
+            // Failed sends have nothing to wait for
+            if ( !command->status.isOK() || NULL == command->conn ) return it;
+
+            DBClientConnection* conn = dynamic_cast<DBClientConnection*>( command->conn );
+            if ( NULL == conn ) continue;
+
+            pollfd info;
+            info.fd = conn->port().psock->rawFD();
+            info.events = POLLIN;
+            info.revents = 0;
+            pollInfo.push_back( info );
+            pollable.push_back( it );
+        }
+
+        if ( !isPollSupported() || pollInfo.empty() ) return _pendingCommands.begin();
+
+        // Wait for the first response to arrive, not for the response to the first command
+        // sent - processing results in arrival order means one slow shard doesn't hold up
+        // bookkeeping for shards that have already answered.
+        const int timeout = _timeoutMillis > 0 ? _timeoutMillis : -1;
+        const int nEvents = socketPoll( &pollInfo[0], pollInfo.size(), timeout );
+        if ( nEvents <= 0 ) {
+            // Timed out or poll failed; fall through to a blocking recv on the oldest
+            // command, which will surface whatever the problem is.
+            return _pendingCommands.begin();
+        }
+
+        for ( size_t i = 0; i < pollInfo.size(); ++i ) {
+            if ( pollInfo[i].revents != 0 ) return pollable[i];
+        }
+        return _pendingCommands.begin();
+    }
+
     Status DBClientMultiCommand::recvAny( ConnectionString* endpoint, BSONSerializable* response ) {
 
-        scoped_ptr<PendingCommand> command( _pendingCommands.front() );
-        _pendingCommands.pop_front();
+        const PendingQueue::iterator nextIt = _chooseNextRecv();
+        scoped_ptr<PendingCommand> command( *nextIt );
+        _pendingCommands.erase( nextIt );
 
         *endpoint = command->endpoint;
         if ( !command->status.isOK() ) return command->status;
@@ -82,6 +82,13 @@ namespace mongo {
         };
 
         typedef std::deque<PendingCommand*> PendingQueue;
+
+        /**
+         * Chooses the next pending command to receive a response for - the first command
+         * whose response has already arrived, rather than the first command sent.
+         */
+        PendingQueue::iterator _chooseNextRecv();
+
         PendingQueue _pendingCommands;
         int _timeoutMillis;
     };
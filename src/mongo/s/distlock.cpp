@@ -34,6 +34,7 @@
 #include <boost/scoped_ptr.hpp>
 #include <boost/thread/thread.hpp>
 
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/server_options.h"
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/s/type_locks.h"
@@ -139,21 +140,30 @@ namespace mongo {
 
                     lastPingTime = pingTime;
 
-                    // refresh the entry corresponding to this process in the lockpings collection
-                    conn->update( LockpingsType::ConfigNS,
-                                  BSON( LockpingsType::process(process) ),
-                                  BSON( "$set" << BSON( LockpingsType::ping(pingTime) ) ),
-                                  true );
-
-                    string err = conn->getLastError();
-                    if ( ! err.empty() ) {
-                        warning() << "pinging failed for distributed lock pinger '" << pingId << "'."
-                                  << causedBy( err ) << endl;
-                        conn.done();
-
-                        // Sleep for normal ping time
-                        sleepmillis(sleepTime);
-                        continue;
+                    // A lock acquisition may have piggybacked a ping renewal on this
+                    // cluster recently, in which case another write here is redundant.
+                    if ( pingRenewedSince( pingId, Date_t( pingTime.millis - sleepTime ) ) ) {
+                        LOG( DistributedLock::logLvl + 1 ) << "distributed lock pinger '" << pingId
+                                << "' skipping ping write, renewed by a recent lock acquisition"
+                                << endl;
+                    }
+                    else {
+                        // refresh the entry corresponding to this process in the lockpings collection
+                        conn->update( LockpingsType::ConfigNS,
+                                      BSON( LockpingsType::process(process) ),
+                                      BSON( "$set" << BSON( LockpingsType::ping(pingTime) ) ),
+                                      true );
+
+                        string err = conn->getLastError();
+                        if ( ! err.empty() ) {
+                            warning() << "pinging failed for distributed lock pinger '" << pingId << "'."
+                                      << causedBy( err ) << endl;
+                            conn.done();
+
+                            // Sleep for normal ping time
+                            sleepmillis(sleepTime);
+                            continue;
+                        }
                     }
 
                     // Remove really old entries from the lockpings collection if they're not
@@ -189,7 +199,7 @@ namespace mongo {
                     conn->remove( LockpingsType::ConfigNS,
                                   BSON( LockpingsType::process() << NIN << pids <<
                                         LockpingsType::ping() << LT << fourDays ) );
-                    err = conn->getLastError();
+                    string err = conn->getLastError();
                     if ( ! err.empty() ) {
                         warning() << "ping cleanup for distributed lock pinger '" << pingId << " failed."
                                   << causedBy( err ) << endl;
@@ -311,6 +321,21 @@ namespace mongo {
             return s;
         }
 
+        /**
+         * Records that a lock acquisition refreshed this process' ping document, so the
+         * pinger thread can skip its next scheduled write.
+         */
+        void notePingRenewed( const ConnectionString& conn, const string& processId ) {
+            scoped_lock lk( _mutex );
+            _lastPingRenewal[ pingThreadId( conn, processId ) ] = jsTime();
+        }
+
+        bool pingRenewedSince( const string& pingId, Date_t since ) {
+            scoped_lock lk( _mutex );
+            map<string,Date_t>::const_iterator i = _lastPingRenewal.find( pingId );
+            return i != _lastPingRenewal.end() && i->second > since;
+        }
+
         void addUnlockOID( const OID& oid ) {
             // Modifying the lock from some other thread
             scoped_lock lk( _mutex );
@@ -355,6 +380,7 @@ namespace mongo {
         set<string> _kill;
         set<string> _seen;
         list<OID> _oldLockOIDs;
+        map<string,Date_t> _lastPingRenewal;
 
     } distLockPinger;
 
@@ -367,7 +393,8 @@ namespace mongo {
           _processId( asProcess ? getDistLockId() : getDistLockProcess() ),
           _lockTimeout( lockTimeout == 0 ? LOCK_TIMEOUT : lockTimeout ),
           _maxClockSkew( _lockTimeout / LOCK_SKEW_FACTOR ), _maxNetSkew( _maxClockSkew ),
-          _lockPing( _maxClockSkew ), _mutex( "DistributedLock" )
+          _lockPing( _maxClockSkew ), _mutex( "DistributedLock" ),
+          _lockDocExists( false )
     {
         LOG( logLvl ) << "created new distributed lock for " << name << " on " << conn
                       << " ( lock timeout : " << _lockTimeout
@@ -625,6 +652,72 @@ namespace mongo {
 
         ScopedDbConnection conn(_conn.toString(), timeout );
 
+        // Fast path: against a single config server the whole acquisition can be one
+        // atomic compare-and-swap.  The multi-round-trip tournament below only exists
+        // because SyncClusterConnection updates cannot be made atomic across multiple
+        // config servers.  Only worth trying once we know the lock document exists;
+        // a miss still falls through so the ping bookkeeping needed to force stale
+        // locks keeps running.
+        if ( ! reenter && _lockDocExists && _conn.type() == ConnectionString::MASTER ) {
+
+            BSONObj fastLockDetails = BSON( LocksType::state(2)
+                    << LocksType::who(getDistLockId())
+                    << LocksType::process(_processId)
+                    << "when" << jsTime()
+                    << LocksType::why(why)
+                    << LocksType::lockID(OID::gen()) );
+
+            BSONObj res;
+            bool ok = false;
+            try {
+                ok = conn->runCommand( nsToDatabase( LocksType::ConfigNS ),
+                                       BSON( "findAndModify"
+                                             << nsToCollectionSubstring( LocksType::ConfigNS )
+                                             << "query" << BSON( LocksType::name(_name)
+                                                                 << LocksType::state(0) )
+                                             << "update" << BSON( "$set" << fastLockDetails )
+                                             << "new" << true ),
+                                       res );
+            }
+            catch ( std::exception& e ) {
+                conn.done();
+                throw LockException( str::stream() << "exception creating distributed lock "
+                                     << _name << "/" << _processId << causedBy( e ), 13663 );
+            }
+
+            if ( ok && res["value"].isABSONObj() ) {
+
+                *other = res["value"].Obj().getOwned();
+
+                // Piggyback a ping renewal on the acquisition; fire-and-forget on the
+                // same connection costs no extra round trip, and lets the pinger thread
+                // skip its next scheduled write.
+                try {
+                    conn->update( LockpingsType::ConfigNS,
+                                  BSON( LockpingsType::process(_processId) ),
+                                  BSON( "$set" << BSON( LockpingsType::ping(jsTime()) ) ),
+                                  true );
+                    distLockPinger.notePingRenewed( _conn, _processId );
+                }
+                catch ( std::exception& e ) {
+                    warning() << "could not piggyback ping renewal on acquisition of lock "
+                              << _name << causedBy( e ) << endl;
+                }
+
+                LOG( logLvl - 1 ) << "distributed lock '" << _name << "/" << _processId
+                                  << "' acquired by compare-and-swap, ts : "
+                                  << (*other)[LocksType::lockID()].OID() << endl;
+
+                conn.done();
+                return true;
+            }
+
+            // CAS miss - the lock is held or contended, take the slow path so takeover
+            // state is maintained
+            LOG( logLvl ) << "distributed lock '" << _name << "/" << _processId
+                          << "' not acquired by compare-and-swap, checking holder" << endl;
+        }
+
         BSONObjBuilder queryBuilder;
         queryBuilder.append( LocksType::name() , _name );
         queryBuilder.append( LocksType::state() , 0 );
@@ -642,6 +735,7 @@ namespace mongo {
                                         << LocksType::state(0)
                                         << LocksType::who("")
                                         << LocksType::lockID(OID()) ));
+                    _lockDocExists = true;
                 }
                 catch ( UserException& e ) {
                     warning() << "could not insert initial doc for distributed lock " << _name << causedBy( e ) << endl;
@@ -651,6 +745,8 @@ namespace mongo {
             // Case 2: A set lock that we might be able to force
             else if ( o[LocksType::state()].numberInt() > 0 ) {
 
+                _lockDocExists = true;
+
                 string lockName = o[LocksType::name()].String() + string("/") + o[LocksType::process()].String();
 
                 bool canReenter = reenter &&
@@ -856,6 +952,7 @@ namespace mongo {
             }
             // Case 3: We have an expired lock
             else if ( o[LocksType::lockID()].type() ) {
+                _lockDocExists = true;
                 queryBuilder.append( o[LocksType::lockID()] );
             }
         }
@@ -234,6 +234,10 @@ namespace mongo {
         mongo::mutex _mutex;
         std::string _threadId;
 
+        // Cached knowledge that the lock document exists on the config server, so
+        // uncontended acquisitions can skip straight to the compare-and-swap fast path.
+        bool _lockDocExists;
+
     };
 
     // Helper functions for tests, allows us to turn the creation of a lock pinger on and off.
@@ -62,6 +62,7 @@
 #include "mongo/s/chunk.h"
 #include "mongo/s/client_info.h"
 #include "mongo/s/config.h"
+#include "mongo/s/config_changelog_monitor.h"
 #include "mongo/s/config_server_checker_service.h"
 #include "mongo/s/config_upgrade.h"
 #include "mongo/s/cursors.h"
@@ -182,12 +183,15 @@ namespace mongo {
         }
 
         virtual void disconnected( AbstractMessagingPort* p ) {
-            // all things are thread local
+            // Delete this thread's ClientInfo now rather than at thread exit so the
+            // thread can be reused for another connection.
+            ClientInfo::destroy();
         }
     };
 
     void start( const MessageServer::Options& opts ) {
         balancer.go();
+        configChangelogMonitor.go();
         cursorCache.startTimeoutThread();
         UserCacheInvalidator cacheInvalidatorThread(getGlobalAuthorizationManager());
         cacheInvalidatorThread.go();
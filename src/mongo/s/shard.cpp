@@ -57,6 +57,7 @@
 #include "mongo/s/version_manager.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stacktrace.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -476,6 +477,54 @@ namespace mongo {
         return listDatabases["totalSize"].numberLong();
     }
 
+    namespace {
+        // Cumulative opcounter total and sample time from the previous getShardOpsPerSec
+        // call, per shard host, so the monotonically increasing counters can be turned
+        // into a rate.
+        mongo::mutex _opsSampleMutex("ShardOpsSample");
+        map<string, pair<long long, unsigned long long> > _lastOpsSample;
+    }
+
+    long long Shard::getShardOpsPerSec(const string& shardHost) {
+        ScopedDbConnection conn(shardHost);
+        BSONObj serverStatus;
+        bool ok = conn->runCommand("admin", BSON("serverStatus" << 1), serverStatus);
+        conn.done();
+
+        uassert(28644,
+                str::stream() << "call to serverStatus on " << shardHost
+                              << " failed: " << serverStatus,
+                ok);
+
+        BSONElement opcountersElem = serverStatus["opcounters"];
+
+        uassert(28645, "opcounters field not found in serverStatus",
+                opcountersElem.isABSONObj());
+
+        long long total = 0;
+        BSONObjIterator it(opcountersElem.Obj());
+        while (it.more()) {
+            BSONElement e = it.next();
+            if (e.isNumber()) {
+                total += e.numberLong();
+            }
+        }
+
+        const unsigned long long now = curTimeMillis64();
+
+        scoped_lock lk(_opsSampleMutex);
+        pair<long long, unsigned long long>& last = _lastOpsSample[shardHost];
+
+        long long opsPerSec = 0;
+        // a counter can go backwards when the shard restarts; report 0 until resampled
+        if (last.second != 0 && now > last.second && total >= last.first) {
+            opsPerSec = (total - last.first) * 1000 / (now - last.second);
+        }
+
+        last = make_pair(total, now);
+        return opsPerSec;
+    }
+
     ShardStatus Shard::getStatus() const {
         return ShardStatus(*this,
                            getShardDataSizeBytes(getConnString()),
@@ -157,6 +157,13 @@ namespace mongo {
          */
         static long long getShardDataSizeBytes(const std::string& shardHost);
 
+        /**
+         * Returns the ops/s the shard served since the last call for the same host, based
+         * on the opcounters from the serverStatus command result.  Returns 0 on the first
+         * call for a host, when there is no previous sample to compute a rate against.
+         */
+        static long long getShardOpsPerSec(const std::string& shardHost);
+
         /**
          * Returns metadata and stats for this shard.
          */
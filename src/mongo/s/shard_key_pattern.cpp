@@ -112,13 +112,34 @@ namespace mongo {
         return parsedPaths.release();
     }
 
+    /**
+     * Precompiles an extraction path for each parsed key pattern path, so that per-document
+     * extraction doesn't have to re-parse the paths.
+     */
+    static vector<ElementPath*> buildElementPaths(const OwnedPointerVector<FieldRef>& patternPaths) {
+
+        OwnedPointerVector<ElementPath> elemPaths;
+
+        for (size_t i = 0; i < patternPaths.size(); ++i) {
+            auto_ptr<ElementPath> elemPath(new ElementPath());
+            elemPath->init(patternPaths.vector()[i]->dottedField());
+            elemPath->setTraverseNonleafArrays(false);
+            elemPath->setTraverseLeafArray(false);
+            elemPaths.push_back(elemPath.release());
+        }
+
+        return elemPaths.release();
+    }
+
     ShardKeyPattern::ShardKeyPattern(const BSONObj& keyPattern)
         : _keyPatternPaths(parseShardKeyPattern(keyPattern)),
+          _keyPatternElemPaths(buildElementPaths(_keyPatternPaths)),
           _keyPattern(_keyPatternPaths.empty() ? BSONObj() : keyPattern) {
     }
 
     ShardKeyPattern::ShardKeyPattern(const KeyPattern& keyPattern)
         : _keyPatternPaths(parseShardKeyPattern(keyPattern.toBSON())),
+          _keyPatternElemPaths(buildElementPaths(_keyPatternPaths)),
           _keyPattern(_keyPatternPaths.empty() ? KeyPattern(BSONObj()) : keyPattern) {
     }
 
@@ -201,12 +222,7 @@ namespace mongo {
     }
 
     static BSONElement extractKeyElementFromMatchable(const MatchableDocument& matchable,
-                                                      const StringData& pathStr) {
-        ElementPath path;
-        path.init(pathStr);
-        path.setTraverseNonleafArrays(false);
-        path.setTraverseLeafArray(false);
-
+                                                      const ElementPath& path) {
         MatchableDocument::IteratorHolder matchIt(&matchable, &path);
         if (!matchIt->more())
             return BSONElement();
@@ -218,6 +234,15 @@ namespace mongo {
         return matchEl;
     }
 
+    static BSONElement extractKeyElementFromMatchable(const MatchableDocument& matchable,
+                                                      const StringData& pathStr) {
+        ElementPath path;
+        path.init(pathStr);
+        path.setTraverseNonleafArrays(false);
+        path.setTraverseLeafArray(false);
+        return extractKeyElementFromMatchable(matchable, path);
+    }
+
     BSONObj //
     ShardKeyPattern::extractShardKeyFromMatchable(const MatchableDocument& matchable) const {
 
@@ -226,12 +251,13 @@ namespace mongo {
 
         BSONObjBuilder keyBuilder;
 
+        const vector<ElementPath*>& elemPaths = _keyPatternElemPaths.vector();
+
         BSONObjIterator patternIt(_keyPattern.toBSON());
-        while (patternIt.more()) {
+        for (size_t i = 0; patternIt.more(); ++i) {
 
             BSONElement patternEl = patternIt.next();
-            BSONElement matchEl = extractKeyElementFromMatchable(matchable,
-                                                                 patternEl.fieldNameStringData());
+            BSONElement matchEl = extractKeyElementFromMatchable(matchable, *elemPaths[i]);
 
             if (!isShardKeyElement(matchEl, true))
                 return BSONObj();
@@ -223,6 +223,10 @@ namespace mongo {
         // Ordered, parsed paths
         const OwnedPointerVector<FieldRef> _keyPatternPaths;
 
+        // Precompiled extraction paths, parallel to _keyPatternPaths, so per-document shard
+        // key extraction doesn't re-parse the key pattern paths
+        const OwnedPointerVector<ElementPath> _keyPatternElemPaths;
+
         const KeyPattern _keyPattern;
     };
 
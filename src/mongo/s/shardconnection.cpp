@@ -146,7 +146,7 @@ namespace mongo {
             return temp;
         }
 
-        ClientConnections() {
+        ClientConnections() : _lock( "ClientConnections" ) {
             // Start tracking client connections
             activeClientConnections.add( this );
         }
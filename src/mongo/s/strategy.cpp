@@ -454,6 +454,7 @@ namespace mongo {
                     ConnectionString::parse( cursor.getShardCursor( *i )->originalHost(),
                                              errMsg );
             result.result = cursor.getShardCursor( *i )->peekFirst().getOwned();
+            result.roundTripMicros = cursor.getShardRoundTripMicros( *i );
             results->push_back( result );
         }
 
@@ -56,9 +56,16 @@ namespace mongo {
         void writeOp( int op , Request& r );
 
         struct CommandResult {
+            CommandResult() : roundTripMicros( -1 ) {}
+
             Shard shardTarget;
             ConnectionString target;
             BSONObj result;
+
+            // Mongos-observed time between dispatching the command to the shard and receiving
+            // its reply, or -1 if not recorded.  Used by explain to attribute network and
+            // queueing latency per shard.
+            long long roundTripMicros;
         };
 
         /**
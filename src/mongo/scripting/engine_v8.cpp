@@ -33,6 +33,7 @@
 
 #include "mongo/scripting/engine_v8.h"
 
+#include <boost/scoped_ptr.hpp>
 #include <iostream>
 
 #include "mongo/base/init.h"
@@ -42,6 +43,7 @@
 #include "mongo/scripting/v8_db.h"
 #include "mongo/scripting/v8_utils.h"
 #include "mongo/util/base64.h"
+#include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -59,6 +61,80 @@ namespace mongo {
         extern const JSFile assert;
     }
 
+    namespace {
+
+        /**
+         * Process-wide cache of V8 pre-parse data, keyed by script source.  Pre-parse
+         * data is context- and isolate-independent, so the parse work done by one scope
+         * can be reused by every scope that later compiles the same source - notably
+         * repeated mapReduce jobs and $where clauses, which recompile identical
+         * functions (and re-run the same core JS files) in every freshly built scope.
+         *
+         * Keys are the full source rather than a source hash: V8 only sanity-checks
+         * pre-parse data against the source, and feeding it data from a colliding
+         * script would go undetected.
+         */
+        class V8PreParseCache {
+        public:
+            V8PreParseCache() : _mutex("V8PreParseCache") {}
+
+            /**
+             * Copies the pre-parse data for 'code' into 'bytes', generating and caching
+             * it the first time the source is seen.  Returns false if the source could
+             * not be pre-parsed, in which case compilation proceeds without hints.
+             */
+            bool get(const std::string& code, std::string* bytes) {
+                {
+                    SimpleMutex::scoped_lock lk(_mutex);
+                    Cache::const_iterator it = _cache.find(code);
+                    if (it != _cache.end()) {
+                        *bytes = it->second;
+                        return !bytes->empty();
+                    }
+                }
+
+                // Pre-parse outside the lock; this runs no JS and touches no context.
+                boost::scoped_ptr<v8::ScriptData> fresh(
+                        v8::ScriptData::PreCompile(code.c_str(), code.size()));
+
+                std::string data;
+                if (fresh.get() && !fresh->HasError()) {
+                    data.assign(fresh->Data(), fresh->Length());
+                }
+
+                SimpleMutex::scoped_lock lk(_mutex);
+                if (_cache.size() >= kMaxEntries) {
+                    _cache.clear();
+                }
+                // Sources that fail to pre-parse are remembered as empty entries so we
+                // don't re-parse them on every compile.
+                _cache[code] = data;
+                *bytes = data;
+                return !bytes->empty();
+            }
+
+        private:
+            static const size_t kMaxEntries = 100;
+
+            typedef unordered_map<std::string, std::string> Cache;
+            SimpleMutex _mutex;
+            Cache _cache; // protected by _mutex
+        };
+
+        V8PreParseCache preParseCache;
+
+        /**
+         * Returns a ScriptData wrapper over the cached pre-parse data for 'code', or
+         * NULL if none is available.  The wrapper may reference 'bytes' directly, so
+         * 'bytes' must outlive it.
+         */
+        v8::ScriptData* getPreParseData(const std::string& code, std::string* bytes) {
+            if (!preParseCache.get(code, bytes))
+                return NULL;
+            return v8::ScriptData::New(bytes->data(), bytes->size());
+        }
+    }
+
     // The  unwrapXXX functions extract internal fields from an object wrapped by wrapBSONObject.
     // These functions are currently only used in places that should always have the correct
     // type of object, however it may be possible for users to come up with a way to make these
@@ -102,6 +178,34 @@ namespace mongo {
         bsonHolderTracker.track(p, holder);
     }
 
+    /**
+     * Stack-allocated UTF-8 copy of a V8 property name.  The interceptors below run
+     * for every property access on a wrapped BSON object - including misses that fall
+     * through to the prototype, such as method lookups - so resolving a name against
+     * the raw BSON buffer must not heap-allocate for ordinary short names.
+     */
+    class V8PropertyName {
+    public:
+        explicit V8PropertyName(const v8::Handle<v8::String>& name) {
+            const int len = name->Utf8Length();
+            if (len < static_cast<int>(sizeof(_stackBuf))) {
+                name->WriteUtf8(_stackBuf);
+                _name = StringData(_stackBuf, len);
+            }
+            else {
+                _heapBuf = toSTLString(name);
+                _name = _heapBuf;
+            }
+        }
+
+        const StringData& name() const { return _name; }
+
+    private:
+        char _stackBuf[64];
+        std::string _heapBuf;
+        StringData _name;
+    };
+
     static v8::Handle<v8::Value> namedGet(v8::Local<v8::String> name,
                                           const v8::AccessorInfo& info) {
         v8::HandleScope handle_scope;
@@ -115,13 +219,14 @@ namespace mongo {
                 return handle_scope.Close(realObject->Get(name));
             }
 
-            string key = toSTLString(name);
+            const V8PropertyName key(name);
             BSONHolder* holder = unwrapHolder(scope, info.Holder());
-            if (!holder || holder->_removed.count(key))
+            if (!holder || (!holder->_removed.empty() &&
+                            holder->_removed.count(key.name().toString())))
                 return handle_scope.Close(v8::Handle<v8::Value>());
 
             BSONObj obj = holder->_obj;
-            BSONElement elmt = obj.getField(key.c_str());
+            BSONElement elmt = obj.getField(key.name());
             if (elmt.eoo())
                 return handle_scope.Close(v8::Handle<v8::Value>());
 
@@ -231,11 +336,13 @@ namespace mongo {
                 // value already cached or added
                 return handle_scope.Close(realObject->Get(index));
             }
-            string key = str::stream() << index;
+            char keyBuf[16];
+            const int keyLen = snprintf(keyBuf, sizeof(keyBuf), "%u", index);
+            const StringData key(keyBuf, keyLen);
 
             BSONHolder* holder = unwrapHolder(scope, info.Holder());
             if (!holder) return v8::Handle<v8::Value>();
-            if (holder->_removed.count(key))
+            if (!holder->_removed.empty() && holder->_removed.count(key.toString()))
                 return handle_scope.Close(v8::Handle<v8::Value>());
 
             BSONObj obj = holder->_obj;
@@ -975,9 +1082,14 @@ namespace mongo {
         string fn = str::stream() << "_funcs" << functionNumber;
         code = str::stream() << fn << " = " << code;
 
+        std::string preParseBytes;
+        boost::scoped_ptr<v8::ScriptData> preData(getPreParseData(code, &preParseBytes));
+
+        v8::ScriptOrigin origin(v8::String::New(fn.c_str()));
         v8::Handle<v8::Script> script = v8::Script::Compile(
                                             v8::String::New(code.c_str(), code.length()),
-                                            v8::String::New(fn.c_str()));
+                                            &origin,
+                                            preData.get());
 
         // throw on error
         checkV8ErrorState(script, try_catch);
@@ -1089,9 +1201,15 @@ namespace mongo {
         V8_SIMPLE_HEADER
         v8::TryCatch try_catch;
 
+        const string codeStr = code.toString();
+        std::string preParseBytes;
+        boost::scoped_ptr<v8::ScriptData> preData(getPreParseData(codeStr, &preParseBytes));
+
+        v8::ScriptOrigin origin(v8::String::New(name.c_str(), name.length()));
         v8::Handle<v8::Script> script =
-                v8::Script::Compile(v8::String::New(code.rawData(), code.size()),
-                                    v8::String::New(name.c_str(), name.length()));
+                v8::Script::Compile(v8::String::New(codeStr.c_str(), codeStr.size()),
+                                    &origin,
+                                    preData.get());
 
         if (checkV8ErrorState(script, try_catch, reportError, assertOnError))
             return false;
@@ -1335,8 +1453,13 @@ namespace mongo {
         v8::TryCatch try_catch;
         string codeStr = str::stream() << "____MongoToV8_newFunction_temp = " << code;
 
+        std::string preParseBytes;
+        boost::scoped_ptr<v8::ScriptData> preData(getPreParseData(codeStr, &preParseBytes));
+
         v8::Local<v8::Script> compiled = v8::Script::New(v8::String::New(codeStr.c_str(),
-                                                                         codeStr.length()));
+                                                                         codeStr.length()),
+                                                         NULL,
+                                                         preData.get());
 
         // throw on compile error
         checkV8ErrorState(compiled, try_catch);
@@ -58,6 +58,7 @@ DBCollection.prototype.help = function () {
     print("\tdb." + shortName + ".insert(obj)");
     print("\tdb." + shortName + ".mapReduce( mapFunction , reduceFunction , <optional params> )");
     print("\tdb." + shortName + ".aggregate( [pipeline], <optional params> ) - performs an aggregation on a collection; returns a cursor");
+    print("\tdb." + shortName + ".parallelScan( numCursors ) - opens up to numCursors cursors over disjoint ranges of the collection; returns an array of cursors");
     print("\tdb." + shortName + ".remove(query)");
     print("\tdb." + shortName + ".renameCollection( newName , <dropTarget> ) renames the collection.");
     print("\tdb." + shortName + ".runCommand( name , <options> ) runs a db command with the given name where the first param is the collection name");
@@ -1232,6 +1233,24 @@ DBCollection.prototype.aggregate = function(pipeline, extraOpts) {
     return res;
 }
 
+/**
+ * Opens multiple server-side cursors over disjoint ranges of the collection via
+ * the parallelCollectionScan command, so the collection can be drained with up
+ * to numCursors streams working in parallel.  Returns an array of
+ * DBCommandCursor objects; the server may hand back fewer cursors than
+ * requested for small collections.
+ */
+DBCollection.prototype.parallelScan = function( numCursors ){
+    var res = this.runCommand( "parallelCollectionScan", { numCursors: numCursors } );
+    assert.commandWorked( res, "parallelCollectionScan failed" );
+
+    var cursors = [];
+    for ( var i = 0; i < res.cursors.length; i++ ) {
+        cursors.push( new DBCommandCursor( this._mongo, res.cursors[i] ) );
+    }
+    return cursors;
+}
+
 DBCollection.prototype.group = function( params ){
     params.ns = this._shortName;
     return this._db.group( params );
@@ -0,0 +1,530 @@
+// replay.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+/**
+ * mongoreplay - capture a workload from the profiler and replay it elsewhere.
+ *
+ * "record" reads the system.profile collections of a node that has been running
+ * with profiling level 2 and writes the replayable operations to a compact
+ * capture file (a stream of trimmed BSON documents).  "play" reconstructs the
+ * captured concurrency structure against a target node -- one connection per
+ * original client, original inter-operation gaps -- and reports captured vs.
+ * replayed latency per operation type, so a real workload can be validated
+ * against a candidate configuration (e.g. a different storage engine) before
+ * cutover.
+ *
+ * The profiler records the shape of queries, commands, updates and removes, but
+ * not the documents of inserts nor the cursor state behind getmores, so those
+ * operations are counted and skipped at record time.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/thread/thread.hpp>
+
+#include "mongo/base/initializer.h"
+#include "mongo/client/dbclientinterface.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/quick_exit.h"
+#include "mongo/util/text.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+using namespace std;
+using namespace mongo;
+
+namespace {
+
+    // First bytes of a capture file; bump the digit if the record layout changes.
+    const char kCaptureMagic[] = "mongowl1";
+    const size_t kCaptureMagicLen = 8;
+
+    // Largest profile entry we are willing to believe when reading a capture file.
+    const int kMaxRecordSize = 17 * 1024 * 1024;
+
+    /**
+     * One replayable operation, trimmed from a system.profile entry.
+     */
+    struct CapturedOp {
+        CapturedOp() : upsert(false), ntoreturn(0), ntoskip(0), millis(0) {}
+
+        Date_t ts;
+        string client;
+        string op;
+        string ns;
+        BSONObj arg;        // query for query/update/remove ops, command object for commands
+        BSONObj updateobj;
+        bool upsert;
+        int ntoreturn;
+        int ntoskip;
+        int millis;
+    };
+
+    bool replayableOp(const string& op) {
+        return op == "query" || op == "command" || op == "update" || op == "remove";
+    }
+
+    /**
+     * Commands whose replay would modify topology or server state rather than
+     * exercise the workload; profiling itself also shows up here.
+     */
+    bool skippedCommand(const BSONObj& cmd) {
+        const char* name = cmd.firstElementFieldName();
+        return str::equals(name, "profile") ||
+               str::equals(name, "shutdown") ||
+               str::equals(name, "replSetReconfig") ||
+               str::equals(name, "getlasterror") ||
+               str::equals(name, "getLastError");
+    }
+
+    // ----------------------------------------------------------------
+    // record
+    // ----------------------------------------------------------------
+
+    int record(const string& from, const vector<string>& dbs, const string& outFile) {
+        DBClientConnection conn;
+        string errmsg;
+        if (!conn.connect(HostAndPort(from), errmsg)) {
+            cerr << "couldn't connect to " << from << ": " << errmsg << endl;
+            return -1;
+        }
+
+        ofstream out(outFile.c_str(), ios::out | ios::binary | ios::trunc);
+        if (!out.good()) {
+            cerr << "couldn't open " << outFile << " for writing" << endl;
+            return -1;
+        }
+        out.write(kCaptureMagic, kCaptureMagicLen);
+
+        long long numWritten = 0;
+        map<string, long long> numSkipped;
+
+        for (size_t i = 0; i < dbs.size(); i++) {
+            const string profileNs = dbs[i] + ".system.profile";
+            auto_ptr<DBClientCursor> cursor =
+                conn.query(profileNs, Query().sort("$natural", 1));
+            uassert(28710, str::stream() << "couldn't query " << profileNs, cursor.get());
+
+            while (cursor->more()) {
+                BSONObj entry = cursor->next();
+                const string op = entry["op"].str();
+                const string ns = entry["ns"].str();
+
+                if (!replayableOp(op) || NamespaceString(ns).isSystem()) {
+                    numSkipped[op.empty() ? "unknown" : op]++;
+                    continue;
+                }
+
+                const BSONObj arg =
+                    entry[op == "command" ? "command" : "query"].Obj();
+                if (op == "command" && skippedCommand(arg)) {
+                    numSkipped["command"]++;
+                    continue;
+                }
+
+                // Keep only what "play" needs; dropping the execution stats is
+                // what keeps the capture compact.
+                BSONObjBuilder b;
+                b.append(entry["ts"]);
+                b.append(entry["client"]);
+                b.append("op", op);
+                b.append("ns", ns);
+                b.append("arg", arg);
+                if (op == "update") {
+                    b.append("updateobj", entry["updateobj"].Obj());
+                    if (entry["upsert"].trueValue())
+                        b.appendBool("upsert", true);
+                }
+                if (entry["ntoreturn"].isNumber())
+                    b.append("ntoreturn", entry["ntoreturn"].numberInt());
+                if (entry["ntoskip"].isNumber())
+                    b.append("ntoskip", entry["ntoskip"].numberInt());
+                b.append("millis", entry["millis"].numberInt());
+
+                const BSONObj trimmed = b.done();
+                out.write(trimmed.objdata(), trimmed.objsize());
+                numWritten++;
+            }
+        }
+
+        out.close();
+        if (!out.good()) {
+            cerr << "error writing " << outFile << endl;
+            return -1;
+        }
+
+        cout << "wrote " << numWritten << " ops to " << outFile << endl;
+        for (map<string, long long>::const_iterator it = numSkipped.begin();
+             it != numSkipped.end();
+             ++it) {
+            cout << "skipped " << it->second << " " << it->first
+                 << " ops (not replayable)" << endl;
+        }
+        return 0;
+    }
+
+    // ----------------------------------------------------------------
+    // play
+    // ----------------------------------------------------------------
+
+    /**
+     * All ops captured from one original client connection, replayed in order
+     * on a dedicated connection by a dedicated thread.
+     */
+    struct ReplaySession {
+        ReplaySession() : numErrors(0) {}
+
+        string client;
+        vector<CapturedOp> ops;
+
+        // Parallel to 'ops'; filled in by the replay thread, read after join.
+        vector<long long> replayMicros;
+        long long numErrors;
+    };
+
+    struct PlayConfig {
+        string target;
+        double speed;
+        Date_t baseTs;      // ts of the earliest captured op
+    };
+
+    bool loadCapture(const string& file, vector<CapturedOp>* ops) {
+        ifstream in(file.c_str(), ios::in | ios::binary);
+        if (!in.good()) {
+            cerr << "couldn't open " << file << endl;
+            return false;
+        }
+
+        char magic[kCaptureMagicLen];
+        in.read(magic, kCaptureMagicLen);
+        if (!in.good() || memcmp(magic, kCaptureMagic, kCaptureMagicLen) != 0) {
+            cerr << file << " is not a mongoreplay capture file" << endl;
+            return false;
+        }
+
+        vector<char> buf;
+        for (;;) {
+            char lenBytes[4];
+            in.read(lenBytes, 4);
+            if (in.eof())
+                break;
+            if (!in.good())
+                return false;
+
+            const int len = ConstDataView(lenBytes).readLE<int>();
+            if (len < 5 || len > kMaxRecordSize) {
+                cerr << file << ": corrupt record of size " << len << endl;
+                return false;
+            }
+
+            buf.resize(len);
+            memcpy(&buf[0], lenBytes, 4);
+            in.read(&buf[4], len - 4);
+            if (!in.good())
+                return false;
+
+            BSONObj record = BSONObj(&buf[0]).getOwned();
+
+            CapturedOp op;
+            op.ts = record["ts"].Date();
+            op.client = record["client"].str();
+            op.op = record["op"].str();
+            op.ns = record["ns"].str();
+            op.arg = record["arg"].Obj().getOwned();
+            if (record.hasField("updateobj"))
+                op.updateobj = record["updateobj"].Obj().getOwned();
+            op.upsert = record["upsert"].trueValue();
+            op.ntoreturn = record["ntoreturn"].numberInt();
+            op.ntoskip = record["ntoskip"].numberInt();
+            op.millis = record["millis"].numberInt();
+            ops->push_back(op);
+        }
+        return true;
+    }
+
+    bool compareByTs(const CapturedOp& lhs, const CapturedOp& rhs) {
+        return lhs.ts < rhs.ts;
+    }
+
+    void replaySession(const PlayConfig* config, ReplaySession* session) {
+        DBClientConnection conn;
+        string errmsg;
+        if (!conn.connect(HostAndPort(config->target), errmsg)) {
+            cerr << "client " << session->client << ": couldn't connect to "
+                 << config->target << ": " << errmsg << endl;
+            session->numErrors = static_cast<long long>(session->ops.size());
+            return;
+        }
+
+        Timer elapsed;
+        for (size_t i = 0; i < session->ops.size(); i++) {
+            const CapturedOp& op = session->ops[i];
+
+            // Reproduce the captured pacing: wait until this op's offset from
+            // the start of the capture, scaled by --speed.
+            const long long targetMicros = static_cast<long long>(
+                (op.ts.millis - config->baseTs.millis) * 1000 / config->speed);
+            const long long waitMicros = targetMicros - elapsed.micros();
+            if (waitMicros > 0)
+                sleepmicros(waitMicros);
+
+            Timer opTimer;
+            try {
+                if (op.op == "query") {
+                    auto_ptr<DBClientCursor> cursor =
+                        conn.query(op.ns, Query(op.arg), op.ntoreturn, op.ntoskip);
+                    while (cursor.get() && cursor->more())
+                        cursor->nextSafe();
+                }
+                else if (op.op == "command") {
+                    BSONObj info;
+                    conn.runCommand(nsToDatabase(op.ns), op.arg, info);
+                }
+                else if (op.op == "update") {
+                    conn.update(op.ns, Query(op.arg), op.updateobj, op.upsert, false);
+                    conn.getLastError();
+                }
+                else if (op.op == "remove") {
+                    conn.remove(op.ns, Query(op.arg));
+                    conn.getLastError();
+                }
+            }
+            catch (const DBException&) {
+                session->numErrors++;
+            }
+            session->replayMicros[i] = opTimer.micros();
+        }
+    }
+
+    long long percentile(const vector<long long>& sorted, int pct) {
+        if (sorted.empty())
+            return 0;
+        return sorted[(sorted.size() - 1) * pct / 100];
+    }
+
+    void printLatencyLine(const string& label, vector<long long>& micros) {
+        sort(micros.begin(), micros.end());
+        cout << "    " << left << setw(10) << label
+             << fixed << setprecision(1)
+             << "p50 " << setw(10) << percentile(micros, 50) / 1000.0
+             << "p95 " << setw(10) << percentile(micros, 95) / 1000.0
+             << "p99 " << setw(10) << percentile(micros, 99) / 1000.0
+             << "ms" << endl;
+    }
+
+    int play(const string& file, const string& target, double speed) {
+        vector<CapturedOp> ops;
+        if (!loadCapture(file, &ops))
+            return -1;
+        if (ops.empty()) {
+            cerr << file << " contains no ops" << endl;
+            return -1;
+        }
+
+        // Per-client order is what matters; stable_sort keeps the capture order
+        // of ops that share a timestamp.
+        stable_sort(ops.begin(), ops.end(), compareByTs);
+
+        PlayConfig config;
+        config.target = target;
+        config.speed = speed;
+        config.baseTs = ops[0].ts;
+
+        map<string, ReplaySession*> sessions;
+        for (size_t i = 0; i < ops.size(); i++) {
+            ReplaySession*& session = sessions[ops[i].client];
+            if (!session) {
+                session = new ReplaySession();
+                session->client = ops[i].client;
+            }
+            session->ops.push_back(ops[i]);
+        }
+        for (map<string, ReplaySession*>::iterator it = sessions.begin();
+             it != sessions.end();
+             ++it) {
+            it->second->replayMicros.resize(it->second->ops.size(), 0);
+        }
+
+        cout << "replaying " << ops.size() << " ops from " << sessions.size()
+             << " clients against " << target << " at " << speed << "x" << endl;
+
+        boost::thread_group threads;
+        for (map<string, ReplaySession*>::iterator it = sessions.begin();
+             it != sessions.end();
+             ++it) {
+            threads.create_thread(stdx::bind(&replaySession, &config, it->second));
+        }
+        threads.join_all();
+
+        // Aggregate captured vs. replayed latency by op type.
+        map<string, vector<long long> > capturedByOp;
+        map<string, vector<long long> > replayedByOp;
+        long long numErrors = 0;
+        for (map<string, ReplaySession*>::iterator it = sessions.begin();
+             it != sessions.end();
+             ++it) {
+            ReplaySession* session = it->second;
+            for (size_t i = 0; i < session->ops.size(); i++) {
+                capturedByOp[session->ops[i].op].push_back(
+                    session->ops[i].millis * 1000LL);
+                replayedByOp[session->ops[i].op].push_back(session->replayMicros[i]);
+            }
+            numErrors += session->numErrors;
+            delete session;
+        }
+
+        for (map<string, vector<long long> >::iterator it = capturedByOp.begin();
+             it != capturedByOp.end();
+             ++it) {
+            cout << it->first << " (" << it->second.size() << " ops)" << endl;
+            printLatencyLine("captured", it->second);
+            printLatencyLine("replayed", replayedByOp[it->first]);
+        }
+        if (numErrors)
+            cout << numErrors << " ops failed during replay" << endl;
+
+        return numErrors ? 1 : 0;
+    }
+
+}  // namespace
+
+void usage() {
+    cout <<
+         "Usage:\n"
+         "  mongoreplay record --from host:port --db <name> [--db <name> ...] -o <file>\n"
+         "  mongoreplay play <file> --target host:port [--speed <factor>]\n"
+         "\n"
+         "record reads the system.profile collections of the named databases on the\n"
+         "source node (run it with profiling level 2 during the window of interest)\n"
+         "and writes the replayable ops to <file>.\n"
+         "\n"
+         "play replays <file> against the target node, one connection per original\n"
+         "client with the original inter-op timing (divided by --speed, default 1),\n"
+         "then prints captured vs. replayed latency percentiles per op type.\n"
+         << endl;
+}
+
+int toolMain(int argc, char** argv, char** envp) {
+    mongo::runGlobalInitializersOrDie(argc, argv, envp);
+
+    string mode;
+    string from;
+    string target;
+    string file;
+    vector<string> dbs;
+    double speed = 1.0;
+
+    vector<const char*> args;
+    for (int i = 1; i < argc; ++i)
+        args.push_back(argv[i]);
+
+    try {
+        for (unsigned i = 0; i < args.size(); ++i) {
+            const char* arg = args[i];
+            if (arg == string("--help")) {
+                usage();
+                return 0;
+            }
+            else if (arg == string("--from")) {
+                from = args[++i];
+            }
+            else if (arg == string("--target")) {
+                target = args[++i];
+            }
+            else if (arg == string("--db")) {
+                dbs.push_back(args[++i]);
+            }
+            else if (arg == string("-o")) {
+                file = args[++i];
+            }
+            else if (arg == string("--speed")) {
+                speed = atof(args[++i]);
+                uassert(28711, "--speed must be positive", speed > 0);
+            }
+            else if (mode.empty() && (arg == string("record") || arg == string("play"))) {
+                mode = arg;
+            }
+            else if (mode == "play" && file.empty()) {
+                file = arg;
+            }
+            else {
+                usage();
+                return -1;
+            }
+        }
+
+        if (mode == "record") {
+            uassert(28712, "record needs --from, --db and -o", !from.empty() && !dbs.empty() && !file.empty());
+            return record(from, dbs, file);
+        }
+        else if (mode == "play") {
+            uassert(28713, "play needs a capture file and --target", !file.empty() && !target.empty());
+            return play(file, target, speed);
+        }
+    }
+    catch (const DBException& e) {
+        cerr << e.what() << endl;
+        return -1;
+    }
+    catch (...) {
+        usage();
+        return -1;
+    }
+
+    usage();
+    return -1;
+}
+
+#if defined(_WIN32)
+// In Windows, wmain() is an alternate entry point for main(), and receives the same parameters
+// as main() but encoded in Windows Unicode (UTF-16); "wide" 16-bit wchar_t characters.  The
+// WindowsCommandLine object converts these wide character strings to a UTF-8 coded equivalent
+// and makes them available through the argv() and envp() members.  This enables toolMain()
+// to process UTF-8 encoded arguments and environment variables without regard to platform.
+int wmain(int argc, wchar_t* argvW[], wchar_t* envpW[]) {
+    WindowsCommandLine wcl(argc, argvW, envpW);
+    int exitCode = toolMain(argc, wcl.argv(), wcl.envp());
+    mongo::quickExit(exitCode);
+}
+#else
+int main(int argc, char* argv[], char** envp) {
+    int exitCode = toolMain(argc, argv, envp);
+    mongo::quickExit(exitCode);
+}
+#endif
@@ -0,0 +1,178 @@
+// benchmark.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace benchmark {
+
+    namespace {
+
+        // A measured run must last at least this long so that timer granularity and
+        // scheduling jitter are small relative to what is being measured.
+        const long long kMinRunMicros = 200 * 1000;
+
+        // Calibration ends once two consecutive estimates agree to within this
+        // fraction; until then the runs count as warm-up and are discarded.
+        const double kCalibrationTolerance = 0.20;
+
+        // Odd, so the median is a single run; see benchmark.h for the confidence
+        // interval the second-lowest/second-highest runs provide.
+        const int kNumMeasuredRuns = 7;
+
+        // Function-local static so registration works regardless of static
+        // initialization order across translation units.
+        std::vector<Benchmark*>& registry() {
+            static std::vector<Benchmark*> benchmarks;
+            return benchmarks;
+        }
+
+        double nsPerOp(long long micros, long long iterations) {
+            return static_cast<double>(micros) * 1000.0 / iterations;
+        }
+
+        long long timeOneRun(Benchmark* bench, long long iterations) {
+            Timer timer;
+            bench->run(iterations);
+            return timer.micros();
+        }
+
+        /**
+         * Grows the iteration count until one run lasts kMinRunMicros and two
+         * consecutive estimates agree, then returns the iteration count to measure
+         * with.
+         */
+        long long calibrate(Benchmark* bench) {
+            long long iterations = 1;
+            double previousEstimate = -1.0;
+
+            for (;;) {
+                const long long micros = timeOneRun(bench, iterations);
+
+                if (micros < kMinRunMicros) {
+                    // Grow quickly while runs are far too short, conservatively when
+                    // close, and guard against a zero measurement.
+                    if (micros <= 0 || micros < kMinRunMicros / 100) {
+                        iterations *= 100;
+                    }
+                    else {
+                        iterations *= 2;
+                    }
+                    previousEstimate = -1.0;
+                    continue;
+                }
+
+                const double estimate = nsPerOp(micros, iterations);
+                if (previousEstimate > 0.0 &&
+                    std::fabs(estimate - previousEstimate) <=
+                        kCalibrationTolerance * previousEstimate) {
+                    return iterations;
+                }
+                previousEstimate = estimate;
+            }
+        }
+
+    }  // namespace
+
+    Benchmark::Benchmark() {}
+    Benchmark::~Benchmark() {}
+    void Benchmark::setUp() {}
+    void Benchmark::tearDown() {}
+
+    void registerBenchmark(Benchmark* bench) {
+        registry().push_back(bench);
+    }
+
+    int runAll(const std::string& filter, bool jsonOutput) {
+        int numRun = 0;
+
+        for (size_t i = 0; i < registry().size(); i++) {
+            Benchmark* bench = registry()[i];
+            if (!filter.empty() && bench->name().find(filter) == std::string::npos) {
+                continue;
+            }
+            numRun++;
+
+            bench->setUp();
+
+            const long long iterations = calibrate(bench);
+
+            std::vector<double> runs;
+            for (int r = 0; r < kNumMeasuredRuns; r++) {
+                runs.push_back(nsPerOp(timeOneRun(bench, iterations), iterations));
+            }
+            std::sort(runs.begin(), runs.end());
+
+            bench->tearDown();
+
+            const double median = runs[runs.size() / 2];
+            const double low = runs[1];
+            const double high = runs[runs.size() - 2];
+
+            if (jsonOutput) {
+                std::cout << std::fixed << std::setprecision(2)
+                          << "{ \"name\" : \"" << bench->name() << "\""
+                          << ", \"iterationsPerRun\" : " << iterations
+                          << ", \"runs\" : " << kNumMeasuredRuns
+                          << ", \"medianNsPerOp\" : " << median
+                          << ", \"lowNsPerOp\" : " << low
+                          << ", \"highNsPerOp\" : " << high
+                          << " }" << std::endl;
+            }
+            else {
+                std::cout << std::fixed << std::setprecision(2)
+                          << bench->name()
+                          << "\t" << median << " ns/op"
+                          << "\t[" << low << ", " << high << "]"
+                          << "\t(" << iterations << " iters/run x "
+                          << kNumMeasuredRuns << " runs)" << std::endl;
+            }
+        }
+
+        if (numRun == 0) {
+            std::cerr << "no benchmarks matched filter \"" << filter << "\"" << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+}  // namespace benchmark
+}  // namespace mongo
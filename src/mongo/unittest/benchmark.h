@@ -0,0 +1,154 @@
+// benchmark.h
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+
+/**
+ * Calibrated microbenchmark harness, the benchmark-side analogue of unittest.h.
+ *
+ * A benchmark is a class with an optional setUp()/tearDown() pair (run outside the
+ * timed region) and a run(iterations) body that performs the measured work
+ * "iterations" times.  The harness:
+ *
+ *   - calibrates the iteration count upward until a single run lasts long enough to
+ *     swamp timer granularity;
+ *   - treats calibration runs as warm-up, and only stops calibrating once two
+ *     consecutive estimates agree, i.e. caches, branch predictors and lazy
+ *     initialization have settled;
+ *   - takes a fixed odd number of measured runs and reports the median ns/op,
+ *     bracketed by the second-lowest and second-highest runs.  For seven runs those
+ *     order statistics bound the true median with roughly 87% confidence (binomial
+ *     argument), which is what regression gating should compare against.
+ *
+ * Sample use:
+ *
+ *     MONGO_BENCHMARK(BSONObjIteration) {
+ *         BSONObj obj = BSON("a" << 1 << "b" << 2);  // careful: timed!
+ *         for (long long i = 0; i < _benchmarkIterations; i++) {
+ *             // measured work
+ *         }
+ *     }
+ *
+ * Setup that must not be timed goes in a fixture:
+ *
+ *     class MyFixture : public mongo::benchmark::Benchmark {
+ *     public:
+ *         virtual void setUp() { ... }
+ *         virtual void tearDown() { ... }
+ *     protected:
+ *         ...state...
+ *     };
+ *
+ *     MONGO_BENCHMARK_F(MyFixture, HotPath) {
+ *         for (long long i = 0; i < _benchmarkIterations; i++) { ... }
+ *     }
+ */
+namespace mongo {
+namespace benchmark {
+
+    class Benchmark {
+        MONGO_DISALLOW_COPYING(Benchmark);
+
+    public:
+        Benchmark();
+        virtual ~Benchmark();
+
+        virtual std::string name() const = 0;
+
+        /**
+         * Invoked once before calibration and once after the last measured run,
+         * outside the timed region.
+         */
+        virtual void setUp();
+        virtual void tearDown();
+
+        /**
+         * Performs the measured work "iterations" times.  The body must scale
+         * linearly with "iterations"; the harness relies on that for calibration.
+         */
+        virtual void run(long long iterations) = 0;
+    };
+
+    /**
+     * Registers "bench" to be run by runAll(); takes ownership.  Ordinarily invoked
+     * through the MONGO_BENCHMARK macros at static initialization time.
+     */
+    void registerBenchmark(Benchmark* bench);
+
+    /**
+     * Runs every registered benchmark whose name contains "filter" (an empty filter
+     * matches all).  Prints one human-readable line per benchmark to stdout; with
+     * "jsonOutput" each benchmark instead emits a single-line JSON document:
+     *
+     *     { "name" : ..., "iterationsPerRun" : ..., "runs" : ...,
+     *       "medianNsPerOp" : ..., "lowNsPerOp" : ..., "highNsPerOp" : ... }
+     *
+     * Returns a process exit code.
+     */
+    int runAll(const std::string& filter, bool jsonOutput);
+
+    template <typename T>
+    class RegistrationAgent {
+    public:
+        RegistrationAgent() {
+            registerBenchmark(new T());
+        }
+    };
+
+}  // namespace benchmark
+}  // namespace mongo
+
+#define MONGO_BENCHMARK(NAME) \
+    class _BENCHMARK_TYPE_##NAME : public ::mongo::benchmark::Benchmark { \
+    public: \
+        virtual std::string name() const { return #NAME; } \
+        virtual void run(long long _benchmarkIterations); \
+    }; \
+    namespace { \
+        ::mongo::benchmark::RegistrationAgent<_BENCHMARK_TYPE_##NAME> \
+            _benchmarkAgent_##NAME; \
+    } \
+    void _BENCHMARK_TYPE_##NAME::run(long long _benchmarkIterations)
+
+#define MONGO_BENCHMARK_F(FIXTURE, NAME) \
+    class _BENCHMARK_TYPE_##FIXTURE##NAME : public FIXTURE { \
+    public: \
+        virtual std::string name() const { return #FIXTURE "." #NAME; } \
+        virtual void run(long long _benchmarkIterations); \
+    }; \
+    namespace { \
+        ::mongo::benchmark::RegistrationAgent<_BENCHMARK_TYPE_##FIXTURE##NAME> \
+            _benchmarkAgent_##FIXTURE##NAME; \
+    } \
+    void _BENCHMARK_TYPE_##FIXTURE##NAME::run(long long _benchmarkIterations)
@@ -77,18 +77,30 @@ namespace mongo {
             // function.
             bool _isShutdownRequested() const;
 
-            // Runs all registered tasks. You must hold _mutex to call this function.
-            void _runTasks();
+            // Runs every registered task whose deadline falls within the coalescing
+            // window of this wakeup, and schedules its next deadline. You must hold
+            // _mutex to call this function.
+            void _runDueTasks();
 
             // Runs one task to completion, and optionally reports timing. You must hold _mutex
             // to call this function.
             void _runTask( PeriodicTask* task );
 
+            // The task's declared period, clamped to at least one millisecond.
+            static unsigned long long _periodFor( const PeriodicTask* task );
+
+            // A registered task and the time, per curTimeMillis64(), at which it should
+            // next run.
+            struct TaskEntry {
+                PeriodicTask* task;
+                unsigned long long nextDueMillis;
+            };
+
             // _mutex protects the _shutdownRequested flag and the _tasks vector.
             mongo::mutex _mutex;
 
-            // The condition variable is used to sleep for the interval between task
-            // executions, and is notified when the _shutdownRequested flag is toggled.
+            // The condition variable is used to sleep until the earliest task deadline,
+            // and is notified when the _shutdownRequested flag is toggled.
             boost::condition _cond;
 
             // Used to break the loop. You should notify _cond after changing this to true
@@ -98,7 +110,7 @@ namespace mongo {
             // The PeriodicTasks contained in this vector are NOT owned by the
             // PeriodicTaskRunner, and are not deleted. The vector never shrinks, removed Tasks
             // have their entry overwritten with NULL.
-            std::vector< PeriodicTask* > _tasks;
+            std::vector< TaskEntry > _tasks;
         };
 
         // We rely here on zero-initialization of 'runnerMutex' to distinguish whether we are
@@ -298,14 +310,26 @@ namespace mongo {
 
     void PeriodicTaskRunner::add( PeriodicTask* task ) {
         mutex::scoped_lock lock( _mutex );
-        _tasks.push_back( task );
+
+        TaskEntry entry;
+        entry.task = task;
+
+        // The first deadline carries a clock-derived jitter of up to a tenth of the
+        // period, so that a fleet of processes started in the same instant does not
+        // issue its first round of background work in lockstep.  Tasks registered
+        // within one process receive similar offsets and therefore tend to share
+        // wakeups from the start.
+        const unsigned long long period = _periodFor( task );
+        entry.nextDueMillis = curTimeMillis64() + period + curTimeMicros64() % ( period / 10 + 1 );
+
+        _tasks.push_back( entry );
     }
 
     void PeriodicTaskRunner::remove( PeriodicTask* task ) {
         mutex::scoped_lock lock( _mutex );
         for ( size_t i = 0; i != _tasks.size(); i++ ) {
-            if ( _tasks[i] == task ) {
-                _tasks[i] = NULL;
+            if ( _tasks[i].task == task ) {
+                _tasks[i].task = NULL;
                 break;
             }
         }
@@ -326,17 +350,37 @@ namespace mongo {
     }
 
     void PeriodicTaskRunner::run() {
-        // Use a shorter cycle time in debug mode to help catch race conditions.
-        const size_t waitMillis = (debug ? 5 : 60) * 1000;
+        // Cap on how long to sleep when no deadline falls sooner. Use a shorter cycle
+        // time in debug mode to help catch race conditions.
+        const unsigned long long maxWaitMillis = (debug ? 5 : 60) * 1000;
 
         const stdx::function<bool()> predicate =
             stdx::bind( &PeriodicTaskRunner::_isShutdownRequested, this );
 
         mutex::scoped_lock lock( _mutex );
         while ( !predicate() ) {
-            const boost::xtime deadline = incxtimemillis( waitMillis );
-            if ( !_cond.timed_wait( lock.boost(), deadline, predicate ) )
-                _runTasks();
+
+            // Sleep until the earliest registered deadline rather than on a fixed tick,
+            // so the thread only wakes when some task is actually due.
+            unsigned long long waitMillis = maxWaitMillis;
+            const unsigned long long now = curTimeMillis64();
+            for ( size_t i = 0; i != _tasks.size(); i++ ) {
+                if ( !_tasks[i].task )
+                    continue;
+                const unsigned long long wait =
+                    _tasks[i].nextDueMillis > now ? _tasks[i].nextDueMillis - now : 0;
+                if ( wait < waitMillis )
+                    waitMillis = wait;
+            }
+
+            if ( waitMillis > 0 ) {
+                const boost::xtime deadline =
+                    incxtimemillis( static_cast<long long>( waitMillis ) );
+                if ( _cond.timed_wait( lock.boost(), deadline, predicate ) )
+                    break;
+            }
+
+            _runDueTasks();
         }
     }
 
@@ -344,11 +388,31 @@ namespace mongo {
         return _shutdownRequested;
     }
 
-    void PeriodicTaskRunner::_runTasks() {
+    void PeriodicTaskRunner::_runDueTasks() {
+        const unsigned long long now = curTimeMillis64();
+
         const size_t size = _tasks.size();
-        for ( size_t i = 0; i != size; ++i )
-            if ( PeriodicTask* const task = _tasks[i] )
-                _runTask(task);
+        for ( size_t i = 0; i != size; ++i ) {
+            TaskEntry& entry = _tasks[i];
+            if ( !entry.task )
+                continue;
+
+            // Coalesce deadlines: anything due within a tenth of its period of this
+            // wakeup runs now instead of forcing a wakeup of its own shortly after.
+            const unsigned long long period = _periodFor( entry.task );
+            if ( entry.nextDueMillis <= now + period / 10 ) {
+                _runTask( entry.task );
+
+                // Schedule off the wakeup time rather than the completion time, so
+                // tasks that ran together stay in phase and keep sharing wakeups.
+                entry.nextDueMillis = now + period;
+            }
+        }
+    }
+
+    unsigned long long PeriodicTaskRunner::_periodFor( const PeriodicTask* task ) {
+        const int period = task->taskPeriodMillis();
+        return period > 1 ? static_cast<unsigned long long>( period ) : 1;
     }
 
     void PeriodicTaskRunner::_runTask(PeriodicTask* const task) {
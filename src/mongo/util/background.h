@@ -133,7 +133,7 @@ namespace mongo {
     };
 
     /**
-     * these run "roughly" every minute
+     * these run "roughly" every taskPeriodMillis(), on one shared background thread
      * instantiate statically
      * class MyTask : public PeriodicTask {
      * public:
@@ -149,6 +149,15 @@ namespace mongo {
         virtual void taskDoWork() = 0;
         virtual std::string taskName() const = 0;
 
+        /**
+         * How often taskDoWork() should be invoked, in milliseconds.  The runner sleeps
+         * until the earliest registered deadline and then also runs every other task due
+         * within a tenth of its period of that wakeup, so that tasks with nearby
+         * deadlines share one wakeup instead of each producing their own.  The period is
+         * therefore honored roughly, not exactly.
+         */
+        virtual int taskPeriodMillis() const { return 60 * 1000; }
+
         /**
          *  Starts the BackgroundJob that runs PeriodicTasks. You may call this multiple times,
          *  from multiple threads, and the BackgroundJob will be started only once. Please note
@@ -0,0 +1,141 @@
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects
+*    for all of the code used other than as permitted herein. If you modify
+*    file(s) with this exception, you may extend this exception to your
+*    version of the file(s), but you are not obligated to do so. If you do not
+*    wish to do so, delete this exception statement from your version. If you
+*    delete this exception statement from all source files in the program,
+*    then also delete it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/big_reader_lock.h"
+
+#include <boost/thread/thread.hpp>
+
+#include "mongo/platform/compiler.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+    namespace {
+
+        // Every thread gets one process-wide slot number on first use, shared by all
+        // BigReaderLock instances, so we burn a single TLS key no matter how many
+        // locks exist.
+        AtomicUInt32 nextThreadSlot;
+        ThreadLocalValue<unsigned> threadSlot; // slot number + 1; 0 means unassigned
+
+        unsigned mySlotNumber() {
+            unsigned n = threadSlot.get();
+            if (MONGO_unlikely(n == 0)) {
+                n = nextThreadSlot.fetchAndAdd(1) + 1;
+                threadSlot.set(n);
+            }
+            return n - 1;
+        }
+
+        unsigned slotCount() {
+            // one slot per core, up to a cap; power of two so lookup is a mask
+            unsigned cores = boost::thread::hardware_concurrency();
+            unsigned n = 1;
+            while (n < cores && n < 64) {
+                n *= 2;
+            }
+            return n;
+        }
+    }
+
+    BigReaderLock::BigReaderLock(const StringData& name)
+        : name(name.toString()),
+          _slotMask(slotCount() - 1),
+          _slots(new Slot[_slotMask + 1]),
+          _writerActive(0),
+          _writerMutex("BigReaderLock"),
+          _readerWaitMutex("BigReaderLock") {
+
+        for (unsigned i = 0; i <= _slotMask; i++) {
+            _slots[i].readers.store(0);
+        }
+    }
+
+    BigReaderLock::~BigReaderLock() {
+    }
+
+    BigReaderLock::Slot* BigReaderLock::_slot() {
+        return &_slots[mySlotNumber() & _slotMask];
+    }
+
+    void BigReaderLock::lock_shared() {
+        Slot* slot = _slot();
+        while (true) {
+            slot->readers.addAndFetch(1);
+            if (MONGO_likely(_writerActive.load() == 0)) {
+                // fast path: we only touched our own slot's cache line
+                return;
+            }
+
+            // a writer is active or sweeping; get out of its way and park
+            slot->readers.subtractAndFetch(1);
+
+            scoped_lock lk(_readerWaitMutex);
+            while (_writerActive.load()) {
+                _noWriter.wait(lk.boost());
+            }
+        }
+    }
+
+    void BigReaderLock::unlock_shared() {
+        _slot()->readers.subtractAndFetch(1);
+    }
+
+    void BigReaderLock::lock() {
+        _writerMutex.lock();
+        _writerActive.store(1);
+
+        // New readers now back off, so each slot only has to drain. Read sections
+        // under this lock are expected to be short, so spin with a light backoff
+        // rather than making unlock_shared pay for a notify.
+        for (unsigned i = 0; i <= _slotMask; i++) {
+            int tries = 0;
+            while (_slots[i].readers.load() > 0) {
+                if (++tries < 100) {
+                    boost::this_thread::yield();
+                }
+                else {
+                    sleepmicros(100);
+                }
+            }
+        }
+    }
+
+    void BigReaderLock::unlock() {
+        _writerActive.store(0);
+        {
+            scoped_lock lk(_readerWaitMutex);
+            _noWriter.notify_all();
+        }
+        _writerMutex.unlock();
+    }
+
+}
@@ -0,0 +1,99 @@
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects
+*    for all of the code used other than as permitted herein. If you modify
+*    file(s) with this exception, you may extend this exception to your
+*    version of the file(s), but you are not obligated to do so. If you do not
+*    wish to do so, delete this exception statement from your version. If you
+*    delete this exception statement from all source files in the program,
+*    then also delete it in the license file.
+*/
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/condition.hpp>
+
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/mutex.h"
+
+namespace mongo {
+
+    /**
+     * Reader-optimized rwlock (a "big reader" lock) for structures that are read on
+     * every operation but written rarely, such as the registry of open databases.
+     *
+     * Each thread counts its shared holds in one of a set of cache-line padded slots,
+     * so concurrent readers on different cores never touch a common cache line.
+     * Writers pay for that: lock() raises a flag and then sweeps every slot, waiting
+     * for the readers to drain. Use SimpleRWLock instead whenever writes are not rare.
+     *
+     * Shared acquisition is not reentrant once a writer is queued: a thread that
+     * already holds the lock shared and reacquires it can deadlock with the waiting
+     * writer. Keep read sections flat.
+     */
+    class BigReaderLock : boost::noncopyable {
+    public:
+        explicit BigReaderLock(const StringData& name = "");
+        ~BigReaderLock();
+
+        void lock();
+        void unlock();
+        void lock_shared();
+        void unlock_shared();
+
+        const std::string name;
+
+        class Shared : boost::noncopyable {
+            BigReaderLock& _r;
+        public:
+            Shared(BigReaderLock& rwlock) : _r(rwlock) { _r.lock_shared(); }
+            ~Shared() { _r.unlock_shared(); }
+        };
+        class Exclusive : boost::noncopyable {
+            BigReaderLock& _r;
+        public:
+            Exclusive(BigReaderLock& rwlock) : _r(rwlock) { _r.lock(); }
+            ~Exclusive() { _r.unlock(); }
+        };
+
+    private:
+        // One counter per slot, padded so each slot owns a cache line.
+        struct Slot {
+            AtomicWord<int> readers;
+            char _padding[64 - sizeof(AtomicWord<int>)];
+        };
+
+        Slot* _slot(); // the calling thread's slot; stable for the thread's lifetime
+
+        const unsigned _slotMask; // _numSlots - 1; slot count is a power of two
+        boost::scoped_array<Slot> _slots;
+
+        AtomicWord<int> _writerActive;
+        SimpleMutex _writerMutex; // serializes writers; held from lock() to unlock()
+
+        // readers that lost to an active writer park here until unlock()
+        mongo::mutex _readerWaitMutex;
+        boost::condition _noWriter;
+    };
+
+}
@@ -0,0 +1,107 @@
+// counter_slab.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/util/concurrency/counter_slab.h"
+
+#include <boost/thread/thread.hpp>
+
+#include "mongo/platform/compiler.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+
+    namespace {
+
+        const int kCacheLineBytes = 64;
+        const int kCellsPerCacheLine = kCacheLineBytes / sizeof(AtomicInt64);
+
+        // Every thread gets one process-wide stripe number on first use, shared by all
+        // CounterSlab instances, so we burn a single TLS key no matter how many slabs
+        // exist.
+        AtomicUInt32 nextThreadStripe;
+        ThreadLocalValue<unsigned> threadStripe; // stripe number + 1; 0 means unassigned
+
+        unsigned myStripeNumber() {
+            unsigned n = threadStripe.get();
+            if (MONGO_unlikely(n == 0)) {
+                n = nextThreadStripe.fetchAndAdd(1) + 1;
+                threadStripe.set(n);
+            }
+            return n - 1;
+        }
+
+        unsigned stripeCount() {
+            // one stripe per core, up to a cap; power of two so lookup is a mask
+            unsigned cores = boost::thread::hardware_concurrency();
+            unsigned n = 1;
+            while (n < cores && n < 64) {
+                n *= 2;
+            }
+            return n;
+        }
+
+    }  // namespace
+
+    CounterSlab::CounterSlab( int numCounters )
+        : _numCounters( numCounters ),
+          _stripeMask( stripeCount() - 1 ) {
+        invariant( numCounters > 0 );
+
+        // Round each stripe up to whole cache lines so stripes never share one.
+        _stride = ( numCounters + kCellsPerCacheLine - 1 ) / kCellsPerCacheLine
+                  * kCellsPerCacheLine;
+        _cells.reset( new AtomicInt64[( _stripeMask + 1 ) * _stride] );
+    }
+
+    void CounterSlab::increment( int counter, long long by ) {
+        dassert( counter >= 0 && counter < _numCounters );
+        const unsigned stripe = myStripeNumber() & _stripeMask;
+        _cells[stripe * _stride + counter].fetchAndAdd( by );
+    }
+
+    long long CounterSlab::sum( int counter ) const {
+        dassert( counter >= 0 && counter < _numCounters );
+        long long total = 0;
+        for ( unsigned stripe = 0; stripe <= _stripeMask; stripe++ ) {
+            total += _cells[stripe * _stride + counter].load();
+        }
+        return total;
+    }
+
+    void CounterSlab::reset() {
+        for ( unsigned stripe = 0; stripe <= _stripeMask; stripe++ ) {
+            for ( int counter = 0; counter < _numCounters; counter++ ) {
+                _cells[stripe * _stride + counter].store( 0 );
+            }
+        }
+    }
+
+}  // namespace mongo
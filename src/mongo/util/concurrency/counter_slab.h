@@ -0,0 +1,81 @@
+// counter_slab.h
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <boost/scoped_array.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+    /**
+     * Slab of 64-bit counters striped across cache-line-sized cells, for counters that
+     * are bumped on every operation but only read by reporting paths.
+     *
+     * A single shared atomic becomes a cache-line contention multiplier at high op
+     * rates; here each thread is assigned (round robin, on first use) to one of a small
+     * power-of-two number of stripes sized to the core count, and increments only touch
+     * that stripe's cells.  Reads sum across all stripes lazily, so they cost a short
+     * walk but the hot path never bounces a shared line between cores.
+     *
+     * reset() is not atomic with respect to concurrent increments; an increment racing
+     * with a reset may survive it or be lost.  It exists for wrap protection, where
+     * exactness does not matter.
+     */
+    class CounterSlab {
+        MONGO_DISALLOW_COPYING(CounterSlab);
+    public:
+        explicit CounterSlab( int numCounters );
+
+        /**
+         * Adds "by" to the given counter in the calling thread's stripe.
+         */
+        void increment( int counter, long long by = 1 );
+
+        /**
+         * Returns the given counter's total across all stripes.
+         */
+        long long sum( int counter ) const;
+
+        /**
+         * Sets every cell back to zero.  See the class comment about racing increments.
+         */
+        void reset();
+
+    private:
+        const int _numCounters;
+        unsigned _stripeMask;  // stripe count - 1; stripe count is a power of two
+        int _stride;           // cells per stripe, padded out to whole cache lines
+        boost::scoped_array<AtomicInt64> _cells;
+    };
+
+}  // namespace mongo
@@ -0,0 +1,86 @@
+// counter_slab_test.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include <boost/thread/thread.hpp>
+#include <vector>
+
+#include "mongo/stdx/functional.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/counter_slab.h"
+
+namespace {
+
+    using mongo::CounterSlab;
+
+    void hammer( CounterSlab* slab, int increments ) {
+        for ( int i = 0; i < increments; i++ ) {
+            slab->increment( 0 );
+            slab->increment( 1, 3 );
+        }
+    }
+
+    TEST(CounterSlabTest, SingleThreadedSums) {
+        CounterSlab slab( 3 );
+        ASSERT_EQUALS( 0, slab.sum( 0 ) );
+
+        slab.increment( 0 );
+        slab.increment( 0 );
+        slab.increment( 2, 40 );
+
+        ASSERT_EQUALS( 2, slab.sum( 0 ) );
+        ASSERT_EQUALS( 0, slab.sum( 1 ) );
+        ASSERT_EQUALS( 40, slab.sum( 2 ) );
+
+        slab.reset();
+        ASSERT_EQUALS( 0, slab.sum( 0 ) );
+        ASSERT_EQUALS( 0, slab.sum( 2 ) );
+    }
+
+    TEST(CounterSlabTest, ConcurrentIncrementsAreNotLost) {
+        const int kThreads = 8;
+        const int kIncrements = 10000;
+
+        CounterSlab slab( 2 );
+
+        std::vector<boost::thread*> threads;
+        for ( int i = 0; i < kThreads; i++ ) {
+            threads.push_back(
+                new boost::thread( mongo::stdx::bind( &hammer, &slab, kIncrements ) ) );
+        }
+        for ( int i = 0; i < kThreads; i++ ) {
+            threads[i]->join();
+            delete threads[i];
+        }
+
+        ASSERT_EQUALS( static_cast<long long>( kThreads ) * kIncrements, slab.sum( 0 ) );
+        ASSERT_EQUALS( static_cast<long long>( kThreads ) * kIncrements * 3, slab.sum( 1 ) );
+    }
+
+}  // namespace
@@ -34,12 +34,71 @@
 
 #include "mongo/util/concurrency/spin_lock.h"
 
+#include <map>
 #include <time.h>
 
 #include "mongo/bson/inline_decls.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+    namespace {
+
+#if defined(__i386__) || defined(__x86_64__)
+        void pauseCPU() { asm volatile ( "pause" ); }
+#else
+        void pauseCPU() { }
+#endif
+
+        // Longest single sleep while parked on a contended lock. Sleeps grow
+        // exponentially from ~32us up to this: a fixed long sleep punishes moderate
+        // contention, immediate retries burn CPU.
+        const long long maxParkNanos = 1000 * 1000;
+
+        // Leaked on purpose: SpinLocks (and thus their stats buckets) are touched
+        // from static destructors at shutdown.
+        SimpleMutex* statsRegistryMutex = NULL;
+        typedef std::map<std::string, SpinLockStats*> StatsRegistry;
+        StatsRegistry* statsRegistry = NULL;
+    }
+
+    SpinLockStats::SpinLockStats(const std::string& name)
+        : _name(name) {
+    }
+
+    SpinLockStats* SpinLockStats::get(const char* name) {
+        if (statsRegistryMutex == NULL) {
+            // only reached during single-threaded static initialization
+            statsRegistryMutex = new SimpleMutex("SpinLockStats");
+            statsRegistry = new StatsRegistry();
+        }
+
+        SimpleMutex::scoped_lock lk(*statsRegistryMutex);
+        StatsRegistry::const_iterator it = statsRegistry->find(name);
+        if (it != statsRegistry->end())
+            return it->second;
+
+        SpinLockStats* stats = new SpinLockStats(name);
+        (*statsRegistry)[name] = stats;
+        return stats;
+    }
+
+    void SpinLockStats::appendAll(std::vector<Snapshot>* out) {
+        if (statsRegistryMutex == NULL)
+            return;
+
+        SimpleMutex::scoped_lock lk(*statsRegistryMutex);
+        for (StatsRegistry::const_iterator it = statsRegistry->begin();
+                it != statsRegistry->end();
+                ++it) {
+            Snapshot s;
+            s.name = it->first;
+            s.contentions = it->second->_contentions.load();
+            s.waitMicros = it->second->_waitMicros.load();
+            out->push_back(s);
+        }
+    }
+
     SpinLock::~SpinLock() {
 #if defined(_WIN32)
         DeleteCriticalSection(&_cs);
@@ -48,15 +107,28 @@ namespace mongo {
 #endif
     }
 
-    SpinLock::SpinLock()
+    SpinLock::SpinLock() : _stats( NULL )
 #if defined(_WIN32)
     { InitializeCriticalSectionAndSpinCount(&_cs, 4000); }
 #elif defined(__USE_XOPEN2K)
     { pthread_spin_init( &_lock , 0 ); }
 #elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
-    : _locked( false ) { }
+    , _locked( false ) { }
 #else
-    : _mutex( "SpinLock" ) { }
+    , _mutex( "SpinLock" ) { }
+#endif
+
+    // Telemetry is only recorded on platforms where we control the slow path; the
+    // Windows CRITICAL_SECTION and fallback mutex variants ignore the bucket.
+    SpinLock::SpinLock(const char* name) : _stats( SpinLockStats::get(name) )
+#if defined(_WIN32)
+    { InitializeCriticalSectionAndSpinCount(&_cs, 4000); }
+#elif defined(__USE_XOPEN2K)
+    { pthread_spin_init( &_lock , 0 ); }
+#elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+    , _locked( false ) { }
+#else
+    , _mutex( "SpinLock" ) { }
 #endif
 
 #if defined(__USE_XOPEN2K)
@@ -64,32 +136,44 @@ namespace mongo {
         /**
          * this is designed to perform close to the default spin lock
          * the reason for the mild insanity is to prevent horrible performance
-         * when contention spikes 
+         * when contention spikes
          * it allows spinlocks to be used in many more places
          * which is good because even with this change they are about 8x faster on linux
          */
-        
-        for ( int i=0; i<1000; i++ ) {            
-            if ( pthread_spin_trylock( &_lock ) == 0 )
+
+        Timer timer; // only read when this lock records telemetry
+
+        for ( int i=0; i<1000; i++ ) {
+            if ( pthread_spin_trylock( &_lock ) == 0 ) {
+                if ( _stats )
+                    _stats->recordContention( timer.micros() );
                 return;
-#if defined(__i386__) || defined(__x86_64__)
-            asm volatile ( "pause" ) ; // maybe trylock does this; just in case.
-#endif
+            }
+            pauseCPU(); // maybe trylock does this; just in case.
         }
 
         for ( int i=0; i<1000; i++ ) {
-            if ( pthread_spin_trylock( &_lock ) == 0 )
+            if ( pthread_spin_trylock( &_lock ) == 0 ) {
+                if ( _stats )
+                    _stats->recordContention( timer.micros() );
                 return;
+            }
             pthread_yield();
         }
-        
-        struct timespec t;
-        t.tv_sec = 0;
-        t.tv_nsec = 5000000;
 
+        // park, sleeping exponentially longer up to the cap
+        long long nanos = 32 * 1000;
         while ( pthread_spin_trylock( &_lock ) != 0 ) {
+            struct timespec t;
+            t.tv_sec = 0;
+            t.tv_nsec = nanos;
             nanosleep(&t, NULL);
+            if ( nanos < maxParkNanos )
+                nanos *= 2;
         }
+
+        if ( _stats )
+            _stats->recordContention( timer.micros() );
     }
 #elif defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
     void SpinLock::lock() {
@@ -99,21 +183,36 @@ namespace mongo {
             return;
         }
 
-        // wait for lock
+        Timer timer; // only read when this lock records telemetry
+
+        // spin on the cached value, pausing between reads, and only retry the
+        // atomic once the lock looks free - keeps the line shared while we wait
         int wait = 1000;
-        while ((wait-- > 0) && (_locked)) {
-#if defined(__i386__) || defined(__x86_64__)
-            asm volatile ( "pause" ) ;
-#endif
+        while (wait-- > 0) {
+            if (_locked) {
+                pauseCPU();
+                continue;
+            }
+            if (!__sync_lock_test_and_set(&_locked, true)) {
+                if (_stats)
+                    _stats->recordContention(timer.micros());
+                return;
+            }
         }
 
-        // if failed to grab lock, sleep
-        struct timespec t;
-        t.tv_sec = 0;
-        t.tv_nsec = 5000000;
-        while (__sync_lock_test_and_set(&_locked, true)) {
+        // park, sleeping exponentially longer up to the cap
+        long long nanos = 32 * 1000;
+        while (_locked || __sync_lock_test_and_set(&_locked, true)) {
+            struct timespec t;
+            t.tv_sec = 0;
+            t.tv_nsec = nanos;
             nanosleep(&t, NULL);
+            if (nanos < maxParkNanos)
+                nanos *= 2;
         }
+
+        if (_stats)
+            _stats->recordContention(timer.micros());
     }
 #endif
 
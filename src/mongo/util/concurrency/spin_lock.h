@@ -34,12 +34,50 @@
 #include "mongo/platform/windows_basic.h"
 #endif
 
+#include <string>
+#include <vector>
+
 #include <boost/noncopyable.hpp>
 
+#include "mongo/platform/atomic_word.h"
+
 #include "mutex.h"
 
 namespace mongo {
 
+    /**
+     * Contention counters aggregated over all SpinLocks constructed with the same
+     * name. Buckets are created on first use and never destroyed, so recording is a
+     * couple of relaxed atomic adds on the contended path only; the uncontended fast
+     * path is untouched. Published through the spinLocks serverStatus section.
+     */
+    class SpinLockStats : boost::noncopyable {
+    public:
+        struct Snapshot {
+            std::string name;
+            unsigned long long contentions;
+            unsigned long long waitMicros;
+        };
+
+        /** find-or-create the bucket for a name; never returns NULL */
+        static SpinLockStats* get(const char* name);
+
+        /** copies out all buckets, for reporting */
+        static void appendAll(std::vector<Snapshot>* out);
+
+        void recordContention(long long micros) {
+            _contentions.fetchAndAdd(1);
+            _waitMicros.fetchAndAdd(micros);
+        }
+
+    private:
+        explicit SpinLockStats(const std::string& name);
+
+        const std::string _name;
+        AtomicUInt64 _contentions; // times the slow path was entered
+        AtomicUInt64 _waitMicros;  // total time burned in the slow path
+    };
+
     /**
      * The spinlock currently requires late GCC support routines to be efficient.
      * Other platforms default to a mutex implemenation.
@@ -47,11 +85,20 @@ namespace mongo {
     class SpinLock : boost::noncopyable {
     public:
         SpinLock();
+
+        /**
+         * Named locks record contention telemetry, aggregated with every other
+         * SpinLock carrying the same name (many are per-document or per-client
+         * instances of the same callsite).
+         */
+        explicit SpinLock(const char* name);
+
         ~SpinLock();
 
         static bool isfast(); // true if a real spinlock on this platform
 
     private:
+        SpinLockStats* _stats; // NULL for unnamed locks
 #if defined(_WIN32)
         CRITICAL_SECTION _cs;
     public:
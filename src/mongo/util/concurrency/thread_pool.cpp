@@ -37,52 +37,94 @@
 
 #include "mongo/util/concurrency/thread_pool.h"
 
+#include <algorithm>
+#include <deque>
+
 #include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/thread/thread.hpp>
 
-#include "mongo/util/concurrency/mvar.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
     namespace threadpool {
 
-        // Worker thread
+        // Worker thread with its own task deque. The owning thread takes work from the
+        // front; thieves take it from the back, so a stolen task is the one that has
+        // been queued the longest and the least likely to be cache-warm here.
         class Worker : boost::noncopyable {
         public:
-            explicit Worker(ThreadPool& owner, const std::string& threadName)
+            Worker(ThreadPool& owner, unsigned index, const std::string& threadName)
                 : _owner(owner)
-                , _is_done(true)
-                , _thread(stdx::bind(&Worker::loop, this, threadName))
+                , _workerIndex(index)
+                , _queueMutex("ThreadPoolWorker")
+                , _threadName(threadName)
             {}
 
-            // destructor will block until current operation is completed
-            // Acts as a "join" on this thread
+            // destructor will block until the thread exits; shut the pool down first
             ~Worker() {
-                _task.put(Task());
-                _thread.join();
+                if (_thread)
+                    _thread->join();
+            }
+
+            void startThread() {
+                verify(!_thread);
+                _thread.reset(new boost::thread(stdx::bind(&Worker::loop, this)));
+            }
+
+            void push(const Task& task) {
+                verify(task);
+                SimpleMutex::scoped_lock lk(_queueMutex);
+                _queue.push_back(task);
+            }
+
+            void pushBatch(std::vector<Task>::const_iterator begin,
+                           std::vector<Task>::const_iterator end) {
+                SimpleMutex::scoped_lock lk(_queueMutex);
+                for (; begin != end; ++begin) {
+                    verify(*begin);
+                    _queue.push_back(*begin);
+                }
             }
 
-            void set_task(Task& func) {
-                verify(func);
-                verify(_is_done);
-                _is_done = false;
+            bool popFront(Task* task) {
+                SimpleMutex::scoped_lock lk(_queueMutex);
+                if (_queue.empty())
+                    return false;
+                *task = _queue.front();
+                _queue.pop_front();
+                return true;
+            }
 
-                _task.put(func);
+            bool popBack(Task* task) {
+                SimpleMutex::scoped_lock lk(_queueMutex);
+                if (_queue.empty())
+                    return false;
+                *task = _queue.back();
+                _queue.pop_back();
+                return true;
             }
 
         private:
             ThreadPool& _owner;
-            MVar<Task> _task;
-            bool _is_done; // only used for error detection
-            boost::thread _thread;
+            const unsigned _workerIndex;
+            SimpleMutex _queueMutex;
+            std::deque<Task> _queue;
+            const std::string _threadName;
+            boost::scoped_ptr<boost::thread> _thread;
 
-            void loop(const std::string& threadName) {
-                setThreadName(threadName);
+            void loop() {
+                setThreadName(_threadName);
                 while (true) {
-                    Task task = _task.take();
-                    if (!task)
-                        break; // ends the thread
+                    Task task;
+                    if (!popFront(&task) && !_owner._stealTask(_workerIndex, &task)) {
+                        if (!_owner._waitForWork())
+                            break; // pool is shutting down, ends the thread
+                        continue;
+                    }
+
+                    _owner._queuedTasks.subtractAndFetch(1);
 
                     try {
                         task();
@@ -96,92 +138,155 @@ namespace mongo {
                     catch (...) {
                         log() << "Unhandled non-exception in worker thread" << endl;
                     }
-                    _is_done = true;
-                    _owner.task_done(this);
+                    _owner._taskDone();
                 }
             }
         };
 
         ThreadPool::ThreadPool(int nThreads, const std::string& threadNamePrefix)
-            : _mutex("ThreadPool"), _tasksRemaining(0)
-            , _nThreads(nThreads)
+            : _mutex("ThreadPool"), _shutdown(false)
+            , _tasksRemaining(0)
+            , _queuedTasks(0)
+            , _sleepingWorkers(0)
             , _threadNamePrefix(threadNamePrefix) {
+            verify(nThreads > 0);
+            for (int i = 0; i < nThreads; ++i) {
+                const std::string threadName(_threadNamePrefix.empty() ?
+                                                        _threadNamePrefix :
+                                                        str::stream() << _threadNamePrefix << i);
+                _workers.push_back(new Worker(*this, i, threadName));
+            }
             startThreads();
         }
 
         ThreadPool::ThreadPool(const DoNotStartThreadsTag&,
                                int nThreads,
                                const std::string& threadNamePrefix)
-            : _mutex("ThreadPool"), _tasksRemaining(0)
-            , _nThreads(nThreads)
+            : _mutex("ThreadPool"), _shutdown(false)
+            , _tasksRemaining(0)
+            , _queuedTasks(0)
+            , _sleepingWorkers(0)
             , _threadNamePrefix(threadNamePrefix) {
-        }
-
-        void ThreadPool::startThreads() {
-            scoped_lock lock(_mutex);
-            for (int i = 0; i < _nThreads; ++i) {
+            verify(nThreads > 0);
+            for (int i = 0; i < nThreads; ++i) {
                 const std::string threadName(_threadNamePrefix.empty() ?
                                                         _threadNamePrefix :
                                                         str::stream() << _threadNamePrefix << i);
-                Worker* worker = new Worker(*this, threadName);
-                if (_tasks.empty()) {
-                    _freeWorkers.push_front(worker);
-                }
-                else {
-                    worker->set_task(_tasks.front());
-                    _tasks.pop_front();
-                }
+                _workers.push_back(new Worker(*this, i, threadName));
+            }
+        }
+
+        void ThreadPool::startThreads() {
+            for (size_t i = 0; i < _workers.size(); ++i) {
+                _workers[i]->startThread();
             }
         }
 
         ThreadPool::~ThreadPool() {
             join();
 
-            verify(_tasksRemaining == 0);
+            verify(_tasksRemaining.load() == 0);
+
+            {
+                scoped_lock lock(_mutex);
+                _shutdown = true;
+                _workAvailable.notify_all();
+            }
 
-            while(!_freeWorkers.empty()) {
-                delete _freeWorkers.front();
-                _freeWorkers.pop_front();
+            while(!_workers.empty()) {
+                delete _workers.back(); // joins the worker's thread
+                _workers.pop_back();
             }
         }
 
         void ThreadPool::join() {
             scoped_lock lock(_mutex);
-            while(_tasksRemaining) {
+            while(_tasksRemaining.load()) {
                 _condition.wait(lock.boost());
             }
         }
 
         void ThreadPool::schedule(Task task) {
-            scoped_lock lock(_mutex);
+            const unsigned target = _nextWorker.fetchAndAdd(1) % _workers.size();
 
-            _tasksRemaining++;
+            _tasksRemaining.addAndFetch(1);
+            _workers[target]->push(task);
+            _queuedTasks.addAndFetch(1);
 
-            if (!_freeWorkers.empty()) {
-                _freeWorkers.front()->set_task(task);
-                _freeWorkers.pop_front();
-            }
-            else {
-                _tasks.push_back(task);
-            }
+            _notifyWorkAvailable(false);
         }
 
-        // should only be called by a worker from the worker thread
-        void ThreadPool::task_done(Worker* worker) {
-            scoped_lock lock(_mutex);
+        void ThreadPool::scheduleWithAffinity(Task task, int affinityHint) {
+            const unsigned target = static_cast<unsigned>(affinityHint) % _workers.size();
+
+            _tasksRemaining.addAndFetch(1);
+            _workers[target]->push(task);
+            _queuedTasks.addAndFetch(1);
+
+            _notifyWorkAvailable(false);
+        }
+
+        void ThreadPool::scheduleBatch(const std::vector<Task>& tasks) {
+            if (tasks.empty())
+                return;
+
+            const size_t nWorkers = _workers.size();
+            const unsigned start = _nextWorker.fetchAndAdd(tasks.size());
 
-            if (!_tasks.empty()) {
-                worker->set_task(_tasks.front());
-                _tasks.pop_front();
+            _tasksRemaining.addAndFetch(tasks.size());
+
+            // hand each worker one contiguous slice of the batch
+            const size_t perWorker = (tasks.size() + nWorkers - 1) / nWorkers;
+            size_t handedOut = 0;
+            for (size_t i = 0; i < nWorkers && handedOut < tasks.size(); ++i) {
+                const size_t slice = std::min(perWorker, tasks.size() - handedOut);
+                _workers[(start + i) % nWorkers]->pushBatch(tasks.begin() + handedOut,
+                                                            tasks.begin() + handedOut + slice);
+                handedOut += slice;
             }
-            else {
-                _freeWorkers.push_front(worker);
+            _queuedTasks.addAndFetch(tasks.size());
+
+            _notifyWorkAvailable(true);
+        }
+
+        void ThreadPool::_notifyWorkAvailable(bool all) {
+            // Reading the sleeper count without _mutex is safe: a worker increments it
+            // and re-checks _queuedTasks before sleeping, and _queuedTasks was bumped
+            // above, so either we see the sleeper or the sleeper sees our task.
+            if (_sleepingWorkers.load() > 0) {
+                scoped_lock lock(_mutex);
+                if (all)
+                    _workAvailable.notify_all();
+                else
+                    _workAvailable.notify_one();
             }
+        }
 
-            _tasksRemaining--;
+        bool ThreadPool::_stealTask(unsigned thiefIndex, Task* task) {
+            for (size_t i = 1; i < _workers.size(); ++i) {
+                if (_workers[(thiefIndex + i) % _workers.size()]->popBack(task))
+                    return true;
+            }
+            return false;
+        }
 
-            if(_tasksRemaining == 0)
+        // called by a worker when it has finished executing a task
+        void ThreadPool::_taskDone() {
+            if (_tasksRemaining.subtractAndFetch(1) == 0) {
+                scoped_lock lock(_mutex);
                 _condition.notify_all();
+            }
+        }
+
+        // called by a worker that found its own deque empty and nothing to steal
+        bool ThreadPool::_waitForWork() {
+            scoped_lock lock(_mutex);
+            _sleepingWorkers.addAndFetch(1);
+            while (!_shutdown && _queuedTasks.load() == 0) {
+                _workAvailable.wait(lock.boost());
+            }
+            _sleepingWorkers.subtractAndFetch(1);
+            return !_shutdown;
         }
 
     } //namespace threadpool
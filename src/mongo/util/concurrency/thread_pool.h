@@ -29,11 +29,12 @@
 
 #pragma once
 
-#include <list>
+#include <vector>
 
 #include <boost/noncopyable.hpp>
 #include <boost/thread/condition.hpp>
 
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/concurrency/mutex.h"
 
@@ -45,6 +46,10 @@ namespace mongo {
         typedef stdx::function<void(void)> Task; //nullary function or functor
 
         // exported to the mongo namespace
+        //
+        // Each worker owns a deque of tasks. schedule() spreads tasks over the workers
+        // round-robin and a worker that runs dry steals from the back of its peers'
+        // deques, so fine-grained tasks don't serialize on one pool-wide task list.
         class ThreadPool : boost::noncopyable {
         public:
             struct DoNotStartThreadsTag {};
@@ -70,6 +75,15 @@ namespace mongo {
             // task will be copied a few times so make sure it's relatively cheap
             void schedule(Task task);
 
+            // As schedule, but tasks carrying the same hint land on the same worker's
+            // deque, so work touching the same data tends to stay on one thread. Only
+            // a hint - an idle worker may still steal the task.
+            void scheduleWithAffinity(Task task, int affinityHint);
+
+            // Hands out the whole batch with one queue lock per worker instead of one
+            // per task; prefer this when submitting many fine-grained tasks at once.
+            void scheduleBatch(const std::vector<Task>& tasks);
+
             // Helpers that wrap schedule and stdx::bind.
             // Functor and args will be copied a few times so make sure it's relatively cheap
             template<typename F, typename A>
@@ -83,20 +97,27 @@ namespace mongo {
             template<typename F, typename A, typename B, typename C, typename D, typename E>
             void schedule(F f, A a, B b, C c, D d, E e) { schedule(stdx::bind(f,a,b,c,d,e)); }
 
-            int tasks_remaining() { return _tasksRemaining; }
+            int tasks_remaining() { return _tasksRemaining.load(); }
 
         private:
-            mongo::mutex _mutex;
-            boost::condition _condition;
-
-            std::list<Worker*> _freeWorkers; //used as LIFO stack (always front)
-            std::list<Task> _tasks; //used as FIFO queue (push_back, pop_front)
-            int _tasksRemaining; // in queue + currently processing
-            int _nThreads; // only used for sanity checking. could be removed in the future.
+            mongo::mutex _mutex; // guards _shutdown and the condition waits below
+            boost::condition _condition; // notified when _tasksRemaining drops to zero
+            boost::condition _workAvailable;
+            bool _shutdown;
+
+            std::vector<Worker*> _workers;
+            AtomicUInt32 _nextWorker; // round-robin placement cursor for schedule()
+            AtomicWord<int> _tasksRemaining; // in queues + currently processing
+            AtomicWord<int> _queuedTasks; // in queues only; lets producers and idle workers
+                                          // synchronize without taking _mutex
+            AtomicWord<int> _sleepingWorkers;
             const std::string _threadNamePrefix; // used for logging/diagnostics
 
-            // should only be called by a worker from the worker's thread
-            void task_done(Worker* worker);
+            // called by workers from the worker's thread
+            bool _stealTask(unsigned thiefIndex, Task* task);
+            void _taskDone();
+            bool _waitForWork(); // returns false once the pool is shutting down
+            void _notifyWorkAvailable(bool all);
             friend class Worker;
         };
 
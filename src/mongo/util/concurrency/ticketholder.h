@@ -27,6 +27,7 @@
 #pragma once
 
 #include <boost/thread/condition_variable.hpp>
+#include <boost/thread/thread_time.hpp>
 #include <iostream>
 
 #include "mongo/util/concurrency/mutex.h"
@@ -35,30 +36,85 @@ namespace mongo {
 
     class TicketHolder {
     public:
-        TicketHolder( int num ) : _mutex("TicketHolder") {
+        /**
+         * Waiters that must not be starved behind regular traffic (e.g. replication)
+         * acquire at PRIORITY_HIGH: while any high priority waiter is queued, a free
+         * ticket is never handed out at PRIORITY_NORMAL.
+         */
+        enum Priority {
+            PRIORITY_NORMAL,
+            PRIORITY_HIGH
+        };
+
+        TicketHolder( int num ) : _highWaiters(0), _mutex("TicketHolder") {
             _outof = num;
             _num = num;
         }
 
         bool tryAcquire() {
             scoped_lock lk( _mutex );
-            return _tryAcquire();
+            return _tryAcquire( PRIORITY_NORMAL );
         }
 
         void waitForTicket() {
+            waitForTicket( PRIORITY_NORMAL );
+        }
+
+        void waitForTicket( Priority priority ) {
             scoped_lock lk( _mutex );
 
-            while( ! _tryAcquire() ) {
+            if ( priority == PRIORITY_HIGH )
+                _highWaiters++;
+
+            while( ! _tryAcquire( priority ) ) {
                 _newTicket.wait( lk.boost() );
             }
+
+            if ( priority == PRIORITY_HIGH )
+                _exitHighWait();
+        }
+
+        /**
+         * As waitForTicket, but gives up after timeoutMillis and returns false.
+         * Callers operating under a maxTimeMS budget should pass however much of
+         * it they are willing to spend queued here.
+         */
+        bool waitForTicket( Priority priority, int timeoutMillis ) {
+            const boost::system_time deadline =
+                boost::get_system_time() + boost::posix_time::milliseconds( timeoutMillis );
+
+            scoped_lock lk( _mutex );
+
+            if ( priority == PRIORITY_HIGH )
+                _highWaiters++;
+
+            while( ! _tryAcquire( priority ) ) {
+                if ( ! _newTicket.timed_wait( lk.boost(), deadline ) &&
+                     ! _tryAcquire( priority ) ) {
+                    if ( priority == PRIORITY_HIGH )
+                        _exitHighWait();
+                    return false;
+                }
+            }
+
+            if ( priority == PRIORITY_HIGH )
+                _exitHighWait();
+            return true;
         }
 
         void release() {
+            bool haveHighWaiters;
             {
                 scoped_lock lk( _mutex );
                 _num++;
+                haveHighWaiters = _highWaiters > 0;
             }
-            _newTicket.notify_one();
+            // notify_one could wake a normal waiter, which would defer to the high
+            // priority waiter and go back to sleep without passing the wakeup on
+            if ( haveHighWaiters )
+                _newTicket.notify_all();
+            else
+                _newTicket.notify_one();
         }
 
         void resize( int newSize ) {
@@ -91,19 +147,31 @@ namespace mongo {
 
     private:
 
-        bool _tryAcquire(){
+        bool _tryAcquire( Priority priority ) {
             if ( _num <= 0 ) {
                 if ( _num < 0 ) {
                     std::cerr << "DISASTER! in TicketHolder" << std::endl;
                 }
                 return false;
             }
+            if ( priority == PRIORITY_NORMAL && _highWaiters > 0 ) {
+                // the ticket is reserved for a high priority waiter
+                return false;
+            }
             _num--;
             return true;
         }
 
+        // Caller must hold _mutex. Normal waiters deferring to us may need a wakeup
+        // once the last high priority waiter leaves.
+        void _exitHighWait() {
+            if ( --_highWaiters == 0 )
+                _newTicket.notify_all();
+        }
+
         int _outof;
         int _num;
+        int _highWaiters;
         mongo::mutex _mutex;
         boost::condition_variable_any _newTicket;
     };
@@ -32,28 +32,26 @@
 
 #include "mongo/util/elapsed_tracker.h"
 
-#include "mongo/util/net/listen.h"
-
 namespace mongo {
 
     ElapsedTracker::ElapsedTracker( int32_t hitsBetweenMarks, int32_t msBetweenMarks ) :
         _hitsBetweenMarks( hitsBetweenMarks ),
         _msBetweenMarks( msBetweenMarks ),
-        _pings( 0 ),
-        _last( Listener::getElapsedTimeMillis() ) {
+        _pings( 0 ) {
     }
 
     bool ElapsedTracker::intervalHasElapsed() {
         if ( ++_pings >= _hitsBetweenMarks ) {
             _pings = 0;
-            _last = Listener::getElapsedTimeMillis();
+            _timer.reset();
             return true;
         }
 
-        long long now = Listener::getElapsedTimeMillis();
-        if ( now - _last > _msBetweenMarks ) {
+        // Timer reads the fast clock (the TSC where available), which is both cheaper and
+        // much finer-grained than the listener's elapsed time estimate this used to poll.
+        if ( _timer.millis() > _msBetweenMarks ) {
             _pings = 0;
-            _last = now;
+            _timer.reset();
             return true;
         }
 
@@ -62,7 +60,7 @@ namespace mongo {
 
     void ElapsedTracker::resetLastTime() {
         _pings = 0;
-        _last = Listener::getElapsedTimeMillis();
+        _timer.reset();
     }
 
 } // namespace mongo
@@ -31,6 +31,7 @@
 #pragma once
 
 #include "mongo/platform/cstdint.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -53,7 +54,7 @@ namespace mongo {
 
         int32_t _pings;
 
-        int64_t _last;
+        Timer _timer;
     };
 
 } // namespace mongo
@@ -37,6 +37,26 @@
 using mongoutils::str::stream;
 
 namespace mongo {
+
+    AtomicUInt32 FailPoint::_numActiveFailPoints;
+
+    namespace {
+        /**
+         * Cheap lock-free generator for the random activation mode.  A shared Weyl
+         * sequence run through an integer mix; contention on the shared word is
+         * acceptable because this only runs while the fail point is active.
+         */
+        AtomicUInt32 randomSequence;
+
+        unsigned nextRandom() {
+            unsigned r = randomSequence.fetchAndAdd(0x9E3779B9U);
+            r ^= r >> 16;
+            r *= 0x85EBCA6BU;
+            r ^= r >> 13;
+            return r;
+        }
+    }
+
     FailPoint::FailPoint():
             _fpInfo(0),
             _mode(off),
@@ -71,6 +91,8 @@ namespace mongo {
         uassert(16442, stream() << "mode not supported " << static_cast<int>(mode),
                 mode >= off && mode < numModes);
 
+        uassert(28701, "period must be positive", mode != random || val >= 1);
+
         _mode = mode;
         _timesOrPeriod.store(val);
 
@@ -96,6 +118,10 @@ namespace mongo {
             newVal = expectedCurrentVal | ACTIVE_BIT;
             currentVal = _fpInfo.compareAndSwap(expectedCurrentVal, newVal);
         } while (expectedCurrentVal != currentVal);
+
+        if ((expectedCurrentVal & ACTIVE_BIT) == 0) {
+            _numActiveFailPoints.fetchAndAdd(1);
+        }
     }
 
     void FailPoint::disableFailPoint() {
@@ -109,6 +135,10 @@ namespace mongo {
             newVal = expectedCurrentVal & REF_COUNTER_MASK;
             currentVal = _fpInfo.compareAndSwap(expectedCurrentVal, newVal);
         } while (expectedCurrentVal != currentVal);
+
+        if ((expectedCurrentVal & ACTIVE_BIT) != 0) {
+            _numActiveFailPoints.subtractAndFetch(1);
+        }
     }
 
     FailPoint::RetCode FailPoint::slowShouldFailOpenBlock() {
@@ -123,9 +153,14 @@ namespace mongo {
             return slowOn;
 
         case random:
-            // TODO: randomly determine if should be active or not
-            error() << "FailPoint Mode random is not yet supported." << endl;
-            fassertFailed(16443);
+        {
+            const unsigned period =
+                static_cast<unsigned>(_timesOrPeriod.load());
+            if (nextRandom() % period == 0) {
+                return slowOn;
+            }
+            return slowOff;
+        }
 
         case nTimes:
         {
@@ -138,6 +173,12 @@ namespace mongo {
             return slowOn;
         }
 
+        case sleepMillis:
+            // Pure latency injection: stall the caller, then report the fail point as
+            // not active so the normal code path continues.
+            sleepmillis(_timesOrPeriod.load());
+            return slowOff;
+
         default:
             error() << "FailPoint Mode not supported: " << static_cast<int>(_mode) << endl;
             fassertFailed(16444);
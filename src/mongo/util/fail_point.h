@@ -68,11 +68,21 @@ namespace mongo {
 
     public:
         typedef AtomicUInt32::WordType ValType;
-        enum Mode { off, alwaysOn, random, nTimes, numModes };
+        enum Mode { off, alwaysOn, random, nTimes, sleepMillis, numModes };
         enum RetCode { fastOff = 0, slowOff, slowOn };
 
         FailPoint();
 
+        /**
+         * @return true if any fail point in the process is currently active.  Read-mostly
+         * and shared by every fail point, so the MONGO_FAIL_POINT macros can gate all of
+         * their per-point checks behind one always-cached line; with no fail points
+         * active, a check site touches no per-point state at all.
+         */
+        static inline bool anyActive() {
+            return _numActiveFailPoints.loadRelaxed() != 0;
+        }
+
         /**
          * Note: This is not side-effect free - it can change the state to OFF after calling.
          *
@@ -119,9 +129,13 @@ namespace mongo {
          * @param val the value that can have different usage depending on the mode:
          *
          *     - off, alwaysOn: ignored
-         *     - random:
+         *     - random: the activation period; each pass on the fail point activates
+         *         with probability 1/val.  Must be at least 1.
          *     - nTimes: the number of times this fail point will be active when
          *         #shouldFail or #shouldFailOpenBlock is called.
+         *     - sleepMillis: the number of milliseconds each pass on the fail point
+         *         sleeps before continuing.  The fail point never reports itself as
+         *         active, so this purely injects latency.
          *
          * @param extra arbitrary BSON object that can be stored to this fail point
          *     that can be referenced afterwards with #getData. Defaults to an empty
@@ -138,6 +152,9 @@ namespace mongo {
         static const ValType ACTIVE_BIT = 1 << 31;
         static const ValType REF_COUNTER_MASK = ~ACTIVE_BIT;
 
+        // Number of fail points in the process whose ACTIVE_BIT is set; backs anyActive().
+        static AtomicUInt32 _numActiveFailPoints;
+
         // Bit layout:
         // 31: tells whether this fail point is active.
         // 0~30: unsigned ref counter for active dynamic instances.
@@ -214,7 +231,8 @@ namespace mongo {
         bool _shouldClose;
     };
 
-    #define MONGO_FAIL_POINT(symbol) MONGO_unlikely(symbol.shouldFail())
+    #define MONGO_FAIL_POINT(symbol) \
+        MONGO_unlikely(::mongo::FailPoint::anyActive() && symbol.shouldFail())
 
     /**
      * Macro for creating a fail point with block context. Also use this when
@@ -222,5 +240,5 @@ namespace mongo {
      */
     #define MONGO_FAIL_POINT_BLOCK(symbol, blockSymbol) \
         for (mongo::ScopedFailPoint blockSymbol(&symbol); \
-            MONGO_unlikely(blockSymbol.isActive()); )
+            MONGO_unlikely(::mongo::FailPoint::anyActive() && blockSymbol.isActive()); )
 }
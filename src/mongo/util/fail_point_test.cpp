@@ -73,6 +73,41 @@ namespace mongo_test {
         }
     }
 
+    TEST(FailPoint, RandomActivatesSometimes) {
+        FailPoint failPoint;
+        failPoint.setMode(FailPoint::random, 2);
+
+        size_t activations = 0;
+        for (size_t x = 0; x < 1000; x++) {
+            if (failPoint.shouldFail()) {
+                activations++;
+            }
+        }
+
+        // Each pass activates with probability 1/2; an all-or-nothing outcome over a
+        // thousand passes means the mode is broken.
+        ASSERT_GREATER_THAN(activations, 0U);
+        ASSERT_LESS_THAN(activations, 1000U);
+    }
+
+    TEST(FailPoint, RandomWithPeriodOneAlwaysActivates) {
+        FailPoint failPoint;
+        failPoint.setMode(FailPoint::random, 1);
+
+        for (size_t x = 0; x < 50; x++) {
+            ASSERT(failPoint.shouldFail());
+        }
+    }
+
+    TEST(FailPoint, SleepMillisNeverReportsActive) {
+        FailPoint failPoint;
+        failPoint.setMode(FailPoint::sleepMillis, 0);
+
+        for (size_t x = 0; x < 50; x++) {
+            ASSERT_FALSE(failPoint.shouldFail());
+        }
+    }
+
     TEST(FailPoint, BlockOff) {
         FailPoint failPoint;
         bool called = false;
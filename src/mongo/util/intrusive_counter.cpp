@@ -34,6 +34,7 @@
 #include "mongo/util/intrusive_counter.h"
 
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/value_arena.h"
 
 namespace mongo {
     using boost::intrusive_ptr;
@@ -47,10 +48,23 @@ namespace mongo {
         const size_t sizeWithNUL = s.size() + 1;
         const size_t bytesNeeded = sizeof(RCString) + sizeWithNUL;
 
+        intrusive_ptr<RCString> ptr;
+        if (ValueArena* arena = ValueArena::current()) {
+            // RCStrings are immutable and trivially destructible, so they can live on
+            // the pipeline's arena with refcounting elided. NULL means the arena is
+            // over budget; fall through to the heap.
+            if (void* storage = arena->allocate(bytesNeeded)) {
+                ptr = new (storage) RCString();
+                ptr->markArenaOwned();
+            }
+        }
+
+        if (!ptr) {
 #pragma warning(push)
 #pragma warning(disable : 4291)
-        intrusive_ptr<RCString> ptr = new (bytesNeeded) RCString(); // uses custom operator new
+            ptr = new (bytesNeeded) RCString(); // uses custom operator new
 #pragma warning(pop)
+        }
 
         ptr->_size = s.size();
         char* stringStart = reinterpret_cast<char*>(ptr.get()) + sizeof(RCString);
@@ -91,10 +91,14 @@ namespace mongo {
         }
 
         friend void intrusive_ptr_add_ref(const RefCountable* ptr) {
+            if (ptr->_count.loadRelaxed() & kArenaOwnedBit)
+                return; // lifetime is managed by a ValueArena, not by refcounts
             ptr->_count.addAndFetch(1);
         };
 
         friend void intrusive_ptr_release(const RefCountable* ptr) {
+            if (ptr->_count.loadRelaxed() & kArenaOwnedBit)
+                return;
             if (ptr->_count.subtractAndFetch(1) == 0) {
                 delete ptr; // uses subclass destructor and operator delete
             }
@@ -104,7 +108,18 @@ namespace mongo {
         RefCountable() {}
         virtual ~RefCountable() {}
 
+        /**
+         * Marks this object as owned by the ValueArena its storage came from, turning
+         * all future refcount operations on it into no-ops. Must be called before the
+         * object is shared. Only valid for objects whose destructor doesn't need to
+         * run (the arena frees raw memory in bulk) and that don't rely on isShared()
+         * for COW, since an arena-owned object always reads as shared.
+         */
+        void markArenaOwned() const { _count.store(kArenaOwnedBit); }
+
     private:
+        static const unsigned kArenaOwnedBit = 1U << 31;
+
         mutable AtomicUInt32 _count; // default initialized to 0
     };
 
@@ -130,6 +145,9 @@ namespace mongo {
         // these can only be created by calling create()
         RCString() {};
         void* operator new (size_t objSize, size_t realSize) { return mongoMalloc(realSize); }
+        // Placement form for arena-backed storage; the class-scope operator new above
+        // hides the global one.
+        void* operator new (size_t objSize, void* ptr) { return ptr; }
 
         int _size; // does NOT include trailing NUL byte.
         // char[_size+1] array allocated past end of class
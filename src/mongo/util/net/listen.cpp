@@ -36,9 +36,12 @@
 
 #include <boost/scoped_array.hpp>
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
 
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/message_port.h"
@@ -77,6 +80,13 @@ namespace mongo {
 
     using boost::shared_ptr;
 
+    // Number of accept threads for listeners that opt in via useAcceptorClones().
+    // Each extra acceptor listens on its own SO_REUSEPORT copy of the TCP sockets,
+    // so the kernel spreads a connection storm across the threads instead of
+    // funneling every handshake through one accept loop. Requires SO_REUSEPORT;
+    // ignored (with a warning) elsewhere.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(listenerAcceptors, int, 1);
+
     // ----- Listener -------
 
     const Listener* Listener::_timeTracker;
@@ -181,6 +191,15 @@ namespace mongo {
                 const int one = 1;
                 if ( setsockopt( sock , SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0 )
                     log() << "Failed to set socket opt, SO_REUSEADDR" << endl;
+
+#if defined(SO_REUSEPORT)
+                // Every socket sharing the port must have SO_REUSEPORT set before
+                // bind, so the primary sockets need it too when clones will follow.
+                if ( listenerAcceptors > 1 && useAcceptorClones() && me.getType() != AF_UNIX ) {
+                    if ( setsockopt( sock , SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0 )
+                        log() << "Failed to set socket opt, SO_REUSEPORT" << endl;
+                }
+#endif
             }
 #endif
 
@@ -217,7 +236,6 @@ namespace mongo {
             return;
         }
 
-        SOCKET maxfd = 0; // needed for select()
         for (unsigned i = 0; i < _socks.size(); i++) {
             if (::listen(_socks[i], 128) != 0) {
                 error() << "listen(): listen() failed " << errnoWithDescription() << endl;
@@ -225,16 +243,6 @@ namespace mongo {
             }
 
             ListeningSockets::get()->add(_socks[i]);
-
-            if (_socks[i] > maxfd) {
-                maxfd = _socks[i];
-            }
-        }
-
-        if ( maxfd >= FD_SETSIZE ) {
-            error() << "socket " << maxfd << " is higher than " << FD_SETSIZE-1 << 
-                "; not supported" << warnings;
-            return;
         }
 
 #ifdef MONGO_SSL
@@ -243,6 +251,21 @@ namespace mongo {
         _logListen(_port, false);
 #endif
 
+        if ( listenerAcceptors > 1 && useAcceptorClones() ) {
+#if defined(SO_REUSEPORT)
+            for ( int i = 1; i < listenerAcceptors; i++ ) {
+                std::vector<SOCKET> clones = _cloneListenSockets();
+                if ( clones.empty() )
+                    break;
+                boost::thread t( stdx::bind( &Listener::_acceptLoop, this, clones, false ) );
+                t.detach();
+            }
+#else
+            warning() << "listenerAcceptors > 1 requires SO_REUSEPORT support; "
+                      << "running a single acceptor" << endl;
+#endif
+        }
+
         {
             // Wake up any threads blocked in waitUntilListening()
             boost::lock_guard<boost::mutex> lock(_readyMutex);
@@ -250,12 +273,82 @@ namespace mongo {
             _readyCondition.notify_all();
         }
 
+        _acceptLoop( _socks, true );
+    }
+
+#if defined(SO_REUSEPORT)
+    std::vector<SOCKET> Listener::_cloneListenSockets() const {
+        std::vector<SOCKET> out;
+
+        for (std::vector<SockAddr>::const_iterator it=_mine.begin(), end=_mine.end();
+             it != end;
+             ++it) {
+
+            const SockAddr& me = *it;
+
+            // A unix socket path cannot be bound a second time; the primary
+            // acceptor keeps serving unix domain connections alone.
+            if (me.getType() == AF_UNIX)
+                continue;
+
+            SOCKET sock = ::socket(me.getType(), SOCK_STREAM, 0);
+            if (sock < 0) {
+                warning() << "listen(): unable to clone listening socket "
+                          << errnoWithDescription() << endl;
+            }
+            else {
+                const int one = 1;
+                if (me.getType() == AF_INET6)
+                    setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, (const char*) &one, sizeof(one));
+                setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+                setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+                if (::bind(sock, me.raw(), me.addressSize) != 0 ||
+                    ::listen(sock, 128) != 0) {
+                    warning() << "listen(): unable to clone listener for " << me.toString()
+                              << " " << errnoWithDescription() << endl;
+                    closesocket(sock);
+                    sock = -1;
+                }
+            }
+
+            if (sock < 0) {
+                for (unsigned i = 0; i < out.size(); i++)
+                    closesocket(out[i]);
+                out.clear();
+                return out;
+            }
+
+            out.push_back(sock);
+        }
+
+        for (unsigned i = 0; i < out.size(); i++)
+            ListeningSockets::get()->add(out[i]);
+
+        return out;
+    }
+#endif
+
+    void Listener::_acceptLoop( std::vector<SOCKET> socks, bool primary ) {
+        SOCKET maxfd = 0; // needed for select()
+        for (unsigned i = 0; i < socks.size(); i++) {
+            if (socks[i] > maxfd) {
+                maxfd = socks[i];
+            }
+        }
+
+        if ( maxfd >= FD_SETSIZE ) {
+            error() << "socket " << maxfd << " is higher than " << FD_SETSIZE-1 <<
+                "; not supported" << warnings;
+            return;
+        }
+
         struct timeval maxSelectTime;
         while ( ! inShutdown() ) {
             fd_set fds[1];
             FD_ZERO(fds);
-            
-            for (vector<SOCKET>::iterator it=_socks.begin(), end=_socks.end(); it != end; ++it) {
+
+            for (vector<SOCKET>::iterator it=socks.begin(), end=socks.end(); it != end; ++it) {
                 FD_SET(*it, fds);
             }
 
@@ -264,11 +357,13 @@ namespace mongo {
             const int ret = select(maxfd+1, fds, NULL, NULL, &maxSelectTime);
 
             if (ret == 0) {
+                if (primary) {
 #if defined(__linux__)
-                _elapsedTime += ( 10000 - maxSelectTime.tv_usec ) / 1000;
+                    _elapsedTime += ( 10000 - maxSelectTime.tv_usec ) / 1000;
 #else
-                _elapsedTime += 10;
+                    _elapsedTime += 10;
 #endif
+                }
                 continue;
             }
 
@@ -285,15 +380,36 @@ namespace mongo {
                 return;
             }
 
+            if (primary) {
 #if defined(__linux__)
-            _elapsedTime += max(ret, (int)(( 10000 - maxSelectTime.tv_usec ) / 1000));
+                _elapsedTime += max(ret, (int)(( 10000 - maxSelectTime.tv_usec ) / 1000));
 #else
-            _elapsedTime += ret; // assume 1ms to grab connection. very rough
+                _elapsedTime += ret; // assume 1ms to grab connection. very rough
 #endif
+            }
 
-            for (vector<SOCKET>::iterator it=_socks.begin(), end=_socks.end(); it != end; ++it) {
+            for (vector<SOCKET>::iterator it=socks.begin(), end=socks.end(); it != end; ++it) {
                 if (! (FD_ISSET(*it, fds)))
                     continue;
+
+#if defined(__linux__)
+                {
+                    // Gauge the kernel accept queue so a storm that outruns the
+                    // acceptors shows up in serverStatus, not just as client side
+                    // connect latency. On a listening socket tcpi_unacked is the
+                    // number of connections waiting to be accepted. Fails (and is
+                    // ignored) for unix domain sockets.
+                    struct tcp_info ti;
+                    socklen_t len = sizeof(ti);
+                    if ( getsockopt( *it, IPPROTO_TCP, TCP_INFO, &ti, &len ) == 0 ) {
+                        const long long depth = ti.tcpi_unacked;
+                        globalAcceptQueueDepth.store( depth );
+                        if ( depth > globalAcceptQueueMaxDepth.load() )
+                            globalAcceptQueueMaxDepth.store( depth );
+                    }
+                }
+#endif
+
                 SockAddr from;
                 int s = accept(*it, from.raw(), &from.addressSize);
                 if ( s < 0 ) {
@@ -425,6 +541,11 @@ namespace mongo {
             _readyCondition.notify_all();
         }
 
+        if ( listenerAcceptors > 1 && useAcceptorClones() ) {
+            warning() << "listenerAcceptors > 1 requires SO_REUSEPORT support; "
+                      << "running a single acceptor" << endl;
+        }
+
         OwnedPointerVector<EventHolder> eventHolders;
         boost::scoped_array<WSAEVENT> events(new WSAEVENT[_socks.size()]);
         
@@ -634,6 +755,8 @@ namespace mongo {
 
     TicketHolder Listener::globalTicketHolder(DEFAULT_MAX_CONN);
     AtomicInt64 Listener::globalConnectionNumber;
+    AtomicInt64 Listener::globalAcceptQueueDepth;
+    AtomicInt64 Listener::globalAcceptQueueMaxDepth;
 
     void ListeningSockets::closeAll() {
         std::set<int>* sockets;
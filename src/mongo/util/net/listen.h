@@ -106,6 +106,22 @@ namespace mongo {
         void waitUntilListening() const;
 
     private:
+        /**
+         * Accept connections on 'socks' until shutdown. Runs on the initAndListen thread
+         * for the primary socket set and on one extra thread per SO_REUSEPORT clone set.
+         * Only the primary loop advances _elapsedTime.
+         */
+        void _acceptLoop( std::vector<SOCKET> socks, bool primary );
+
+        /**
+         * Binds and listens on a fresh SO_REUSEPORT copy of each of this listener's TCP
+         * addresses, so the kernel spreads incoming connections between the clones and
+         * the primary sockets. Unix domain sockets are skipped (a path cannot be bound
+         * twice). Returns an empty vector, closing any partial work, on failure. Only
+         * defined on platforms with SO_REUSEPORT.
+         */
+        std::vector<SOCKET> _cloneListenSockets() const;
+
         std::vector<SockAddr> _mine;
         std::vector<SOCKET> _socks;
         std::string _name;
@@ -125,9 +141,16 @@ namespace mongo {
         void _logListen( int port , bool ssl );
 
         static const Listener* _timeTracker;
-        
+
         virtual bool useUnixSockets() const { return false; }
 
+        /**
+         * Whether this listener may spread accepts over listenerAcceptors threads on
+         * SO_REUSEPORT-cloned sockets. Off by default: subclasses whose accepted()
+         * callback is safe to run from several threads at once opt in.
+         */
+        virtual bool useAcceptorClones() const { return false; }
+
     public:
         /** the "next" connection number.  every connection to this process has a unique number */
         static AtomicInt64 globalConnectionNumber;
@@ -135,6 +158,11 @@ namespace mongo {
         /** keeps track of how many allowed connections there are and how many are being used*/
         static TicketHolder globalTicketHolder;
 
+        /** kernel accept-queue depth as last sampled by an acceptor, and its high water
+            mark since startup. Zero on platforms where the queue cannot be observed. */
+        static AtomicInt64 globalAcceptQueueDepth;
+        static AtomicInt64 globalAcceptQueueMaxDepth;
+
         /** makes sure user input is sane */
         static void checkTicketNumbers();
     };
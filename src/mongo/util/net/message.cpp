@@ -72,5 +72,31 @@ namespace mongo {
         return op == dbQuery || op == dbGetMore;
     }
 
+    SharedBuffer MessageBufferPool::acquire(size_t bytes) {
+        if (bytes > kMaxPooledBytes)
+            return SharedBuffer::allocate(bytes);
+
+        int sizeClass = 0;
+        size_t classBytes = kMinClassBytes;
+        while (classBytes < bytes) {
+            classBytes <<= 1;
+            sizeClass++;
+        }
+
+        for (int i = 0; i < kBuffersPerClass; i++) {
+            SharedBuffer& slot = _slots[sizeClass][i];
+            if (!slot.get()) {
+                slot = SharedBuffer::allocate(classBytes);
+                return slot;
+            }
+            if (slot.unique())
+                return slot;
+        }
+
+        // All pooled buffers of this size are still referenced (e.g. by a stashed
+        // reply), so this one isn't retained.
+        return SharedBuffer::allocate(classBytes);
+    }
+
 
 } // namespace mongo
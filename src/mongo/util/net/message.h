@@ -34,11 +34,13 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/cstdint.h"
 #include "mongo/base/data_view.h"
+#include "mongo/base/disallow_copying.h"
 #include "mongo/base/encoded_value_storage.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/net/sock.h"
+#include "mongo/util/shared_buffer.h"
 #include "mongo/util/print.h"
 
 namespace mongo {
@@ -400,6 +402,9 @@ namespace mongo {
             if ( r._data.size() > 0 ) {
                 _data.swap( r._data );
             }
+            if ( r._adopted.size() > 0 ) {
+                _adopted.swap( r._adopted );
+            }
             r._freeIt = false;
             _freeIt = true;
             return *this;
@@ -407,16 +412,18 @@ namespace mongo {
 
         void reset() {
             if ( _freeIt ) {
-                if ( _buf ) {
+                if ( _buf && !_isAdopted( _buf ) ) {
                     free( _buf );
                 }
                 for (std::vector< std::pair< char *, int > >::const_iterator i = _data.begin();
                      i != _data.end(); ++i) {
-                    free(i->first);
+                    if ( !_isAdopted( i->first ) )
+                        free(i->first);
                 }
             }
             _buf = 0;
             _data.clear();
+            _adopted.clear();
             _freeIt = false;
         }
 
@@ -441,11 +448,33 @@ namespace mongo {
             header().setLen(header().getLen() + size);
         }
 
+        // use to add a buffer the message shares ownership of, rather than copying it or
+        // taking over freeing it.  The payload must start at buf.get().  This lets a finished,
+        // owned BSONObj's buffer be spliced into an outgoing message with no memcpy; the
+        // message keeps its reference until reset().  The message must already have a first
+        // (header) buffer.
+        void appendSharedData(SharedBuffer buf, int size) {
+            verify( !empty() );
+            char* d = buf.get();
+            _adopted.push_back( buf.moveFrom() );
+            appendData( d, size );
+        }
+
         // use to set first buffer if empty
         void setData(char* d, bool freeIt) {
             verify( empty() );
             _setData( d, freeIt );
         }
+
+        // use to set first buffer if empty, sharing ownership with the caller rather
+        // than taking over freeing it. The buffer must contain a full MsgData starting
+        // at buf.get().
+        void setSharedData(SharedBuffer buf) {
+            verify( empty() );
+            char* d = buf.get();
+            _adopted.push_back( buf.moveFrom() );
+            _setData( d, true );
+        }
         void setData(int operation, const char *msgtxt) {
             setData(operation, msgtxt, strlen(msgtxt)+1);
         }
@@ -472,15 +501,53 @@ namespace mongo {
             _freeIt = freeIt;
             _buf = d;
         }
+        bool _isAdopted( const char* p ) const {
+            for ( size_t i = 0; i < _adopted.size(); i++ ) {
+                if ( _adopted[i].get() == p )
+                    return true;
+            }
+            return false;
+        }
         // if just one buffer, keep it in _buf, otherwise keep a sequence of buffers in _data
         char* _buf;
         // byte buffer(s) - the first must contain at least a full MsgData unless using _buf for storage instead
         typedef std::vector< std::pair< char*, int > > MsgVec;
         MsgVec _data;
+        // buffers in _data we share ownership of (see appendSharedData) and so must not free
+        std::vector<SharedBuffer> _adopted;
         bool _freeIt;
     };
 
 
+    /**
+     * Recycles the buffers that hold inbound messages, avoiding a malloc/free pair per
+     * request. Buffers are kept in power-of-two size classes; acquire() hands a buffer
+     * out again only once every Message referencing it (see Message::setSharedData) has
+     * been reset. Not thread safe - each connection (or worker) owns its own pool.
+     */
+    class MessageBufferPool {
+        MONGO_DISALLOW_COPYING(MessageBufferPool);
+    public:
+        MessageBufferPool() {}
+
+        /**
+         * Returns a buffer with room for at least 'bytes' bytes. May return more room
+         * than requested. Requests too large to be worth pooling are served by a plain
+         * allocation that is not retained.
+         */
+        SharedBuffer acquire(size_t bytes);
+
+    private:
+        static const size_t kMinClassBytes = 1024;
+        static const size_t kMaxPooledBytes = 16 * 1024 * 1024;
+        static const int kNumClasses = 15; // 1KB, 2KB, ... 16MB
+        static const int kBuffersPerClass = 2;
+
+        // Pooled buffers; empty slots hold no buffer. All buffers in _slots[c] are of
+        // size kMinClassBytes << c.
+        SharedBuffer _slots[kNumClasses][kBuffersPerClass];
+    };
+
     MSGID nextMessageId();
 
 
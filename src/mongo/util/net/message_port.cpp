@@ -44,7 +44,6 @@
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/ssl_options.h"
-#include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 
 #ifndef _WIN32
@@ -141,19 +140,20 @@ namespace mongo {
         ports.closeAll(mask);
     }
 
-    MessagingPort::MessagingPort(int fd, const SockAddr& remote) 
-        : psock( new Socket( fd , remote ) ) , piggyBackData(0) {
+    MessagingPort::MessagingPort(int fd, const SockAddr& remote)
+        : psock( new Socket( fd , remote ) ) , piggyBackData(0),
+          _recvBufReadPos(0), _recvBufWritePos(0) {
         ports.insert(this);
     }
 
-    MessagingPort::MessagingPort( double timeout, logger::LogSeverity ll ) 
-        : psock( new Socket( timeout, ll ) ) {
+    MessagingPort::MessagingPort( double timeout, logger::LogSeverity ll )
+        : psock( new Socket( timeout, ll ) ), _recvBufReadPos(0), _recvBufWritePos(0) {
         ports.insert(this);
         piggyBackData = 0;
     }
 
     MessagingPort::MessagingPort( boost::shared_ptr<Socket> sock )
-        : psock( sock ), piggyBackData( 0 ) {
+        : psock( sock ), piggyBackData( 0 ), _recvBufReadPos(0), _recvBufWritePos(0) {
         ports.insert(this);
     }
 
@@ -168,17 +168,51 @@ namespace mongo {
     MessagingPort::~MessagingPort() {
         if ( piggyBackData )
             delete( piggyBackData );
+        for ( std::map<MSGID, Message*>::iterator i = _pipelinedReplies.begin();
+              i != _pipelinedReplies.end();
+              ++i ) {
+            delete i->second;
+        }
         shutdown();
         ports.erase(this);
     }
     
+    void MessagingPort::_ensureBuffered(int bytes) {
+        verify( bytes <= kSpeculativeRecvBufSize );
+        if ( !_recvBuf.get() )
+            _recvBuf = SharedBuffer::allocate(kSpeculativeRecvBufSize);
+
+        if ( _recvBufWritePos - _recvBufReadPos >= bytes )
+            return;
+
+        // compact so the requested bytes fit contiguously
+        if ( _recvBufReadPos + bytes > kSpeculativeRecvBufSize ) {
+            memmove(_recvBuf.get(),
+                    _recvBuf.get() + _recvBufReadPos,
+                    _recvBufWritePos - _recvBufReadPos);
+            _recvBufWritePos -= _recvBufReadPos;
+            _recvBufReadPos = 0;
+        }
+
+        while ( _recvBufWritePos - _recvBufReadPos < bytes ) {
+            int max = kSpeculativeRecvBufSize - _recvBufWritePos;
+            if ( psock->isAwaitingHandshake() ) {
+                // don't read past what was asked for: the trailing bytes may be the
+                // start of an SSL stream that doSSLHandshake needs to see
+                max = bytes - (_recvBufWritePos - _recvBufReadPos);
+            }
+            _recvBufWritePos += psock->unsafe_recv(_recvBuf.get() + _recvBufWritePos, max);
+        }
+    }
+
     bool MessagingPort::recv(Message& m) {
         try {
 again:
             //mmm( log() << "*  recv() sock:" << this->sock << endl; )
             MSGHEADER::Value header;
             int headerLen = sizeof(MSGHEADER::Value);
-            psock->recv( (char *)&header, headerLen );
+            _ensureBuffered( headerLen );
+            memcpy( (char *)&header, _recvBuf.get() + _recvBufReadPos, headerLen );
             int len = header.constView().getMessageLength();
 
             if ( len == 542393671 ) {
@@ -193,6 +227,7 @@ again:
             }
             else if ( len == -1 ) {
                 // Endian check from the client, after connecting, to see what mode server is running in.
+                _recvBufReadPos += headerLen;
                 unsigned foo = 0x10203040;
                 send( (char *) &foo, 4, "endian" );
                 psock->setHandshakeReceived();
@@ -212,6 +247,7 @@ again:
                     uassert(17132,
                             "SSL handshake received but server is started without SSL support",
                             sslGlobalParams.sslMode.load() != SSLGlobalParams::SSLMode_disabled);
+                    _recvBufReadPos += headerLen;
                     setX509SubjectName(psock->doSSLHandshake(
                                        reinterpret_cast<const char*>(&header), sizeof(header)));
                     psock->setHandshakeReceived();
@@ -231,17 +267,30 @@ again:
             psock->setHandshakeReceived();
             int z = (len+1023)&0xfffffc00;
             verify(z>=len);
-            MsgData::View md = reinterpret_cast<char *>(mongoMalloc(z));
-            ScopeGuard guard = MakeGuard(free, md.view2ptr());
+            SharedBuffer buf = _recvBufferPool.acquire(z);
+            MsgData::View md = buf.get();
             verify(md.view2ptr());
 
-            memcpy(md.view2ptr(), &header, headerLen);
-            int left = len - headerLen;
+            if ( len <= kSpeculativeRecvBufSize ) {
+                // small message: buffer it whole (the read that completes it will also
+                // pull in the start of any messages queued behind it) and carve it out
+                _ensureBuffered( len );
+                memcpy(md.view2ptr(), _recvBuf.get() + _recvBufReadPos, len);
+                _recvBufReadPos += len;
+            }
+            else {
+                // large message: take what is buffered and read the remainder directly
+                // into the message's own buffer
+                const int have = _recvBufWritePos - _recvBufReadPos;
+                memcpy(md.view2ptr(), _recvBuf.get() + _recvBufReadPos, have);
+                _recvBufReadPos += have;
+                psock->recv( md.view2ptr() + have, len - have );
+            }
 
-            psock->recv( md.data(), left );
+            if ( _recvBufReadPos == _recvBufWritePos )
+                _recvBufReadPos = _recvBufWritePos = 0;
 
-            guard.Dismiss();
-            m.setData(md.view2ptr(), true);
+            m.setSharedData(buf.moveFrom());
             return true;
 
         }
@@ -255,6 +304,38 @@ again:
         }
     }
 
+    MSGID MessagingPort::sayPipelined( Message& toSend ) {
+        say( toSend );
+        return toSend.header().getId();
+    }
+
+    bool MessagingPort::recvPipelined( MSGID requestId, Message& response ) {
+        std::map<MSGID, Message*>::iterator stashed = _pipelinedReplies.find( requestId );
+        if ( stashed != _pipelinedReplies.end() ) {
+            response = *stashed->second;
+            delete stashed->second;
+            _pipelinedReplies.erase( stashed );
+            return true;
+        }
+
+        while ( true ) {
+            if ( !recv( response ) )
+                return false;
+
+            const MSGID inResponseTo = response.header().getResponseTo();
+            if ( inResponseTo == requestId )
+                return true;
+
+            // A reply to a different outstanding pipelined request; stash it for when its
+            // requester asks. Message assignment steals the buffers, leaving 'response'
+            // empty for the next recv.
+            std::auto_ptr<Message> keep( new Message() );
+            *keep = response;
+            delete _pipelinedReplies[inResponseTo]; // normally NULL; don't leak if not
+            _pipelinedReplies[inResponseTo] = keep.release();
+        }
+    }
+
     void MessagingPort::reply(Message& received, Message& response) {
         say(/*received.from, */response, received.header().getId());
     }
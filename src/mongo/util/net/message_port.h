@@ -31,6 +31,7 @@
 
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
+#include <map>
 #include <vector>
 
 #include "mongo/util/net/message.h"
@@ -114,6 +115,21 @@ namespace mongo {
          */
         bool recv( const Message& sent , Message& response );
 
+        /**
+         * Pipelining: sends 'toSend' without waiting for its reply and returns the
+         * message id the reply will carry in its responseTo header. Any number of
+         * pipelined requests may be outstanding at once; collect each reply with
+         * recvPipelined(), in any order. Don't mix with call()/recv(sent, response)
+         * while pipelined replies are outstanding.
+         */
+        MSGID sayPipelined( Message& toSend );
+
+        /**
+         * Receives the reply to the pipelined request 'requestId'. Replies that arrive
+         * for other outstanding pipelined requests are buffered until asked for.
+         */
+        bool recvPipelined( MSGID requestId, Message& response );
+
         void piggyBack( Message& toSend , int responseTo = 0 );
 
         unsigned remotePort() const { return psock->remotePort(); }
@@ -154,9 +170,33 @@ namespace mongo {
         }
 
     private:
-        
+
+        /**
+         * Makes at least 'bytes' contiguous received bytes available at
+         * _recvBuf.get() + _recvBufReadPos, compacting the buffer when needed. Reads
+         * speculatively past 'bytes' (up to the buffer capacity) so several small
+         * messages can be carved out of a single syscall - except during the initial
+         * handshake, where trailing bytes may belong to an SSL stream we must not
+         * consume. Throws SocketException on failure.
+         */
+        void _ensureBuffered(int bytes);
+
         PiggyBackData * piggyBackData;
 
+        // replies that arrived while recvPipelined() was waiting for a different request,
+        // keyed by the id of the request they answer; owned until handed out
+        std::map<MSGID, Message*> _pipelinedReplies;
+
+        // recycles inbound message buffers across requests on this connection
+        MessageBufferPool _recvBufferPool;
+
+        // speculative read buffer: bytes [_recvBufReadPos, _recvBufWritePos) have been
+        // received from the socket but not yet carved into messages
+        static const int kSpeculativeRecvBufSize = 64 * 1024;
+        SharedBuffer _recvBuf; // allocated on first use
+        int _recvBufReadPos;
+        int _recvBufWritePos;
+
         // this is the parsed version of remote
         // mutable because its initialized only on call to remote()
         mutable HostAndPort _remoteParsed; 
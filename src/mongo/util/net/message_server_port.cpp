@@ -33,11 +33,13 @@
 
 #include <boost/scoped_ptr.hpp>
 #include <boost/thread/thread.hpp>
+#include <deque>
 #include <memory>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/concurrency/thread_name.h"
@@ -50,6 +52,7 @@
 #include "mongo/util/net/message_port.h"
 #include "mongo/util/net/message_server.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/numa.h"
 #include "mongo/util/scopeguard.h"
 
 #ifdef __linux__  // TODO: consider making this ifndef _WIN32
@@ -64,6 +67,17 @@ namespace mongo {
 
     using boost::scoped_ptr;
 
+    // Maximum number of finished connection threads kept parked waiting to serve a newly
+    // accepted connection instead of exiting. Reusing a thread skips the per-connection
+    // pthread_create/exit (and thread local setup/teardown) for workloads that churn
+    // through short lived connections. 0 disables thread reuse.
+    MONGO_EXPORT_SERVER_PARAMETER(connectionThreadCacheSize, int, 64);
+
+    // When true on a NUMA machine, each connection thread is pinned to the cpus of
+    // one node, assigned round robin, so its stack and message buffers end up
+    // node-local by first touch instead of scattered across sockets.
+    MONGO_EXPORT_STARTUP_SERVER_PARAMETER(numaBindConnectionThreads, bool, false);
+
 namespace {
 
     class MessagingPortWithHandler : public MessagingPort {
@@ -84,6 +98,70 @@ namespace {
         MessageHandler* const _handler;
     };
 
+    /**
+     * A bounded cache of connection threads that have finished serving their socket and
+     * are parked waiting for another one. accepted() hands a fresh connection to a parked
+     * thread when one is available and only creates a thread when none is.
+     */
+    class ConnectionThreadCache {
+        MONGO_DISALLOW_COPYING(ConnectionThreadCache);
+
+    public:
+        ConnectionThreadCache() : _idleThreads(0) {}
+
+        /**
+         * Hands "port" to a parked thread. Returns false, leaving ownership with the
+         * caller, when no parked thread is available to take it.
+         */
+        bool dispatch(MessagingPortWithHandler* port) {
+            boost::lock_guard<boost::mutex> lk(_mutex);
+            // Only queue a connection when there is an idle thread that is not already
+            // spoken for, so a port can never be left stranded in the queue.
+            if (_idleThreads <= static_cast<int>(_pending.size()))
+                return false;
+            _pending.push_back(port);
+            _hasPending.notify_one();
+            return true;
+        }
+
+        /**
+         * Parks the calling connection thread until another connection is dispatched to
+         * it. Returns NULL when the thread should exit instead: the cache is full, the
+         * server is shutting down, or the thread has been idle for too long.
+         */
+        MessagingPortWithHandler* park() {
+            boost::unique_lock<boost::mutex> lk(_mutex);
+            if (inShutdown() || _idleThreads >= connectionThreadCacheSize)
+                return NULL;
+            _idleThreads++;
+            int secondsIdle = 0;
+            while (_pending.empty()) {
+                if (inShutdown() || secondsIdle >= kMaxIdleSeconds) {
+                    _idleThreads--;
+                    return NULL;
+                }
+                // Waking to a still empty queue overestimates idle time on spurious
+                // wakeups, but this is just a retirement heuristic.
+                _hasPending.timed_wait(lk, Seconds(1));
+                secondsIdle++;
+            }
+            MessagingPortWithHandler* const port = _pending.front();
+            _pending.pop_front();
+            _idleThreads--;
+            return port;
+        }
+
+    private:
+        static const int kMaxIdleSeconds = 60;
+
+        boost::mutex _mutex;
+        boost::condition_variable _hasPending;
+        std::deque<MessagingPortWithHandler*> _pending;
+        int _idleThreads;
+    };
+
+    ConnectionThreadCache connectionThreadCache;
+
 }  // namespace
 
     class PortMessageServer : public MessageServer , public Listener {
@@ -109,6 +187,12 @@ namespace {
                 return;
             }
 
+            if (connectionThreadCache.dispatch(portWithHandler.get())) {
+                portWithHandler.release();
+                sleepAfterClosingPort.Dismiss();
+                return;
+            }
+
             try {
 #ifndef __linux__  // TODO: consider making this ifdef _WIN32
                 {
@@ -174,9 +258,41 @@ namespace {
 
         virtual bool useUnixSockets() const { return true; }
 
+        // accepted() only hands the socket off to a handler thread, so it is safe
+        // to run from several SO_REUSEPORT acceptor threads at once.
+        virtual bool useAcceptorClones() const { return true; }
+
     private:
         MessageHandler* _handler;
 
+        /**
+         * Thread body for connection threads. Serves the connection it was created (or
+         * reused) for, then parks in the connection thread cache waiting for another one,
+         * exiting once the cache declines to keep it.
+         *
+         * @param arg the MessagingPortWithHandler for the first connection to serve;
+         *     this method is in charge of cleaning up the arg object.
+         *
+         * @return NULL
+         */
+        static void* handleIncomingMsg(void* arg) {
+            invariant(arg);
+
+            if (numaBindConnectionThreads && numa::available()) {
+                Status status = numa::bindCurrentThreadToNode(numa::nextNodeRoundRobin());
+                if (!status.isOK())
+                    warning() << "could not bind connection thread to a NUMA node: "
+                              << status.reason() << endl;
+            }
+
+            MessagingPortWithHandler* port = static_cast<MessagingPortWithHandler*>(arg);
+            while (port) {
+                handleConnection(port);
+                port = connectionThreadCache.park();
+            }
+            return NULL;
+        }
+
         /**
          * Handles incoming messages from a given socket.
          *
@@ -186,15 +302,11 @@ namespace {
          * 3. Server is shutting down (based on inShutdown)
          *
          * @param arg this method is in charge of cleaning up the arg object.
-         *
-         * @return NULL
          */
-        static void* handleIncomingMsg(void* arg) {
+        static void handleConnection(MessagingPortWithHandler* arg) {
             TicketHolderReleaser connTicketReleaser( &Listener::globalTicketHolder );
 
-            invariant(arg);
-            scoped_ptr<MessagingPortWithHandler> portWithHandler(
-                static_cast<MessagingPortWithHandler*>(arg));
+            scoped_ptr<MessagingPortWithHandler> portWithHandler(arg);
             MessageHandler* const handler = portWithHandler->getHandler();
 
             setThreadName(std::string(str::stream() << "conn" << portWithHandler->connectionId()));
@@ -251,8 +363,6 @@ namespace {
                 manager->cleanupThreadLocals();
 #endif
             handler->disconnected(portWithHandler.get());
-
-            return NULL;
         }
     };
 
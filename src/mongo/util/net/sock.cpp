@@ -41,6 +41,7 @@
 # include <netinet/tcp.h>
 # include <arpa/inet.h>
 # include <errno.h>
+# include <limits.h>
 # include <netdb.h>
 # if defined(__openbsd__)
 #  include <sys/uio.h>
@@ -643,8 +644,49 @@ namespace mongo {
 #endif
 
 #if defined(_WIN32)
-        // TODO use scatter/gather api
-        _send( data , context );
+        // WSASend scatter/gather, so multi-fragment messages don't pay a coalescing
+        // copy or a syscall per fragment
+        vector<WSABUF> d( data.size() );
+        DWORD bufCount = 0;
+        for (vector< pair<char *, int> >::const_iterator j = data.begin();
+             j != data.end();
+             ++j) {
+            if ( j->second > 0 ) {
+                d[ bufCount ].buf = j->first;
+                d[ bufCount ].len = j->second;
+                ++bufCount;
+                _bytesOut += j->second;
+            }
+        }
+
+        WSABUF * bufs = &d[ 0 ];
+        while ( bufCount > 0 ) {
+            DWORD sent = 0;
+            int ret = -1;
+            if (MONGO_FAIL_POINT(throwSockExcep)) {
+                WSASetLastError(WSAENETUNREACH);
+            }
+            else {
+                ret = ::WSASend( _fd, bufs, bufCount, &sent, 0, NULL, NULL );
+            }
+
+            if ( ret != 0 ) {
+                handleSendError( -1, context );
+            }
+
+            while ( sent > 0 ) {
+                if ( bufs->len > sent ) {
+                    bufs->len -= sent;
+                    bufs->buf += sent;
+                    sent = 0;
+                }
+                else {
+                    sent -= bufs->len;
+                    ++bufs;
+                    --bufCount;
+                }
+            }
+        }
 #else
         vector<struct iovec> d( data.size() );
         int i = 0;
@@ -658,12 +700,24 @@ namespace mongo {
                 _bytesOut += j->second;
             }
         }
+#if defined(IOV_MAX)
+        const size_t maxIovecs = IOV_MAX;
+#else
+        const size_t maxIovecs = 1024;
+#endif
+
         struct msghdr meta;
         memset( &meta, 0, sizeof( meta ) );
         meta.msg_iov = &d[ 0 ];
         meta.msg_iovlen = d.size();
 
         while( meta.msg_iovlen > 0 ) {
+            // sendmsg refuses more than IOV_MAX segments with EMSGSIZE, so a message
+            // with more fragments than that goes out in IOV_MAX sized gulps
+            const size_t totalIovlen = meta.msg_iovlen;
+            if ( meta.msg_iovlen > maxIovecs )
+                meta.msg_iovlen = maxIovecs;
+
             int ret = -1;
             if (MONGO_FAIL_POINT(throwSockExcep)) {
 #if defined(_WIN32)
@@ -675,6 +729,7 @@ namespace mongo {
             else {
                 ret = ::sendmsg(_fd, &meta, portSendFlags);
             }
+            meta.msg_iovlen = totalIovlen;
 
             if (ret == -1) {
                 if ( errno != EAGAIN || _timeout == 0 ) {
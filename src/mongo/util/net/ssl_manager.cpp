@@ -595,9 +595,33 @@ namespace mongo {
         // Note: this is for blocking sockets only.
         SSL_CTX_set_mode(*context, SSL_MODE_AUTO_RETRY);
 
-        // Disable session caching (see SERVER-10261)
-        SSL_CTX_set_session_cache_mode(*context, SSL_SESS_CACHE_OFF);
- 
+        if (context == &_serverContext) {
+            // Cache sessions on the server side so clients that reconnect frequently can
+            // resume with an abbreviated handshake instead of paying a full key exchange
+            // each time. The cache is bounded and entries expire, which keeps the
+            // unbounded growth of SERVER-10261 (the reason caching used to be off
+            // entirely) from recurring. Stateless ticket resumption is also available to
+            // clients that support it since we never set SSL_OP_NO_TICKET.
+            const long kMaxSessionCacheSize = 20 * 1024; // sessions, not bytes
+            const long kSessionTimeoutSeconds = 300;
+            SSL_CTX_set_session_cache_mode(*context, SSL_SESS_CACHE_SERVER);
+            SSL_CTX_sess_set_cache_size(*context, kMaxSessionCacheSize);
+            SSL_CTX_set_timeout(*context, kSessionTimeoutSeconds);
+
+            // OpenSSL requires a session id context for reuse when client certificates
+            // are verified; any process-stable value works.
+            static const unsigned char sessionIdContext[] = "mongodb";
+            SSL_CTX_set_session_id_context(*context,
+                                           sessionIdContext,
+                                           sizeof(sessionIdContext) - 1);
+        }
+        else {
+            // Disable session caching on outgoing connections (see SERVER-10261). We
+            // never try to resume sessions we initiate, so caching them would only
+            // accumulate memory.
+            SSL_CTX_set_session_cache_mode(*context, SSL_SESS_CACHE_OFF);
+        }
+
         // Use the clusterfile for internal outgoing SSL connections if specified 
         if (context == &_clientContext && !params.clusterfile.empty()) {
             EVP_set_pw_prompt("Enter cluster certificate passphrase");
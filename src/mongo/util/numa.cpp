@@ -0,0 +1,204 @@
+// numa.cpp
+
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace numa {
+
+    namespace {
+
+        // cpu numbers per node, loaded once from /sys/devices/system/node.
+        // A machine without that tree (non-linux, or no NUMA support in the
+        // kernel) gets a single node covering everything.
+        std::vector< std::vector<int> > nodeCpus;
+        bool topologyLoaded = false;
+        SimpleMutex topologyMutex( "numaTopology" );
+
+        AtomicUInt32 roundRobinCounter;
+
+        /** parses a kernel cpulist, e.g. "0-7,16-23" */
+        std::vector<int> parseCpuList( const std::string& list ) {
+            std::vector<int> cpus;
+            std::stringstream ss( list );
+            std::string range;
+            while ( std::getline( ss, range, ',' ) ) {
+                int lo, hi;
+                size_t dash = range.find( '-' );
+                if ( dash == std::string::npos ) {
+                    lo = hi = atoi( range.c_str() );
+                }
+                else {
+                    lo = atoi( range.substr( 0, dash ).c_str() );
+                    hi = atoi( range.substr( dash + 1 ).c_str() );
+                }
+                for ( int cpu = lo; cpu <= hi; cpu++ )
+                    cpus.push_back( cpu );
+            }
+            return cpus;
+        }
+
+        void loadTopology_inlock() {
+#ifdef __linux__
+            for ( int node = 0; ; node++ ) {
+                const std::string path = str::stream()
+                    << "/sys/devices/system/node/node" << node << "/cpulist";
+                std::ifstream f( path.c_str() );
+                if ( !f )
+                    break;
+                std::string list;
+                std::getline( f, list );
+                std::vector<int> cpus = parseCpuList( list );
+                if ( !cpus.empty() )
+                    nodeCpus.push_back( cpus );
+            }
+#endif
+            if ( nodeCpus.empty() )
+                nodeCpus.resize( 1 );
+            topologyLoaded = true;
+        }
+
+        const std::vector< std::vector<int> >& topology() {
+            SimpleMutex::scoped_lock lk( topologyMutex );
+            if ( !topologyLoaded )
+                loadTopology_inlock();
+            return nodeCpus;
+        }
+
+#ifdef __linux__
+        /**
+         * Appends any "name number" pairs in the given file, e.g. node meminfo
+         * ("Node 0 MemTotal: 131906708 kB", converted to bytes) or numastat
+         * ("numa_hit 12345").
+         */
+        void appendKernelCounters( const std::string& path, BSONObjBuilder& b ) {
+            std::ifstream f( path.c_str() );
+            if ( !f )
+                return;
+            std::string line;
+            while ( std::getline( f, line ) ) {
+                std::stringstream ss( line );
+                std::string word, name;
+                long long value = -1;
+                bool kb = false;
+                while ( ss >> word ) {
+                    if ( isdigit( word[0] ) ) {
+                        // the counter is the last number on the line ("Node 0
+                        // MemTotal: 123 kB" carries the node number too)
+                        value = atoll( word.c_str() );
+                    }
+                    else if ( word == "kB" ) {
+                        kb = true;
+                    }
+                    else {
+                        // the last word before the counter names it; strip the
+                        // trailing ':' of meminfo style lines
+                        name = word;
+                        if ( !name.empty() && name[name.size() - 1] == ':' )
+                            name = name.substr( 0, name.size() - 1 );
+                    }
+                }
+                if ( name.empty() || value == -1 )
+                    continue;
+                b.appendNumber( name, kb ? value * 1024 : value );
+            }
+        }
+#endif
+
+    }  // namespace
+
+    int nodeCount() {
+        return static_cast<int>( topology().size() );
+    }
+
+    bool available() {
+        return nodeCount() > 1;
+    }
+
+    Status bindCurrentThreadToNode( int node ) {
+#ifdef __linux__
+        const std::vector< std::vector<int> >& nodes = topology();
+        const std::vector<int>& cpus = nodes[ static_cast<unsigned>( node ) % nodes.size() ];
+        if ( cpus.empty() )
+            return Status( ErrorCodes::InternalError, "no cpus known for NUMA node" );
+
+        cpu_set_t cpuSet;
+        CPU_ZERO( &cpuSet );
+        for ( size_t i = 0; i < cpus.size(); i++ )
+            CPU_SET( cpus[i], &cpuSet );
+
+        if ( sched_setaffinity( 0, sizeof(cpuSet), &cpuSet ) != 0 ) {
+            return Status( ErrorCodes::InternalError,
+                           str::stream() << "sched_setaffinity failed: " << errnoWithDescription() );
+        }
+        return Status::OK();
+#else
+        return Status( ErrorCodes::CommandNotSupported,
+                       "NUMA thread placement is only supported on Linux" );
+#endif
+    }
+
+    int nextNodeRoundRobin() {
+        return static_cast<int>( roundRobinCounter.fetchAndAdd( 1 ) % nodeCount() );
+    }
+
+    void appendNodeMemoryStats( BSONObjBuilder& b ) {
+#ifdef __linux__
+        const int nodes = nodeCount();
+        for ( int node = 0; node < nodes; node++ ) {
+            const std::string nodeName = str::stream() << "node" << node;
+            BSONObjBuilder sub( b.subobjStart( nodeName ) );
+            const std::string base = str::stream() << "/sys/devices/system/node/node" << node;
+            appendKernelCounters( base + "/meminfo", sub );
+            appendKernelCounters( base + "/numastat", sub );
+            sub.done();
+        }
+#endif
+    }
+
+}  // namespace numa
+}
@@ -0,0 +1,73 @@
+// numa.h
+
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+    class BSONObjBuilder;
+
+    /**
+     * Minimal NUMA awareness, built on the kernel interfaces alone (no libnuma).
+     *
+     * On Linux the topology is read once from /sys/devices/system/node.  A thread
+     * pinned to one node's cpus also gets node-local memory for everything it
+     * first touches afterwards (stacks, connection buffers), which is how the
+     * network threads avoid cross-node traffic.  On other platforms, or on a
+     * single-node box, nodeCount() is 1 and binding is a no-op.
+     */
+    namespace numa {
+
+        /** Number of NUMA nodes with cpus; 1 when not NUMA or not supported. */
+        int nodeCount();
+
+        /** true when the machine has more than one node */
+        bool available();
+
+        /**
+         * Pins the calling thread to the cpus of "node" (modulo nodeCount()).
+         * Not supported outside Linux.
+         */
+        Status bindCurrentThreadToNode( int node );
+
+        /** The next node in round robin order, for spreading worker threads. */
+        int nextNodeRoundRobin();
+
+        /**
+         * Appends one subobject per node with its memory counters
+         * (total/free bytes, numa_hit/numa_miss when the kernel reports them).
+         * Appends nothing when per-node stats are not available.
+         */
+        void appendNodeMemoryStats( BSONObjBuilder& b );
+
+    }  // namespace numa
+
+}
@@ -41,6 +41,8 @@
 #include <fstream>
 
 #include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 using namespace std;
 
@@ -89,4 +91,68 @@ namespace mongo {
         return Status::OK();
     }
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+    namespace {
+
+        /**
+         * TSC-based clock source for Timer. Reading the counter costs a few nanoseconds
+         * versus ~20-30ns for the vDSO clock_gettime call, which matters for the millions
+         * of small sections timed per second (yield checks, CurOp phase timing).
+         */
+        long long timerNowTsc() {
+            unsigned lo, hi;
+            __asm__ __volatile__("rdtsc" : "=a"(lo), "=d"(hi));
+            return (static_cast<long long>(hi) << 32) | lo;
+        }
+
+        /**
+         * Switches Timer over to the TSC if the processor has an invariant TSC (constant
+         * rate regardless of frequency scaling, keeps counting in low power states),
+         * calibrating its frequency at startup. One process-wide calibration suffices: the
+         * invariant TSC runs at the same rate on every core, and processors without one
+         * keep the platform default clock.
+         */
+        MONGO_INITIALIZER_WITH_PREREQUISITES(TimerTscClockSource, ("SystemInfo"))
+                                            (InitializerContext* context) {
+
+            if (!ProcessInfo().hasInvariantTsc()) {
+                return Status::OK();
+            }
+
+            // Read both clocks, wait, read them again; the ratio of the two deltas is the
+            // TSC frequency. Wake-up latency does not matter, because both clocks are read
+            // at the same moments.
+            const long long startMicros = curTimeMicros64();
+            const long long startTicks = timerNowTsc();
+
+            sleepmillis(10);
+
+            const long long elapsedTicks = timerNowTsc() - startTicks;
+            const long long elapsedMicros = curTimeMicros64() - startMicros;
+
+            if (elapsedMicros <= 0 || elapsedTicks <= 0) {
+                return Status::OK();
+            }
+
+            const long long ticksPerSecond =
+                (elapsedTicks * Timer::microsPerSecond) / elapsedMicros;
+
+            // Plausible TSC frequencies only; anything else means the calibration was
+            // disturbed and the platform default clock stays.
+            if (ticksPerSecond < 100 * Timer::microsPerSecond ||
+                ticksPerSecond > 100 * Timer::nanosPerSecond) {
+                warning() << "implausible TSC frequency " << ticksPerSecond
+                          << " Hz; timing will use the platform default clock";
+                return Status::OK();
+            }
+
+            Timer::switchClockSource(&timerNowTsc, ticksPerSecond);
+            return Status::OK();
+        }
+
+    }  // namespace
+
+#endif  // x86 TSC
+
 }
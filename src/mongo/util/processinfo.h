@@ -97,6 +97,13 @@ namespace mongo {
          */
         bool hasNumaEnabled() const { return sysInfo().hasNuma; }
 
+        /**
+         * Determine if the processor has an invariant TSC, i.e. one which runs at a
+         * constant rate regardless of frequency scaling and does not stop in low power
+         * states, making it usable as a time source.
+         */
+        bool hasInvariantTsc() const { return sysInfo().hasInvariantTsc; }
+
         /**
          * Determine if file zeroing is necessary for newly allocated data files.
          */
@@ -160,6 +167,7 @@ namespace mongo {
             unsigned long long pageSize;
             std::string cpuArch;
             bool hasNuma;
+            bool hasInvariantTsc;
             BSONObj _extraStats;
 
             // This is an OS specific value, which determines whether files should be zero-filled
@@ -180,7 +188,8 @@ namespace mongo {
                     numCores( 0 ),
                     pageSize( 0 ),
                     hasNuma( false ),
-                    fileZeroNeeded (false), 
+                    hasInvariantTsc( false ),
+                    fileZeroNeeded (false),
                     preferMsyncOverFSync (true) { 
                 // populate SystemInfo during construction
                 collectSystemInfo();
@@ -432,7 +432,13 @@ namespace mongo {
         pageSize = static_cast<unsigned long long>(sysconf( _SC_PAGESIZE ));
         cpuArch = unameData.machine;
         hasNuma = checkNumaEnabled();
-        
+
+        // constant_tsc and nonstop_tsc together are what Intel documents as the invariant
+        // TSC: constant rate regardless of frequency scaling, keeps counting in low power
+        // states.
+        hasInvariantTsc = cpuFeatures.find( "constant_tsc" ) != string::npos &&
+                          cpuFeatures.find( "nonstop_tsc" ) != string::npos;
+
         BSONObjBuilder bExtra;
         bExtra.append( "versionString", LinuxSysHelper::readLineFromFile( "/proc/version" ) );
         bExtra.append( "libcVersion", gnu_get_libc_version() );
@@ -0,0 +1,293 @@
+// sampling_profiler.cpp
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/hex.h"
+
+#if !defined(_WIN32)
+
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/time.h>
+
+#include "mongo/platform/backtrace.h"
+
+namespace mongo {
+
+    namespace {
+
+        const int kMaxFrames = 24;
+        // Frames contributed by the signal handler and trampoline, stripped from
+        // every sample.
+        const int kSkipFrames = 2;
+        const size_t kTableSize = 4096;  // Must be a power of two.
+        const int kMaxProbes = 8;
+
+        // Slot states; transitions are EMPTY -> WRITING -> READY, never back.
+        enum { kEmpty = 0, kWriting = 1, kReady = 2 };
+
+        struct StackEntry {
+            AtomicUInt32 state;
+            AtomicUInt32 count;
+            unsigned long long hash;
+            int depth;
+            void* frames[kMaxFrames];
+        };
+
+        // All sampling state is preallocated so the signal handler never
+        // allocates.  Reset only while the timer is disarmed.
+        StackEntry stackTable[kTableSize];
+        AtomicUInt32 totalSamples;
+        AtomicUInt32 droppedSamples;
+
+        unsigned long long hashStack(void* const* frames, int depth) {
+            // FNV-1a over the frame addresses.
+            unsigned long long h = 14695981039346656037ULL;
+            for (int i = 0; i < depth; i++) {
+                h ^= static_cast<unsigned long long>(reinterpret_cast<size_t>(frames[i]));
+                h *= 1099511628211ULL;
+            }
+            return h;
+        }
+
+        void profilerSignalHandler(int) {
+            void* rawFrames[kSkipFrames + kMaxFrames];
+            int rawDepth = backtrace(rawFrames, kSkipFrames + kMaxFrames);
+            if (rawDepth <= kSkipFrames) {
+                return;
+            }
+            void* const* frames = rawFrames + kSkipFrames;
+            const int depth = rawDepth - kSkipFrames;
+
+            totalSamples.fetchAndAdd(1);
+
+            const unsigned long long h = hashStack(frames, depth);
+            size_t idx = static_cast<size_t>(h) & (kTableSize - 1);
+            for (int probe = 0; probe < kMaxProbes; probe++) {
+                StackEntry& entry = stackTable[idx];
+                unsigned state = entry.state.load();
+                if (state == kEmpty) {
+                    if (entry.state.compareAndSwap(kEmpty, kWriting) == kEmpty) {
+                        entry.hash = h;
+                        entry.depth = depth;
+                        memcpy(entry.frames, frames, depth * sizeof(void*));
+                        entry.state.store(kReady);
+                        entry.count.fetchAndAdd(1);
+                        return;
+                    }
+                    state = entry.state.load();
+                }
+                if (state == kReady && entry.hash == h && entry.depth == depth &&
+                    memcmp(entry.frames, frames, depth * sizeof(void*)) == 0) {
+                    entry.count.fetchAndAdd(1);
+                    return;
+                }
+                // Slot mid-write by another thread or occupied by a different
+                // stack; probe the next one.
+                idx = (idx + 1) & (kTableSize - 1);
+            }
+            droppedSamples.fetchAndAdd(1);
+        }
+
+        // Guards start/stop transitions; never touched by the signal handler.
+        SimpleMutex profilerMutex("SamplingProfiler");
+        bool profilerRunning = false;
+        struct sigaction savedAction;
+
+        struct ReportEntry {
+            unsigned count;
+            const StackEntry* entry;
+            bool operator<(const ReportEntry& other) const {
+                return count > other.count;  // Descending.
+            }
+        };
+
+    }  // namespace
+
+    SamplingProfiler::SamplingProfiler() {}
+
+    SamplingProfiler& SamplingProfiler::get() {
+        static SamplingProfiler instance;
+        return instance;
+    }
+
+    Status SamplingProfiler::start(int samplesPerSecond) {
+        if (samplesPerSecond < 1 || samplesPerSecond > 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "samplesPerSecond must be between 1 and 1000");
+        }
+
+        SimpleMutex::scoped_lock lk(profilerMutex);
+        if (profilerRunning) {
+            return Status(ErrorCodes::IllegalOperation, "sampling profiler already running");
+        }
+
+        // The timer is disarmed, so no handler is concurrently writing.
+        for (size_t i = 0; i < kTableSize; i++) {
+            stackTable[i].state.store(kEmpty);
+            stackTable[i].count.store(0);
+        }
+        totalSamples.store(0);
+        droppedSamples.store(0);
+
+        // backtrace() lazily loads libgcc's unwinder on first use, which may
+        // allocate; take that hit here rather than inside the signal handler.
+        void* warmup[2];
+        backtrace(warmup, 2);
+
+        struct sigaction action;
+        memset(&action, 0, sizeof(action));
+        action.sa_handler = profilerSignalHandler;
+        sigemptyset(&action.sa_mask);
+        action.sa_flags = SA_RESTART;
+        if (sigaction(SIGPROF, &action, &savedAction) != 0) {
+            return Status(ErrorCodes::InternalError, "failed to install SIGPROF handler");
+        }
+
+        struct itimerval timer;
+        timer.it_interval.tv_sec = 0;
+        timer.it_interval.tv_usec = 1000 * 1000 / samplesPerSecond;
+        timer.it_value = timer.it_interval;
+        if (setitimer(ITIMER_PROF, &timer, NULL) != 0) {
+            sigaction(SIGPROF, &savedAction, NULL);
+            return Status(ErrorCodes::InternalError, "failed to arm profiling timer");
+        }
+
+        profilerRunning = true;
+        return Status::OK();
+    }
+
+    Status SamplingProfiler::stop() {
+        SimpleMutex::scoped_lock lk(profilerMutex);
+        if (!profilerRunning) {
+            return Status(ErrorCodes::IllegalOperation, "sampling profiler is not running");
+        }
+
+        struct itimerval timer;
+        memset(&timer, 0, sizeof(timer));
+        setitimer(ITIMER_PROF, &timer, NULL);
+        sigaction(SIGPROF, &savedAction, NULL);
+
+        profilerRunning = false;
+        return Status::OK();
+    }
+
+    BSONObj SamplingProfiler::report() const {
+        // Entries in the kReady state are immutable except for their counts, so
+        // reading while sampling is active only undercounts in-flight samples.
+        std::vector<ReportEntry> ready;
+        for (size_t i = 0; i < kTableSize; i++) {
+            const StackEntry& entry = stackTable[i];
+            if (entry.state.load() != kReady) {
+                continue;
+            }
+            ReportEntry re;
+            re.count = entry.count.load();
+            re.entry = &entry;
+            ready.push_back(re);
+        }
+        std::sort(ready.begin(), ready.end());
+
+        BSONObjBuilder bob;
+        bob.appendBool("running", running());
+        bob.appendNumber("totalSamples", static_cast<long long>(totalSamples.load()));
+        bob.appendNumber("droppedSamples", static_cast<long long>(droppedSamples.load()));
+
+        BSONArrayBuilder stacks(bob.subarrayStart("stacks"));
+        for (size_t i = 0; i < ready.size(); i++) {
+            const StackEntry& entry = *ready[i].entry;
+            BSONObjBuilder stack(stacks.subobjStart());
+            stack.appendNumber("count", static_cast<long long>(ready[i].count));
+            BSONArrayBuilder frames(stack.subarrayStart("frames"));
+            char** symbols = backtrace_symbols(entry.frames, entry.depth);
+            for (int j = 0; j < entry.depth; j++) {
+                if (symbols) {
+                    frames.append(symbols[j]);
+                }
+                else {
+                    frames.append(integerToHex(reinterpret_cast<size_t>(entry.frames[j])));
+                }
+            }
+            free(symbols);
+            frames.done();
+            stack.done();
+        }
+        stacks.done();
+        return bob.obj();
+    }
+
+    bool SamplingProfiler::running() const {
+        SimpleMutex::scoped_lock lk(profilerMutex);
+        return profilerRunning;
+    }
+
+}  // namespace mongo
+
+#else  // defined(_WIN32)
+
+namespace mongo {
+
+    SamplingProfiler::SamplingProfiler() {}
+
+    SamplingProfiler& SamplingProfiler::get() {
+        static SamplingProfiler instance;
+        return instance;
+    }
+
+    Status SamplingProfiler::start(int samplesPerSecond) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "the sampling profiler is only available on POSIX systems");
+    }
+
+    Status SamplingProfiler::stop() {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "the sampling profiler is only available on POSIX systems");
+    }
+
+    BSONObj SamplingProfiler::report() const {
+        return BSONObj();
+    }
+
+    bool SamplingProfiler::running() const {
+        return false;
+    }
+
+}  // namespace mongo
+
+#endif  // !defined(_WIN32)
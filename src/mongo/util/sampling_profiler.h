@@ -0,0 +1,85 @@
+// sampling_profiler.h
+
+/**
+ *    Copyright (C) 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+    /**
+     * In-process sampling CPU profiler for environments where running an external
+     * profiler is not possible.
+     *
+     * While started, a SIGPROF interval timer fires on whichever thread is
+     * currently consuming CPU and the signal handler records the thread's call
+     * stack into a fixed, preallocated hash table of stacks, aggregating
+     * identical stacks by count.  Nothing is allocated and no locks are taken on
+     * the sampling path; samples that cannot be placed (table full or probe
+     * collision) are counted as dropped.  Symbolization happens only when a
+     * report is requested.
+     *
+     * POSIX only; start() fails on Windows.  Process-wide singleton.
+     */
+    class SamplingProfiler {
+    public:
+        static SamplingProfiler& get();
+
+        /**
+         * Starts sampling at approximately "samplesPerSecond" (1 to 1000) stacks
+         * per second of consumed CPU time.  Fails if sampling is already active.
+         */
+        Status start(int samplesPerSecond);
+
+        /**
+         * Stops sampling.  Collected samples are retained for report() until the
+         * next start().
+         */
+        Status stop();
+
+        /**
+         * Returns the aggregated samples collected since the last start(), with
+         * symbolized frames, ordered by descending sample count:
+         *
+         *     { running: <bool>, totalSamples: N, droppedSamples: N,
+         *       stacks: [ { count: N, frames: [ <symbol>, ... ] }, ... ] }
+         *
+         * May be called while sampling is active.
+         */
+        BSONObj report() const;
+
+        bool running() const;
+
+    private:
+        SamplingProfiler();
+    };
+
+}  // namespace mongo
@@ -36,6 +36,8 @@ namespace mongo {
 
     class SharedBuffer {
     public:
+        class View;
+
         SharedBuffer() {}
 
         void swap(SharedBuffer& other) {
@@ -76,6 +78,19 @@ namespace mongo {
             return _holder ? _holder->data() : NULL;
         }
 
+        /**
+         * Returns true if this is the only reference to the buffer.
+         */
+        bool unique() const {
+            return _holder && _holder->useCount() == 1;
+        }
+
+        /**
+         * Returns a borrowed, non-owning view of this buffer (see View below).
+         * The view must not outlive every owning SharedBuffer.
+         */
+        inline View view() const;
+
         class Holder {
         public:
             explicit Holder(AtomicUInt32::WordType initial = AtomicUInt32::WordType())
@@ -83,10 +98,18 @@ namespace mongo {
 
             // these are called automatically by boost::intrusive_ptr
             friend void intrusive_ptr_add_ref(Holder* h) {
-                h->_refCount.fetchAndAdd(1);
+                // Taking another reference carries no ordering obligations: the
+                // data was already safely published to this thread by whatever
+                // handed it the buffer. Only the final release (below) must
+                // synchronize.
+                h->_refCount.fetchAndAddRelaxed(1);
             }
 
             friend void intrusive_ptr_release(Holder* h) {
+                // The decrement needs release semantics so this thread's writes
+                // to the buffer are visible before the free, and observing zero
+                // needs acquire semantics so the freeing thread sees everyone
+                // else's; subtractAndFetch provides both.
                 if (h->_refCount.subtractAndFetch(1) == 0) {
                     // We placement new'ed a Holder in takeOwnership above,
                     // so we must destroy the object here.
@@ -103,11 +126,17 @@ namespace mongo {
                 return reinterpret_cast<const char *>(this + 1);
             }
 
+            AtomicUInt32::WordType useCount() const {
+                return _refCount.load();
+            }
+
         private:
             AtomicUInt32 _refCount;
         };
 
     private:
+        friend class View;
+
         explicit SharedBuffer(Holder* holder)
             : _holder(holder, /*add_ref=*/ false) {
             // NOTE: The 'false' above is because we have already initialized the Holder with a
@@ -117,6 +146,45 @@ namespace mongo {
         boost::intrusive_ptr<Holder> _holder;
     };
 
+    /**
+     * A borrowed, non-owning view of a SharedBuffer.
+     *
+     * Copying a SharedBuffer is an atomic refcount round trip; copying a View is a
+     * plain pointer copy. Short-lived readers that provably stay within the
+     * lifetime of an owning SharedBuffer can pass buffer access around for free,
+     * and call own() to promote the view to a real reference only when it has to
+     * outlive the owner.
+     */
+    class SharedBuffer::View {
+    public:
+        View() : _holder(NULL) {}
+
+        char* get() const {
+            return _holder ? _holder->data() : NULL;
+        }
+
+        /**
+         * Promotes this view to an owning reference. This is the one place a view
+         * pays the refcount increment.
+         */
+        SharedBuffer own() const {
+            SharedBuffer out;
+            out._holder = _holder; // adds a reference
+            return out;
+        }
+
+    private:
+        friend class SharedBuffer;
+
+        explicit View(Holder* holder) : _holder(holder) {}
+
+        Holder* _holder;
+    };
+
+    inline SharedBuffer::View SharedBuffer::view() const {
+        return View(_holder.get());
+    }
+
     inline void swap(SharedBuffer& one, SharedBuffer& two) {
         one.swap(two);
     }
@@ -0,0 +1,275 @@
+// @file spsc_queue.h
+
+/*    Copyright 2014 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_array.hpp>
+#include <boost/thread/condition.hpp>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/mutex.h"
+#include "mongo/util/queue.h" // for _getSizeDefault
+
+namespace mongo {
+
+    /**
+     * Bounded single-producer/single-consumer queue over a fixed ring of slots.
+     *
+     * On the fast path neither side takes a lock: the producer writes a slot and
+     * publishes it by advancing the tail index, the consumer reads a slot and
+     * retires it by advancing the head index, both plain atomics.  The mutex and
+     * condition variables are only touched at the empty/full edges, where one side
+     * flags itself as waiting and sleeps until the other side crosses the edge, so
+     * a steadily busy queue performs no mutex hand-offs at all.
+     *
+     * Bounded both by a byte budget (measured with the same sizing function as
+     * BlockingQueue) and by the slot count; push blocks on either limit.
+     *
+     * Exactly one thread may push and exactly one thread may pop/peek, but
+     * empty(), size() and count() may be called from any thread.
+     */
+    template<typename T>
+    class SingleProducerSingleConsumerQueue : boost::noncopyable {
+        typedef size_t (*getSizeFunc)(const T& t);
+    public:
+        SingleProducerSingleConsumerQueue(size_t maxSize,
+                                          getSizeFunc f = &_getSizeDefault,
+                                          size_t maxCount = 64 * 1024) :
+            _lock("SPSCQueue"),
+            _maxSize(maxSize),
+            _getSize(f) {
+            // round the slot count up to a power of two so that index masking works
+            size_t capacity = 1;
+            while (capacity < maxCount)
+                capacity *= 2;
+            _capacity = capacity;
+            _mask = capacity - 1;
+            _slots.reset(new T[capacity]);
+        }
+
+        /**
+         * Producer only.  Blocks while the queue is full.
+         */
+        void push(T const& t) {
+            pushBatch(&t, &t + 1);
+        }
+
+        /**
+         * Producer only.  Pushes [begin, end) and wakes the consumer once at the
+         * end instead of per element.  If the queue fills mid-batch, what has been
+         * written so far is published so the consumer can drain it while we wait.
+         */
+        template<typename Iterator>
+        void pushBatch(Iterator begin, Iterator end) {
+            unsigned long long tail = _tail.load();
+            for (Iterator it = begin; it != end; ++it) {
+                const size_t tSize = _getSize(*it);
+                if (_isFull(tail, tSize)) {
+                    _tail.store(tail);
+                    _wakeConsumer();
+
+                    scoped_lock l(_lock);
+                    _producerWaiting.store(1);
+                    while (_isFull(tail, tSize)) {
+                        _cvNoLongerFull.wait(l.boost());
+                    }
+                    _producerWaiting.store(0);
+                }
+                _slots[tail & _mask] = *it;
+                _currentSize.fetchAndAdd(tSize);
+                tail++;
+            }
+            _tail.store(tail);
+            _wakeConsumer();
+        }
+
+        bool empty() const {
+            return _head.load() == _tail.load();
+        }
+
+        /**
+         * The size as measured by the size function. Default to counting each item
+         */
+        size_t size() const {
+            return static_cast<size_t>(_currentSize.load());
+        }
+
+        /**
+         * The max size for this queue
+         */
+        size_t maxSize() const {
+            return _maxSize;
+        }
+
+        /**
+         * The number/count of items in the queue
+         */
+        int count() const {
+            return static_cast<int>(_tail.load() - _head.load());
+        }
+
+        /**
+         * Consumer only.
+         */
+        bool tryPop(T& t) {
+            const unsigned long long head = _head.load();
+            if (head == _tail.load())
+                return false;
+            _pop(head, t);
+            return true;
+        }
+
+        /**
+         * Consumer only.  Blocks until an item is available.
+         */
+        T blockingPop() {
+            const unsigned long long head = _head.load();
+            if (head == _tail.load()) {
+                scoped_lock l(_lock);
+                _consumerWaiting.store(1);
+                while (head == _tail.load()) {
+                    _cvNoLongerEmpty.wait(l.boost());
+                }
+                _consumerWaiting.store(0);
+            }
+
+            T t;
+            _pop(head, t);
+            return t;
+        }
+
+        /**
+         * Consumer only.  Blocks waiting for an object until maxSecondsToWait
+         * passes; if got one, return true and set in t, otherwise return false
+         * and t won't be changed.
+         */
+        bool blockingPop(T& t, int maxSecondsToWait) {
+            if (!_waitNotEmpty(maxSecondsToWait))
+                return false;
+            _pop(_head.load(), t);
+            return true;
+        }
+
+        /**
+         * Consumer only.
+         */
+        bool peek(T& t) {
+            const unsigned long long head = _head.load();
+            if (head == _tail.load())
+                return false;
+            t = _slots[head & _mask];
+            return true;
+        }
+
+        /**
+         * Consumer only.
+         */
+        bool blockingPeek(T& t, int maxSecondsToWait) {
+            if (!_waitNotEmpty(maxSecondsToWait))
+                return false;
+            t = _slots[_head.load() & _mask];
+            return true;
+        }
+
+        /**
+         * Consumer only.
+         */
+        void clear() {
+            T t;
+            while (tryPop(t)) {
+            }
+        }
+
+    private:
+        bool _isFull(unsigned long long tail, size_t tSize) const {
+            return tail - _head.load() >= _capacity ||
+                   static_cast<size_t>(_currentSize.load()) + tSize >= _maxSize;
+        }
+
+        void _pop(unsigned long long head, T& t) {
+            t = _slots[head & _mask];
+            _slots[head & _mask] = T(); // release the slot's payload eagerly
+            _currentSize.fetchAndSubtract(_getSize(t));
+            _head.store(head + 1);
+            if (_producerWaiting.load()) {
+                scoped_lock l(_lock);
+                _cvNoLongerFull.notify_one();
+            }
+        }
+
+        void _wakeConsumer() {
+            if (_consumerWaiting.load()) {
+                scoped_lock l(_lock);
+                _cvNoLongerEmpty.notify_one();
+            }
+        }
+
+        bool _waitNotEmpty(int maxSecondsToWait) {
+            const unsigned long long head = _head.load();
+            if (head != _tail.load())
+                return true;
+
+            boost::xtime xt;
+            boost::xtime_get(&xt, MONGO_BOOST_TIME_UTC);
+            xt.sec += maxSecondsToWait;
+
+            scoped_lock l(_lock);
+            _consumerWaiting.store(1);
+            while (head == _tail.load()) {
+                if (!_cvNoLongerEmpty.timed_wait(l.boost(), xt)) {
+                    _consumerWaiting.store(0);
+                    return false;
+                }
+            }
+            _consumerWaiting.store(0);
+            return true;
+        }
+
+        mutable mongo::mutex _lock;
+        const size_t _maxSize;
+        getSizeFunc _getSize;
+
+        size_t _capacity;
+        size_t _mask;
+        boost::scoped_array<T> _slots;
+
+        // only the producer writes _tail, only the consumer writes _head
+        AtomicUInt64 _head;
+        AtomicUInt64 _tail;
+        AtomicUInt64 _currentSize;
+
+        AtomicUInt32 _producerWaiting;
+        AtomicUInt32 _consumerWaiting;
+
+        boost::condition _cvNoLongerFull;
+        boost::condition _cvNoLongerEmpty;
+    };
+
+}
@@ -133,4 +133,12 @@ namespace mongo {
         return _timerNow();
     }
 
+    void Timer::switchClockSource(long long (*nowFunc)(), long long countsPerSecond) {
+        fassert(28714, nowFunc != NULL);
+        fassert(28715, countsPerSecond > 0);
+
+        _countsPerSecond = countsPerSecond;
+        _timerNow = nowFunc;
+    }
+
 }  // namespace mongo
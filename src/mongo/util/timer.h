@@ -84,6 +84,14 @@ namespace mongo {
          */
         static long long _countsPerSecond;
 
+        /**
+         * Replaces the clock source behind now() with nowFunc, counting at the given
+         * frequency. Called once during startup, before the server begins timing
+         * operations, by the TSC initializer (see processinfo.cpp). Timer instances
+         * constructed before the switch must not be read after it.
+         */
+        static void switchClockSource(long long (*nowFunc)(), long long countsPerSecond);
+
     private:
         long long now() const;
 
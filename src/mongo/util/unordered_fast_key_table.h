@@ -29,10 +29,17 @@
 
 #pragma once
 
+#include <cstring>
+
 #include <boost/smart_ptr/scoped_array.hpp>
 
 #include "mongo/base/disallow_copying.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#define MONGO_UNORDERED_FAST_KEY_TABLE_SSE2 1
+#include <emmintrin.h>
+#endif
+
 namespace mongo {
 
     template<typename K_L, typename K_S>
@@ -58,17 +65,29 @@ namespace mongo {
 
     private:
         struct Entry {
-            Entry()
-                : used( false ), everUsed( false ) {
+            Entry() : curHash( 0 ) {
             }
 
-            bool used;
-            bool everUsed;
             size_t curHash;
             value_type data;
         };
 
         struct Area {
+            // Occupancy lives in a side array of metadata bytes, one per bucket, so
+            // that probing touches a dense cache line and can inspect a whole group
+            // of buckets at once (with SSE2 when available):
+            //   0x00            bucket never used, terminates a probe sequence
+            //   0x01            bucket deleted (tombstone)
+            //   0x80 | (h&0x7f) bucket used, tagged with 7 bits of the key's hash
+            static const unsigned char kMetaEmptyNever = 0;
+            static const unsigned char kMetaEmptyDeleted = 1;
+            static const unsigned char kMetaUsedBit = 0x80;
+            static const unsigned kMetaGroupSize = 16;
+
+            static unsigned char tagForHash( size_t hash ) {
+                return static_cast<unsigned char>( kMetaUsedBit | ( hash & 0x7f ) );
+            }
+
             Area( unsigned capacity, double maxProbeRatio );
             Area( const Area& other );
 
@@ -76,16 +95,31 @@ namespace mongo {
 
             bool transfer( Area* newArea, const UnorderedFastKeyTable& sm ) const;
 
+            bool isUsed( unsigned pos ) const {
+                return ( _meta[pos] & kMetaUsedBit ) != 0;
+            }
+
+            // The first kMetaGroupSize-1 metadata bytes are mirrored past the end of
+            // the array so a group load starting near the end sees the wrapped-around
+            // buckets it will probe next.
+            void setMeta( unsigned pos, unsigned char m ) {
+                _meta[pos] = m;
+                if ( pos < kMetaGroupSize - 1 )
+                    _meta[pos + _capacity] = m;
+            }
+
             void swap( Area* other ) {
                 using std::swap;
                 swap( _capacity, other->_capacity );
                 swap( _maxProbe, other->_maxProbe );
                 swap( _entries, other->_entries );
+                swap( _meta, other->_meta );
             }
 
             unsigned _capacity;
             unsigned _maxProbe;
             boost::scoped_array<Entry> _entries;
+            boost::scoped_array<unsigned char> _meta; // _capacity + kMetaGroupSize - 1 bytes
         };
 
     public:
@@ -173,7 +207,7 @@ namespace mongo {
 
             void _skip() {
                 while ( true ) {
-                    if ( _area->_entries[_position].used )
+                    if ( _area->isUsed( _position ) )
                         break;
                     if ( _position >= _max ) {
                         _position = -1;
@@ -31,22 +31,35 @@
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
+    template< typename K_L, typename K_S, typename V, typename H, typename E, typename C, typename C_LS >
+    const unsigned char UnorderedFastKeyTable<K_L, K_S, V, H, E, C, C_LS>::Area::kMetaEmptyNever;
+    template< typename K_L, typename K_S, typename V, typename H, typename E, typename C, typename C_LS >
+    const unsigned char UnorderedFastKeyTable<K_L, K_S, V, H, E, C, C_LS>::Area::kMetaEmptyDeleted;
+    template< typename K_L, typename K_S, typename V, typename H, typename E, typename C, typename C_LS >
+    const unsigned char UnorderedFastKeyTable<K_L, K_S, V, H, E, C, C_LS>::Area::kMetaUsedBit;
+    template< typename K_L, typename K_S, typename V, typename H, typename E, typename C, typename C_LS >
+    const unsigned UnorderedFastKeyTable<K_L, K_S, V, H, E, C, C_LS>::Area::kMetaGroupSize;
+
     template< typename K_L, typename K_S, typename V, typename H, typename E, typename C, typename C_LS >
     inline UnorderedFastKeyTable<K_L, K_S, V, H, E, C, C_LS>::Area::Area(unsigned capacity,
                                                                    double maxProbeRatio)
         : _capacity( capacity ),
           _maxProbe( static_cast<unsigned>( capacity * maxProbeRatio ) ),
-          _entries( new Entry[_capacity] ) {
+          _entries( new Entry[_capacity] ),
+          _meta( new unsigned char[_capacity + kMetaGroupSize - 1] ) {
+        memset( _meta.get(), kMetaEmptyNever, _capacity + kMetaGroupSize - 1 );
     }
 
     template< typename K_L, typename K_S, typename V, typename H, typename E, typename C, typename C_LS >
     inline UnorderedFastKeyTable<K_L, K_S, V, H, E, C, C_LS>::Area::Area(const Area& other )
         : _capacity( other._capacity ),
           _maxProbe( other._maxProbe ),
-          _entries( new Entry[_capacity] ) {
+          _entries( new Entry[_capacity] ),
+          _meta( new unsigned char[_capacity + kMetaGroupSize - 1] ) {
         for ( unsigned i = 0; i < _capacity; i++ ) {
             _entries[i] = other._entries[i];
         }
+        memcpy( _meta.get(), other._meta.get(), _capacity + kMetaGroupSize - 1 );
     }
 
     template< typename K_L, typename K_S, typename V, typename H, typename E, typename C, typename C_LS >
@@ -58,32 +71,73 @@ namespace mongo {
         if ( firstEmpty )
             *firstEmpty = -1;
 
-        for ( unsigned probe = 0; probe < _maxProbe; probe++ ) {
-            unsigned pos = (hash + probe) % _capacity;
-
-            if ( ! _entries[pos].used ) {
-                // space is empty
-                if ( firstEmpty && *firstEmpty == -1 )
-                    *firstEmpty = pos;
-                if ( ! _entries[pos].everUsed )
-                    return -1;
+        const unsigned char tag = tagForHash( hash );
+
+        // Probe the metadata bytes a group at a time.  Groups that contain no
+        // candidate tag and nothing that can end or record the probe are skipped
+        // with a couple of mask tests; full key comparisons only happen on buckets
+        // whose 7-bit hash tag already matches.
+        for ( unsigned probe = 0; probe < _maxProbe; probe += kMetaGroupSize ) {
+            const unsigned base = ( hash + probe ) % _capacity;
+
+            unsigned groupLen = _maxProbe - probe;
+            if ( groupLen > kMetaGroupSize )
+                groupLen = kMetaGroupSize;
+
+#if defined(MONGO_UNORDERED_FAST_KEY_TABLE_SSE2)
+            const __m128i group =
+                _mm_loadu_si128( reinterpret_cast<const __m128i*>( _meta.get() + base ) );
+            const unsigned candMask = static_cast<unsigned>(
+                _mm_movemask_epi8( _mm_cmpeq_epi8( group,
+                                                   _mm_set1_epi8( static_cast<char>( tag ) ) ) ) );
+            const unsigned neverMask = static_cast<unsigned>(
+                _mm_movemask_epi8( _mm_cmpeq_epi8( group, _mm_setzero_si128() ) ) );
+            const unsigned emptyMask =
+                ~static_cast<unsigned>( _mm_movemask_epi8( group ) ) & 0xffff;
+
+            if ( candMask == 0 && neverMask == 0 &&
+                 ( emptyMask == 0 || firstEmpty == NULL || *firstEmpty != -1 ) ) {
+                // nothing of interest in this whole group
                 continue;
             }
 
-            if ( _entries[pos].curHash != hash ) {
-                // space has something else
-                continue;
+            for ( unsigned j = 0; j < groupLen; j++ ) {
+                const unsigned bit = 1u << j;
+                if ( candMask & bit ) {
+                    const unsigned pos = ( base + j ) % _capacity;
+                    if ( _entries[pos].curHash == hash &&
+                         sm._equals( key, sm._convertor( _entries[pos].data.first ) ) ) {
+                        // tag, hash, and key all match
+                        return pos;
+                    }
+                }
+                else if ( emptyMask & bit ) {
+                    if ( firstEmpty && *firstEmpty == -1 )
+                        *firstEmpty = ( base + j ) % _capacity;
+                    if ( neverMask & bit )
+                        return -1;
+                }
             }
-
-            if ( ! sm._equals(key, sm._convertor( _entries[pos].data.first ) ) ) {
-                // hashes match
-                // strings are not equals
-                continue;
+#else
+            for ( unsigned j = 0; j < groupLen; j++ ) {
+                const unsigned pos = ( base + j ) % _capacity;
+                const unsigned char m = _meta[pos];
+                if ( m == tag ) {
+                    if ( _entries[pos].curHash == hash &&
+                         sm._equals( key, sm._convertor( _entries[pos].data.first ) ) ) {
+                        // tag, hash, and key all match
+                        return pos;
+                    }
+                }
+                else if ( !( m & kMetaUsedBit ) ) {
+                    // space is empty
+                    if ( firstEmpty && *firstEmpty == -1 )
+                        *firstEmpty = pos;
+                    if ( m == kMetaEmptyNever )
+                        return -1;
+                }
             }
-
-            // hashes and strings are equal
-            // yay!
-            return pos;
+#endif
         }
         return -1;
     }
@@ -93,7 +147,7 @@ namespace mongo {
             Area* newArea,
             const UnorderedFastKeyTable& sm) const {
         for ( unsigned i = 0; i < _capacity; i++ ) {
-            if ( ! _entries[i].used )
+            if ( ! isUsed( i ) )
                 continue;
 
             int firstEmpty = -1;
@@ -108,6 +162,7 @@ namespace mongo {
             }
 
             newArea->_entries[firstEmpty] = _entries[i];
+            newArea->setMeta( firstEmpty, tagForHash( _entries[i].curHash ) );
         }
         return true;
     }
@@ -155,8 +210,7 @@ namespace mongo {
             // need to add
             if ( firstEmpty >= 0 ) {
                 _size++;
-                _area._entries[firstEmpty].used = true;
-                _area._entries[firstEmpty].everUsed = true;
+                _area.setMeta( firstEmpty, Area::tagForHash( hash ) );
                 _area._entries[firstEmpty].curHash = hash;
                 _area._entries[firstEmpty].data.first = _convertorOther(key);
                 return _area._entries[firstEmpty].data.second;
@@ -178,7 +232,7 @@ namespace mongo {
             return 0;
 
         --_size;
-        _area._entries[pos].used = false;
+        _area.setMeta( pos, Area::kMetaEmptyDeleted );
         _area._entries[pos].data.second = V();
         return 1;
     }
@@ -189,7 +243,7 @@ namespace mongo {
         dassert(it._area == &_area);
 
         --_size;
-        _area._entries[it._position].used = false;
+        _area.setMeta( it._position, Area::kMetaEmptyDeleted );
         _area._entries[it._position].data.second = V();
     }
 
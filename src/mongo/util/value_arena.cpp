@@ -0,0 +1,122 @@
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects
+*    for all of the code used other than as permitted herein. If you modify
+*    file(s) with this exception, you may extend this exception to your
+*    version of the file(s), but you are not obligated to do so. If you do not
+*    wish to do so, delete this exception statement from your version. If you
+*    delete this exception statement from all source files in the program,
+*    then also delete it in the license file.
+*/
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/value_arena.h"
+
+#include <cstdlib>
+
+#include "mongo/util/allocator.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+
+    // The arena installed for the current thread, if any. Raw thread-local storage
+    // where available since this is just a pointer and nothing needs to be freed on
+    // thread exit.
+#if defined(MONGO_HAVE___THREAD)
+    __thread ValueArena* _currentValueArena = NULL;
+    static ValueArena* getCurrentValueArena() { return _currentValueArena; }
+    static void setCurrentValueArena(ValueArena* arena) { _currentValueArena = arena; }
+#elif defined(MONGO_HAVE___DECLSPEC_THREAD)
+    __declspec( thread ) ValueArena* _currentValueArena = NULL;
+    static ValueArena* getCurrentValueArena() { return _currentValueArena; }
+    static void setCurrentValueArena(ValueArena* arena) { _currentValueArena = arena; }
+#else
+    struct CurrentValueArena {
+        ValueArena* arena;
+    };
+    TSP_DEFINE(CurrentValueArena, _currentValueArena);
+    static ValueArena* getCurrentValueArena() {
+        return _currentValueArena.getMake()->arena;
+    }
+    static void setCurrentValueArena(ValueArena* arena) {
+        _currentValueArena.getMake()->arena = arena;
+    }
+#endif
+
+    ValueArena::ValueArena(size_t maxBytes)
+        : _next(NULL)
+        , _end(NULL)
+        , _nextBlockBytes(kFirstBlockBytes)
+        , _bytesAllocated(0)
+        , _maxBytes(maxBytes)
+    {}
+
+    ValueArena::~ValueArena() {
+        for (size_t i = 0; i < _blocks.size(); i++) {
+            free(_blocks[i]);
+        }
+    }
+
+    void* ValueArena::allocate(size_t bytes) {
+        // Round up so the next allocation stays 8-byte aligned.
+        bytes = (bytes + 7) & ~size_t(7);
+
+        if (_bytesAllocated + bytes > _maxBytes)
+            return NULL; // over budget - caller uses the heap
+
+        if (size_t(_end - _next) < bytes)
+            newBlock(bytes);
+
+        void* out = _next;
+        _next += bytes;
+        _bytesAllocated += bytes;
+        return out;
+    }
+
+    void ValueArena::newBlock(size_t minBytes) {
+        size_t blockBytes = _nextBlockBytes;
+        if (blockBytes < minBytes)
+            blockBytes = minBytes;
+
+        char* block = static_cast<char*>(mongoMalloc(blockBytes));
+        _blocks.push_back(block);
+        _next = block;
+        _end = block + blockBytes;
+
+        if (_nextBlockBytes < kMaxBlockBytes)
+            _nextBlockBytes *= 2;
+    }
+
+    ValueArena* ValueArena::current() {
+        return getCurrentValueArena();
+    }
+
+    ValueArena::Scope::Scope(ValueArena* arena) {
+        _saved = getCurrentValueArena();
+        setCurrentValueArena(arena);
+    }
+
+    ValueArena::Scope::~Scope() {
+        setCurrentValueArena(_saved);
+    }
+
+}
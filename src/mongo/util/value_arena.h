@@ -0,0 +1,101 @@
+/**
+*    Copyright (C) 2014 MongoDB Inc.
+*
+*    This program is free software: you can redistribute it and/or  modify
+*    it under the terms of the GNU Affero General Public License, version 3,
+*    as published by the Free Software Foundation.
+*
+*    This program is distributed in the hope that it will be useful,
+*    but WITHOUT ANY WARRANTY; without even the implied warranty of
+*    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*    GNU Affero General Public License for more details.
+*
+*    You should have received a copy of the GNU Affero General Public License
+*    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*    As a special exception, the copyright holders give permission to link the
+*    code of portions of this program with the OpenSSL library under certain
+*    conditions as described in each individual source file and distribute
+*    linked combinations including the program with the OpenSSL library. You
+*    must comply with the GNU Affero General Public License in all respects
+*    for all of the code used other than as permitted herein. If you modify
+*    file(s) with this exception, you may extend this exception to your
+*    version of the file(s), but you are not obligated to do so. If you do not
+*    wish to do so, delete this exception statement from your version. If you
+*    delete this exception statement from all source files in the program,
+*    then also delete it in the license file.
+*/
+
+#pragma once
+
+#include <boost/noncopyable.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace mongo {
+
+    /**
+     * A bump allocator for the small refcounted objects behind the aggregation
+     * Document and Value types.
+     *
+     * While an arena is installed for the current thread (see Scope), RCString and
+     * DocumentStorage buffers are carved out of large blocks instead of being
+     * individually malloc'd, and refcounting of arena-owned objects is elided
+     * entirely (see RefCountable::markArenaOwned()). Everything is freed in one step
+     * when the arena is destroyed. Once an arena has handed out maxBytes, allocate()
+     * returns NULL and callers fall back to the heap with ordinary refcounting, so
+     * pipelines that stream far more data than they retain degrade to the status quo
+     * instead of accumulating per-document garbage until the pipeline finishes.
+     *
+     * An arena is single-threaded - only the thread that installed it may allocate
+     * from it - and it must outlive every object allocated from it. For a pipeline
+     * the arena is owned by the ExpressionContext, which is destroyed after all of
+     * the pipeline's stages.
+     */
+    class ValueArena : boost::noncopyable {
+    public:
+        explicit ValueArena(size_t maxBytes);
+
+        /// Frees all blocks. Does not run any destructors.
+        ~ValueArena();
+
+        /**
+         * Returns 8-byte aligned storage that lives until this arena is destroyed, or
+         * NULL if the allocation does not fit in the remaining budget.
+         */
+        void* allocate(size_t bytes);
+
+        size_t bytesAllocated() const { return _bytesAllocated; }
+
+        /// The arena installed for the current thread, or NULL.
+        static ValueArena* current();
+
+        /**
+         * Installs an arena (which may be NULL) as the current thread's arena for
+         * this object's lifetime, restoring the previous one on destruction.
+         */
+        class Scope : boost::noncopyable {
+        public:
+            explicit Scope(ValueArena* arena);
+            ~Scope();
+
+        private:
+            ValueArena* _saved;
+        };
+
+    private:
+        static const size_t kFirstBlockBytes = 64 * 1024;
+        static const size_t kMaxBlockBytes = 4 * 1024 * 1024;
+
+        /// Makes the current block able to hold at least minBytes.
+        void newBlock(size_t minBytes);
+
+        std::vector<char*> _blocks;
+        char* _next; // within the last block
+        char* _end; // of the last block
+        size_t _nextBlockBytes;
+        size_t _bytesAllocated;
+        const size_t _maxBytes;
+    };
+
+}